@@ -1,116 +1,174 @@
-#include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <sstream>
-
-#include "cppoutput.h"
-#include "fileerror.h"
-#include "parser.h"
-#include "structurecheck.h"
-
-#include "args/args.hxx"
-
-#ifndef COREBUFFER_VERSION
-#define COREBUFFER_VERSION "<undefined>"
-#endif
-#ifndef COREBUFFER_BRANCH
-#define COREBUFFER_BRANCH "<undefined>"
-#endif
-
-using namespace std;
-
-void usageError(const string &msg, const args::ArgumentParser &args)
-{
-  cerr << msg << endl << endl;
-  cerr << args << endl;
-}
-
-void logError(const string &file, const FileError &pe)
-{
-  cerr << file << ":" << pe._state.line << ":" << pe._state.column << ": error: " << pe.what() << endl;
-}
-
-int compile(const string &input, const string &output, const args::ArgumentParser &args)
-{
-  ifstream t(input);
-  if (!t)
-  {
-    usageError("can not open input '" + input + "'.", args);
-    return 2;
-  }
-
-  string source((istreambuf_iterator<char>(t)), istreambuf_iterator<char>());
-
-  Package p;
-  try
-  {
-    Parser(source, p).parse();
-
-    auto errors = StructureCheck(p).check();
-    sort(errors.begin(), errors.end(),
-         [](const FileError &l, const FileError &r) { return l._state.pos < r._state.pos; });
-    if (!errors.empty())
-    {
-      for (const auto &pe : errors)
-        logError(input, pe);
-      return 3;
-    }
-  }
-  catch (const FileError &pe)
-  {
-    logError(input, pe);
-    return 3;
-  }
-
-  ofstream o(output);
-  if (!o)
-  {
-    usageError("can not open output '" + output + "'.", args);
-    return 4;
-  }
-
-  WriteCppCode(o, p);
-
-  return 0;
-}
-
-int main(int argc, char *argv[])
-{
-  args::ArgumentParser args(
-      "CoreBuffer compiler. Code generation tool for convenient automatically generated binary serialization of "
-      "complex data structures.",
-      __DATE__ " CoreBufferC " COREBUFFER_VERSION " (" COREBUFFER_BRANCH ")");
-  args::HelpFlag help(args, "help", "Display this help menu", {'h', "help"});
-  args::Flag version(args, "version", "display the program version", {"version"});
-  args::Positional<string> input(args, "<input.cor>", "the CoreBuffer IDL descripting input file");
-  args::Positional<string> output(args, "<output.h>", "the c++ header output");
-
-  try
-  {
-    args.ParseCLI(argc, argv);
-  }
-  catch (args::Help)
-  {
-    cout << args;
-    return 0;
-  }
-  catch (args::ParseError e)
-  {
-    usageError(e.what(), args);
-    return 1;
-  }
-
-  if (version)
-  {
-    cout << COREBUFFER_VERSION << endl;
-    return 0;
-  }
-
-  if (!input || !output)
-  {
-    usageError("missing commad line argument(s).", args);
-    return 1;
-  }
-
-  return compile(input.Get(), output.Get(), args);
-}
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "cppoutput.h"
+#include "fileerror.h"
+#include "parser.h"
+#include "structurecheck.h"
+
+#include "args/args.hxx"
+
+#ifndef COREBUFFER_VERSION
+#define COREBUFFER_VERSION "<undefined>"
+#endif
+#ifndef COREBUFFER_BRANCH
+#define COREBUFFER_BRANCH "<undefined>"
+#endif
+
+using namespace std;
+
+void usageError(const string &msg, const args::ArgumentParser &args)
+{
+  cerr << msg << endl << endl;
+  cerr << args << endl;
+}
+
+void logError(const string &file, const FileError &pe)
+{
+  cerr << file << ":" << pe._state.line << ":" << pe._state.column << ": error: " << pe.what() << endl;
+}
+
+int compile(const string &input, const string &output, const OutputOptions &options, const args::ArgumentParser &args)
+{
+  ifstream t(input);
+  if (!t)
+  {
+    usageError("can not open input '" + input + "'.", args);
+    return 2;
+  }
+
+  string source((istreambuf_iterator<char>(t)), istreambuf_iterator<char>());
+
+  Package p;
+  try
+  {
+    Parser(source, p).parse();
+
+    auto errors = StructureCheck(p).check();
+    sort(errors.begin(), errors.end(),
+         [](const FileError &l, const FileError &r) { return l._state.pos < r._state.pos; });
+    if (!errors.empty())
+    {
+      for (const auto &pe : errors)
+        logError(input, pe);
+      return 3;
+    }
+  }
+  catch (const FileError &pe)
+  {
+    logError(input, pe);
+    return 3;
+  }
+
+  ofstream o(output);
+  if (!o)
+  {
+    usageError("can not open output '" + output + "'.", args);
+    return 4;
+  }
+
+  WriteCppCode(o, p, options);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  args::ArgumentParser args(
+      "CoreBuffer compiler. Code generation tool for convenient automatically generated binary serialization of "
+      "complex data structures.",
+      __DATE__ " CoreBufferC " COREBUFFER_VERSION " (" COREBUFFER_BRANCH ")");
+  args::HelpFlag help(args, "help", "Display this help menu", {'h', "help"});
+  args::Flag version(args, "version", "display the program version", {"version"});
+  args::ValueFlag<string> wire(args, "profile",
+                               "wire format of the generated io functions: 'default', 'compact' or 'portable'",
+                               {"wire"});
+  args::Flag indexVectors(args, "index-vectors", "store an offset index for random access into root vectors",
+                          {"index-vectors"});
+  args::Flag pmr(args, "pmr", "use std::pmr containers in the generated types (requires C++17)", {"pmr"});
+  args::Flag trackChanges(args, "track-changes", "track changed root members for writing deltas",
+                          {"track-changes"});
+  args::Flag parallel(args, "parallel",
+                      "generate functions encoding and decoding large root vectors on several threads",
+                      {"parallel"});
+  args::Flag asyncFile(args, "async-file", "generate Save<root>FileAsync writing the file on a background thread",
+                       {"async-file"});
+  args::Flag ioUring(args, "io-uring", "generate Save<root>FileUring and Load<root>FileUring using io_uring on Linux",
+                     {"io-uring"});
+  args::Flag diff(args, "diff", "generate Diff<root> and Patch<root> for patches between two roots", {"diff"});
+  args::Flag journal(args, "journal", "generate a journal recording operations on the root (requires threads)",
+                     {"journal"});
+  args::Flag compressed(args, "compressed",
+                        "generate Write<root>Compressed and Read<root>Compressed for a block compressed container",
+                        {"compressed"});
+  args::Flag visitor(args, "visitor", "generate a visitor decoding the root member by member", {"visitor"});
+  args::Flag views(args, "views", "generate read-only view types over serialized data", {"views"});
+  args::Flag verifier(args, "verify", "generate Verify<root> checking serialized data without building it",
+                      {"verify"});
+  args::Flag mappedFile(args, "mapped-file", "generate Save<root>File and Load<root>File using memory mapped files",
+                        {"mapped-file"});
+  args::ValueFlag<unsigned int> inlineUnions(args, "bytes",
+                                             "store union alternatives up to this size inside the union",
+                                             {"inline-unions"});
+  args::Positional<string> input(args, "<input.cor>", "the CoreBuffer IDL descripting input file");
+  args::Positional<string> output(args, "<output.h>", "the c++ header output");
+
+  try
+  {
+    args.ParseCLI(argc, argv);
+  }
+  catch (args::Help)
+  {
+    cout << args;
+    return 0;
+  }
+  catch (args::ParseError e)
+  {
+    usageError(e.what(), args);
+    return 1;
+  }
+
+  if (version)
+  {
+    cout << COREBUFFER_VERSION << endl;
+    return 0;
+  }
+
+  if (!input || !output)
+  {
+    usageError("missing commad line argument(s).", args);
+    return 1;
+  }
+
+  OutputOptions options;
+  options.indexedVectors = indexVectors;
+  options.pmr = pmr;
+  options.trackChanges = trackChanges;
+  options.parallel = parallel;
+  options.asyncFile = asyncFile;
+  options.ioUring = ioUring;
+  options.diff = diff;
+  options.journal = journal;
+  options.compressed = compressed;
+  options.visitor = visitor;
+  options.views = views;
+  options.verifier = verifier;
+  options.mappedFile = mappedFile;
+  options.inlineUnionSize = inlineUnions ? inlineUnions.Get() : 0;
+  if (wire)
+  {
+    if (wire.Get() == "compact")
+      options.compactWire = true;
+    else if (wire.Get() == "portable")
+      options.portableWire = true;
+    else if (wire.Get() != "default")
+    {
+      usageError("unknown wire format '" + wire.Get() + "'.", args);
+      return 1;
+    }
+  }
+
+  return compile(input.Get(), output.Get(), options, args);
+}
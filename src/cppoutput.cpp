@@ -1,1266 +1,5832 @@
-#include "cppoutput.h"
-
-#include <algorithm>
-#include <limits>
-#include <tuple>
-
-using namespace std;
-
-template <typename Predicate>
-bool any_table_of(const Package &p, const Predicate &pr)
-{
-  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &t) { return t.is_Table() && pr(t.as_Table()); }) ||
-         any_of(p.baseTypes.begin(), p.baseTypes.end(), pr);
-}
-
-template <typename Predicate>
-bool any_union_of(const Package &p, const Predicate &pr)
-{
-  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &u) { return u.is_Union() && pr(u.as_Union()); });
-}
-
-template <typename Predicate>
-bool any_enum_of(const Package &p, const Predicate &pr)
-{
-  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &u) { return u.is_Enum() && pr(u.as_Enum()); });
-}
-
-template <typename Predicate>
-bool any_flag_of(const Package &p, const Predicate &pr)
-{
-  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &u) { return u.is_Flag() && pr(u.as_Flag()); });
-}
-
-template <class T>
-bool hasUniqueAppearance(const T &t)
-{
-  return ((t.appearance & UniqueAppearance) == UniqueAppearance) ||
-         ((t.appearance & UniqueVectorAppearance) == UniqueVectorAppearance);
-}
-
-bool someThingIsUnique(const Package &p)
-{
-  return any_table_of(p, hasUniqueAppearance<Table>) || any_union_of(p, hasUniqueAppearance<Union>);
-}
-
-template <class T>
-bool hasUniqueVectorAppearance(const T &t)
-{
-  return (t.appearance & UniqueVectorAppearance) == UniqueVectorAppearance;
-};
-
-bool someThingIsUniqueVector(const Package &p)
-{
-  return any_table_of(p, hasUniqueVectorAppearance<Table>) || any_union_of(p, hasUniqueVectorAppearance<Union>);
-}
-
-template <class T>
-bool hasSharedAppearance(const T &t)
-{
-  return ((t.appearance & SharedAppearance) == SharedAppearance) ||
-         ((t.appearance & SharedVectorAppearance) == SharedVectorAppearance);
-}
-
-bool someThingIsShared(const Package &p)
-{
-  return any_table_of(p, hasSharedAppearance<Table>) || any_union_of(p, hasSharedAppearance<Union>);
-}
-
-template <class T>
-bool hasSharedVectorAppearance(const T &t)
-{
-  return (t.appearance & SharedVectorAppearance) == SharedVectorAppearance;
-};
-
-bool someThingIsSharedVector(const Package &p)
-{
-  return any_table_of(p, hasSharedVectorAppearance<Table>) || any_union_of(p, hasSharedVectorAppearance<Union>);
-}
-
-template <class T>
-bool isComplex(const T &t)
-{
-  return t.isComplexType;
-}
-
-template <>
-bool isComplex(const Union &)
-{
-  return true;
-}
-
-template <class T>
-bool hasWeakAppearance(const T &t)
-{
-  return ((t.appearance & WeakAppearance) == WeakAppearance) ||
-         ((t.appearance & WeakVectorAppearance) == WeakVectorAppearance);
-}
-
-bool someThingIsWeak(const Package &p)
-{
-  return any_table_of(p, hasWeakAppearance<Table>) || any_union_of(p, hasWeakAppearance<Union>);
-}
-
-template <class T>
-bool hasWeakVectorAppearance(const T &t)
-{
-  return (t.appearance & WeakVectorAppearance) == WeakVectorAppearance;
-};
-
-bool someThingIsWeakVector(const Package &p)
-{
-  return any_table_of(p, hasWeakVectorAppearance<Table>) || any_union_of(p, hasWeakVectorAppearance<Union>);
-}
-
-template <class T>
-bool hasPlainVectorAppearance(const T &t)
-{
-  return ((t.appearance & VectorAppearance) == VectorAppearance);
-}
-
-bool hasVectorOfString(const Package &p)
-{
-  return any_table_of(p, [](const Table &t) {
-    return any_of(t.member.begin(), t.member.end(),
-                  [](const Member &m) { return m.isBaseType && m.isVector && m.type == "std::string"; });
-  });
-}
-
-bool hasPlainString(const Package &p)
-{
-  return any_table_of(p, [](const Table &t) {
-    return any_of(t.member.begin(), t.member.end(),
-                  [](const Member &m) { return m.isBaseType && !m.isVector && m.type == "std::string"; });
-  });
-}
-
-bool isEnum(const Package &p, const string &type)
-{
-  return any_enum_of(p, [&type](const Enum &e) { return e.name == type; });
-}
-
-bool isFlag(const Package &p, const string &type)
-{
-  return any_flag_of(p, [&type](const Flag &e) { return e.name == type; });
-}
-
-void WriteNameSpaceBegin(ostream &o, const string &path, int pos = 0)
-{
-  if (path.empty())
-    return;
-
-  const auto end = path.find('.', pos);
-  o << "namespace " << path.substr(pos, end) << " {" << endl;
-  if (end != string::npos)
-    WriteNameSpaceBegin(o, path, int(end) + 1);
-}
-
-void WriteNameSpaceEnd(ostream &o, const string &path, int pos = 0)
-{
-  if (path.empty())
-    return;
-
-  const auto end = path.find('.', pos);
-  o << "}" << endl;
-  if (end != string::npos)
-    WriteNameSpaceEnd(o, path, int(end) + 1);
-}
-
-void WriteForwardDeclarations(ostream &o, const Package &p)
-{
-  for (const auto &t : p.types)
-    if (t.is_Table())
-      o << endl << "struct " << t.as_Table().name << ";";
-    else if (t.is_Union())
-      o << endl << "struct " << t.as_Union().name << ";";
-  o << endl << endl;
-}
-
-void WriteEnumDeclaration(ostream &o, const Enum &e)
-{
-  int64_t maxEntry = 0ul;
-  for (const auto &entry : e.entries)
-    maxEntry = max(entry.value, maxEntry);
-
-  string type = "std::int8_t";
-  if (maxEntry > numeric_limits<uint32_t>::max())
-    type = "std::int64_t";
-  else if (maxEntry > numeric_limits<uint16_t>::max())
-    type = "std::int32_t";
-  else if (maxEntry > numeric_limits<uint8_t>::max())
-    type = "std::int16_t";
-
-  o << "enum class " << e.name << " : " << type << " {" << endl;
-  for (const auto &v : e.entries)
-    o << "  " << v.name << " = " << v.value << "," << endl;
-  o << "};" << endl << endl;
-}
-
-void WriteEnumFunctions(ostream &o, const Enum &e)
-{
-  o << "inline const std::array<" << e.name << "," << e.entries.size() << "> & " << e.name << "Values() {" << endl;
-  o << "  static const std::array<" << e.name << "," << e.entries.size() << "> values {{" << endl;
-  for (const auto &v : e.entries)
-    o << "    " << e.name << "::" << v.name << "," << endl;
-  o << "  }};" << endl;
-  o << "  return values;" << endl;
-  o << "};" << endl << endl;
-
-  o << "inline const char * ValueName(const " << e.name << " &v) {" << endl;
-  o << "  switch(v) {" << endl;
-  for (const auto &v : e.entries)
-    o << "    case " << e.name << "::" << v.name << ": return \"" << v.name << "\";" << endl;
-  o << "  }" << endl;
-  o << "  return \"<error>\";" << endl;
-  o << "};" << endl << endl;
-}
-
-void WriteFlagDeclaration(ostream &o, const Flag &f, const string &intType)
-{
-  o << "struct " << f.name << " {" << endl;
-  o << "  enum value_t {" << endl;
-  o << "    _none = 0," << endl;
-  int64_t i = 1;
-  for (const auto &v : f.entries)
-  {
-    o << "    " << v.value << " = " << i << "," << endl;
-    i <<= 1;
-  }
-  o << "  };" << endl << endl;
-
-  o << "  inline " << f.name << "(value_t v = _none) : value(v) {}" << endl << endl;
-
-  o << "  bool operator[](const value_t &a) const { return (value & a) == a; }" << endl;
-  o << "  bool operator[](const " << f.name << " &a) const { return (value & a.value) == a.value; }" << endl;
-
-  o << "  friend bool operator==(const " << f.name << " &a, const " << f.name << " &b) { return a.value == b.value; }"
-    << endl;
-  o << "  friend bool operator!=(const " << f.name << " &a, const " << f.name << " &b) { return a.value != b.value; }"
-    << endl
-    << endl;
-
-  o << "  " << intType << " value;" << endl;
-
-  o << "};" << endl << endl;
-}
-
-void WriteFlagFunctions(ostream &o, const Flag &f, const string &intType)
-{
-  o << "inline " << f.name << " operator|(" << f.name << "::value_t a, " << f.name << "::value_t b)" << endl;
-  o << "{" << endl;
-  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a)) | (static_cast<" << intType << ">(b)));"
-    << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " operator|(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a.value)) | (static_cast<" << intType
-    << ">(b.value)));" << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " &operator|=(" << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return reinterpret_cast<" << f.name << " &>((reinterpret_cast<" << intType << " &>(a.value)) |= (static_cast<"
-    << intType << ">(b.value)));" << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " operator&(" << f.name << "::value_t a, " << f.name << "::value_t b)" << endl;
-  o << "{" << endl;
-  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a)) & (static_cast<" << intType << ">(b)));"
-    << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " operator&(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a.value)) & (static_cast<" << intType
-    << ">(b.value)));" << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " &operator&=(" << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return reinterpret_cast<" << f.name << " &>((reinterpret_cast<" << intType << " &>(a.value)) &= (static_cast<"
-    << intType << ">(b.value)));" << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " operator~(" << f.name << "::value_t a) { return " << f.name << "::value_t(~static_cast<"
-    << intType << ">(a)); }" << endl;
-  o << "inline " << f.name << " operator~(const " << f.name << " &a) { return " << f.name << "::value_t(~a.value); }"
-    << endl;
-  o << "inline " << f.name << " operator^(" << f.name << "::value_t a, " << f.name << "::value_t b)" << endl;
-  o << "{" << endl;
-  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a)) ^ (static_cast<" << intType << ">(b)));"
-    << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " operator^(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a.value)) ^ (static_cast<" << intType
-    << ">(b.value)));" << endl;
-  o << "}" << endl;
-  o << "inline " << f.name << " &operator^=(" << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return reinterpret_cast<" << f.name << " &>((reinterpret_cast<" << intType << " &>(a.value)) ^= (static_cast<"
-    << intType << ">(b.value)));" << endl;
-  o << "}" << endl;
-  o << "inline bool operator<(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return a.value < b.value;" << endl;
-  o << "}" << endl;
-  o << "inline bool operator>(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return a.value > b.value;" << endl;
-  o << "}" << endl;
-  o << "inline bool operator>=(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return a.value >= b.value;" << endl;
-  o << "}" << endl;
-  o << "inline bool operator<=(const " << f.name << " &a, const " << f.name << " &b)" << endl;
-  o << "{" << endl;
-  o << "  return a.value <= b.value;" << endl;
-  o << "}" << endl;
-  o << "" << endl;
-  o << "inline const std::array<" << f.name << "::value_t, 4> &" << f.name << "Values()" << endl;
-  o << "{" << endl;
-  o << "  static const std::array<" << f.name << "::value_t, 4> values{{" << endl;
-  o << "      " << f.name << "::alpha," << endl;
-  o << "      " << f.name << "::beta," << endl;
-  o << "      " << f.name << "::gamma," << endl;
-  o << "      " << f.name << "::delta," << endl;
-  o << "  }};" << endl;
-  o << "  return values;" << endl;
-  o << "};" << endl;
-  o << "" << endl;
-  o << "inline const char *ValueName(const " << f.name << "::value_t &v)" << endl;
-  o << "{" << endl;
-  o << "  switch (v)" << endl;
-  o << "  {" << endl;
-  o << "    default:" << endl;
-  o << "      break;" << endl;
-  o << "    case " << f.name << "::alpha:" << endl;
-  o << "      return \"alpha\";" << endl;
-  o << "    case " << f.name << "::beta:" << endl;
-  o << "      return \"beta\";" << endl;
-  o << "    case " << f.name << "::gamma:" << endl;
-  o << "      return \"gamma\";" << endl;
-  o << "    case " << f.name << "::delta:" << endl;
-  o << "      return \"delta\";" << endl;
-  o << "  }" << endl;
-  o << "  return \"<error>\";" << endl;
-  o << "};" << endl;
-}
-
-void WriteFlag(ostream &o, const Flag &f)
-{
-  int64_t maxEntry = 0ul;
-  int64_t i = 1;
-  for (const auto &e : f.entries)
-    maxEntry = max(i <<= 1, maxEntry);
-
-  string intType = "std::int8_t";
-  if (maxEntry > numeric_limits<uint32_t>::max())
-    intType = "std::int64_t";
-  else if (maxEntry > numeric_limits<uint16_t>::max())
-    intType = "std::int32_t";
-  else if (maxEntry > numeric_limits<uint8_t>::max())
-    intType = "std::int16_t";
-
-  WriteFlagDeclaration(o, f, intType);
-  WriteFlagFunctions(o, f, intType);
-}
-
-void WriteBaseTypeIoFnuctions(ostream &o, const Package &p)
-{
-  static const auto notImplementedAssert = "    static_assert(AlwaysFalse<T>::value, \"Something not implemented\");";
-
-  o << "  template<typename T> void Write(std::ostream &, const T *) {" << endl;
-  o << notImplementedAssert << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<typename T> void Write(std::ostream &o, const T &v) {" << endl;
-  o << "    o.write(reinterpret_cast<const char *>(&v), sizeof(T));" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<typename T> void Write(std::ostream &o, const std::vector<T> &v) {" << endl;
-  o << "    Write(o, v.size());" << endl;
-  o << "    o.write(reinterpret_cast<const char *>(v.data()), sizeof(T) * v.size());" << endl;
-  o << "  }" << endl << endl;
-
-  if (hasVectorOfString(p))
-  {
-    o << "  void Write(std::ostream &o, const std::vector<std::string> &v) {" << endl;
-    o << "    Write(o, v.size());" << endl;
-    o << "    for (const auto &entry : v)" << endl;
-    o << "      Write(o, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsUnique(p))
-  {
-    o << "  template<typename T> void Write(std::ostream &o, const std::unique_ptr<T> &v) {" << endl;
-    o << "    if (!v) {" << endl;
-    o << "      o.write(\"\\x0\", 1);" << endl;
-    o << "    } else {" << endl;
-    o << "      o.write(\"\\x1\", 1);" << endl;
-    o << "      Write(o, *v);" << endl;
-    o << "    }" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsShared(p))
-  {
-    o << "  template<typename T> void Write(std::ostream &o, const std::shared_ptr<T> &v, unsigned int &counter) {"
-      << endl;
-    o << "    if (!v) {" << endl;
-    o << "      o.write(\"\\x0\", 1);" << endl;
-    o << "    } else if (v->io_counter_== 0) {" << endl;
-    o << "      v->io_counter_ = ++counter;" << endl;
-    o << "      o.write(\"\\x1\", 1);" << endl;
-    o << "      Write(o, *v);" << endl;
-    o << "    } else {" << endl;
-    o << "      o.write(\"\\x2\", 1);" << endl;
-    o << "      Write(o, v->io_counter_);" << endl;
-    o << "    }" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsUniqueVector(p))
-  {
-    o << "  template<typename T> void Write(std::ostream &o, const std::vector<std::unique_ptr<T>> &v) {" << endl;
-    o << "    Write(o, v.size());" << endl;
-    o << "    for (const auto &entry : v)" << endl;
-    o << "      Write(o, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsSharedVector(p))
-  {
-    o << "  template<typename T> void Write(std::ostream &o, const std::vector<std::shared_ptr<T>> &v) {" << endl;
-    o << "    Write(o, v.size());" << endl;
-    o << "    for (const auto &entry : v)" << endl;
-    o << "      Write(o, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsWeakVector(p))
-  {
-    o << "  template<typename T> void Write(std::ostream &o, const std::vector<std::weak_ptr<T>> &v) {" << endl;
-    o << "    Write(o, v.size());" << endl;
-    o << "    for (const auto &entry : v)" << endl;
-    o << "      Write(o, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<typename T> void Write(std::ostream &, const std::shared_ptr<T> &) {" << endl;
-  o << notImplementedAssert << endl;
-  o << "  }" << endl << endl;
-
-  if (someThingIsWeak(p))
-  {
-    o << "  template<typename T> void Write(std::ostream &, const std::weak_ptr<T> &) {" << endl;
-    o << notImplementedAssert << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (hasPlainString(p))
-  {
-    o << "  void Write(std::ostream &o, const std::string &v) {" << endl;
-    o << "    Write(o, v.size());" << endl;
-    o << "    o.write(v.data(), v.size());" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<typename T> void Read(std::istream &i, T &v) {" << endl;
-  o << "    i.read(reinterpret_cast<char *>(&v), sizeof(T));" << endl;
-  o << "  }" << endl << endl;
-
-  if (someThingIsUnique(p))
-  {
-    o << "  template<typename T> void Read(std::istream &i, std::unique_ptr<T> &v) {" << endl;
-    o << "    char ref = 0;" << endl;
-    o << "    i.read(&ref, 1);" << endl;
-    o << "    if (ref == '\\x1') {" << endl;
-    o << "      v = std::unique_ptr<T>(new T);" << endl;
-    o << "      Read(i, *v);" << endl;
-    o << "    }" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<typename T> void Read(std::istream &, std::shared_ptr<T> &) {" << endl;
-  o << notImplementedAssert << endl;
-  o << "  }" << endl << endl;
-
-  if (someThingIsWeak(p))
-  {
-    o << "  template<typename T> void Read(std::istream &, std::weak_ptr<T> &) {" << endl;
-    o << notImplementedAssert << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsShared(p))
-  {
-    o << "  template<typename T> void Read(std::istream &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache) {"
-      << endl;
-    o << "    char ref = 0;" << endl;
-    o << "    s.read(&ref, 1);" << endl;
-    o << "    if (ref == '\\x1') {" << endl;
-    o << "      v = std::make_shared<T>();" << endl;
-    o << "      cache.push_back(v);" << endl;
-    o << "      Read(s, *v);" << endl;
-    o << "    } else if (ref == '\\x2') {" << endl;
-    o << "      unsigned int index = 0;" << endl;
-    o << "      Read(s, index);" << endl;
-    o << "      v = cache[index - 1];" << endl;
-    o << "    }" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsUniqueVector(p))
-  {
-    o << "  template<typename T> void Read(std::istream &s, std::vector<std::unique_ptr<T>> &v) {" << endl;
-    o << "    auto size = v.size();" << endl;
-    o << "    Read(s, size);" << endl;
-    o << "    v.resize(size);" << endl;
-    o << "    for (auto &entry : v)" << endl;
-    o << "      Read(s, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsSharedVector(p))
-  {
-    o << "  template<typename T> void Read(std::istream &s, std::vector<std::shared_ptr<T>> &v) {" << endl;
-    o << "    auto size = v.size();" << endl;
-    o << "    Read(s, size);" << endl;
-    o << "    v.resize(size);" << endl;
-    o << "    for (auto &entry : v)" << endl;
-    o << "      Read(s, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (someThingIsWeakVector(p))
-  {
-    o << "  template<typename T> void Read(std::istream &s, std::vector<std::weak_ptr<T>> &v) {" << endl;
-    o << "    auto size = v.size();" << endl;
-    o << "    Read(s, size);" << endl;
-    o << "    v.resize(size);" << endl;
-    o << "    for (auto &entry : v)" << endl;
-    o << "      Read(s, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<typename T> void Read(std::istream &i, std::vector<T> &v) {" << endl;
-  o << "    typename std::vector<T>::size_type s{0};" << endl;
-  o << "    Read(i, s);" << endl;
-  o << "    v.resize(s);" << endl;
-  o << "    i.read(reinterpret_cast<char *>(v.data()), sizeof(T) * s);" << endl;
-  o << "  }" << endl << endl;
-
-  if (hasVectorOfString(p))
-  {
-    o << "  void Read(std::istream &i, std::vector<std::string> &v) {" << endl;
-    o << "    auto size = v.size();" << endl;
-    o << "    Read(i, size);" << endl;
-    o << "    v.resize(size);" << endl;
-    o << "    for (auto &entry : v)" << endl;
-    o << "      Read(i, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  if (hasPlainString(p))
-  {
-    o << "  void Read(std::istream &i, std::string &v) {" << endl;
-    o << "    std::string::size_type s{0};" << endl;
-    o << "    Read(i, s);" << endl;
-    o << "    v.resize(s);" << endl;
-    o << "    i.read(&v[0], s);" << endl;
-    o << "  }" << endl << endl;
-  }
-}
-
-ostream &WriteType(ostream &o, const Member &m)
-{
-  if (m.isVector)
-    o << "std::vector<";
-  if (m.pointer == Pointer::Weak)
-    o << "std::weak_ptr<";
-  if (m.pointer == Pointer::Unique)
-    o << "std::unique_ptr<";
-  if (m.pointer == Pointer::Shared)
-    o << "std::shared_ptr<";
-  o << m.type;
-  if (m.pointer != Pointer::Plain)
-    o << ">";
-  if (m.isVector)
-    o << ">";
-  return o;
-}
-
-ostream &WriteParameterType(ostream &o, const Member &m)
-{
-  if (m.pointer != Pointer::Unique)
-    o << "const ";
-
-  auto mm = m;
-  if (!m.isVector && m.pointer == Pointer::Weak)
-    mm.pointer = Pointer::Shared;
-
-  WriteType(o, mm) << " ";
-  if (m.pointer != Pointer::Unique)
-    o << "&";
-
-  return o << m.name << "_";
-}
-
-std::pair<int, const Member *> memberEntry(const Table &t, const string &name)
-{
-  int i = 0;
-  for (const auto &m : t.member)
-  {
-    if (m.name == name)
-      return make_pair(i, &m);
-    ++i;
-  }
-  throw std::runtime_error("Member not defined!");
-}
-
-std::vector<std::pair<int, const Member *>> indexParameter(const Table &t, const Method &m)
-{
-  std::vector<std::pair<int, const Member *>> parameter;
-
-  for (const auto &p : m.parameter)
-    parameter.emplace_back(memberEntry(t, p.name));
-
-  return parameter;
-}
-
-void WriteTableInitializer(ostream &o, const Table &t)
-{
-  o << endl << "  " << t.name << "() = default;" << endl;
-  for (const auto &method : t.methods)
-  {
-    if (method.name != "init")
-      continue;
-
-    auto parameter = indexParameter(t, method);
-    o << "  " << t.name << "(";
-    string comma;
-    for (const auto &p : parameter)
-    {
-      o << comma;
-      WriteParameterType(o, *p.second);
-      comma = ", ";
-    }
-    o << ")" << endl;
-    comma = ": ";
-    std::sort(parameter.begin(), parameter.end());
-    for (const auto &p : parameter)
-    {
-      bool isUnique = p.second->pointer == Pointer::Unique;
-      o << "    " << comma << p.second->name << "(";
-      if (isUnique)
-        o << "std::move(" << p.second->name << "_))" << endl;
-      else
-        o << p.second->name << "_)" << endl;
-      comma = ", ";
-    }
-    o << "  {}" << endl;
-  }
-}
-
-string defaultValueLiteral(const Member &m)
-{
-  if (m.isBaseType)
-  {
-    if (m.type == "float")
-      return m.defaultValue.value.back() == 'f' ? "" : "f";
-    else if (m.type.find("std::u") == 0)
-      return m.defaultValue.value.back() == 'u' ? "" : "u";
-  }
-  return string();
-}
-
-void WriteTableCompareFunctions(ostream &o, const Table &t)
-{
-  o << endl << "  friend bool operator==(const " << t.name << "&l, const " << t.name << "&r) {" << endl;
-  o << "    return ";
-  bool first = true;
-  for (const auto &m : t.member)
-  {
-    o << endl << "      " << (first ? "" : "&& ") << "l." << m.name << " == r." << m.name;
-    first = false;
-  }
-  o << ";" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  friend bool operator!=(const " << t.name << "&l, const " << t.name << "&r) {" << endl;
-  o << "    return ";
-  first = true;
-  for (const auto &m : t.member)
-  {
-    o << endl << "      " << (first ? "" : "|| ") << "l." << m.name << " != r." << m.name;
-    first = false;
-  }
-  o << ";" << endl;
-  o << "  }" << endl;
-}
-
-void WriteMemberVectorFunctions(ostream &o, const Package &p, const Member &m)
-{
-  if (!m.isVector)
-    return;
-
-  o << endl;
-  if (m.pointer != Pointer::Unique)
-  {
-    o << "  template<class T> void fill_" << m.name << "(const T &v) {" << endl;
-    o << "    std::fill(" << m.name << ".begin(), " << m.name << ".end(), v);" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<class Generator> void generate_" << m.name << "(Generator gen) {" << endl;
-  o << "    std::generate(" << m.name << ".begin(), " << m.name << ".end(), gen);" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<class T> ";
-  WriteType(o, m) << "::iterator remove_" << m.name << "(const T &v) {" << endl;
-  o << "    return std::remove(" << m.name << ".begin(), " << m.name << ".end(), v);" << endl;
-  o << "  }" << endl;
-  o << "  template<class Pred> ";
-  WriteType(o, m) << "::iterator remove_" << m.name << "_if(Pred v) {" << endl;
-  o << "    return std::remove_if(" << m.name << ".begin(), " << m.name << ".end(), v);" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<class T> void erase_" << m.name << "(const T &v) {" << endl;
-  o << "    " << m.name << ".erase(remove_" << m.name << "(v));" << endl;
-  o << "  }" << endl;
-  o << "  template<class Pred> void erase_" << m.name << "_if(Pred v) {" << endl;
-  o << "    " << m.name << ".erase(remove_" << m.name << "_if(v));" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  void reverse_" << m.name << "() {" << endl;
-  o << "    std::reverse(" << m.name << ".begin(), " << m.name << ".end());" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  void rotate_" << m.name << "(";
-  WriteType(o, m) << "::iterator i) {" << endl;
-  o << "    std::rotate(" << m.name << ".begin(), i, " << m.name << ".end());" << endl;
-  o << "  }" << endl << endl;
-
-  if (m.isBaseType || isEnum(p, m.type) || isFlag(p, m.type))
-  {
-    o << "  void sort_" << m.name << "() {" << endl;
-    o << "    std::sort(" << m.name << ".begin(), " << m.name << ".end());" << endl;
-    o << "  }" << endl;
-  }
-  o << "  template<class Comp> void sort_" << m.name << "(Comp p) {" << endl;
-  o << "    std::sort(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<class Comp> bool any_of_" << m.name << "(Comp p) {" << endl;
-  o << "    return std::any_of(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl;
-  o << "  template<class T> bool any_of_" << m.name << "_is(const T &p) {" << endl;
-  o << "    return any_of_" << m.name << "([&p](const ";
-  auto mm = m;
-  mm.isVector = false;
-  auto mmm = mm;
-  mmm.pointer = Pointer::Shared;
-  WriteType(o, mm) << " &x) { return ";
-  if (m.pointer == Pointer::Weak)
-    o << "x.lock() && ";
-  else if (m.pointer != Pointer::Plain)
-    o << "x && ";
-  o << (m.pointer != Pointer::Plain ? "*" : "") << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });"
-    << endl;
-  o << "  }" << endl << endl;
-  if (m.pointer == Pointer::Shared || m.pointer == Pointer::Weak)
-  {
-    o << "  bool any_of_" << m.name << "_is(const ";
-    WriteType(o, mmm) << " &p) {" << endl;
-    o << "    return any_of_" << m.name << "([&p](const ";
-    WriteType(o, mm) << " &x) { return ";
-    o << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<class Comp> bool all_of_" << m.name << "(Comp p) {" << endl;
-  o << "    return std::all_of(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl;
-  o << "  template<class T> bool all_of_" << m.name << "_are(const T &p) {" << endl;
-  o << "    return all_of_" << m.name << "([&p](const ";
-  WriteType(o, mm) << " &x) { return ";
-  if (m.pointer == Pointer::Weak)
-    o << "x.lock() && ";
-  else if (m.pointer != Pointer::Plain)
-    o << "x && ";
-  o << (m.pointer != Pointer::Plain ? "*" : "") << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });"
-    << endl;
-  o << "  }" << endl << endl;
-  if (m.pointer == Pointer::Shared || m.pointer == Pointer::Weak)
-  {
-    o << "  bool all_of_" << m.name << "_are(const ";
-    WriteType(o, mmm) << " &p) {" << endl;
-    o << "    return all_of_" << m.name << "([&p](const ";
-    WriteType(o, mm) << " &x) { return ";
-    o << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<class Comp> bool none_of_" << m.name << "(Comp p) {" << endl;
-  o << "    return std::none_of(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl;
-  o << "  template<class T> bool none_of_" << m.name << "_is(const T &p) {" << endl;
-  o << "    return none_of_" << m.name << "([&p](const ";
-  WriteType(o, mm) << " &x) { return ";
-  if (m.pointer == Pointer::Weak)
-    o << "x.lock() && ";
-  else if (m.pointer != Pointer::Plain)
-    o << "x && ";
-  o << (m.pointer != Pointer::Plain ? "*" : "") << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });"
-    << endl;
-  o << "  }" << endl << endl;
-  if (m.pointer == Pointer::Shared || m.pointer == Pointer::Weak)
-  {
-    o << "  bool none_of_" << m.name << "_is(const ";
-    WriteType(o, mmm) << " &p) {" << endl;
-    o << "    return none_of_" << m.name << "([&p](const ";
-    WriteType(o, mm) << " &x) { return ";
-    o << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  template<class Fn> Fn for_each_" << m.name << "(Fn p) {" << endl;
-  o << "    return std::for_each(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<class T> ";
-  WriteType(o, m) << "::iterator find_in_" << m.name << "(const T &p) {" << endl;
-  o << "    return std::find(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl;
-  o << "  template<class Comp> ";
-  WriteType(o, m) << "::iterator find_in_" << m.name << "_if(Comp p) {" << endl;
-  o << "    return std::find_if(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  template<class T> ";
-  o << "  typename std::iterator_traits<";
-  WriteType(o, m) << "::iterator>::difference_type count_in_" << m.name << "(const T &p) {" << endl;
-  o << "    return std::count(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl;
-  o << "  template<class Comp> ";
-  o << "  typename std::iterator_traits<";
-  WriteType(o, m) << "::iterator>::difference_type count_in_" << m.name << "_if(Comp p) {" << endl;
-  o << "    return std::count_if(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
-  o << "  }" << endl;
-}
-
-void WriteTableDeclaration(ostream &o, const Package &p, const Table &t, const string &root_type)
-{
-  o << "struct " << t.name << " {" << endl;
-  for (const auto &m : t.member)
-  {
-    o << "  ";
-    WriteType(o, m) << " " << m.name;
-    if (!m.isVector && m.pointer == Pointer::Plain && !m.defaultValue.value.empty())
-      o << "{" << m.defaultValue.value << defaultValueLiteral(m) << "}";
-    o << ";" << endl;
-  }
-
-  WriteTableInitializer(o, t);
-
-  WriteTableCompareFunctions(o, t);
-
-  for (const auto &m : t.member)
-    WriteMemberVectorFunctions(o, p, m);
-
-  if (hasSharedAppearance(t))
-  {
-    o << endl;
-    o << "private:" << endl;
-    o << "  unsigned int io_counter_{0};" << endl;
-    o << "  friend struct " << root_type << "_io;" << endl;
-  }
-  o << "};" << endl << endl;
-}
-
-template <class T>
-void WritePointerOutputFor(ostream &o, const T &t)
-{
-  if (hasSharedAppearance(t))
-  {
-    o << "  void Write(std::ostream &o, const std::shared_ptr<" << t.name << "> &v) {" << endl;
-    o << "    Write(o, v, " << t.name << "_count_);" << endl;
-    o << "  }" << endl << endl;
-  }
-  if (hasWeakAppearance(t))
-  {
-    o << "  void Write(std::ostream &o, const std::weak_ptr<" << t.name << "> &v) {" << endl;
-    o << "    Write(o, v.lock(), " << t.name << "_count_);" << endl;
-    o << "  }" << endl << endl;
-  }
-  if (isComplex(t) && hasPlainVectorAppearance(t))
-  {
-    o << "  void Write(std::ostream &o, const std::vector<" << t.name << "> &v) {" << endl;
-    o << "    Write(o, v.size());" << endl;
-    o << "    for (const auto &entry : v)" << endl;
-    o << "      Write(o, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-}
-
-void WriteTableOutput(ostream &o, const Table &t)
-{
-  if (isComplex(t))
-  {
-    o << "  void Write(std::ostream &o, const " << t.name << " &v) {" << endl;
-    for (const auto &m : t.member)
-      o << "    Write(o, v." << m.name << ");" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  WritePointerOutputFor(o, t);
-}
-
-template <class T>
-void WritePointerInputFor(ostream &o, const T &t)
-{
-  if (hasSharedAppearance(t))
-  {
-    o << "  void Read(std::istream &s, std::shared_ptr<" << t.name << "> &v) {" << endl;
-    o << "    Read(s, v, " << t.name << "_references_);" << endl;
-    o << "  }" << endl << endl;
-  }
-  if (hasWeakAppearance(t))
-  {
-    o << "  void Read(std::istream &s, std::weak_ptr<" << t.name << "> &v) {" << endl;
-    o << "    auto t = v.lock();" << endl;
-    o << "    Read(s, t, " << t.name << "_references_);" << endl;
-    o << "    v = t;" << endl;
-    o << "  }" << endl << endl;
-  }
-  if (isComplex(t) && hasPlainVectorAppearance(t))
-  {
-    o << "  void Read(std::istream &s, std::vector<" << t.name << "> &v) {" << endl;
-    o << "    auto size = v.size();" << endl;
-    o << "    Read(s, size);" << endl;
-    o << "    v.resize(size);" << endl;
-    o << "    for (auto &entry : v)" << endl;
-    o << "      Read(s, entry);" << endl;
-    o << "  }" << endl << endl;
-  }
-}
-
-void WriteTableInput(ostream &o, const Table &t)
-{
-  if (isComplex(t))
-  {
-    o << "  void Read(std::istream &s, " << t.name << " &v) {" << endl;
-    for (const auto &m : t.member)
-      o << "    Read(s, v." << m.name << ");" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  WritePointerInputFor(o, t);
-}
-
-void WriteCompareOperatorForWeakPointer(ostream &o)
-{
-  o << "template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {" << endl;
-  o << "  return l.lock() == r.lock();" << endl;
-  o << "}" << endl << endl;
-
-  o << "template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {" << endl;
-  o << "  return l.lock() != r.lock();" << endl;
-  o << "}" << endl << endl;
-}
-
-void WriteUnionStruct(ostream &o, const Union &u, const string &root_type)
-{
-  o << "struct " << u.name << " {" << endl;
-
-  o << "  " << u.name << "() = default;" << endl;
-  o << "  " << u.name << "(const " << u.name << " &o) { _clone(o); }" << endl;
-  o << "  " << u.name << "& operator=(const " << u.name << " &o) { _destroy(); _clone(o); return *this; }" << endl
-    << endl;
-
-  for (const auto &t : u.tables)
-  {
-    o << "  " << u.name << "(const " << t.value << " &v)" << endl;
-    o << "    : _" << t.value << "(new " << t.value << "(v))" << endl;
-    o << "    , _selection(_" << t.value << "_selection)" << endl;
-    o << "  {}" << endl;
-    o << "  " << u.name << "(" << t.value << " &&v)" << endl;
-    o << "    : _" << t.value << "(new " << t.value << "(std::forward<" << t.value << ">(v)))" << endl;
-    o << "    , _selection(_" << t.value << "_selection)" << endl;
-    o << "  {}" << endl;
-    o << "  " << u.name << " & operator=(const " << t.value << " &v) {" << endl;
-    o << "    _destroy();" << endl;
-    o << "    _" << t.value << " = new " << t.value << "(v);" << endl;
-    o << "    _selection = _" << t.value << "_selection;" << endl;
-    o << "    return *this;" << endl;
-    o << "  }" << endl;
-    o << "  " << u.name << " & operator=(" << t.value << " &&v) {" << endl;
-    o << "    _destroy();" << endl;
-    o << "    _" << t.value << " = new " << t.value << "(std::forward<" << t.value << ">(v));" << endl;
-    o << "    _selection = _" << t.value << "_selection;" << endl;
-    o << "    return *this;" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  o << "  ~" << u.name << "() {" << endl;
-  o << "    _destroy();" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  bool is_Defined() const noexcept { return _selection != no_selection; }" << endl;
-  o << "  void clear() { *this = " << u.name << "(); }" << endl << endl;
-  for (const auto &t : u.tables)
-  {
-    o << "  bool is_" << t.value << "() const noexcept { return _selection == _" << t.value << "_selection; }" << endl;
-    o << "  const " << t.value << " & as_" << t.value << "() const noexcept { return *_" << t.value << "; }" << endl;
-    o << "  " << t.value << " & as_" << t.value << "() { return *_" << t.value << "; }" << endl;
-
-    o << "  template<typename... Args> " << t.value << " & create_" << t.value << "(Args&&... args) {" << endl;
-    o << "    return (*this = " << t.value << "(std::forward<Args>(args)...)).as_" << t.value << "();" << endl;
-    o << "  }" << endl << endl;
-  }
-
-  for (const auto &t : u.tables)
-  {
-    o << "  friend bool operator==(const " << u.name << "&ab, const " << t.value << " &o) noexcept";
-    o << "  { return ab.is_" << t.value << "() && ab.as_" << t.value << "() == o; }" << endl;
-    o << "  friend bool operator==(const " << t.value << " &o, const " << u.name << "&ab) noexcept";
-    o << "  { return ab.is_" << t.value << "() && o == ab.as_" << t.value << "(); }" << endl;
-    o << "  friend bool operator!=(const " << u.name << "&ab, const " << t.value << " &o) noexcept";
-    o << "  { return !ab.is_" << t.value << "() || ab.as_" << t.value << "() != o; }" << endl;
-    o << "  friend bool operator!=(const " << t.value << " &o, const " << u.name << "&ab) noexcept";
-    o << "  { return !ab.is_" << t.value << "() || o != ab.as_" << t.value << "(); }" << endl << endl;
-  }
-
-  o << "  bool operator==(const " << u.name << " &o) const noexcept" << endl;
-  o << "  {" << endl;
-  o << "    if (this == &o)" << endl;
-  o << "      return true;" << endl;
-  o << "    if (_selection != o._selection)" << endl;
-  o << "      return false;" << endl;
-  o << "    switch(_selection) {" << endl;
-  o << "    case no_selection: while(false); /* hack for coverage tool */ return true;" << endl;
-  for (const auto &t : u.tables)
-    o << "    case _" << t.value << "_selection: return *_" << t.value << " == *o._" << t.value << ";" << endl;
-  o << "    }" << endl;
-  o << "    return false; // without this line there is a msvc warning I do not understand." << endl;
-  o << "  }" << endl << endl;
-
-  o << "  bool operator!=(const " << u.name << " &o) const noexcept" << endl;
-  o << "  {" << endl;
-  o << "    if (this == &o)" << endl;
-  o << "      return false;" << endl;
-  o << "    if (_selection != o._selection)" << endl;
-  o << "      return true;" << endl;
-  o << "    switch(_selection) {" << endl;
-  o << "    case no_selection: while(false); /* hack for coverage tool */ return false;" << endl;
-  for (const auto &t : u.tables)
-    o << "    case _" << t.value << "_selection: return *_" << t.value << " != *o._" << t.value << ";" << endl;
-  o << "    }" << endl;
-  o << "    return false; // without this line there is a msvc warning I do not understand." << endl;
-  o << "  }" << endl << endl;
-
-  o << "private:" << endl;
-  o << "  void _clone(const " << u.name << " &o) noexcept" << endl;
-  o << "  {" << endl;
-  o << "     _selection = o._selection;" << endl;
-  o << "    switch(_selection) {" << endl;
-  o << "    case no_selection: while(false); /* hack for coverage tool */ break;" << endl;
-  for (const auto &t : u.tables)
-    o << "    case _" << t.value << "_selection: _" << t.value << " = new " << t.value << "(*o._" << t.value
-      << "); break;" << endl;
-  o << "    }" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  void _destroy() noexcept {" << endl;
-  o << "    switch(_selection) {" << endl;
-  o << "    case no_selection: while(false); /* hack for coverage tool */ break;" << endl;
-  for (const auto &t : u.tables)
-    o << "    case _" << t.value << "_selection: delete _" << t.value << "; break;" << endl;
-  o << "    }" << endl;
-  o << "    no_value = nullptr;" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  union {" << endl;
-  o << "    struct NoValue_t *no_value{nullptr};" << endl;
-
-  for (const auto &t : u.tables)
-    o << "    " << t.value << " * _" << t.value << ";" << endl;
-  o << "  };" << endl << endl;
-  o << "  enum Selection_t {" << endl;
-  o << "    no_selection," << endl;
-  for (const auto &t : u.tables)
-    o << "    _" << t.value << "_selection," << endl;
-  o << "  };" << endl << endl;
-
-  o << "  Selection_t _selection{no_selection};" << endl;
-  if (hasSharedAppearance(u))
-    o << "  unsigned int io_counter_{0};" << endl;
-  o << "  friend struct " << root_type << "_io;" << endl;
-  o << "};" << endl << endl;
-}
-
-void WriteTypeStructs(ostream &o, const Package &p)
-{
-  if (someThingIsWeak(p))
-    WriteCompareOperatorForWeakPointer(o);
-
-  for (const auto &t : p.types)
-  {
-    if (t.is_Table())
-      WriteTableDeclaration(o, p, t.as_Table(), p.root_type.value);
-    else if (t.is_Union())
-      WriteUnionStruct(o, t.as_Union(), p.root_type.value);
-    else if (t.is_Enum())
-    {
-      WriteEnumDeclaration(o, t.as_Enum());
-      WriteEnumFunctions(o, t.as_Enum());
-    }
-    else if (t.is_Flag())
-      WriteFlag(o, t.as_Flag());
-  }
-}
-
-void WriteUnionOutput(ostream &o, const Union &u)
-{
-  o << "  void Write(std::ostream &o, const " << u.name << " &v) {" << endl;
-  o << "    o.write(reinterpret_cast<const char*>(&v._selection), sizeof(" << u.name << "::Selection_t));" << endl;
-  o << "    switch(v._selection) {" << endl;
-  o << "    case " << u.name << "::no_selection: while(false); /* hack for coverage tool */ break;" << endl;
-  for (const auto &t : u.tables)
-    o << "    case " << u.name << "::_" << t.value << "_selection: Write(o, v.as_" << t.value << "()); break;" << endl;
-  o << "    }" << endl;
-  o << "  }" << endl << endl;
-
-  WritePointerOutputFor(o, u);
-}
-
-void WriteUnionInput(ostream &o, const Union &u)
-{
-  o << "  void Read(std::istream &i, " << u.name << " &v) {" << endl;
-  o << "    i.read(reinterpret_cast<char*>(&v._selection), sizeof(" << u.name << "::Selection_t));" << endl;
-  o << "    switch(v._selection) {" << endl;
-  o << "    case " << u.name << "::no_selection: while(false); /* hack for coverage tool */ break;" << endl;
-  for (const auto &t : u.tables)
-    o << "    case " << u.name << "::_" << t.value << "_selection: Read(i, v.create_" << t.value << "()); break;"
-      << endl;
-  o << "    }" << endl;
-  o << "  }" << endl << endl;
-
-  WritePointerInputFor(o, u);
-}
-
-void WriteTablesIOFunctions(ostream &o, const vector<Type> &types)
-{
-  for (const auto &t : types)
-  {
-    if (t.is_Table())
-    {
-      WriteTableOutput(o, t.as_Table());
-      WriteTableInput(o, t.as_Table());
-    }
-    else if (t.is_Union())
-    {
-      WriteUnionOutput(o, t.as_Union());
-      WriteUnionInput(o, t.as_Union());
-    }
-  }
-}
-
-void WriteBaseIO(ostream &o, const Package &p)
-{
-  o << "  void Write" << p.root_type.value << "(std::ostream &o, const " << p.root_type.value << " &v) {" << endl;
-  for (const auto &t : p.types)
-    if (t.is_Table() && hasSharedAppearance(t.as_Table()))
-      o << "    " << t.as_Table().name << "_count_ = 0;" << endl;
-
-  o << endl << "    o.write(\"CORE\", 4);" << endl;
-  o << "    o.write(\"" << p.version.value << "\", " << p.version.value.size() << ");" << endl;
-  o << "    Write(o, v);" << endl;
-  o << "  }" << endl << endl;
-
-  o << "  bool Read" << p.root_type.value << "(std::istream &i, " << p.root_type.value << " &v) {" << endl;
-
-  for (const auto &t : p.types)
-    if (t.is_Table() && hasSharedAppearance(t.as_Table()))
-      o << "    " << t.as_Table().name << "_references_.clear();" << endl;
-
-  o << endl << "    std::string marker(\"0000\");" << endl;
-  o << "    i.read(&marker[0], 4);" << endl;
-  o << "    if (marker != \"CORE\")" << endl;
-  o << "      return false;" << endl;
-
-  o << "    std::string version(" << p.version.value.size() << ", '_');" << endl;
-  o << "    i.read(&version[0], " << p.version.value.size() << ");" << endl;
-  o << "    if (version != \"" << p.version.value << "\")" << endl;
-  o << "      return false;" << endl;
-
-  o << "    Read(i, v);" << endl;
-  o << "    return true;" << endl;
-  o << "  }" << endl << endl;
-}
-
-void WriteIOStructMember(const Package &p, ostream &o)
-{
-  for (const auto &t : p.types)
-  {
-    if (t.is_Table() && hasSharedAppearance(t.as_Table()))
-    {
-      o << "  unsigned int " << t.as_Table().name << "_count_{0};" << endl;
-      o << "  std::vector<std::shared_ptr<" << t.as_Table().name << ">> " << t.as_Table().name << "_references_;"
-        << endl
-        << endl;
-    }
-    else if (t.is_Union() && hasSharedAppearance(t.as_Union()))
-    {
-      o << "  unsigned int " << t.as_Union().name << "_count_{0};" << endl;
-      o << "  std::vector<std::shared_ptr<" << t.as_Union().name << ">> " << t.as_Union().name << "_references_;"
-        << endl
-        << endl;
-    }
-  }
-}
-
-void WriteIOStruct(ostream &o, const Package &p)
-{
-  o << "struct " << p.root_type.value << "_io {" << endl;
-  o << "private:" << endl;
-
-  WriteIOStructMember(p, o);
-  WriteBaseTypeIoFnuctions(o, p);
-  WriteTablesIOFunctions(o, p.types);
-
-  o << "public:" << endl;
-
-  WriteBaseIO(o, p);
-
-  o << "};" << endl;
-}
-
-void WriteHelperForNotImplementedTemplates(ostream &o)
-{
-  o << "template<typename T>" << endl;
-  o << "struct AlwaysFalse : std::false_type {};" << endl;
-}
-
-void WriteCppCode(ostream &o, const Package &p)
-{
-  o << "#pragma once" << endl << endl;
-
-  o << "#include <vector>" << endl;
-  o << "#include <string>" << endl;
-  o << "#include <ostream>" << endl;
-  o << "#include <istream>" << endl;
-  o << "#include <memory>" << endl;
-  o << "#include <array>" << endl;
-  o << "#include <algorithm>" << endl;
-  o << "#include <type_traits>" << endl << endl;
-
-  WriteNameSpaceBegin(o, p.path.value);
-  o << endl;
-
-  WriteHelperForNotImplementedTemplates(o);
-
-  WriteForwardDeclarations(o, p);
-  WriteTypeStructs(o, p);
-
-  WriteIOStruct(o, p);
-
-  WriteNameSpaceEnd(o, p.path.value);
-}
+#include "cppoutput.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <tuple>
+
+using namespace std;
+
+template <typename Predicate>
+bool any_table_of(const Package &p, const Predicate &pr)
+{
+  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &t) { return t.is_Table() && pr(t.as_Table()); }) ||
+         any_of(p.baseTypes.begin(), p.baseTypes.end(), pr);
+}
+
+template <typename Predicate>
+bool any_union_of(const Package &p, const Predicate &pr)
+{
+  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &u) { return u.is_Union() && pr(u.as_Union()); });
+}
+
+template <typename Predicate>
+bool any_enum_of(const Package &p, const Predicate &pr)
+{
+  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &u) { return u.is_Enum() && pr(u.as_Enum()); });
+}
+
+template <typename Predicate>
+bool any_flag_of(const Package &p, const Predicate &pr)
+{
+  return any_of(p.types.begin(), p.types.end(), [&pr](const Type &u) { return u.is_Flag() && pr(u.as_Flag()); });
+}
+
+template <class T>
+bool hasUniqueAppearance(const T &t)
+{
+  return ((t.appearance & UniqueAppearance) == UniqueAppearance) ||
+         ((t.appearance & UniqueVectorAppearance) == UniqueVectorAppearance);
+}
+
+bool someThingIsUnique(const Package &p)
+{
+  return any_table_of(p, hasUniqueAppearance<Table>) || any_union_of(p, hasUniqueAppearance<Union>);
+}
+
+template <class T>
+bool hasUniqueVectorAppearance(const T &t)
+{
+  return (t.appearance & UniqueVectorAppearance) == UniqueVectorAppearance;
+};
+
+bool someThingIsUniqueVector(const Package &p)
+{
+  return any_table_of(p, hasUniqueVectorAppearance<Table>) || any_union_of(p, hasUniqueVectorAppearance<Union>);
+}
+
+template <class T>
+bool hasSharedAppearance(const T &t)
+{
+  return ((t.appearance & SharedAppearance) == SharedAppearance) ||
+         ((t.appearance & SharedVectorAppearance) == SharedVectorAppearance);
+}
+
+bool someThingIsShared(const Package &p)
+{
+  return any_table_of(p, hasSharedAppearance<Table>) || any_union_of(p, hasSharedAppearance<Union>);
+}
+
+vector<string> sharedTypes(const Package &p)
+{
+  vector<string> shared;
+  for (const auto &t : p.types)
+  {
+    if (t.is_Table() && hasSharedAppearance(t.as_Table()))
+      shared.push_back(t.as_Table().name);
+    else if (t.is_Union() && hasSharedAppearance(t.as_Union()))
+      shared.push_back(t.as_Union().name);
+  }
+  return shared;
+}
+
+// the marker is followed by a revision byte of the header layout, revision 1 added the shared object counts
+const char *headerRevision = "\\x01";
+
+// marker, revision and package version are in front of the shared object counts
+size_t countsOffset(const Package &p)
+{
+  return 5 + p.version.value.size();
+}
+
+size_t headerSize(const Package &p)
+{
+  return countsOffset(p) + sharedTypes(p).size() * sizeof(uint32_t);
+}
+
+template <class T>
+bool hasSharedVectorAppearance(const T &t)
+{
+  return (t.appearance & SharedVectorAppearance) == SharedVectorAppearance;
+};
+
+bool someThingIsSharedVector(const Package &p)
+{
+  return any_table_of(p, hasSharedVectorAppearance<Table>) || any_union_of(p, hasSharedVectorAppearance<Union>);
+}
+
+template <class T>
+bool isComplex(const T &t)
+{
+  return t.isComplexType;
+}
+
+template <>
+bool isComplex(const Union &)
+{
+  return true;
+}
+
+template <class T>
+bool hasWeakAppearance(const T &t)
+{
+  return ((t.appearance & WeakAppearance) == WeakAppearance) ||
+         ((t.appearance & WeakVectorAppearance) == WeakVectorAppearance);
+}
+
+bool someThingIsWeak(const Package &p)
+{
+  return any_table_of(p, hasWeakAppearance<Table>) || any_union_of(p, hasWeakAppearance<Union>);
+}
+
+template <class T>
+bool hasWeakVectorAppearance(const T &t)
+{
+  return (t.appearance & WeakVectorAppearance) == WeakVectorAppearance;
+};
+
+bool someThingIsWeakVector(const Package &p)
+{
+  return any_table_of(p, hasWeakVectorAppearance<Table>) || any_union_of(p, hasWeakVectorAppearance<Union>);
+}
+
+template <class T>
+bool hasPlainVectorAppearance(const T &t)
+{
+  return ((t.appearance & VectorAppearance) == VectorAppearance);
+}
+
+bool hasVectorOfString(const Package &p)
+{
+  return any_table_of(p, [](const Table &t) {
+    return any_of(t.member.begin(), t.member.end(),
+                  [](const Member &m) { return m.isBaseType && m.isVector && m.type == "std::string"; });
+  });
+}
+
+bool hasPlainString(const Package &p)
+{
+  return any_table_of(p, [](const Table &t) {
+    return any_of(t.member.begin(), t.member.end(),
+                  [](const Member &m) { return m.isBaseType && !m.isVector && m.type == "std::string"; });
+  });
+}
+
+const Table *rootTable(const Package &p)
+{
+  for (const auto &t : p.types)
+    if (t.is_Table() && t.as_Table().name == p.root_type.value)
+      return &t.as_Table();
+  return nullptr;
+}
+
+bool isBulkVector(const Package &p, const Member &m)
+{
+  if (!m.isVector || m.pointer != Pointer::Plain)
+    return false;
+  if (any_union_of(p, [&m](const Union &u) { return u.name == m.type; }))
+    return false;
+  return !any_table_of(p, [&m](const Table &t) { return t.name == m.type && isComplex(t); });
+}
+
+bool reachesSharedPointer(const Package &p, const string &type, vector<string> &seen)
+{
+  if (find(seen.begin(), seen.end(), type) != seen.end())
+    return false;
+  seen.push_back(type);
+
+  for (const auto &t : p.types)
+  {
+    if (t.is_Table() && t.as_Table().name == type)
+      return any_of(t.as_Table().member.begin(), t.as_Table().member.end(), [&p, &seen](const Member &m) {
+        return m.pointer == Pointer::Shared || m.pointer == Pointer::Weak || reachesSharedPointer(p, m.type, seen);
+      });
+    if (t.is_Union() && t.as_Union().name == type)
+      return any_of(t.as_Union().tables.begin(), t.as_Union().tables.end(),
+                    [&p, &seen](const Attribute &a) { return reachesSharedPointer(p, a.value, seen); });
+  }
+  return false;
+}
+
+bool isSelfContainedVector(const Package &p, const Member &m)
+{
+  if (!m.isVector || isBulkVector(p, m) || (m.pointer != Pointer::Plain && m.pointer != Pointer::Unique))
+    return false;
+  vector<string> seen;
+  return !reachesSharedPointer(p, m.type, seen);
+}
+
+vector<const Member *> indexedRootVectors(const Package &p, const OutputOptions &options)
+{
+  vector<const Member *> members;
+  const auto *root = rootTable(p);
+  if (!options.indexedVectors || !root || !isComplex(*root))
+    return members;
+  for (const auto &m : root->member)
+    if (isSelfContainedVector(p, m))
+      members.push_back(&m);
+  return members;
+}
+
+vector<const Member *> parallelRootVectors(const Package &p)
+{
+  vector<const Member *> members;
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return members;
+  for (const auto &m : root->member)
+    if (isSelfContainedVector(p, m))
+      members.push_back(&m);
+  return members;
+}
+
+const Table *trackedRoot(const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!options.trackChanges || !root || !isComplex(*root))
+    return nullptr;
+  return root;
+}
+
+bool isRangeVector(const Package &p, const Member &m)
+{
+  return isBulkVector(p, m) || isSelfContainedVector(p, m);
+}
+
+bool isValueRange(const Package &p, const Member &m)
+{
+  return isBulkVector(p, m) && m.type != "std::string";
+}
+
+bool holdsReferences(const Package &p, const Member &m)
+{
+  vector<string> seen;
+  return m.pointer == Pointer::Shared || m.pointer == Pointer::Weak || reachesSharedPointer(p, m.type, seen);
+}
+
+const char *vectorTemplate(const OutputOptions &options)
+{
+  return options.pmr ? "std::pmr::vector" : "std::vector";
+}
+
+string stringType(const OutputOptions &options)
+{
+  return options.pmr ? "std::pmr::string" : "std::string";
+}
+
+const Table *findTable(const Package &p, const string &name)
+{
+  for (const auto &t : p.types)
+    if (t.is_Table() && t.as_Table().name == name)
+      return &t.as_Table();
+  return nullptr;
+}
+
+bool isAllocatorAware(const Package &p, const Member &m);
+
+bool isAllocatorAware(const Package &p, const Table &t)
+{
+  return any_of(t.member.begin(), t.member.end(), [&p](const Member &m) { return isAllocatorAware(p, m); });
+}
+
+bool isAllocatorAware(const Package &p, const Member &m)
+{
+  if (m.isVector || (m.pointer == Pointer::Plain && m.type == "std::string"))
+    return true;
+  const auto *t = findTable(p, m.type);
+  return m.pointer == Pointer::Plain && t && isAllocatorAware(p, *t);
+}
+
+bool isCopyable(const Package &p, const string &type, vector<string> &seen)
+{
+  if (find(seen.begin(), seen.end(), type) != seen.end())
+    return true;
+  seen.push_back(type);
+
+  for (const auto &t : p.types)
+  {
+    if (t.is_Table() && t.as_Table().name == type)
+      return all_of(t.as_Table().member.begin(), t.as_Table().member.end(), [&p, &seen](const Member &m) {
+        return m.pointer != Pointer::Unique && (m.pointer != Pointer::Plain || isCopyable(p, m.type, seen));
+      });
+    if (t.is_Union() && t.as_Union().name == type)
+      return all_of(t.as_Union().tables.begin(), t.as_Union().tables.end(),
+                    [&p, &seen](const Attribute &a) { return isCopyable(p, a.value, seen); });
+  }
+  return true;
+}
+
+string upperFirst(string name)
+{
+  if (!name.empty())
+    name[0] = static_cast<char>(toupper(static_cast<unsigned char>(name[0])));
+  return name;
+}
+
+bool isEnum(const Package &p, const string &type)
+{
+  return any_enum_of(p, [&type](const Enum &e) { return e.name == type; });
+}
+
+bool isFlag(const Package &p, const string &type)
+{
+  return any_flag_of(p, [&type](const Flag &e) { return e.name == type; });
+}
+
+void WriteNameSpaceBegin(ostream &o, const string &path, int pos = 0)
+{
+  if (path.empty())
+    return;
+
+  const auto end = path.find('.', pos);
+  o << "namespace " << path.substr(pos, end) << " {" << endl;
+  if (end != string::npos)
+    WriteNameSpaceBegin(o, path, int(end) + 1);
+}
+
+void WriteNameSpaceEnd(ostream &o, const string &path, int pos = 0)
+{
+  if (path.empty())
+    return;
+
+  const auto end = path.find('.', pos);
+  o << "}" << endl;
+  if (end != string::npos)
+    WriteNameSpaceEnd(o, path, int(end) + 1);
+}
+
+void WriteForwardDeclarations(ostream &o, const Package &p)
+{
+  for (const auto &t : p.types)
+    if (t.is_Table())
+      o << endl << "struct " << t.as_Table().name << ";";
+    else if (t.is_Union())
+      o << endl << "struct " << t.as_Union().name << ";";
+  o << endl << endl;
+}
+
+void WriteEnumDeclaration(ostream &o, const Enum &e)
+{
+  int64_t maxEntry = 0ul;
+  for (const auto &entry : e.entries)
+    maxEntry = max(entry.value, maxEntry);
+
+  string type = "std::int8_t";
+  if (maxEntry > numeric_limits<uint32_t>::max())
+    type = "std::int64_t";
+  else if (maxEntry > numeric_limits<uint16_t>::max())
+    type = "std::int32_t";
+  else if (maxEntry > numeric_limits<uint8_t>::max())
+    type = "std::int16_t";
+
+  o << "enum class " << e.name << " : " << type << " {" << endl;
+  for (const auto &v : e.entries)
+    o << "  " << v.name << " = " << v.value << "," << endl;
+  o << "};" << endl << endl;
+}
+
+void WriteEnumFunctions(ostream &o, const Enum &e)
+{
+  o << "inline const std::array<" << e.name << "," << e.entries.size() << "> & " << e.name << "Values() {" << endl;
+  o << "  static const std::array<" << e.name << "," << e.entries.size() << "> values {{" << endl;
+  for (const auto &v : e.entries)
+    o << "    " << e.name << "::" << v.name << "," << endl;
+  o << "  }};" << endl;
+  o << "  return values;" << endl;
+  o << "};" << endl << endl;
+
+  o << "inline const char * ValueName(const " << e.name << " &v) {" << endl;
+  o << "  switch(v) {" << endl;
+  for (const auto &v : e.entries)
+    o << "    case " << e.name << "::" << v.name << ": return \"" << v.name << "\";" << endl;
+  o << "  }" << endl;
+  o << "  return \"<error>\";" << endl;
+  o << "};" << endl << endl;
+}
+
+void WriteFlagDeclaration(ostream &o, const Flag &f, const string &intType)
+{
+  o << "struct " << f.name << " {" << endl;
+  o << "  enum value_t {" << endl;
+  o << "    _none = 0," << endl;
+  int64_t i = 1;
+  for (const auto &v : f.entries)
+  {
+    o << "    " << v.value << " = " << i << "," << endl;
+    i <<= 1;
+  }
+  o << "  };" << endl << endl;
+
+  o << "  inline " << f.name << "(value_t v = _none) : value(v) {}" << endl << endl;
+
+  o << "  bool operator[](const value_t &a) const { return (value & a) == a; }" << endl;
+  o << "  bool operator[](const " << f.name << " &a) const { return (value & a.value) == a.value; }" << endl;
+
+  o << "  friend bool operator==(const " << f.name << " &a, const " << f.name << " &b) { return a.value == b.value; }"
+    << endl;
+  o << "  friend bool operator!=(const " << f.name << " &a, const " << f.name << " &b) { return a.value != b.value; }"
+    << endl
+    << endl;
+
+  o << "  " << intType << " value;" << endl;
+
+  o << "};" << endl << endl;
+}
+
+void WriteFlagFunctions(ostream &o, const Flag &f, const string &intType)
+{
+  o << "inline " << f.name << " operator|(" << f.name << "::value_t a, " << f.name << "::value_t b)" << endl;
+  o << "{" << endl;
+  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a)) | (static_cast<" << intType << ">(b)));"
+    << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " operator|(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a.value)) | (static_cast<" << intType
+    << ">(b.value)));" << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " &operator|=(" << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return reinterpret_cast<" << f.name << " &>((reinterpret_cast<" << intType << " &>(a.value)) |= (static_cast<"
+    << intType << ">(b.value)));" << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " operator&(" << f.name << "::value_t a, " << f.name << "::value_t b)" << endl;
+  o << "{" << endl;
+  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a)) & (static_cast<" << intType << ">(b)));"
+    << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " operator&(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a.value)) & (static_cast<" << intType
+    << ">(b.value)));" << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " &operator&=(" << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return reinterpret_cast<" << f.name << " &>((reinterpret_cast<" << intType << " &>(a.value)) &= (static_cast<"
+    << intType << ">(b.value)));" << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " operator~(" << f.name << "::value_t a) { return " << f.name << "::value_t(~static_cast<"
+    << intType << ">(a)); }" << endl;
+  o << "inline " << f.name << " operator~(const " << f.name << " &a) { return " << f.name << "::value_t(~a.value); }"
+    << endl;
+  o << "inline " << f.name << " operator^(" << f.name << "::value_t a, " << f.name << "::value_t b)" << endl;
+  o << "{" << endl;
+  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a)) ^ (static_cast<" << intType << ">(b)));"
+    << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " operator^(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return " << f.name << "::value_t((static_cast<" << intType << ">(a.value)) ^ (static_cast<" << intType
+    << ">(b.value)));" << endl;
+  o << "}" << endl;
+  o << "inline " << f.name << " &operator^=(" << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return reinterpret_cast<" << f.name << " &>((reinterpret_cast<" << intType << " &>(a.value)) ^= (static_cast<"
+    << intType << ">(b.value)));" << endl;
+  o << "}" << endl;
+  o << "inline bool operator<(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return a.value < b.value;" << endl;
+  o << "}" << endl;
+  o << "inline bool operator>(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return a.value > b.value;" << endl;
+  o << "}" << endl;
+  o << "inline bool operator>=(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return a.value >= b.value;" << endl;
+  o << "}" << endl;
+  o << "inline bool operator<=(const " << f.name << " &a, const " << f.name << " &b)" << endl;
+  o << "{" << endl;
+  o << "  return a.value <= b.value;" << endl;
+  o << "}" << endl;
+  o << "" << endl;
+  o << "inline const std::array<" << f.name << "::value_t, 4> &" << f.name << "Values()" << endl;
+  o << "{" << endl;
+  o << "  static const std::array<" << f.name << "::value_t, 4> values{{" << endl;
+  o << "      " << f.name << "::alpha," << endl;
+  o << "      " << f.name << "::beta," << endl;
+  o << "      " << f.name << "::gamma," << endl;
+  o << "      " << f.name << "::delta," << endl;
+  o << "  }};" << endl;
+  o << "  return values;" << endl;
+  o << "};" << endl;
+  o << "" << endl;
+  o << "inline const char *ValueName(const " << f.name << "::value_t &v)" << endl;
+  o << "{" << endl;
+  o << "  switch (v)" << endl;
+  o << "  {" << endl;
+  o << "    default:" << endl;
+  o << "      break;" << endl;
+  o << "    case " << f.name << "::alpha:" << endl;
+  o << "      return \"alpha\";" << endl;
+  o << "    case " << f.name << "::beta:" << endl;
+  o << "      return \"beta\";" << endl;
+  o << "    case " << f.name << "::gamma:" << endl;
+  o << "      return \"gamma\";" << endl;
+  o << "    case " << f.name << "::delta:" << endl;
+  o << "      return \"delta\";" << endl;
+  o << "  }" << endl;
+  o << "  return \"<error>\";" << endl;
+  o << "};" << endl;
+}
+
+void WriteFlag(ostream &o, const Flag &f)
+{
+  int64_t maxEntry = 0ul;
+  int64_t i = 1;
+  for (const auto &e : f.entries)
+    maxEntry = max(i <<= 1, maxEntry);
+
+  string intType = "std::int8_t";
+  if (maxEntry > numeric_limits<uint32_t>::max())
+    intType = "std::int64_t";
+  else if (maxEntry > numeric_limits<uint16_t>::max())
+    intType = "std::int32_t";
+  else if (maxEntry > numeric_limits<uint8_t>::max())
+    intType = "std::int16_t";
+
+  WriteFlagDeclaration(o, f, intType);
+  WriteFlagFunctions(o, f, intType);
+}
+
+void WriteReferencesMember(ostream &o, const Package &p, const char *type)
+{
+  if (someThingIsShared(p))
+    o << "    " << type << " references;" << endl;
+}
+
+// the references of the sinks and sources are initialized empty, so the aggregate initializers name them too
+const char *referencesInit(const Package &p)
+{
+  return someThingIsShared(p) ? ", {}" : "";
+}
+
+void WriteOutputSinks(ostream &o, const Package &p)
+{
+  o << "  struct OutputBuffer {" << endl;
+  o << "    std::vector<char> &buffer;" << endl;
+  o << "    std::size_t size;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+
+  o << "  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {" << endl;
+  o << "    o.write(d, s);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // counts the written bytes itself, tellp() does not work for every stream" << endl;
+  o << "  struct OutputStream {" << endl;
+  o << "    std::ostream &stream;" << endl;
+  o << "    std::uint64_t size;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+
+  o << "  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {" << endl;
+  o << "    o.stream.write(d, s);" << endl;
+  o << "    o.size += s;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {" << endl;
+  o << "    if (o.buffer.size() - o.size < s)" << endl;
+  o << "      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));" << endl;
+  o << "    if (s != 0)" << endl;
+  o << "      std::memcpy(o.buffer.data() + o.size, d, s);" << endl;
+  o << "    o.size += s;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  struct OutputSpan {" << endl;
+  o << "    char *data;" << endl;
+  o << "    std::size_t size;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+
+  o << "  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {" << endl;
+  o << "    if (s != 0)" << endl;
+  o << "      std::memcpy(o.data + o.size, d, s);" << endl;
+  o << "    o.size += s;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  struct OutputCounter {" << endl;
+  o << "    std::size_t size;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+
+  o << "  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {" << endl;
+  o << "    o.size += s;" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteInputSources(ostream &o, const Package &p)
+{
+  o << "  struct InputBuffer {" << endl;
+  o << "    const char *data;" << endl;
+  o << "    std::size_t size;" << endl;
+  o << "    std::size_t pos;" << endl;
+  o << "    bool failed;" << endl;
+  WriteReferencesMember(o, p, "ReadReferences");
+  o << "  };" << endl << endl;
+
+  o << "  // positions are stream positions, size is the end of a stream that can seek or the maximum" << endl;
+  o << "  struct InputStream {" << endl;
+  o << "    std::istream &stream;" << endl;
+  o << "    std::uint64_t size;" << endl;
+  o << "    std::uint64_t pos;" << endl;
+  o << "    bool failed;" << endl;
+  WriteReferencesMember(o, p, "ReadReferences");
+  o << "  };" << endl << endl;
+
+  o << "  static InputStream MakeInput(std::istream &i) {" << endl;
+  o << "    const auto pos = i.tellg();" << endl;
+  o << "    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (pos == std::istream::pos_type(-1))" << endl;
+  o << "      return s;" << endl;
+  o << "    s.pos = static_cast<std::uint64_t>(pos);" << endl;
+  o << "    const auto end = i.seekg(0, std::ios::end).tellg();" << endl;
+  o << "    if (end != std::istream::pos_type(-1) && end >= pos)" << endl;
+  o << "      s.size = static_cast<std::uint64_t>(end);" << endl;
+  o << "    i.clear();" << endl;
+  o << "    i.seekg(pos);" << endl;
+  o << "    return s;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void Fail(InputStream &i) {" << endl;
+  o << "    if (!i.failed)" << endl;
+  o << "      error_offset_ = i.pos;" << endl;
+  o << "    i.failed = true;" << endl;
+  o << "    i.pos = i.size;" << endl;
+  o << "    i.stream.setstate(std::ios::failbit);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void Fail(InputBuffer &i) {" << endl;
+  o << "    if (!i.failed)" << endl;
+  o << "      error_offset_ = i.pos;" << endl;
+  o << "    i.failed = true;" << endl;
+  o << "    i.pos = i.size;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I> void Fail(I &i) {" << endl;
+  o << "    i.failed = true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void ReadBytes(InputStream &i, char *d, std::size_t s) {" << endl;
+  o << "    if (i.size - i.pos < s || !i.stream.read(d, s)) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      std::memset(d, 0, s);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    i.pos += s;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {" << endl;
+  o << "    if (i.size - i.pos < s) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      std::memset(d, 0, s);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    if (s != 0)" << endl;
+  o << "      std::memcpy(d, i.data + i.pos, s);" << endl;
+  o << "    i.pos += s;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Failed(InputStream &i) {" << endl;
+  o << "    return i.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Failed(InputBuffer &i) {" << endl;
+  o << "    return i.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Available(InputStream &i, std::size_t count, std::size_t size) {" << endl;
+  o << "    if (count <= (i.size - i.pos) / size)" << endl;
+  o << "      return true;" << endl;
+  o << "    Fail(i);" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {" << endl;
+  o << "    if (count <= (i.size - i.pos) / size)" << endl;
+  o << "      return true;" << endl;
+  o << "    Fail(i);" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // bytes known to follow, 0 for a stream that cannot tell its end" << endl;
+  o << "  static std::uint64_t Remaining(const InputStream &i) {" << endl;
+  o << "    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static std::uint64_t Remaining(const InputBuffer &i) {" << endl;
+  o << "    return i.size - i.pos;" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteCompactWireFunctions(ostream &o)
+{
+  o << "  template<typename O> void WriteVarint(O &o, std::uint64_t v) const {" << endl;
+  o << "    char b[10];" << endl;
+  o << "    std::size_t s = 0;" << endl;
+  o << "    while (v >= 0x80) {" << endl;
+  o << "      b[s++] = static_cast<char>(v | 0x80);" << endl;
+  o << "      v >>= 7;" << endl;
+  o << "    }" << endl;
+  o << "    b[s++] = static_cast<char>(v);" << endl;
+  o << "    WriteBytes(o, b, s);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I> void ReadVarint(I &i, std::uint64_t &v) {" << endl;
+  o << "    v = 0;" << endl;
+  o << "    for (unsigned int shift = 0; shift < 64; shift += 7) {" << endl;
+  o << "      char c = 0;" << endl;
+  o << "      ReadBytes(i, &c, 1);" << endl;
+  o << "      v |= std::uint64_t(static_cast<unsigned char>(c) & 0x7f) << shift;" << endl;
+  o << "      if ((c & 0x80) == 0)" << endl;
+  o << "        return;" << endl;
+  o << "    }" << endl;
+  o << "    Fail(i);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void ReadVarint(InputBuffer &i, std::uint64_t &v) {" << endl;
+  o << "    if (i.pos < i.size && (i.data[i.pos] & 0x80) == 0) {" << endl;
+  o << "      v = static_cast<unsigned char>(i.data[i.pos++]);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    v = 0;" << endl;
+  o << "    for (unsigned int shift = 0; shift < 64 && i.pos < i.size; shift += 7) {" << endl;
+  o << "      const auto c = static_cast<unsigned char>(i.data[i.pos++]);" << endl;
+  o << "      v |= std::uint64_t(c & 0x7f) << shift;" << endl;
+  o << "      if ((c & 0x80) == 0)" << endl;
+  o << "        return;" << endl;
+  o << "    }" << endl;
+  o << "    Fail(i);" << endl;
+  o << "  }" << endl << endl;
+
+  for (const auto &type : {"unsigned short", "unsigned int", "unsigned long", "unsigned long long"})
+  {
+    o << "  template<typename O> void Write(O &o, const " << type << " &v) const {" << endl;
+    o << "    WriteVarint(o, v);" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  template<typename I> void Read(I &i, " << type << " &v) {" << endl;
+    o << "    std::uint64_t u = 0;" << endl;
+    o << "    ReadVarint(i, u);" << endl;
+    o << "    if (u > std::numeric_limits<" << type << ">::max())" << endl;
+    o << "      Fail(i);" << endl;
+    o << "    v = static_cast<" << type << ">(u);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  for (const auto &type : {"short", "int", "long", "long long"})
+  {
+    o << "  template<typename O> void Write(O &o, const " << type << " &v) const {" << endl;
+    o << "    const auto u = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));" << endl;
+    o << "    WriteVarint(o, (u << 1) ^ (v < 0 ? ~std::uint64_t(0) : std::uint64_t(0)));" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  template<typename I> void Read(I &i, " << type << " &v) {" << endl;
+    o << "    std::uint64_t u = 0;" << endl;
+    o << "    ReadVarint(i, u);" << endl;
+    o << "    const auto d = static_cast<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));" << endl;
+    o << "    if (d < std::numeric_limits<" << type << ">::min() || d > std::numeric_limits<" << type << ">::max())"
+      << endl;
+    o << "      Fail(i);" << endl;
+    o << "    v = static_cast<" << type << ">(d);" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+void WriteCompressionFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  o << "  static constexpr std::size_t CompressedBlockSize() {" << endl;
+  o << "    return 1 << 16;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static void LzEmit(std::vector<char> &d, const char *literals, std::size_t count, std::size_t offset, std::size_t length) {"
+    << endl;
+  o << "    const auto extra = [&d](std::size_t v) {" << endl;
+  o << "      for (; v >= 255; v -= 255)" << endl;
+  o << "        d.push_back(static_cast<char>(255));" << endl;
+  o << "      d.push_back(static_cast<char>(v));" << endl;
+  o << "    };" << endl;
+  o << "    const auto matched = length == 0 ? 0 : length - 4;" << endl;
+  o << "    d.push_back(static_cast<char>((std::min<std::size_t>(count, 15) << 4) | std::min<std::size_t>(matched, 15)));"
+    << endl;
+  o << "    if (count >= 15)" << endl;
+  o << "      extra(count - 15);" << endl;
+  o << "    d.insert(d.end(), literals, literals + count);" << endl;
+  o << "    if (length == 0)" << endl;
+  o << "      return;" << endl;
+  o << "    d.push_back(static_cast<char>(offset & 0xff));" << endl;
+  o << "    d.push_back(static_cast<char>(offset >> 8));" << endl;
+  o << "    if (matched >= 15)" << endl;
+  o << "      extra(matched - 15);" << endl;
+  o << "  }" << endl << endl;
+  o << "  static void LzCompress(const char *s, std::size_t size, std::vector<char> &d) {" << endl;
+  o << "    std::vector<std::uint32_t> table(1 << 12, 0);" << endl;
+  o << "    d.clear();" << endl;
+  o << "    std::size_t anchor = 0;" << endl;
+  o << "    std::size_t pos = 0;" << endl;
+  o << "    while (size >= 4 && pos <= size - 4) {" << endl;
+  o << "      std::uint32_t sequence;" << endl;
+  o << "      std::memcpy(&sequence, s + pos, 4);" << endl;
+  o << "      auto &entry = table[(sequence * 2654435761u) >> 20];" << endl;
+  o << "      const std::size_t candidate = entry;" << endl;
+  o << "      entry = static_cast<std::uint32_t>(pos + 1);" << endl;
+  o << "      if (candidate == 0 || pos + 1 - candidate > 0xffff || std::memcmp(s + candidate - 1, s + pos, 4) != 0) {"
+    << endl;
+  o << "        ++pos;" << endl;
+  o << "        continue;" << endl;
+  o << "      }" << endl;
+  o << "      const auto match = candidate - 1;" << endl;
+  o << "      std::size_t length = 4;" << endl;
+  o << "      while (pos + length < size && s[match + length] == s[pos + length])" << endl;
+  o << "        ++length;" << endl;
+  o << "      LzEmit(d, s + anchor, pos - anchor, pos - match, length);" << endl;
+  o << "      pos += length;" << endl;
+  o << "      anchor = pos;" << endl;
+  o << "    }" << endl;
+  o << "    LzEmit(d, s + anchor, size - anchor, 0, 0);" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool LzDecompress(const char *s, std::size_t size, char *d, std::size_t capacity) {" << endl;
+  o << "    std::size_t in = 0;" << endl;
+  o << "    std::size_t out = 0;" << endl;
+  o << "    const auto extra = [s, size, &in](std::size_t &v) {" << endl;
+  o << "      unsigned char b = 255;" << endl;
+  o << "      while (b == 255) {" << endl;
+  o << "        if (in == size)" << endl;
+  o << "          return false;" << endl;
+  o << "        b = static_cast<unsigned char>(s[in++]);" << endl;
+  o << "        v += b;" << endl;
+  o << "      }" << endl;
+  o << "      return true;" << endl;
+  o << "    };" << endl;
+  o << "    while (in < size) {" << endl;
+  o << "      const auto token = static_cast<unsigned char>(s[in++]);" << endl;
+  o << "      std::size_t count = token >> 4;" << endl;
+  o << "      if (count == 15 && !extra(count))" << endl;
+  o << "        return false;" << endl;
+  o << "      if (count > size - in || count > capacity - out)" << endl;
+  o << "        return false;" << endl;
+  o << "      std::memcpy(d + out, s + in, count);" << endl;
+  o << "      in += count;" << endl;
+  o << "      out += count;" << endl;
+  o << "      if (in == size)" << endl;
+  o << "        break;" << endl;
+  o << "      if (size - in < 2)" << endl;
+  o << "        return false;" << endl;
+  o << "      const std::size_t offset = static_cast<unsigned char>(s[in]) | (static_cast<unsigned char>(s[in + 1]) << 8);"
+    << endl;
+  o << "      in += 2;" << endl;
+  o << "      std::size_t length = token & 15;" << endl;
+  o << "      if (length == 15 && !extra(length))" << endl;
+  o << "        return false;" << endl;
+  o << "      length += 4;" << endl;
+  o << "      if (offset == 0 || offset > out || length > capacity - out)" << endl;
+  o << "        return false;" << endl;
+  o << "      if (offset >= length)" << endl;
+  o << "        std::memcpy(d + out, d + out - offset, length);" << endl;
+  o << "      else" << endl;
+  o << "        for (std::size_t i = 0; i < length; ++i)" << endl;
+  o << "          d[out + i] = d[out + i - offset];" << endl;
+  o << "      out += length;" << endl;
+  o << "    }" << endl;
+  o << "    return out == capacity;" << endl;
+  o << "  }" << endl << endl;
+  o << "  struct CompressedOutput {" << endl;
+  o << "    std::ostream &stream;" << endl;
+  o << "    std::vector<char> block;" << endl;
+  o << "    std::vector<char> compressed;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+  o << "  void FlushBlock(CompressedOutput &o) const {" << endl;
+  o << "    if (o.block.empty())" << endl;
+  o << "      return;" << endl;
+  o << "    LzCompress(o.block.data(), o.block.size(), o.compressed);" << endl;
+  o << "    const auto &data = o.compressed.size() < o.block.size() ? o.compressed : o.block;" << endl;
+  o << "    " << (options.portableWire ? "" : "const ")
+    << "std::uint32_t sizes[2] = {static_cast<std::uint32_t>(o.block.size()), static_cast<std::uint32_t>(data.size())};"
+    << endl;
+  if (options.portableWire)
+    o << "    WireOrder(sizes, 2);" << endl;
+  o << "    o.stream.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));" << endl;
+  o << "    o.stream.write(data.data(), data.size());" << endl;
+  o << "    o.block.clear();" << endl;
+  o << "  }" << endl << endl;
+  o << "  void WriteBytes(CompressedOutput &o, const char *d, std::size_t s) const {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      const auto n = std::min(s, CompressedBlockSize() - o.block.size());" << endl;
+  o << "      o.block.insert(o.block.end(), d, d + n);" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= n;" << endl;
+  o << "      if (o.block.size() == CompressedBlockSize())" << endl;
+  o << "        FlushBlock(o);" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+  o << "  // offset counts the decompressed bytes of all blocks before the current one" << endl;
+  o << "  struct CompressedInput {" << endl;
+  o << "    InputStream source;" << endl;
+  o << "    std::vector<char> block;" << endl;
+  o << "    std::vector<char> compressed;" << endl;
+  o << "    std::size_t pos;" << endl;
+  o << "    std::uint64_t offset;" << endl;
+  o << "    bool failed;" << endl;
+  WriteReferencesMember(o, p, "ReadReferences");
+  o << "  };" << endl << endl;
+  o << "  bool NextBlock(CompressedInput &i) {" << endl;
+  o << "    std::uint32_t sizes[2] = {0, 0};" << endl;
+  o << "    ReadBytes(i.source, reinterpret_cast<char *>(sizes), sizeof(sizes));" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(sizes, 2);" << endl;
+  o << "    if (i.source.failed || sizes[0] == 0 || sizes[0] > CompressedBlockSize() || sizes[1] > sizes[0])" << endl;
+  o << "      return false;" << endl;
+  o << "    i.offset += i.block.size();" << endl;
+  o << "    i.block.resize(sizes[0]);" << endl;
+  o << "    i.pos = 0;" << endl;
+  o << "    if (sizes[1] == sizes[0]) {" << endl;
+  o << "      ReadBytes(i.source, i.block.data(), sizes[0]);" << endl;
+  o << "      return !i.source.failed;" << endl;
+  o << "    }" << endl;
+  o << "    i.compressed.resize(sizes[1]);" << endl;
+  o << "    ReadBytes(i.source, i.compressed.data(), sizes[1]);" << endl;
+  o << "    return !i.source.failed && LzDecompress(i.compressed.data(), sizes[1], i.block.data(), sizes[0]);" << endl;
+  o << "  }" << endl << endl;
+  o << "  void ReadBytes(CompressedInput &i, char *d, std::size_t s) {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      if (i.pos == i.block.size() && (i.failed || !NextBlock(i))) {" << endl;
+  o << "        Fail(i);" << endl;
+  o << "        std::memset(d, 0, s);" << endl;
+  o << "        return;" << endl;
+  o << "      }" << endl;
+  o << "      const auto n = std::min(s, i.block.size() - i.pos);" << endl;
+  o << "      std::memcpy(d, i.block.data() + i.pos, n);" << endl;
+  o << "      i.pos += n;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= n;" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+  o << "  bool Failed(CompressedInput &i) {" << endl;
+  o << "    return i.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void Fail(CompressedInput &i) {" << endl;
+  o << "    if (!i.failed)" << endl;
+  o << "      error_offset_ = i.offset + i.pos;" << endl;
+  o << "    i.failed = true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // a compressed byte never expands to more than 255 bytes, the bound keeps lengths from garbage in check" << endl;
+  o << "  static std::uint64_t Remaining(const CompressedInput &i) {" << endl;
+  o << "    const auto stream = i.source.size - i.source.pos;" << endl;
+  o << "    const auto limit = std::numeric_limits<std::uint64_t>::max() / 256;" << endl;
+  o << "    return i.block.size() - i.pos + (stream > limit ? limit : stream) * 255;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Available(CompressedInput &i, std::size_t count, std::size_t size) {" << endl;
+  o << "    if (!i.failed && count <= Remaining(i) / size)" << endl;
+  o << "      return true;" << endl;
+  o << "    Fail(i);" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl;
+}
+
+void WriteBaseTypeIoFnuctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  static const auto notImplementedAssert = "    static_assert(AlwaysFalse<T>::value, \"Something not implemented\");";
+
+  WriteOutputSinks(o, p);
+
+  o << "  template<typename O, typename T> void Write(O &, const T *) const {" << endl;
+  o << notImplementedAssert << endl;
+  o << "  }" << endl << endl;
+
+  if (options.portableWire)
+  {
+    o << "  static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), \"the portable wire format has 64 bit lengths\");"
+      << endl << endl;
+
+    o << "  template<typename O, typename T> void Write(O &o, const T &v) const {" << endl;
+    o << "    T w = v;" << endl;
+    o << "    WireOrder(&w, 1);" << endl;
+    o << "    WriteBytes(o, reinterpret_cast<const char *>(&w), sizeof(T));" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {" << endl;
+    o << "#if COREBUFFER_BIG_ENDIAN" << endl;
+    o << "    char b[4096];" << endl;
+    o << "    for (std::size_t n = 0; n < count;) {" << endl;
+    o << "      const auto s = std::min(count - n, sizeof(b) / sizeof(T));" << endl;
+    o << "      SwapBytes(b, reinterpret_cast<const char *>(v + n), s, sizeof(T));" << endl;
+    o << "      WriteBytes(o, b, s * sizeof(T));" << endl;
+    o << "      n += s;" << endl;
+    o << "    }" << endl;
+    o << "#else" << endl;
+    o << "    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);" << endl;
+    o << "#endif" << endl;
+    o << "  }" << endl << endl;
+  }
+  else
+  {
+    o << "  template<typename O, typename T> void Write(O &o, const T &v) const {" << endl;
+    o << "    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {" << endl;
+    o << "    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<typename O, typename T> void Write(O &o, const " << vectorTemplate(options) << "<T> &v) const {"
+    << endl;
+  o << "    Write(o, v.size());" << endl;
+  o << "    WriteValues(o, v.data(), v.size());" << endl;
+  o << "  }" << endl << endl;
+
+  if (hasVectorOfString(p))
+  {
+    o << "  template<typename O> void Write(O &o, const " << vectorTemplate(options) << "<" << stringType(options)
+      << "> &v) const {" << endl;
+    o << "    Write(o, v.size());" << endl;
+    o << "    for (const auto &entry : v)" << endl;
+    o << "      Write(o, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsUnique(p))
+  {
+    o << "  template<typename O, typename T> void Write(O &o, const std::unique_ptr<T> &v) const {" << endl;
+    o << "    if (!v) {" << endl;
+    o << "      WriteBytes(o, \"\\x0\", 1);" << endl;
+    o << "    } else {" << endl;
+    o << "      WriteBytes(o, \"\\x1\", 1);" << endl;
+    o << "      Write(o, *v);" << endl;
+    o << "    }" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsShared(p))
+  {
+    o << "  template<typename O, typename T> void Write(O &o, const std::shared_ptr<T> &v, "
+         "std::unordered_map<const T *, unsigned int> &ids) const {"
+      << endl;
+    o << "    if (!v) {" << endl;
+    o << "      WriteBytes(o, \"\\x0\", 1);" << endl;
+    o << "      return;" << endl;
+    o << "    }" << endl;
+    o << "    const auto entry = ids.emplace(v.get(), static_cast<unsigned int>(ids.size() + 1));" << endl;
+    o << "    if (entry.second) {" << endl;
+    o << "      WriteBytes(o, \"\\x1\", 1);" << endl;
+    o << "      Write(o, *v);" << endl;
+    o << "    } else {" << endl;
+    o << "      WriteBytes(o, \"\\x2\", 1);" << endl;
+    o << "      Write(o, entry.first->second);" << endl;
+    o << "    }" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsUniqueVector(p))
+  {
+    o << "  template<typename O, typename T> void Write(O &o, const " << vectorTemplate(options)
+      << "<std::unique_ptr<T>> &v) const {" << endl;
+    o << "    Write(o, v.size());" << endl;
+    o << "    for (const auto &entry : v)" << endl;
+    o << "      Write(o, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsSharedVector(p))
+  {
+    o << "  template<typename O, typename T> void Write(O &o, const " << vectorTemplate(options)
+      << "<std::shared_ptr<T>> &v) const {" << endl;
+    o << "    Write(o, v.size());" << endl;
+    o << "    for (const auto &entry : v)" << endl;
+    o << "      Write(o, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsWeakVector(p))
+  {
+    o << "  template<typename O, typename T> void Write(O &o, const " << vectorTemplate(options)
+      << "<std::weak_ptr<T>> &v) const {" << endl;
+    o << "    Write(o, v.size());" << endl;
+    o << "    for (const auto &entry : v)" << endl;
+    o << "      Write(o, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {" << endl;
+  o << notImplementedAssert << endl;
+  o << "  }" << endl << endl;
+
+  if (someThingIsWeak(p))
+  {
+    o << "  template<typename O, typename T> void Write(O &, const std::weak_ptr<T> &) const {" << endl;
+    o << notImplementedAssert << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (hasPlainString(p))
+  {
+    o << "  template<typename O> void Write(O &o, const " << stringType(options) << " &v) const {" << endl;
+    o << "    Write(o, v.size());" << endl;
+    o << "    WriteBytes(o, v.data(), v.size());" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  WriteInputSources(o, p);
+  if (options.compressed)
+    WriteCompressionFunctions(o, p, options);
+
+  if (options.compactWire)
+    WriteCompactWireFunctions(o);
+
+  o << "  template<typename I, typename T> void Read(I &i, T &v) {" << endl;
+  o << "    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(&v, 1);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {" << endl;
+  o << "    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(v, count);" << endl;
+  o << "  }" << endl << endl;
+
+  if (someThingIsUnique(p))
+  {
+    o << "  template<typename I, typename T> void Read(I &i, std::unique_ptr<T> &v) {" << endl;
+    o << "    char ref = 0;" << endl;
+    o << "    ReadBytes(i, &ref, 1);" << endl;
+    o << "    if (ref == '\\x1') {" << endl;
+    o << "      v = std::unique_ptr<T>(new T);" << endl;
+    o << "      Read(i, *v);" << endl;
+    o << "    } else {" << endl;
+    o << "      if (ref != '\\0')" << endl;
+    o << "        Fail(i);" << endl;
+    o << "      v.reset();" << endl;
+    o << "    }" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {" << endl;
+  o << notImplementedAssert << endl;
+  o << "  }" << endl << endl;
+
+  if (someThingIsWeak(p))
+  {
+    o << "  template<typename I, typename T> void Read(I &, std::weak_ptr<T> &) {" << endl;
+    o << notImplementedAssert << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsShared(p))
+  {
+    o << "  template<typename I, typename T> void Read(I &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache, "
+         "std::uint32_t count) {"
+      << endl;
+    o << "    char ref = 0;" << endl;
+    o << "    ReadBytes(s, &ref, 1);" << endl;
+    o << "    if (ref == '\\x1') {" << endl;
+    o << "      // every object takes at least a byte, a count larger than the input left is no reason to allocate" << endl;
+    o << "      if (cache.empty())" << endl;
+    o << "        cache.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, Remaining(s))));" << endl;
+    o << "      v = std::make_shared<T>();" << endl;
+    o << "      cache.push_back(v);" << endl;
+    o << "      Read(s, *v);" << endl;
+    o << "    } else if (ref == '\\x2') {" << endl;
+    o << "      unsigned int index = 0;" << endl;
+    o << "      Read(s, index);" << endl;
+    o << "      if (index == 0 || index > cache.size()) {" << endl;
+    o << "        Fail(s);" << endl;
+    o << "        v.reset();" << endl;
+    o << "      } else {" << endl;
+    o << "        v = cache[index - 1];" << endl;
+    o << "      }" << endl;
+    o << "    } else {" << endl;
+    o << "      if (ref != '\\0')" << endl;
+    o << "        Fail(s);" << endl;
+    o << "      v.reset();" << endl;
+    o << "    }" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsUniqueVector(p))
+  {
+    o << "  template<typename I, typename T> void Read(I &s, " << vectorTemplate(options)
+      << "<std::unique_ptr<T>> &v) {" << endl;
+    o << "    auto size = v.size();" << endl;
+    o << "    Read(s, size);" << endl;
+    o << "    if (!Available(s, size, 1))" << endl;
+    o << "      return;" << endl;
+    o << "    v.resize(size);" << endl;
+    o << "    for (auto &entry : v)" << endl;
+    o << "      Read(s, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsSharedVector(p))
+  {
+    o << "  template<typename I, typename T> void Read(I &s, " << vectorTemplate(options)
+      << "<std::shared_ptr<T>> &v) {" << endl;
+    o << "    auto size = v.size();" << endl;
+    o << "    Read(s, size);" << endl;
+    o << "    if (!Available(s, size, 1))" << endl;
+    o << "      return;" << endl;
+    o << "    v.resize(size);" << endl;
+    o << "    for (auto &entry : v)" << endl;
+    o << "      Read(s, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (someThingIsWeakVector(p))
+  {
+    o << "  template<typename I, typename T> void Read(I &s, " << vectorTemplate(options)
+      << "<std::weak_ptr<T>> &v) {" << endl;
+    o << "    auto size = v.size();" << endl;
+    o << "    Read(s, size);" << endl;
+    o << "    if (!Available(s, size, 1))" << endl;
+    o << "      return;" << endl;
+    o << "    v.resize(size);" << endl;
+    o << "    for (auto &entry : v)" << endl;
+    o << "      Read(s, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<typename I, typename T> void Read(I &i, " << vectorTemplate(options) << "<T> &v) {" << endl;
+  o << "    typename " << vectorTemplate(options) << "<T>::size_type s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (!Available(i, s, sizeof(T)))" << endl;
+  o << "      return;" << endl;
+  o << "    v.resize(s);" << endl;
+  o << "    ReadValues(i, v.data(), s);" << endl;
+  o << "  }" << endl << endl;
+
+  if (hasVectorOfString(p))
+  {
+    o << "  template<typename I> void Read(I &i, " << vectorTemplate(options) << "<" << stringType(options)
+      << "> &v) {" << endl;
+    o << "    auto size = v.size();" << endl;
+    o << "    Read(i, size);" << endl;
+    o << "    if (!Available(i, size, " << (options.compactWire ? "1" : "sizeof(std::string::size_type)") << "))" << endl;
+    o << "      return;" << endl;
+    o << "    v.resize(size);" << endl;
+    o << "    for (auto &entry : v)" << endl;
+    o << "      Read(i, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  if (hasPlainString(p))
+  {
+    o << "  template<typename I> void Read(I &i, " << stringType(options) << " &v) {" << endl;
+    o << "    std::string::size_type s{0};" << endl;
+    o << "    Read(i, s);" << endl;
+    o << "    if (!Available(i, s, 1))" << endl;
+    o << "      return;" << endl;
+    o << "    v.resize(s);" << endl;
+    o << "    ReadBytes(i, &v[0], s);" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+ostream &WriteType(ostream &o, const Member &m, const OutputOptions &options)
+{
+  if (m.isVector)
+    o << vectorTemplate(options) << "<";
+  if (m.pointer == Pointer::Weak)
+    o << "std::weak_ptr<";
+  if (m.pointer == Pointer::Unique)
+    o << "std::unique_ptr<";
+  if (m.pointer == Pointer::Shared)
+    o << "std::shared_ptr<";
+  o << (m.type == "std::string" ? stringType(options) : m.type);
+  if (m.pointer != Pointer::Plain)
+    o << ">";
+  if (m.isVector)
+    o << ">";
+  return o;
+}
+
+ostream &WriteParameterType(ostream &o, const Member &m, const OutputOptions &options)
+{
+  if (m.pointer != Pointer::Unique)
+    o << "const ";
+
+  auto mm = m;
+  if (!m.isVector && m.pointer == Pointer::Weak)
+    mm.pointer = Pointer::Shared;
+
+  WriteType(o, mm, options) << " ";
+  if (m.pointer != Pointer::Unique)
+    o << "&";
+
+  return o << m.name << "_";
+}
+
+std::pair<int, const Member *> memberEntry(const Table &t, const string &name)
+{
+  int i = 0;
+  for (const auto &m : t.member)
+  {
+    if (m.name == name)
+      return make_pair(i, &m);
+    ++i;
+  }
+  throw std::runtime_error("Member not defined!");
+}
+
+std::vector<std::pair<int, const Member *>> indexParameter(const Table &t, const Method &m)
+{
+  std::vector<std::pair<int, const Member *>> parameter;
+
+  for (const auto &p : m.parameter)
+    parameter.emplace_back(memberEntry(t, p.name));
+
+  return parameter;
+}
+
+void WriteTableInitializer(ostream &o, const Table &t, const OutputOptions &options)
+{
+  o << endl << "  " << t.name << "() = default;" << endl;
+  for (const auto &method : t.methods)
+  {
+    if (method.name != "init")
+      continue;
+
+    auto parameter = indexParameter(t, method);
+    o << "  " << t.name << "(";
+    string comma;
+    for (const auto &p : parameter)
+    {
+      o << comma;
+      WriteParameterType(o, *p.second, options);
+      comma = ", ";
+    }
+    o << ")" << endl;
+    comma = ": ";
+    std::sort(parameter.begin(), parameter.end());
+    for (const auto &p : parameter)
+    {
+      bool isUnique = p.second->pointer == Pointer::Unique;
+      o << "    " << comma << p.second->name << "(";
+      if (isUnique)
+        o << "std::move(" << p.second->name << "_))" << endl;
+      else
+        o << p.second->name << "_)" << endl;
+      comma = ", ";
+    }
+    o << "  {}" << endl;
+  }
+}
+
+string defaultValueLiteral(const Member &m)
+{
+  if (m.isBaseType)
+  {
+    if (m.type == "float")
+      return m.defaultValue.value.back() == 'f' ? "" : "f";
+    else if (m.type.find("std::u") == 0)
+      return m.defaultValue.value.back() == 'u' ? "" : "u";
+  }
+  return string();
+}
+
+void WriteTableCompareFunctions(ostream &o, const Table &t)
+{
+  o << endl << "  friend bool operator==(const " << t.name << "&l, const " << t.name << "&r) {" << endl;
+  o << "    return ";
+  bool first = true;
+  for (const auto &m : t.member)
+  {
+    o << endl << "      " << (first ? "" : "&& ") << "l." << m.name << " == r." << m.name;
+    first = false;
+  }
+  o << ";" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  friend bool operator!=(const " << t.name << "&l, const " << t.name << "&r) {" << endl;
+  o << "    return ";
+  first = true;
+  for (const auto &m : t.member)
+  {
+    o << endl << "      " << (first ? "" : "|| ") << "l." << m.name << " != r." << m.name;
+    first = false;
+  }
+  o << ";" << endl;
+  o << "  }" << endl;
+}
+
+void WriteMemberVectorFunctions(ostream &o, const Package &p, const Member &m, const OutputOptions &options,
+                                bool tracked)
+{
+  if (!m.isVector)
+    return;
+
+  const auto mark = tracked ? "    mark_" + m.name + "();\n" : string();
+  o << endl;
+  if (m.pointer != Pointer::Unique)
+  {
+    o << "  template<class T> void fill_" << m.name << "(const T &v) {" << endl;
+    o << "    std::fill(" << m.name << ".begin(), " << m.name << ".end(), v);" << endl;
+    o << mark << "  }" << endl << endl;
+  }
+
+  o << "  template<class Generator> void generate_" << m.name << "(Generator gen) {" << endl;
+  o << "    std::generate(" << m.name << ".begin(), " << m.name << ".end(), gen);" << endl;
+  o << mark << "  }" << endl << endl;
+
+  for (const auto &remove : {string("remove"), string("remove_if")})
+  {
+    o << "  template<class " << (remove == "remove" ? "T" : "Pred") << "> ";
+    WriteType(o, m, options) << "::iterator remove_" << m.name << remove.substr(6) << "("
+                              << (remove == "remove" ? "const T &v" : "Pred v") << ") {" << endl;
+    if (!tracked)
+    {
+      o << "    return std::" << remove << "(" << m.name << ".begin(), " << m.name << ".end(), v);" << endl;
+      o << "  }" << endl;
+      continue;
+    }
+    o << "    const auto first = std::" << (remove == "remove" ? "find" : "find_if") << "(" << m.name << ".begin(), "
+      << m.name << ".end(), v);" << endl;
+    o << "    mark_" << m.name << "(static_cast<std::size_t>(first - " << m.name << ".begin()), " << m.name
+      << ".size());" << endl;
+    o << "    return std::" << remove << "(first, " << m.name << ".end(), v);" << endl;
+    o << "  }" << endl;
+  }
+  o << endl;
+
+  o << "  template<class T> void erase_" << m.name << "(const T &v) {" << endl;
+  o << "    " << m.name << ".erase(remove_" << m.name << "(v));" << endl;
+  o << "  }" << endl;
+  o << "  template<class Pred> void erase_" << m.name << "_if(Pred v) {" << endl;
+  o << "    " << m.name << ".erase(remove_" << m.name << "_if(v));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void reverse_" << m.name << "() {" << endl;
+  o << "    std::reverse(" << m.name << ".begin(), " << m.name << ".end());" << endl;
+  o << mark << "  }" << endl << endl;
+
+  o << "  void rotate_" << m.name << "(";
+  WriteType(o, m, options) << "::iterator i) {" << endl;
+  o << "    std::rotate(" << m.name << ".begin(), i, " << m.name << ".end());" << endl;
+  o << mark << "  }" << endl << endl;
+
+  if (m.isBaseType || isEnum(p, m.type) || isFlag(p, m.type))
+  {
+    o << "  void sort_" << m.name << "() {" << endl;
+    o << "    std::sort(" << m.name << ".begin(), " << m.name << ".end());" << endl;
+    o << mark << "  }" << endl;
+  }
+  o << "  template<class Comp> void sort_" << m.name << "(Comp p) {" << endl;
+  o << "    std::sort(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << mark << "  }" << endl << endl;
+
+  o << "  template<class Comp> bool any_of_" << m.name << "(Comp p) {" << endl;
+  o << "    return std::any_of(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl;
+  o << "  template<class T> bool any_of_" << m.name << "_is(const T &p) {" << endl;
+  o << "    return any_of_" << m.name << "([&p](const ";
+  auto mm = m;
+  mm.isVector = false;
+  auto mmm = mm;
+  mmm.pointer = Pointer::Shared;
+  WriteType(o, mm, options) << " &x) { return ";
+  if (m.pointer == Pointer::Weak)
+    o << "x.lock() && ";
+  else if (m.pointer != Pointer::Plain)
+    o << "x && ";
+  o << (m.pointer != Pointer::Plain ? "*" : "") << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });"
+    << endl;
+  o << "  }" << endl << endl;
+  if (m.pointer == Pointer::Shared || m.pointer == Pointer::Weak)
+  {
+    o << "  bool any_of_" << m.name << "_is(const ";
+    WriteType(o, mmm, options) << " &p) {" << endl;
+    o << "    return any_of_" << m.name << "([&p](const ";
+    WriteType(o, mm, options) << " &x) { return ";
+    o << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<class Comp> bool all_of_" << m.name << "(Comp p) {" << endl;
+  o << "    return std::all_of(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl;
+  o << "  template<class T> bool all_of_" << m.name << "_are(const T &p) {" << endl;
+  o << "    return all_of_" << m.name << "([&p](const ";
+  WriteType(o, mm, options) << " &x) { return ";
+  if (m.pointer == Pointer::Weak)
+    o << "x.lock() && ";
+  else if (m.pointer != Pointer::Plain)
+    o << "x && ";
+  o << (m.pointer != Pointer::Plain ? "*" : "") << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });"
+    << endl;
+  o << "  }" << endl << endl;
+  if (m.pointer == Pointer::Shared || m.pointer == Pointer::Weak)
+  {
+    o << "  bool all_of_" << m.name << "_are(const ";
+    WriteType(o, mmm, options) << " &p) {" << endl;
+    o << "    return all_of_" << m.name << "([&p](const ";
+    WriteType(o, mm, options) << " &x) { return ";
+    o << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<class Comp> bool none_of_" << m.name << "(Comp p) {" << endl;
+  o << "    return std::none_of(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl;
+  o << "  template<class T> bool none_of_" << m.name << "_is(const T &p) {" << endl;
+  o << "    return none_of_" << m.name << "([&p](const ";
+  WriteType(o, mm, options) << " &x) { return ";
+  if (m.pointer == Pointer::Weak)
+    o << "x.lock() && ";
+  else if (m.pointer != Pointer::Plain)
+    o << "x && ";
+  o << (m.pointer != Pointer::Plain ? "*" : "") << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });"
+    << endl;
+  o << "  }" << endl << endl;
+  if (m.pointer == Pointer::Shared || m.pointer == Pointer::Weak)
+  {
+    o << "  bool none_of_" << m.name << "_is(const ";
+    WriteType(o, mmm, options) << " &p) {" << endl;
+    o << "    return none_of_" << m.name << "([&p](const ";
+    WriteType(o, mm, options) << " &x) { return ";
+    o << "x" << (m.pointer == Pointer::Weak ? ".lock()" : "") << " == p; });" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  template<class Fn> Fn for_each_" << m.name << "(Fn p) {" << endl;
+  o << "    return std::for_each(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<class T> ";
+  WriteType(o, m, options) << "::iterator find_in_" << m.name << "(const T &p) {" << endl;
+  o << "    return std::find(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl;
+  o << "  template<class Comp> ";
+  WriteType(o, m, options) << "::iterator find_in_" << m.name << "_if(Comp p) {" << endl;
+  o << "    return std::find_if(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<class T> ";
+  o << "  typename std::iterator_traits<";
+  WriteType(o, m, options) << "::iterator>::difference_type count_in_" << m.name << "(const T &p) {" << endl;
+  o << "    return std::count(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl;
+  o << "  template<class Comp> ";
+  o << "  typename std::iterator_traits<";
+  WriteType(o, m, options) << "::iterator>::difference_type count_in_" << m.name << "_if(Comp p) {" << endl;
+  o << "    return std::count_if(" << m.name << ".begin(), " << m.name << ".end(), p);" << endl;
+  o << "  }" << endl;
+}
+
+void WriteAllocatorConstructors(ostream &o, const Package &p, const Table &t)
+{
+  o << endl << "  using allocator_type = std::pmr::polymorphic_allocator<char>;" << endl << endl;
+
+  o << "  explicit " << t.name << "(const allocator_type &alloc)" << endl;
+  string comma = ": ";
+  for (const auto &m : t.member)
+  {
+    if (!isAllocatorAware(p, m))
+      continue;
+    o << "    " << comma << m.name << "(";
+    if (!m.isVector && !m.defaultValue.value.empty())
+      o << m.defaultValue.value << ", ";
+    o << "alloc)" << endl;
+    comma = ", ";
+  }
+  o << "  {}" << endl;
+
+  vector<string> seen;
+  const bool copyable = isCopyable(p, t.name, seen);
+  for (const auto &source : {"const " + t.name + " &other", t.name + " &&other"})
+  {
+    const bool move = source.find("&&") != string::npos;
+    if (!move && !copyable)
+      continue;
+    o << "  " << t.name << "(" << source << ", const allocator_type &alloc)" << endl;
+    comma = ": ";
+    for (const auto &m : t.member)
+    {
+      o << "    " << comma << m.name << "(" << (move ? "std::move(other." + m.name + ")" : "other." + m.name);
+      o << (isAllocatorAware(p, m) ? ", alloc)" : ")") << endl;
+      comma = ", ";
+    }
+    o << "  {}" << endl;
+  }
+}
+
+void WriteChangeTracking(ostream &o, const Package &p, const Table &t, const OutputOptions &options)
+{
+  o << endl << "  bool has_changes() const {" << endl;
+  o << "    return changes_.any();" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void clear_changes() {" << endl;
+  o << "    changes_.reset();" << endl;
+  for (const auto &m : t.member)
+    if (isRangeVector(p, m))
+      o << "    " << m.name << "_changed_.clear();" << endl;
+  o << "  }" << endl;
+
+  size_t index = 0;
+  for (const auto &m : t.member)
+  {
+    o << endl;
+    if (isRangeVector(p, m))
+    {
+      o << "  void mark_" << m.name << "() {" << endl;
+      o << "    mark_" << m.name << "(0, " << m.name << ".size());" << endl;
+      o << "  }" << endl;
+      o << "  void mark_" << m.name << "(std::size_t first, std::size_t last) {" << endl;
+      o << "    " << m.name << "_changed_.mark(first, std::min(last, " << m.name << ".size()));" << endl;
+      o << "    changes_.set(" << index << ");" << endl;
+      o << "  }" << endl;
+    }
+    else
+    {
+      o << "  void mark_" << m.name << "() {" << endl;
+      o << "    changes_.set(" << index << ");" << endl;
+      o << "  }" << endl;
+      if (m.isVector)
+      {
+        o << "  void mark_" << m.name << "(std::size_t, std::size_t) {" << endl;
+        o << "    changes_.set(" << index << ");" << endl;
+        o << "  }" << endl;
+      }
+    }
+    ++index;
+
+    o << "  template<class T> void set_" << m.name << "(T &&v) {" << endl;
+    o << "    " << m.name << " = std::forward<T>(v);" << endl;
+    o << "    mark_" << m.name << "();" << endl;
+    o << "  }" << endl;
+
+    if (!m.isVector)
+      continue;
+
+    o << "  ";
+    WriteType(o, m, options) << "::reference change_" << m.name << "(std::size_t index) {" << endl;
+    o << "    mark_" << m.name << "(index, index + 1);" << endl;
+    o << "    return " << m.name << "[index];" << endl;
+    o << "  }" << endl;
+    o << "  template<class T> void push_" << m.name << "(T &&v) {" << endl;
+    o << "    " << m.name << ".push_back(std::forward<T>(v));" << endl;
+    o << "    mark_" << m.name << "(" << m.name << ".size() - 1, " << m.name << ".size());" << endl;
+    o << "  }" << endl;
+    o << "  void resize_" << m.name << "(std::size_t size) {" << endl;
+    o << "    const auto old = " << m.name << ".size();" << endl;
+    o << "    " << m.name << ".resize(size);" << endl;
+    o << "    mark_" << m.name << "(std::min(old, size), size);" << endl;
+    o << "  }" << endl;
+  }
+}
+
+void WriteChangedElements(ostream &o)
+{
+  o << endl << "class ChangedElements {" << endl;
+  o << "public:" << endl;
+  o << "  void mark(std::size_t first, std::size_t last) {" << endl;
+  o << "    if (first >= last)" << endl;
+  o << "      return;" << endl;
+  o << "    if (words_.size() < (last + 63) / 64)" << endl;
+  o << "      words_.resize((last + 63) / 64);" << endl;
+  o << "    for (auto n = first; n < last;) {" << endl;
+  o << "      if (n % 64 == 0 && last - n >= 64) {" << endl;
+  o << "        words_[n / 64] = ~std::uint64_t(0);" << endl;
+  o << "        n += 64;" << endl;
+  o << "      } else {" << endl;
+  o << "        words_[n / 64] |= std::uint64_t(1) << (n % 64);" << endl;
+  o << "        ++n;" << endl;
+  o << "      }" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void clear() {" << endl;
+  o << "    words_.clear();" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  std::vector<std::pair<std::size_t, std::size_t>> runs(std::size_t size) const {" << endl;
+  o << "    std::vector<std::pair<std::size_t, std::size_t>> r;" << endl;
+  o << "    const auto end = std::min(size, words_.size() * 64);" << endl;
+  o << "    for (std::size_t n = 0; n < end;) {" << endl;
+  o << "      if (n % 64 == 0 && words_[n / 64] == 0) {" << endl;
+  o << "        n += 64;" << endl;
+  o << "        continue;" << endl;
+  o << "      }" << endl;
+  o << "      if (!test(n)) {" << endl;
+  o << "        ++n;" << endl;
+  o << "        continue;" << endl;
+  o << "      }" << endl;
+  o << "      const auto first = n;" << endl;
+  o << "      while (n < end && test(n))" << endl;
+  o << "        ++n;" << endl;
+  o << "      r.emplace_back(first, n);" << endl;
+  o << "    }" << endl;
+  o << "    return r;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "private:" << endl;
+  o << "  bool test(std::size_t n) const {" << endl;
+  o << "    return (words_[n / 64] >> (n % 64)) & 1;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  std::vector<std::uint64_t> words_;" << endl;
+  o << "};" << endl << endl;
+}
+
+void WriteChangeState(ostream &o, const Package &p, const Table &t)
+{
+  o << endl << "  std::bitset<" << t.member.size() << "> changes_;" << endl;
+  for (const auto &m : t.member)
+    if (isRangeVector(p, m))
+      o << "  ChangedElements " << m.name << "_changed_;" << endl;
+}
+
+void WriteTableDeclaration(ostream &o, const Package &p, const Table &t, const OutputOptions &options)
+{
+  o << "struct " << t.name << " {" << endl;
+  for (const auto &m : t.member)
+  {
+    o << "  ";
+    WriteType(o, m, options) << " " << m.name;
+    if (!m.isVector && m.pointer == Pointer::Plain && !m.defaultValue.value.empty())
+      o << "{" << m.defaultValue.value << defaultValueLiteral(m) << "}";
+    o << ";" << endl;
+  }
+
+  WriteTableInitializer(o, t, options);
+  if (options.pmr && isAllocatorAware(p, t))
+    WriteAllocatorConstructors(o, p, t);
+
+  WriteTableCompareFunctions(o, t);
+
+  const bool tracked = trackedRoot(p, options) == &t;
+  if (tracked)
+    WriteChangeTracking(o, p, t, options);
+
+  for (const auto &m : t.member)
+    WriteMemberVectorFunctions(o, p, m, options, tracked);
+  if (tracked)
+    WriteChangeState(o, p, t);
+  o << "};" << endl << endl;
+}
+
+template <class T>
+void WritePointerOutputFor(ostream &o, const T &t, const OutputOptions &options)
+{
+  if (hasSharedAppearance(t))
+  {
+    o << "  template<typename O> void Write(O &o, const std::shared_ptr<" << t.name << "> &v) const {" << endl;
+    o << "    Write(o, v, o.references." << t.name << "_ids);" << endl;
+    o << "  }" << endl << endl;
+  }
+  if (hasWeakAppearance(t))
+  {
+    o << "  template<typename O> void Write(O &o, const std::weak_ptr<" << t.name << "> &v) const {" << endl;
+    o << "    Write(o, v.lock(), o.references." << t.name << "_ids);" << endl;
+    o << "  }" << endl << endl;
+  }
+  if (isComplex(t) && hasPlainVectorAppearance(t))
+  {
+    o << "  template<typename O> void Write(O &o, const " << vectorTemplate(options) << "<" << t.name << "> &v) const {"
+      << endl;
+    o << "    Write(o, v.size());" << endl;
+    o << "    for (const auto &entry : v)" << endl;
+    o << "      Write(o, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+void WriteTableOutput(ostream &o, const Table &t, const OutputOptions &options)
+{
+  if (isComplex(t))
+  {
+    o << "  template<typename O> void Write(O &o, const " << t.name << " &v) const {" << endl;
+    for (const auto &m : t.member)
+      o << "    Write(o, v." << m.name << ");" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  WritePointerOutputFor(o, t, options);
+}
+
+template <class T>
+void WritePointerInputFor(ostream &o, const T &t, const OutputOptions &options)
+{
+  if (hasSharedAppearance(t))
+  {
+    o << "  template<typename I> void Read(I &s, std::shared_ptr<" << t.name << "> &v) {" << endl;
+    o << "    Read(s, v, s.references." << t.name << "_objects, s.references." << t.name << "_count);" << endl;
+    o << "  }" << endl << endl;
+  }
+  if (hasWeakAppearance(t))
+  {
+    o << "  template<typename I> void Read(I &s, std::weak_ptr<" << t.name << "> &v) {" << endl;
+    o << "    auto t = v.lock();" << endl;
+    o << "    Read(s, t, s.references." << t.name << "_objects, s.references." << t.name << "_count);" << endl;
+    o << "    v = t;" << endl;
+    o << "  }" << endl << endl;
+  }
+  if (isComplex(t) && hasPlainVectorAppearance(t))
+  {
+    o << "  template<typename I> void Read(I &s, " << vectorTemplate(options) << "<" << t.name << "> &v) {" << endl;
+    o << "    auto size = v.size();" << endl;
+    o << "    Read(s, size);" << endl;
+    o << "    if (!Available(s, size, 1))" << endl;
+    o << "      return;" << endl;
+    o << "    v.resize(size);" << endl;
+    o << "    for (auto &entry : v)" << endl;
+    o << "      Read(s, entry);" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+void WriteTableInput(ostream &o, const Table &t, const OutputOptions &options)
+{
+  if (isComplex(t))
+  {
+    o << "  template<typename I> void Read(I &s, " << t.name << " &v) {" << endl;
+    for (const auto &m : t.member)
+      o << "    Read(s, v." << m.name << ");" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  WritePointerInputFor(o, t, options);
+}
+
+void WriteCompareOperatorForWeakPointer(ostream &o)
+{
+  o << "template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {" << endl;
+  o << "  return l.lock() == r.lock();" << endl;
+  o << "}" << endl << endl;
+
+  o << "template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {" << endl;
+  o << "  return l.lock() != r.lock();" << endl;
+  o << "}" << endl << endl;
+}
+
+string unionAlternative(const Attribute &t, const OutputOptions &options, const string &object = "")
+{
+  if (options.inlineUnionSize > 0)
+    return "*" + object + "_get<" + t.value + ">()";
+  return "*" + object + "_" + t.value;
+}
+
+void WriteUnionStorageFunctions(ostream &o, const Union &u, const OutputOptions &options)
+{
+  o << "  template<typename T> using _inline = std::integral_constant<bool, sizeof(T) <= " << options.inlineUnionSize
+    << " && std::is_nothrow_move_constructible<T>::value>;" << endl;
+  o << "  template<typename T> using _held = typename std::conditional<_inline<T>::value, T, T *>::type;" << endl;
+  o << "  template<typename T> struct _slot {" << endl;
+  o << "    alignas(_held<T>) unsigned char bytes[sizeof(_held<T>)];" << endl;
+  o << "  };" << endl << endl;
+
+  o << "  template<typename T> T *_get() noexcept { return _get<T>(_inline<T>()); }" << endl;
+  o << "  template<typename T> const T *_get() const noexcept { return const_cast<" << u.name
+    << " *>(this)->_get<T>(); }" << endl;
+  o << "  template<typename T> T *_get(std::true_type) noexcept { return reinterpret_cast<T *>(&_storage); }" << endl;
+  o << "  template<typename T> T *_get(std::false_type) noexcept { return *reinterpret_cast<T **>(&_storage); }"
+    << endl
+    << endl;
+
+  o << "  template<typename T, typename... Args> void _construct(Args &&... args) {" << endl;
+  o << "    _place<T>(_inline<T>(), std::forward<Args>(args)...);" << endl;
+  o << "  }" << endl;
+  o << "  template<typename T, typename... Args> void _place(std::true_type, Args &&... args) {" << endl;
+  o << "    new (&_storage) T(std::forward<Args>(args)...);" << endl;
+  o << "  }" << endl;
+  o << "  template<typename T, typename... Args> void _place(std::false_type, Args &&... args) {" << endl;
+  o << "    new (&_storage) T *(new T(std::forward<Args>(args)...));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // builds the new value before the old one is destroyed, the arguments may refer into it" << endl;
+  o << "  template<typename T, typename... Args> void _replace(Args &&... args) {" << endl;
+  o << "    _replace<T>(_inline<T>(), std::forward<Args>(args)...);" << endl;
+  o << "  }" << endl;
+  o << "  template<typename T, typename... Args> void _replace(std::true_type, Args &&... args) {" << endl;
+  o << "    T v(std::forward<Args>(args)...);" << endl;
+  o << "    _destroy();" << endl;
+  o << "    new (&_storage) T(std::move(v));" << endl;
+  o << "  }" << endl;
+  o << "  template<typename T, typename... Args> void _replace(std::false_type, Args &&... args) {" << endl;
+  o << "    T *v = new T(std::forward<Args>(args)...);" << endl;
+  o << "    _destroy();" << endl;
+  o << "    new (&_storage) T *(v);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename T> void _free() noexcept { _free<T>(_inline<T>()); }" << endl;
+  o << "  template<typename T> void _free(std::true_type) noexcept { _get<T>()->~T(); }" << endl;
+  o << "  template<typename T> void _free(std::false_type) noexcept { delete _get<T>(); }" << endl << endl;
+
+  o << "  template<typename T> void _take(" << u.name << " &o) noexcept { _take<T>(o, _inline<T>()); }" << endl;
+  o << "  template<typename T> void _take(" << u.name << " &o, std::true_type) noexcept {" << endl;
+  o << "    new (&_storage) T(std::move(*o._get<T>()));" << endl;
+  o << "    o._free<T>();" << endl;
+  o << "  }" << endl;
+  o << "  template<typename T> void _take(" << u.name << " &o, std::false_type) noexcept {" << endl;
+  o << "    new (&_storage) T *(o._get<T>());" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteUnionStruct(ostream &o, const Union &u, const string &root_type, const OutputOptions &options)
+{
+  const bool inlined = options.inlineUnionSize > 0;
+  o << "struct " << u.name << " {" << endl;
+
+  o << "  " << u.name << "() = default;" << endl;
+  o << "  " << u.name << "(const " << u.name << " &o) { _clone(o); }" << endl;
+  o << "  " << u.name << "& operator=(const " << u.name << " &o) {" << endl;
+  o << "    if (this != &o)" << endl;
+  o << "      *this = " << u.name << "(o);" << endl;
+  o << "    return *this;" << endl;
+  o << "  }" << endl;
+  o << "  " << u.name << "(" << u.name << " &&o) noexcept { _move(o); }" << endl;
+  o << "  " << u.name << "& operator=(" << u.name << " &&o) noexcept {" << endl;
+  o << "    if (this != &o) {" << endl;
+  o << "      _destroy();" << endl;
+  o << "      _move(o);" << endl;
+  o << "    }" << endl;
+  o << "    return *this;" << endl;
+  o << "  }" << endl << endl;
+
+  for (const auto &t : u.tables)
+  {
+    if (inlined)
+    {
+      o << "  " << u.name << "(const " << t.value << " &v)" << endl;
+      o << "    : _selection(_" << t.value << "_selection)" << endl;
+      o << "  { _construct<" << t.value << ">(v); }" << endl;
+      o << "  " << u.name << "(" << t.value << " &&v)" << endl;
+      o << "    : _selection(_" << t.value << "_selection)" << endl;
+      o << "  { _construct<" << t.value << ">(std::forward<" << t.value << ">(v)); }" << endl;
+      o << "  " << u.name << " & operator=(const " << t.value << " &v) {" << endl;
+      o << "    create_" << t.value << "(v);" << endl;
+      o << "    return *this;" << endl;
+      o << "  }" << endl;
+      o << "  " << u.name << " & operator=(" << t.value << " &&v) {" << endl;
+      o << "    create_" << t.value << "(std::forward<" << t.value << ">(v));" << endl;
+      o << "    return *this;" << endl;
+      o << "  }" << endl << endl;
+      continue;
+    }
+    o << "  " << u.name << "(const " << t.value << " &v)" << endl;
+    o << "    : _" << t.value << "(new " << t.value << "(v))" << endl;
+    o << "    , _selection(_" << t.value << "_selection)" << endl;
+    o << "  {}" << endl;
+    o << "  " << u.name << "(" << t.value << " &&v)" << endl;
+    o << "    : _" << t.value << "(new " << t.value << "(std::forward<" << t.value << ">(v)))" << endl;
+    o << "    , _selection(_" << t.value << "_selection)" << endl;
+    o << "  {}" << endl;
+    o << "  " << u.name << " & operator=(const " << t.value << " &v) {" << endl;
+    o << "    auto *n = new " << t.value << "(v);" << endl;
+    o << "    _destroy();" << endl;
+    o << "    _" << t.value << " = n;" << endl;
+    o << "    _selection = _" << t.value << "_selection;" << endl;
+    o << "    return *this;" << endl;
+    o << "  }" << endl;
+    o << "  " << u.name << " & operator=(" << t.value << " &&v) {" << endl;
+    o << "    auto *n = new " << t.value << "(std::forward<" << t.value << ">(v));" << endl;
+    o << "    _destroy();" << endl;
+    o << "    _" << t.value << " = n;" << endl;
+    o << "    _selection = _" << t.value << "_selection;" << endl;
+    o << "    return *this;" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  ~" << u.name << "() {" << endl;
+  o << "    _destroy();" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool is_Defined() const noexcept { return _selection != no_selection; }" << endl;
+  o << "  void clear() { *this = " << u.name << "(); }" << endl;
+  o << "  void swap(" << u.name << " &o) noexcept {" << endl;
+  o << "    " << u.name << " t(std::move(o));" << endl;
+  o << "    o = std::move(*this);" << endl;
+  o << "    *this = std::move(t);" << endl;
+  o << "  }" << endl;
+  o << "  friend void swap(" << u.name << " &l, " << u.name << " &r) noexcept { l.swap(r); }" << endl << endl;
+  for (const auto &t : u.tables)
+  {
+    o << "  bool is_" << t.value << "() const noexcept { return _selection == _" << t.value << "_selection; }" << endl;
+    o << "  const " << t.value << " & as_" << t.value << "() const noexcept { return " << unionAlternative(t, options)
+      << "; }" << endl;
+    o << "  " << t.value << " & as_" << t.value << "() { return " << unionAlternative(t, options) << "; }" << endl;
+
+    o << "  template<typename... Args> " << t.value << " & create_" << t.value << "(Args&&... args) {" << endl;
+    if (inlined)
+    {
+      o << "    _replace<" << t.value << ">(std::forward<Args>(args)...);" << endl;
+      o << "    _selection = _" << t.value << "_selection;" << endl;
+      o << "    return as_" << t.value << "();" << endl;
+    }
+    else
+      o << "    return (*this = " << t.value << "(std::forward<Args>(args)...)).as_" << t.value << "();" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  for (const auto &t : u.tables)
+  {
+    o << "  friend bool operator==(const " << u.name << "&ab, const " << t.value << " &o) noexcept";
+    o << "  { return ab.is_" << t.value << "() && ab.as_" << t.value << "() == o; }" << endl;
+    o << "  friend bool operator==(const " << t.value << " &o, const " << u.name << "&ab) noexcept";
+    o << "  { return ab.is_" << t.value << "() && o == ab.as_" << t.value << "(); }" << endl;
+    o << "  friend bool operator!=(const " << u.name << "&ab, const " << t.value << " &o) noexcept";
+    o << "  { return !ab.is_" << t.value << "() || ab.as_" << t.value << "() != o; }" << endl;
+    o << "  friend bool operator!=(const " << t.value << " &o, const " << u.name << "&ab) noexcept";
+    o << "  { return !ab.is_" << t.value << "() || o != ab.as_" << t.value << "(); }" << endl << endl;
+  }
+
+  o << "  bool operator==(const " << u.name << " &o) const noexcept" << endl;
+  o << "  {" << endl;
+  o << "    if (this == &o)" << endl;
+  o << "      return true;" << endl;
+  o << "    if (_selection != o._selection)" << endl;
+  o << "      return false;" << endl;
+  o << "    switch(_selection) {" << endl;
+  o << "    case no_selection: while(false); /* hack for coverage tool */ return true;" << endl;
+  for (const auto &t : u.tables)
+    o << "    case _" << t.value << "_selection: return " << unionAlternative(t, options)
+      << " == " << unionAlternative(t, options, "o.") << ";" << endl;
+  o << "    }" << endl;
+  o << "    return false; // without this line there is a msvc warning I do not understand." << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool operator!=(const " << u.name << " &o) const noexcept" << endl;
+  o << "  {" << endl;
+  o << "    if (this == &o)" << endl;
+  o << "      return false;" << endl;
+  o << "    if (_selection != o._selection)" << endl;
+  o << "      return true;" << endl;
+  o << "    switch(_selection) {" << endl;
+  o << "    case no_selection: while(false); /* hack for coverage tool */ return false;" << endl;
+  for (const auto &t : u.tables)
+    o << "    case _" << t.value << "_selection: return " << unionAlternative(t, options)
+      << " != " << unionAlternative(t, options, "o.") << ";" << endl;
+  o << "    }" << endl;
+  o << "    return false; // without this line there is a msvc warning I do not understand." << endl;
+  o << "  }" << endl << endl;
+
+  o << "private:" << endl;
+  o << "  void _clone(const " << u.name << " &o) noexcept" << endl;
+  o << "  {" << endl;
+  o << "     _selection = o._selection;" << endl;
+  o << "    switch(_selection) {" << endl;
+  o << "    case no_selection: while(false); /* hack for coverage tool */ break;" << endl;
+  for (const auto &t : u.tables)
+  {
+    if (inlined)
+      o << "    case _" << t.value << "_selection: _construct<" << t.value << ">(" << unionAlternative(t, options, "o.")
+        << "); break;" << endl;
+    else
+      o << "    case _" << t.value << "_selection: _" << t.value << " = new " << t.value << "(*o._" << t.value
+        << "); break;" << endl;
+  }
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void _move(" << u.name << " &o) noexcept" << endl;
+  o << "  {" << endl;
+  o << "    _selection = o._selection;" << endl;
+  o << "    switch(_selection) {" << endl;
+  o << "    case no_selection: while(false); /* hack for coverage tool */ break;" << endl;
+  for (const auto &t : u.tables)
+  {
+    if (inlined)
+      o << "    case _" << t.value << "_selection: _take<" << t.value << ">(o); break;" << endl;
+    else
+      o << "    case _" << t.value << "_selection: _" << t.value << " = o._" << t.value << "; break;" << endl;
+  }
+  o << "    }" << endl;
+  if (!inlined)
+    o << "    o.no_value = nullptr;" << endl;
+  o << "    o._selection = no_selection;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void _destroy() noexcept {" << endl;
+  o << "    switch(_selection) {" << endl;
+  o << "    case no_selection: while(false); /* hack for coverage tool */ break;" << endl;
+  for (const auto &t : u.tables)
+  {
+    if (inlined)
+      o << "    case _" << t.value << "_selection: _free<" << t.value << ">(); break;" << endl;
+    else
+      o << "    case _" << t.value << "_selection: delete _" << t.value << "; break;" << endl;
+  }
+  o << "    }" << endl;
+  if (inlined)
+    o << "    _selection = no_selection;" << endl;
+  else
+    o << "    no_value = nullptr;" << endl;
+  o << "  }" << endl << endl;
+
+  if (inlined)
+  {
+    WriteUnionStorageFunctions(o, u, options);
+
+    o << "  union {" << endl;
+    for (const auto &t : u.tables)
+      o << "    _slot<" << t.value << "> _" << t.value << ";" << endl;
+    o << "  } _storage;" << endl << endl;
+  }
+  else
+  {
+    o << "  union {" << endl;
+    o << "    struct NoValue_t *no_value{nullptr};" << endl;
+
+    for (const auto &t : u.tables)
+      o << "    " << t.value << " * _" << t.value << ";" << endl;
+    o << "  };" << endl << endl;
+  }
+  o << "  enum Selection_t {" << endl;
+  o << "    no_selection," << endl;
+  for (const auto &t : u.tables)
+    o << "    _" << t.value << "_selection," << endl;
+  o << "  };" << endl << endl;
+
+  o << "  Selection_t _selection{no_selection};" << endl;
+  o << "  friend struct " << root_type << "_io;" << endl;
+  o << "};" << endl << endl;
+}
+
+ostream &WriteElementType(ostream &o, const Member &m, const OutputOptions &options)
+{
+  auto element = m;
+  element.isVector = false;
+  return WriteType(o, element, options);
+}
+
+void WriteVisitorStruct(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  o << "struct " << root->name << "Visitor {" << endl;
+  o << "  virtual ~" << root->name << "Visitor() = default;" << endl << endl;
+  for (const auto &m : root->member)
+  {
+    if (m.isVector)
+    {
+      o << "  virtual void on_" << m.name << "_begin(std::size_t) {}" << endl;
+      o << "  virtual void on_" << m.name << "_element(const ";
+      WriteElementType(o, m, options) << " &) {}" << endl;
+      o << "  virtual void on_" << m.name << "_end() {}" << endl;
+    }
+    else
+    {
+      o << "  virtual void on_" << m.name << "(const ";
+      WriteType(o, m, options) << " &) {}" << endl;
+    }
+  }
+  o << "};" << endl << endl;
+}
+
+void WriteTypeStructs(ostream &o, const Package &p, const OutputOptions &options)
+{
+  if (someThingIsWeak(p))
+    WriteCompareOperatorForWeakPointer(o);
+
+  for (const auto &t : p.types)
+  {
+    if (t.is_Table())
+      WriteTableDeclaration(o, p, t.as_Table(), options);
+    else if (t.is_Union())
+      WriteUnionStruct(o, t.as_Union(), p.root_type.value, options);
+    else if (t.is_Enum())
+    {
+      WriteEnumDeclaration(o, t.as_Enum());
+      WriteEnumFunctions(o, t.as_Enum());
+    }
+    else if (t.is_Flag())
+      WriteFlag(o, t.as_Flag());
+  }
+}
+
+void WriteUnionOutput(ostream &o, const Union &u, const OutputOptions &options)
+{
+  o << "  template<typename O> void Write(O &o, const " << u.name << " &v) const {" << endl;
+  if (options.compactWire)
+    o << "    WriteVarint(o, static_cast<std::uint64_t>(v._selection));" << endl;
+  else
+    o << "    Write(o, v._selection);" << endl;
+  o << "    switch(v._selection) {" << endl;
+  o << "    case " << u.name << "::no_selection: while(false); /* hack for coverage tool */ break;" << endl;
+  for (const auto &t : u.tables)
+    o << "    case " << u.name << "::_" << t.value << "_selection: Write(o, v.as_" << t.value << "()); break;" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  WritePointerOutputFor(o, u, options);
+}
+
+// reads the selection of an union as plain number into 'value', it is no valid Selection_t before the range check
+void WriteSelectionValueInput(ostream &o, const Union &u, const OutputOptions &options)
+{
+  if (options.compactWire)
+  {
+    o << "    std::uint64_t value = 0;" << endl;
+    o << "    ReadVarint(i, value);" << endl;
+    return;
+  }
+  o << "    std::underlying_type<" << u.name << "::Selection_t>::type raw = 0;" << endl;
+  o << "    Read(i, raw);" << endl;
+  o << "    const auto value = static_cast<std::uint64_t>(raw);" << endl;
+}
+
+void WriteUnionInput(ostream &o, const Union &u, const OutputOptions &options)
+{
+  o << "  template<typename I> void Read(I &i, " << u.name << " &v) {" << endl;
+  WriteSelectionValueInput(o, u, options);
+  o << "    if (value > " << u.tables.size() << ") {" << endl;
+  o << "      v.clear();" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    switch(static_cast<" << u.name << "::Selection_t>(value)) {" << endl;
+  o << "    case " << u.name << "::no_selection: v.clear(); break;" << endl;
+  for (const auto &t : u.tables)
+    o << "    case " << u.name << "::_" << t.value << "_selection: Read(i, v.create_" << t.value << "()); break;"
+      << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  WritePointerInputFor(o, u, options);
+}
+
+void WriteTablesIOFunctions(ostream &o, const vector<Type> &types, const OutputOptions &options)
+{
+  for (const auto &t : types)
+  {
+    if (t.is_Table())
+    {
+      WriteTableOutput(o, t.as_Table(), options);
+      WriteTableInput(o, t.as_Table(), options);
+    }
+    else if (t.is_Union())
+    {
+      WriteUnionOutput(o, t.as_Union(), options);
+      WriteUnionInput(o, t.as_Union(), options);
+    }
+  }
+}
+
+const char *fileMarker(const OutputOptions &options)
+{
+  if (options.portableWire)
+    return "CORP";
+  return options.compactWire ? "CORC" : "CORE";
+}
+
+void WriteHeaderIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto shared = sharedTypes(p);
+  o << "  template<typename O> void WriteHeader(O &o) const {" << endl;
+  o << "    WriteBytes(o, \"" << fileMarker(options) << headerRevision << "\", 5);" << endl;
+  o << "    WriteBytes(o, \"" << p.version.value << "\", " << p.version.value.size() << ");" << endl;
+  if (!shared.empty())
+  {
+    o << "    const std::uint32_t counts[" << shared.size() << "] = {};" << endl;
+    o << "    WriteValues(o, counts, " << shared.size() << ");" << endl;
+  }
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I> bool ReadHeader(I &i) {" << endl;
+  o << "    char marker[5];" << endl;
+  o << "    error_offset_ = 0;" << endl;
+  o << "    ReadBytes(i, marker, 5);" << endl;
+  o << "    if (std::memcmp(marker, \"" << fileMarker(options) << headerRevision << "\", 5) != 0) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    char version[" << p.version.value.size() << "];" << endl;
+  o << "    ReadBytes(i, version, " << p.version.value.size() << ");" << endl;
+  if (shared.empty())
+  {
+    o << "    return std::memcmp(version, \"" << p.version.value << "\", " << p.version.value.size() << ") == 0;"
+      << endl;
+    o << "  }" << endl << endl;
+    return;
+  }
+  o << "    if (std::memcmp(version, \"" << p.version.value << "\", " << p.version.value.size() << ") != 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    std::uint32_t counts[" << shared.size() << "] = {};" << endl;
+  o << "    ReadValues(i, counts, " << shared.size() << ");" << endl;
+  for (size_t n = 0; n < shared.size(); ++n)
+    o << "    i.references." << shared[n] << "_count = counts[" << n << "];" << endl;
+  o << "    return !Failed(i) && Available(i, ";
+  for (size_t n = 0; n < shared.size(); ++n)
+    o << (n == 0 ? "" : " + ") << "std::size_t(counts[" << n << "])";
+  o << ", 1);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void PatchHeader(char *header, const WriteReferences &references) const {" << endl;
+  o << "    " << (options.portableWire ? "" : "const ") << "std::uint32_t counts[" << shared.size() << "] = {" << endl;
+  for (size_t n = 0; n < shared.size(); ++n)
+    o << "      static_cast<std::uint32_t>(references." << shared[n] << "_ids.size())," << endl;
+  o << "    };" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(counts, " << shared.size() << ");" << endl;
+  o << "    std::memcpy(header + " << countsOffset(p) << ", counts, sizeof(counts));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void PatchHeader(std::ostream &o, std::ostream::pos_type start, const WriteReferences &references) const {"
+    << endl;
+  o << "    const auto end = o.tellp();" << endl;
+  o << "    if (start == std::ostream::pos_type(-1) || end == std::ostream::pos_type(-1))" << endl;
+  o << "      return;" << endl;
+  o << "    char header[" << headerSize(p) << "];" << endl;
+  o << "    PatchHeader(header, references);" << endl;
+  o << "    o.seekp(start + std::streamoff(" << countsOffset(p) << "));" << endl;
+  o << "    o.write(header + " << countsOffset(p) << ", " << shared.size() * sizeof(uint32_t) << ");"
+    << endl;
+  o << "    o.seekp(end);" << endl;
+  o << "  }" << endl << endl;
+}
+
+const char *rootWrite(const Package &p, const OutputOptions &options)
+{
+  return indexedRootVectors(p, options).empty() ? "Write" : "WriteIndexed";
+}
+
+void WriteVectorIndexFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto indexed = indexedRootVectors(p, options);
+  if (indexed.empty())
+    return;
+
+  o << "  std::uint64_t Position(OutputStream &o) const {" << endl;
+  o << "    return o.size;" << endl;
+  o << "  }" << endl << endl;
+  o << "  std::uint64_t Position(OutputBuffer &o) const {" << endl;
+  o << "    return o.size;" << endl;
+  o << "  }" << endl << endl;
+  o << "  std::uint64_t Position(OutputSpan &o) const {" << endl;
+  o << "    return o.size;" << endl;
+  o << "  }" << endl << endl;
+  o << "  std::uint64_t Position(OutputCounter &o) const {" << endl;
+  o << "    return o.size;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename O> void WriteVectorIndex(O &o, std::uint64_t start, "
+       "std::initializer_list<const std::vector<std::uint64_t> *> index) const {"
+    << endl;
+  o << "    std::vector<std::uint64_t> directory;" << endl;
+  o << "    for (const auto *entry : index) {" << endl;
+  o << "      directory.push_back(entry->size());" << endl;
+  o << "      directory.push_back(Position(o) - start);" << endl;
+  o << "      WriteValues(o, entry->data(), entry->size());" << endl;
+  o << "    }" << endl;
+  o << "    directory.push_back(Position(o) - start + (directory.size() + 1) * sizeof(std::uint64_t));" << endl;
+  o << "    WriteValues(o, directory.data(), directory.size());" << endl;
+  o << "  }" << endl << endl;
+
+  const auto *root = rootTable(p);
+  o << "  template<typename O> void WriteIndexed(O &o, const " << root->name << " &v) const {" << endl;
+  o << "    const auto start = Position(o);" << endl;
+  for (const auto *m : indexed)
+  {
+    o << "    std::vector<std::uint64_t> " << m->name << "_index;" << endl;
+    o << "    " << m->name << "_index.reserve(v." << m->name << ".size());" << endl;
+  }
+  for (const auto &m : root->member)
+  {
+    if (find(indexed.begin(), indexed.end(), &m) == indexed.end())
+    {
+      o << "    Write(o, v." << m.name << ");" << endl;
+      continue;
+    }
+    o << "    Write(o, v." << m.name << ".size());" << endl;
+    o << "    for (const auto &entry : v." << m.name << ") {" << endl;
+    o << "      " << m.name << "_index.push_back(Position(o) - start);" << endl;
+    o << "      Write(o, entry);" << endl;
+    o << "    }" << endl;
+  }
+  o << "    WriteVectorIndex(o, start, {";
+  for (size_t i = 0; i < indexed.size(); ++i)
+    o << (i == 0 ? "&" : ", &") << indexed[i]->name << "_index";
+  o << "});" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  std::uint64_t InputSize(InputStream &i) {" << endl;
+  o << "    return i.size;" << endl;
+  o << "  }" << endl << endl;
+  o << "  std::uint64_t InputSize(InputBuffer &i) {" << endl;
+  o << "    return i.size;" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Seek(InputStream &i, std::uint64_t pos) {" << endl;
+  o << "    if (i.failed || pos > i.size || !i.stream.seekg(static_cast<std::streamoff>(pos))) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    i.pos = pos;" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Seek(InputBuffer &i, std::uint64_t pos) {" << endl;
+  o << "    i.failed = i.failed || pos > i.size;" << endl;
+  o << "    i.pos = i.failed ? i.size : static_cast<std::size_t>(pos);" << endl;
+  o << "  }" << endl << endl;
+
+  const auto header = headerSize(p);
+  o << "  template<typename I> bool SeekVectorEntry(I &i, std::size_t member, std::uint64_t index) {" << endl;
+  o << "    const std::uint64_t header = " << header << ";" << endl;
+  o << "    const std::uint64_t trailer = " << (2 * indexed.size() + 1) << " * sizeof(std::uint64_t);" << endl;
+  o << "    const auto size = InputSize(i);" << endl;
+  o << "    if (size < header + trailer)" << endl;
+  o << "      return false;" << endl;
+  o << "    std::uint64_t length = 0;" << endl;
+  o << "    Seek(i, size - sizeof(length));" << endl;
+  o << "    ReadValues(i, &length, 1);" << endl;
+  o << "    if (Failed(i) || length < trailer || length > size - header)" << endl;
+  o << "      return false;" << endl;
+  o << "    const auto start = size - length;" << endl;
+  o << "    Seek(i, start - header);" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    std::uint64_t entry[2] = {0, 0};" << endl;
+  o << "    Seek(i, size - trailer + 2 * member * sizeof(std::uint64_t));" << endl;
+  o << "    ReadValues(i, entry, 2);" << endl;
+  o << "    if (Failed(i) || index >= entry[0] || entry[1] > length ||" << endl;
+  o << "        entry[0] > (length - entry[1]) / sizeof(std::uint64_t))" << endl;
+  o << "      return false;" << endl;
+  o << "    std::uint64_t offset = 0;" << endl;
+  o << "    Seek(i, start + entry[1] + index * sizeof(std::uint64_t));" << endl;
+  o << "    ReadValues(i, &offset, 1);" << endl;
+  o << "    if (Failed(i) || offset >= length)" << endl;
+  o << "      return false;" << endl;
+  o << "    Seek(i, start + offset);" << endl;
+  o << "    return !Failed(i);" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteIndexedVectorIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto indexed = indexedRootVectors(p, options);
+  for (size_t k = 0; k < indexed.size(); ++k)
+  {
+    const auto &m = *indexed[k];
+    const auto name = "Read" + p.root_type.value + upperFirst(m.name) + "At";
+
+    o << "  bool " << name << "(std::istream &stream, std::size_t index, ";
+    WriteElementType(o, m, options) << " &v) {" << endl;
+    o << "    auto i = MakeInput(stream);" << endl;
+    o << "    if (!SeekVectorEntry(i, " << k << ", index))" << endl;
+    o << "      return false;" << endl;
+    o << "    Read(i, v);" << endl;
+    o << "    return !Failed(i);" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  bool " << name << "(const char *data, std::size_t size, std::size_t index, ";
+    WriteElementType(o, m, options) << " &v) {" << endl;
+    o << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+    o << "    if (!SeekVectorEntry(i, " << k << ", index))" << endl;
+    o << "      return false;" << endl;
+    o << "    Read(i, v);" << endl;
+    o << "    return !i.failed;" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+void WriteParallelOutput(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto parallel = parallelRootVectors(p);
+  if (parallel.empty())
+    return;
+
+  const auto indexed = indexedRootVectors(p, options);
+  const auto isIndexed = [&indexed](const Member *m) { return find(indexed.begin(), indexed.end(), m) != indexed.end(); };
+  const auto *root = rootTable(p);
+
+  o << "  static constexpr std::size_t ParallelSliceMinimum() {" << endl;
+  o << "    return 1024;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename T> std::vector<char> EncodeSlice(const T *begin, const T *end";
+  if (!indexed.empty())
+    o << ", std::vector<std::uint64_t> *offsets";
+  o << ") {" << endl;
+  o << "    std::vector<char> b;" << endl;
+  o << "    OutputBuffer o{b, 0" << referencesInit(p) << "};" << endl;
+  o << "    for (auto entry = begin; entry != end; ++entry) {" << endl;
+  if (!indexed.empty())
+  {
+    o << "      if (offsets)" << endl;
+    o << "        offsets->push_back(o.size);" << endl;
+  }
+  o << "      Write(o, *entry);" << endl;
+  o << "    }" << endl;
+  o << "    b.resize(o.size);" << endl;
+  o << "    return b;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename O, typename T> void WriteVectorParallel(O &o, const " << vectorTemplate(options)
+    << "<T> &v, unsigned int threads";
+  if (!indexed.empty())
+    o << ", std::uint64_t start, std::vector<std::uint64_t> *index";
+  o << ") const {" << endl;
+  o << "    Write(o, v.size());" << endl;
+  o << "    const auto slices = std::min<std::size_t>(threads, v.size() / ParallelSliceMinimum());" << endl;
+  o << "    if (slices < 2) {" << endl;
+  o << "      for (const auto &entry : v) {" << endl;
+  if (!indexed.empty())
+  {
+    o << "        if (index)" << endl;
+    o << "          index->push_back(Position(o) - start);" << endl;
+  }
+  o << "        Write(o, entry);" << endl;
+  o << "      }" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl << endl;
+  o << "    std::vector<std::future<std::vector<char>>> parts;" << endl;
+  if (!indexed.empty())
+    o << "    std::vector<std::vector<std::uint64_t>> offsets(slices);" << endl;
+  o << "    for (std::size_t s = 0; s < slices; ++s) {" << endl;
+  o << "      const auto *begin = v.data() + v.size() * s / slices;" << endl;
+  o << "      const auto *end = v.data() + v.size() * (s + 1) / slices;" << endl;
+  if (!indexed.empty())
+  {
+    o << "      auto *slice = index ? &offsets[s] : nullptr;" << endl;
+    o << "      parts.push_back(std::async(std::launch::async, [begin, end, slice]() {" << endl;
+    o << "        return " << root->name << "_io().EncodeSlice(begin, end, slice);" << endl;
+  }
+  else
+  {
+    o << "      parts.push_back(std::async(std::launch::async, [begin, end]() {" << endl;
+    o << "        return " << root->name << "_io().EncodeSlice(begin, end);" << endl;
+  }
+  o << "      }));" << endl;
+  o << "    }" << endl;
+  o << "    for (std::size_t s = 0; s < slices; ++s) {" << endl;
+  o << "      const auto part = parts[s].get();" << endl;
+  if (!indexed.empty())
+  {
+    o << "      if (index) {" << endl;
+    o << "        const auto base = Position(o) - start;" << endl;
+    o << "        for (const auto offset : offsets[s])" << endl;
+    o << "          index->push_back(base + offset);" << endl;
+    o << "      }" << endl;
+  }
+  o << "      WriteBytes(o, part.data(), part.size());" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename O> void WriteParallel(O &o, const " << root->name << " &v, unsigned int threads) const {"
+    << endl;
+  if (!indexed.empty())
+  {
+    o << "    const auto start = Position(o);" << endl;
+    for (const auto *m : indexed)
+    {
+      o << "    std::vector<std::uint64_t> " << m->name << "_index;" << endl;
+      o << "    " << m->name << "_index.reserve(v." << m->name << ".size());" << endl;
+    }
+  }
+  for (const auto &m : root->member)
+  {
+    if (find(parallel.begin(), parallel.end(), &m) == parallel.end())
+    {
+      o << "    Write(o, v." << m.name << ");" << endl;
+      continue;
+    }
+    o << "    WriteVectorParallel(o, v." << m.name << ", threads";
+    if (!indexed.empty())
+      o << ", start, " << (isIndexed(&m) ? "&" + m.name + "_index" : string("nullptr"));
+    o << ");" << endl;
+  }
+  if (!indexed.empty())
+  {
+    o << "    WriteVectorIndex(o, start, {";
+    for (size_t i = 0; i < indexed.size(); ++i)
+      o << (i == 0 ? "&" : ", &") << indexed[i]->name << "_index";
+    o << "});" << endl;
+  }
+  o << "  }" << endl << endl;
+}
+
+void WriteParallelInput(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto indexed = indexedRootVectors(p, options);
+  if (indexed.empty())
+    return;
+
+  const auto *root = rootTable(p);
+  o << "  bool ReadVectorIndex(const InputBuffer &i, std::size_t member, std::uint64_t start, "
+       "std::vector<std::uint64_t> &offsets) {"
+    << endl;
+  o << "    const std::uint64_t trailer = " << (2 * indexed.size() + 1) << " * sizeof(std::uint64_t);" << endl;
+  o << "    std::uint64_t length = 0;" << endl;
+  o << "    if (i.size < start + trailer)" << endl;
+  o << "      return false;" << endl;
+  o << "    std::memcpy(&length, i.data + i.size - sizeof(length), sizeof(length));" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(&length, 1);" << endl;
+  o << "    if (length != i.size - start)" << endl;
+  o << "      return false;" << endl;
+  o << "    std::uint64_t entry[2] = {0, 0};" << endl;
+  o << "    std::memcpy(entry, i.data + i.size - trailer + 2 * member * sizeof(std::uint64_t), sizeof(entry));" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(entry, 2);" << endl;
+  o << "    if (entry[1] > length || entry[0] > (length - entry[1]) / sizeof(std::uint64_t))" << endl;
+  o << "      return false;" << endl;
+  o << "    offsets.resize(entry[0]);" << endl;
+  o << "    if (!offsets.empty())" << endl;
+  o << "      std::memcpy(&offsets[0], i.data + start + entry[1], offsets.size() * sizeof(std::uint64_t));" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(offsets.data(), offsets.size());" << endl;
+  o << "    for (std::size_t k = 1; k < offsets.size(); ++k)" << endl;
+  o << "      if (offsets[k] < offsets[k - 1])" << endl;
+  o << "        return false;" << endl;
+  o << "    return offsets.empty() || offsets.back() < length;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename T> InputBuffer ReadSlice(InputBuffer i, T *begin, T *end) {" << endl;
+  o << "    for (auto entry = begin; entry != end && !i.failed; ++entry)" << endl;
+  o << "      Read(i, *entry);" << endl;
+  o << "    return i;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename T> void ReadVectorParallel(InputBuffer &i, " << vectorTemplate(options)
+    << "<T> &v, const std::vector<std::uint64_t> &offsets, std::uint64_t start, unsigned int threads) {" << endl;
+  o << "    typename " << vectorTemplate(options) << "<T>::size_type s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (s != offsets.size() || (s != 0 && i.pos != start + offsets[0])) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    v.resize(s);" << endl;
+  o << "    const auto slices = std::min<std::size_t>(threads, s / ParallelSliceMinimum());" << endl;
+  o << "    if (slices < 2) {" << endl;
+  o << "      i = ReadSlice(i, v.data(), v.data() + s);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl << endl;
+  o << "    std::vector<std::future<InputBuffer>> parts;" << endl;
+  o << "    for (std::size_t k = 0; k < slices; ++k) {" << endl;
+  o << "      const auto first = s * k / slices;" << endl;
+  o << "      const auto last = s * (k + 1) / slices;" << endl;
+  o << "      const InputBuffer slice{i.data, last == s ? i.size : static_cast<std::size_t>(start + offsets[last]),"
+       << endl;
+  o << "                              static_cast<std::size_t>(start + offsets[first]), false" << referencesInit(p) << "};"
+    << endl;
+  o << "      auto *begin = v.data() + first;" << endl;
+  o << "      auto *end = v.data() + last;" << endl;
+  o << "      parts.push_back(std::async(std::launch::async, [slice, begin, end]() {" << endl;
+  o << "        return " << root->name << "_io().ReadSlice(slice, begin, end);" << endl;
+  o << "      }));" << endl;
+  o << "    }" << endl;
+  o << "    for (std::size_t k = 0; k < slices; ++k) {" << endl;
+  o << "      const auto slice = parts[k].get();" << endl;
+  o << "      const auto last = s * (k + 1) / slices;" << endl;
+  o << "      if (i.failed)" << endl;
+  o << "        continue;" << endl;
+  o << "      i.pos = static_cast<std::size_t>(start + offsets[s * k / slices]);" << endl;
+  o << "      if (slice.failed || (last != s && slice.pos != start + offsets[last]))" << endl;
+  o << "        Fail(i);" << endl;
+  o << "      else" << endl;
+  o << "        i.pos = slice.pos;" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void ReadParallel(InputBuffer &i, " << root->name << " &v, unsigned int threads) {" << endl;
+  o << "    const std::uint64_t start = i.pos;" << endl;
+  for (size_t k = 0; k < indexed.size(); ++k)
+  {
+    o << "    std::vector<std::uint64_t> " << indexed[k]->name << "_offsets;" << endl;
+    o << "    if (!ReadVectorIndex(i, " << k << ", start, " << indexed[k]->name << "_offsets)) {" << endl;
+    o << "      Fail(i);" << endl;
+    o << "      return;" << endl;
+    o << "    }" << endl;
+  }
+  for (const auto &m : root->member)
+  {
+    if (find(indexed.begin(), indexed.end(), &m) == indexed.end())
+      o << "    Read(i, v." << m.name << ");" << endl;
+    else
+      o << "    ReadVectorParallel(i, v." << m.name << ", " << m.name << "_offsets, start, threads);" << endl;
+  }
+  o << "  }" << endl << endl;
+}
+
+void WriteHeaderStart(ostream &o, const Package &p, const string &position)
+{
+  if (someThingIsShared(p))
+    o << "    const auto start = " << position << ";" << endl;
+}
+
+void WriteHeaderPatch(ostream &o, const Package &p, const string &args)
+{
+  if (someThingIsShared(p))
+    o << "    PatchHeader(" << args << ");" << endl;
+}
+
+void WriteParallelIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  if (parallelRootVectors(p).empty())
+    return;
+
+  const auto &root = p.root_type.value;
+  o << "  void Write" << root << "Parallel(std::ostream &o, const " << root
+    << " &v, unsigned int threads = std::thread::hardware_concurrency()) const {" << endl;
+  WriteHeaderStart(o, p, "o.tellp()");
+  o << endl << "    OutputStream s{o, 0" << referencesInit(p) << "};" << endl;
+  o << "    WriteHeader(s);" << endl;
+  o << "    WriteParallel(s, v, threads);" << endl;
+  WriteHeaderPatch(o, p, "o, start, s.references");
+  o << "  }" << endl << endl;
+
+  o << "  void Write" << root << "Parallel(std::vector<char> &b, const " << root
+    << " &v, unsigned int threads = std::thread::hardware_concurrency()) const {" << endl;
+  WriteHeaderStart(o, p, "b.size()");
+  o << endl << "    OutputBuffer o{b, b.size()" << referencesInit(p) << "};" << endl;
+  o << "    WriteHeader(o);" << endl;
+  o << "    WriteParallel(o, v, threads);" << endl;
+  o << "    b.resize(o.size);" << endl;
+  WriteHeaderPatch(o, p, "b.data() + start, o.references");
+  o << "  }" << endl << endl;
+
+  if (indexedRootVectors(p, options).empty())
+    return;
+
+  o << "  bool Read" << root << "Parallel(const char *data, std::size_t size, " << root
+    << " &v, unsigned int threads = std::thread::hardware_concurrency()) {" << endl;
+  o << endl << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    ReadParallel(i, v, threads);" << endl;
+  o << "    return !i.failed;" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteBaseIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  o << "  void Write" << p.root_type.value << "(std::ostream &o, const " << p.root_type.value << " &v) const {" << endl;
+  WriteHeaderStart(o, p, "o.tellp()");
+  o << endl << "    OutputStream s{o, 0" << referencesInit(p) << "};" << endl;
+  o << "    WriteHeader(s);" << endl;
+  o << "    " << rootWrite(p, options) << "(s, v);" << endl;
+  WriteHeaderPatch(o, p, "o, start, s.references");
+  o << "  }" << endl << endl;
+
+  o << "  void Write" << p.root_type.value << "(std::vector<char> &b, const " << p.root_type.value << " &v) const {"
+    << endl;
+  WriteHeaderStart(o, p, "b.size()");
+  o << endl << "    OutputBuffer o{b, b.size()" << referencesInit(p) << "};" << endl;
+  o << "    WriteHeader(o);" << endl;
+  o << "    " << rootWrite(p, options) << "(o, v);" << endl;
+  o << "    b.resize(o.size);" << endl;
+  WriteHeaderPatch(o, p, "b.data() + start, o.references");
+  o << "  }" << endl << endl;
+
+  o << "  bool Read" << p.root_type.value << "(std::istream &stream, " << p.root_type.value << " &v) {" << endl;
+  o << endl << "    auto i = MakeInput(stream);" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    Read(i, v);" << endl;
+  o << "    return !i.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Read" << p.root_type.value << "(const char *data, std::size_t size, " << p.root_type.value << " &v) {"
+    << endl;
+  o << endl << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    Read(i, v);" << endl;
+  o << "    return !i.failed;" << endl;
+  o << "  }" << endl << endl;
+}
+
+template <class T>
+void WriteSerializedSizeFor(ostream &o, const T &t, const Package &p, const OutputOptions &options)
+{
+  const auto isRoot = t.name == p.root_type.value;
+  const auto header = isRoot ? to_string(headerSize(p)) + " + " : string();
+  if (isComplex(t))
+  {
+    o << "  std::size_t SerializedSize(const " << t.name << " &v) const {" << endl;
+    o << "    OutputCounter c{0" << referencesInit(p) << "};" << endl;
+    if (isRoot)
+      o << "    WriteHeader(c);" << endl;
+    o << "    " << (isRoot ? rootWrite(p, options) : "Write") << "(c, v);" << endl;
+    o << "    return c.size;" << endl;
+    o << "  }" << endl << endl;
+  }
+  else
+  {
+    o << "  static constexpr std::size_t SerializedSize(const " << t.name << " &) {" << endl;
+    o << "    return " << header << "sizeof(" << t.name << ");" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+void WriteVisitorInput(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  o << "  template<typename I> void Visit(I &i, " << root->name << "Visitor &visitor) {" << endl;
+  for (const auto &m : root->member)
+  {
+    o << "    {" << endl;
+    if (m.isVector)
+    {
+      o << "      std::size_t size = 0;" << endl;
+      o << "      Read(i, size);" << endl;
+      o << "      visitor.on_" << m.name << "_begin(size);" << endl;
+      o << "      ";
+      WriteElementType(o, m, options) << " entry{};" << endl;
+      o << "      for (std::size_t n = 0; n < size && !Failed(i); ++n) {" << endl;
+      if (isBulkVector(p, m))
+        o << "        ReadValues(i, &entry, 1);" << endl;
+      else
+        o << "        Read(i, entry);" << endl;
+      o << "        visitor.on_" << m.name << "_element(entry);" << endl;
+      o << "      }" << endl;
+      o << "      visitor.on_" << m.name << "_end();" << endl;
+    }
+    else
+    {
+      o << "      ";
+      WriteType(o, m, options) << " value{};" << endl;
+      o << "      Read(i, value);" << endl;
+      o << "      visitor.on_" << m.name << "(value);" << endl;
+    }
+    o << "    }" << endl;
+  }
+  o << "  }" << endl << endl;
+}
+
+void WriteVisitorIO(ostream &o, const Package &p)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  o << "  bool Visit" << root->name << "(std::istream &stream, " << root->name << "Visitor &visitor) {" << endl;
+  o << endl << "    auto i = MakeInput(stream);" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    Visit(i, visitor);" << endl;
+  o << "    return !Failed(i);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Visit" << root->name << "(const char *data, std::size_t size, " << root->name
+    << "Visitor &visitor) {" << endl;
+  o << endl << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    Visit(i, visitor);" << endl;
+  o << "    return !Failed(i);" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteCompressedIO(ostream &o, const Package &p)
+{
+  const auto &root = p.root_type.value;
+
+  // the header is compressed with the first block and is not patched afterwards, its shared counts stay zero
+  o << "  void Write" << root << "Compressed(std::ostream &o, const " << root << " &v) const {" << endl;
+  o << endl << "    o.write(\"CORZ\", 4);" << endl;
+  o << "    CompressedOutput c{o, {}, {}" << referencesInit(p) << "};" << endl;
+  o << "    c.block.reserve(CompressedBlockSize());" << endl;
+  o << "    WriteHeader(c);" << endl;
+  o << "    Write(c, v);" << endl;
+  o << "    FlushBlock(c);" << endl;
+  o << "    const std::uint32_t end[2] = {0, 0};" << endl;
+  o << "    o.write(reinterpret_cast<const char *>(end), sizeof(end));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Read" << root << "Compressed(std::istream &i, " << root << " &v) {" << endl;
+  o << endl << "    char marker[4];" << endl;
+  o << "    i.read(marker, 4);" << endl;
+  o << "    if (!i || std::memcmp(marker, \"CORZ\", 4) != 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    CompressedInput c{MakeInput(i), {}, {}, 0, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (!ReadHeader(c))" << endl;
+  o << "      return false;" << endl;
+  o << "    Read(c, v);" << endl;
+  o << "    std::uint32_t end[2] = {1, 1};" << endl;
+  o << "    i.read(reinterpret_cast<char *>(end), sizeof(end));" << endl;
+  o << "    return !c.failed && c.pos == c.block.size() && i && end[0] == 0;" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteSerializedSize(ostream &o, const Package &p, const OutputOptions &options)
+{
+  for (const auto &t : p.types)
+    if (t.is_Table())
+      WriteSerializedSizeFor(o, t.as_Table(), p, options);
+    else if (t.is_Union())
+      WriteSerializedSizeFor(o, t.as_Union(), p, options);
+}
+
+// Save<root>File and Load<root>File map the file, the async and io_uring saves fall back to them on other systems
+bool mapsFiles(const OutputOptions &options)
+{
+  return options.mappedFile || options.asyncFile || options.ioUring;
+}
+
+// the file handle, write and sync helpers, shared by all the ways to save a file and by the journal
+bool needsFileFunctions(const OutputOptions &options)
+{
+  return mapsFiles(options) || options.journal;
+}
+
+void WriteFileFunctions(ostream &o)
+{
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "  // owns a file descriptor, it is closed on every way out unless close() was called" << endl;
+  o << "  struct FileHandle {" << endl;
+  o << "    FileHandle() = default;" << endl;
+  o << "    FileHandle(const FileHandle &) = delete;" << endl;
+  o << "    FileHandle &operator=(const FileHandle &) = delete;" << endl;
+  o << "    ~FileHandle() {" << endl;
+  o << "      if (fd >= 0)" << endl;
+  o << "        ::close(fd);" << endl;
+  o << "    }" << endl;
+  o << "    bool close() {" << endl;
+  o << "      const auto closed = fd >= 0 && ::close(fd) == 0;" << endl;
+  o << "      fd = -1;" << endl;
+  o << "      return closed;" << endl;
+  o << "    }" << endl;
+  o << "    int fd{-1};" << endl;
+  o << "  };" << endl << endl;
+  o << "  static bool PwriteAll(int fd, const char *d, std::size_t s, std::uint64_t offset) {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      const auto n = ::pwrite(fd, d, s, static_cast<off_t>(offset));" << endl;
+  o << "      if (n < 0 && errno == EINTR)" << endl;
+  o << "        continue;" << endl;
+  o << "      if (n <= 0)" << endl;
+  o << "        return false;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= static_cast<std::size_t>(n);" << endl;
+  o << "      offset += static_cast<std::uint64_t>(n);" << endl;
+  o << "    }" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+  o << "  // allocates the blocks up front, so a full disk fails here and not with SIGBUS while writing a mapping" << endl;
+  o << "  static bool ReserveFile(int fd, std::size_t size) {" << endl;
+  o << "#if defined(__APPLE__)" << endl;
+  o << "    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;" << endl;
+  o << "#else" << endl;
+  o << "    return ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+  o << "  // makes a rename into the directory of path durable" << endl;
+  o << "  static bool SyncDirectory(const std::string &path) {" << endl;
+  o << "    const auto slash = path.find_last_of('/');" << endl;
+  o << "    const auto directory = slash == std::string::npos ? std::string(\".\") : path.substr(0, slash == 0 ? 1 : slash);"
+    << endl;
+  o << "    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);" << endl;
+  o << "    if (fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    const auto synced = ::fsync(fd) == 0;" << endl;
+  o << "    return ::close(fd) == 0 && synced;" << endl;
+  o << "  }" << endl;
+  o << "#endif" << endl << endl;
+}
+
+void WriteFileIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto &root = p.root_type.value;
+
+  o << "  bool Load" << root << "File(const std::string &path, " << root << " &v) {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    const int fd = ::open(path.c_str(), O_RDONLY);" << endl;
+  o << "    if (fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    struct stat st;" << endl;
+  o << "    if (::fstat(fd, &st) != 0 || st.st_size == 0) {" << endl;
+  o << "      ::close(fd);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    const auto size = static_cast<std::size_t>(st.st_size);" << endl;
+  o << "    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);" << endl;
+  o << "    ::close(fd);" << endl;
+  o << "    if (data == MAP_FAILED)" << endl;
+  o << "      return false;" << endl;
+  o << "    ::madvise(data, size, MADV_SEQUENTIAL);" << endl;
+  o << "    const auto ok = Read" << root << "(static_cast<const char *>(data), size, v);" << endl;
+  o << "    ::munmap(data, size);" << endl;
+  o << "    return ok;" << endl;
+  o << "#else" << endl;
+  o << "    std::ifstream i(path, std::ios::binary);" << endl;
+  o << "    return i && Read" << root << "(i, v);" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Save" << root << "File(const std::string &path, const " << root << " &v) const {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    // the data goes to a temporary file first, path is replaced only once everything is on disk" << endl;
+  o << "    const auto size = SerializedSize(v);" << endl;
+  o << "    const auto temporary = path + \".tmp\";" << endl;
+  o << "    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);" << endl;
+  o << "    if (fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    void *data = ReserveFile(fd, size) ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;"
+    << endl;
+  o << "    if (data == MAP_FAILED) {" << endl;
+  o << "      ::close(fd);" << endl;
+  o << "      ::unlink(temporary.c_str());" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    OutputSpan s{static_cast<char *>(data), 0" << referencesInit(p) << "};" << endl;
+  o << "    WriteHeader(s);" << endl;
+  o << "    " << rootWrite(p, options) << "(s, v);" << endl;
+  WriteHeaderPatch(o, p, "s.data, s.references");
+  o << "    const auto flushed = ::msync(data, size, MS_SYNC) == 0;" << endl;
+  o << "    const auto synced = ::munmap(data, size) == 0 && flushed && ::fsync(fd) == 0;" << endl;
+  o << "    if (::close(fd) != 0 || !synced || ::rename(temporary.c_str(), path.c_str()) != 0) {" << endl;
+  o << "      ::unlink(temporary.c_str());" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    return SyncDirectory(path);" << endl;
+  o << "#else" << endl;
+  o << "    std::ofstream f(path, std::ios::binary);" << endl;
+  o << "    Write" << root << "(f, v);" << endl;
+  o << "    return bool(f);" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteAsyncOutput(ostream &o, const Package &p, const OutputOptions &options)
+{
+  o << "  static constexpr std::size_t AsyncBlockSize() {" << endl;
+  o << "    return 1 << 20;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  struct AsyncOutput {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    FileHandle file;" << endl;
+  o << "#else" << endl;
+  o << "    std::ofstream file;" << endl;
+  o << "#endif" << endl;
+  o << "    std::vector<char> buffer;" << endl;
+  o << "    std::vector<char> flushing;" << endl;
+  o << "    std::future<bool> flushed;" << endl;
+  o << "    std::uint64_t size;" << endl;
+  o << "    bool failed;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+
+  o << "  static bool FlushAll(AsyncOutput &o, const std::vector<char> &d) {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    std::size_t done = 0;" << endl;
+  o << "    while (done < d.size()) {" << endl;
+  o << "      const auto n = ::write(o.file.fd, d.data() + done, d.size() - done);" << endl;
+  o << "      if (n < 0 && errno == EINTR)" << endl;
+  o << "        continue;" << endl;
+  o << "      if (n <= 0)" << endl;
+  o << "        return false;" << endl;
+  o << "      done += static_cast<std::size_t>(n);" << endl;
+  o << "    }" << endl;
+  o << "    return true;" << endl;
+  o << "#else" << endl;
+  o << "    return bool(o.file.write(d.data(), d.size()));" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static bool WaitFlush(AsyncOutput &o) {" << endl;
+  o << "    if (o.flushed.valid() && !o.flushed.get())" << endl;
+  o << "      o.failed = true;" << endl;
+  o << "    return !o.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static void FlushAsync(AsyncOutput &o) {" << endl;
+  o << "    WaitFlush(o);" << endl;
+  o << "    std::swap(o.buffer, o.flushing);" << endl;
+  o << "    o.buffer.clear();" << endl;
+  o << "    auto *output = &o;" << endl;
+  o << "    o.flushed = std::async(std::launch::async, [output]() { return FlushAll(*output, output->flushing); });"
+    << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void WriteBytes(AsyncOutput &o, const char *d, std::size_t s) const {" << endl;
+  o << "    o.buffer.insert(o.buffer.end(), d, d + s);" << endl;
+  o << "    o.size += s;" << endl;
+  o << "    if (o.buffer.size() >= AsyncBlockSize())" << endl;
+  o << "      FlushAsync(o);" << endl;
+  o << "  }" << endl << endl;
+
+  if (!indexedRootVectors(p, options).empty())
+  {
+    o << "  std::uint64_t Position(AsyncOutput &o) const {" << endl;
+    o << "    return o.size;" << endl;
+    o << "  }" << endl << endl;
+  }
+}
+
+// the shared counts of the header in the order they are written, for files that are written front to back
+void WriteFileHeaderCounts(ostream &o, const Package &p, const string &references)
+{
+  o << "    char header[" << headerSize(p) << "];" << endl;
+  o << "    PatchHeader(header, " << references << ");" << endl;
+  o << "    const std::string counts(header + " << countsOffset(p) << ", " << sharedTypes(p).size() * sizeof(uint32_t)
+    << ");" << endl;
+}
+
+void WriteAsyncFileIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto &root = p.root_type.value;
+  const auto shared = someThingIsShared(p);
+
+  o << "  std::future<bool> Save" << root << "FileAsync(const std::string &path, const " << root << " &v) const {"
+    << endl;
+  o << "    auto output = std::make_shared<AsyncOutput>();" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    // the data goes to a temporary file first, path is replaced only once everything is on disk" << endl;
+  o << "    const auto temporary = path + \".tmp\";" << endl;
+  o << "    output->file.fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);" << endl;
+  o << "    if (output->file.fd < 0) {" << endl;
+  o << "#else" << endl;
+  o << "    output->file.open(path, std::ios::binary);" << endl;
+  o << "    if (!output->file) {" << endl;
+  o << "#endif" << endl;
+  o << "      std::promise<bool> failed;" << endl;
+  o << "      failed.set_value(false);" << endl;
+  o << "      return failed.get_future();" << endl;
+  o << "    }" << endl;
+  o << "    output->buffer.reserve(AsyncBlockSize());" << endl;
+  o << "    output->flushing.reserve(AsyncBlockSize());" << endl;
+  o << "    WriteHeader(*output);" << endl;
+  o << "    " << rootWrite(p, options) << "(*output, v);" << endl;
+  if (shared)
+    WriteFileHeaderCounts(o, p, "output->references");
+  const auto captured = shared ? ", counts" : "";
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    return std::async(std::launch::async, [output, path, temporary" << captured << "]() {" << endl;
+  o << "      " << (shared ? "auto" : "const auto") << " ok = WaitFlush(*output) && FlushAll(*output, output->buffer);"
+    << endl;
+  if (shared)
+    o << "      ok = ok && PwriteAll(output->file.fd, counts.data(), counts.size(), " << countsOffset(p) << ");" << endl;
+  o << "      if (!ok || ::fsync(output->file.fd) != 0 || !output->file.close() ||" << endl;
+  o << "          ::rename(temporary.c_str(), path.c_str()) != 0) {" << endl;
+  o << "        ::unlink(temporary.c_str());" << endl;
+  o << "        return false;" << endl;
+  o << "      }" << endl;
+  o << "      return SyncDirectory(path);" << endl;
+  o << "#else" << endl;
+  o << "    return std::async(std::launch::async, [output" << captured << "]() {" << endl;
+  o << "      const auto ok = WaitFlush(*output) && FlushAll(*output, output->buffer);" << endl;
+  if (shared)
+  {
+    o << "      output->file.seekp(" << countsOffset(p) << ");" << endl;
+    o << "      output->file.write(counts.data(), counts.size());" << endl;
+  }
+  o << "      output->file.close();" << endl;
+  o << "      return ok && !output->file.fail();" << endl;
+  o << "#endif" << endl;
+  o << "    });" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteFileRingFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "  static constexpr std::size_t FileBlockSize() {" << endl;
+  o << "    return 1 << 20;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static constexpr std::size_t FileBlockCount() {" << endl;
+  o << "    return 4;" << endl;
+  o << "  }" << endl << endl;
+  o << "#ifdef COREBUFFER_IO_URING" << endl;
+  o << "  struct FileRing {" << endl;
+  o << "    int fd{-1};" << endl;
+  o << "    void *sqRing;" << endl;
+  o << "    void *cqRing;" << endl;
+  o << "    io_uring_sqe *sqes;" << endl;
+  o << "    std::size_t sqRingSize;" << endl;
+  o << "    std::size_t cqRingSize;" << endl;
+  o << "    std::size_t sqesSize;" << endl;
+  o << "    unsigned *sqHead;" << endl;
+  o << "    unsigned *sqTail;" << endl;
+  o << "    unsigned *sqMask;" << endl;
+  o << "    unsigned *sqArray;" << endl;
+  o << "    unsigned *cqHead;" << endl;
+  o << "    unsigned *cqTail;" << endl;
+  o << "    unsigned *cqMask;" << endl;
+  o << "    io_uring_cqe *cqes;" << endl;
+  o << "  };" << endl << endl;
+  o << "  static void CloseRing(FileRing &r) {" << endl;
+  o << "    if (r.sqes)" << endl;
+  o << "      ::munmap(r.sqes, r.sqesSize);" << endl;
+  o << "    if (r.cqRing)" << endl;
+  o << "      ::munmap(r.cqRing, r.cqRingSize);" << endl;
+  o << "    if (r.sqRing)" << endl;
+  o << "      ::munmap(r.sqRing, r.sqRingSize);" << endl;
+  o << "    if (r.fd >= 0)" << endl;
+  o << "      ::close(r.fd);" << endl;
+  o << "    r = FileRing();" << endl;
+  o << "    r.fd = -1;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool SetupRing(FileRing &r, char *buffer, std::size_t size) {" << endl;
+  o << "    r = FileRing();" << endl;
+  o << "    io_uring_params params;" << endl;
+  o << "    std::memset(&params, 0, sizeof(params));" << endl;
+  o << "    r.fd = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(FileBlockCount()), &params));"
+    << endl;
+  o << "    if (r.fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    r.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);" << endl;
+  o << "    r.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);" << endl;
+  o << "    r.sqesSize = params.sq_entries * sizeof(io_uring_sqe);" << endl;
+  o << "    const auto map = [&r](std::size_t length, off_t offset) -> void * {" << endl;
+  o << "      void *p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, offset);"
+    << endl;
+  o << "      return p == MAP_FAILED ? nullptr : p;" << endl;
+  o << "    };" << endl;
+  o << "    r.sqRing = map(r.sqRingSize, IORING_OFF_SQ_RING);" << endl;
+  o << "    r.cqRing = map(r.cqRingSize, IORING_OFF_CQ_RING);" << endl;
+  o << "    r.sqes = static_cast<io_uring_sqe *>(map(r.sqesSize, IORING_OFF_SQES));" << endl;
+  o << "    iovec registered{buffer, size};" << endl;
+  o << "    if (!r.sqRing || !r.cqRing || !r.sqes ||" << endl;
+  o << "        ::syscall(__NR_io_uring_register, r.fd, IORING_REGISTER_BUFFERS, &registered, 1) != 0) {" << endl;
+  o << "      CloseRing(r);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    auto *sq = static_cast<char *>(r.sqRing);" << endl;
+  o << "    r.sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);" << endl;
+  o << "    r.sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);" << endl;
+  o << "    r.sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);" << endl;
+  o << "    r.sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);" << endl;
+  o << "    auto *cq = static_cast<char *>(r.cqRing);" << endl;
+  o << "    r.cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);" << endl;
+  o << "    r.cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);" << endl;
+  o << "    r.cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);" << endl;
+  o << "    r.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool SubmitFixed(FileRing &r, bool write, int fd, char *d, std::size_t s, std::uint64_t offset,"
+    << endl;
+  o << "                          std::uint64_t tag) {" << endl;
+  o << "    const auto tail = *r.sqTail;" << endl;
+  o << "    const auto slot = tail & *r.sqMask;" << endl;
+  o << "    auto &sqe = r.sqes[slot];" << endl;
+  o << "    std::memset(&sqe, 0, sizeof(sqe));" << endl;
+  o << "    sqe.opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;" << endl;
+  o << "    sqe.fd = fd;" << endl;
+  o << "    sqe.addr = reinterpret_cast<std::uint64_t>(d);" << endl;
+  o << "    sqe.len = static_cast<std::uint32_t>(s);" << endl;
+  o << "    sqe.off = offset;" << endl;
+  o << "    sqe.buf_index = 0;" << endl;
+  o << "    sqe.user_data = tag;" << endl;
+  o << "    r.sqArray[slot] = slot;" << endl;
+  o << "    __atomic_store_n(r.sqTail, tail + 1, __ATOMIC_RELEASE);" << endl;
+  o << "    long submitted = 0;" << endl;
+  o << "    do" << endl;
+  o << "      submitted = ::syscall(__NR_io_uring_enter, r.fd, 1, 0, 0, nullptr, 0);" << endl;
+  o << "    while (submitted < 0 && errno == EINTR);" << endl;
+  o << "    if (submitted == 1 || __atomic_load_n(r.sqHead, __ATOMIC_ACQUIRE) != tail)" << endl;
+  o << "      return true;" << endl;
+  o << "    __atomic_store_n(r.sqTail, tail, __ATOMIC_RELEASE);" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool WaitFixed(FileRing &r, std::uint64_t &tag, int &result) {" << endl;
+  o << "    for (;;) {" << endl;
+  o << "      const auto head = *r.cqHead;" << endl;
+  o << "      if (head != __atomic_load_n(r.cqTail, __ATOMIC_ACQUIRE)) {" << endl;
+  o << "        const auto &cqe = r.cqes[head & *r.cqMask];" << endl;
+  o << "        tag = cqe.user_data;" << endl;
+  o << "        result = cqe.res;" << endl;
+  o << "        __atomic_store_n(r.cqHead, head + 1, __ATOMIC_RELEASE);" << endl;
+  o << "        return true;" << endl;
+  o << "      }" << endl;
+  o << "      if (::syscall(__NR_io_uring_enter, r.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)"
+    << endl;
+  o << "        return false;" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+  o << "#else" << endl;
+  o << "  struct FileRing {" << endl;
+  o << "    int fd{-1};" << endl;
+  o << "  };" << endl << endl;
+  o << "  static void CloseRing(FileRing &r) {" << endl;
+  o << "    r.fd = -1;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool SetupRing(FileRing &r, char *, std::size_t) {" << endl;
+  o << "    r.fd = -1;" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool SubmitFixed(FileRing &, bool, int, char *, std::size_t, std::uint64_t, std::uint64_t) {" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool WaitFixed(FileRing &, std::uint64_t &, int &) {" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+  o << "#endif" << endl << endl;
+  o << "  static bool PreadAll(int fd, char *d, std::size_t s, std::uint64_t offset) {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      const auto n = ::pread(fd, d, s, static_cast<off_t>(offset));" << endl;
+  o << "      if (n < 0 && errno == EINTR)" << endl;
+  o << "        continue;" << endl;
+  o << "      if (n <= 0)" << endl;
+  o << "        return false;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= static_cast<std::size_t>(n);" << endl;
+  o << "      offset += static_cast<std::uint64_t>(n);" << endl;
+  o << "    }" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+  o << "  struct FileOutput {" << endl;
+  o << "    ~FileOutput() {" << endl;
+  o << "      CloseRing(ring);" << endl;
+  o << "    }" << endl;
+  o << "    FileHandle file;" << endl;
+  o << "    FileRing ring;" << endl;
+  o << "    std::vector<char> blocks;" << endl;
+  o << "    std::vector<std::size_t> pending;" << endl;
+  o << "    std::vector<std::uint64_t> offsets;" << endl;
+  o << "    std::size_t block;" << endl;
+  o << "    std::size_t used;" << endl;
+  o << "    std::uint64_t size;" << endl;
+  o << "    bool failed;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+  o << "  static void CompleteWrite(FileOutput &o) {" << endl;
+  o << "    std::uint64_t block = 0;" << endl;
+  o << "    int result = 0;" << endl;
+  o << "    if (!WaitFixed(o.ring, block, result) || block >= FileBlockCount()) {" << endl;
+  o << "      o.failed = true;" << endl;
+  o << "      std::fill(o.pending.begin(), o.pending.end(), 0);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    const auto length = o.pending[block];" << endl;
+  o << "    const auto done = static_cast<std::size_t>(std::max(result, 0));" << endl;
+  o << "    if (result < 0 || (done < length && !PwriteAll(o.file.fd, o.blocks.data() + block * FileBlockSize() + done,"
+    << endl;
+  o << "                                                     length - done, o.offsets[block] + done)))" << endl;
+  o << "      o.failed = true;" << endl;
+  o << "    o.pending[block] = 0;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static void SubmitBlock(FileOutput &o) {" << endl;
+  o << "    if (o.used == 0)" << endl;
+  o << "      return;" << endl;
+  o << "    auto *d = o.blocks.data() + o.block * FileBlockSize();" << endl;
+  o << "    if (o.ring.fd >= 0 && SubmitFixed(o.ring, true, o.file.fd, d, o.used, o.size, o.block)) {" << endl;
+  o << "      o.pending[o.block] = o.used;" << endl;
+  o << "      o.offsets[o.block] = o.size;" << endl;
+  o << "    } else if (!PwriteAll(o.file.fd, d, o.used, o.size)) {" << endl;
+  o << "      o.failed = true;" << endl;
+  o << "    }" << endl;
+  o << "    o.size += o.used;" << endl;
+  o << "    o.used = 0;" << endl;
+  o << "    o.block = (o.block + 1) % FileBlockCount();" << endl;
+  o << "    while (o.pending[o.block] != 0)" << endl;
+  o << "      CompleteWrite(o);" << endl;
+  o << "  }" << endl << endl;
+  o << "  void WriteBytes(FileOutput &o, const char *d, std::size_t s) const {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      const auto n = std::min(s, FileBlockSize() - o.used);" << endl;
+  o << "      std::memcpy(o.blocks.data() + o.block * FileBlockSize() + o.used, d, n);" << endl;
+  o << "      o.used += n;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= n;" << endl;
+  o << "      if (o.used == FileBlockSize())" << endl;
+  o << "        SubmitBlock(o);" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool FinishOutput(FileOutput &o) {" << endl;
+  o << "    SubmitBlock(o);" << endl;
+  o << "    for (std::size_t block = 0; block < FileBlockCount(); ++block)" << endl;
+  o << "      while (o.pending[block] != 0)" << endl;
+  o << "        CompleteWrite(o);" << endl;
+  o << "    CloseRing(o.ring);" << endl;
+  o << "    return !o.failed;" << endl;
+  o << "  }" << endl << endl;
+  o << "  struct FileInput {" << endl;
+  o << "    ~FileInput() {" << endl;
+  o << "      CloseRing(ring);" << endl;
+  o << "    }" << endl;
+  o << "    FileHandle file;" << endl;
+  o << "    FileRing ring;" << endl;
+  o << "    std::vector<char> blocks;" << endl;
+  o << "    std::vector<char> loaded;" << endl;
+  o << "    std::uint64_t size;" << endl;
+  o << "    std::uint64_t current;" << endl;
+  o << "    std::size_t pos;" << endl;
+  o << "    std::size_t pending;" << endl;
+  o << "    bool failed;" << endl;
+  WriteReferencesMember(o, p, "ReadReferences");
+  o << "  };" << endl << endl;
+  o << "  static std::size_t BlockLength(const FileInput &i, std::uint64_t block) {" << endl;
+  o << "    if (block * FileBlockSize() >= i.size)" << endl;
+  o << "      return 0;" << endl;
+  o << "    return static_cast<std::size_t>(std::min<std::uint64_t>(FileBlockSize(), i.size - block * FileBlockSize()));"
+    << endl;
+  o << "  }" << endl << endl;
+  o << "  static void RequestBlock(FileInput &i, std::uint64_t block) {" << endl;
+  o << "    const auto slot = block % FileBlockCount();" << endl;
+  o << "    i.loaded[slot] = 0;" << endl;
+  o << "    if (BlockLength(i, block) == 0 || i.ring.fd < 0)" << endl;
+  o << "      return;" << endl;
+  o << "    if (SubmitFixed(i.ring, false, i.file.fd, i.blocks.data() + slot * FileBlockSize(), BlockLength(i, block),"
+    << endl;
+  o << "                    block * FileBlockSize(), block))" << endl;
+  o << "      ++i.pending;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static void CompleteRead(FileInput &i) {" << endl;
+  o << "    std::uint64_t block = 0;" << endl;
+  o << "    int result = 0;" << endl;
+  o << "    if (!WaitFixed(i.ring, block, result)) {" << endl;
+  o << "      i.failed = true;" << endl;
+  o << "      i.pending = 0;" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    --i.pending;" << endl;
+  o << "    const auto slot = block % FileBlockCount();" << endl;
+  o << "    const auto length = BlockLength(i, block);" << endl;
+  o << "    const auto done = static_cast<std::size_t>(std::max(result, 0));" << endl;
+  o << "    auto *d = i.blocks.data() + slot * FileBlockSize();" << endl;
+  o << "    i.loaded[slot] = result >= 0 && (done >= length || PreadAll(i.file.fd, d + done, length - done," << endl;
+  o << "                                                                   block * FileBlockSize() + done));" << endl;
+  o << "    if (!i.loaded[slot])" << endl;
+  o << "      i.failed = true;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool LoadBlock(FileInput &i, std::uint64_t block) {" << endl;
+  o << "    const auto slot = block % FileBlockCount();" << endl;
+  o << "    while (!i.loaded[slot] && i.pending != 0 && !i.failed)" << endl;
+  o << "      CompleteRead(i);" << endl;
+  o << "    if (i.loaded[slot])" << endl;
+  o << "      return true;" << endl;
+  o << "    return !i.failed && BlockLength(i, block) != 0 &&" << endl;
+  o << "           PreadAll(i.file.fd, i.blocks.data() + slot * FileBlockSize(), BlockLength(i, block), block * FileBlockSize());"
+    << endl;
+  o << "  }" << endl << endl;
+  o << "  void ReadBytes(FileInput &i, char *d, std::size_t s) {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      if (i.failed) {" << endl;
+  o << "        std::memset(d, 0, s);" << endl;
+  o << "        return;" << endl;
+  o << "      }" << endl;
+  o << "      if (i.pos == BlockLength(i, i.current)) {" << endl;
+  o << "        RequestBlock(i, i.current + FileBlockCount());" << endl;
+  o << "        ++i.current;" << endl;
+  o << "        i.pos = 0;" << endl;
+  o << "        if (!LoadBlock(i, i.current))" << endl;
+  o << "          Fail(i);" << endl;
+  o << "        continue;" << endl;
+  o << "      }" << endl;
+  o << "      const auto n = std::min(s, BlockLength(i, i.current) - i.pos);" << endl;
+  o << "      std::memcpy(d, i.blocks.data() + (i.current % FileBlockCount()) * FileBlockSize() + i.pos, n);" << endl;
+  o << "      i.pos += n;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= n;" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+  o << "  bool Failed(FileInput &i) {" << endl;
+  o << "    return i.failed;" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Fail(FileInput &i) {" << endl;
+  o << "    if (!i.failed)" << endl;
+  o << "      error_offset_ = i.current * FileBlockSize() + i.pos;" << endl;
+  o << "    i.failed = true;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static std::uint64_t Remaining(const FileInput &i) {" << endl;
+  o << "    return i.size - i.current * FileBlockSize() - i.pos;" << endl;
+  o << "  }" << endl << endl;
+  o << "  bool Available(FileInput &i, std::size_t count, std::size_t size) {" << endl;
+  o << "    if (count <= Remaining(i) / size)" << endl;
+  o << "      return true;" << endl;
+  o << "    Fail(i);" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+  o << "  static bool FinishInput(FileInput &i) {" << endl;
+  o << "    while (i.pending != 0)" << endl;
+  o << "      CompleteRead(i);" << endl;
+  o << "    CloseRing(i.ring);" << endl;
+  o << "    return i.file.close() && !i.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  if (!indexedRootVectors(p, options).empty())
+  {
+    o << "  std::uint64_t Position(FileOutput &o) const {" << endl;
+    o << "    return o.size + o.used;" << endl;
+    o << "  }" << endl << endl;
+  }
+  o << "#endif" << endl << endl;
+}
+
+void WriteRingFileIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto &root = p.root_type.value;
+
+  o << "  bool Save" << root << "FileUring(const std::string &path, const " << root << " &v) const {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    const auto temporary = path + \".tmp\";" << endl;
+  o << "    FileOutput f{};" << endl;
+  o << "    f.file.fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);" << endl;
+  o << "    if (f.file.fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    f.blocks.resize(FileBlockCount() * FileBlockSize());" << endl;
+  o << "    f.pending.assign(FileBlockCount(), 0);" << endl;
+  o << "    f.offsets.assign(FileBlockCount(), 0);" << endl;
+  o << "    SetupRing(f.ring, f.blocks.data(), f.blocks.size());" << endl;
+  o << "    WriteHeader(f);" << endl;
+  o << "    " << rootWrite(p, options) << "(f, v);" << endl;
+  if (someThingIsShared(p))
+  {
+    o << "    auto ok = FinishOutput(f);" << endl;
+    o << "    char header[" << headerSize(p) << "];" << endl;
+    o << "    PatchHeader(header, f.references);" << endl;
+    o << "    ok = ok && PwriteAll(f.file.fd, header + " << countsOffset(p) << ", "
+      << sharedTypes(p).size() * sizeof(uint32_t) << ", " << countsOffset(p) << ");" << endl;
+  }
+  else
+    o << "    const auto ok = FinishOutput(f);" << endl;
+  o << "    if (!ok || ::fsync(f.file.fd) != 0 || !f.file.close() || ::rename(temporary.c_str(), path.c_str()) != 0) {"
+    << endl;
+  o << "      ::unlink(temporary.c_str());" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    return SyncDirectory(path);" << endl;
+  o << "#else" << endl;
+  o << "    return Save" << root << "File(path, v);" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Load" << root << "FileUring(const std::string &path, " << root << " &v) {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    FileInput f{};" << endl;
+  o << "    f.file.fd = ::open(path.c_str(), O_RDONLY);" << endl;
+  o << "    if (f.file.fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    struct stat st;" << endl;
+  o << "    if (::fstat(f.file.fd, &st) != 0 || st.st_size == 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    f.size = static_cast<std::uint64_t>(st.st_size);" << endl;
+  o << "    f.blocks.resize(FileBlockCount() * FileBlockSize());" << endl;
+  o << "    f.loaded.assign(FileBlockCount(), 0);" << endl;
+  o << "    SetupRing(f.ring, f.blocks.data(), f.blocks.size());" << endl;
+  o << "    for (std::uint64_t block = 0; block < FileBlockCount(); ++block)" << endl;
+  o << "      RequestBlock(f, block);" << endl;
+  o << "    f.failed = !LoadBlock(f, 0);" << endl;
+  o << "    if (ReadHeader(f))" << endl;
+  o << "      Read(f, v);" << endl;
+  o << "    else" << endl;
+  o << "      f.failed = true;" << endl;
+  o << "    return FinishInput(f);" << endl;
+  o << "#else" << endl;
+  o << "    return Load" << root << "File(path, v);" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteIOStructMember(const Package &p, ostream &o)
+{
+  o << "  std::uint64_t error_offset_{0};" << endl << endl;
+
+  const auto shared = sharedTypes(p);
+  if (shared.empty())
+    return;
+
+  // the shared objects of one call travel with its output or input, the _io object itself keeps no state for them
+  o << "  struct WriteReferences {" << endl;
+  for (const auto &name : shared)
+    o << "    std::unordered_map<const " << name << " *, unsigned int> " << name << "_ids;" << endl;
+  o << "  };" << endl << endl;
+
+  o << "  struct ReadReferences {" << endl;
+  for (const auto &name : shared)
+  {
+    o << "    std::vector<std::shared_ptr<" << name << ">> " << name << "_objects;" << endl;
+    o << "    std::uint32_t " << name << "_count{0};" << endl;
+    o << "    std::uint64_t " << name << "_verified{0};" << endl;
+  }
+  o << "  };" << endl << endl;
+}
+
+bool hasViews(const Package &p)
+{
+  return any_of(p.types.begin(), p.types.end(), [](const Type &t) {
+    return t.is_Union() || (t.is_Table() && isComplex(t.as_Table()));
+  });
+}
+
+bool isUnion(const Package &p, const string &name)
+{
+  return any_union_of(p, [&name](const Union &u) { return u.name == name; });
+}
+
+bool isViewType(const Package &p, const string &type)
+{
+  const auto *t = findTable(p, type);
+  return isUnion(p, type) || (t && isComplex(*t));
+}
+
+string viewType(const Package &p, const string &type, Pointer pointer)
+{
+  if (pointer == Pointer::Shared || pointer == Pointer::Weak)
+    return string();
+  if (type == "std::string")
+    return pointer == Pointer::Plain ? "StringView" : string();
+  if (isViewType(p, type))
+    return type + "View";
+  return pointer == Pointer::Plain ? type : string();
+}
+
+string memberViewType(const Package &p, const Member &m)
+{
+  const auto element = viewType(p, m.type, m.pointer);
+  if (!m.isVector || element.empty())
+    return element;
+  if (isBulkVector(p, m))
+    return "ArrayView<" + m.type + ">";
+  ostringstream encoded;
+  WriteElementType(encoded, m, OutputOptions());
+  return "ListView<" + p.root_type.value + "_io, " + element + ", " + encoded.str() + ">";
+}
+
+bool isListView(const Package &p, const Member &m)
+{
+  return m.isVector && !isBulkVector(p, m) && !viewType(p, m.type, m.pointer).empty();
+}
+
+string tagOf(const string &type)
+{
+  return "const " + type + " *";
+}
+
+string nullOf(const string &type)
+{
+  return "static_cast<" + tagOf(type) + ">(nullptr)";
+}
+
+void WriteViewDeclarations(ostream &o, const Package &p, const OutputOptions &options)
+{
+  if (!hasViews(p))
+    return;
+
+  o << "struct StringView {" << endl;
+  o << "  StringView() = default;" << endl;
+  o << "  StringView(const char *data, std::size_t size) : data_(data), size_(size) {}" << endl << endl;
+  o << "  const char *data() const { return data_; }" << endl;
+  o << "  std::size_t size() const { return size_; }" << endl;
+  o << "  bool empty() const { return size_ == 0; }" << endl;
+  o << "  std::string str() const { return size_ == 0 ? std::string() : std::string(data_, size_); }" << endl << endl;
+  o << "  friend bool operator==(const StringView &l, const std::string &r) {" << endl;
+  o << "    return l.size_ == r.size() && (l.size_ == 0 || std::memcmp(l.data_, r.data(), l.size_) == 0);" << endl;
+  o << "  }" << endl;
+  o << "  friend bool operator!=(const StringView &l, const std::string &r) { return !(l == r); }" << endl << endl;
+  o << "private:" << endl;
+  o << "  const char *data_{nullptr};" << endl;
+  o << "  std::size_t size_{0};" << endl;
+  o << "};" << endl << endl;
+  o << "template<typename T> struct ArrayView {" << endl;
+  o << "  ArrayView() = default;" << endl;
+  o << "  ArrayView(const char *data, std::size_t count) : data_(data), count_(count) {}" << endl << endl;
+  o << "  std::size_t size() const { return count_; }" << endl;
+  o << "  bool empty() const { return count_ == 0; }" << endl;
+  o << "  T operator[](std::size_t index) const {" << endl;
+  o << "    T v;" << endl;
+  o << "    std::memcpy(static_cast<void *>(&v), data_ + index * sizeof(T), sizeof(T));" << endl;
+  if (options.portableWire)
+    o << "    WireOrder(&v, 1);" << endl;
+  o << "    return v;" << endl;
+  o << "  }" << endl << endl;
+  o << "  struct iterator {" << endl;
+  o << "    const ArrayView *view;" << endl;
+  o << "    std::size_t index;" << endl << endl;
+  o << "    T operator*() const { return (*view)[index]; }" << endl;
+  o << "    iterator &operator++() { ++index; return *this; }" << endl;
+  o << "    bool operator==(const iterator &o) const { return index == o.index; }" << endl;
+  o << "    bool operator!=(const iterator &o) const { return index != o.index; }" << endl;
+  o << "  };" << endl;
+  o << "  iterator begin() const { return iterator{this, 0}; }" << endl;
+  o << "  iterator end() const { return iterator{this, count_}; }" << endl << endl;
+  o << "private:" << endl;
+  o << "  const char *data_{nullptr};" << endl;
+  o << "  std::size_t count_{0};" << endl;
+  o << "};" << endl << endl;
+  o << "// elements are found by passing the ones in front of them, or through the offset index of --index-vectors;" << endl;
+  o << "// the offsets passed for indexing are kept, so indexing the same list again takes constant time" << endl;
+  o << "template<typename IO, typename E, typename Encoded> struct ListView {" << endl;
+  o << "  ListView() = default;" << endl;
+  o << "  ListView(const char *data, std::size_t size, std::size_t first, std::size_t count, const char *index = nullptr)"
+    << endl;
+  o << "    : data_(data), size_(size), first_(first), count_(count), index_(index) {}" << endl << endl;
+  o << "  std::size_t size() const { return count_; }" << endl;
+  o << "  bool empty() const { return count_ == 0; }" << endl << endl;
+  o << "  E operator[](std::size_t index) const {" << endl;
+  o << "    return At(Find(index));" << endl;
+  o << "  }" << endl << endl;
+  o << "  struct iterator {" << endl;
+  o << "    const ListView *view;" << endl;
+  o << "    std::size_t index;" << endl;
+  o << "    std::size_t pos;" << endl << endl;
+  o << "    E operator*() const { return view->At(pos); }" << endl;
+  o << "    iterator &operator++() {" << endl;
+  o << "      ++index;" << endl;
+  o << "      pos = view->index_ ? view->Find(index) : view->Next(pos);" << endl;
+  o << "      // a list that cannot be passed ends where it broke" << endl;
+  o << "      if (pos >= view->size_)" << endl;
+  o << "        index = view->count_;" << endl;
+  o << "      return *this;" << endl;
+  o << "    }" << endl;
+  o << "    bool operator==(const iterator &o) const { return index == o.index; }" << endl;
+  o << "    bool operator!=(const iterator &o) const { return index != o.index; }" << endl;
+  o << "  };" << endl;
+  o << "  iterator begin() const { return iterator{this, 0, index_ ? Find(0) : first_}; }" << endl;
+  o << "  iterator end() const { return iterator{this, count_, size_}; }" << endl << endl;
+  o << "  // where the list ends, the size of the data if it cannot be passed" << endl;
+  o << "  std::size_t EndOffset() const {" << endl;
+  o << "    if (count_ == 0)" << endl;
+  o << "      return first_;" << endl;
+  o << "    if (index_)" << endl;
+  o << "      return Next(Find(count_ - 1));" << endl;
+  o << "    auto pos = first_;" << endl;
+  o << "    for (std::size_t n = 0; n < count_ && pos < size_; ++n)" << endl;
+  o << "      pos = Next(pos);" << endl;
+  o << "    return pos;" << endl;
+  o << "  }" << endl << endl;
+  o << "private:" << endl;
+  o << "  std::size_t Next(std::size_t pos) const {" << endl;
+  o << "    if (pos >= size_)" << endl;
+  o << "      return size_;" << endl;
+  o << "    IO io;" << endl;
+  o << "    typename IO::InputBuffer i{data_, size_, pos, false" << referencesInit(p) << "};" << endl;
+  o << "    io.Skip(i, static_cast<const Encoded *>(nullptr));" << endl;
+  o << "    return i.failed ? size_ : i.pos;" << endl;
+  o << "  }" << endl << endl;
+  o << "  std::size_t Find(std::size_t index) const {" << endl;
+  o << "    if (index >= count_)" << endl;
+  o << "      return size_;" << endl;
+  o << "    if (index_) {" << endl;
+  o << "      IO io;" << endl;
+  o << "      typename IO::InputBuffer i{index_, count_ * sizeof(std::uint64_t), index * sizeof(std::uint64_t), false"
+    << referencesInit(p) << "};" << endl;
+  o << "      std::uint64_t offset = 0;" << endl;
+  o << "      io.ReadValues(i, &offset, 1);" << endl;
+  o << "      return i.failed || offset >= size_ ? size_ : static_cast<std::size_t>(offset);" << endl;
+  o << "    }" << endl;
+  o << "    if (offsets_.empty())" << endl;
+  o << "      offsets_.push_back(first_);" << endl;
+  o << "    while (offsets_.size() <= index && offsets_.back() < size_)" << endl;
+  o << "      offsets_.push_back(Next(offsets_.back()));" << endl;
+  o << "    return offsets_.size() > index ? offsets_[index] : size_;" << endl;
+  o << "  }" << endl << endl;
+  o << "  E At(std::size_t pos) const {" << endl;
+  o << "    if (pos >= size_)" << endl;
+  o << "      return E();" << endl;
+  o << "    IO io;" << endl;
+  o << "    typename IO::InputBuffer i{data_, size_, pos, false" << referencesInit(p) << "};" << endl;
+  o << "    return io.MakeView(i, static_cast<const Encoded *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  const char *data_{nullptr};" << endl;
+  o << "  std::size_t size_{0};" << endl;
+  o << "  std::size_t first_{0};" << endl;
+  o << "  std::size_t count_{0};" << endl;
+  o << "  const char *index_{nullptr};" << endl;
+  o << "  mutable std::vector<std::size_t> offsets_;" << endl;
+  o << "};" << endl;
+
+  for (const auto &t : p.types)
+    if (t.is_Union() || (t.is_Table() && isComplex(t.as_Table())))
+      o << "struct " << (t.is_Union() ? t.as_Union().name : t.as_Table().name) << "View;" << endl;
+  o << endl;
+}
+
+void WriteViewFriends(ostream &o, const Package &p)
+{
+  if (!hasViews(p))
+    return;
+
+  for (const auto &t : p.types)
+    if (t.is_Union() || (t.is_Table() && isComplex(t.as_Table())))
+      o << "  friend struct " << (t.is_Union() ? t.as_Union().name : t.as_Table().name) << "View;" << endl;
+  o << "  template<typename, typename, typename> friend struct ListView;" << endl << endl;
+}
+
+void WriteUnionSelection(ostream &o, const Union &u, const OutputOptions &options)
+{
+  o << "  std::uint64_t ReadSelection(InputBuffer &i, const " << u.name << " *) {" << endl;
+  WriteSelectionValueInput(o, u, options);
+  o << "    if (value > " << u.tables.size() << ")" << endl;
+  o << "      Fail(i);" << endl;
+  o << "    return value;" << endl;
+  o << "  }" << endl << endl;
+}
+
+// the selection of a union read on its own, for the views and the verifier that look at a union without building it
+void WriteUnionSelections(ostream &o, const Package &p, const OutputOptions &options)
+{
+  for (const auto &t : p.types)
+    if (t.is_Union())
+      WriteUnionSelection(o, t.as_Union(), options);
+}
+
+void WriteViewInput(ostream &o, const Package &p, const OutputOptions &options)
+{
+  if (!hasViews(p))
+    return;
+
+  o << "  template<typename T> void Skip(InputBuffer &i, const T *) {" << endl;
+  o << "    T v;" << endl;
+  o << "    Read(i, v);" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::vector<T> *) {" << endl;
+  o << "    std::size_t s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (Available(i, s, sizeof(T)))" << endl;
+  o << "      i.pos += s * sizeof(T);" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void SkipEach(InputBuffer &i, const T *) {" << endl;
+  o << "    std::size_t s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (!Available(i, s, 1))" << endl;
+  o << "      return;" << endl;
+  o << "    for (std::size_t n = 0; n < s && !i.failed; ++n)" << endl;
+  o << "      Skip(i, static_cast<const T *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Skip(InputBuffer &i, const std::string *) {" << endl;
+  o << "    std::string::size_type s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (Available(i, s, 1))" << endl;
+  o << "      i.pos += s;" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Skip(InputBuffer &i, const std::vector<std::string> *) {" << endl;
+  o << "    SkipEach(i, static_cast<const std::string *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::unique_ptr<T> *) {" << endl;
+  o << "    char ref = 0;" << endl;
+  o << "    ReadBytes(i, &ref, 1);" << endl;
+  o << "    if (ref == '\\x1')" << endl;
+  o << "      Skip(i, static_cast<const T *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::shared_ptr<T> *) {" << endl;
+  o << "    char ref = 0;" << endl;
+  o << "    ReadBytes(i, &ref, 1);" << endl;
+  o << "    if (ref == '\\x1') {" << endl;
+  o << "      Skip(i, static_cast<const T *>(nullptr));" << endl;
+  o << "    } else if (ref == '\\x2') {" << endl;
+  o << "      unsigned int index = 0;" << endl;
+  o << "      Read(i, index);" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::weak_ptr<T> *) {" << endl;
+  o << "    Skip(i, static_cast<const std::shared_ptr<T> *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {" << endl;
+  o << "    SkipEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {" << endl;
+  o << "    SkipEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Skip(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {" << endl;
+  o << "    SkipEach(i, static_cast<const std::weak_ptr<T> *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  StringView MakeView(InputBuffer &i, const std::string *) {" << endl;
+  o << "    std::string::size_type s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (!Available(i, s, 1))" << endl;
+  o << "      return StringView();" << endl;
+  o << "    i.pos += s;" << endl;
+  o << "    return StringView(i.data + i.pos - s, s);" << endl;
+  o << "  }" << endl;
+
+  for (const auto &t : p.types)
+  {
+    string name;
+    if (t.is_Table() && isComplex(t.as_Table()))
+    {
+      const auto &table = t.as_Table();
+      name = table.name;
+      o << "  void Skip(InputBuffer &" << (table.member.empty() ? "" : "i") << ", " << tagOf(name) << ") {" << endl;
+      for (const auto &m : table.member)
+      {
+        ostringstream type;
+        WriteType(type, m, OutputOptions());
+        o << "    Skip(i, " << nullOf(type.str()) << ");" << endl;
+      }
+      o << "  }" << endl << endl;
+    }
+    else if (t.is_Union())
+    {
+      const auto &u = t.as_Union();
+      name = u.name;
+      o << "  void Skip(InputBuffer &i, " << tagOf(name) << ") {" << endl;
+      o << "    switch (ReadSelection(i, " << nullOf(name) << ")) {" << endl;
+      for (size_t k = 0; k < u.tables.size(); ++k)
+        o << "    case " << k + 1 << ": Skip(i, " << nullOf(u.tables[k].value) << "); break;" << endl;
+      o << "    case 0: break;" << endl;
+      o << "    default: Fail(i); break;" << endl;
+      o << "    }" << endl;
+      o << "  }" << endl << endl;
+    }
+    else
+      continue;
+
+    o << "  void Skip(InputBuffer &i, " << tagOf("std::vector<" + name + ">") << ") {" << endl;
+    o << "    SkipEach(i, " << nullOf(name) << ");" << endl;
+    o << "  }" << endl << endl;
+    o << "  " << name << "View MakeView(InputBuffer &i, " << tagOf(name) << ");" << endl;
+    o << "  " << name << "View MakeView(InputBuffer &i, " << tagOf("std::unique_ptr<" + name + ">") << ");" << endl
+      << endl;
+  }
+}
+
+void WriteVerifyInput(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root)
+    return;
+
+  o << "  template<typename T> void Verify(InputBuffer &i, const T *) {" << endl;
+  o << "    T v;" << endl;
+  o << "    Read(i, v);" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Verify(InputBuffer &i, const std::vector<T> *) {" << endl;
+  o << "    std::size_t s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (Available(i, s, sizeof(T)))" << endl;
+  o << "      i.pos += s * sizeof(T);" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void VerifyEach(InputBuffer &i, const T *) {" << endl;
+  o << "    std::size_t s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (!Available(i, s, 1))" << endl;
+  o << "      return;" << endl;
+  o << "    for (std::size_t n = 0; n < s && !i.failed; ++n)" << endl;
+  o << "      Verify(i, static_cast<const T *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Verify(InputBuffer &i, const std::string *) {" << endl;
+  o << "    std::string::size_type s{0};" << endl;
+  o << "    Read(i, s);" << endl;
+  o << "    if (Available(i, s, 1))" << endl;
+  o << "      i.pos += s;" << endl;
+  o << "  }" << endl << endl;
+  o << "  void Verify(InputBuffer &i, const std::vector<std::string> *) {" << endl;
+  o << "    VerifyEach(i, static_cast<const std::string *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Verify(InputBuffer &i, const std::unique_ptr<T> *) {" << endl;
+  o << "    char ref = 0;" << endl;
+  o << "    ReadBytes(i, &ref, 1);" << endl;
+  o << "    if (ref == '\\x1')" << endl;
+  o << "      Verify(i, static_cast<const T *>(nullptr));" << endl;
+  o << "    else if (ref != '\\0')" << endl;
+  o << "      Fail(i);" << endl;
+  o << "  }" << endl << endl;
+  o << "  template<typename T> void Verify(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {" << endl;
+  o << "    VerifyEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));" << endl;
+  o << "  }" << endl << endl;
+
+  const auto shared = sharedTypes(p);
+  if (!shared.empty())
+  {
+    for (const auto &name : shared)
+    {
+      o << "  static std::uint64_t &Verified(InputBuffer &i, " << tagOf(name) << ") {" << endl;
+      o << "    return i.references." << name << "_verified;" << endl;
+      o << "  }" << endl << endl;
+    }
+    o << "  template<typename T> void Verify(InputBuffer &i, const std::shared_ptr<T> *) {" << endl;
+    o << "    char ref = 0;" << endl;
+    o << "    ReadBytes(i, &ref, 1);" << endl;
+    o << "    if (ref == '\\x1') {" << endl;
+    o << "      ++Verified(i, static_cast<const T *>(nullptr));" << endl;
+    o << "      Verify(i, static_cast<const T *>(nullptr));" << endl;
+    o << "    } else if (ref == '\\x2') {" << endl;
+    o << "      unsigned int index = 0;" << endl;
+    o << "      Read(i, index);" << endl;
+    o << "      if (index == 0 || index > Verified(i, static_cast<const T *>(nullptr)))" << endl;
+    o << "        Fail(i);" << endl;
+    o << "    } else if (ref != '\\0') {" << endl;
+    o << "      Fail(i);" << endl;
+    o << "    }" << endl;
+    o << "  }" << endl << endl;
+    o << "  template<typename T> void Verify(InputBuffer &i, const std::weak_ptr<T> *) {" << endl;
+    o << "    Verify(i, static_cast<const std::shared_ptr<T> *>(nullptr));" << endl;
+    o << "  }" << endl << endl;
+    o << "  template<typename T> void Verify(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {" << endl;
+    o << "    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));" << endl;
+    o << "  }" << endl << endl;
+    o << "  template<typename T> void Verify(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {" << endl;
+    o << "    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  for (const auto &t : p.types)
+  {
+    string name;
+    if (t.is_Table() && !isComplex(t.as_Table()))
+    {
+      o << "  void Verify(InputBuffer &i, " << tagOf(t.as_Table().name) << ") {" << endl;
+      o << "    if (Available(i, 1, sizeof(" << t.as_Table().name << ")))" << endl;
+      o << "      i.pos += sizeof(" << t.as_Table().name << ");" << endl;
+      o << "  }" << endl << endl;
+      continue;
+    }
+    if (t.is_Table())
+    {
+      const auto &table = t.as_Table();
+      name = table.name;
+      o << "  void Verify(InputBuffer &" << (table.member.empty() ? "" : "i") << ", " << tagOf(name) << ") {"
+        << endl;
+      for (const auto &m : table.member)
+      {
+        ostringstream type;
+        WriteType(type, m, OutputOptions());
+        o << "    Verify(i, " << nullOf(type.str()) << ");" << endl;
+      }
+      o << "  }" << endl << endl;
+    }
+    else if (t.is_Union())
+    {
+      const auto &u = t.as_Union();
+      name = u.name;
+      o << "  void Verify(InputBuffer &i, " << tagOf(name) << ") {" << endl;
+      o << "    switch (ReadSelection(i, " << nullOf(name) << ")) {" << endl;
+      for (size_t k = 0; k < u.tables.size(); ++k)
+        o << "    case " << k + 1 << ": Verify(i, " << nullOf(u.tables[k].value) << "); break;" << endl;
+      o << "    case 0: break;" << endl;
+      o << "    default: Fail(i); break;" << endl;
+      o << "    }" << endl;
+      o << "  }" << endl << endl;
+    }
+    else
+      continue;
+
+    o << "  void Verify(InputBuffer &i, " << tagOf("std::vector<" + name + ">") << ") {" << endl;
+    o << "    VerifyEach(i, " << nullOf(name) << ");" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  const auto indexed = indexedRootVectors(p, options);
+  if (indexed.empty())
+    return;
+
+  const auto count = 2 * indexed.size() + 1;
+  o << "  void VerifyIndexed(InputBuffer &i) {" << endl;
+  o << "    const std::uint64_t start = i.pos;" << endl;
+  o << "    const std::uint64_t trailer = " << count << " * sizeof(std::uint64_t);" << endl;
+  o << "    if (i.size - i.pos < trailer) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    std::uint64_t directory[" << count << "];" << endl;
+  o << "    InputBuffer index{i.data, i.size, i.size - static_cast<std::size_t>(trailer), false" << referencesInit(p) << "};"
+    << endl;
+  o << "    ReadValues(index, directory, " << count << ");" << endl;
+  o << "    const auto length = i.size - start;" << endl;
+  o << "    if (directory[" << count - 1 << "] != length) {" << endl;
+  o << "      i.pos = i.size - sizeof(std::uint64_t);" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  for (const auto &m : root->member)
+  {
+    const auto k = find(indexed.begin(), indexed.end(), &m) - indexed.begin();
+    ostringstream type;
+    if (k == static_cast<ptrdiff_t>(indexed.size()))
+    {
+      WriteType(type, m, OutputOptions());
+      o << "    Verify(i, " << nullOf(type.str()) << ");" << endl;
+      continue;
+    }
+    WriteElementType(type, m, OutputOptions());
+    o << "    {" << endl;
+    o << "      std::size_t s{0};" << endl;
+    o << "      Read(i, s);" << endl;
+    o << "      const auto entries = directory[" << 2 * k + 1 << "];" << endl;
+    o << "      if (s != directory[" << 2 * k << "] || entries > length || s > (length - entries) / sizeof(std::uint64_t))"
+      << endl;
+    o << "        Fail(i);" << endl;
+    o << "      index.pos = static_cast<std::size_t>(start + entries);" << endl;
+    o << "      for (std::size_t n = 0; n < s && !i.failed; ++n) {" << endl;
+    o << "        std::uint64_t offset = 0;" << endl;
+    o << "        ReadValues(index, &offset, 1);" << endl;
+    o << "        if (offset != i.pos - start)" << endl;
+    o << "          Fail(i);" << endl;
+    o << "        Verify(i, " << nullOf(type.str()) << ");" << endl;
+    o << "      }" << endl;
+    o << "    }" << endl;
+  }
+  o << "    auto entries = i.pos - start;" << endl;
+  o << "    for (std::size_t k = 0; k < " << indexed.size() << " && !i.failed; ++k) {" << endl;
+  o << "      if (directory[2 * k + 1] != entries)" << endl;
+  o << "        Fail(i);" << endl;
+  o << "      entries += directory[2 * k] * sizeof(std::uint64_t);" << endl;
+  o << "    }" << endl;
+  o << "    if (!i.failed && entries + trailer != length)" << endl;
+  o << "      Fail(i);" << endl;
+  o << "    if (!i.failed)" << endl;
+  o << "      i.pos = i.size;" << endl;
+  o << "  }" << endl << endl;
+}
+
+string deltaMarker(const Package &p, const OutputOptions &options)
+{
+  return string("DLT") + fileMarker(options)[3] + p.version.value;
+}
+
+void WriteDeltaFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = trackedRoot(p, options);
+  if (!root)
+    return;
+
+  const auto marker = deltaMarker(p, options);
+  o << "  template<typename O> void WriteDelta(O &o, " << root->name << " &v) const {" << endl;
+  o << "    WriteBytes(o, \"" << marker << "\", " << marker.size() << ");" << endl;
+  string references;
+  size_t index = 0;
+  for (const auto &m : root->member)
+  {
+    if (holdsReferences(p, m))
+      references += (references.empty() ? "" : " || ") + string("v.changes_[") + to_string(index) + "]";
+    ++index;
+  }
+  if (!references.empty())
+    o << "    const bool references = " << references << ";" << endl;
+  index = 0;
+  for (const auto &m : root->member)
+  {
+    o << "    if (" << (holdsReferences(p, m) ? string("references") : "v.changes_[" + to_string(index) + "]")
+      << ") {" << endl;
+    o << "      Write(o, std::uint32_t(" << ++index << "));" << endl;
+    if (!isRangeVector(p, m))
+      o << "      Write(o, v." << m.name << ");" << endl;
+    else
+    {
+      o << "      const auto runs = v." << m.name << "_changed_.runs(v." << m.name << ".size());" << endl;
+      o << "      Write(o, v." << m.name << ".size());" << endl;
+      o << "      Write(o, runs.size());" << endl;
+      o << "      for (const auto &r : runs) {" << endl;
+      o << "        Write(o, r.first);" << endl;
+      o << "        Write(o, r.second - r.first);" << endl;
+      if (isValueRange(p, m))
+        o << "        WriteValues(o, v." << m.name << ".data() + r.first, r.second - r.first);" << endl;
+      else
+      {
+        o << "        for (auto n = r.first; n < r.second; ++n)" << endl;
+        o << "          Write(o, v." << m.name << "[n]);" << endl;
+      }
+      o << "      }" << endl;
+    }
+    o << "    }" << endl;
+  }
+  o << "    Write(o, std::uint32_t(0));" << endl;
+  o << "    v.clear_changes();" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I, typename V> bool ReadRun(I &i, V &v, std::size_t size, std::size_t &first, "
+       "std::size_t &count, std::size_t element) {"
+    << endl;
+  o << "    Read(i, first);" << endl;
+  o << "    Read(i, count);" << endl;
+  o << "    if (Failed(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    if (first > v.size() || first > size || count > size - first) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    if (!Available(i, count, element))" << endl;
+  o << "      return false;" << endl;
+  o << "    if (first + count > v.size())" << endl;
+  o << "      v.resize(first + count);" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I, typename V> void EndRuns(I &i, V &v, std::size_t size) {" << endl;
+  o << "    if (Failed(i))" << endl;
+  o << "      return;" << endl;
+  o << "    if (size > v.size())" << endl;
+  o << "      Fail(i);" << endl;
+  o << "    else" << endl;
+  o << "      v.resize(size);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename I> bool ApplyDelta(I &i, " << root->name << " &v) {" << endl;
+  o << "    char marker[" << marker.size() << "];" << endl;
+  o << "    error_offset_ = 0;" << endl;
+  o << "    ReadBytes(i, marker, " << marker.size() << ");" << endl;
+  o << "    if (std::memcmp(marker, \"" << marker << "\", " << marker.size() << ") != 0) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    for (;;) {" << endl;
+  o << "      std::uint32_t member = 0;" << endl;
+  o << "      Read(i, member);" << endl;
+  o << "      if (Failed(i))" << endl;
+  o << "        return false;" << endl;
+  o << "      switch (member) {" << endl;
+  o << "      case 0:" << endl;
+  o << "        return true;" << endl;
+  index = 0;
+  for (const auto &m : root->member)
+  {
+    o << "      case " << ++index << ": {" << endl;
+    if (!isRangeVector(p, m))
+      o << "        Read(i, v." << m.name << ");" << endl;
+    else
+    {
+      o << "        std::size_t size = 0, runs = 0;" << endl;
+      o << "        Read(i, size);" << endl;
+      o << "        Read(i, runs);" << endl;
+      o << "        for (std::size_t r = 0; r < runs && !Failed(i); ++r) {" << endl;
+      o << "          std::size_t first = 0, count = 0;" << endl;
+      if (isValueRange(p, m))
+      {
+        o << "          if (ReadRun(i, v." << m.name << ", size, first, count, sizeof(";
+        WriteElementType(o, m, options) << ")))" << endl;
+        o << "            ReadValues(i, v." << m.name << ".data() + first, count);" << endl;
+      }
+      else
+      {
+        o << "          if (ReadRun(i, v." << m.name << ", size, first, count, 1))" << endl;
+        o << "            for (auto n = first; n < first + count; ++n)" << endl;
+        o << "              Read(i, v." << m.name << "[n]);" << endl;
+      }
+      o << "        }" << endl;
+      o << "        EndRuns(i, v." << m.name << ", size);" << endl;
+    }
+    o << "        break;" << endl;
+    o << "      }" << endl;
+  }
+  o << "      default:" << endl;
+  o << "        Fail(i);" << endl;
+  o << "        return false;" << endl;
+  o << "      }" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+}
+
+bool isDiffVector(const Package &p, const Member &m)
+{
+  vector<string> seen;
+  return isRangeVector(p, m) && m.pointer == Pointer::Plain && isCopyable(p, m.type, seen);
+}
+
+template <class T>
+bool isHashable(const Package &p, const T &t)
+{
+  vector<string> seen;
+  return !reachesSharedPointer(p, t.name, seen);
+}
+
+void WriteHashBytes(ostream &o)
+{
+  o << "  static std::uint64_t HashBytes(std::uint64_t h, const char *data, std::size_t size) {" << endl;
+  o << "    for (std::size_t n = 0; n < size; ++n)" << endl;
+  o << "      h = (h ^ static_cast<unsigned char>(data[n])) * 0x100000001b3u;" << endl;
+  o << "    return h;" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteHashFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  o << "  template<typename T> std::uint64_t Hash(std::uint64_t h, const T &v) const {" << endl;
+  o << "    return HashBytes(h, reinterpret_cast<const char *>(&v), sizeof(T));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename T> std::uint64_t Hash(std::uint64_t h, const " << vectorTemplate(options)
+    << "<T> &v) const {" << endl;
+  o << "    h = Hash(h, v.size());" << endl;
+  o << "    for (const auto &entry : v)" << endl;
+  o << "      h = Hash(h, entry);" << endl;
+  o << "    return h;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename T> std::uint64_t Hash(std::uint64_t h, const std::unique_ptr<T> &v) const {" << endl;
+  o << "    return v ? Hash(Hash(h, '\\x1'), *v) : Hash(h, '\\x0');" << endl;
+  o << "  }" << endl << endl;
+
+  if (hasPlainString(p) || hasVectorOfString(p))
+  {
+    o << "  std::uint64_t Hash(std::uint64_t h, const " << stringType(options) << " &v) const {" << endl;
+    o << "    return HashBytes(Hash(h, v.size()), v.data(), v.size());" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  for (const auto &t : p.types)
+  {
+    if (t.is_Table() && isHashable(p, t.as_Table()))
+    {
+      o << "  std::uint64_t Hash(std::uint64_t h, const " << t.as_Table().name << " &v) const {" << endl;
+      for (const auto &m : t.as_Table().member)
+        o << "    h = Hash(h, v." << m.name << ");" << endl;
+      o << "    return h;" << endl;
+      o << "  }" << endl << endl;
+    }
+    else if (t.is_Union() && isHashable(p, t.as_Union()))
+    {
+      const auto &u = t.as_Union();
+      o << "  std::uint64_t Hash(std::uint64_t h, const " << u.name << " &v) const {" << endl;
+      int selection = 0;
+      for (const auto &a : u.tables)
+      {
+        o << "    if (v.is_" << a.value << "())" << endl;
+        o << "      return Hash(Hash(h, " << ++selection << "), v.as_" << a.value << "());" << endl;
+      }
+      o << "    return Hash(h, 0);" << endl;
+      o << "  }" << endl << endl;
+    }
+  }
+}
+
+void WriteDiffFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  WriteHashFunctions(o, p, options);
+
+  o << "  template<typename O, typename V> void WriteLiteral(O &o, const V &v, std::size_t first, "
+       "std::size_t last) const {"
+    << endl;
+  o << "    if (first == last)" << endl;
+  o << "      return;" << endl;
+  o << "    Write(o, last - first);" << endl;
+  o << "    Write(o, std::size_t(0));" << endl;
+  o << "    for (auto n = first; n < last; ++n)" << endl;
+  o << "      Write(o, v[n]);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename V> void IndexElements(const V &a, std::vector<std::uint64_t> &hashes, "
+       "std::vector<std::size_t> &slots) const {"
+    << endl;
+  o << "    std::size_t capacity = 16;" << endl;
+  o << "    while (capacity < 2 * a.size())" << endl;
+  o << "      capacity *= 2;" << endl;
+  o << "    hashes.resize(a.size());" << endl;
+  o << "    slots.assign(capacity, 0);" << endl;
+  o << "    for (std::size_t k = 0; k < a.size(); ++k) {" << endl;
+  o << "      hashes[k] = Hash(0xcbf29ce484222325u, a[k]);" << endl;
+  o << "      auto s = hashes[k] & (capacity - 1);" << endl;
+  o << "      while (slots[s] != 0 && hashes[slots[s] - 1] != hashes[k])" << endl;
+  o << "        s = (s + 1) & (capacity - 1);" << endl;
+  o << "      if (slots[s] == 0)" << endl;
+  o << "        slots[s] = k + 1;" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename V> std::size_t FindElement(const V &a, const typename V::value_type &e, "
+       "const std::vector<std::uint64_t> &hashes, const std::vector<std::size_t> &slots) const {"
+    << endl;
+  o << "    const auto h = Hash(0xcbf29ce484222325u, e);" << endl;
+  o << "    for (auto s = h & (slots.size() - 1); slots[s] != 0; s = (s + 1) & (slots.size() - 1))" << endl;
+  o << "      if (hashes[slots[s] - 1] == h)" << endl;
+  o << "        return a[slots[s] - 1] == e ? slots[s] - 1 : a.size();" << endl;
+  o << "    return a.size();" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename O, typename V> void WriteVectorDiff(O &o, const V &a, const V &b) const {" << endl;
+  o << "    std::vector<std::uint64_t> hashes;" << endl;
+  o << "    std::vector<std::size_t> slots;" << endl;
+  o << "    Write(o, b.size());" << endl;
+  o << "    std::size_t literal = 0, next = 0;" << endl;
+  o << "    for (std::size_t n = 0; n < b.size();) {" << endl;
+  o << "      auto from = a.size();" << endl;
+  o << "      const auto replaced = next + (n - literal);" << endl;
+  o << "      if (replaced < a.size() && a[replaced] == b[n]) {" << endl;
+  o << "        from = replaced;" << endl;
+  o << "      } else if (next < a.size() && a[next] == b[n]) {" << endl;
+  o << "        from = next;" << endl;
+  o << "      } else {" << endl;
+  o << "        if (slots.empty())" << endl;
+  o << "          IndexElements(a, hashes, slots);" << endl;
+  o << "        from = FindElement(a, b[n], hashes, slots);" << endl;
+  o << "      }" << endl;
+  o << "      if (from == a.size()) {" << endl;
+  o << "        ++n;" << endl;
+  o << "        continue;" << endl;
+  o << "      }" << endl;
+  o << "      std::size_t count = 1;" << endl;
+  o << "      while (n + count < b.size() && from + count < a.size() && a[from + count] == b[n + count])" << endl;
+  o << "        ++count;" << endl;
+  o << "      WriteLiteral(o, b, literal, n);" << endl;
+  o << "      Write(o, count);" << endl;
+  o << "      Write(o, from + 1);" << endl;
+  o << "      n += count;" << endl;
+  o << "      literal = n;" << endl;
+  o << "      next = from + count;" << endl;
+  o << "    }" << endl;
+  o << "    WriteLiteral(o, b, literal, b.size());" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename V> bool ReadCopy(InputBuffer &i, V &v, const V &a, std::size_t size, std::size_t count, "
+       "std::size_t from) {"
+    << endl;
+  o << "    if (count == 0 || count > size - v.size() || from - 1 >= a.size() || count > a.size() - (from - 1)) {"
+    << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    v.insert(v.end(), a.begin() + (from - 1), a.begin() + (from - 1 + count));" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  template<typename V> bool ReadLiteral(InputBuffer &i, V &v, std::size_t size, std::size_t count) {" << endl;
+  o << "    if (count == 0 || count > size - v.size()) {" << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    if (!Available(i, count, 1))" << endl;
+  o << "      return false;" << endl;
+  o << "    v.resize(v.size() + count);" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  struct OutputHash {" << endl;
+  o << "    std::uint64_t hash;" << endl;
+  WriteReferencesMember(o, p, "WriteReferences");
+  o << "  };" << endl << endl;
+
+  o << "  void WriteBytes(OutputHash &o, const char *d, std::size_t s) const {" << endl;
+  o << "    o.hash = HashBytes(o.hash, d, s);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // a patch only applies to the value it was made from, it carries the hash of its written bytes" << endl;
+  o << "  std::uint64_t HashDiffBase(const " << root->name << " &v) const {" << endl;
+  o << "    OutputHash h{0xcbf29ce484222325u" << referencesInit(p) << "};" << endl;
+  o << "    Write(h, v);" << endl;
+  o << "    return h.hash;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static bool Differs(const std::vector<char> &a, const OutputBuffer &oa, const std::vector<char> &b, "
+       "const OutputBuffer &ob) {"
+    << endl;
+  o << "    return oa.size != ob.size || (oa.size != 0 && std::memcmp(a.data(), b.data(), oa.size) != 0);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // pointers compare by the values they point to, so the written bytes are compared" << endl;
+  o << "  template<typename T> bool WrittenDiffers(const T &a, const T &b) const {" << endl;
+  o << "    std::vector<char> wa, wb;" << endl;
+  const auto refs = referencesInit(p);
+  o << "    OutputBuffer oa{wa, 0" << refs << "}, ob{wb, 0" << refs << "};" << endl;
+  o << "    Write(oa, a);" << endl;
+  o << "    Write(ob, b);" << endl;
+  o << "    return Differs(wa, oa, wb, ob);" << endl;
+  o << "  }" << endl << endl;
+
+  const auto marker = string("DIF") + fileMarker(options)[3] + p.version.value;
+  o << "  template<typename O> void WriteDiff(O &o, const " << root->name << " &a, const " << root->name
+    << " &b) const {" << endl;
+  o << "    WriteBytes(o, \"" << marker << "\", " << marker.size() << ");" << endl;
+  o << "    Write(o, HashDiffBase(a));" << endl;
+  vector<const Member *> references;
+  for (const auto &m : root->member)
+    if (holdsReferences(p, m))
+      references.push_back(&m);
+  if (!references.empty())
+  {
+    o << "    // members with shared or weak pointers are written together, they share the ids of their objects" << endl;
+    o << "    std::vector<char> ra, rb;" << endl;
+    o << "    OutputBuffer oa{ra, 0" << refs << "}, ob{rb, 0" << refs << "};" << endl;
+    for (const auto *side : {"a", "b"})
+      for (const auto *m : references)
+        o << "    Write(o" << side << ", " << side << "." << m->name << ");" << endl;
+    o << "    const bool references = Differs(ra, oa, rb, ob);" << endl;
+  }
+  size_t index = 0;
+  for (const auto &m : root->member)
+  {
+    ++index;
+    vector<string> seen;
+    if (holdsReferences(p, m))
+      o << "    if (references) {" << endl;
+    else if (m.pointer != Pointer::Plain || !isCopyable(p, m.type, seen))
+      o << "    if (WrittenDiffers(a." << m.name << ", b." << m.name << ")) {" << endl;
+    else
+      o << "    if (a." << m.name << " != b." << m.name << ") {" << endl;
+    o << "      Write(o, std::uint32_t(" << index << "));" << endl;
+    if (isDiffVector(p, m))
+      o << "      WriteVectorDiff(o, a." << m.name << ", b." << m.name << ");" << endl;
+    else
+      o << "      Write(o, b." << m.name << ");" << endl;
+    o << "    }" << endl;
+  }
+  o << "    Write(o, std::uint32_t(0));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool ApplyDiff(InputBuffer &i, " << root->name << " &v) {" << endl;
+  o << "    char marker[" << marker.size() << "];" << endl;
+  o << "    std::uint64_t base = 0;" << endl;
+  o << "    error_offset_ = 0;" << endl;
+  o << "    ReadBytes(i, marker, " << marker.size() << ");" << endl;
+  o << "    Read(i, base);" << endl;
+  o << "    if (std::memcmp(marker, \"" << marker << "\", " << marker.size() << ") != 0 || base != HashDiffBase(v)) {"
+    << endl;
+  o << "      Fail(i);" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    for (;;) {" << endl;
+  o << "      std::uint32_t member = 0;" << endl;
+  o << "      Read(i, member);" << endl;
+  o << "      if (Failed(i))" << endl;
+  o << "        return false;" << endl;
+  o << "      switch (member) {" << endl;
+  o << "      case 0:" << endl;
+  o << "        return true;" << endl;
+  index = 0;
+  for (const auto &m : root->member)
+  {
+    o << "      case " << ++index << ": {" << endl;
+    if (!isDiffVector(p, m))
+      o << "        Read(i, v." << m.name << ");" << endl;
+    else
+    {
+      o << "        std::size_t size = 0;" << endl;
+      o << "        Read(i, size);" << endl;
+      o << "        decltype(v." << m.name << ") b(v." << m.name << ".get_allocator());" << endl;
+      o << "        while (b.size() < size && !Failed(i)) {" << endl;
+      o << "          std::size_t count = 0, from = 0;" << endl;
+      o << "          Read(i, count);" << endl;
+      o << "          Read(i, from);" << endl;
+      o << "          if (Failed(i))" << endl;
+      o << "            break;" << endl;
+      o << "          if (from != 0) {" << endl;
+      o << "            ReadCopy(i, b, v." << m.name << ", size, count, from);" << endl;
+      o << "            continue;" << endl;
+      o << "          }" << endl;
+      o << "          if (ReadLiteral(i, b, size, count))" << endl;
+      o << "            for (auto n = b.size() - count; n < b.size(); ++n)" << endl;
+      o << "              Read(i, b[n]);" << endl;
+      o << "        }" << endl;
+      o << "        if (!Failed(i))" << endl;
+      o << "          v." << m.name << ".swap(b);" << endl;
+    }
+    o << "        break;" << endl;
+    o << "      }" << endl;
+  }
+  o << "      default:" << endl;
+  o << "        Fail(i);" << endl;
+  o << "        return false;" << endl;
+  o << "      }" << endl;
+  o << "    }" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteDiffIO(ostream &o, const Package &p)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  o << "  std::vector<char> Diff" << root->name << "(const " << root->name << " &a, const " << root->name
+    << " &b) const {" << endl;
+  o << "    std::vector<char> patch;" << endl;
+  o << "    OutputBuffer o{patch, 0" << referencesInit(p) << "};" << endl;
+  o << "    WriteDiff(o, a, b);" << endl;
+  o << "    patch.resize(o.size);" << endl;
+  o << "    return patch;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Patch" << root->name << "(" << root->name << " &v, const char *data, std::size_t size) {" << endl;
+  o << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (!ApplyDiff(i, v))" << endl;
+  o << "      return false;" << endl;
+  o << "    if (i.pos != i.size)" << endl;
+  o << "      Fail(i);" << endl;
+  o << "    return !i.failed;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Patch" << root->name << "(" << root->name << " &v, const std::vector<char> &patch) {" << endl;
+  o << "    return Patch" << root->name << "(v, patch.data(), patch.size());" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteDeltaIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = trackedRoot(p, options);
+  if (!root)
+    return;
+
+  o << "  void Write" << root->name << "Delta(std::ostream &o, " << root->name << " &v) const {" << endl;
+  o << "    OutputStream s{o, 0" << referencesInit(p) << "};" << endl;
+  o << "    WriteDelta(s, v);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void Write" << root->name << "Delta(std::vector<char> &b, " << root->name << " &v) const {" << endl;
+  o << "    OutputBuffer o{b, b.size()" << referencesInit(p) << "};" << endl;
+  o << "    WriteDelta(o, v);" << endl;
+  o << "    b.resize(o.size);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Apply" << root->name << "Delta(std::istream &stream, " << root->name << " &v) {" << endl;
+  o << "    auto i = MakeInput(stream);" << endl;
+  o << "    return ApplyDelta(i, v);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool Apply" << root->name << "Delta(const char *data, std::size_t size, " << root->name << " &v) {" << endl;
+  o << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    return ApplyDelta(i, v);" << endl;
+  o << "  }" << endl << endl;
+}
+
+string journalMarker(const Package &p, const OutputOptions &options)
+{
+  return string("JRN") + fileMarker(options)[3] + p.version.value;
+}
+
+void WriteJournalFunctions(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  const auto marker = journalMarker(p, options);
+  o << "  enum JournalOperation : std::uint32_t { JournalSet, JournalAssign, JournalPush, JournalInsert, JournalErase };"
+    << endl
+    << endl;
+
+  o << "  // every journal record starts with the little endian size and hash of its payload" << endl;
+  o << "  static constexpr std::size_t JournalFrameSize() {" << endl;
+  o << "    return 12;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static std::uint64_t JournalWord(const char *d, std::size_t bytes) {" << endl;
+  o << "    std::uint64_t v = 0;" << endl;
+  o << "    while (bytes-- != 0)" << endl;
+  o << "      v = (v << 8) | static_cast<unsigned char>(d[bytes]);" << endl;
+  o << "    return v;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void WriteJournalFrame(std::vector<char> &b, std::size_t start) const {" << endl;
+  o << "    const std::uint64_t size = b.size() - start - JournalFrameSize();" << endl;
+  o << "    const auto hash = HashBytes(0xcbf29ce484222325u, b.data() + start + JournalFrameSize(), size);" << endl;
+  o << "    for (std::size_t n = 0; n < 4; ++n)" << endl;
+  o << "      b[start + n] = static_cast<char>(size >> (8 * n));" << endl;
+  o << "    for (std::size_t n = 0; n < 8; ++n)" << endl;
+  o << "      b[start + 4 + n] = static_cast<char>(hash >> (8 * n));" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // end of the last complete record, 0 without a journal header or with a damaged record before the end" << endl;
+  o << "  std::size_t JournalEnd(const char *data, std::size_t size) {" << endl;
+  o << "    if (size < " << marker.size() << " || std::memcmp(data, \"" << marker << "\", " << marker.size()
+    << ") != 0)" << endl;
+  o << "      return 0;" << endl;
+  o << "    std::size_t pos = " << marker.size() << ";" << endl;
+  o << "    while (size - pos >= JournalFrameSize()) {" << endl;
+  o << "      const auto length = JournalWord(data + pos, 4);" << endl;
+  o << "      if (length > size - pos - JournalFrameSize())" << endl;
+  o << "        break;" << endl;
+  o << "      if (HashBytes(0xcbf29ce484222325u, data + pos + JournalFrameSize(), length) != JournalWord(data + pos + 4, 8)) {"
+    << endl;
+  o << "        if (pos + JournalFrameSize() + length == size)" << endl;
+  o << "          return pos;" << endl;
+  o << "        error_offset_ = pos;" << endl;
+  o << "        return 0;" << endl;
+  o << "      }" << endl;
+  o << "      pos += JournalFrameSize() + length;" << endl;
+  o << "    }" << endl;
+  o << "    return pos;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // a checkpoint holds the hash of a snapshot and how many bytes before it the state of the snapshot was reached"
+    << endl;
+  o << "  bool JournalCheckpoint(const char *data, std::size_t size, std::uint64_t &snapshot, std::uint64_t &back) {"
+    << endl;
+  o << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    std::uint32_t member = 1, operation = 0;" << endl;
+  o << "    Read(i, member);" << endl;
+  o << "    Read(i, operation);" << endl;
+  o << "    Read(i, snapshot);" << endl;
+  o << "    Read(i, back);" << endl;
+  o << "    return member == 0 && !Failed(i);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static bool JournalRange(std::uint32_t operation, std::size_t first, std::size_t last, std::size_t size) {"
+    << endl;
+  o << "    switch (operation) {" << endl;
+  o << "    case JournalSet:" << endl;
+  o << "    case JournalPush:" << endl;
+  o << "      return true;" << endl;
+  o << "    case JournalAssign:" << endl;
+  o << "      return first < size;" << endl;
+  o << "    case JournalInsert:" << endl;
+  o << "      return first <= size;" << endl;
+  o << "    case JournalErase:" << endl;
+  o << "      return first <= last && last <= size;" << endl;
+  o << "    }" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool ApplyJournalRecord(InputBuffer &i, " << root->name << " &v) {" << endl;
+  o << "    std::uint32_t member = 0, operation = 0;" << endl;
+  o << "    Read(i, member);" << endl;
+  o << "    Read(i, operation);" << endl;
+  o << "    if (Failed(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    if (member == 0) {" << endl;
+  o << "      std::uint64_t snapshot = 0, back = 0;" << endl;
+  o << "      Read(i, snapshot);" << endl;
+  o << "      Read(i, back);" << endl;
+  o << "      return !Failed(i);" << endl;
+  o << "    }" << endl;
+  o << "    std::size_t first = 0, last = 0;" << endl;
+  o << "    if (operation == JournalAssign || operation == JournalInsert || operation == JournalErase)" << endl;
+  o << "      Read(i, first);" << endl;
+  o << "    if (operation == JournalErase)" << endl;
+  o << "      Read(i, last);" << endl;
+  o << "    if (Failed(i))" << endl;
+  o << "      return false;" << endl;
+  o << "    switch (member) {" << endl;
+  size_t index = 0;
+  for (const auto &m : root->member)
+  {
+    ++index;
+    if (holdsReferences(p, m))
+      continue;
+    o << "    case " << index << ":" << endl;
+    if (!m.isVector)
+    {
+      o << "      if (operation != JournalSet)" << endl;
+      o << "        break;" << endl;
+      o << "      Read(i, v." << m.name << ");" << endl;
+      if (options.trackChanges)
+        o << "      v.mark_" << m.name << "();" << endl;
+      o << "      return !Failed(i);" << endl;
+      continue;
+    }
+    const auto v = "v." + m.name;
+    o << "      if (!JournalRange(operation, first, last, " << v << ".size()))" << endl;
+    o << "        break;" << endl;
+    o << "      switch (operation) {" << endl;
+    o << "      case JournalSet:" << endl;
+    o << "        Read(i, " << v << ");" << endl;
+    o << "        break;" << endl;
+    o << "      case JournalAssign:" << endl;
+    o << "        Read(i, " << v << "[first]);" << endl;
+    o << "        break;" << endl;
+    o << "      case JournalPush:" << endl;
+    o << "        first = " << v << ".size();" << endl;
+    o << "        " << v << ".emplace_back();" << endl;
+    o << "        Read(i, " << v << ".back());" << endl;
+    o << "        break;" << endl;
+    o << "      case JournalInsert:" << endl;
+    o << "        " << v << ".emplace(" << v << ".begin() + first);" << endl;
+    o << "        Read(i, " << v << "[first]);" << endl;
+    o << "        break;" << endl;
+    o << "      default:" << endl;
+    o << "        " << v << ".erase(" << v << ".begin() + first, " << v << ".begin() + last);" << endl;
+    o << "      }" << endl;
+    if (options.trackChanges)
+    {
+      o << "      if (operation == JournalSet)" << endl;
+      o << "        " << "v.mark_" << m.name << "();" << endl;
+      o << "      else" << endl;
+      o << "        " << "v.mark_" << m.name << "(first, operation == JournalAssign ? first + 1 : " << v << ".size());"
+        << endl;
+    }
+    o << "      return !Failed(i);" << endl;
+  }
+  o << "    }" << endl;
+  o << "    Fail(i);" << endl;
+  o << "    return false;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // replays the records from the point the last checkpoint of the snapshot refers to, a journal that does not start"
+    << endl;
+  o << "  // with a checkpoint was opened on the snapshot and is replayed from its start" << endl;
+  o << "  bool ReplayJournal(const char *data, std::size_t size, std::uint64_t snapshot, " << root->name << " &v) {"
+    << endl;
+  o << "    error_offset_ = 0;" << endl;
+  o << "    const auto end = JournalEnd(data, size);" << endl;
+  o << "    if (end == 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    std::size_t start = " << marker.size() << ";" << endl;
+  o << "    bool found = false, leading = false;" << endl;
+  o << "    std::vector<std::size_t> frames;" << endl;
+  o << "    for (auto pos = start; pos < end; pos += JournalFrameSize() + JournalWord(data + pos, 4)) {" << endl;
+  o << "      frames.push_back(pos);" << endl;
+  o << "      std::uint64_t hash = 0, back = 0;" << endl;
+  o << "      if (!JournalCheckpoint(data + pos + JournalFrameSize(), JournalWord(data + pos, 4), hash, back))" << endl;
+  o << "        continue;" << endl;
+  o << "      leading = leading || pos == " << marker.size() << ";" << endl;
+  o << "      if (hash == snapshot && back <= pos && std::binary_search(frames.begin(), frames.end(), pos - back)) {"
+    << endl;
+  o << "        found = true;" << endl;
+  o << "        start = static_cast<std::size_t>(pos - back);" << endl;
+  o << "      }" << endl;
+  o << "    }" << endl;
+  o << "    if (leading && !found)" << endl;
+  o << "      return false;" << endl;
+  o << "    for (auto pos = start; pos < end;) {" << endl;
+  o << "      const auto length = JournalWord(data + pos, 4);" << endl;
+  o << "      InputBuffer i{data + pos + JournalFrameSize(), length, 0, false" << referencesInit(p) << "};" << endl;
+  o << "      if (!ApplyJournalRecord(i, v) || i.pos != i.size) {" << endl;
+  o << "        error_offset_ = pos;" << endl;
+  o << "        return false;" << endl;
+  o << "      }" << endl;
+  o << "      pos += JournalFrameSize() + length;" << endl;
+  o << "    }" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static bool ReadFileData(const std::string &path, std::vector<char> &d) {" << endl;
+  o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "    const int fd = ::open(path.c_str(), O_RDONLY);" << endl;
+  o << "    if (fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    struct stat st;" << endl;
+  o << "    auto ok = ::fstat(fd, &st) == 0;" << endl;
+  o << "    d.resize(ok ? static_cast<std::size_t>(st.st_size) : 0);" << endl;
+  o << "    for (std::size_t done = 0; ok && done < d.size();) {" << endl;
+  o << "      const auto n = ::read(fd, d.data() + done, d.size() - done);" << endl;
+  o << "      if (n < 0 && errno == EINTR)" << endl;
+  o << "        continue;" << endl;
+  o << "      ok = n > 0;" << endl;
+  o << "      done += ok ? static_cast<std::size_t>(n) : 0;" << endl;
+  o << "    }" << endl;
+  o << "    ::close(fd);" << endl;
+  o << "    return ok;" << endl;
+  o << "#else" << endl;
+  o << "    std::ifstream f(path, std::ios::binary);" << endl;
+  o << "    if (!f)" << endl;
+  o << "      return false;" << endl;
+  o << "    d.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());" << endl;
+  o << "    return !f.bad();" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteJournalIO(ostream &o, const Package &p)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  o << "  bool Replay" << root->name << "Journal(const std::string &snapshot, const std::string &journal, "
+    << root->name << " &v) {" << endl;
+  o << "    std::vector<char> state, records;" << endl;
+  o << "    if (!ReadFileData(snapshot, state) || !ReadFileData(journal, records) || !Read" << root->name
+    << "(state.data(), state.size(), v))" << endl;
+  o << "      return false;" << endl;
+  o << "    return ReplayJournal(records.data(), records.size(), HashBytes(0xcbf29ce484222325u, state.data(), "
+       "state.size()), v);"
+    << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteJournalOperation(ostream &o, const string &io, size_t index, const string &operation,
+                           const vector<string> &arguments, const string &range = string())
+{
+  o << "    std::lock_guard<std::mutex> lock(mutex_);" << endl;
+  if (!range.empty())
+  {
+    o << "    if (" << range << ")" << endl;
+    o << "      return false;" << endl;
+  }
+  o << "    auto o = record(" << index << ", " << io << "::" << operation << ");" << endl;
+  for (const auto &a : arguments)
+    o << "    io_.Write(o, " << a << ");" << endl;
+  o << "    seal(o);" << endl;
+}
+
+void WriteRootJournal(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  const auto &name = root->name;
+  const auto io = p.root_type.value + "_io";
+  const auto marker = journalMarker(p, options);
+
+  o << endl << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+  o << "struct " << name << "Journal {" << endl;
+  o << "  " << name << "Journal(const std::string &path, " << name << " &root) : path_(path), root_(root) {" << endl;
+  o << "    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);" << endl;
+  o << "    struct stat st;" << endl;
+  o << "    if (fd_ < 0 || ::fstat(fd_, &st) != 0) {" << endl;
+  o << "      failed_ = true;" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    // a crash while the marker was written leaves less than the marker and no records, that starts over" << endl;
+  o << "    if (st.st_size < " << marker.size() << ") {" << endl;
+  o << "      failed_ = (st.st_size != 0 && ::ftruncate(fd_, 0) != 0) || !WriteAll(fd_, \"" << marker << "\", "
+    << marker.size() << ") || !Sync(fd_);" << endl;
+  o << "      size_ = end_ = " << marker.size() << ";" << endl;
+  o << "      return;" << endl;
+  o << "    }" << endl;
+  o << "    std::vector<char> data(static_cast<std::size_t>(st.st_size));" << endl;
+  o << "    // a crash can leave an incomplete record behind, new records have to follow the last complete one" << endl;
+  o << "    const auto end = ReadAll(fd_, data.data(), data.size(), 0) ? io_.JournalEnd(data.data(), data.size()) : 0;"
+    << endl;
+  o << "    failed_ = end == 0 || (end < data.size() && ::ftruncate(fd_, static_cast<off_t>(end)) != 0);" << endl;
+  o << "    size_ = end_ = end;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  ~" << name << "Journal() {" << endl;
+  o << "    if (compactor_.joinable())" << endl;
+  o << "      compactor_.join();" << endl;
+  o << "    commit();" << endl;
+  o << "    if (fd_ >= 0)" << endl;
+  o << "      ::close(fd_);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  " << name << "Journal(const " << name << "Journal &) = delete;" << endl;
+  o << "  " << name << "Journal &operator=(const " << name << "Journal &) = delete;" << endl << endl;
+
+  size_t index = 0;
+  for (const auto &m : root->member)
+  {
+    ++index;
+    if (holdsReferences(p, m))
+      continue;
+    const auto v = "root_." + m.name;
+    const auto mark = options.trackChanges ? "    root_.mark_" + m.name : string();
+
+    o << "  void set_" << m.name << "(";
+    WriteType(o, m, options) << " v) {" << endl;
+    WriteJournalOperation(o, io, index, "JournalSet", {"v"});
+    o << "    " << v << " = std::move(v);" << endl;
+    if (!mark.empty())
+      o << mark << "();" << endl;
+    o << "  }" << endl << endl;
+
+    if (!m.isVector)
+      continue;
+
+    o << "  bool set_" << m.name << "(std::size_t index, ";
+    WriteElementType(o, m, options) << " v) {" << endl;
+    WriteJournalOperation(o, io, index, "JournalAssign", {"index", "v"}, "index >= " + v + ".size()");
+    o << "    " << v << "[index] = std::move(v);" << endl;
+    if (!mark.empty())
+      o << mark << "(index, index + 1);" << endl;
+    o << "    return true;" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  void push_" << m.name << "(";
+    WriteElementType(o, m, options) << " v) {" << endl;
+    WriteJournalOperation(o, io, index, "JournalPush", {"v"});
+    o << "    " << v << ".push_back(std::move(v));" << endl;
+    if (!mark.empty())
+      o << mark << "(" << v << ".size() - 1, " << v << ".size());" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  bool insert_" << m.name << "(std::size_t index, ";
+    WriteElementType(o, m, options) << " v) {" << endl;
+    WriteJournalOperation(o, io, index, "JournalInsert", {"index", "v"}, "index > " + v + ".size()");
+    o << "    " << v << ".insert(" << v << ".begin() + index, std::move(v));" << endl;
+    if (!mark.empty())
+      o << mark << "(index, " << v << ".size());" << endl;
+    o << "    return true;" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  bool erase_" << m.name << "(std::size_t first, std::size_t last) {" << endl;
+    WriteJournalOperation(o, io, index, "JournalErase", {"first", "last"},
+                          "first > last || last > " + v + ".size()");
+    o << "    " << v << ".erase(" << v << ".begin() + first, " << v << ".begin() + last);" << endl;
+    if (!mark.empty())
+      o << mark << "(first, " << v << ".size());" << endl;
+    o << "    return true;" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "  // returns once every operation recorded so far is on disk, concurrent commits share one sync" << endl;
+  o << "  bool commit() {" << endl;
+  o << "    std::unique_lock<std::mutex> lock(mutex_);" << endl;
+  o << "    const auto target = appended_;" << endl;
+  o << "    while (!failed_ && durable_ < target) {" << endl;
+  o << "      if (syncing_) {" << endl;
+  o << "        synced_.wait(lock);" << endl;
+  o << "        continue;" << endl;
+  o << "      }" << endl;
+  o << "      syncing_ = true;" << endl;
+  o << "      flushing_.swap(pending_);" << endl;
+  o << "      pending_.clear();" << endl;
+  o << "      const auto records = appended_;" << endl;
+  o << "      lock.unlock();" << endl;
+  o << "      const auto ok = WriteAll(fd_, flushing_.data(), flushing_.size()) && Sync(fd_);" << endl;
+  o << "      lock.lock();" << endl;
+  o << "      syncing_ = false;" << endl;
+  o << "      failed_ = failed_ || !ok;" << endl;
+  o << "      size_ += flushing_.size();" << endl;
+  o << "      durable_ = records;" << endl;
+  o << "      synced_.notify_all();" << endl;
+  o << "    }" << endl;
+  o << "    return !failed_;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // saves the current state as snapshot in the background, afterwards the journal only keeps later operations"
+    << endl;
+  o << "  std::future<bool> compact(const std::string &snapshot) {" << endl;
+  o << "    if (compactor_.joinable())" << endl;
+  o << "      compactor_.join();" << endl;
+  o << "    auto state = std::make_shared<std::vector<char>>();" << endl;
+  o << "    std::uint64_t point = 0;" << endl;
+  o << "    {" << endl;
+  o << "      std::lock_guard<std::mutex> lock(mutex_);" << endl;
+  o << "      io_.Write" << name << "(*state, root_);" << endl;
+  o << "      point = end_;" << endl;
+  o << "    }" << endl;
+  o << "    auto done = std::make_shared<std::promise<bool>>();" << endl;
+  o << "    compactor_ = std::thread([this, snapshot, state, point, done]() {" << endl;
+  o << "      done->set_value(save(snapshot, *state, point));" << endl;
+  o << "    });" << endl;
+  o << "    return done->get_future();" << endl;
+  o << "  }" << endl << endl;
+
+  o << "private:" << endl;
+  o << "  static bool WriteAll(int fd, const char *d, std::size_t s) {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      const auto n = ::write(fd, d, s);" << endl;
+  o << "      if (n < 0 && errno == EINTR)" << endl;
+  o << "        continue;" << endl;
+  o << "      if (n <= 0)" << endl;
+  o << "        return false;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= static_cast<std::size_t>(n);" << endl;
+  o << "    }" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static bool ReadAll(int fd, char *d, std::size_t s, std::uint64_t offset) {" << endl;
+  o << "    while (s != 0) {" << endl;
+  o << "      const auto n = ::pread(fd, d, s, static_cast<off_t>(offset));" << endl;
+  o << "      if (n < 0 && errno == EINTR)" << endl;
+  o << "        continue;" << endl;
+  o << "      if (n <= 0)" << endl;
+  o << "        return false;" << endl;
+  o << "      d += n;" << endl;
+  o << "      s -= static_cast<std::size_t>(n);" << endl;
+  o << "      offset += static_cast<std::uint64_t>(n);" << endl;
+  o << "    }" << endl;
+  o << "    return true;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  static bool Sync(int fd) {" << endl;
+  o << "#if defined(__APPLE__)" << endl;
+  o << "    return ::fsync(fd) == 0;" << endl;
+  o << "#else" << endl;
+  o << "    return ::fdatasync(fd) == 0;" << endl;
+  o << "#endif" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  " << io << "::OutputBuffer record(std::uint32_t member, std::uint32_t operation) {" << endl;
+  o << "    start_ = pending_.size();" << endl;
+  o << "    pending_.resize(start_ + " << io << "::JournalFrameSize());" << endl;
+  o << "    " << io << "::OutputBuffer o{pending_, pending_.size()" << referencesInit(p) << "};" << endl;
+  o << "    io_.Write(o, member);" << endl;
+  o << "    io_.Write(o, operation);" << endl;
+  o << "    return o;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  void seal(" << io << "::OutputBuffer &o) {" << endl;
+  o << "    pending_.resize(o.size);" << endl;
+  o << "    io_.WriteJournalFrame(pending_, start_);" << endl;
+  o << "    end_ += pending_.size() - start_;" << endl;
+  o << "    ++appended_;" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // point is the end of the journal at the time the state was taken" << endl;
+  o << "  bool save(const std::string &path, const std::vector<char> &state, std::uint64_t point) {" << endl;
+  o << "    const auto temporary = path + \".tmp\";" << endl;
+  o << "    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);" << endl;
+  o << "    if (fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    const auto written = WriteAll(fd, state.data(), state.size()) && Sync(fd);" << endl;
+  o << "    if (::close(fd) != 0 || !written) {" << endl;
+  o << "      ::unlink(temporary.c_str());" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    // the checkpoint follows the synced snapshot and has to be on disk before the snapshot replaces the old one"
+    << endl;
+  o << "    const auto hash = io_.HashBytes(0xcbf29ce484222325u, state.data(), state.size());" << endl;
+  o << "    {" << endl;
+  o << "      std::lock_guard<std::mutex> lock(mutex_);" << endl;
+  o << "      auto o = record(0, " << io << "::JournalSet);" << endl;
+  o << "      io_.Write(o, hash);" << endl;
+  o << "      io_.Write(o, end_ - point);" << endl;
+  o << "      seal(o);" << endl;
+  o << "    }" << endl;
+  o << "    if (!commit() || ::rename(temporary.c_str(), path.c_str()) != 0 || !io_.SyncDirectory(path)) {" << endl;
+  o << "      ::unlink(temporary.c_str());" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    std::unique_lock<std::mutex> lock(mutex_);" << endl;
+  o << "    synced_.wait(lock, [this]() { return !syncing_; });" << endl;
+  o << "    return !failed_ && rotate(point, hash);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  // replaces the journal by one that starts with a checkpoint of the snapshot and keeps the records from point on"
+    << endl;
+  o << "  bool rotate(std::uint64_t point, std::uint64_t hash) {" << endl;
+  o << "    std::vector<char> kept(\"" << marker << "\", \"" << marker << "\" + " << marker.size() << ");" << endl;
+  o << "    kept.resize(kept.size() + " << io << "::JournalFrameSize());" << endl;
+  o << "    " << io << "::OutputBuffer o{kept, kept.size()" << referencesInit(p) << "};" << endl;
+  o << "    io_.Write(o, std::uint32_t(0));" << endl;
+  o << "    io_.Write(o, std::uint32_t(" << io << "::JournalSet));" << endl;
+  o << "    io_.Write(o, hash);" << endl;
+  o << "    io_.Write(o, std::uint64_t(0));" << endl;
+  o << "    kept.resize(o.size);" << endl;
+  o << "    io_.WriteJournalFrame(kept, " << marker.size() << ");" << endl;
+  o << "    const auto head = kept.size();" << endl;
+  o << "    kept.resize(head + static_cast<std::size_t>(size_ - point));" << endl;
+  o << "    if (!ReadAll(fd_, kept.data() + head, kept.size() - head, point))" << endl;
+  o << "      return false;" << endl;
+  o << "    const auto temporary = path_ + \".tmp\";" << endl;
+  o << "    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);" << endl;
+  o << "    if (fd < 0)" << endl;
+  o << "      return false;" << endl;
+  o << "    if (!WriteAll(fd, kept.data(), kept.size()) || !Sync(fd) || ::rename(temporary.c_str(), path_.c_str()) != 0) {"
+    << endl;
+  o << "      ::close(fd);" << endl;
+  o << "      ::unlink(temporary.c_str());" << endl;
+  o << "      return false;" << endl;
+  o << "    }" << endl;
+  o << "    ::close(fd_);" << endl;
+  o << "    fd_ = fd;" << endl;
+  o << "    end_ -= size_ - kept.size();" << endl;
+  o << "    size_ = kept.size();" << endl;
+  o << "    return io_.SyncDirectory(path_);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  std::string path_;" << endl;
+  o << "  " << name << " &root_;" << endl;
+  o << "  " << io << " io_;" << endl;
+  o << "  int fd_{-1};" << endl;
+  o << "  std::mutex mutex_;" << endl;
+  o << "  std::condition_variable synced_;" << endl;
+  o << "  std::vector<char> pending_;" << endl;
+  o << "  std::vector<char> flushing_;" << endl;
+  o << "  std::size_t start_{0};" << endl;
+  o << "  std::uint64_t appended_{0};" << endl;
+  o << "  std::uint64_t durable_{0};" << endl;
+  o << "  std::uint64_t size_{0};" << endl;
+  o << "  std::uint64_t end_{0};" << endl;
+  o << "  bool syncing_{false};" << endl;
+  o << "  bool failed_{false};" << endl;
+  o << "  std::thread compactor_;" << endl;
+  o << "};" << endl;
+  o << "#endif" << endl;
+}
+
+void WriteVerifyIO(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root)
+    return;
+
+  o << "  bool Verify" << root->name << "(const char *data, std::size_t size) {" << endl;
+  o << "    InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "    if (!ReadHeader(i))" << endl;
+  o << "      return false;" << endl;
+  if (indexedRootVectors(p, options).empty())
+    o << "    Verify(i, " << nullOf(root->name) << ");" << endl;
+  else
+    o << "    VerifyIndexed(i);" << endl;
+  o << "    if (!i.failed && i.pos != i.size)" << endl;
+  o << "      Fail(i);" << endl;
+  o << "    return !i.failed;" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteViewIO(ostream &o, const Package &p)
+{
+  const auto *root = rootTable(p);
+  if (root && isComplex(*root))
+    o << "  bool View" << root->name << "(const char *data, std::size_t size, " << root->name << "View &v);" << endl
+      << endl;
+}
+
+void WriteViewMemberBody(ostream &o, const Package &p, const string &ret, const string &type, Pointer pointer)
+{
+  if (ret == "StringView")
+    o << "  return io.MakeView(i, " << nullOf("std::string") << ");" << endl;
+  else if (!isViewType(p, type))
+  {
+    o << "  " << ret << " v{};" << endl;
+    o << "  io.Read(i, v);" << endl;
+    o << "  return v;" << endl;
+  }
+  else if (pointer == Pointer::Unique)
+  {
+    o << "  char ref = 0;" << endl;
+    o << "  io.ReadBytes(i, &ref, 1);" << endl;
+    o << "  return ref == '\\x1' ? " << ret << "(i.data + i.pos, i.size - i.pos) : " << ret << "();" << endl;
+  }
+  else
+    o << "  return i.failed ? " << ret << "() : " << ret << "(i.data + i.pos, i.size - i.pos);" << endl;
+}
+
+vector<const Member *> indexedViewMembers(const Package &p, const Table &t, const OutputOptions &options)
+{
+  return t.name == p.root_type.value ? indexedRootVectors(p, options) : vector<const Member *>();
+}
+
+void WriteTableView(ostream &o, const Package &p, const Table &t, const OutputOptions &options)
+{
+  const auto io = p.root_type.value + "_io";
+
+  o << "struct " << t.name << "View {" << endl;
+  o << "  " << t.name << "View() = default;" << endl;
+  o << "  " << t.name << "View(const char *data, std::size_t size) : data_(data), size_(size) {}" << endl << endl;
+  o << "  explicit operator bool() const { return data_ != nullptr; }" << endl << endl;
+  for (const auto &m : t.member)
+  {
+    const auto ret = memberViewType(p, m);
+    if (!ret.empty())
+      o << "  " << ret << " " << m.name << "() const;" << endl;
+  }
+  o << endl << "private:" << endl;
+  o << "  friend struct " << io << ";" << endl << endl;
+  o << "  " << io << "::InputBuffer SeekMember(std::size_t member) const;" << endl;
+  if (!indexedViewMembers(p, t, options).empty())
+    o << "  const char *VectorIndex(std::size_t vector, std::size_t count) const;" << endl;
+  o << endl;
+  o << "  const char *data_{nullptr};" << endl;
+  o << "  std::size_t size_{0};" << endl;
+  o << "  // members are found when they are first asked for, offsets_ up to known_ hold where they start" << endl;
+  o << "  mutable std::size_t offsets_[" << t.member.size() << "]{};" << endl;
+  o << "  mutable std::size_t known_{0};" << endl;
+  o << "};" << endl << endl;
+}
+
+void WriteVectorIndexView(ostream &o, const Package &p, const Table &t, size_t vectors)
+{
+  const auto io = p.root_type.value + "_io";
+
+  o << "// the offsets of the elements from the --index-vectors trailer, nullptr if the data does not end with it" << endl;
+  o << "inline const char *" << t.name << "View::VectorIndex(std::size_t vector, std::size_t count) const {" << endl;
+  o << "  const std::size_t trailer = " << (2 * vectors + 1) << " * sizeof(std::uint64_t);" << endl;
+  o << "  if (size_ < trailer)" << endl;
+  o << "    return nullptr;" << endl;
+  o << "  " << io << " io;" << endl;
+  o << "  " << io << "::InputBuffer i{data_, size_, size_ - sizeof(std::uint64_t), false" << referencesInit(p) << "};"
+    << endl;
+  o << "  std::uint64_t length = 0;" << endl;
+  o << "  io.ReadValues(i, &length, 1);" << endl;
+  o << "  std::uint64_t entry[2] = {0, 0};" << endl;
+  o << "  i.pos = size_ - trailer + 2 * vector * sizeof(std::uint64_t);" << endl;
+  o << "  io.ReadValues(i, entry, 2);" << endl;
+  o << "  if (i.failed || length != size_ || entry[0] != count || entry[1] > size_ - trailer ||" << endl;
+  o << "      count > (size_ - trailer - entry[1]) / sizeof(std::uint64_t))" << endl;
+  o << "    return nullptr;" << endl;
+  o << "  return data_ + entry[1];" << endl;
+  o << "}" << endl << endl;
+}
+
+void WriteSeekMember(ostream &o, const Package &p, const Table &t)
+{
+  const auto io = p.root_type.value + "_io";
+
+  // a single member always starts the table, so it needs no lookup
+  o << "inline " << io << "::InputBuffer " << t.name << "View::SeekMember(std::size_t"
+    << (t.member.size() == 1 ? "" : " member") << ") const {" << endl;
+  if (t.member.size() == 1)
+  {
+    o << "  return " << io << "::InputBuffer{data_, size_, 0, false" << referencesInit(p) << "};" << endl;
+    o << "}" << endl << endl;
+    return;
+  }
+  o << "  " << io << " io;" << endl;
+  o << "  " << io << "::InputBuffer i{data_, size_, offsets_[known_], false" << referencesInit(p) << "};" << endl;
+  o << "  while (known_ < member && !i.failed) {" << endl;
+  o << "    switch (known_) {" << endl;
+  for (size_t k = 0; k + 1 < t.member.size(); ++k)
+  {
+    const auto &m = t.member[k];
+    ostringstream type;
+    WriteType(type, m, OutputOptions());
+    if (isListView(p, m))
+    {
+      o << "    case " << k << ": i.pos = this->" << m.name << "().EndOffset(); i.failed = i.pos >= size_; break;"
+        << endl;
+    }
+    else
+      o << "    case " << k << ": io.Skip(i, " << nullOf(type.str()) << "); break;" << endl;
+  }
+  o << "    }" << endl;
+  o << "    if (!i.failed)" << endl;
+  o << "      offsets_[++known_] = i.pos;" << endl;
+  o << "  }" << endl;
+  o << "  if (!i.failed)" << endl;
+  o << "    i.pos = offsets_[member];" << endl;
+  o << "  return i;" << endl;
+  o << "}" << endl << endl;
+}
+
+void WriteTableViewFunctions(ostream &o, const Package &p, const Table &t, const OutputOptions &options)
+{
+  const auto io = p.root_type.value + "_io";
+  const auto indexed = indexedViewMembers(p, t, options);
+
+  if (!indexed.empty())
+    WriteVectorIndexView(o, p, t, indexed.size());
+  WriteSeekMember(o, p, t);
+
+  for (size_t k = 0; k < t.member.size(); ++k)
+  {
+    const auto &m = t.member[k];
+    const auto ret = memberViewType(p, m);
+    if (ret.empty())
+      continue;
+
+    o << "inline " << ret << " " << t.name << "View::" << m.name << "() const {" << endl;
+    if (m.isVector || ret == "StringView" || !isViewType(p, m.type) || m.pointer == Pointer::Unique)
+      o << "  " << io << " io;" << endl;
+    o << "  auto i = SeekMember(" << k << ");" << endl;
+    if (isListView(p, m))
+    {
+      const auto vector = find(indexed.begin(), indexed.end(), &m);
+      o << "  std::size_t s{0};" << endl;
+      o << "  io.Read(i, s);" << endl;
+      o << "  if (!io.Available(i, s, 1))" << endl;
+      o << "    return " << ret << "();" << endl;
+      o << "  return " << ret << "(data_, size_, i.pos, s";
+      if (vector != indexed.end())
+        o << ", VectorIndex(" << vector - indexed.begin() << ", s)";
+      o << ");" << endl;
+    }
+    else if (m.isVector)
+    {
+      o << "  std::size_t s{0};" << endl;
+      o << "  io.Read(i, s);" << endl;
+      o << "  if (!io.Available(i, s, sizeof(" << m.type << ")))" << endl;
+      o << "    return " << ret << "();" << endl;
+      o << "  return " << ret << "(i.data + i.pos, s);" << endl;
+    }
+    else
+      WriteViewMemberBody(o, p, ret, m.type, m.pointer);
+    o << "}" << endl << endl;
+  }
+}
+
+void WriteUnionView(ostream &o, const Package &p, const Union &u)
+{
+  o << "struct " << u.name << "View {" << endl;
+  o << "  " << u.name << "View() = default;" << endl;
+  o << "  " << u.name << "View(const char *data, std::size_t size) : data_(data), size_(size) {}" << endl << endl;
+  o << "  bool is_Defined() const;" << endl;
+  for (const auto &t : u.tables)
+  {
+    o << "  bool is_" << t.value << "() const;" << endl;
+    o << "  " << viewType(p, t.value, Pointer::Plain) << " as_" << t.value << "() const;" << endl;
+  }
+  o << endl << "private:" << endl;
+  o << "  const char *data_{nullptr};" << endl;
+  o << "  std::size_t size_{0};" << endl;
+  o << "};" << endl << endl;
+}
+
+void WriteUnionViewFunctions(ostream &o, const Package &p, const Union &u)
+{
+  const auto io = p.root_type.value + "_io";
+
+  o << "inline bool " << u.name << "View::is_Defined() const {" << endl;
+  o << "  " << io << " io;" << endl;
+  o << "  " << io << "::InputBuffer i{data_, size_, 0, false" << referencesInit(p) << "};" << endl;
+  o << "  const auto selection = io.ReadSelection(i, " << nullOf(u.name) << ");" << endl;
+  o << "  return !i.failed && selection != 0;" << endl;
+  o << "}" << endl << endl;
+
+  for (size_t k = 0; k < u.tables.size(); ++k)
+  {
+    const auto &t = u.tables[k];
+    const auto ret = viewType(p, t.value, Pointer::Plain);
+
+    o << "inline bool " << u.name << "View::is_" << t.value << "() const {" << endl;
+    o << "  " << io << " io;" << endl;
+    o << "  " << io << "::InputBuffer i{data_, size_, 0, false" << referencesInit(p) << "};" << endl;
+    o << "  const auto selection = io.ReadSelection(i, " << nullOf(u.name) << ");" << endl;
+    o << "  return !i.failed && selection == " << k + 1 << ";" << endl;
+    o << "}" << endl << endl;
+
+    o << "inline " << ret << " " << u.name << "View::as_" << t.value << "() const {" << endl;
+    o << "  " << io << " io;" << endl;
+    o << "  " << io << "::InputBuffer i{data_, size_, 0, false" << referencesInit(p) << "};" << endl;
+    o << "  if (io.ReadSelection(i, " << nullOf(u.name) << ") != " << k + 1 << " || i.failed)" << endl;
+    o << "    return " << ret << "();" << endl;
+    WriteViewMemberBody(o, p, ret, t.value, Pointer::Plain);
+    o << "}" << endl << endl;
+  }
+}
+
+void WriteMakeViewFunctions(ostream &o, const Package &p, const string &name)
+{
+  const auto io = p.root_type.value + "_io";
+
+  o << "inline " << name << "View " << io << "::MakeView(InputBuffer &i, " << tagOf(name) << ") {" << endl;
+  o << "  return i.failed ? " << name << "View() : " << name << "View(i.data + i.pos, i.size - i.pos);" << endl;
+  o << "}" << endl << endl;
+
+  o << "inline " << name << "View " << io << "::MakeView(InputBuffer &i, " << tagOf("std::unique_ptr<" + name + ">")
+    << ") {" << endl;
+  o << "  char ref = 0;" << endl;
+  o << "  ReadBytes(i, &ref, 1);" << endl;
+  o << "  return ref == '\\x1' ? MakeView(i, " << nullOf(name) << ") : " << name << "View();" << endl;
+  o << "}" << endl << endl;
+}
+
+void WriteViewStructs(ostream &o, const Package &p, const OutputOptions &options)
+{
+  if (!hasViews(p))
+    return;
+
+  o << endl;
+  for (const auto &t : p.types)
+    if (t.is_Table() && isComplex(t.as_Table()))
+      WriteTableView(o, p, t.as_Table(), options);
+    else if (t.is_Union())
+      WriteUnionView(o, p, t.as_Union());
+
+  for (const auto &t : p.types)
+    if (t.is_Table() && isComplex(t.as_Table()))
+    {
+      WriteTableViewFunctions(o, p, t.as_Table(), options);
+      WriteMakeViewFunctions(o, p, t.as_Table().name);
+    }
+    else if (t.is_Union())
+    {
+      WriteUnionViewFunctions(o, p, t.as_Union());
+      WriteMakeViewFunctions(o, p, t.as_Union().name);
+    }
+
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+  const auto &name = root->name;
+  o << "inline bool " << name << "_io::View" << name << "(const char *data, std::size_t size, " << name << "View &v) {"
+    << endl;
+  o << "  InputBuffer i{data, size, 0, false" << referencesInit(p) << "};" << endl;
+  o << "  if (!ReadHeader(i))" << endl;
+  o << "    return false;" << endl;
+  o << "  v = " << name << "View(i.data + i.pos, i.size - i.pos);" << endl;
+  o << "  return true;" << endl;
+  o << "}" << endl;
+}
+
+void WritePaddedSize(ostream &o, const OutputOptions &options)
+{
+  o << "  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {" << endl;
+  if (options.compactWire)
+  {
+    o << "    char b[10];" << endl;
+    o << "    for (auto &c : b) {" << endl;
+    o << "      c = static_cast<char>((v & 0x7f) | 0x80);" << endl;
+    o << "      v >>= 7;" << endl;
+    o << "    }" << endl;
+    o << "    b[9] &= 0x7f;" << endl;
+    o << "    WriteBytes(o, b, 10);" << endl;
+  }
+  else
+    o << "    Write(o, v);" << endl;
+  o << "  }" << endl << endl;
+}
+
+void WriteIOStruct(ostream &o, const Package &p, const OutputOptions &options)
+{
+  o << "struct " << p.root_type.value << "_io {" << endl;
+  const auto *root = rootTable(p);
+  if (root && isComplex(*root))
+  {
+    o << "  friend struct " << root->name << "Writer;" << endl;
+    if (options.journal)
+      o << "  friend struct " << root->name << "Journal;" << endl;
+    o << endl;
+  }
+  if (options.views)
+    WriteViewFriends(o, p);
+  o << "private:" << endl;
+
+  WriteIOStructMember(p, o);
+  WriteBaseTypeIoFnuctions(o, p, options);
+  WriteTablesIOFunctions(o, p.types, options);
+  WriteHeaderIO(o, p, options);
+  if (options.visitor)
+    WriteVisitorInput(o, p, options);
+  WritePaddedSize(o, options);
+  WriteVectorIndexFunctions(o, p, options);
+  if (options.views || options.verifier)
+    WriteUnionSelections(o, p, options);
+  if (options.views)
+    WriteViewInput(o, p, options);
+  if (options.verifier)
+    WriteVerifyInput(o, p, options);
+  WriteDeltaFunctions(o, p, options);
+  if (options.diff || options.journal)
+    WriteHashBytes(o);
+  if (options.diff)
+    WriteDiffFunctions(o, p, options);
+  if (options.journal)
+    WriteJournalFunctions(o, p, options);
+  if (options.parallel)
+  {
+    WriteParallelOutput(o, p, options);
+    WriteParallelInput(o, p, options);
+  }
+  if (needsFileFunctions(options))
+    WriteFileFunctions(o);
+  if (options.asyncFile)
+    WriteAsyncOutput(o, p, options);
+  if (options.ioUring)
+    WriteFileRingFunctions(o, p, options);
+
+  o << "public:" << endl;
+
+  o << "  std::uint64_t ErrorOffset() const {" << endl;
+  o << "    return error_offset_;" << endl;
+  o << "  }" << endl << endl;
+
+  WriteBaseIO(o, p, options);
+  if (options.parallel)
+    WriteParallelIO(o, p, options);
+  if (options.compressed)
+    WriteCompressedIO(o, p);
+  if (options.visitor)
+    WriteVisitorIO(o, p);
+  WriteIndexedVectorIO(o, p, options);
+  if (options.views)
+    WriteViewIO(o, p);
+  if (options.verifier)
+    WriteVerifyIO(o, p, options);
+  WriteDeltaIO(o, p, options);
+  if (options.diff)
+    WriteDiffIO(o, p);
+  if (options.journal)
+    WriteJournalIO(o, p);
+  WriteSerializedSize(o, p, options);
+  if (mapsFiles(options))
+    WriteFileIO(o, p, options);
+  if (options.asyncFile)
+    WriteAsyncFileIO(o, p, options);
+  if (options.ioUring)
+    WriteRingFileIO(o, p, options);
+
+  o << "};" << endl;
+}
+
+// after the last member, the index trailer and the shared counts of a seekable stream are written
+void WriteWriterEnd(ostream &o, const Package &p, const vector<const Member *> &indexed)
+{
+  if (!indexed.empty())
+  {
+    o << "    io_.WriteVectorIndex(out_, start_, {";
+    for (size_t i = 0; i < indexed.size(); ++i)
+      o << (i == 0 ? "&" : ", &") << indexed[i]->name << "_index_";
+    o << "});" << endl;
+  }
+  if (someThingIsShared(p))
+    o << "    io_.PatchHeader(o_, header_, out_.references);" << endl;
+}
+
+void WriteRootWriter(ostream &o, const Package &p, const OutputOptions &options)
+{
+  const auto *root = rootTable(p);
+  if (!root || !isComplex(*root))
+    return;
+
+  const auto indexed = indexedRootVectors(p, options);
+  const auto isIndexed = [&indexed](const Member &m) { return find(indexed.begin(), indexed.end(), &m) != indexed.end(); };
+
+  const auto &name = root->name;
+  o << endl << "struct " << name << "Writer {" << endl;
+  o << "  explicit " << name << "Writer(std::ostream &o) : o_(o), out_{o, 0" << referencesInit(p) << "} {" << endl;
+  if (someThingIsShared(p))
+    o << "    header_ = o_.tellp();" << endl;
+  o << "    io_.WriteHeader(out_);" << endl;
+  if (!indexed.empty())
+    o << "    start_ = io_.Position(out_);" << endl;
+  o << "  }" << endl << endl;
+
+  o << "  bool done() const {" << endl;
+  o << "    return next_ == count_members && bool(o_);" << endl;
+  o << "  }" << endl << endl;
+
+  for (size_t i = 0; i < root->member.size(); ++i)
+  {
+    const auto &m = root->member[i];
+    if (!m.isVector)
+    {
+      o << "  bool write_" << m.name << "(const ";
+      WriteType(o, m, options) << " &v) {" << endl;
+      o << "    if (next_ != " << i << " || open_)" << endl;
+      o << "      return false;" << endl;
+      o << "    io_.Write(out_, v);" << endl;
+      o << "    ++next_;" << endl;
+      if (i + 1 == root->member.size())
+        WriteWriterEnd(o, p, indexed);
+      o << "    return bool(o_);" << endl;
+      o << "  }" << endl << endl;
+      continue;
+    }
+
+    o << "  bool begin_" << m.name << "() {" << endl;
+    o << "    if (next_ != " << i << " || open_)" << endl;
+    o << "      return false;" << endl;
+    o << "    position_ = o_.tellp();" << endl;
+    o << "    if (position_ == std::streampos(-1))" << endl;
+    o << "      return false;" << endl;
+    o << "    io_.WritePaddedSize(out_, 0);" << endl;
+    o << "    open_ = true;" << endl;
+    o << "    count_ = 0;" << endl;
+    o << "    return bool(o_);" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  bool begin_" << m.name << "(std::size_t size) {" << endl;
+    o << "    if (next_ != " << i << " || open_)" << endl;
+    o << "      return false;" << endl;
+    o << "    io_.Write(out_, size);" << endl;
+    o << "    position_ = std::streampos(-1);" << endl;
+    o << "    open_ = true;" << endl;
+    o << "    count_ = 0;" << endl;
+    o << "    size_ = size;" << endl;
+    o << "    return bool(o_);" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  bool push_" << m.name << "(const ";
+    WriteElementType(o, m, options) << " &v) {" << endl;
+    o << "    if (next_ != " << i << " || !open_)" << endl;
+    o << "      return false;" << endl;
+    if (isIndexed(m))
+      o << "    " << m.name << "_index_.push_back(io_.Position(out_) - start_);" << endl;
+    if (isBulkVector(p, m))
+      o << "    io_.WriteValues(out_, &v, 1);" << endl;
+    else
+      o << "    io_.Write(out_, v);" << endl;
+    o << "    ++count_;" << endl;
+    o << "    return bool(o_);" << endl;
+    o << "  }" << endl << endl;
+
+    o << "  bool end_" << m.name << "() {" << endl;
+    o << "    if (next_ != " << i << " || !open_)" << endl;
+    o << "      return false;" << endl;
+    o << "    open_ = false;" << endl;
+    o << "    ++next_;" << endl;
+    o << "    if (position_ != std::streampos(-1)) {" << endl;
+    o << "      const auto end = o_.tellp();" << endl;
+    o << "      o_.seekp(position_);" << endl;
+    o << "      io_.WritePaddedSize(o_, count_);" << endl;
+    o << "      o_.seekp(end);" << endl;
+    o << "    } else if (count_ != size_)" << endl;
+    o << "      return false;" << endl;
+    if (i + 1 == root->member.size())
+      WriteWriterEnd(o, p, indexed);
+    o << "    return bool(o_);" << endl;
+    o << "  }" << endl << endl;
+  }
+
+  o << "private:" << endl;
+  o << "  static constexpr std::size_t count_members = " << root->member.size() << ";" << endl << endl;
+  o << "  std::ostream &o_;" << endl;
+  o << "  " << p.root_type.value << "_io::OutputStream out_;" << endl;
+  o << "  " << p.root_type.value << "_io io_;" << endl;
+  o << "  std::size_t next_{0};" << endl;
+  o << "  bool open_{false};" << endl;
+  o << "  std::size_t count_{0};" << endl;
+  o << "  std::size_t size_{0};" << endl;
+  o << "  std::streampos position_{-1};" << endl;
+  if (someThingIsShared(p))
+    o << "  std::streampos header_{-1};" << endl;
+  if (!indexed.empty())
+    o << "  std::uint64_t start_{0};" << endl;
+  for (const auto *m : indexed)
+    o << "  std::vector<std::uint64_t> " << m->name << "_index_;" << endl;
+  o << "};" << endl;
+}
+
+void WriteHelperForNotImplementedTemplates(ostream &o)
+{
+  o << "template<typename T>" << endl;
+  o << "struct AlwaysFalse : std::false_type {};" << endl;
+}
+
+void WriteByteOrderFunctions(ostream &o)
+{
+  o << endl << "inline std::uint16_t SwapBytes(std::uint16_t v) {" << endl;
+  o << "  return static_cast<std::uint16_t>((v >> 8) | (v << 8));" << endl;
+  o << "}" << endl << endl;
+  o << "inline std::uint32_t SwapBytes(std::uint32_t v) {" << endl;
+  o << "  return (v >> 24) | ((v >> 8) & 0xff00u) | ((v & 0xff00u) << 8) | (v << 24);" << endl;
+  o << "}" << endl << endl;
+  o << "inline std::uint64_t SwapBytes(std::uint64_t v) {" << endl;
+  o << "  return (std::uint64_t(SwapBytes(static_cast<std::uint32_t>(v))) << 32) | "
+       "SwapBytes(static_cast<std::uint32_t>(v >> 32));"
+    << endl;
+  o << "}" << endl << endl;
+  o << "// plain loop over whole words, compilers turn it into vector shuffles" << endl;
+  o << "template<typename W> void SwapWords(char *d, const char *s, std::size_t count) {" << endl;
+  o << "  for (std::size_t n = 0; n < count; ++n) {" << endl;
+  o << "    W w;" << endl;
+  o << "    std::memcpy(&w, s + n * sizeof(W), sizeof(W));" << endl;
+  o << "    w = SwapBytes(w);" << endl;
+  o << "    std::memcpy(d + n * sizeof(W), &w, sizeof(W));" << endl;
+  o << "  }" << endl;
+  o << "}" << endl << endl;
+  o << "// copies count values of size bytes from s to d and reverses the bytes of each value, d may be s" << endl;
+  o << "inline void SwapBytes(char *d, const char *s, std::size_t count, std::size_t size) {" << endl;
+  o << "  switch (size) {" << endl;
+  o << "  case 2: SwapWords<std::uint16_t>(d, s, count); break;" << endl;
+  o << "  case 4: SwapWords<std::uint32_t>(d, s, count); break;" << endl;
+  o << "  case 8: SwapWords<std::uint64_t>(d, s, count); break;" << endl;
+  o << "  default:" << endl;
+  o << "    if (d != s && count != 0)" << endl;
+  o << "      std::memmove(d, s, count * size);" << endl;
+  o << "    for (std::size_t n = 0; size > 1 && n < count; ++n)" << endl;
+  o << "      std::reverse(d + n * size, d + (n + 1) * size);" << endl;
+  o << "  }" << endl;
+  o << "}" << endl << endl;
+  o << "// converts values between host and wire (little endian) byte order" << endl;
+  o << "template<typename T> void WireOrder(T *v, std::size_t count) {" << endl;
+  o << "#if COREBUFFER_BIG_ENDIAN" << endl;
+  o << "  SwapBytes(reinterpret_cast<char *>(v), reinterpret_cast<const char *>(v), count, sizeof(T));" << endl;
+  o << "#else" << endl;
+  o << "  (void)v;" << endl;
+  o << "  (void)count;" << endl;
+  o << "#endif" << endl;
+  o << "}" << endl;
+}
+
+void WriteCppCode(ostream &o, const Package &p, const OutputOptions &options)
+{
+  if ((options.portableWire || options.compactWire) &&
+      any_of(p.types.begin(), p.types.end(), [](const Type &t) { return t.is_Table() && !isComplex(t.as_Table()); }))
+  {
+    // tables are never copied as raw memory in the portable profile, their layout differs between compilers, and in
+    // the compact profile, their members are encoded one by one
+    Package memberwise = p;
+    for (auto &t : memberwise.types)
+      if (t.is_Table())
+        t.as_Table().isComplexType = true;
+    WriteCppCode(o, memberwise, options);
+    return;
+  }
+
+  o << "#pragma once" << endl << endl;
+
+  o << "#include <vector>" << endl;
+  o << "#include <cstdint>" << endl;
+  o << "#include <cstring>" << endl;
+  o << "#include <string>" << endl;
+  o << "#include <ostream>" << endl;
+  o << "#include <istream>" << endl;
+  o << "#include <memory>" << endl;
+  o << "#include <array>" << endl;
+  o << "#include <algorithm>" << endl;
+  o << "#include <type_traits>" << endl;
+  o << "#include <limits>" << endl;
+  if (options.parallel || options.asyncFile || options.journal)
+    o << "#include <future>" << endl;
+  if (options.parallel || options.journal)
+    o << "#include <thread>" << endl;
+  if (options.journal)
+  {
+    o << "#include <mutex>" << endl;
+    o << "#include <condition_variable>" << endl;
+  }
+  if (!sharedTypes(p).empty())
+    o << "#include <unordered_map>" << endl;
+  if (options.inlineUnionSize > 0)
+    o << "#include <new>" << endl;
+  if (options.trackChanges)
+    o << "#include <bitset>" << endl;
+  o << endl;
+
+  if (options.pmr)
+  {
+    o << "#if __cplusplus < 201703L" << endl;
+    o << "#error \"generated with --pmr, requires C++17\"" << endl;
+    o << "#endif" << endl;
+    o << "#include <memory_resource>" << endl << endl;
+  }
+
+  if (needsFileFunctions(options))
+  {
+    o << "#if defined(__unix__) || defined(__APPLE__)" << endl;
+    o << "#include <cerrno>" << endl;
+    o << "#include <fcntl.h>" << endl;
+    if (mapsFiles(options))
+      o << "#include <sys/mman.h>" << endl;
+    o << "#include <sys/stat.h>" << endl;
+    o << "#include <unistd.h>" << endl;
+    if (options.ioUring)
+    {
+      o << "#if defined(__linux__) && defined(__has_include)" << endl;
+      o << "#if __has_include(<linux/io_uring.h>)" << endl;
+      o << "#include <linux/io_uring.h>" << endl;
+      o << "#include <sys/syscall.h>" << endl;
+      o << "#include <sys/uio.h>" << endl;
+      o << "#ifndef COREBUFFER_IO_URING" << endl;
+      o << "#define COREBUFFER_IO_URING 1" << endl;
+      o << "#endif" << endl;
+      o << "#endif" << endl;
+      o << "#endif" << endl;
+    }
+    o << "#else" << endl;
+    o << "#include <fstream>" << endl;
+    o << "#endif" << endl << endl;
+  }
+
+  if (options.portableWire)
+  {
+    o << "#ifndef COREBUFFER_BIG_ENDIAN" << endl;
+    o << "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__" << endl;
+    o << "#define COREBUFFER_BIG_ENDIAN 1" << endl;
+    o << "#else" << endl;
+    o << "#define COREBUFFER_BIG_ENDIAN 0" << endl;
+    o << "#endif" << endl;
+    o << "#endif" << endl << endl;
+  }
+
+  WriteNameSpaceBegin(o, p.path.value);
+  o << endl;
+
+  WriteHelperForNotImplementedTemplates(o);
+  if (options.trackChanges)
+    WriteChangedElements(o);
+  if (options.portableWire)
+    WriteByteOrderFunctions(o);
+
+  WriteForwardDeclarations(o, p);
+  WriteTypeStructs(o, p, options);
+  if (options.visitor)
+    WriteVisitorStruct(o, p, options);
+  if (options.views)
+    WriteViewDeclarations(o, p, options);
+
+  WriteIOStruct(o, p, options);
+  if (options.views)
+    WriteViewStructs(o, p, options);
+  WriteRootWriter(o, p, options);
+  if (options.journal)
+    WriteRootJournal(o, p, options);
+
+  WriteNameSpaceEnd(o, p.path.value);
+}
@@ -1,10 +1,30 @@
-#ifndef CPPOUTPUT_H
-#define CPPOUTPUT_H
-
-#include <ostream>
-
-#include "package.h"
-
-void WriteCppCode(std::ostream &o, const Package &p);
-
-#endif  // CPPOUTPUT_H
+#ifndef CPPOUTPUT_H
+#define CPPOUTPUT_H
+
+#include <ostream>
+
+#include "package.h"
+
+struct OutputOptions
+{
+  bool compactWire{false};
+  bool portableWire{false};
+  bool indexedVectors{false};
+  bool pmr{false};
+  bool trackChanges{false};
+  bool parallel{false};
+  bool asyncFile{false};
+  bool ioUring{false};
+  bool diff{false};
+  bool journal{false};
+  bool compressed{false};
+  bool visitor{false};
+  bool views{false};
+  bool verifier{false};
+  bool mappedFile{false};
+  unsigned int inlineUnionSize{0};
+};
+
+void WriteCppCode(std::ostream &o, const Package &p, const OutputOptions &options = OutputOptions());
+
+#endif  // CPPOUTPUT_H
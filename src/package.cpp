@@ -1 +1 @@
-#include "package.h"
+#include "package.h"
@@ -1,443 +1,717 @@
-#pragma once
-
-#include <vector>
-#include <string>
-#include <ostream>
-#include <istream>
-#include <memory>
-#include <array>
-#include <algorithm>
-#include <type_traits>
-
-namespace Scope {
-
-template<typename T>
-struct AlwaysFalse : std::false_type {};
-
-struct BaseTypes;
-struct PointerBaseTypes;
-struct Initializer;
-struct Root;
-
-struct BaseTypes {
-  std::int32_t a{0};
-  std::int16_t aa{0};
-  std::int64_t ab{0};
-  bool b{false};
-  float c{0.0f};
-  double d{0.0};
-  std::int8_t e{0};
-  std::int16_t f{0};
-  std::int32_t g{0};
-  std::int64_t h{0};
-  std::uint8_t i{0u};
-  std::uint16_t j{0u};
-  std::uint32_t k{0u};
-  std::uint64_t l{0u};
-  std::string m;
-
-  BaseTypes() = default;
-
-  friend bool operator==(const BaseTypes&l, const BaseTypes&r) {
-    return 
-      l.a == r.a
-      && l.aa == r.aa
-      && l.ab == r.ab
-      && l.b == r.b
-      && l.c == r.c
-      && l.d == r.d
-      && l.e == r.e
-      && l.f == r.f
-      && l.g == r.g
-      && l.h == r.h
-      && l.i == r.i
-      && l.j == r.j
-      && l.k == r.k
-      && l.l == r.l
-      && l.m == r.m;
-  }
-
-  friend bool operator!=(const BaseTypes&l, const BaseTypes&r) {
-    return 
-      l.a != r.a
-      || l.aa != r.aa
-      || l.ab != r.ab
-      || l.b != r.b
-      || l.c != r.c
-      || l.d != r.d
-      || l.e != r.e
-      || l.f != r.f
-      || l.g != r.g
-      || l.h != r.h
-      || l.i != r.i
-      || l.j != r.j
-      || l.k != r.k
-      || l.l != r.l
-      || l.m != r.m;
-  }
-};
-
-struct PointerBaseTypes {
-  std::vector<std::string> b1;
-  std::vector<std::int32_t> x;
-
-  PointerBaseTypes() = default;
-
-  friend bool operator==(const PointerBaseTypes&l, const PointerBaseTypes&r) {
-    return 
-      l.b1 == r.b1
-      && l.x == r.x;
-  }
-
-  friend bool operator!=(const PointerBaseTypes&l, const PointerBaseTypes&r) {
-    return 
-      l.b1 != r.b1
-      || l.x != r.x;
-  }
-
-  template<class T> void fill_b1(const T &v) {
-    std::fill(b1.begin(), b1.end(), v);
-  }
-
-  template<class Generator> void generate_b1(Generator gen) {
-    std::generate(b1.begin(), b1.end(), gen);
-  }
-
-  template<class T> std::vector<std::string>::iterator remove_b1(const T &v) {
-    return std::remove(b1.begin(), b1.end(), v);
-  }
-  template<class Pred> std::vector<std::string>::iterator remove_b1_if(Pred v) {
-    return std::remove_if(b1.begin(), b1.end(), v);
-  }
-
-  template<class T> void erase_b1(const T &v) {
-    b1.erase(remove_b1(v));
-  }
-  template<class Pred> void erase_b1_if(Pred v) {
-    b1.erase(remove_b1_if(v));
-  }
-
-  void reverse_b1() {
-    std::reverse(b1.begin(), b1.end());
-  }
-
-  void rotate_b1(std::vector<std::string>::iterator i) {
-    std::rotate(b1.begin(), i, b1.end());
-  }
-
-  void sort_b1() {
-    std::sort(b1.begin(), b1.end());
-  }
-  template<class Comp> void sort_b1(Comp p) {
-    std::sort(b1.begin(), b1.end(), p);
-  }
-
-  template<class Comp> bool any_of_b1(Comp p) {
-    return std::any_of(b1.begin(), b1.end(), p);
-  }
-  template<class T> bool any_of_b1_is(const T &p) {
-    return any_of_b1([&p](const std::string &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_b1(Comp p) {
-    return std::all_of(b1.begin(), b1.end(), p);
-  }
-  template<class T> bool all_of_b1_are(const T &p) {
-    return all_of_b1([&p](const std::string &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_b1(Comp p) {
-    return std::none_of(b1.begin(), b1.end(), p);
-  }
-  template<class T> bool none_of_b1_is(const T &p) {
-    return none_of_b1([&p](const std::string &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_b1(Fn p) {
-    return std::for_each(b1.begin(), b1.end(), p);
-  }
-
-  template<class T> std::vector<std::string>::iterator find_in_b1(const T &p) {
-    return std::find(b1.begin(), b1.end(), p);
-  }
-  template<class Comp> std::vector<std::string>::iterator find_in_b1_if(Comp p) {
-    return std::find_if(b1.begin(), b1.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<std::string>::iterator>::difference_type count_in_b1(const T &p) {
-    return std::count(b1.begin(), b1.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<std::string>::iterator>::difference_type count_in_b1_if(Comp p) {
-    return std::count_if(b1.begin(), b1.end(), p);
-  }
-
-  template<class T> void fill_x(const T &v) {
-    std::fill(x.begin(), x.end(), v);
-  }
-
-  template<class Generator> void generate_x(Generator gen) {
-    std::generate(x.begin(), x.end(), gen);
-  }
-
-  template<class T> std::vector<std::int32_t>::iterator remove_x(const T &v) {
-    return std::remove(x.begin(), x.end(), v);
-  }
-  template<class Pred> std::vector<std::int32_t>::iterator remove_x_if(Pred v) {
-    return std::remove_if(x.begin(), x.end(), v);
-  }
-
-  template<class T> void erase_x(const T &v) {
-    x.erase(remove_x(v));
-  }
-  template<class Pred> void erase_x_if(Pred v) {
-    x.erase(remove_x_if(v));
-  }
-
-  void reverse_x() {
-    std::reverse(x.begin(), x.end());
-  }
-
-  void rotate_x(std::vector<std::int32_t>::iterator i) {
-    std::rotate(x.begin(), i, x.end());
-  }
-
-  void sort_x() {
-    std::sort(x.begin(), x.end());
-  }
-  template<class Comp> void sort_x(Comp p) {
-    std::sort(x.begin(), x.end(), p);
-  }
-
-  template<class Comp> bool any_of_x(Comp p) {
-    return std::any_of(x.begin(), x.end(), p);
-  }
-  template<class T> bool any_of_x_is(const T &p) {
-    return any_of_x([&p](const std::int32_t &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_x(Comp p) {
-    return std::all_of(x.begin(), x.end(), p);
-  }
-  template<class T> bool all_of_x_are(const T &p) {
-    return all_of_x([&p](const std::int32_t &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_x(Comp p) {
-    return std::none_of(x.begin(), x.end(), p);
-  }
-  template<class T> bool none_of_x_is(const T &p) {
-    return none_of_x([&p](const std::int32_t &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_x(Fn p) {
-    return std::for_each(x.begin(), x.end(), p);
-  }
-
-  template<class T> std::vector<std::int32_t>::iterator find_in_x(const T &p) {
-    return std::find(x.begin(), x.end(), p);
-  }
-  template<class Comp> std::vector<std::int32_t>::iterator find_in_x_if(Comp p) {
-    return std::find_if(x.begin(), x.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<std::int32_t>::iterator>::difference_type count_in_x(const T &p) {
-    return std::count(x.begin(), x.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<std::int32_t>::iterator>::difference_type count_in_x_if(Comp p) {
-    return std::count_if(x.begin(), x.end(), p);
-  }
-};
-
-struct Initializer {
-  std::int32_t a{3};
-  float b{4.2f};
-  std::uint64_t c{999933030303003u};
-
-  Initializer() = default;
-  Initializer(const std::int32_t &a_)
-    : a(a_)
-  {}
-  Initializer(const float &b_, const std::int32_t &a_)
-    : a(a_)
-    , b(b_)
-  {}
-
-  friend bool operator==(const Initializer&l, const Initializer&r) {
-    return 
-      l.a == r.a
-      && l.b == r.b
-      && l.c == r.c;
-  }
-
-  friend bool operator!=(const Initializer&l, const Initializer&r) {
-    return 
-      l.a != r.a
-      || l.b != r.b
-      || l.c != r.c;
-  }
-};
-
-struct Root {
-  BaseTypes a;
-  PointerBaseTypes b;
-  Initializer c;
-
-  Root() = default;
-
-  friend bool operator==(const Root&l, const Root&r) {
-    return 
-      l.a == r.a
-      && l.b == r.b
-      && l.c == r.c;
-  }
-
-  friend bool operator!=(const Root&l, const Root&r) {
-    return 
-      l.a != r.a
-      || l.b != r.b
-      || l.c != r.c;
-  }
-};
-
-struct Root_io {
-private:
-  template<typename T> void Write(std::ostream &, const T *) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &o, const T &v) {
-    o.write(reinterpret_cast<const char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<T> &v) {
-    Write(o, v.size());
-    o.write(reinterpret_cast<const char *>(v.data()), sizeof(T) * v.size());
-  }
-
-  void Write(std::ostream &o, const std::vector<std::string> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  template<typename T> void Write(std::ostream &, const std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  void Write(std::ostream &o, const std::string &v) {
-    Write(o, v.size());
-    o.write(v.data(), v.size());
-  }
-
-  template<typename T> void Read(std::istream &i, T &v) {
-    i.read(reinterpret_cast<char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Read(std::istream &, std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &i, std::vector<T> &v) {
-    typename std::vector<T>::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(reinterpret_cast<char *>(v.data()), sizeof(T) * s);
-  }
-
-  void Read(std::istream &i, std::vector<std::string> &v) {
-    auto size = v.size();
-    Read(i, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(i, entry);
-  }
-
-  void Read(std::istream &i, std::string &v) {
-    std::string::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(&v[0], s);
-  }
-
-  void Write(std::ostream &o, const BaseTypes &v) {
-    Write(o, v.a);
-    Write(o, v.aa);
-    Write(o, v.ab);
-    Write(o, v.b);
-    Write(o, v.c);
-    Write(o, v.d);
-    Write(o, v.e);
-    Write(o, v.f);
-    Write(o, v.g);
-    Write(o, v.h);
-    Write(o, v.i);
-    Write(o, v.j);
-    Write(o, v.k);
-    Write(o, v.l);
-    Write(o, v.m);
-  }
-
-  void Read(std::istream &s, BaseTypes &v) {
-    Read(s, v.a);
-    Read(s, v.aa);
-    Read(s, v.ab);
-    Read(s, v.b);
-    Read(s, v.c);
-    Read(s, v.d);
-    Read(s, v.e);
-    Read(s, v.f);
-    Read(s, v.g);
-    Read(s, v.h);
-    Read(s, v.i);
-    Read(s, v.j);
-    Read(s, v.k);
-    Read(s, v.l);
-    Read(s, v.m);
-  }
-
-  void Write(std::ostream &o, const PointerBaseTypes &v) {
-    Write(o, v.b1);
-    Write(o, v.x);
-  }
-
-  void Read(std::istream &s, PointerBaseTypes &v) {
-    Read(s, v.b1);
-    Read(s, v.x);
-  }
-
-  void Write(std::ostream &o, const Root &v) {
-    Write(o, v.a);
-    Write(o, v.b);
-    Write(o, v.c);
-  }
-
-  void Read(std::istream &s, Root &v) {
-    Read(s, v.a);
-    Read(s, v.b);
-    Read(s, v.c);
-  }
-
-public:
-  void WriteRoot(std::ostream &o, const Root &v) {
-
-    o.write("CORE", 4);
-    o.write("0.0", 3);
-    Write(o, v);
-  }
-
-  bool ReadRoot(std::istream &i, Root &v) {
-
-    std::string marker("0000");
-    i.read(&marker[0], 4);
-    if (marker != "CORE")
-      return false;
-    std::string version(3, '_');
-    i.read(&version[0], 3);
-    if (version != "0.0")
-      return false;
-    Read(i, v);
-    return true;
-  }
-
-};
-}
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+
+namespace Scope {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+struct BaseTypes;
+struct PointerBaseTypes;
+struct Initializer;
+struct Root;
+
+struct BaseTypes {
+  std::int32_t a{0};
+  std::int16_t aa{0};
+  std::int64_t ab{0};
+  bool b{false};
+  float c{0.0f};
+  double d{0.0};
+  std::int8_t e{0};
+  std::int16_t f{0};
+  std::int32_t g{0};
+  std::int64_t h{0};
+  std::uint8_t i{0u};
+  std::uint16_t j{0u};
+  std::uint32_t k{0u};
+  std::uint64_t l{0u};
+  std::string m;
+
+  BaseTypes() = default;
+
+  friend bool operator==(const BaseTypes&l, const BaseTypes&r) {
+    return 
+      l.a == r.a
+      && l.aa == r.aa
+      && l.ab == r.ab
+      && l.b == r.b
+      && l.c == r.c
+      && l.d == r.d
+      && l.e == r.e
+      && l.f == r.f
+      && l.g == r.g
+      && l.h == r.h
+      && l.i == r.i
+      && l.j == r.j
+      && l.k == r.k
+      && l.l == r.l
+      && l.m == r.m;
+  }
+
+  friend bool operator!=(const BaseTypes&l, const BaseTypes&r) {
+    return 
+      l.a != r.a
+      || l.aa != r.aa
+      || l.ab != r.ab
+      || l.b != r.b
+      || l.c != r.c
+      || l.d != r.d
+      || l.e != r.e
+      || l.f != r.f
+      || l.g != r.g
+      || l.h != r.h
+      || l.i != r.i
+      || l.j != r.j
+      || l.k != r.k
+      || l.l != r.l
+      || l.m != r.m;
+  }
+};
+
+struct PointerBaseTypes {
+  std::vector<std::string> b1;
+  std::vector<std::int32_t> x;
+
+  PointerBaseTypes() = default;
+
+  friend bool operator==(const PointerBaseTypes&l, const PointerBaseTypes&r) {
+    return 
+      l.b1 == r.b1
+      && l.x == r.x;
+  }
+
+  friend bool operator!=(const PointerBaseTypes&l, const PointerBaseTypes&r) {
+    return 
+      l.b1 != r.b1
+      || l.x != r.x;
+  }
+
+  template<class T> void fill_b1(const T &v) {
+    std::fill(b1.begin(), b1.end(), v);
+  }
+
+  template<class Generator> void generate_b1(Generator gen) {
+    std::generate(b1.begin(), b1.end(), gen);
+  }
+
+  template<class T> std::vector<std::string>::iterator remove_b1(const T &v) {
+    return std::remove(b1.begin(), b1.end(), v);
+  }
+  template<class Pred> std::vector<std::string>::iterator remove_b1_if(Pred v) {
+    return std::remove_if(b1.begin(), b1.end(), v);
+  }
+
+  template<class T> void erase_b1(const T &v) {
+    b1.erase(remove_b1(v));
+  }
+  template<class Pred> void erase_b1_if(Pred v) {
+    b1.erase(remove_b1_if(v));
+  }
+
+  void reverse_b1() {
+    std::reverse(b1.begin(), b1.end());
+  }
+
+  void rotate_b1(std::vector<std::string>::iterator i) {
+    std::rotate(b1.begin(), i, b1.end());
+  }
+
+  void sort_b1() {
+    std::sort(b1.begin(), b1.end());
+  }
+  template<class Comp> void sort_b1(Comp p) {
+    std::sort(b1.begin(), b1.end(), p);
+  }
+
+  template<class Comp> bool any_of_b1(Comp p) {
+    return std::any_of(b1.begin(), b1.end(), p);
+  }
+  template<class T> bool any_of_b1_is(const T &p) {
+    return any_of_b1([&p](const std::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_b1(Comp p) {
+    return std::all_of(b1.begin(), b1.end(), p);
+  }
+  template<class T> bool all_of_b1_are(const T &p) {
+    return all_of_b1([&p](const std::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_b1(Comp p) {
+    return std::none_of(b1.begin(), b1.end(), p);
+  }
+  template<class T> bool none_of_b1_is(const T &p) {
+    return none_of_b1([&p](const std::string &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_b1(Fn p) {
+    return std::for_each(b1.begin(), b1.end(), p);
+  }
+
+  template<class T> std::vector<std::string>::iterator find_in_b1(const T &p) {
+    return std::find(b1.begin(), b1.end(), p);
+  }
+  template<class Comp> std::vector<std::string>::iterator find_in_b1_if(Comp p) {
+    return std::find_if(b1.begin(), b1.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::string>::iterator>::difference_type count_in_b1(const T &p) {
+    return std::count(b1.begin(), b1.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::string>::iterator>::difference_type count_in_b1_if(Comp p) {
+    return std::count_if(b1.begin(), b1.end(), p);
+  }
+
+  template<class T> void fill_x(const T &v) {
+    std::fill(x.begin(), x.end(), v);
+  }
+
+  template<class Generator> void generate_x(Generator gen) {
+    std::generate(x.begin(), x.end(), gen);
+  }
+
+  template<class T> std::vector<std::int32_t>::iterator remove_x(const T &v) {
+    return std::remove(x.begin(), x.end(), v);
+  }
+  template<class Pred> std::vector<std::int32_t>::iterator remove_x_if(Pred v) {
+    return std::remove_if(x.begin(), x.end(), v);
+  }
+
+  template<class T> void erase_x(const T &v) {
+    x.erase(remove_x(v));
+  }
+  template<class Pred> void erase_x_if(Pred v) {
+    x.erase(remove_x_if(v));
+  }
+
+  void reverse_x() {
+    std::reverse(x.begin(), x.end());
+  }
+
+  void rotate_x(std::vector<std::int32_t>::iterator i) {
+    std::rotate(x.begin(), i, x.end());
+  }
+
+  void sort_x() {
+    std::sort(x.begin(), x.end());
+  }
+  template<class Comp> void sort_x(Comp p) {
+    std::sort(x.begin(), x.end(), p);
+  }
+
+  template<class Comp> bool any_of_x(Comp p) {
+    return std::any_of(x.begin(), x.end(), p);
+  }
+  template<class T> bool any_of_x_is(const T &p) {
+    return any_of_x([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_x(Comp p) {
+    return std::all_of(x.begin(), x.end(), p);
+  }
+  template<class T> bool all_of_x_are(const T &p) {
+    return all_of_x([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_x(Comp p) {
+    return std::none_of(x.begin(), x.end(), p);
+  }
+  template<class T> bool none_of_x_is(const T &p) {
+    return none_of_x([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_x(Fn p) {
+    return std::for_each(x.begin(), x.end(), p);
+  }
+
+  template<class T> std::vector<std::int32_t>::iterator find_in_x(const T &p) {
+    return std::find(x.begin(), x.end(), p);
+  }
+  template<class Comp> std::vector<std::int32_t>::iterator find_in_x_if(Comp p) {
+    return std::find_if(x.begin(), x.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::int32_t>::iterator>::difference_type count_in_x(const T &p) {
+    return std::count(x.begin(), x.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::int32_t>::iterator>::difference_type count_in_x_if(Comp p) {
+    return std::count_if(x.begin(), x.end(), p);
+  }
+};
+
+struct Initializer {
+  std::int32_t a{3};
+  float b{4.2f};
+  std::uint64_t c{999933030303003u};
+
+  Initializer() = default;
+  Initializer(const std::int32_t &a_)
+    : a(a_)
+  {}
+  Initializer(const float &b_, const std::int32_t &a_)
+    : a(a_)
+    , b(b_)
+  {}
+
+  friend bool operator==(const Initializer&l, const Initializer&r) {
+    return 
+      l.a == r.a
+      && l.b == r.b
+      && l.c == r.c;
+  }
+
+  friend bool operator!=(const Initializer&l, const Initializer&r) {
+    return 
+      l.a != r.a
+      || l.b != r.b
+      || l.c != r.c;
+  }
+};
+
+struct Root {
+  BaseTypes a;
+  PointerBaseTypes b;
+  Initializer c;
+
+  Root() = default;
+
+  friend bool operator==(const Root&l, const Root&r) {
+    return 
+      l.a == r.a
+      && l.b == r.b
+      && l.c == r.c;
+  }
+
+  friend bool operator!=(const Root&l, const Root&r) {
+    return 
+      l.a != r.a
+      || l.b != r.b
+      || l.c != r.c;
+  }
+};
+
+struct Root_io {
+  friend struct RootWriter;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O> void Write(O &o, const std::vector<std::string> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O> void Write(O &o, const std::string &v) const {
+    Write(o, v.size());
+    WriteBytes(o, v.data(), v.size());
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename I> void Read(I &i, std::vector<std::string> &v) {
+    auto size = v.size();
+    Read(i, size);
+    if (!Available(i, size, sizeof(std::string::size_type)))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(i, entry);
+  }
+
+  template<typename I> void Read(I &i, std::string &v) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    v.resize(s);
+    ReadBytes(i, &v[0], s);
+  }
+
+  template<typename O> void Write(O &o, const BaseTypes &v) const {
+    Write(o, v.a);
+    Write(o, v.aa);
+    Write(o, v.ab);
+    Write(o, v.b);
+    Write(o, v.c);
+    Write(o, v.d);
+    Write(o, v.e);
+    Write(o, v.f);
+    Write(o, v.g);
+    Write(o, v.h);
+    Write(o, v.i);
+    Write(o, v.j);
+    Write(o, v.k);
+    Write(o, v.l);
+    Write(o, v.m);
+  }
+
+  template<typename I> void Read(I &s, BaseTypes &v) {
+    Read(s, v.a);
+    Read(s, v.aa);
+    Read(s, v.ab);
+    Read(s, v.b);
+    Read(s, v.c);
+    Read(s, v.d);
+    Read(s, v.e);
+    Read(s, v.f);
+    Read(s, v.g);
+    Read(s, v.h);
+    Read(s, v.i);
+    Read(s, v.j);
+    Read(s, v.k);
+    Read(s, v.l);
+    Read(s, v.m);
+  }
+
+  template<typename O> void Write(O &o, const PointerBaseTypes &v) const {
+    Write(o, v.b1);
+    Write(o, v.x);
+  }
+
+  template<typename I> void Read(I &s, PointerBaseTypes &v) {
+    Read(s, v.b1);
+    Read(s, v.x);
+  }
+
+  template<typename O> void Write(O &o, const Root &v) const {
+    Write(o, v.a);
+    Write(o, v.b);
+    Write(o, v.c);
+  }
+
+  template<typename I> void Read(I &s, Root &v) {
+    Read(s, v.a);
+    Read(s, v.b);
+    Read(s, v.c);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.0", 3);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    return std::memcmp(version, "0.0", 3) == 0;
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteRoot(std::ostream &o, const Root &v) const {
+
+    OutputStream s{o, 0};
+    WriteHeader(s);
+    Write(s, v);
+  }
+
+  void WriteRoot(std::vector<char> &b, const Root &v) const {
+
+    OutputBuffer o{b, b.size()};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+  }
+
+  bool ReadRoot(std::istream &stream, Root &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadRoot(const char *data, std::size_t size, Root &v) {
+
+    InputBuffer i{data, size, 0, false};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  std::size_t SerializedSize(const BaseTypes &v) const {
+    OutputCounter c{0};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const PointerBaseTypes &v) const {
+    OutputCounter c{0};
+    Write(c, v);
+    return c.size;
+  }
+
+  static constexpr std::size_t SerializedSize(const Initializer &) {
+    return sizeof(Initializer);
+  }
+
+  std::size_t SerializedSize(const Root &v) const {
+    OutputCounter c{0};
+    WriteHeader(c);
+    Write(c, v);
+    return c.size;
+  }
+
+};
+
+struct RootWriter {
+  explicit RootWriter(std::ostream &o) : o_(o), out_{o, 0} {
+    io_.WriteHeader(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_a(const BaseTypes &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_b(const PointerBaseTypes &v) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_c(const Initializer &v) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 3;
+
+  std::ostream &o_;
+  Root_io::OutputStream out_;
+  Root_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+};
+}
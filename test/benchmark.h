@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Runs fn() repeatedly for at least half a second and prints the throughput for the given payload size.
+template <typename Fn>
+double benchmark(const std::string &name, std::size_t bytes, Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+
+  fn();
+  std::size_t iterations = 0;
+  const auto start = clock::now();
+  auto elapsed = clock::duration::zero();
+  do
+  {
+    fn();
+    ++iterations;
+    elapsed = clock::now() - start;
+  } while (elapsed < std::chrono::milliseconds(500));
+
+  const auto seconds = std::chrono::duration<double>(elapsed).count() / iterations;
+  const auto mbPerSecond = bytes / seconds / (1024.0 * 1024.0);
+  std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed
+            << std::setprecision(3) << seconds * 1000.0 << " ms" << std::setw(12) << std::setprecision(1)
+            << mbPerSecond << " MB/s" << std::endl;
+  return mbPerSecond;
+}
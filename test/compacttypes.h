@@ -0,0 +1,2466 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+namespace Compact {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+struct Numbers;
+struct Name;
+struct Entry;
+struct Root;
+
+template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
+  return l.lock() == r.lock();
+}
+
+template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
+  return l.lock() != r.lock();
+}
+
+struct Numbers {
+  std::int16_t a{0};
+  std::int32_t b{0};
+  std::int64_t c{0};
+  std::uint16_t d{0u};
+  std::uint32_t e{0u};
+  std::uint64_t f{0u};
+  std::int8_t g{0};
+  float h{0.0f};
+
+  Numbers() = default;
+
+  friend bool operator==(const Numbers&l, const Numbers&r) {
+    return 
+      l.a == r.a
+      && l.b == r.b
+      && l.c == r.c
+      && l.d == r.d
+      && l.e == r.e
+      && l.f == r.f
+      && l.g == r.g
+      && l.h == r.h;
+  }
+
+  friend bool operator!=(const Numbers&l, const Numbers&r) {
+    return 
+      l.a != r.a
+      || l.b != r.b
+      || l.c != r.c
+      || l.d != r.d
+      || l.e != r.e
+      || l.f != r.f
+      || l.g != r.g
+      || l.h != r.h;
+  }
+};
+
+struct Name {
+  std::string name;
+  std::int32_t value{0};
+
+  Name() = default;
+  Name(const std::string &name_, const std::int32_t &value_)
+    : name(name_)
+    , value(value_)
+  {}
+
+  friend bool operator==(const Name&l, const Name&r) {
+    return 
+      l.name == r.name
+      && l.value == r.value;
+  }
+
+  friend bool operator!=(const Name&l, const Name&r) {
+    return 
+      l.name != r.name
+      || l.value != r.value;
+  }
+};
+
+struct Entry {
+  Entry() = default;
+  Entry(const Entry &o) { _clone(o); }
+  Entry& operator=(const Entry &o) {
+    if (this != &o)
+      *this = Entry(o);
+    return *this;
+  }
+  Entry(Entry &&o) noexcept { _move(o); }
+  Entry& operator=(Entry &&o) noexcept {
+    if (this != &o) {
+      _destroy();
+      _move(o);
+    }
+    return *this;
+  }
+
+  Entry(const Numbers &v)
+    : _Numbers(new Numbers(v))
+    , _selection(_Numbers_selection)
+  {}
+  Entry(Numbers &&v)
+    : _Numbers(new Numbers(std::forward<Numbers>(v)))
+    , _selection(_Numbers_selection)
+  {}
+  Entry & operator=(const Numbers &v) {
+    auto *n = new Numbers(v);
+    _destroy();
+    _Numbers = n;
+    _selection = _Numbers_selection;
+    return *this;
+  }
+  Entry & operator=(Numbers &&v) {
+    auto *n = new Numbers(std::forward<Numbers>(v));
+    _destroy();
+    _Numbers = n;
+    _selection = _Numbers_selection;
+    return *this;
+  }
+
+  Entry(const Name &v)
+    : _Name(new Name(v))
+    , _selection(_Name_selection)
+  {}
+  Entry(Name &&v)
+    : _Name(new Name(std::forward<Name>(v)))
+    , _selection(_Name_selection)
+  {}
+  Entry & operator=(const Name &v) {
+    auto *n = new Name(v);
+    _destroy();
+    _Name = n;
+    _selection = _Name_selection;
+    return *this;
+  }
+  Entry & operator=(Name &&v) {
+    auto *n = new Name(std::forward<Name>(v));
+    _destroy();
+    _Name = n;
+    _selection = _Name_selection;
+    return *this;
+  }
+
+  ~Entry() {
+    _destroy();
+  }
+
+  bool is_Defined() const noexcept { return _selection != no_selection; }
+  void clear() { *this = Entry(); }
+  void swap(Entry &o) noexcept {
+    Entry t(std::move(o));
+    o = std::move(*this);
+    *this = std::move(t);
+  }
+  friend void swap(Entry &l, Entry &r) noexcept { l.swap(r); }
+
+  bool is_Numbers() const noexcept { return _selection == _Numbers_selection; }
+  const Numbers & as_Numbers() const noexcept { return *_Numbers; }
+  Numbers & as_Numbers() { return *_Numbers; }
+  template<typename... Args> Numbers & create_Numbers(Args&&... args) {
+    return (*this = Numbers(std::forward<Args>(args)...)).as_Numbers();
+  }
+
+  bool is_Name() const noexcept { return _selection == _Name_selection; }
+  const Name & as_Name() const noexcept { return *_Name; }
+  Name & as_Name() { return *_Name; }
+  template<typename... Args> Name & create_Name(Args&&... args) {
+    return (*this = Name(std::forward<Args>(args)...)).as_Name();
+  }
+
+  friend bool operator==(const Entry&ab, const Numbers &o) noexcept  { return ab.is_Numbers() && ab.as_Numbers() == o; }
+  friend bool operator==(const Numbers &o, const Entry&ab) noexcept  { return ab.is_Numbers() && o == ab.as_Numbers(); }
+  friend bool operator!=(const Entry&ab, const Numbers &o) noexcept  { return !ab.is_Numbers() || ab.as_Numbers() != o; }
+  friend bool operator!=(const Numbers &o, const Entry&ab) noexcept  { return !ab.is_Numbers() || o != ab.as_Numbers(); }
+
+  friend bool operator==(const Entry&ab, const Name &o) noexcept  { return ab.is_Name() && ab.as_Name() == o; }
+  friend bool operator==(const Name &o, const Entry&ab) noexcept  { return ab.is_Name() && o == ab.as_Name(); }
+  friend bool operator!=(const Entry&ab, const Name &o) noexcept  { return !ab.is_Name() || ab.as_Name() != o; }
+  friend bool operator!=(const Name &o, const Entry&ab) noexcept  { return !ab.is_Name() || o != ab.as_Name(); }
+
+  bool operator==(const Entry &o) const noexcept
+  {
+    if (this == &o)
+      return true;
+    if (_selection != o._selection)
+      return false;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return true;
+    case _Numbers_selection: return *_Numbers == *o._Numbers;
+    case _Name_selection: return *_Name == *o._Name;
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+  bool operator!=(const Entry &o) const noexcept
+  {
+    if (this == &o)
+      return false;
+    if (_selection != o._selection)
+      return true;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return false;
+    case _Numbers_selection: return *_Numbers != *o._Numbers;
+    case _Name_selection: return *_Name != *o._Name;
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+private:
+  void _clone(const Entry &o) noexcept
+  {
+     _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Numbers_selection: _Numbers = new Numbers(*o._Numbers); break;
+    case _Name_selection: _Name = new Name(*o._Name); break;
+    }
+  }
+
+  void _move(Entry &o) noexcept
+  {
+    _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Numbers_selection: _Numbers = o._Numbers; break;
+    case _Name_selection: _Name = o._Name; break;
+    }
+    o.no_value = nullptr;
+    o._selection = no_selection;
+  }
+
+  void _destroy() noexcept {
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Numbers_selection: delete _Numbers; break;
+    case _Name_selection: delete _Name; break;
+    }
+    no_value = nullptr;
+  }
+
+  union {
+    struct NoValue_t *no_value{nullptr};
+    Numbers * _Numbers;
+    Name * _Name;
+  };
+
+  enum Selection_t {
+    no_selection,
+    _Numbers_selection,
+    _Name_selection,
+  };
+
+  Selection_t _selection{no_selection};
+  friend struct Root_io;
+};
+
+struct Root {
+  Numbers numbers;
+  std::vector<std::string> names;
+  std::vector<std::int32_t> values;
+  std::vector<Entry> entries;
+  std::shared_ptr<Name> first;
+  std::vector<std::shared_ptr<Name>> others;
+  std::weak_ptr<Name> last;
+
+  Root() = default;
+
+  friend bool operator==(const Root&l, const Root&r) {
+    return 
+      l.numbers == r.numbers
+      && l.names == r.names
+      && l.values == r.values
+      && l.entries == r.entries
+      && l.first == r.first
+      && l.others == r.others
+      && l.last == r.last;
+  }
+
+  friend bool operator!=(const Root&l, const Root&r) {
+    return 
+      l.numbers != r.numbers
+      || l.names != r.names
+      || l.values != r.values
+      || l.entries != r.entries
+      || l.first != r.first
+      || l.others != r.others
+      || l.last != r.last;
+  }
+
+  template<class T> void fill_names(const T &v) {
+    std::fill(names.begin(), names.end(), v);
+  }
+
+  template<class Generator> void generate_names(Generator gen) {
+    std::generate(names.begin(), names.end(), gen);
+  }
+
+  template<class T> std::vector<std::string>::iterator remove_names(const T &v) {
+    return std::remove(names.begin(), names.end(), v);
+  }
+  template<class Pred> std::vector<std::string>::iterator remove_names_if(Pred v) {
+    return std::remove_if(names.begin(), names.end(), v);
+  }
+
+  template<class T> void erase_names(const T &v) {
+    names.erase(remove_names(v));
+  }
+  template<class Pred> void erase_names_if(Pred v) {
+    names.erase(remove_names_if(v));
+  }
+
+  void reverse_names() {
+    std::reverse(names.begin(), names.end());
+  }
+
+  void rotate_names(std::vector<std::string>::iterator i) {
+    std::rotate(names.begin(), i, names.end());
+  }
+
+  void sort_names() {
+    std::sort(names.begin(), names.end());
+  }
+  template<class Comp> void sort_names(Comp p) {
+    std::sort(names.begin(), names.end(), p);
+  }
+
+  template<class Comp> bool any_of_names(Comp p) {
+    return std::any_of(names.begin(), names.end(), p);
+  }
+  template<class T> bool any_of_names_is(const T &p) {
+    return any_of_names([&p](const std::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_names(Comp p) {
+    return std::all_of(names.begin(), names.end(), p);
+  }
+  template<class T> bool all_of_names_are(const T &p) {
+    return all_of_names([&p](const std::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_names(Comp p) {
+    return std::none_of(names.begin(), names.end(), p);
+  }
+  template<class T> bool none_of_names_is(const T &p) {
+    return none_of_names([&p](const std::string &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_names(Fn p) {
+    return std::for_each(names.begin(), names.end(), p);
+  }
+
+  template<class T> std::vector<std::string>::iterator find_in_names(const T &p) {
+    return std::find(names.begin(), names.end(), p);
+  }
+  template<class Comp> std::vector<std::string>::iterator find_in_names_if(Comp p) {
+    return std::find_if(names.begin(), names.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::string>::iterator>::difference_type count_in_names(const T &p) {
+    return std::count(names.begin(), names.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::string>::iterator>::difference_type count_in_names_if(Comp p) {
+    return std::count_if(names.begin(), names.end(), p);
+  }
+
+  template<class T> void fill_values(const T &v) {
+    std::fill(values.begin(), values.end(), v);
+  }
+
+  template<class Generator> void generate_values(Generator gen) {
+    std::generate(values.begin(), values.end(), gen);
+  }
+
+  template<class T> std::vector<std::int32_t>::iterator remove_values(const T &v) {
+    return std::remove(values.begin(), values.end(), v);
+  }
+  template<class Pred> std::vector<std::int32_t>::iterator remove_values_if(Pred v) {
+    return std::remove_if(values.begin(), values.end(), v);
+  }
+
+  template<class T> void erase_values(const T &v) {
+    values.erase(remove_values(v));
+  }
+  template<class Pred> void erase_values_if(Pred v) {
+    values.erase(remove_values_if(v));
+  }
+
+  void reverse_values() {
+    std::reverse(values.begin(), values.end());
+  }
+
+  void rotate_values(std::vector<std::int32_t>::iterator i) {
+    std::rotate(values.begin(), i, values.end());
+  }
+
+  void sort_values() {
+    std::sort(values.begin(), values.end());
+  }
+  template<class Comp> void sort_values(Comp p) {
+    std::sort(values.begin(), values.end(), p);
+  }
+
+  template<class Comp> bool any_of_values(Comp p) {
+    return std::any_of(values.begin(), values.end(), p);
+  }
+  template<class T> bool any_of_values_is(const T &p) {
+    return any_of_values([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_values(Comp p) {
+    return std::all_of(values.begin(), values.end(), p);
+  }
+  template<class T> bool all_of_values_are(const T &p) {
+    return all_of_values([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_values(Comp p) {
+    return std::none_of(values.begin(), values.end(), p);
+  }
+  template<class T> bool none_of_values_is(const T &p) {
+    return none_of_values([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_values(Fn p) {
+    return std::for_each(values.begin(), values.end(), p);
+  }
+
+  template<class T> std::vector<std::int32_t>::iterator find_in_values(const T &p) {
+    return std::find(values.begin(), values.end(), p);
+  }
+  template<class Comp> std::vector<std::int32_t>::iterator find_in_values_if(Comp p) {
+    return std::find_if(values.begin(), values.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::int32_t>::iterator>::difference_type count_in_values(const T &p) {
+    return std::count(values.begin(), values.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::int32_t>::iterator>::difference_type count_in_values_if(Comp p) {
+    return std::count_if(values.begin(), values.end(), p);
+  }
+
+  template<class T> void fill_entries(const T &v) {
+    std::fill(entries.begin(), entries.end(), v);
+  }
+
+  template<class Generator> void generate_entries(Generator gen) {
+    std::generate(entries.begin(), entries.end(), gen);
+  }
+
+  template<class T> std::vector<Entry>::iterator remove_entries(const T &v) {
+    return std::remove(entries.begin(), entries.end(), v);
+  }
+  template<class Pred> std::vector<Entry>::iterator remove_entries_if(Pred v) {
+    return std::remove_if(entries.begin(), entries.end(), v);
+  }
+
+  template<class T> void erase_entries(const T &v) {
+    entries.erase(remove_entries(v));
+  }
+  template<class Pred> void erase_entries_if(Pred v) {
+    entries.erase(remove_entries_if(v));
+  }
+
+  void reverse_entries() {
+    std::reverse(entries.begin(), entries.end());
+  }
+
+  void rotate_entries(std::vector<Entry>::iterator i) {
+    std::rotate(entries.begin(), i, entries.end());
+  }
+
+  template<class Comp> void sort_entries(Comp p) {
+    std::sort(entries.begin(), entries.end(), p);
+  }
+
+  template<class Comp> bool any_of_entries(Comp p) {
+    return std::any_of(entries.begin(), entries.end(), p);
+  }
+  template<class T> bool any_of_entries_is(const T &p) {
+    return any_of_entries([&p](const Entry &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_entries(Comp p) {
+    return std::all_of(entries.begin(), entries.end(), p);
+  }
+  template<class T> bool all_of_entries_are(const T &p) {
+    return all_of_entries([&p](const Entry &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_entries(Comp p) {
+    return std::none_of(entries.begin(), entries.end(), p);
+  }
+  template<class T> bool none_of_entries_is(const T &p) {
+    return none_of_entries([&p](const Entry &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_entries(Fn p) {
+    return std::for_each(entries.begin(), entries.end(), p);
+  }
+
+  template<class T> std::vector<Entry>::iterator find_in_entries(const T &p) {
+    return std::find(entries.begin(), entries.end(), p);
+  }
+  template<class Comp> std::vector<Entry>::iterator find_in_entries_if(Comp p) {
+    return std::find_if(entries.begin(), entries.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<Entry>::iterator>::difference_type count_in_entries(const T &p) {
+    return std::count(entries.begin(), entries.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<Entry>::iterator>::difference_type count_in_entries_if(Comp p) {
+    return std::count_if(entries.begin(), entries.end(), p);
+  }
+
+  template<class T> void fill_others(const T &v) {
+    std::fill(others.begin(), others.end(), v);
+  }
+
+  template<class Generator> void generate_others(Generator gen) {
+    std::generate(others.begin(), others.end(), gen);
+  }
+
+  template<class T> std::vector<std::shared_ptr<Name>>::iterator remove_others(const T &v) {
+    return std::remove(others.begin(), others.end(), v);
+  }
+  template<class Pred> std::vector<std::shared_ptr<Name>>::iterator remove_others_if(Pred v) {
+    return std::remove_if(others.begin(), others.end(), v);
+  }
+
+  template<class T> void erase_others(const T &v) {
+    others.erase(remove_others(v));
+  }
+  template<class Pred> void erase_others_if(Pred v) {
+    others.erase(remove_others_if(v));
+  }
+
+  void reverse_others() {
+    std::reverse(others.begin(), others.end());
+  }
+
+  void rotate_others(std::vector<std::shared_ptr<Name>>::iterator i) {
+    std::rotate(others.begin(), i, others.end());
+  }
+
+  template<class Comp> void sort_others(Comp p) {
+    std::sort(others.begin(), others.end(), p);
+  }
+
+  template<class Comp> bool any_of_others(Comp p) {
+    return std::any_of(others.begin(), others.end(), p);
+  }
+  template<class T> bool any_of_others_is(const T &p) {
+    return any_of_others([&p](const std::shared_ptr<Name> &x) { return x && *x == p; });
+  }
+
+  bool any_of_others_is(const std::shared_ptr<Name> &p) {
+    return any_of_others([&p](const std::shared_ptr<Name> &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_others(Comp p) {
+    return std::all_of(others.begin(), others.end(), p);
+  }
+  template<class T> bool all_of_others_are(const T &p) {
+    return all_of_others([&p](const std::shared_ptr<Name> &x) { return x && *x == p; });
+  }
+
+  bool all_of_others_are(const std::shared_ptr<Name> &p) {
+    return all_of_others([&p](const std::shared_ptr<Name> &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_others(Comp p) {
+    return std::none_of(others.begin(), others.end(), p);
+  }
+  template<class T> bool none_of_others_is(const T &p) {
+    return none_of_others([&p](const std::shared_ptr<Name> &x) { return x && *x == p; });
+  }
+
+  bool none_of_others_is(const std::shared_ptr<Name> &p) {
+    return none_of_others([&p](const std::shared_ptr<Name> &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_others(Fn p) {
+    return std::for_each(others.begin(), others.end(), p);
+  }
+
+  template<class T> std::vector<std::shared_ptr<Name>>::iterator find_in_others(const T &p) {
+    return std::find(others.begin(), others.end(), p);
+  }
+  template<class Comp> std::vector<std::shared_ptr<Name>>::iterator find_in_others_if(Comp p) {
+    return std::find_if(others.begin(), others.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::shared_ptr<Name>>::iterator>::difference_type count_in_others(const T &p) {
+    return std::count(others.begin(), others.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::shared_ptr<Name>>::iterator>::difference_type count_in_others_if(Comp p) {
+    return std::count_if(others.begin(), others.end(), p);
+  }
+};
+
+struct RootVisitor {
+  virtual ~RootVisitor() = default;
+
+  virtual void on_numbers(const Numbers &) {}
+  virtual void on_names_begin(std::size_t) {}
+  virtual void on_names_element(const std::string &) {}
+  virtual void on_names_end() {}
+  virtual void on_values_begin(std::size_t) {}
+  virtual void on_values_element(const std::int32_t &) {}
+  virtual void on_values_end() {}
+  virtual void on_entries_begin(std::size_t) {}
+  virtual void on_entries_element(const Entry &) {}
+  virtual void on_entries_end() {}
+  virtual void on_first(const std::shared_ptr<Name> &) {}
+  virtual void on_others_begin(std::size_t) {}
+  virtual void on_others_element(const std::shared_ptr<Name> &) {}
+  virtual void on_others_end() {}
+  virtual void on_last(const std::weak_ptr<Name> &) {}
+};
+
+struct StringView {
+  StringView() = default;
+  StringView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::string str() const { return size_ == 0 ? std::string() : std::string(data_, size_); }
+
+  friend bool operator==(const StringView &l, const std::string &r) {
+    return l.size_ == r.size() && (l.size_ == 0 || std::memcmp(l.data_, r.data(), l.size_) == 0);
+  }
+  friend bool operator!=(const StringView &l, const std::string &r) { return !(l == r); }
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+template<typename T> struct ArrayView {
+  ArrayView() = default;
+  ArrayView(const char *data, std::size_t count) : data_(data), count_(count) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  T operator[](std::size_t index) const {
+    T v;
+    std::memcpy(static_cast<void *>(&v), data_ + index * sizeof(T), sizeof(T));
+    return v;
+  }
+
+  struct iterator {
+    const ArrayView *view;
+    std::size_t index;
+
+    T operator*() const { return (*view)[index]; }
+    iterator &operator++() { ++index; return *this; }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{this, count_}; }
+
+private:
+  const char *data_{nullptr};
+  std::size_t count_{0};
+};
+
+// elements are found by passing the ones in front of them, or through the offset index of --index-vectors;
+// the offsets passed for indexing are kept, so indexing the same list again takes constant time
+template<typename IO, typename E, typename Encoded> struct ListView {
+  ListView() = default;
+  ListView(const char *data, std::size_t size, std::size_t first, std::size_t count, const char *index = nullptr)
+    : data_(data), size_(size), first_(first), count_(count), index_(index) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  E operator[](std::size_t index) const {
+    return At(Find(index));
+  }
+
+  struct iterator {
+    const ListView *view;
+    std::size_t index;
+    std::size_t pos;
+
+    E operator*() const { return view->At(pos); }
+    iterator &operator++() {
+      ++index;
+      pos = view->index_ ? view->Find(index) : view->Next(pos);
+      // a list that cannot be passed ends where it broke
+      if (pos >= view->size_)
+        index = view->count_;
+      return *this;
+    }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0, index_ ? Find(0) : first_}; }
+  iterator end() const { return iterator{this, count_, size_}; }
+
+  // where the list ends, the size of the data if it cannot be passed
+  std::size_t EndOffset() const {
+    if (count_ == 0)
+      return first_;
+    if (index_)
+      return Next(Find(count_ - 1));
+    auto pos = first_;
+    for (std::size_t n = 0; n < count_ && pos < size_; ++n)
+      pos = Next(pos);
+    return pos;
+  }
+
+private:
+  std::size_t Next(std::size_t pos) const {
+    if (pos >= size_)
+      return size_;
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false, {}};
+    io.Skip(i, static_cast<const Encoded *>(nullptr));
+    return i.failed ? size_ : i.pos;
+  }
+
+  std::size_t Find(std::size_t index) const {
+    if (index >= count_)
+      return size_;
+    if (index_) {
+      IO io;
+      typename IO::InputBuffer i{index_, count_ * sizeof(std::uint64_t), index * sizeof(std::uint64_t), false, {}};
+      std::uint64_t offset = 0;
+      io.ReadValues(i, &offset, 1);
+      return i.failed || offset >= size_ ? size_ : static_cast<std::size_t>(offset);
+    }
+    if (offsets_.empty())
+      offsets_.push_back(first_);
+    while (offsets_.size() <= index && offsets_.back() < size_)
+      offsets_.push_back(Next(offsets_.back()));
+    return offsets_.size() > index ? offsets_[index] : size_;
+  }
+
+  E At(std::size_t pos) const {
+    if (pos >= size_)
+      return E();
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false, {}};
+    return io.MakeView(i, static_cast<const Encoded *>(nullptr));
+  }
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  std::size_t first_{0};
+  std::size_t count_{0};
+  const char *index_{nullptr};
+  mutable std::vector<std::size_t> offsets_;
+};
+struct NumbersView;
+struct NameView;
+struct EntryView;
+struct RootView;
+
+struct Root_io {
+  friend struct RootWriter;
+
+  friend struct NumbersView;
+  friend struct NameView;
+  friend struct EntryView;
+  friend struct RootView;
+  template<typename, typename, typename> friend struct ListView;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct WriteReferences {
+    std::unordered_map<const Name *, unsigned int> Name_ids;
+  };
+
+  struct ReadReferences {
+    std::vector<std::shared_ptr<Name>> Name_objects;
+    std::uint32_t Name_count{0};
+    std::uint64_t Name_verified{0};
+  };
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O> void Write(O &o, const std::vector<std::string> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::shared_ptr<T> &v, std::unordered_map<const T *, unsigned int> &ids) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+      return;
+    }
+    const auto entry = ids.emplace(v.get(), static_cast<unsigned int>(ids.size() + 1));
+    if (entry.second) {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    } else {
+      WriteBytes(o, "\x2", 1);
+      Write(o, entry.first->second);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<std::shared_ptr<T>> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &, const std::weak_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O> void Write(O &o, const std::string &v) const {
+    Write(o, v.size());
+    WriteBytes(o, v.data(), v.size());
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false, {}};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  template<typename O> void WriteVarint(O &o, std::uint64_t v) const {
+    char b[10];
+    std::size_t s = 0;
+    while (v >= 0x80) {
+      b[s++] = static_cast<char>(v | 0x80);
+      v >>= 7;
+    }
+    b[s++] = static_cast<char>(v);
+    WriteBytes(o, b, s);
+  }
+
+  template<typename I> void ReadVarint(I &i, std::uint64_t &v) {
+    v = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+      char c = 0;
+      ReadBytes(i, &c, 1);
+      v |= std::uint64_t(static_cast<unsigned char>(c) & 0x7f) << shift;
+      if ((c & 0x80) == 0)
+        return;
+    }
+    Fail(i);
+  }
+
+  void ReadVarint(InputBuffer &i, std::uint64_t &v) {
+    if (i.pos < i.size && (i.data[i.pos] & 0x80) == 0) {
+      v = static_cast<unsigned char>(i.data[i.pos++]);
+      return;
+    }
+    v = 0;
+    for (unsigned int shift = 0; shift < 64 && i.pos < i.size; shift += 7) {
+      const auto c = static_cast<unsigned char>(i.data[i.pos++]);
+      v |= std::uint64_t(c & 0x7f) << shift;
+      if ((c & 0x80) == 0)
+        return;
+    }
+    Fail(i);
+  }
+
+  template<typename O> void Write(O &o, const unsigned short &v) const {
+    WriteVarint(o, v);
+  }
+
+  template<typename I> void Read(I &i, unsigned short &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    if (u > std::numeric_limits<unsigned short>::max())
+      Fail(i);
+    v = static_cast<unsigned short>(u);
+  }
+
+  template<typename O> void Write(O &o, const unsigned int &v) const {
+    WriteVarint(o, v);
+  }
+
+  template<typename I> void Read(I &i, unsigned int &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    if (u > std::numeric_limits<unsigned int>::max())
+      Fail(i);
+    v = static_cast<unsigned int>(u);
+  }
+
+  template<typename O> void Write(O &o, const unsigned long &v) const {
+    WriteVarint(o, v);
+  }
+
+  template<typename I> void Read(I &i, unsigned long &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    if (u > std::numeric_limits<unsigned long>::max())
+      Fail(i);
+    v = static_cast<unsigned long>(u);
+  }
+
+  template<typename O> void Write(O &o, const unsigned long long &v) const {
+    WriteVarint(o, v);
+  }
+
+  template<typename I> void Read(I &i, unsigned long long &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    if (u > std::numeric_limits<unsigned long long>::max())
+      Fail(i);
+    v = static_cast<unsigned long long>(u);
+  }
+
+  template<typename O> void Write(O &o, const short &v) const {
+    const auto u = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+    WriteVarint(o, (u << 1) ^ (v < 0 ? ~std::uint64_t(0) : std::uint64_t(0)));
+  }
+
+  template<typename I> void Read(I &i, short &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    const auto d = static_cast<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));
+    if (d < std::numeric_limits<short>::min() || d > std::numeric_limits<short>::max())
+      Fail(i);
+    v = static_cast<short>(d);
+  }
+
+  template<typename O> void Write(O &o, const int &v) const {
+    const auto u = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+    WriteVarint(o, (u << 1) ^ (v < 0 ? ~std::uint64_t(0) : std::uint64_t(0)));
+  }
+
+  template<typename I> void Read(I &i, int &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    const auto d = static_cast<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));
+    if (d < std::numeric_limits<int>::min() || d > std::numeric_limits<int>::max())
+      Fail(i);
+    v = static_cast<int>(d);
+  }
+
+  template<typename O> void Write(O &o, const long &v) const {
+    const auto u = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+    WriteVarint(o, (u << 1) ^ (v < 0 ? ~std::uint64_t(0) : std::uint64_t(0)));
+  }
+
+  template<typename I> void Read(I &i, long &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    const auto d = static_cast<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));
+    if (d < std::numeric_limits<long>::min() || d > std::numeric_limits<long>::max())
+      Fail(i);
+    v = static_cast<long>(d);
+  }
+
+  template<typename O> void Write(O &o, const long long &v) const {
+    const auto u = static_cast<std::uint64_t>(static_cast<std::int64_t>(v));
+    WriteVarint(o, (u << 1) ^ (v < 0 ? ~std::uint64_t(0) : std::uint64_t(0)));
+  }
+
+  template<typename I> void Read(I &i, long long &v) {
+    std::uint64_t u = 0;
+    ReadVarint(i, u);
+    const auto d = static_cast<std::int64_t>((u >> 1) ^ (~(u & 1) + 1));
+    if (d < std::numeric_limits<long long>::min() || d > std::numeric_limits<long long>::max())
+      Fail(i);
+    v = static_cast<long long>(d);
+  }
+
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &, std::weak_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache, std::uint32_t count) {
+    char ref = 0;
+    ReadBytes(s, &ref, 1);
+    if (ref == '\x1') {
+      // every object takes at least a byte, a count larger than the input left is no reason to allocate
+      if (cache.empty())
+        cache.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, Remaining(s))));
+      v = std::make_shared<T>();
+      cache.push_back(v);
+      Read(s, *v);
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(s, index);
+      if (index == 0 || index > cache.size()) {
+        Fail(s);
+        v.reset();
+      } else {
+        v = cache[index - 1];
+      }
+    } else {
+      if (ref != '\0')
+        Fail(s);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &s, std::vector<std::shared_ptr<T>> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename I> void Read(I &i, std::vector<std::string> &v) {
+    auto size = v.size();
+    Read(i, size);
+    if (!Available(i, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(i, entry);
+  }
+
+  template<typename I> void Read(I &i, std::string &v) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    v.resize(s);
+    ReadBytes(i, &v[0], s);
+  }
+
+  template<typename O> void Write(O &o, const Numbers &v) const {
+    Write(o, v.a);
+    Write(o, v.b);
+    Write(o, v.c);
+    Write(o, v.d);
+    Write(o, v.e);
+    Write(o, v.f);
+    Write(o, v.g);
+    Write(o, v.h);
+  }
+
+  template<typename I> void Read(I &s, Numbers &v) {
+    Read(s, v.a);
+    Read(s, v.b);
+    Read(s, v.c);
+    Read(s, v.d);
+    Read(s, v.e);
+    Read(s, v.f);
+    Read(s, v.g);
+    Read(s, v.h);
+  }
+
+  template<typename O> void Write(O &o, const Name &v) const {
+    Write(o, v.name);
+    Write(o, v.value);
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<Name> &v) const {
+    Write(o, v, o.references.Name_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::weak_ptr<Name> &v) const {
+    Write(o, v.lock(), o.references.Name_ids);
+  }
+
+  template<typename I> void Read(I &s, Name &v) {
+    Read(s, v.name);
+    Read(s, v.value);
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<Name> &v) {
+    Read(s, v, s.references.Name_objects, s.references.Name_count);
+  }
+
+  template<typename I> void Read(I &s, std::weak_ptr<Name> &v) {
+    auto t = v.lock();
+    Read(s, t, s.references.Name_objects, s.references.Name_count);
+    v = t;
+  }
+
+  template<typename O> void Write(O &o, const Entry &v) const {
+    WriteVarint(o, static_cast<std::uint64_t>(v._selection));
+    switch(v._selection) {
+    case Entry::no_selection: while(false); /* hack for coverage tool */ break;
+    case Entry::_Numbers_selection: Write(o, v.as_Numbers()); break;
+    case Entry::_Name_selection: Write(o, v.as_Name()); break;
+    }
+  }
+
+  template<typename O> void Write(O &o, const std::vector<Entry> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &i, Entry &v) {
+    std::uint64_t value = 0;
+    ReadVarint(i, value);
+    if (value > 2) {
+      v.clear();
+      Fail(i);
+      return;
+    }
+    switch(static_cast<Entry::Selection_t>(value)) {
+    case Entry::no_selection: v.clear(); break;
+    case Entry::_Numbers_selection: Read(i, v.create_Numbers()); break;
+    case Entry::_Name_selection: Read(i, v.create_Name()); break;
+    }
+  }
+
+  template<typename I> void Read(I &s, std::vector<Entry> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Root &v) const {
+    Write(o, v.numbers);
+    Write(o, v.names);
+    Write(o, v.values);
+    Write(o, v.entries);
+    Write(o, v.first);
+    Write(o, v.others);
+    Write(o, v.last);
+  }
+
+  template<typename I> void Read(I &s, Root &v) {
+    Read(s, v.numbers);
+    Read(s, v.names);
+    Read(s, v.values);
+    Read(s, v.entries);
+    Read(s, v.first);
+    Read(s, v.others);
+    Read(s, v.last);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORC\x01", 5);
+    WriteBytes(o, "0.0", 3);
+    const std::uint32_t counts[1] = {};
+    WriteValues(o, counts, 1);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORC\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    if (std::memcmp(version, "0.0", 3) != 0)
+      return false;
+    std::uint32_t counts[1] = {};
+    ReadValues(i, counts, 1);
+    i.references.Name_count = counts[0];
+    return !Failed(i) && Available(i, std::size_t(counts[0]), 1);
+  }
+
+  void PatchHeader(char *header, const WriteReferences &references) const {
+    const std::uint32_t counts[1] = {
+      static_cast<std::uint32_t>(references.Name_ids.size()),
+    };
+    std::memcpy(header + 8, counts, sizeof(counts));
+  }
+
+  void PatchHeader(std::ostream &o, std::ostream::pos_type start, const WriteReferences &references) const {
+    const auto end = o.tellp();
+    if (start == std::ostream::pos_type(-1) || end == std::ostream::pos_type(-1))
+      return;
+    char header[12];
+    PatchHeader(header, references);
+    o.seekp(start + std::streamoff(8));
+    o.write(header + 8, 4);
+    o.seekp(end);
+  }
+
+  template<typename I> void Visit(I &i, RootVisitor &visitor) {
+    {
+      Numbers value{};
+      Read(i, value);
+      visitor.on_numbers(value);
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_names_begin(size);
+      std::string entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_names_element(entry);
+      }
+      visitor.on_names_end();
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_values_begin(size);
+      std::int32_t entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        ReadValues(i, &entry, 1);
+        visitor.on_values_element(entry);
+      }
+      visitor.on_values_end();
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_entries_begin(size);
+      Entry entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_entries_element(entry);
+      }
+      visitor.on_entries_end();
+    }
+    {
+      std::shared_ptr<Name> value{};
+      Read(i, value);
+      visitor.on_first(value);
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_others_begin(size);
+      std::shared_ptr<Name> entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_others_element(entry);
+      }
+      visitor.on_others_end();
+    }
+    {
+      std::weak_ptr<Name> value{};
+      Read(i, value);
+      visitor.on_last(value);
+    }
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    char b[10];
+    for (auto &c : b) {
+      c = static_cast<char>((v & 0x7f) | 0x80);
+      v >>= 7;
+    }
+    b[9] &= 0x7f;
+    WriteBytes(o, b, 10);
+  }
+
+  std::uint64_t ReadSelection(InputBuffer &i, const Entry *) {
+    std::uint64_t value = 0;
+    ReadVarint(i, value);
+    if (value > 2)
+      Fail(i);
+    return value;
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void SkipEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Skip(InputBuffer &i, const std::vector<std::string> *) {
+    SkipEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      Skip(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+    }
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::weak_ptr<T> *) {
+    Skip(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::weak_ptr<T> *>(nullptr));
+  }
+
+  StringView MakeView(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return StringView();
+    i.pos += s;
+    return StringView(i.data + i.pos - s, s);
+  }
+  void Skip(InputBuffer &i, const Numbers *) {
+    Skip(i, static_cast<const std::int16_t *>(nullptr));
+    Skip(i, static_cast<const std::int32_t *>(nullptr));
+    Skip(i, static_cast<const std::int64_t *>(nullptr));
+    Skip(i, static_cast<const std::uint16_t *>(nullptr));
+    Skip(i, static_cast<const std::uint32_t *>(nullptr));
+    Skip(i, static_cast<const std::uint64_t *>(nullptr));
+    Skip(i, static_cast<const std::int8_t *>(nullptr));
+    Skip(i, static_cast<const float *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Numbers> *) {
+    SkipEach(i, static_cast<const Numbers *>(nullptr));
+  }
+
+  NumbersView MakeView(InputBuffer &i, const Numbers *);
+  NumbersView MakeView(InputBuffer &i, const std::unique_ptr<Numbers> *);
+
+  void Skip(InputBuffer &i, const Name *) {
+    Skip(i, static_cast<const std::string *>(nullptr));
+    Skip(i, static_cast<const std::int32_t *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Name> *) {
+    SkipEach(i, static_cast<const Name *>(nullptr));
+  }
+
+  NameView MakeView(InputBuffer &i, const Name *);
+  NameView MakeView(InputBuffer &i, const std::unique_ptr<Name> *);
+
+  void Skip(InputBuffer &i, const Entry *) {
+    switch (ReadSelection(i, static_cast<const Entry *>(nullptr))) {
+    case 1: Skip(i, static_cast<const Numbers *>(nullptr)); break;
+    case 2: Skip(i, static_cast<const Name *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Entry> *) {
+    SkipEach(i, static_cast<const Entry *>(nullptr));
+  }
+
+  EntryView MakeView(InputBuffer &i, const Entry *);
+  EntryView MakeView(InputBuffer &i, const std::unique_ptr<Entry> *);
+
+  void Skip(InputBuffer &i, const Root *) {
+    Skip(i, static_cast<const Numbers *>(nullptr));
+    Skip(i, static_cast<const std::vector<std::string> *>(nullptr));
+    Skip(i, static_cast<const std::vector<std::int32_t> *>(nullptr));
+    Skip(i, static_cast<const std::vector<Entry> *>(nullptr));
+    Skip(i, static_cast<const std::shared_ptr<Name> *>(nullptr));
+    Skip(i, static_cast<const std::vector<std::shared_ptr<Name>> *>(nullptr));
+    Skip(i, static_cast<const std::weak_ptr<Name> *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Root> *) {
+    SkipEach(i, static_cast<const Root *>(nullptr));
+  }
+
+  RootView MakeView(InputBuffer &i, const Root *);
+  RootView MakeView(InputBuffer &i, const std::unique_ptr<Root> *);
+
+  template<typename T> void Verify(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void VerifyEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Verify(i, static_cast<const T *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Verify(InputBuffer &i, const std::vector<std::string> *) {
+    VerifyEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Verify(i, static_cast<const T *>(nullptr));
+    else if (ref != '\0')
+      Fail(i);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  static std::uint64_t &Verified(InputBuffer &i, const Name *) {
+    return i.references.Name_verified;
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      ++Verified(i, static_cast<const T *>(nullptr));
+      Verify(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+      if (index == 0 || index > Verified(i, static_cast<const T *>(nullptr)))
+        Fail(i);
+    } else if (ref != '\0') {
+      Fail(i);
+    }
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::weak_ptr<T> *) {
+    Verify(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Numbers *) {
+    Verify(i, static_cast<const std::int16_t *>(nullptr));
+    Verify(i, static_cast<const std::int32_t *>(nullptr));
+    Verify(i, static_cast<const std::int64_t *>(nullptr));
+    Verify(i, static_cast<const std::uint16_t *>(nullptr));
+    Verify(i, static_cast<const std::uint32_t *>(nullptr));
+    Verify(i, static_cast<const std::uint64_t *>(nullptr));
+    Verify(i, static_cast<const std::int8_t *>(nullptr));
+    Verify(i, static_cast<const float *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Numbers> *) {
+    VerifyEach(i, static_cast<const Numbers *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Name *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const std::int32_t *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Name> *) {
+    VerifyEach(i, static_cast<const Name *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Entry *) {
+    switch (ReadSelection(i, static_cast<const Entry *>(nullptr))) {
+    case 1: Verify(i, static_cast<const Numbers *>(nullptr)); break;
+    case 2: Verify(i, static_cast<const Name *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Entry> *) {
+    VerifyEach(i, static_cast<const Entry *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Root *) {
+    Verify(i, static_cast<const Numbers *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::string> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::int32_t> *>(nullptr));
+    Verify(i, static_cast<const std::vector<Entry> *>(nullptr));
+    Verify(i, static_cast<const std::shared_ptr<Name> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::shared_ptr<Name>> *>(nullptr));
+    Verify(i, static_cast<const std::weak_ptr<Name> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Root> *) {
+    VerifyEach(i, static_cast<const Root *>(nullptr));
+  }
+
+  static constexpr std::size_t ParallelSliceMinimum() {
+    return 1024;
+  }
+
+  template<typename T> std::vector<char> EncodeSlice(const T *begin, const T *end) {
+    std::vector<char> b;
+    OutputBuffer o{b, 0, {}};
+    for (auto entry = begin; entry != end; ++entry) {
+      Write(o, *entry);
+    }
+    b.resize(o.size);
+    return b;
+  }
+
+  template<typename O, typename T> void WriteVectorParallel(O &o, const std::vector<T> &v, unsigned int threads) const {
+    Write(o, v.size());
+    const auto slices = std::min<std::size_t>(threads, v.size() / ParallelSliceMinimum());
+    if (slices < 2) {
+      for (const auto &entry : v) {
+        Write(o, entry);
+      }
+      return;
+    }
+
+    std::vector<std::future<std::vector<char>>> parts;
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto *begin = v.data() + v.size() * s / slices;
+      const auto *end = v.data() + v.size() * (s + 1) / slices;
+      parts.push_back(std::async(std::launch::async, [begin, end]() {
+        return Root_io().EncodeSlice(begin, end);
+      }));
+    }
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto part = parts[s].get();
+      WriteBytes(o, part.data(), part.size());
+    }
+  }
+
+  template<typename O> void WriteParallel(O &o, const Root &v, unsigned int threads) const {
+    Write(o, v.numbers);
+    WriteVectorParallel(o, v.names, threads);
+    Write(o, v.values);
+    WriteVectorParallel(o, v.entries, threads);
+    Write(o, v.first);
+    Write(o, v.others);
+    Write(o, v.last);
+  }
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteRoot(std::ostream &o, const Root &v) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteRoot(std::vector<char> &b, const Root &v) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool ReadRoot(std::istream &stream, Root &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadRoot(const char *data, std::size_t size, Root &v) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  void WriteRootParallel(std::ostream &o, const Root &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    WriteParallel(s, v, threads);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteRootParallel(std::vector<char> &b, const Root &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    WriteParallel(o, v, threads);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool VisitRoot(std::istream &stream, RootVisitor &visitor) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Visit(i, visitor);
+    return !Failed(i);
+  }
+
+  bool VisitRoot(const char *data, std::size_t size, RootVisitor &visitor) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Visit(i, visitor);
+    return !Failed(i);
+  }
+
+  bool ViewRoot(const char *data, std::size_t size, RootView &v);
+
+  bool VerifyRoot(const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Verify(i, static_cast<const Root *>(nullptr));
+    if (!i.failed && i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  std::size_t SerializedSize(const Numbers &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Name &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Entry &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Root &v) const {
+    OutputCounter c{0, {}};
+    WriteHeader(c);
+    Write(c, v);
+    return c.size;
+  }
+
+};
+
+struct NumbersView {
+  NumbersView() = default;
+  NumbersView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  std::int16_t a() const;
+  std::int32_t b() const;
+  std::int64_t c() const;
+  std::uint16_t d() const;
+  std::uint32_t e() const;
+  std::uint64_t f() const;
+  std::int8_t g() const;
+  float h() const;
+
+private:
+  friend struct Root_io;
+
+  Root_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[8]{};
+  mutable std::size_t known_{0};
+};
+
+struct NameView {
+  NameView() = default;
+  NameView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  StringView name() const;
+  std::int32_t value() const;
+
+private:
+  friend struct Root_io;
+
+  Root_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[2]{};
+  mutable std::size_t known_{0};
+};
+
+struct EntryView {
+  EntryView() = default;
+  EntryView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  bool is_Defined() const;
+  bool is_Numbers() const;
+  NumbersView as_Numbers() const;
+  bool is_Name() const;
+  NameView as_Name() const;
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+struct RootView {
+  RootView() = default;
+  RootView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  NumbersView numbers() const;
+  ListView<Root_io, StringView, std::string> names() const;
+  ArrayView<std::int32_t> values() const;
+  ListView<Root_io, EntryView, Entry> entries() const;
+
+private:
+  friend struct Root_io;
+
+  Root_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[7]{};
+  mutable std::size_t known_{0};
+};
+
+inline Root_io::InputBuffer NumbersView::SeekMember(std::size_t member) const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const std::int16_t *>(nullptr)); break;
+    case 1: io.Skip(i, static_cast<const std::int32_t *>(nullptr)); break;
+    case 2: io.Skip(i, static_cast<const std::int64_t *>(nullptr)); break;
+    case 3: io.Skip(i, static_cast<const std::uint16_t *>(nullptr)); break;
+    case 4: io.Skip(i, static_cast<const std::uint32_t *>(nullptr)); break;
+    case 5: io.Skip(i, static_cast<const std::uint64_t *>(nullptr)); break;
+    case 6: io.Skip(i, static_cast<const std::int8_t *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline std::int16_t NumbersView::a() const {
+  Root_io io;
+  auto i = SeekMember(0);
+  std::int16_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline std::int32_t NumbersView::b() const {
+  Root_io io;
+  auto i = SeekMember(1);
+  std::int32_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline std::int64_t NumbersView::c() const {
+  Root_io io;
+  auto i = SeekMember(2);
+  std::int64_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline std::uint16_t NumbersView::d() const {
+  Root_io io;
+  auto i = SeekMember(3);
+  std::uint16_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline std::uint32_t NumbersView::e() const {
+  Root_io io;
+  auto i = SeekMember(4);
+  std::uint32_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline std::uint64_t NumbersView::f() const {
+  Root_io io;
+  auto i = SeekMember(5);
+  std::uint64_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline std::int8_t NumbersView::g() const {
+  Root_io io;
+  auto i = SeekMember(6);
+  std::int8_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline float NumbersView::h() const {
+  Root_io io;
+  auto i = SeekMember(7);
+  float v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline NumbersView Root_io::MakeView(InputBuffer &i, const Numbers *) {
+  return i.failed ? NumbersView() : NumbersView(i.data + i.pos, i.size - i.pos);
+}
+
+inline NumbersView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<Numbers> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Numbers *>(nullptr)) : NumbersView();
+}
+
+inline Root_io::InputBuffer NameView::SeekMember(std::size_t member) const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const std::string *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline StringView NameView::name() const {
+  Root_io io;
+  auto i = SeekMember(0);
+  return io.MakeView(i, static_cast<const std::string *>(nullptr));
+}
+
+inline std::int32_t NameView::value() const {
+  Root_io io;
+  auto i = SeekMember(1);
+  std::int32_t v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline NameView Root_io::MakeView(InputBuffer &i, const Name *) {
+  return i.failed ? NameView() : NameView(i.data + i.pos, i.size - i.pos);
+}
+
+inline NameView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<Name> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Name *>(nullptr)) : NameView();
+}
+
+inline bool EntryView::is_Defined() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  const auto selection = io.ReadSelection(i, static_cast<const Entry *>(nullptr));
+  return !i.failed && selection != 0;
+}
+
+inline bool EntryView::is_Numbers() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  const auto selection = io.ReadSelection(i, static_cast<const Entry *>(nullptr));
+  return !i.failed && selection == 1;
+}
+
+inline NumbersView EntryView::as_Numbers() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  if (io.ReadSelection(i, static_cast<const Entry *>(nullptr)) != 1 || i.failed)
+    return NumbersView();
+  return i.failed ? NumbersView() : NumbersView(i.data + i.pos, i.size - i.pos);
+}
+
+inline bool EntryView::is_Name() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  const auto selection = io.ReadSelection(i, static_cast<const Entry *>(nullptr));
+  return !i.failed && selection == 2;
+}
+
+inline NameView EntryView::as_Name() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  if (io.ReadSelection(i, static_cast<const Entry *>(nullptr)) != 2 || i.failed)
+    return NameView();
+  return i.failed ? NameView() : NameView(i.data + i.pos, i.size - i.pos);
+}
+
+inline EntryView Root_io::MakeView(InputBuffer &i, const Entry *) {
+  return i.failed ? EntryView() : EntryView(i.data + i.pos, i.size - i.pos);
+}
+
+inline EntryView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<Entry> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Entry *>(nullptr)) : EntryView();
+}
+
+inline Root_io::InputBuffer RootView::SeekMember(std::size_t member) const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const Numbers *>(nullptr)); break;
+    case 1: i.pos = this->names().EndOffset(); i.failed = i.pos >= size_; break;
+    case 2: io.Skip(i, static_cast<const std::vector<std::int32_t> *>(nullptr)); break;
+    case 3: i.pos = this->entries().EndOffset(); i.failed = i.pos >= size_; break;
+    case 4: io.Skip(i, static_cast<const std::shared_ptr<Name> *>(nullptr)); break;
+    case 5: io.Skip(i, static_cast<const std::vector<std::shared_ptr<Name>> *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline NumbersView RootView::numbers() const {
+  auto i = SeekMember(0);
+  return i.failed ? NumbersView() : NumbersView(i.data + i.pos, i.size - i.pos);
+}
+
+inline ListView<Root_io, StringView, std::string> RootView::names() const {
+  Root_io io;
+  auto i = SeekMember(1);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, 1))
+    return ListView<Root_io, StringView, std::string>();
+  return ListView<Root_io, StringView, std::string>(data_, size_, i.pos, s);
+}
+
+inline ArrayView<std::int32_t> RootView::values() const {
+  Root_io io;
+  auto i = SeekMember(2);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, sizeof(std::int32_t)))
+    return ArrayView<std::int32_t>();
+  return ArrayView<std::int32_t>(i.data + i.pos, s);
+}
+
+inline ListView<Root_io, EntryView, Entry> RootView::entries() const {
+  Root_io io;
+  auto i = SeekMember(3);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, 1))
+    return ListView<Root_io, EntryView, Entry>();
+  return ListView<Root_io, EntryView, Entry>(data_, size_, i.pos, s);
+}
+
+inline RootView Root_io::MakeView(InputBuffer &i, const Root *) {
+  return i.failed ? RootView() : RootView(i.data + i.pos, i.size - i.pos);
+}
+
+inline RootView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<Root> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Root *>(nullptr)) : RootView();
+}
+
+inline bool Root_io::ViewRoot(const char *data, std::size_t size, RootView &v) {
+  InputBuffer i{data, size, 0, false, {}};
+  if (!ReadHeader(i))
+    return false;
+  v = RootView(i.data + i.pos, i.size - i.pos);
+  return true;
+}
+
+struct RootWriter {
+  explicit RootWriter(std::ostream &o) : o_(o), out_{o, 0, {}} {
+    header_ = o_.tellp();
+    io_.WriteHeader(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_numbers(const Numbers &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_names() {
+    if (next_ != 1 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_names(std::size_t size) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_names(const std::string &v) {
+    if (next_ != 1 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_names() {
+    if (next_ != 1 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_values() {
+    if (next_ != 2 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_values(std::size_t size) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_values(const std::int32_t &v) {
+    if (next_ != 2 || !open_)
+      return false;
+    io_.WriteValues(out_, &v, 1);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_values() {
+    if (next_ != 2 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_entries() {
+    if (next_ != 3 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_entries(std::size_t size) {
+    if (next_ != 3 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_entries(const Entry &v) {
+    if (next_ != 3 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_entries() {
+    if (next_ != 3 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool write_first(const std::shared_ptr<Name> &v) {
+    if (next_ != 4 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_others() {
+    if (next_ != 5 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_others(std::size_t size) {
+    if (next_ != 5 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_others(const std::shared_ptr<Name> &v) {
+    if (next_ != 5 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_others() {
+    if (next_ != 5 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool write_last(const std::weak_ptr<Name> &v) {
+    if (next_ != 6 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    io_.PatchHeader(o_, header_, out_.references);
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 7;
+
+  std::ostream &o_;
+  Root_io::OutputStream out_;
+  Root_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+  std::streampos header_{-1};
+};
+}
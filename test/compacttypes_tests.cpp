@@ -0,0 +1,277 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "compacttypes.h"
+#include "fuzz.h"
+
+#include <limits>
+#include <sstream>
+
+using namespace Compact;
+
+namespace {
+
+Root testRoot()
+{
+  Root r;
+  r.numbers.a = -2;
+  r.numbers.b = std::numeric_limits<std::int32_t>::min();
+  r.numbers.c = std::numeric_limits<std::int64_t>::max();
+  r.numbers.d = 300;
+  r.numbers.e = std::numeric_limits<std::uint32_t>::max();
+  r.numbers.f = std::numeric_limits<std::uint64_t>::max();
+  r.numbers.g = -1;
+  r.numbers.h = 1.5f;
+  r.names.assign({"a", "bb", ""});
+  r.values.assign({-1, 0, 1});
+  r.entries.emplace_back(r.numbers);
+  r.entries.emplace_back(Name("entry", -64));
+  r.entries.emplace_back();
+  r.first = std::make_shared<Name>("first", 64);
+  r.others.push_back(r.first);
+  r.others.push_back(std::make_shared<Name>("other", 0));
+  r.others.push_back(r.others.back());
+  r.last = r.others.back();
+  return r;
+}
+
+}  // namespace
+
+TEST_CASE("compact wire format test", "[output, compact]")
+{
+  SECTION("reading whats written")
+  {
+    const auto rOut = testRoot();
+
+    std::stringstream sOut;
+    Root_io().WriteRoot(sOut, rOut);
+
+    Root rIn;
+    REQUIRE(Root_io().ReadRoot(sOut, rIn));
+
+    CHECK(rIn.numbers == rOut.numbers);
+    CHECK(rIn.names == rOut.names);
+    CHECK(rIn.values == rOut.values);
+    CHECK(rIn.entries == rOut.entries);
+    REQUIRE(rIn.first);
+    CHECK(*rIn.first == *rOut.first);
+    REQUIRE(rIn.others.size() == 3);
+    CHECK(rIn.others[0] == rIn.first);
+    CHECK(rIn.others[1] == rIn.others[2]);
+    CHECK(rIn.last.lock() == rIn.others[1]);
+  }
+
+  SECTION("buffer, stream and size agree")
+  {
+    const auto r = testRoot();
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, r);
+
+    std::stringstream sOut;
+    Root_io().WriteRoot(sOut, testRoot());
+
+    CHECK(buffer.size() == sOut.str().size());
+    CHECK(Root_io().SerializedSize(testRoot()) == buffer.size());
+
+    Root rIn;
+    REQUIRE(Root_io().ReadRoot(buffer.data(), buffer.size(), rIn));
+    CHECK(rIn.numbers == r.numbers);
+    CHECK(rIn.entries == r.entries);
+
+  }
+
+  SECTION("writing in parallel")
+  {
+    const auto largeRoot = []() {
+      auto r = testRoot();
+      for (int i = 0; i < 3000; ++i)
+      {
+        r.names.push_back(std::to_string(i));
+        r.entries.emplace_back(Name("entry", i));
+      }
+      return r;
+    };
+
+    const auto r = largeRoot();
+
+    std::vector<char> serial;
+    Root_io().WriteRoot(serial, r);
+
+    std::vector<char> buffer;
+    Root_io().WriteRootParallel(buffer, r, 2);
+    CHECK(buffer == serial);
+
+    Root rIn;
+    REQUIRE(Root_io().ReadRoot(buffer.data(), buffer.size(), rIn));
+    CHECK(rIn.names == r.names);
+    CHECK(rIn.entries == r.entries);
+    REQUIRE(rIn.others.size() == 3);
+    CHECK(rIn.others[0] == rIn.first);
+  }
+
+  SECTION("Reading fails with short data")
+  {
+    auto r = testRoot();
+    r.first.reset();
+    r.others.clear();
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, r);
+
+    for (std::size_t size = 0; size < buffer.size(); ++size)
+    {
+      Root rIn;
+      CHECK_FALSE(Root_io().ReadRoot(buffer.data(), size, rIn));
+    }
+  }
+
+  SECTION("visiting whats written")
+  {
+    struct Visitor : RootVisitor
+    {
+      void on_values_element(const int &v) override { values.push_back(v); }
+      void on_entries_element(const Entry &e) override { names += e.is_Name() ? e.as_Name().name : "-"; }
+
+      std::vector<int> values;
+      std::string names;
+    };
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, testRoot());
+
+    Visitor v;
+    REQUIRE(Root_io().VisitRoot(buffer.data(), buffer.size(), v));
+    CHECK(v.values == std::vector<int>({-1, 0, 1}));
+    CHECK(v.names == "-entry-");
+  }
+
+  SECTION("reading whats written incrementally")
+  {
+    const auto rOut = testRoot();
+
+    std::stringstream sOut;
+    RootWriter w(sOut);
+    REQUIRE(w.write_numbers(rOut.numbers));
+    REQUIRE(w.begin_names());
+    for (const auto &name : rOut.names)
+      REQUIRE(w.push_names(name));
+    REQUIRE(w.end_names());
+    REQUIRE(w.begin_values(rOut.values.size()));
+    for (const auto value : rOut.values)
+      REQUIRE(w.push_values(value));
+    REQUIRE(w.end_values());
+    REQUIRE(w.begin_entries());
+    REQUIRE(w.end_entries());
+    REQUIRE(w.write_first(nullptr));
+    REQUIRE(w.begin_others());
+    REQUIRE(w.end_others());
+    REQUIRE(w.write_last(std::weak_ptr<Name>()));
+    REQUIRE(w.done());
+
+    Root rIn;
+    REQUIRE(Root_io().ReadRoot(sOut, rIn));
+    CHECK(rIn.numbers == rOut.numbers);
+    CHECK(rIn.names == rOut.names);
+    CHECK(rIn.values == rOut.values);
+    CHECK(rIn.entries.empty());
+    CHECK(rIn.others.empty());
+  }
+
+  SECTION("viewing whats written")
+  {
+    const auto rOut = testRoot();
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, rOut);
+
+    RootView v;
+    REQUIRE(Root_io().ViewRoot(buffer.data(), buffer.size(), v));
+    CHECK(v.numbers().b() == rOut.numbers.b);
+    CHECK(v.numbers().f() == rOut.numbers.f);
+    CHECK(v.numbers().h() == rOut.numbers.h);
+
+    std::vector<std::string> names;
+    for (const auto &name : v.names())
+      names.push_back(name.str());
+    CHECK(names == rOut.names);
+
+    std::vector<int> values;
+    for (const auto value : v.values())
+      values.push_back(value);
+    CHECK(values == rOut.values);
+
+    REQUIRE(v.entries().size() == 3);
+    CHECK(v.entries()[0].as_Numbers().c() == rOut.numbers.c);
+    CHECK(v.entries()[1].as_Name().name() == std::string("entry"));
+    CHECK(v.entries()[1].as_Name().value() == -64);
+    CHECK_FALSE(v.entries()[2].is_Defined());
+  }
+
+  SECTION("verifying whats written")
+  {
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, testRoot());
+    CHECK(Root_io().VerifyRoot(buffer.data(), buffer.size()));
+
+    CHECK(fuzzRoot(buffer, 5000, &Root_io::VerifyRoot, &Root_io::ReadRoot) == 0);
+  }
+
+  SECTION("small values take one byte")
+  {
+    Name n("", 63);
+    CHECK(Root_io().SerializedSize(n) == 2);
+    n.value = -64;
+    CHECK(Root_io().SerializedSize(n) == 2);
+    n.value = 64;
+    CHECK(Root_io().SerializedSize(n) == 3);
+
+    Entry e(n);
+    CHECK(Root_io().SerializedSize(e) == 4);
+
+    // tables without strings or vectors are encoded member by member as well
+    CHECK(Root_io().SerializedSize(Numbers()) == 7 + sizeof(float));
+  }
+
+  SECTION("Reading fails with wrong data")
+  {
+    Root r;
+
+    std::stringstream s1("CORE0.0");
+    CHECK_FALSE(Root_io().ReadRoot(s1, r));
+
+    const char overlong[] = "CORC\x01" "0.0\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff";
+    CHECK_FALSE(Root_io().ReadRoot(overlong, sizeof(overlong) - 1, r));
+  }
+
+  SECTION("Reading fails with values out of the range of their type")
+  {
+    Root r;
+    r.first = std::make_shared<Name>("first", 1);
+    r.others.push_back(r.first);
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, r);
+
+    // the reference to the first object is the last but one byte, 2^32 + 1 must not wrap around to it
+    REQUIRE(buffer[buffer.size() - 2] == 1);
+    const char wide[] = "\x81\x80\x80\x80\x10";
+    buffer.insert(buffer.end() - 2, wide, wide + sizeof(wide) - 1);
+    buffer.erase(buffer.end() - 2);
+
+    Root rIn;
+    CHECK_FALSE(Root_io().ReadRoot(buffer.data(), buffer.size(), rIn));
+    CHECK_FALSE(Root_io().VerifyRoot(buffer.data(), buffer.size()));
+
+    // the first member is an i16 behind the marker, the version and the shared count, zigzag 2^16 is 32768
+    buffer.clear();
+    Root_io().WriteRoot(buffer, Root());
+    const auto a = buffer.begin() + 8 + sizeof(std::uint32_t);
+    REQUIRE(*a == 0);
+    const char big[] = "\x80\x80\x04";
+    buffer.insert(buffer.erase(a), big, big + sizeof(big) - 1);
+
+    CHECK_FALSE(Root_io().ReadRoot(buffer.data(), buffer.size(), rIn));
+    CHECK_FALSE(Root_io().VerifyRoot(buffer.data(), buffer.size()));
+  }
+}
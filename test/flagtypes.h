@@ -1,288 +1,580 @@
-#pragma once
-
-#include <vector>
-#include <string>
-#include <ostream>
-#include <istream>
-#include <memory>
-#include <array>
-#include <algorithm>
-#include <type_traits>
-
-namespace FlagScope {
-
-template<typename T>
-struct AlwaysFalse : std::false_type {};
-
-struct Dummy;
-
-struct Flags {
-  enum value_t {
-    _none = 0,
-    alpha = 1,
-    beta = 2,
-    gamma = 4,
-    delta = 8,
-  };
-
-  inline Flags(value_t v = _none) : value(v) {}
-
-  bool operator[](const value_t &a) const { return (value & a) == a; }
-  bool operator[](const Flags &a) const { return (value & a.value) == a.value; }
-  friend bool operator==(const Flags &a, const Flags &b) { return a.value == b.value; }
-  friend bool operator!=(const Flags &a, const Flags &b) { return a.value != b.value; }
-
-  std::int8_t value;
-};
-
-inline Flags operator|(Flags::value_t a, Flags::value_t b)
-{
-  return Flags::value_t((static_cast<std::int8_t>(a)) | (static_cast<std::int8_t>(b)));
-}
-inline Flags operator|(const Flags &a, const Flags &b)
-{
-  return Flags::value_t((static_cast<std::int8_t>(a.value)) | (static_cast<std::int8_t>(b.value)));
-}
-inline Flags &operator|=(Flags &a, const Flags &b)
-{
-  return reinterpret_cast<Flags &>((reinterpret_cast<std::int8_t &>(a.value)) |= (static_cast<std::int8_t>(b.value)));
-}
-inline Flags operator&(Flags::value_t a, Flags::value_t b)
-{
-  return Flags::value_t((static_cast<std::int8_t>(a)) & (static_cast<std::int8_t>(b)));
-}
-inline Flags operator&(const Flags &a, const Flags &b)
-{
-  return Flags::value_t((static_cast<std::int8_t>(a.value)) & (static_cast<std::int8_t>(b.value)));
-}
-inline Flags &operator&=(Flags &a, const Flags &b)
-{
-  return reinterpret_cast<Flags &>((reinterpret_cast<std::int8_t &>(a.value)) &= (static_cast<std::int8_t>(b.value)));
-}
-inline Flags operator~(Flags::value_t a) { return Flags::value_t(~static_cast<std::int8_t>(a)); }
-inline Flags operator~(const Flags &a) { return Flags::value_t(~a.value); }
-inline Flags operator^(Flags::value_t a, Flags::value_t b)
-{
-  return Flags::value_t((static_cast<std::int8_t>(a)) ^ (static_cast<std::int8_t>(b)));
-}
-inline Flags operator^(const Flags &a, const Flags &b)
-{
-  return Flags::value_t((static_cast<std::int8_t>(a.value)) ^ (static_cast<std::int8_t>(b.value)));
-}
-inline Flags &operator^=(Flags &a, const Flags &b)
-{
-  return reinterpret_cast<Flags &>((reinterpret_cast<std::int8_t &>(a.value)) ^= (static_cast<std::int8_t>(b.value)));
-}
-inline bool operator<(const Flags &a, const Flags &b)
-{
-  return a.value < b.value;
-}
-inline bool operator>(const Flags &a, const Flags &b)
-{
-  return a.value > b.value;
-}
-inline bool operator>=(const Flags &a, const Flags &b)
-{
-  return a.value >= b.value;
-}
-inline bool operator<=(const Flags &a, const Flags &b)
-{
-  return a.value <= b.value;
-}
-
-inline const std::array<Flags::value_t, 4> &FlagsValues()
-{
-  static const std::array<Flags::value_t, 4> values{{
-      Flags::alpha,
-      Flags::beta,
-      Flags::gamma,
-      Flags::delta,
-  }};
-  return values;
-};
-
-inline const char *ValueName(const Flags::value_t &v)
-{
-  switch (v)
-  {
-    default:
-      break;
-    case Flags::alpha:
-      return "alpha";
-    case Flags::beta:
-      return "beta";
-    case Flags::gamma:
-      return "gamma";
-    case Flags::delta:
-      return "delta";
-  }
-  return "<error>";
-};
-struct Dummy {
-  Flags en1;
-  Flags en2{FlagScope::Flags::gamma};
-  std::vector<Flags> en3;
-
-  Dummy() = default;
-
-  friend bool operator==(const Dummy&l, const Dummy&r) {
-    return 
-      l.en1 == r.en1
-      && l.en2 == r.en2
-      && l.en3 == r.en3;
-  }
-
-  friend bool operator!=(const Dummy&l, const Dummy&r) {
-    return 
-      l.en1 != r.en1
-      || l.en2 != r.en2
-      || l.en3 != r.en3;
-  }
-
-  template<class T> void fill_en3(const T &v) {
-    std::fill(en3.begin(), en3.end(), v);
-  }
-
-  template<class Generator> void generate_en3(Generator gen) {
-    std::generate(en3.begin(), en3.end(), gen);
-  }
-
-  template<class T> std::vector<Flags>::iterator remove_en3(const T &v) {
-    return std::remove(en3.begin(), en3.end(), v);
-  }
-  template<class Pred> std::vector<Flags>::iterator remove_en3_if(Pred v) {
-    return std::remove_if(en3.begin(), en3.end(), v);
-  }
-
-  template<class T> void erase_en3(const T &v) {
-    en3.erase(remove_en3(v));
-  }
-  template<class Pred> void erase_en3_if(Pred v) {
-    en3.erase(remove_en3_if(v));
-  }
-
-  void reverse_en3() {
-    std::reverse(en3.begin(), en3.end());
-  }
-
-  void rotate_en3(std::vector<Flags>::iterator i) {
-    std::rotate(en3.begin(), i, en3.end());
-  }
-
-  void sort_en3() {
-    std::sort(en3.begin(), en3.end());
-  }
-  template<class Comp> void sort_en3(Comp p) {
-    std::sort(en3.begin(), en3.end(), p);
-  }
-
-  template<class Comp> bool any_of_en3(Comp p) {
-    return std::any_of(en3.begin(), en3.end(), p);
-  }
-  template<class T> bool any_of_en3_is(const T &p) {
-    return any_of_en3([&p](const Flags &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_en3(Comp p) {
-    return std::all_of(en3.begin(), en3.end(), p);
-  }
-  template<class T> bool all_of_en3_are(const T &p) {
-    return all_of_en3([&p](const Flags &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_en3(Comp p) {
-    return std::none_of(en3.begin(), en3.end(), p);
-  }
-  template<class T> bool none_of_en3_is(const T &p) {
-    return none_of_en3([&p](const Flags &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_en3(Fn p) {
-    return std::for_each(en3.begin(), en3.end(), p);
-  }
-
-  template<class T> std::vector<Flags>::iterator find_in_en3(const T &p) {
-    return std::find(en3.begin(), en3.end(), p);
-  }
-  template<class Comp> std::vector<Flags>::iterator find_in_en3_if(Comp p) {
-    return std::find_if(en3.begin(), en3.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<Flags>::iterator>::difference_type count_in_en3(const T &p) {
-    return std::count(en3.begin(), en3.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<Flags>::iterator>::difference_type count_in_en3_if(Comp p) {
-    return std::count_if(en3.begin(), en3.end(), p);
-  }
-};
-
-struct Dummy_io {
-private:
-  template<typename T> void Write(std::ostream &, const T *) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &o, const T &v) {
-    o.write(reinterpret_cast<const char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<T> &v) {
-    Write(o, v.size());
-    o.write(reinterpret_cast<const char *>(v.data()), sizeof(T) * v.size());
-  }
-
-  template<typename T> void Write(std::ostream &, const std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &i, T &v) {
-    i.read(reinterpret_cast<char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Read(std::istream &, std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &i, std::vector<T> &v) {
-    typename std::vector<T>::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(reinterpret_cast<char *>(v.data()), sizeof(T) * s);
-  }
-
-  void Write(std::ostream &o, const Dummy &v) {
-    Write(o, v.en1);
-    Write(o, v.en2);
-    Write(o, v.en3);
-  }
-
-  void Read(std::istream &s, Dummy &v) {
-    Read(s, v.en1);
-    Read(s, v.en2);
-    Read(s, v.en3);
-  }
-
-public:
-  void WriteDummy(std::ostream &o, const Dummy &v) {
-
-    o.write("CORE", 4);
-    o.write("0.0", 3);
-    Write(o, v);
-  }
-
-  bool ReadDummy(std::istream &i, Dummy &v) {
-
-    std::string marker("0000");
-    i.read(&marker[0], 4);
-    if (marker != "CORE")
-      return false;
-    std::string version(3, '_');
-    i.read(&version[0], 3);
-    if (version != "0.0")
-      return false;
-    Read(i, v);
-    return true;
-  }
-
-};
-}
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+
+namespace FlagScope {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+struct Dummy;
+
+struct Flags {
+  enum value_t {
+    _none = 0,
+    alpha = 1,
+    beta = 2,
+    gamma = 4,
+    delta = 8,
+  };
+
+  inline Flags(value_t v = _none) : value(v) {}
+
+  bool operator[](const value_t &a) const { return (value & a) == a; }
+  bool operator[](const Flags &a) const { return (value & a.value) == a.value; }
+  friend bool operator==(const Flags &a, const Flags &b) { return a.value == b.value; }
+  friend bool operator!=(const Flags &a, const Flags &b) { return a.value != b.value; }
+
+  std::int8_t value;
+};
+
+inline Flags operator|(Flags::value_t a, Flags::value_t b)
+{
+  return Flags::value_t((static_cast<std::int8_t>(a)) | (static_cast<std::int8_t>(b)));
+}
+inline Flags operator|(const Flags &a, const Flags &b)
+{
+  return Flags::value_t((static_cast<std::int8_t>(a.value)) | (static_cast<std::int8_t>(b.value)));
+}
+inline Flags &operator|=(Flags &a, const Flags &b)
+{
+  return reinterpret_cast<Flags &>((reinterpret_cast<std::int8_t &>(a.value)) |= (static_cast<std::int8_t>(b.value)));
+}
+inline Flags operator&(Flags::value_t a, Flags::value_t b)
+{
+  return Flags::value_t((static_cast<std::int8_t>(a)) & (static_cast<std::int8_t>(b)));
+}
+inline Flags operator&(const Flags &a, const Flags &b)
+{
+  return Flags::value_t((static_cast<std::int8_t>(a.value)) & (static_cast<std::int8_t>(b.value)));
+}
+inline Flags &operator&=(Flags &a, const Flags &b)
+{
+  return reinterpret_cast<Flags &>((reinterpret_cast<std::int8_t &>(a.value)) &= (static_cast<std::int8_t>(b.value)));
+}
+inline Flags operator~(Flags::value_t a) { return Flags::value_t(~static_cast<std::int8_t>(a)); }
+inline Flags operator~(const Flags &a) { return Flags::value_t(~a.value); }
+inline Flags operator^(Flags::value_t a, Flags::value_t b)
+{
+  return Flags::value_t((static_cast<std::int8_t>(a)) ^ (static_cast<std::int8_t>(b)));
+}
+inline Flags operator^(const Flags &a, const Flags &b)
+{
+  return Flags::value_t((static_cast<std::int8_t>(a.value)) ^ (static_cast<std::int8_t>(b.value)));
+}
+inline Flags &operator^=(Flags &a, const Flags &b)
+{
+  return reinterpret_cast<Flags &>((reinterpret_cast<std::int8_t &>(a.value)) ^= (static_cast<std::int8_t>(b.value)));
+}
+inline bool operator<(const Flags &a, const Flags &b)
+{
+  return a.value < b.value;
+}
+inline bool operator>(const Flags &a, const Flags &b)
+{
+  return a.value > b.value;
+}
+inline bool operator>=(const Flags &a, const Flags &b)
+{
+  return a.value >= b.value;
+}
+inline bool operator<=(const Flags &a, const Flags &b)
+{
+  return a.value <= b.value;
+}
+
+inline const std::array<Flags::value_t, 4> &FlagsValues()
+{
+  static const std::array<Flags::value_t, 4> values{{
+      Flags::alpha,
+      Flags::beta,
+      Flags::gamma,
+      Flags::delta,
+  }};
+  return values;
+};
+
+inline const char *ValueName(const Flags::value_t &v)
+{
+  switch (v)
+  {
+    default:
+      break;
+    case Flags::alpha:
+      return "alpha";
+    case Flags::beta:
+      return "beta";
+    case Flags::gamma:
+      return "gamma";
+    case Flags::delta:
+      return "delta";
+  }
+  return "<error>";
+};
+struct Dummy {
+  Flags en1;
+  Flags en2{FlagScope::Flags::gamma};
+  std::vector<Flags> en3;
+
+  Dummy() = default;
+
+  friend bool operator==(const Dummy&l, const Dummy&r) {
+    return 
+      l.en1 == r.en1
+      && l.en2 == r.en2
+      && l.en3 == r.en3;
+  }
+
+  friend bool operator!=(const Dummy&l, const Dummy&r) {
+    return 
+      l.en1 != r.en1
+      || l.en2 != r.en2
+      || l.en3 != r.en3;
+  }
+
+  template<class T> void fill_en3(const T &v) {
+    std::fill(en3.begin(), en3.end(), v);
+  }
+
+  template<class Generator> void generate_en3(Generator gen) {
+    std::generate(en3.begin(), en3.end(), gen);
+  }
+
+  template<class T> std::vector<Flags>::iterator remove_en3(const T &v) {
+    return std::remove(en3.begin(), en3.end(), v);
+  }
+  template<class Pred> std::vector<Flags>::iterator remove_en3_if(Pred v) {
+    return std::remove_if(en3.begin(), en3.end(), v);
+  }
+
+  template<class T> void erase_en3(const T &v) {
+    en3.erase(remove_en3(v));
+  }
+  template<class Pred> void erase_en3_if(Pred v) {
+    en3.erase(remove_en3_if(v));
+  }
+
+  void reverse_en3() {
+    std::reverse(en3.begin(), en3.end());
+  }
+
+  void rotate_en3(std::vector<Flags>::iterator i) {
+    std::rotate(en3.begin(), i, en3.end());
+  }
+
+  void sort_en3() {
+    std::sort(en3.begin(), en3.end());
+  }
+  template<class Comp> void sort_en3(Comp p) {
+    std::sort(en3.begin(), en3.end(), p);
+  }
+
+  template<class Comp> bool any_of_en3(Comp p) {
+    return std::any_of(en3.begin(), en3.end(), p);
+  }
+  template<class T> bool any_of_en3_is(const T &p) {
+    return any_of_en3([&p](const Flags &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_en3(Comp p) {
+    return std::all_of(en3.begin(), en3.end(), p);
+  }
+  template<class T> bool all_of_en3_are(const T &p) {
+    return all_of_en3([&p](const Flags &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_en3(Comp p) {
+    return std::none_of(en3.begin(), en3.end(), p);
+  }
+  template<class T> bool none_of_en3_is(const T &p) {
+    return none_of_en3([&p](const Flags &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_en3(Fn p) {
+    return std::for_each(en3.begin(), en3.end(), p);
+  }
+
+  template<class T> std::vector<Flags>::iterator find_in_en3(const T &p) {
+    return std::find(en3.begin(), en3.end(), p);
+  }
+  template<class Comp> std::vector<Flags>::iterator find_in_en3_if(Comp p) {
+    return std::find_if(en3.begin(), en3.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<Flags>::iterator>::difference_type count_in_en3(const T &p) {
+    return std::count(en3.begin(), en3.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<Flags>::iterator>::difference_type count_in_en3_if(Comp p) {
+    return std::count_if(en3.begin(), en3.end(), p);
+  }
+};
+
+struct Dummy_io {
+  friend struct DummyWriter;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename O> void Write(O &o, const Dummy &v) const {
+    Write(o, v.en1);
+    Write(o, v.en2);
+    Write(o, v.en3);
+  }
+
+  template<typename I> void Read(I &s, Dummy &v) {
+    Read(s, v.en1);
+    Read(s, v.en2);
+    Read(s, v.en3);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.0", 3);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    return std::memcmp(version, "0.0", 3) == 0;
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteDummy(std::ostream &o, const Dummy &v) const {
+
+    OutputStream s{o, 0};
+    WriteHeader(s);
+    Write(s, v);
+  }
+
+  void WriteDummy(std::vector<char> &b, const Dummy &v) const {
+
+    OutputBuffer o{b, b.size()};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+  }
+
+  bool ReadDummy(std::istream &stream, Dummy &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadDummy(const char *data, std::size_t size, Dummy &v) {
+
+    InputBuffer i{data, size, 0, false};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  std::size_t SerializedSize(const Dummy &v) const {
+    OutputCounter c{0};
+    WriteHeader(c);
+    Write(c, v);
+    return c.size;
+  }
+
+};
+
+struct DummyWriter {
+  explicit DummyWriter(std::ostream &o) : o_(o), out_{o, 0} {
+    io_.WriteHeader(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_en1(const Flags &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_en2(const Flags &v) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_en3() {
+    if (next_ != 2 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_en3(std::size_t size) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_en3(const Flags &v) {
+    if (next_ != 2 || !open_)
+      return false;
+    io_.WriteValues(out_, &v, 1);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_en3() {
+    if (next_ != 2 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 3;
+
+  std::ostream &o_;
+  Dummy_io::OutputStream out_;
+  Dummy_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+};
+}
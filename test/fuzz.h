@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Flips random bits in copies of valid data and counts the copies that pass verify() but fail read(), which should
+// never happen. Every cut off copy of the data has to fail verify().
+template <typename Verify, typename Read>
+std::size_t fuzz(const std::vector<char> &data, std::size_t rounds, Verify verify, Read read)
+{
+  std::mt19937 random(static_cast<std::mt19937::result_type>(data.size()));
+  std::size_t mismatches = 0;
+  for (std::size_t n = 0; n < rounds; ++n)
+  {
+    auto broken = data;
+    for (auto flips = 1 + random() % 4; flips != 0; --flips)
+      broken[random() % broken.size()] ^= static_cast<char>(1 << (random() % 8));
+    if (verify(broken) && !read(broken))
+      ++mismatches;
+  }
+  for (std::size_t size = 0; size < data.size(); size += 1 + data.size() / 64)
+    if (verify(std::vector<char>(data.begin(), data.begin() + size)))
+      ++mismatches;
+  return mismatches;
+}
+
+// Fuzzes the span verifier and reader of a root type, every try uses fresh io structs. The optional parallel reader
+// has to accept the same data with two threads.
+template <typename Io, typename Root>
+std::size_t fuzzRoot(const std::vector<char> &data, std::size_t rounds, bool (Io::*verify)(const char *, std::size_t),
+                     bool (Io::*read)(const char *, std::size_t, Root &),
+                     bool (Io::*readParallel)(const char *, std::size_t, Root &, unsigned int) = nullptr)
+{
+  return fuzz(data, rounds, [verify](const std::vector<char> &d) { return (Io().*verify)(d.data(), d.size()); },
+              [read, readParallel](const std::vector<char> &d) {
+                Root r;
+                if (!(Io().*read)(d.data(), d.size(), r))
+                  return false;
+                return !readParallel || (Io().*readParallel)(d.data(), d.size(), r, 2);
+              });
+}
@@ -1,449 +1,3601 @@
-#pragma once
-
-#include <vector>
-#include <string>
-#include <ostream>
-#include <istream>
-#include <memory>
-#include <array>
-#include <algorithm>
-#include <type_traits>
-
-namespace Example {
-namespace Game {
-
-template<typename T>
-struct AlwaysFalse : std::false_type {};
-
-struct Spell;
-struct Technique;
-struct Ability;
-struct Hero;
-
-struct Spell {
-  float manaCost{0.0f};
-  float cooldown{0.0f};
-
-  Spell() = default;
-
-  friend bool operator==(const Spell&l, const Spell&r) {
-    return 
-      l.manaCost == r.manaCost
-      && l.cooldown == r.cooldown;
-  }
-
-  friend bool operator!=(const Spell&l, const Spell&r) {
-    return 
-      l.manaCost != r.manaCost
-      || l.cooldown != r.cooldown;
-  }
-};
-
-struct Technique {
-  float damage{0.0f};
-  float strength{0.0f};
-
-  Technique() = default;
-
-  friend bool operator==(const Technique&l, const Technique&r) {
-    return 
-      l.damage == r.damage
-      && l.strength == r.strength;
-  }
-
-  friend bool operator!=(const Technique&l, const Technique&r) {
-    return 
-      l.damage != r.damage
-      || l.strength != r.strength;
-  }
-};
-
-struct Ability {
-  Ability() = default;
-  Ability(const Ability &o) { _clone(o); }
-  Ability& operator=(const Ability &o) { _destroy(); _clone(o); return *this; }
-
-  Ability(const Spell &v)
-    : _Spell(new Spell(v))
-    , _selection(_Spell_selection)
-  {}
-  Ability(Spell &&v)
-    : _Spell(new Spell(std::forward<Spell>(v)))
-    , _selection(_Spell_selection)
-  {}
-  Ability & operator=(const Spell &v) {
-    _destroy();
-    _Spell = new Spell(v);
-    _selection = _Spell_selection;
-    return *this;
-  }
-  Ability & operator=(Spell &&v) {
-    _destroy();
-    _Spell = new Spell(std::forward<Spell>(v));
-    _selection = _Spell_selection;
-    return *this;
-  }
-
-  Ability(const Technique &v)
-    : _Technique(new Technique(v))
-    , _selection(_Technique_selection)
-  {}
-  Ability(Technique &&v)
-    : _Technique(new Technique(std::forward<Technique>(v)))
-    , _selection(_Technique_selection)
-  {}
-  Ability & operator=(const Technique &v) {
-    _destroy();
-    _Technique = new Technique(v);
-    _selection = _Technique_selection;
-    return *this;
-  }
-  Ability & operator=(Technique &&v) {
-    _destroy();
-    _Technique = new Technique(std::forward<Technique>(v));
-    _selection = _Technique_selection;
-    return *this;
-  }
-
-  ~Ability() {
-    _destroy();
-  }
-
-  bool is_Defined() const noexcept { return _selection != no_selection; }
-  void clear() { *this = Ability(); }
-
-  bool is_Spell() const noexcept { return _selection == _Spell_selection; }
-  const Spell & as_Spell() const noexcept { return *_Spell; }
-  Spell & as_Spell() { return *_Spell; }
-  template<typename... Args> Spell & create_Spell(Args&&... args) {
-    return (*this = Spell(std::forward<Args>(args)...)).as_Spell();
-  }
-
-  bool is_Technique() const noexcept { return _selection == _Technique_selection; }
-  const Technique & as_Technique() const noexcept { return *_Technique; }
-  Technique & as_Technique() { return *_Technique; }
-  template<typename... Args> Technique & create_Technique(Args&&... args) {
-    return (*this = Technique(std::forward<Args>(args)...)).as_Technique();
-  }
-
-  friend bool operator==(const Ability&ab, const Spell &o) noexcept  { return ab.is_Spell() && ab.as_Spell() == o; }
-  friend bool operator==(const Spell &o, const Ability&ab) noexcept  { return ab.is_Spell() && o == ab.as_Spell(); }
-  friend bool operator!=(const Ability&ab, const Spell &o) noexcept  { return !ab.is_Spell() || ab.as_Spell() != o; }
-  friend bool operator!=(const Spell &o, const Ability&ab) noexcept  { return !ab.is_Spell() || o != ab.as_Spell(); }
-
-  friend bool operator==(const Ability&ab, const Technique &o) noexcept  { return ab.is_Technique() && ab.as_Technique() == o; }
-  friend bool operator==(const Technique &o, const Ability&ab) noexcept  { return ab.is_Technique() && o == ab.as_Technique(); }
-  friend bool operator!=(const Ability&ab, const Technique &o) noexcept  { return !ab.is_Technique() || ab.as_Technique() != o; }
-  friend bool operator!=(const Technique &o, const Ability&ab) noexcept  { return !ab.is_Technique() || o != ab.as_Technique(); }
-
-  bool operator==(const Ability &o) const noexcept
-  {
-    if (this == &o)
-      return true;
-    if (_selection != o._selection)
-      return false;
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ return true;
-    case _Spell_selection: return *_Spell == *o._Spell;
-    case _Technique_selection: return *_Technique == *o._Technique;
-    }
-    return false; // without this line there is a msvc warning I do not understand.
-  }
-
-  bool operator!=(const Ability &o) const noexcept
-  {
-    if (this == &o)
-      return false;
-    if (_selection != o._selection)
-      return true;
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ return false;
-    case _Spell_selection: return *_Spell != *o._Spell;
-    case _Technique_selection: return *_Technique != *o._Technique;
-    }
-    return false; // without this line there is a msvc warning I do not understand.
-  }
-
-private:
-  void _clone(const Ability &o) noexcept
-  {
-     _selection = o._selection;
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ break;
-    case _Spell_selection: _Spell = new Spell(*o._Spell); break;
-    case _Technique_selection: _Technique = new Technique(*o._Technique); break;
-    }
-  }
-
-  void _destroy() noexcept {
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ break;
-    case _Spell_selection: delete _Spell; break;
-    case _Technique_selection: delete _Technique; break;
-    }
-    no_value = nullptr;
-  }
-
-  union {
-    struct NoValue_t *no_value{nullptr};
-    Spell * _Spell;
-    Technique * _Technique;
-  };
-
-  enum Selection_t {
-    no_selection,
-    _Spell_selection,
-    _Technique_selection,
-  };
-
-  Selection_t _selection{no_selection};
-  friend struct Hero_io;
-};
-
-enum class Category : std::int8_t {
-  Carries = 0,
-  Jungler = 1,
-  Initiator = 2,
-  Support = 3,
-};
-
-inline const std::array<Category,4> & CategoryValues() {
-  static const std::array<Category,4> values {{
-    Category::Carries,
-    Category::Jungler,
-    Category::Initiator,
-    Category::Support,
-  }};
-  return values;
-};
-
-inline const char * ValueName(const Category &v) {
-  switch(v) {
-    case Category::Carries: return "Carries";
-    case Category::Jungler: return "Jungler";
-    case Category::Initiator: return "Initiator";
-    case Category::Support: return "Support";
-  }
-  return "<error>";
-};
-
-struct Hero {
-  std::string name;
-  Category category{Example::Game::Category::Carries};
-  float health{0.0f};
-  float mana{0.0f};
-  std::vector<Ability> abilities;
-
-  Hero() = default;
-
-  friend bool operator==(const Hero&l, const Hero&r) {
-    return 
-      l.name == r.name
-      && l.category == r.category
-      && l.health == r.health
-      && l.mana == r.mana
-      && l.abilities == r.abilities;
-  }
-
-  friend bool operator!=(const Hero&l, const Hero&r) {
-    return 
-      l.name != r.name
-      || l.category != r.category
-      || l.health != r.health
-      || l.mana != r.mana
-      || l.abilities != r.abilities;
-  }
-
-  template<class T> void fill_abilities(const T &v) {
-    std::fill(abilities.begin(), abilities.end(), v);
-  }
-
-  template<class Generator> void generate_abilities(Generator gen) {
-    std::generate(abilities.begin(), abilities.end(), gen);
-  }
-
-  template<class T> std::vector<Ability>::iterator remove_abilities(const T &v) {
-    return std::remove(abilities.begin(), abilities.end(), v);
-  }
-  template<class Pred> std::vector<Ability>::iterator remove_abilities_if(Pred v) {
-    return std::remove_if(abilities.begin(), abilities.end(), v);
-  }
-
-  template<class T> void erase_abilities(const T &v) {
-    abilities.erase(remove_abilities(v));
-  }
-  template<class Pred> void erase_abilities_if(Pred v) {
-    abilities.erase(remove_abilities_if(v));
-  }
-
-  void reverse_abilities() {
-    std::reverse(abilities.begin(), abilities.end());
-  }
-
-  void rotate_abilities(std::vector<Ability>::iterator i) {
-    std::rotate(abilities.begin(), i, abilities.end());
-  }
-
-  template<class Comp> void sort_abilities(Comp p) {
-    std::sort(abilities.begin(), abilities.end(), p);
-  }
-
-  template<class Comp> bool any_of_abilities(Comp p) {
-    return std::any_of(abilities.begin(), abilities.end(), p);
-  }
-  template<class T> bool any_of_abilities_is(const T &p) {
-    return any_of_abilities([&p](const Ability &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_abilities(Comp p) {
-    return std::all_of(abilities.begin(), abilities.end(), p);
-  }
-  template<class T> bool all_of_abilities_are(const T &p) {
-    return all_of_abilities([&p](const Ability &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_abilities(Comp p) {
-    return std::none_of(abilities.begin(), abilities.end(), p);
-  }
-  template<class T> bool none_of_abilities_is(const T &p) {
-    return none_of_abilities([&p](const Ability &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_abilities(Fn p) {
-    return std::for_each(abilities.begin(), abilities.end(), p);
-  }
-
-  template<class T> std::vector<Ability>::iterator find_in_abilities(const T &p) {
-    return std::find(abilities.begin(), abilities.end(), p);
-  }
-  template<class Comp> std::vector<Ability>::iterator find_in_abilities_if(Comp p) {
-    return std::find_if(abilities.begin(), abilities.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<Ability>::iterator>::difference_type count_in_abilities(const T &p) {
-    return std::count(abilities.begin(), abilities.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<Ability>::iterator>::difference_type count_in_abilities_if(Comp p) {
-    return std::count_if(abilities.begin(), abilities.end(), p);
-  }
-};
-
-struct Hero_io {
-private:
-  template<typename T> void Write(std::ostream &, const T *) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &o, const T &v) {
-    o.write(reinterpret_cast<const char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<T> &v) {
-    Write(o, v.size());
-    o.write(reinterpret_cast<const char *>(v.data()), sizeof(T) * v.size());
-  }
-
-  template<typename T> void Write(std::ostream &, const std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  void Write(std::ostream &o, const std::string &v) {
-    Write(o, v.size());
-    o.write(v.data(), v.size());
-  }
-
-  template<typename T> void Read(std::istream &i, T &v) {
-    i.read(reinterpret_cast<char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Read(std::istream &, std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &i, std::vector<T> &v) {
-    typename std::vector<T>::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(reinterpret_cast<char *>(v.data()), sizeof(T) * s);
-  }
-
-  void Read(std::istream &i, std::string &v) {
-    std::string::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(&v[0], s);
-  }
-
-  void Write(std::ostream &o, const Ability &v) {
-    o.write(reinterpret_cast<const char*>(&v._selection), sizeof(Ability::Selection_t));
-    switch(v._selection) {
-    case Ability::no_selection: while(false); /* hack for coverage tool */ break;
-    case Ability::_Spell_selection: Write(o, v.as_Spell()); break;
-    case Ability::_Technique_selection: Write(o, v.as_Technique()); break;
-    }
-  }
-
-  void Write(std::ostream &o, const std::vector<Ability> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  void Read(std::istream &i, Ability &v) {
-    i.read(reinterpret_cast<char*>(&v._selection), sizeof(Ability::Selection_t));
-    switch(v._selection) {
-    case Ability::no_selection: while(false); /* hack for coverage tool */ break;
-    case Ability::_Spell_selection: Read(i, v.create_Spell()); break;
-    case Ability::_Technique_selection: Read(i, v.create_Technique()); break;
-    }
-  }
-
-  void Read(std::istream &s, std::vector<Ability> &v) {
-    auto size = v.size();
-    Read(s, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(s, entry);
-  }
-
-  void Write(std::ostream &o, const Hero &v) {
-    Write(o, v.name);
-    Write(o, v.category);
-    Write(o, v.health);
-    Write(o, v.mana);
-    Write(o, v.abilities);
-  }
-
-  void Read(std::istream &s, Hero &v) {
-    Read(s, v.name);
-    Read(s, v.category);
-    Read(s, v.health);
-    Read(s, v.mana);
-    Read(s, v.abilities);
-  }
-
-public:
-  void WriteHero(std::ostream &o, const Hero &v) {
-
-    o.write("CORE", 4);
-    o.write("0.1", 3);
-    Write(o, v);
-  }
-
-  bool ReadHero(std::istream &i, Hero &v) {
-
-    std::string marker("0000");
-    i.read(&marker[0], 4);
-    if (marker != "CORE")
-      return false;
-    std::string version(3, '_');
-    i.read(&version[0], 3);
-    if (version != "0.1")
-      return false;
-    Read(i, v);
-    return true;
-  }
-
-};
-}
-}
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <new>
+#include <bitset>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#ifndef COREBUFFER_IO_URING
+#define COREBUFFER_IO_URING 1
+#endif
+#endif
+#endif
+#else
+#include <fstream>
+#endif
+
+namespace Example {
+namespace Game {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+class ChangedElements {
+public:
+  void mark(std::size_t first, std::size_t last) {
+    if (first >= last)
+      return;
+    if (words_.size() < (last + 63) / 64)
+      words_.resize((last + 63) / 64);
+    for (auto n = first; n < last;) {
+      if (n % 64 == 0 && last - n >= 64) {
+        words_[n / 64] = ~std::uint64_t(0);
+        n += 64;
+      } else {
+        words_[n / 64] |= std::uint64_t(1) << (n % 64);
+        ++n;
+      }
+    }
+  }
+
+  void clear() {
+    words_.clear();
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> runs(std::size_t size) const {
+    std::vector<std::pair<std::size_t, std::size_t>> r;
+    const auto end = std::min(size, words_.size() * 64);
+    for (std::size_t n = 0; n < end;) {
+      if (n % 64 == 0 && words_[n / 64] == 0) {
+        n += 64;
+        continue;
+      }
+      if (!test(n)) {
+        ++n;
+        continue;
+      }
+      const auto first = n;
+      while (n < end && test(n))
+        ++n;
+      r.emplace_back(first, n);
+    }
+    return r;
+  }
+
+private:
+  bool test(std::size_t n) const {
+    return (words_[n / 64] >> (n % 64)) & 1;
+  }
+
+  std::vector<std::uint64_t> words_;
+};
+
+
+struct Spell;
+struct Technique;
+struct Ability;
+struct Hero;
+
+struct Spell {
+  float manaCost{0.0f};
+  float cooldown{0.0f};
+
+  Spell() = default;
+
+  friend bool operator==(const Spell&l, const Spell&r) {
+    return 
+      l.manaCost == r.manaCost
+      && l.cooldown == r.cooldown;
+  }
+
+  friend bool operator!=(const Spell&l, const Spell&r) {
+    return 
+      l.manaCost != r.manaCost
+      || l.cooldown != r.cooldown;
+  }
+};
+
+struct Technique {
+  float damage{0.0f};
+  float strength{0.0f};
+
+  Technique() = default;
+
+  friend bool operator==(const Technique&l, const Technique&r) {
+    return 
+      l.damage == r.damage
+      && l.strength == r.strength;
+  }
+
+  friend bool operator!=(const Technique&l, const Technique&r) {
+    return 
+      l.damage != r.damage
+      || l.strength != r.strength;
+  }
+};
+
+struct Ability {
+  Ability() = default;
+  Ability(const Ability &o) { _clone(o); }
+  Ability& operator=(const Ability &o) {
+    if (this != &o)
+      *this = Ability(o);
+    return *this;
+  }
+  Ability(Ability &&o) noexcept { _move(o); }
+  Ability& operator=(Ability &&o) noexcept {
+    if (this != &o) {
+      _destroy();
+      _move(o);
+    }
+    return *this;
+  }
+
+  Ability(const Spell &v)
+    : _selection(_Spell_selection)
+  { _construct<Spell>(v); }
+  Ability(Spell &&v)
+    : _selection(_Spell_selection)
+  { _construct<Spell>(std::forward<Spell>(v)); }
+  Ability & operator=(const Spell &v) {
+    create_Spell(v);
+    return *this;
+  }
+  Ability & operator=(Spell &&v) {
+    create_Spell(std::forward<Spell>(v));
+    return *this;
+  }
+
+  Ability(const Technique &v)
+    : _selection(_Technique_selection)
+  { _construct<Technique>(v); }
+  Ability(Technique &&v)
+    : _selection(_Technique_selection)
+  { _construct<Technique>(std::forward<Technique>(v)); }
+  Ability & operator=(const Technique &v) {
+    create_Technique(v);
+    return *this;
+  }
+  Ability & operator=(Technique &&v) {
+    create_Technique(std::forward<Technique>(v));
+    return *this;
+  }
+
+  ~Ability() {
+    _destroy();
+  }
+
+  bool is_Defined() const noexcept { return _selection != no_selection; }
+  void clear() { *this = Ability(); }
+  void swap(Ability &o) noexcept {
+    Ability t(std::move(o));
+    o = std::move(*this);
+    *this = std::move(t);
+  }
+  friend void swap(Ability &l, Ability &r) noexcept { l.swap(r); }
+
+  bool is_Spell() const noexcept { return _selection == _Spell_selection; }
+  const Spell & as_Spell() const noexcept { return *_get<Spell>(); }
+  Spell & as_Spell() { return *_get<Spell>(); }
+  template<typename... Args> Spell & create_Spell(Args&&... args) {
+    _replace<Spell>(std::forward<Args>(args)...);
+    _selection = _Spell_selection;
+    return as_Spell();
+  }
+
+  bool is_Technique() const noexcept { return _selection == _Technique_selection; }
+  const Technique & as_Technique() const noexcept { return *_get<Technique>(); }
+  Technique & as_Technique() { return *_get<Technique>(); }
+  template<typename... Args> Technique & create_Technique(Args&&... args) {
+    _replace<Technique>(std::forward<Args>(args)...);
+    _selection = _Technique_selection;
+    return as_Technique();
+  }
+
+  friend bool operator==(const Ability&ab, const Spell &o) noexcept  { return ab.is_Spell() && ab.as_Spell() == o; }
+  friend bool operator==(const Spell &o, const Ability&ab) noexcept  { return ab.is_Spell() && o == ab.as_Spell(); }
+  friend bool operator!=(const Ability&ab, const Spell &o) noexcept  { return !ab.is_Spell() || ab.as_Spell() != o; }
+  friend bool operator!=(const Spell &o, const Ability&ab) noexcept  { return !ab.is_Spell() || o != ab.as_Spell(); }
+
+  friend bool operator==(const Ability&ab, const Technique &o) noexcept  { return ab.is_Technique() && ab.as_Technique() == o; }
+  friend bool operator==(const Technique &o, const Ability&ab) noexcept  { return ab.is_Technique() && o == ab.as_Technique(); }
+  friend bool operator!=(const Ability&ab, const Technique &o) noexcept  { return !ab.is_Technique() || ab.as_Technique() != o; }
+  friend bool operator!=(const Technique &o, const Ability&ab) noexcept  { return !ab.is_Technique() || o != ab.as_Technique(); }
+
+  bool operator==(const Ability &o) const noexcept
+  {
+    if (this == &o)
+      return true;
+    if (_selection != o._selection)
+      return false;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return true;
+    case _Spell_selection: return *_get<Spell>() == *o._get<Spell>();
+    case _Technique_selection: return *_get<Technique>() == *o._get<Technique>();
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+  bool operator!=(const Ability &o) const noexcept
+  {
+    if (this == &o)
+      return false;
+    if (_selection != o._selection)
+      return true;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return false;
+    case _Spell_selection: return *_get<Spell>() != *o._get<Spell>();
+    case _Technique_selection: return *_get<Technique>() != *o._get<Technique>();
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+private:
+  void _clone(const Ability &o) noexcept
+  {
+     _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Spell_selection: _construct<Spell>(*o._get<Spell>()); break;
+    case _Technique_selection: _construct<Technique>(*o._get<Technique>()); break;
+    }
+  }
+
+  void _move(Ability &o) noexcept
+  {
+    _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Spell_selection: _take<Spell>(o); break;
+    case _Technique_selection: _take<Technique>(o); break;
+    }
+    o._selection = no_selection;
+  }
+
+  void _destroy() noexcept {
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Spell_selection: _free<Spell>(); break;
+    case _Technique_selection: _free<Technique>(); break;
+    }
+    _selection = no_selection;
+  }
+
+  template<typename T> using _inline = std::integral_constant<bool, sizeof(T) <= 32 && std::is_nothrow_move_constructible<T>::value>;
+  template<typename T> using _held = typename std::conditional<_inline<T>::value, T, T *>::type;
+  template<typename T> struct _slot {
+    alignas(_held<T>) unsigned char bytes[sizeof(_held<T>)];
+  };
+
+  template<typename T> T *_get() noexcept { return _get<T>(_inline<T>()); }
+  template<typename T> const T *_get() const noexcept { return const_cast<Ability *>(this)->_get<T>(); }
+  template<typename T> T *_get(std::true_type) noexcept { return reinterpret_cast<T *>(&_storage); }
+  template<typename T> T *_get(std::false_type) noexcept { return *reinterpret_cast<T **>(&_storage); }
+
+  template<typename T, typename... Args> void _construct(Args &&... args) {
+    _place<T>(_inline<T>(), std::forward<Args>(args)...);
+  }
+  template<typename T, typename... Args> void _place(std::true_type, Args &&... args) {
+    new (&_storage) T(std::forward<Args>(args)...);
+  }
+  template<typename T, typename... Args> void _place(std::false_type, Args &&... args) {
+    new (&_storage) T *(new T(std::forward<Args>(args)...));
+  }
+
+  // builds the new value before the old one is destroyed, the arguments may refer into it
+  template<typename T, typename... Args> void _replace(Args &&... args) {
+    _replace<T>(_inline<T>(), std::forward<Args>(args)...);
+  }
+  template<typename T, typename... Args> void _replace(std::true_type, Args &&... args) {
+    T v(std::forward<Args>(args)...);
+    _destroy();
+    new (&_storage) T(std::move(v));
+  }
+  template<typename T, typename... Args> void _replace(std::false_type, Args &&... args) {
+    T *v = new T(std::forward<Args>(args)...);
+    _destroy();
+    new (&_storage) T *(v);
+  }
+
+  template<typename T> void _free() noexcept { _free<T>(_inline<T>()); }
+  template<typename T> void _free(std::true_type) noexcept { _get<T>()->~T(); }
+  template<typename T> void _free(std::false_type) noexcept { delete _get<T>(); }
+
+  template<typename T> void _take(Ability &o) noexcept { _take<T>(o, _inline<T>()); }
+  template<typename T> void _take(Ability &o, std::true_type) noexcept {
+    new (&_storage) T(std::move(*o._get<T>()));
+    o._free<T>();
+  }
+  template<typename T> void _take(Ability &o, std::false_type) noexcept {
+    new (&_storage) T *(o._get<T>());
+  }
+
+  union {
+    _slot<Spell> _Spell;
+    _slot<Technique> _Technique;
+  } _storage;
+
+  enum Selection_t {
+    no_selection,
+    _Spell_selection,
+    _Technique_selection,
+  };
+
+  Selection_t _selection{no_selection};
+  friend struct Hero_io;
+};
+
+enum class Category : std::int8_t {
+  Carries = 0,
+  Jungler = 1,
+  Initiator = 2,
+  Support = 3,
+};
+
+inline const std::array<Category,4> & CategoryValues() {
+  static const std::array<Category,4> values {{
+    Category::Carries,
+    Category::Jungler,
+    Category::Initiator,
+    Category::Support,
+  }};
+  return values;
+};
+
+inline const char * ValueName(const Category &v) {
+  switch(v) {
+    case Category::Carries: return "Carries";
+    case Category::Jungler: return "Jungler";
+    case Category::Initiator: return "Initiator";
+    case Category::Support: return "Support";
+  }
+  return "<error>";
+};
+
+struct Hero {
+  std::string name;
+  Category category{Example::Game::Category::Carries};
+  float health{0.0f};
+  float mana{0.0f};
+  std::vector<Ability> abilities;
+
+  Hero() = default;
+
+  friend bool operator==(const Hero&l, const Hero&r) {
+    return 
+      l.name == r.name
+      && l.category == r.category
+      && l.health == r.health
+      && l.mana == r.mana
+      && l.abilities == r.abilities;
+  }
+
+  friend bool operator!=(const Hero&l, const Hero&r) {
+    return 
+      l.name != r.name
+      || l.category != r.category
+      || l.health != r.health
+      || l.mana != r.mana
+      || l.abilities != r.abilities;
+  }
+
+  bool has_changes() const {
+    return changes_.any();
+  }
+
+  void clear_changes() {
+    changes_.reset();
+    abilities_changed_.clear();
+  }
+
+  void mark_name() {
+    changes_.set(0);
+  }
+  template<class T> void set_name(T &&v) {
+    name = std::forward<T>(v);
+    mark_name();
+  }
+
+  void mark_category() {
+    changes_.set(1);
+  }
+  template<class T> void set_category(T &&v) {
+    category = std::forward<T>(v);
+    mark_category();
+  }
+
+  void mark_health() {
+    changes_.set(2);
+  }
+  template<class T> void set_health(T &&v) {
+    health = std::forward<T>(v);
+    mark_health();
+  }
+
+  void mark_mana() {
+    changes_.set(3);
+  }
+  template<class T> void set_mana(T &&v) {
+    mana = std::forward<T>(v);
+    mark_mana();
+  }
+
+  void mark_abilities() {
+    mark_abilities(0, abilities.size());
+  }
+  void mark_abilities(std::size_t first, std::size_t last) {
+    abilities_changed_.mark(first, std::min(last, abilities.size()));
+    changes_.set(4);
+  }
+  template<class T> void set_abilities(T &&v) {
+    abilities = std::forward<T>(v);
+    mark_abilities();
+  }
+  std::vector<Ability>::reference change_abilities(std::size_t index) {
+    mark_abilities(index, index + 1);
+    return abilities[index];
+  }
+  template<class T> void push_abilities(T &&v) {
+    abilities.push_back(std::forward<T>(v));
+    mark_abilities(abilities.size() - 1, abilities.size());
+  }
+  void resize_abilities(std::size_t size) {
+    const auto old = abilities.size();
+    abilities.resize(size);
+    mark_abilities(std::min(old, size), size);
+  }
+
+  template<class T> void fill_abilities(const T &v) {
+    std::fill(abilities.begin(), abilities.end(), v);
+    mark_abilities();
+  }
+
+  template<class Generator> void generate_abilities(Generator gen) {
+    std::generate(abilities.begin(), abilities.end(), gen);
+    mark_abilities();
+  }
+
+  template<class T> std::vector<Ability>::iterator remove_abilities(const T &v) {
+    const auto first = std::find(abilities.begin(), abilities.end(), v);
+    mark_abilities(static_cast<std::size_t>(first - abilities.begin()), abilities.size());
+    return std::remove(first, abilities.end(), v);
+  }
+  template<class Pred> std::vector<Ability>::iterator remove_abilities_if(Pred v) {
+    const auto first = std::find_if(abilities.begin(), abilities.end(), v);
+    mark_abilities(static_cast<std::size_t>(first - abilities.begin()), abilities.size());
+    return std::remove_if(first, abilities.end(), v);
+  }
+
+  template<class T> void erase_abilities(const T &v) {
+    abilities.erase(remove_abilities(v));
+  }
+  template<class Pred> void erase_abilities_if(Pred v) {
+    abilities.erase(remove_abilities_if(v));
+  }
+
+  void reverse_abilities() {
+    std::reverse(abilities.begin(), abilities.end());
+    mark_abilities();
+  }
+
+  void rotate_abilities(std::vector<Ability>::iterator i) {
+    std::rotate(abilities.begin(), i, abilities.end());
+    mark_abilities();
+  }
+
+  template<class Comp> void sort_abilities(Comp p) {
+    std::sort(abilities.begin(), abilities.end(), p);
+    mark_abilities();
+  }
+
+  template<class Comp> bool any_of_abilities(Comp p) {
+    return std::any_of(abilities.begin(), abilities.end(), p);
+  }
+  template<class T> bool any_of_abilities_is(const T &p) {
+    return any_of_abilities([&p](const Ability &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_abilities(Comp p) {
+    return std::all_of(abilities.begin(), abilities.end(), p);
+  }
+  template<class T> bool all_of_abilities_are(const T &p) {
+    return all_of_abilities([&p](const Ability &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_abilities(Comp p) {
+    return std::none_of(abilities.begin(), abilities.end(), p);
+  }
+  template<class T> bool none_of_abilities_is(const T &p) {
+    return none_of_abilities([&p](const Ability &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_abilities(Fn p) {
+    return std::for_each(abilities.begin(), abilities.end(), p);
+  }
+
+  template<class T> std::vector<Ability>::iterator find_in_abilities(const T &p) {
+    return std::find(abilities.begin(), abilities.end(), p);
+  }
+  template<class Comp> std::vector<Ability>::iterator find_in_abilities_if(Comp p) {
+    return std::find_if(abilities.begin(), abilities.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<Ability>::iterator>::difference_type count_in_abilities(const T &p) {
+    return std::count(abilities.begin(), abilities.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<Ability>::iterator>::difference_type count_in_abilities_if(Comp p) {
+    return std::count_if(abilities.begin(), abilities.end(), p);
+  }
+
+  std::bitset<5> changes_;
+  ChangedElements abilities_changed_;
+};
+
+struct StringView {
+  StringView() = default;
+  StringView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::string str() const { return size_ == 0 ? std::string() : std::string(data_, size_); }
+
+  friend bool operator==(const StringView &l, const std::string &r) {
+    return l.size_ == r.size() && (l.size_ == 0 || std::memcmp(l.data_, r.data(), l.size_) == 0);
+  }
+  friend bool operator!=(const StringView &l, const std::string &r) { return !(l == r); }
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+template<typename T> struct ArrayView {
+  ArrayView() = default;
+  ArrayView(const char *data, std::size_t count) : data_(data), count_(count) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  T operator[](std::size_t index) const {
+    T v;
+    std::memcpy(static_cast<void *>(&v), data_ + index * sizeof(T), sizeof(T));
+    return v;
+  }
+
+  struct iterator {
+    const ArrayView *view;
+    std::size_t index;
+
+    T operator*() const { return (*view)[index]; }
+    iterator &operator++() { ++index; return *this; }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{this, count_}; }
+
+private:
+  const char *data_{nullptr};
+  std::size_t count_{0};
+};
+
+// elements are found by passing the ones in front of them, or through the offset index of --index-vectors;
+// the offsets passed for indexing are kept, so indexing the same list again takes constant time
+template<typename IO, typename E, typename Encoded> struct ListView {
+  ListView() = default;
+  ListView(const char *data, std::size_t size, std::size_t first, std::size_t count, const char *index = nullptr)
+    : data_(data), size_(size), first_(first), count_(count), index_(index) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  E operator[](std::size_t index) const {
+    return At(Find(index));
+  }
+
+  struct iterator {
+    const ListView *view;
+    std::size_t index;
+    std::size_t pos;
+
+    E operator*() const { return view->At(pos); }
+    iterator &operator++() {
+      ++index;
+      pos = view->index_ ? view->Find(index) : view->Next(pos);
+      // a list that cannot be passed ends where it broke
+      if (pos >= view->size_)
+        index = view->count_;
+      return *this;
+    }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0, index_ ? Find(0) : first_}; }
+  iterator end() const { return iterator{this, count_, size_}; }
+
+  // where the list ends, the size of the data if it cannot be passed
+  std::size_t EndOffset() const {
+    if (count_ == 0)
+      return first_;
+    if (index_)
+      return Next(Find(count_ - 1));
+    auto pos = first_;
+    for (std::size_t n = 0; n < count_ && pos < size_; ++n)
+      pos = Next(pos);
+    return pos;
+  }
+
+private:
+  std::size_t Next(std::size_t pos) const {
+    if (pos >= size_)
+      return size_;
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false};
+    io.Skip(i, static_cast<const Encoded *>(nullptr));
+    return i.failed ? size_ : i.pos;
+  }
+
+  std::size_t Find(std::size_t index) const {
+    if (index >= count_)
+      return size_;
+    if (index_) {
+      IO io;
+      typename IO::InputBuffer i{index_, count_ * sizeof(std::uint64_t), index * sizeof(std::uint64_t), false};
+      std::uint64_t offset = 0;
+      io.ReadValues(i, &offset, 1);
+      return i.failed || offset >= size_ ? size_ : static_cast<std::size_t>(offset);
+    }
+    if (offsets_.empty())
+      offsets_.push_back(first_);
+    while (offsets_.size() <= index && offsets_.back() < size_)
+      offsets_.push_back(Next(offsets_.back()));
+    return offsets_.size() > index ? offsets_[index] : size_;
+  }
+
+  E At(std::size_t pos) const {
+    if (pos >= size_)
+      return E();
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false};
+    return io.MakeView(i, static_cast<const Encoded *>(nullptr));
+  }
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  std::size_t first_{0};
+  std::size_t count_{0};
+  const char *index_{nullptr};
+  mutable std::vector<std::size_t> offsets_;
+};
+struct AbilityView;
+struct HeroView;
+
+struct Hero_io {
+  friend struct HeroWriter;
+  friend struct HeroJournal;
+
+  friend struct AbilityView;
+  friend struct HeroView;
+  template<typename, typename, typename> friend struct ListView;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O> void Write(O &o, const std::string &v) const {
+    Write(o, v.size());
+    WriteBytes(o, v.data(), v.size());
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  static constexpr std::size_t CompressedBlockSize() {
+    return 1 << 16;
+  }
+
+  static void LzEmit(std::vector<char> &d, const char *literals, std::size_t count, std::size_t offset, std::size_t length) {
+    const auto extra = [&d](std::size_t v) {
+      for (; v >= 255; v -= 255)
+        d.push_back(static_cast<char>(255));
+      d.push_back(static_cast<char>(v));
+    };
+    const auto matched = length == 0 ? 0 : length - 4;
+    d.push_back(static_cast<char>((std::min<std::size_t>(count, 15) << 4) | std::min<std::size_t>(matched, 15)));
+    if (count >= 15)
+      extra(count - 15);
+    d.insert(d.end(), literals, literals + count);
+    if (length == 0)
+      return;
+    d.push_back(static_cast<char>(offset & 0xff));
+    d.push_back(static_cast<char>(offset >> 8));
+    if (matched >= 15)
+      extra(matched - 15);
+  }
+
+  static void LzCompress(const char *s, std::size_t size, std::vector<char> &d) {
+    std::vector<std::uint32_t> table(1 << 12, 0);
+    d.clear();
+    std::size_t anchor = 0;
+    std::size_t pos = 0;
+    while (size >= 4 && pos <= size - 4) {
+      std::uint32_t sequence;
+      std::memcpy(&sequence, s + pos, 4);
+      auto &entry = table[(sequence * 2654435761u) >> 20];
+      const std::size_t candidate = entry;
+      entry = static_cast<std::uint32_t>(pos + 1);
+      if (candidate == 0 || pos + 1 - candidate > 0xffff || std::memcmp(s + candidate - 1, s + pos, 4) != 0) {
+        ++pos;
+        continue;
+      }
+      const auto match = candidate - 1;
+      std::size_t length = 4;
+      while (pos + length < size && s[match + length] == s[pos + length])
+        ++length;
+      LzEmit(d, s + anchor, pos - anchor, pos - match, length);
+      pos += length;
+      anchor = pos;
+    }
+    LzEmit(d, s + anchor, size - anchor, 0, 0);
+  }
+
+  static bool LzDecompress(const char *s, std::size_t size, char *d, std::size_t capacity) {
+    std::size_t in = 0;
+    std::size_t out = 0;
+    const auto extra = [s, size, &in](std::size_t &v) {
+      unsigned char b = 255;
+      while (b == 255) {
+        if (in == size)
+          return false;
+        b = static_cast<unsigned char>(s[in++]);
+        v += b;
+      }
+      return true;
+    };
+    while (in < size) {
+      const auto token = static_cast<unsigned char>(s[in++]);
+      std::size_t count = token >> 4;
+      if (count == 15 && !extra(count))
+        return false;
+      if (count > size - in || count > capacity - out)
+        return false;
+      std::memcpy(d + out, s + in, count);
+      in += count;
+      out += count;
+      if (in == size)
+        break;
+      if (size - in < 2)
+        return false;
+      const std::size_t offset = static_cast<unsigned char>(s[in]) | (static_cast<unsigned char>(s[in + 1]) << 8);
+      in += 2;
+      std::size_t length = token & 15;
+      if (length == 15 && !extra(length))
+        return false;
+      length += 4;
+      if (offset == 0 || offset > out || length > capacity - out)
+        return false;
+      if (offset >= length)
+        std::memcpy(d + out, d + out - offset, length);
+      else
+        for (std::size_t i = 0; i < length; ++i)
+          d[out + i] = d[out + i - offset];
+      out += length;
+    }
+    return out == capacity;
+  }
+
+  struct CompressedOutput {
+    std::ostream &stream;
+    std::vector<char> block;
+    std::vector<char> compressed;
+  };
+
+  void FlushBlock(CompressedOutput &o) const {
+    if (o.block.empty())
+      return;
+    LzCompress(o.block.data(), o.block.size(), o.compressed);
+    const auto &data = o.compressed.size() < o.block.size() ? o.compressed : o.block;
+    const std::uint32_t sizes[2] = {static_cast<std::uint32_t>(o.block.size()), static_cast<std::uint32_t>(data.size())};
+    o.stream.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    o.stream.write(data.data(), data.size());
+    o.block.clear();
+  }
+
+  void WriteBytes(CompressedOutput &o, const char *d, std::size_t s) const {
+    while (s != 0) {
+      const auto n = std::min(s, CompressedBlockSize() - o.block.size());
+      o.block.insert(o.block.end(), d, d + n);
+      d += n;
+      s -= n;
+      if (o.block.size() == CompressedBlockSize())
+        FlushBlock(o);
+    }
+  }
+
+  // offset counts the decompressed bytes of all blocks before the current one
+  struct CompressedInput {
+    InputStream source;
+    std::vector<char> block;
+    std::vector<char> compressed;
+    std::size_t pos;
+    std::uint64_t offset;
+    bool failed;
+  };
+
+  bool NextBlock(CompressedInput &i) {
+    std::uint32_t sizes[2] = {0, 0};
+    ReadBytes(i.source, reinterpret_cast<char *>(sizes), sizeof(sizes));
+    if (i.source.failed || sizes[0] == 0 || sizes[0] > CompressedBlockSize() || sizes[1] > sizes[0])
+      return false;
+    i.offset += i.block.size();
+    i.block.resize(sizes[0]);
+    i.pos = 0;
+    if (sizes[1] == sizes[0]) {
+      ReadBytes(i.source, i.block.data(), sizes[0]);
+      return !i.source.failed;
+    }
+    i.compressed.resize(sizes[1]);
+    ReadBytes(i.source, i.compressed.data(), sizes[1]);
+    return !i.source.failed && LzDecompress(i.compressed.data(), sizes[1], i.block.data(), sizes[0]);
+  }
+
+  void ReadBytes(CompressedInput &i, char *d, std::size_t s) {
+    while (s != 0) {
+      if (i.pos == i.block.size() && (i.failed || !NextBlock(i))) {
+        Fail(i);
+        std::memset(d, 0, s);
+        return;
+      }
+      const auto n = std::min(s, i.block.size() - i.pos);
+      std::memcpy(d, i.block.data() + i.pos, n);
+      i.pos += n;
+      d += n;
+      s -= n;
+    }
+  }
+
+  bool Failed(CompressedInput &i) {
+    return i.failed;
+  }
+
+  void Fail(CompressedInput &i) {
+    if (!i.failed)
+      error_offset_ = i.offset + i.pos;
+    i.failed = true;
+  }
+
+  // a compressed byte never expands to more than 255 bytes, the bound keeps lengths from garbage in check
+  static std::uint64_t Remaining(const CompressedInput &i) {
+    const auto stream = i.source.size - i.source.pos;
+    const auto limit = std::numeric_limits<std::uint64_t>::max() / 256;
+    return i.block.size() - i.pos + (stream > limit ? limit : stream) * 255;
+  }
+
+  bool Available(CompressedInput &i, std::size_t count, std::size_t size) {
+    if (!i.failed && count <= Remaining(i) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename I> void Read(I &i, std::string &v) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    v.resize(s);
+    ReadBytes(i, &v[0], s);
+  }
+
+  template<typename O> void Write(O &o, const Ability &v) const {
+    Write(o, v._selection);
+    switch(v._selection) {
+    case Ability::no_selection: while(false); /* hack for coverage tool */ break;
+    case Ability::_Spell_selection: Write(o, v.as_Spell()); break;
+    case Ability::_Technique_selection: Write(o, v.as_Technique()); break;
+    }
+  }
+
+  template<typename O> void Write(O &o, const std::vector<Ability> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &i, Ability &v) {
+    std::underlying_type<Ability::Selection_t>::type raw = 0;
+    Read(i, raw);
+    const auto value = static_cast<std::uint64_t>(raw);
+    if (value > 2) {
+      v.clear();
+      Fail(i);
+      return;
+    }
+    switch(static_cast<Ability::Selection_t>(value)) {
+    case Ability::no_selection: v.clear(); break;
+    case Ability::_Spell_selection: Read(i, v.create_Spell()); break;
+    case Ability::_Technique_selection: Read(i, v.create_Technique()); break;
+    }
+  }
+
+  template<typename I> void Read(I &s, std::vector<Ability> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Hero &v) const {
+    Write(o, v.name);
+    Write(o, v.category);
+    Write(o, v.health);
+    Write(o, v.mana);
+    Write(o, v.abilities);
+  }
+
+  template<typename I> void Read(I &s, Hero &v) {
+    Read(s, v.name);
+    Read(s, v.category);
+    Read(s, v.health);
+    Read(s, v.mana);
+    Read(s, v.abilities);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.1", 3);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    return std::memcmp(version, "0.1", 3) == 0;
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+  std::uint64_t Position(OutputStream &o) const {
+    return o.size;
+  }
+
+  std::uint64_t Position(OutputBuffer &o) const {
+    return o.size;
+  }
+
+  std::uint64_t Position(OutputSpan &o) const {
+    return o.size;
+  }
+
+  std::uint64_t Position(OutputCounter &o) const {
+    return o.size;
+  }
+
+  template<typename O> void WriteVectorIndex(O &o, std::uint64_t start, std::initializer_list<const std::vector<std::uint64_t> *> index) const {
+    std::vector<std::uint64_t> directory;
+    for (const auto *entry : index) {
+      directory.push_back(entry->size());
+      directory.push_back(Position(o) - start);
+      WriteValues(o, entry->data(), entry->size());
+    }
+    directory.push_back(Position(o) - start + (directory.size() + 1) * sizeof(std::uint64_t));
+    WriteValues(o, directory.data(), directory.size());
+  }
+
+  template<typename O> void WriteIndexed(O &o, const Hero &v) const {
+    const auto start = Position(o);
+    std::vector<std::uint64_t> abilities_index;
+    abilities_index.reserve(v.abilities.size());
+    Write(o, v.name);
+    Write(o, v.category);
+    Write(o, v.health);
+    Write(o, v.mana);
+    Write(o, v.abilities.size());
+    for (const auto &entry : v.abilities) {
+      abilities_index.push_back(Position(o) - start);
+      Write(o, entry);
+    }
+    WriteVectorIndex(o, start, {&abilities_index});
+  }
+
+  std::uint64_t InputSize(InputStream &i) {
+    return i.size;
+  }
+
+  std::uint64_t InputSize(InputBuffer &i) {
+    return i.size;
+  }
+
+  void Seek(InputStream &i, std::uint64_t pos) {
+    if (i.failed || pos > i.size || !i.stream.seekg(static_cast<std::streamoff>(pos))) {
+      Fail(i);
+      return;
+    }
+    i.pos = pos;
+  }
+
+  void Seek(InputBuffer &i, std::uint64_t pos) {
+    i.failed = i.failed || pos > i.size;
+    i.pos = i.failed ? i.size : static_cast<std::size_t>(pos);
+  }
+
+  template<typename I> bool SeekVectorEntry(I &i, std::size_t member, std::uint64_t index) {
+    const std::uint64_t header = 8;
+    const std::uint64_t trailer = 3 * sizeof(std::uint64_t);
+    const auto size = InputSize(i);
+    if (size < header + trailer)
+      return false;
+    std::uint64_t length = 0;
+    Seek(i, size - sizeof(length));
+    ReadValues(i, &length, 1);
+    if (Failed(i) || length < trailer || length > size - header)
+      return false;
+    const auto start = size - length;
+    Seek(i, start - header);
+    if (!ReadHeader(i))
+      return false;
+    std::uint64_t entry[2] = {0, 0};
+    Seek(i, size - trailer + 2 * member * sizeof(std::uint64_t));
+    ReadValues(i, entry, 2);
+    if (Failed(i) || index >= entry[0] || entry[1] > length ||
+        entry[0] > (length - entry[1]) / sizeof(std::uint64_t))
+      return false;
+    std::uint64_t offset = 0;
+    Seek(i, start + entry[1] + index * sizeof(std::uint64_t));
+    ReadValues(i, &offset, 1);
+    if (Failed(i) || offset >= length)
+      return false;
+    Seek(i, start + offset);
+    return !Failed(i);
+  }
+
+  std::uint64_t ReadSelection(InputBuffer &i, const Ability *) {
+    std::underlying_type<Ability::Selection_t>::type raw = 0;
+    Read(i, raw);
+    const auto value = static_cast<std::uint64_t>(raw);
+    if (value > 2)
+      Fail(i);
+    return value;
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void SkipEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Skip(InputBuffer &i, const std::vector<std::string> *) {
+    SkipEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      Skip(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+    }
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::weak_ptr<T> *) {
+    Skip(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::weak_ptr<T> *>(nullptr));
+  }
+
+  StringView MakeView(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return StringView();
+    i.pos += s;
+    return StringView(i.data + i.pos - s, s);
+  }
+  void Skip(InputBuffer &i, const Ability *) {
+    switch (ReadSelection(i, static_cast<const Ability *>(nullptr))) {
+    case 1: Skip(i, static_cast<const Spell *>(nullptr)); break;
+    case 2: Skip(i, static_cast<const Technique *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Ability> *) {
+    SkipEach(i, static_cast<const Ability *>(nullptr));
+  }
+
+  AbilityView MakeView(InputBuffer &i, const Ability *);
+  AbilityView MakeView(InputBuffer &i, const std::unique_ptr<Ability> *);
+
+  void Skip(InputBuffer &i, const Hero *) {
+    Skip(i, static_cast<const std::string *>(nullptr));
+    Skip(i, static_cast<const Category *>(nullptr));
+    Skip(i, static_cast<const float *>(nullptr));
+    Skip(i, static_cast<const float *>(nullptr));
+    Skip(i, static_cast<const std::vector<Ability> *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Hero> *) {
+    SkipEach(i, static_cast<const Hero *>(nullptr));
+  }
+
+  HeroView MakeView(InputBuffer &i, const Hero *);
+  HeroView MakeView(InputBuffer &i, const std::unique_ptr<Hero> *);
+
+  template<typename T> void Verify(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void VerifyEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Verify(i, static_cast<const T *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Verify(InputBuffer &i, const std::vector<std::string> *) {
+    VerifyEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Verify(i, static_cast<const T *>(nullptr));
+    else if (ref != '\0')
+      Fail(i);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Spell *) {
+    if (Available(i, 1, sizeof(Spell)))
+      i.pos += sizeof(Spell);
+  }
+
+  void Verify(InputBuffer &i, const Technique *) {
+    if (Available(i, 1, sizeof(Technique)))
+      i.pos += sizeof(Technique);
+  }
+
+  void Verify(InputBuffer &i, const Ability *) {
+    switch (ReadSelection(i, static_cast<const Ability *>(nullptr))) {
+    case 1: Verify(i, static_cast<const Spell *>(nullptr)); break;
+    case 2: Verify(i, static_cast<const Technique *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Ability> *) {
+    VerifyEach(i, static_cast<const Ability *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Hero *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const Category *>(nullptr));
+    Verify(i, static_cast<const float *>(nullptr));
+    Verify(i, static_cast<const float *>(nullptr));
+    Verify(i, static_cast<const std::vector<Ability> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Hero> *) {
+    VerifyEach(i, static_cast<const Hero *>(nullptr));
+  }
+
+  void VerifyIndexed(InputBuffer &i) {
+    const std::uint64_t start = i.pos;
+    const std::uint64_t trailer = 3 * sizeof(std::uint64_t);
+    if (i.size - i.pos < trailer) {
+      Fail(i);
+      return;
+    }
+    std::uint64_t directory[3];
+    InputBuffer index{i.data, i.size, i.size - static_cast<std::size_t>(trailer), false};
+    ReadValues(index, directory, 3);
+    const auto length = i.size - start;
+    if (directory[2] != length) {
+      i.pos = i.size - sizeof(std::uint64_t);
+      Fail(i);
+      return;
+    }
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const Category *>(nullptr));
+    Verify(i, static_cast<const float *>(nullptr));
+    Verify(i, static_cast<const float *>(nullptr));
+    {
+      std::size_t s{0};
+      Read(i, s);
+      const auto entries = directory[1];
+      if (s != directory[0] || entries > length || s > (length - entries) / sizeof(std::uint64_t))
+        Fail(i);
+      index.pos = static_cast<std::size_t>(start + entries);
+      for (std::size_t n = 0; n < s && !i.failed; ++n) {
+        std::uint64_t offset = 0;
+        ReadValues(index, &offset, 1);
+        if (offset != i.pos - start)
+          Fail(i);
+        Verify(i, static_cast<const Ability *>(nullptr));
+      }
+    }
+    auto entries = i.pos - start;
+    for (std::size_t k = 0; k < 1 && !i.failed; ++k) {
+      if (directory[2 * k + 1] != entries)
+        Fail(i);
+      entries += directory[2 * k] * sizeof(std::uint64_t);
+    }
+    if (!i.failed && entries + trailer != length)
+      Fail(i);
+    if (!i.failed)
+      i.pos = i.size;
+  }
+
+  template<typename O> void WriteDelta(O &o, Hero &v) const {
+    WriteBytes(o, "DLTE0.1", 7);
+    if (v.changes_[0]) {
+      Write(o, std::uint32_t(1));
+      Write(o, v.name);
+    }
+    if (v.changes_[1]) {
+      Write(o, std::uint32_t(2));
+      Write(o, v.category);
+    }
+    if (v.changes_[2]) {
+      Write(o, std::uint32_t(3));
+      Write(o, v.health);
+    }
+    if (v.changes_[3]) {
+      Write(o, std::uint32_t(4));
+      Write(o, v.mana);
+    }
+    if (v.changes_[4]) {
+      Write(o, std::uint32_t(5));
+      const auto runs = v.abilities_changed_.runs(v.abilities.size());
+      Write(o, v.abilities.size());
+      Write(o, runs.size());
+      for (const auto &r : runs) {
+        Write(o, r.first);
+        Write(o, r.second - r.first);
+        for (auto n = r.first; n < r.second; ++n)
+          Write(o, v.abilities[n]);
+      }
+    }
+    Write(o, std::uint32_t(0));
+    v.clear_changes();
+  }
+
+  template<typename I, typename V> bool ReadRun(I &i, V &v, std::size_t size, std::size_t &first, std::size_t &count, std::size_t element) {
+    Read(i, first);
+    Read(i, count);
+    if (Failed(i))
+      return false;
+    if (first > v.size() || first > size || count > size - first) {
+      Fail(i);
+      return false;
+    }
+    if (!Available(i, count, element))
+      return false;
+    if (first + count > v.size())
+      v.resize(first + count);
+    return true;
+  }
+
+  template<typename I, typename V> void EndRuns(I &i, V &v, std::size_t size) {
+    if (Failed(i))
+      return;
+    if (size > v.size())
+      Fail(i);
+    else
+      v.resize(size);
+  }
+
+  template<typename I> bool ApplyDelta(I &i, Hero &v) {
+    char marker[7];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 7);
+    if (std::memcmp(marker, "DLTE0.1", 7) != 0) {
+      Fail(i);
+      return false;
+    }
+    for (;;) {
+      std::uint32_t member = 0;
+      Read(i, member);
+      if (Failed(i))
+        return false;
+      switch (member) {
+      case 0:
+        return true;
+      case 1: {
+        Read(i, v.name);
+        break;
+      }
+      case 2: {
+        Read(i, v.category);
+        break;
+      }
+      case 3: {
+        Read(i, v.health);
+        break;
+      }
+      case 4: {
+        Read(i, v.mana);
+        break;
+      }
+      case 5: {
+        std::size_t size = 0, runs = 0;
+        Read(i, size);
+        Read(i, runs);
+        for (std::size_t r = 0; r < runs && !Failed(i); ++r) {
+          std::size_t first = 0, count = 0;
+          if (ReadRun(i, v.abilities, size, first, count, 1))
+            for (auto n = first; n < first + count; ++n)
+              Read(i, v.abilities[n]);
+        }
+        EndRuns(i, v.abilities, size);
+        break;
+      }
+      default:
+        Fail(i);
+        return false;
+      }
+    }
+  }
+
+  static std::uint64_t HashBytes(std::uint64_t h, const char *data, std::size_t size) {
+    for (std::size_t n = 0; n < size; ++n)
+      h = (h ^ static_cast<unsigned char>(data[n])) * 0x100000001b3u;
+    return h;
+  }
+
+  template<typename T> std::uint64_t Hash(std::uint64_t h, const T &v) const {
+    return HashBytes(h, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename T> std::uint64_t Hash(std::uint64_t h, const std::vector<T> &v) const {
+    h = Hash(h, v.size());
+    for (const auto &entry : v)
+      h = Hash(h, entry);
+    return h;
+  }
+
+  template<typename T> std::uint64_t Hash(std::uint64_t h, const std::unique_ptr<T> &v) const {
+    return v ? Hash(Hash(h, '\x1'), *v) : Hash(h, '\x0');
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const std::string &v) const {
+    return HashBytes(Hash(h, v.size()), v.data(), v.size());
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const Spell &v) const {
+    h = Hash(h, v.manaCost);
+    h = Hash(h, v.cooldown);
+    return h;
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const Technique &v) const {
+    h = Hash(h, v.damage);
+    h = Hash(h, v.strength);
+    return h;
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const Ability &v) const {
+    if (v.is_Spell())
+      return Hash(Hash(h, 1), v.as_Spell());
+    if (v.is_Technique())
+      return Hash(Hash(h, 2), v.as_Technique());
+    return Hash(h, 0);
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const Hero &v) const {
+    h = Hash(h, v.name);
+    h = Hash(h, v.category);
+    h = Hash(h, v.health);
+    h = Hash(h, v.mana);
+    h = Hash(h, v.abilities);
+    return h;
+  }
+
+  template<typename O, typename V> void WriteLiteral(O &o, const V &v, std::size_t first, std::size_t last) const {
+    if (first == last)
+      return;
+    Write(o, last - first);
+    Write(o, std::size_t(0));
+    for (auto n = first; n < last; ++n)
+      Write(o, v[n]);
+  }
+
+  template<typename V> void IndexElements(const V &a, std::vector<std::uint64_t> &hashes, std::vector<std::size_t> &slots) const {
+    std::size_t capacity = 16;
+    while (capacity < 2 * a.size())
+      capacity *= 2;
+    hashes.resize(a.size());
+    slots.assign(capacity, 0);
+    for (std::size_t k = 0; k < a.size(); ++k) {
+      hashes[k] = Hash(0xcbf29ce484222325u, a[k]);
+      auto s = hashes[k] & (capacity - 1);
+      while (slots[s] != 0 && hashes[slots[s] - 1] != hashes[k])
+        s = (s + 1) & (capacity - 1);
+      if (slots[s] == 0)
+        slots[s] = k + 1;
+    }
+  }
+
+  template<typename V> std::size_t FindElement(const V &a, const typename V::value_type &e, const std::vector<std::uint64_t> &hashes, const std::vector<std::size_t> &slots) const {
+    const auto h = Hash(0xcbf29ce484222325u, e);
+    for (auto s = h & (slots.size() - 1); slots[s] != 0; s = (s + 1) & (slots.size() - 1))
+      if (hashes[slots[s] - 1] == h)
+        return a[slots[s] - 1] == e ? slots[s] - 1 : a.size();
+    return a.size();
+  }
+
+  template<typename O, typename V> void WriteVectorDiff(O &o, const V &a, const V &b) const {
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::size_t> slots;
+    Write(o, b.size());
+    std::size_t literal = 0, next = 0;
+    for (std::size_t n = 0; n < b.size();) {
+      auto from = a.size();
+      const auto replaced = next + (n - literal);
+      if (replaced < a.size() && a[replaced] == b[n]) {
+        from = replaced;
+      } else if (next < a.size() && a[next] == b[n]) {
+        from = next;
+      } else {
+        if (slots.empty())
+          IndexElements(a, hashes, slots);
+        from = FindElement(a, b[n], hashes, slots);
+      }
+      if (from == a.size()) {
+        ++n;
+        continue;
+      }
+      std::size_t count = 1;
+      while (n + count < b.size() && from + count < a.size() && a[from + count] == b[n + count])
+        ++count;
+      WriteLiteral(o, b, literal, n);
+      Write(o, count);
+      Write(o, from + 1);
+      n += count;
+      literal = n;
+      next = from + count;
+    }
+    WriteLiteral(o, b, literal, b.size());
+  }
+
+  template<typename V> bool ReadCopy(InputBuffer &i, V &v, const V &a, std::size_t size, std::size_t count, std::size_t from) {
+    if (count == 0 || count > size - v.size() || from - 1 >= a.size() || count > a.size() - (from - 1)) {
+      Fail(i);
+      return false;
+    }
+    v.insert(v.end(), a.begin() + (from - 1), a.begin() + (from - 1 + count));
+    return true;
+  }
+
+  template<typename V> bool ReadLiteral(InputBuffer &i, V &v, std::size_t size, std::size_t count) {
+    if (count == 0 || count > size - v.size()) {
+      Fail(i);
+      return false;
+    }
+    if (!Available(i, count, 1))
+      return false;
+    v.resize(v.size() + count);
+    return true;
+  }
+
+  struct OutputHash {
+    std::uint64_t hash;
+  };
+
+  void WriteBytes(OutputHash &o, const char *d, std::size_t s) const {
+    o.hash = HashBytes(o.hash, d, s);
+  }
+
+  // a patch only applies to the value it was made from, it carries the hash of its written bytes
+  std::uint64_t HashDiffBase(const Hero &v) const {
+    OutputHash h{0xcbf29ce484222325u};
+    Write(h, v);
+    return h.hash;
+  }
+
+  static bool Differs(const std::vector<char> &a, const OutputBuffer &oa, const std::vector<char> &b, const OutputBuffer &ob) {
+    return oa.size != ob.size || (oa.size != 0 && std::memcmp(a.data(), b.data(), oa.size) != 0);
+  }
+
+  // pointers compare by the values they point to, so the written bytes are compared
+  template<typename T> bool WrittenDiffers(const T &a, const T &b) const {
+    std::vector<char> wa, wb;
+    OutputBuffer oa{wa, 0}, ob{wb, 0};
+    Write(oa, a);
+    Write(ob, b);
+    return Differs(wa, oa, wb, ob);
+  }
+
+  template<typename O> void WriteDiff(O &o, const Hero &a, const Hero &b) const {
+    WriteBytes(o, "DIFE0.1", 7);
+    Write(o, HashDiffBase(a));
+    if (a.name != b.name) {
+      Write(o, std::uint32_t(1));
+      Write(o, b.name);
+    }
+    if (a.category != b.category) {
+      Write(o, std::uint32_t(2));
+      Write(o, b.category);
+    }
+    if (a.health != b.health) {
+      Write(o, std::uint32_t(3));
+      Write(o, b.health);
+    }
+    if (a.mana != b.mana) {
+      Write(o, std::uint32_t(4));
+      Write(o, b.mana);
+    }
+    if (a.abilities != b.abilities) {
+      Write(o, std::uint32_t(5));
+      WriteVectorDiff(o, a.abilities, b.abilities);
+    }
+    Write(o, std::uint32_t(0));
+  }
+
+  bool ApplyDiff(InputBuffer &i, Hero &v) {
+    char marker[7];
+    std::uint64_t base = 0;
+    error_offset_ = 0;
+    ReadBytes(i, marker, 7);
+    Read(i, base);
+    if (std::memcmp(marker, "DIFE0.1", 7) != 0 || base != HashDiffBase(v)) {
+      Fail(i);
+      return false;
+    }
+    for (;;) {
+      std::uint32_t member = 0;
+      Read(i, member);
+      if (Failed(i))
+        return false;
+      switch (member) {
+      case 0:
+        return true;
+      case 1: {
+        Read(i, v.name);
+        break;
+      }
+      case 2: {
+        Read(i, v.category);
+        break;
+      }
+      case 3: {
+        Read(i, v.health);
+        break;
+      }
+      case 4: {
+        Read(i, v.mana);
+        break;
+      }
+      case 5: {
+        std::size_t size = 0;
+        Read(i, size);
+        decltype(v.abilities) b(v.abilities.get_allocator());
+        while (b.size() < size && !Failed(i)) {
+          std::size_t count = 0, from = 0;
+          Read(i, count);
+          Read(i, from);
+          if (Failed(i))
+            break;
+          if (from != 0) {
+            ReadCopy(i, b, v.abilities, size, count, from);
+            continue;
+          }
+          if (ReadLiteral(i, b, size, count))
+            for (auto n = b.size() - count; n < b.size(); ++n)
+              Read(i, b[n]);
+        }
+        if (!Failed(i))
+          v.abilities.swap(b);
+        break;
+      }
+      default:
+        Fail(i);
+        return false;
+      }
+    }
+  }
+
+  enum JournalOperation : std::uint32_t { JournalSet, JournalAssign, JournalPush, JournalInsert, JournalErase };
+
+  // every journal record starts with the little endian size and hash of its payload
+  static constexpr std::size_t JournalFrameSize() {
+    return 12;
+  }
+
+  static std::uint64_t JournalWord(const char *d, std::size_t bytes) {
+    std::uint64_t v = 0;
+    while (bytes-- != 0)
+      v = (v << 8) | static_cast<unsigned char>(d[bytes]);
+    return v;
+  }
+
+  void WriteJournalFrame(std::vector<char> &b, std::size_t start) const {
+    const std::uint64_t size = b.size() - start - JournalFrameSize();
+    const auto hash = HashBytes(0xcbf29ce484222325u, b.data() + start + JournalFrameSize(), size);
+    for (std::size_t n = 0; n < 4; ++n)
+      b[start + n] = static_cast<char>(size >> (8 * n));
+    for (std::size_t n = 0; n < 8; ++n)
+      b[start + 4 + n] = static_cast<char>(hash >> (8 * n));
+  }
+
+  // end of the last complete record, 0 without a journal header or with a damaged record before the end
+  std::size_t JournalEnd(const char *data, std::size_t size) {
+    if (size < 7 || std::memcmp(data, "JRNE0.1", 7) != 0)
+      return 0;
+    std::size_t pos = 7;
+    while (size - pos >= JournalFrameSize()) {
+      const auto length = JournalWord(data + pos, 4);
+      if (length > size - pos - JournalFrameSize())
+        break;
+      if (HashBytes(0xcbf29ce484222325u, data + pos + JournalFrameSize(), length) != JournalWord(data + pos + 4, 8)) {
+        if (pos + JournalFrameSize() + length == size)
+          return pos;
+        error_offset_ = pos;
+        return 0;
+      }
+      pos += JournalFrameSize() + length;
+    }
+    return pos;
+  }
+
+  // a checkpoint holds the hash of a snapshot and how many bytes before it the state of the snapshot was reached
+  bool JournalCheckpoint(const char *data, std::size_t size, std::uint64_t &snapshot, std::uint64_t &back) {
+    InputBuffer i{data, size, 0, false};
+    std::uint32_t member = 1, operation = 0;
+    Read(i, member);
+    Read(i, operation);
+    Read(i, snapshot);
+    Read(i, back);
+    return member == 0 && !Failed(i);
+  }
+
+  static bool JournalRange(std::uint32_t operation, std::size_t first, std::size_t last, std::size_t size) {
+    switch (operation) {
+    case JournalSet:
+    case JournalPush:
+      return true;
+    case JournalAssign:
+      return first < size;
+    case JournalInsert:
+      return first <= size;
+    case JournalErase:
+      return first <= last && last <= size;
+    }
+    return false;
+  }
+
+  bool ApplyJournalRecord(InputBuffer &i, Hero &v) {
+    std::uint32_t member = 0, operation = 0;
+    Read(i, member);
+    Read(i, operation);
+    if (Failed(i))
+      return false;
+    if (member == 0) {
+      std::uint64_t snapshot = 0, back = 0;
+      Read(i, snapshot);
+      Read(i, back);
+      return !Failed(i);
+    }
+    std::size_t first = 0, last = 0;
+    if (operation == JournalAssign || operation == JournalInsert || operation == JournalErase)
+      Read(i, first);
+    if (operation == JournalErase)
+      Read(i, last);
+    if (Failed(i))
+      return false;
+    switch (member) {
+    case 1:
+      if (operation != JournalSet)
+        break;
+      Read(i, v.name);
+      v.mark_name();
+      return !Failed(i);
+    case 2:
+      if (operation != JournalSet)
+        break;
+      Read(i, v.category);
+      v.mark_category();
+      return !Failed(i);
+    case 3:
+      if (operation != JournalSet)
+        break;
+      Read(i, v.health);
+      v.mark_health();
+      return !Failed(i);
+    case 4:
+      if (operation != JournalSet)
+        break;
+      Read(i, v.mana);
+      v.mark_mana();
+      return !Failed(i);
+    case 5:
+      if (!JournalRange(operation, first, last, v.abilities.size()))
+        break;
+      switch (operation) {
+      case JournalSet:
+        Read(i, v.abilities);
+        break;
+      case JournalAssign:
+        Read(i, v.abilities[first]);
+        break;
+      case JournalPush:
+        first = v.abilities.size();
+        v.abilities.emplace_back();
+        Read(i, v.abilities.back());
+        break;
+      case JournalInsert:
+        v.abilities.emplace(v.abilities.begin() + first);
+        Read(i, v.abilities[first]);
+        break;
+      default:
+        v.abilities.erase(v.abilities.begin() + first, v.abilities.begin() + last);
+      }
+      if (operation == JournalSet)
+        v.mark_abilities();
+      else
+        v.mark_abilities(first, operation == JournalAssign ? first + 1 : v.abilities.size());
+      return !Failed(i);
+    }
+    Fail(i);
+    return false;
+  }
+
+  // replays the records from the point the last checkpoint of the snapshot refers to, a journal that does not start
+  // with a checkpoint was opened on the snapshot and is replayed from its start
+  bool ReplayJournal(const char *data, std::size_t size, std::uint64_t snapshot, Hero &v) {
+    error_offset_ = 0;
+    const auto end = JournalEnd(data, size);
+    if (end == 0)
+      return false;
+    std::size_t start = 7;
+    bool found = false, leading = false;
+    std::vector<std::size_t> frames;
+    for (auto pos = start; pos < end; pos += JournalFrameSize() + JournalWord(data + pos, 4)) {
+      frames.push_back(pos);
+      std::uint64_t hash = 0, back = 0;
+      if (!JournalCheckpoint(data + pos + JournalFrameSize(), JournalWord(data + pos, 4), hash, back))
+        continue;
+      leading = leading || pos == 7;
+      if (hash == snapshot && back <= pos && std::binary_search(frames.begin(), frames.end(), pos - back)) {
+        found = true;
+        start = static_cast<std::size_t>(pos - back);
+      }
+    }
+    if (leading && !found)
+      return false;
+    for (auto pos = start; pos < end;) {
+      const auto length = JournalWord(data + pos, 4);
+      InputBuffer i{data + pos + JournalFrameSize(), length, 0, false};
+      if (!ApplyJournalRecord(i, v) || i.pos != i.size) {
+        error_offset_ = pos;
+        return false;
+      }
+      pos += JournalFrameSize() + length;
+    }
+    return true;
+  }
+
+  static bool ReadFileData(const std::string &path, std::vector<char> &d) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    auto ok = ::fstat(fd, &st) == 0;
+    d.resize(ok ? static_cast<std::size_t>(st.st_size) : 0);
+    for (std::size_t done = 0; ok && done < d.size();) {
+      const auto n = ::read(fd, d.data() + done, d.size() - done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      ok = n > 0;
+      done += ok ? static_cast<std::size_t>(n) : 0;
+    }
+    ::close(fd);
+    return ok;
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f)
+      return false;
+    d.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return !f.bad();
+#endif
+  }
+
+  static constexpr std::size_t ParallelSliceMinimum() {
+    return 1024;
+  }
+
+  template<typename T> std::vector<char> EncodeSlice(const T *begin, const T *end, std::vector<std::uint64_t> *offsets) {
+    std::vector<char> b;
+    OutputBuffer o{b, 0};
+    for (auto entry = begin; entry != end; ++entry) {
+      if (offsets)
+        offsets->push_back(o.size);
+      Write(o, *entry);
+    }
+    b.resize(o.size);
+    return b;
+  }
+
+  template<typename O, typename T> void WriteVectorParallel(O &o, const std::vector<T> &v, unsigned int threads, std::uint64_t start, std::vector<std::uint64_t> *index) const {
+    Write(o, v.size());
+    const auto slices = std::min<std::size_t>(threads, v.size() / ParallelSliceMinimum());
+    if (slices < 2) {
+      for (const auto &entry : v) {
+        if (index)
+          index->push_back(Position(o) - start);
+        Write(o, entry);
+      }
+      return;
+    }
+
+    std::vector<std::future<std::vector<char>>> parts;
+    std::vector<std::vector<std::uint64_t>> offsets(slices);
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto *begin = v.data() + v.size() * s / slices;
+      const auto *end = v.data() + v.size() * (s + 1) / slices;
+      auto *slice = index ? &offsets[s] : nullptr;
+      parts.push_back(std::async(std::launch::async, [begin, end, slice]() {
+        return Hero_io().EncodeSlice(begin, end, slice);
+      }));
+    }
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto part = parts[s].get();
+      if (index) {
+        const auto base = Position(o) - start;
+        for (const auto offset : offsets[s])
+          index->push_back(base + offset);
+      }
+      WriteBytes(o, part.data(), part.size());
+    }
+  }
+
+  template<typename O> void WriteParallel(O &o, const Hero &v, unsigned int threads) const {
+    const auto start = Position(o);
+    std::vector<std::uint64_t> abilities_index;
+    abilities_index.reserve(v.abilities.size());
+    Write(o, v.name);
+    Write(o, v.category);
+    Write(o, v.health);
+    Write(o, v.mana);
+    WriteVectorParallel(o, v.abilities, threads, start, &abilities_index);
+    WriteVectorIndex(o, start, {&abilities_index});
+  }
+
+  bool ReadVectorIndex(const InputBuffer &i, std::size_t member, std::uint64_t start, std::vector<std::uint64_t> &offsets) {
+    const std::uint64_t trailer = 3 * sizeof(std::uint64_t);
+    std::uint64_t length = 0;
+    if (i.size < start + trailer)
+      return false;
+    std::memcpy(&length, i.data + i.size - sizeof(length), sizeof(length));
+    if (length != i.size - start)
+      return false;
+    std::uint64_t entry[2] = {0, 0};
+    std::memcpy(entry, i.data + i.size - trailer + 2 * member * sizeof(std::uint64_t), sizeof(entry));
+    if (entry[1] > length || entry[0] > (length - entry[1]) / sizeof(std::uint64_t))
+      return false;
+    offsets.resize(entry[0]);
+    if (!offsets.empty())
+      std::memcpy(&offsets[0], i.data + start + entry[1], offsets.size() * sizeof(std::uint64_t));
+    for (std::size_t k = 1; k < offsets.size(); ++k)
+      if (offsets[k] < offsets[k - 1])
+        return false;
+    return offsets.empty() || offsets.back() < length;
+  }
+
+  template<typename T> InputBuffer ReadSlice(InputBuffer i, T *begin, T *end) {
+    for (auto entry = begin; entry != end && !i.failed; ++entry)
+      Read(i, *entry);
+    return i;
+  }
+
+  template<typename T> void ReadVectorParallel(InputBuffer &i, std::vector<T> &v, const std::vector<std::uint64_t> &offsets, std::uint64_t start, unsigned int threads) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (s != offsets.size() || (s != 0 && i.pos != start + offsets[0])) {
+      Fail(i);
+      return;
+    }
+    v.resize(s);
+    const auto slices = std::min<std::size_t>(threads, s / ParallelSliceMinimum());
+    if (slices < 2) {
+      i = ReadSlice(i, v.data(), v.data() + s);
+      return;
+    }
+
+    std::vector<std::future<InputBuffer>> parts;
+    for (std::size_t k = 0; k < slices; ++k) {
+      const auto first = s * k / slices;
+      const auto last = s * (k + 1) / slices;
+      const InputBuffer slice{i.data, last == s ? i.size : static_cast<std::size_t>(start + offsets[last]),
+                              static_cast<std::size_t>(start + offsets[first]), false};
+      auto *begin = v.data() + first;
+      auto *end = v.data() + last;
+      parts.push_back(std::async(std::launch::async, [slice, begin, end]() {
+        return Hero_io().ReadSlice(slice, begin, end);
+      }));
+    }
+    for (std::size_t k = 0; k < slices; ++k) {
+      const auto slice = parts[k].get();
+      const auto last = s * (k + 1) / slices;
+      if (i.failed)
+        continue;
+      i.pos = static_cast<std::size_t>(start + offsets[s * k / slices]);
+      if (slice.failed || (last != s && slice.pos != start + offsets[last]))
+        Fail(i);
+      else
+        i.pos = slice.pos;
+    }
+  }
+
+  void ReadParallel(InputBuffer &i, Hero &v, unsigned int threads) {
+    const std::uint64_t start = i.pos;
+    std::vector<std::uint64_t> abilities_offsets;
+    if (!ReadVectorIndex(i, 0, start, abilities_offsets)) {
+      Fail(i);
+      return;
+    }
+    Read(i, v.name);
+    Read(i, v.category);
+    Read(i, v.health);
+    Read(i, v.mana);
+    ReadVectorParallel(i, v.abilities, abilities_offsets, start, threads);
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  // owns a file descriptor, it is closed on every way out unless close() was called
+  struct FileHandle {
+    FileHandle() = default;
+    FileHandle(const FileHandle &) = delete;
+    FileHandle &operator=(const FileHandle &) = delete;
+    ~FileHandle() {
+      if (fd >= 0)
+        ::close(fd);
+    }
+    bool close() {
+      const auto closed = fd >= 0 && ::close(fd) == 0;
+      fd = -1;
+      return closed;
+    }
+    int fd{-1};
+  };
+
+  static bool PwriteAll(int fd, const char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pwrite(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  // allocates the blocks up front, so a full disk fails here and not with SIGBUS while writing a mapping
+  static bool ReserveFile(int fd, std::size_t size) {
+#if defined(__APPLE__)
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+    return ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+  }
+
+  // makes a rename into the directory of path durable
+  static bool SyncDirectory(const std::string &path) {
+    const auto slash = path.find_last_of('/');
+    const auto directory = slash == std::string::npos ? std::string(".") : path.substr(0, slash == 0 ? 1 : slash);
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+      return false;
+    const auto synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+  }
+#endif
+
+  static constexpr std::size_t AsyncBlockSize() {
+    return 1 << 20;
+  }
+
+  struct AsyncOutput {
+#if defined(__unix__) || defined(__APPLE__)
+    FileHandle file;
+#else
+    std::ofstream file;
+#endif
+    std::vector<char> buffer;
+    std::vector<char> flushing;
+    std::future<bool> flushed;
+    std::uint64_t size;
+    bool failed;
+  };
+
+  static bool FlushAll(AsyncOutput &o, const std::vector<char> &d) {
+#if defined(__unix__) || defined(__APPLE__)
+    std::size_t done = 0;
+    while (done < d.size()) {
+      const auto n = ::write(o.file.fd, d.data() + done, d.size() - done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      done += static_cast<std::size_t>(n);
+    }
+    return true;
+#else
+    return bool(o.file.write(d.data(), d.size()));
+#endif
+  }
+
+  static bool WaitFlush(AsyncOutput &o) {
+    if (o.flushed.valid() && !o.flushed.get())
+      o.failed = true;
+    return !o.failed;
+  }
+
+  static void FlushAsync(AsyncOutput &o) {
+    WaitFlush(o);
+    std::swap(o.buffer, o.flushing);
+    o.buffer.clear();
+    auto *output = &o;
+    o.flushed = std::async(std::launch::async, [output]() { return FlushAll(*output, output->flushing); });
+  }
+
+  void WriteBytes(AsyncOutput &o, const char *d, std::size_t s) const {
+    o.buffer.insert(o.buffer.end(), d, d + s);
+    o.size += s;
+    if (o.buffer.size() >= AsyncBlockSize())
+      FlushAsync(o);
+  }
+
+  std::uint64_t Position(AsyncOutput &o) const {
+    return o.size;
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  static constexpr std::size_t FileBlockSize() {
+    return 1 << 20;
+  }
+
+  static constexpr std::size_t FileBlockCount() {
+    return 4;
+  }
+
+#ifdef COREBUFFER_IO_URING
+  struct FileRing {
+    int fd{-1};
+    void *sqRing;
+    void *cqRing;
+    io_uring_sqe *sqes;
+    std::size_t sqRingSize;
+    std::size_t cqRingSize;
+    std::size_t sqesSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    io_uring_cqe *cqes;
+  };
+
+  static void CloseRing(FileRing &r) {
+    if (r.sqes)
+      ::munmap(r.sqes, r.sqesSize);
+    if (r.cqRing)
+      ::munmap(r.cqRing, r.cqRingSize);
+    if (r.sqRing)
+      ::munmap(r.sqRing, r.sqRingSize);
+    if (r.fd >= 0)
+      ::close(r.fd);
+    r = FileRing();
+    r.fd = -1;
+  }
+
+  static bool SetupRing(FileRing &r, char *buffer, std::size_t size) {
+    r = FileRing();
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    r.fd = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(FileBlockCount()), &params));
+    if (r.fd < 0)
+      return false;
+    r.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    r.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    r.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    const auto map = [&r](std::size_t length, off_t offset) -> void * {
+      void *p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, offset);
+      return p == MAP_FAILED ? nullptr : p;
+    };
+    r.sqRing = map(r.sqRingSize, IORING_OFF_SQ_RING);
+    r.cqRing = map(r.cqRingSize, IORING_OFF_CQ_RING);
+    r.sqes = static_cast<io_uring_sqe *>(map(r.sqesSize, IORING_OFF_SQES));
+    iovec registered{buffer, size};
+    if (!r.sqRing || !r.cqRing || !r.sqes ||
+        ::syscall(__NR_io_uring_register, r.fd, IORING_REGISTER_BUFFERS, &registered, 1) != 0) {
+      CloseRing(r);
+      return false;
+    }
+    auto *sq = static_cast<char *>(r.sqRing);
+    r.sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    r.sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    r.sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    r.sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(r.cqRing);
+    r.cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    r.cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    r.cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    r.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  static bool SubmitFixed(FileRing &r, bool write, int fd, char *d, std::size_t s, std::uint64_t offset,
+                          std::uint64_t tag) {
+    const auto tail = *r.sqTail;
+    const auto slot = tail & *r.sqMask;
+    auto &sqe = r.sqes[slot];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(d);
+    sqe.len = static_cast<std::uint32_t>(s);
+    sqe.off = offset;
+    sqe.buf_index = 0;
+    sqe.user_data = tag;
+    r.sqArray[slot] = slot;
+    __atomic_store_n(r.sqTail, tail + 1, __ATOMIC_RELEASE);
+    long submitted = 0;
+    do
+      submitted = ::syscall(__NR_io_uring_enter, r.fd, 1, 0, 0, nullptr, 0);
+    while (submitted < 0 && errno == EINTR);
+    if (submitted == 1 || __atomic_load_n(r.sqHead, __ATOMIC_ACQUIRE) != tail)
+      return true;
+    __atomic_store_n(r.sqTail, tail, __ATOMIC_RELEASE);
+    return false;
+  }
+
+  static bool WaitFixed(FileRing &r, std::uint64_t &tag, int &result) {
+    for (;;) {
+      const auto head = *r.cqHead;
+      if (head != __atomic_load_n(r.cqTail, __ATOMIC_ACQUIRE)) {
+        const auto &cqe = r.cqes[head & *r.cqMask];
+        tag = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(r.cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+      if (::syscall(__NR_io_uring_enter, r.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+        return false;
+    }
+  }
+
+#else
+  struct FileRing {
+    int fd{-1};
+  };
+
+  static void CloseRing(FileRing &r) {
+    r.fd = -1;
+  }
+
+  static bool SetupRing(FileRing &r, char *, std::size_t) {
+    r.fd = -1;
+    return false;
+  }
+
+  static bool SubmitFixed(FileRing &, bool, int, char *, std::size_t, std::uint64_t, std::uint64_t) {
+    return false;
+  }
+
+  static bool WaitFixed(FileRing &, std::uint64_t &, int &) {
+    return false;
+  }
+
+#endif
+
+  static bool PreadAll(int fd, char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pread(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  struct FileOutput {
+    ~FileOutput() {
+      CloseRing(ring);
+    }
+    FileHandle file;
+    FileRing ring;
+    std::vector<char> blocks;
+    std::vector<std::size_t> pending;
+    std::vector<std::uint64_t> offsets;
+    std::size_t block;
+    std::size_t used;
+    std::uint64_t size;
+    bool failed;
+  };
+
+  static void CompleteWrite(FileOutput &o) {
+    std::uint64_t block = 0;
+    int result = 0;
+    if (!WaitFixed(o.ring, block, result) || block >= FileBlockCount()) {
+      o.failed = true;
+      std::fill(o.pending.begin(), o.pending.end(), 0);
+      return;
+    }
+    const auto length = o.pending[block];
+    const auto done = static_cast<std::size_t>(std::max(result, 0));
+    if (result < 0 || (done < length && !PwriteAll(o.file.fd, o.blocks.data() + block * FileBlockSize() + done,
+                                                     length - done, o.offsets[block] + done)))
+      o.failed = true;
+    o.pending[block] = 0;
+  }
+
+  static void SubmitBlock(FileOutput &o) {
+    if (o.used == 0)
+      return;
+    auto *d = o.blocks.data() + o.block * FileBlockSize();
+    if (o.ring.fd >= 0 && SubmitFixed(o.ring, true, o.file.fd, d, o.used, o.size, o.block)) {
+      o.pending[o.block] = o.used;
+      o.offsets[o.block] = o.size;
+    } else if (!PwriteAll(o.file.fd, d, o.used, o.size)) {
+      o.failed = true;
+    }
+    o.size += o.used;
+    o.used = 0;
+    o.block = (o.block + 1) % FileBlockCount();
+    while (o.pending[o.block] != 0)
+      CompleteWrite(o);
+  }
+
+  void WriteBytes(FileOutput &o, const char *d, std::size_t s) const {
+    while (s != 0) {
+      const auto n = std::min(s, FileBlockSize() - o.used);
+      std::memcpy(o.blocks.data() + o.block * FileBlockSize() + o.used, d, n);
+      o.used += n;
+      d += n;
+      s -= n;
+      if (o.used == FileBlockSize())
+        SubmitBlock(o);
+    }
+  }
+
+  static bool FinishOutput(FileOutput &o) {
+    SubmitBlock(o);
+    for (std::size_t block = 0; block < FileBlockCount(); ++block)
+      while (o.pending[block] != 0)
+        CompleteWrite(o);
+    CloseRing(o.ring);
+    return !o.failed;
+  }
+
+  struct FileInput {
+    ~FileInput() {
+      CloseRing(ring);
+    }
+    FileHandle file;
+    FileRing ring;
+    std::vector<char> blocks;
+    std::vector<char> loaded;
+    std::uint64_t size;
+    std::uint64_t current;
+    std::size_t pos;
+    std::size_t pending;
+    bool failed;
+  };
+
+  static std::size_t BlockLength(const FileInput &i, std::uint64_t block) {
+    if (block * FileBlockSize() >= i.size)
+      return 0;
+    return static_cast<std::size_t>(std::min<std::uint64_t>(FileBlockSize(), i.size - block * FileBlockSize()));
+  }
+
+  static void RequestBlock(FileInput &i, std::uint64_t block) {
+    const auto slot = block % FileBlockCount();
+    i.loaded[slot] = 0;
+    if (BlockLength(i, block) == 0 || i.ring.fd < 0)
+      return;
+    if (SubmitFixed(i.ring, false, i.file.fd, i.blocks.data() + slot * FileBlockSize(), BlockLength(i, block),
+                    block * FileBlockSize(), block))
+      ++i.pending;
+  }
+
+  static void CompleteRead(FileInput &i) {
+    std::uint64_t block = 0;
+    int result = 0;
+    if (!WaitFixed(i.ring, block, result)) {
+      i.failed = true;
+      i.pending = 0;
+      return;
+    }
+    --i.pending;
+    const auto slot = block % FileBlockCount();
+    const auto length = BlockLength(i, block);
+    const auto done = static_cast<std::size_t>(std::max(result, 0));
+    auto *d = i.blocks.data() + slot * FileBlockSize();
+    i.loaded[slot] = result >= 0 && (done >= length || PreadAll(i.file.fd, d + done, length - done,
+                                                                   block * FileBlockSize() + done));
+    if (!i.loaded[slot])
+      i.failed = true;
+  }
+
+  static bool LoadBlock(FileInput &i, std::uint64_t block) {
+    const auto slot = block % FileBlockCount();
+    while (!i.loaded[slot] && i.pending != 0 && !i.failed)
+      CompleteRead(i);
+    if (i.loaded[slot])
+      return true;
+    return !i.failed && BlockLength(i, block) != 0 &&
+           PreadAll(i.file.fd, i.blocks.data() + slot * FileBlockSize(), BlockLength(i, block), block * FileBlockSize());
+  }
+
+  void ReadBytes(FileInput &i, char *d, std::size_t s) {
+    while (s != 0) {
+      if (i.failed) {
+        std::memset(d, 0, s);
+        return;
+      }
+      if (i.pos == BlockLength(i, i.current)) {
+        RequestBlock(i, i.current + FileBlockCount());
+        ++i.current;
+        i.pos = 0;
+        if (!LoadBlock(i, i.current))
+          Fail(i);
+        continue;
+      }
+      const auto n = std::min(s, BlockLength(i, i.current) - i.pos);
+      std::memcpy(d, i.blocks.data() + (i.current % FileBlockCount()) * FileBlockSize() + i.pos, n);
+      i.pos += n;
+      d += n;
+      s -= n;
+    }
+  }
+
+  bool Failed(FileInput &i) {
+    return i.failed;
+  }
+
+  void Fail(FileInput &i) {
+    if (!i.failed)
+      error_offset_ = i.current * FileBlockSize() + i.pos;
+    i.failed = true;
+  }
+
+  static std::uint64_t Remaining(const FileInput &i) {
+    return i.size - i.current * FileBlockSize() - i.pos;
+  }
+
+  bool Available(FileInput &i, std::size_t count, std::size_t size) {
+    if (count <= Remaining(i) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  static bool FinishInput(FileInput &i) {
+    while (i.pending != 0)
+      CompleteRead(i);
+    CloseRing(i.ring);
+    return i.file.close() && !i.failed;
+  }
+
+  std::uint64_t Position(FileOutput &o) const {
+    return o.size + o.used;
+  }
+
+#endif
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteHero(std::ostream &o, const Hero &v) const {
+
+    OutputStream s{o, 0};
+    WriteHeader(s);
+    WriteIndexed(s, v);
+  }
+
+  void WriteHero(std::vector<char> &b, const Hero &v) const {
+
+    OutputBuffer o{b, b.size()};
+    WriteHeader(o);
+    WriteIndexed(o, v);
+    b.resize(o.size);
+  }
+
+  bool ReadHero(std::istream &stream, Hero &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadHero(const char *data, std::size_t size, Hero &v) {
+
+    InputBuffer i{data, size, 0, false};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  void WriteHeroParallel(std::ostream &o, const Hero &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+
+    OutputStream s{o, 0};
+    WriteHeader(s);
+    WriteParallel(s, v, threads);
+  }
+
+  void WriteHeroParallel(std::vector<char> &b, const Hero &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+
+    OutputBuffer o{b, b.size()};
+    WriteHeader(o);
+    WriteParallel(o, v, threads);
+    b.resize(o.size);
+  }
+
+  bool ReadHeroParallel(const char *data, std::size_t size, Hero &v, unsigned int threads = std::thread::hardware_concurrency()) {
+
+    InputBuffer i{data, size, 0, false};
+    if (!ReadHeader(i))
+      return false;
+    ReadParallel(i, v, threads);
+    return !i.failed;
+  }
+
+  void WriteHeroCompressed(std::ostream &o, const Hero &v) const {
+
+    o.write("CORZ", 4);
+    CompressedOutput c{o, {}, {}};
+    c.block.reserve(CompressedBlockSize());
+    WriteHeader(c);
+    Write(c, v);
+    FlushBlock(c);
+    const std::uint32_t end[2] = {0, 0};
+    o.write(reinterpret_cast<const char *>(end), sizeof(end));
+  }
+
+  bool ReadHeroCompressed(std::istream &i, Hero &v) {
+
+    char marker[4];
+    i.read(marker, 4);
+    if (!i || std::memcmp(marker, "CORZ", 4) != 0)
+      return false;
+    CompressedInput c{MakeInput(i), {}, {}, 0, 0, false};
+    if (!ReadHeader(c))
+      return false;
+    Read(c, v);
+    std::uint32_t end[2] = {1, 1};
+    i.read(reinterpret_cast<char *>(end), sizeof(end));
+    return !c.failed && c.pos == c.block.size() && i && end[0] == 0;
+  }
+
+  bool ReadHeroAbilitiesAt(std::istream &stream, std::size_t index, Ability &v) {
+    auto i = MakeInput(stream);
+    if (!SeekVectorEntry(i, 0, index))
+      return false;
+    Read(i, v);
+    return !Failed(i);
+  }
+
+  bool ReadHeroAbilitiesAt(const char *data, std::size_t size, std::size_t index, Ability &v) {
+    InputBuffer i{data, size, 0, false};
+    if (!SeekVectorEntry(i, 0, index))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ViewHero(const char *data, std::size_t size, HeroView &v);
+
+  bool VerifyHero(const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false};
+    if (!ReadHeader(i))
+      return false;
+    VerifyIndexed(i);
+    if (!i.failed && i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  void WriteHeroDelta(std::ostream &o, Hero &v) const {
+    OutputStream s{o, 0};
+    WriteDelta(s, v);
+  }
+
+  void WriteHeroDelta(std::vector<char> &b, Hero &v) const {
+    OutputBuffer o{b, b.size()};
+    WriteDelta(o, v);
+    b.resize(o.size);
+  }
+
+  bool ApplyHeroDelta(std::istream &stream, Hero &v) {
+    auto i = MakeInput(stream);
+    return ApplyDelta(i, v);
+  }
+
+  bool ApplyHeroDelta(const char *data, std::size_t size, Hero &v) {
+    InputBuffer i{data, size, 0, false};
+    return ApplyDelta(i, v);
+  }
+
+  std::vector<char> DiffHero(const Hero &a, const Hero &b) const {
+    std::vector<char> patch;
+    OutputBuffer o{patch, 0};
+    WriteDiff(o, a, b);
+    patch.resize(o.size);
+    return patch;
+  }
+
+  bool PatchHero(Hero &v, const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false};
+    if (!ApplyDiff(i, v))
+      return false;
+    if (i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  bool PatchHero(Hero &v, const std::vector<char> &patch) {
+    return PatchHero(v, patch.data(), patch.size());
+  }
+
+  bool ReplayHeroJournal(const std::string &snapshot, const std::string &journal, Hero &v) {
+    std::vector<char> state, records;
+    if (!ReadFileData(snapshot, state) || !ReadFileData(journal, records) || !ReadHero(state.data(), state.size(), v))
+      return false;
+    return ReplayJournal(records.data(), records.size(), HashBytes(0xcbf29ce484222325u, state.data(), state.size()), v);
+  }
+
+  static constexpr std::size_t SerializedSize(const Spell &) {
+    return sizeof(Spell);
+  }
+
+  static constexpr std::size_t SerializedSize(const Technique &) {
+    return sizeof(Technique);
+  }
+
+  std::size_t SerializedSize(const Ability &v) const {
+    OutputCounter c{0};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Hero &v) const {
+    OutputCounter c{0};
+    WriteHeader(c);
+    WriteIndexed(c, v);
+    return c.size;
+  }
+
+  bool LoadHeroFile(const std::string &path, Hero &v) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+      return false;
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    const auto ok = ReadHero(static_cast<const char *>(data), size, v);
+    ::munmap(data, size);
+    return ok;
+#else
+    std::ifstream i(path, std::ios::binary);
+    return i && ReadHero(i, v);
+#endif
+  }
+
+  bool SaveHeroFile(const std::string &path, const Hero &v) const {
+#if defined(__unix__) || defined(__APPLE__)
+    // the data goes to a temporary file first, path is replaced only once everything is on disk
+    const auto size = SerializedSize(v);
+    const auto temporary = path + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return false;
+    void *data = ReserveFile(fd, size) ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    OutputSpan s{static_cast<char *>(data), 0};
+    WriteHeader(s);
+    WriteIndexed(s, v);
+    const auto flushed = ::msync(data, size, MS_SYNC) == 0;
+    const auto synced = ::munmap(data, size) == 0 && flushed && ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !synced || ::rename(temporary.c_str(), path.c_str()) != 0) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    return SyncDirectory(path);
+#else
+    std::ofstream f(path, std::ios::binary);
+    WriteHero(f, v);
+    return bool(f);
+#endif
+  }
+
+  std::future<bool> SaveHeroFileAsync(const std::string &path, const Hero &v) const {
+    auto output = std::make_shared<AsyncOutput>();
+#if defined(__unix__) || defined(__APPLE__)
+    // the data goes to a temporary file first, path is replaced only once everything is on disk
+    const auto temporary = path + ".tmp";
+    output->file.fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (output->file.fd < 0) {
+#else
+    output->file.open(path, std::ios::binary);
+    if (!output->file) {
+#endif
+      std::promise<bool> failed;
+      failed.set_value(false);
+      return failed.get_future();
+    }
+    output->buffer.reserve(AsyncBlockSize());
+    output->flushing.reserve(AsyncBlockSize());
+    WriteHeader(*output);
+    WriteIndexed(*output, v);
+#if defined(__unix__) || defined(__APPLE__)
+    return std::async(std::launch::async, [output, path, temporary]() {
+      const auto ok = WaitFlush(*output) && FlushAll(*output, output->buffer);
+      if (!ok || ::fsync(output->file.fd) != 0 || !output->file.close() ||
+          ::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        return false;
+      }
+      return SyncDirectory(path);
+#else
+    return std::async(std::launch::async, [output]() {
+      const auto ok = WaitFlush(*output) && FlushAll(*output, output->buffer);
+      output->file.close();
+      return ok && !output->file.fail();
+#endif
+    });
+  }
+
+  bool SaveHeroFileUring(const std::string &path, const Hero &v) const {
+#if defined(__unix__) || defined(__APPLE__)
+    const auto temporary = path + ".tmp";
+    FileOutput f{};
+    f.file.fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (f.file.fd < 0)
+      return false;
+    f.blocks.resize(FileBlockCount() * FileBlockSize());
+    f.pending.assign(FileBlockCount(), 0);
+    f.offsets.assign(FileBlockCount(), 0);
+    SetupRing(f.ring, f.blocks.data(), f.blocks.size());
+    WriteHeader(f);
+    WriteIndexed(f, v);
+    const auto ok = FinishOutput(f);
+    if (!ok || ::fsync(f.file.fd) != 0 || !f.file.close() || ::rename(temporary.c_str(), path.c_str()) != 0) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    return SyncDirectory(path);
+#else
+    return SaveHeroFile(path, v);
+#endif
+  }
+
+  bool LoadHeroFileUring(const std::string &path, Hero &v) {
+#if defined(__unix__) || defined(__APPLE__)
+    FileInput f{};
+    f.file.fd = ::open(path.c_str(), O_RDONLY);
+    if (f.file.fd < 0)
+      return false;
+    struct stat st;
+    if (::fstat(f.file.fd, &st) != 0 || st.st_size == 0)
+      return false;
+    f.size = static_cast<std::uint64_t>(st.st_size);
+    f.blocks.resize(FileBlockCount() * FileBlockSize());
+    f.loaded.assign(FileBlockCount(), 0);
+    SetupRing(f.ring, f.blocks.data(), f.blocks.size());
+    for (std::uint64_t block = 0; block < FileBlockCount(); ++block)
+      RequestBlock(f, block);
+    f.failed = !LoadBlock(f, 0);
+    if (ReadHeader(f))
+      Read(f, v);
+    else
+      f.failed = true;
+    return FinishInput(f);
+#else
+    return LoadHeroFile(path, v);
+#endif
+  }
+
+};
+
+struct AbilityView {
+  AbilityView() = default;
+  AbilityView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  bool is_Defined() const;
+  bool is_Spell() const;
+  Spell as_Spell() const;
+  bool is_Technique() const;
+  Technique as_Technique() const;
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+struct HeroView {
+  HeroView() = default;
+  HeroView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  StringView name() const;
+  Category category() const;
+  float health() const;
+  float mana() const;
+  ListView<Hero_io, AbilityView, Ability> abilities() const;
+
+private:
+  friend struct Hero_io;
+
+  Hero_io::InputBuffer SeekMember(std::size_t member) const;
+  const char *VectorIndex(std::size_t vector, std::size_t count) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[5]{};
+  mutable std::size_t known_{0};
+};
+
+inline bool AbilityView::is_Defined() const {
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, 0, false};
+  const auto selection = io.ReadSelection(i, static_cast<const Ability *>(nullptr));
+  return !i.failed && selection != 0;
+}
+
+inline bool AbilityView::is_Spell() const {
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, 0, false};
+  const auto selection = io.ReadSelection(i, static_cast<const Ability *>(nullptr));
+  return !i.failed && selection == 1;
+}
+
+inline Spell AbilityView::as_Spell() const {
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, 0, false};
+  if (io.ReadSelection(i, static_cast<const Ability *>(nullptr)) != 1 || i.failed)
+    return Spell();
+  Spell v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline bool AbilityView::is_Technique() const {
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, 0, false};
+  const auto selection = io.ReadSelection(i, static_cast<const Ability *>(nullptr));
+  return !i.failed && selection == 2;
+}
+
+inline Technique AbilityView::as_Technique() const {
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, 0, false};
+  if (io.ReadSelection(i, static_cast<const Ability *>(nullptr)) != 2 || i.failed)
+    return Technique();
+  Technique v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline AbilityView Hero_io::MakeView(InputBuffer &i, const Ability *) {
+  return i.failed ? AbilityView() : AbilityView(i.data + i.pos, i.size - i.pos);
+}
+
+inline AbilityView Hero_io::MakeView(InputBuffer &i, const std::unique_ptr<Ability> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Ability *>(nullptr)) : AbilityView();
+}
+
+// the offsets of the elements from the --index-vectors trailer, nullptr if the data does not end with it
+inline const char *HeroView::VectorIndex(std::size_t vector, std::size_t count) const {
+  const std::size_t trailer = 3 * sizeof(std::uint64_t);
+  if (size_ < trailer)
+    return nullptr;
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, size_ - sizeof(std::uint64_t), false};
+  std::uint64_t length = 0;
+  io.ReadValues(i, &length, 1);
+  std::uint64_t entry[2] = {0, 0};
+  i.pos = size_ - trailer + 2 * vector * sizeof(std::uint64_t);
+  io.ReadValues(i, entry, 2);
+  if (i.failed || length != size_ || entry[0] != count || entry[1] > size_ - trailer ||
+      count > (size_ - trailer - entry[1]) / sizeof(std::uint64_t))
+    return nullptr;
+  return data_ + entry[1];
+}
+
+inline Hero_io::InputBuffer HeroView::SeekMember(std::size_t member) const {
+  Hero_io io;
+  Hero_io::InputBuffer i{data_, size_, offsets_[known_], false};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const std::string *>(nullptr)); break;
+    case 1: io.Skip(i, static_cast<const Category *>(nullptr)); break;
+    case 2: io.Skip(i, static_cast<const float *>(nullptr)); break;
+    case 3: io.Skip(i, static_cast<const float *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline StringView HeroView::name() const {
+  Hero_io io;
+  auto i = SeekMember(0);
+  return io.MakeView(i, static_cast<const std::string *>(nullptr));
+}
+
+inline Category HeroView::category() const {
+  Hero_io io;
+  auto i = SeekMember(1);
+  Category v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline float HeroView::health() const {
+  Hero_io io;
+  auto i = SeekMember(2);
+  float v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline float HeroView::mana() const {
+  Hero_io io;
+  auto i = SeekMember(3);
+  float v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline ListView<Hero_io, AbilityView, Ability> HeroView::abilities() const {
+  Hero_io io;
+  auto i = SeekMember(4);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, 1))
+    return ListView<Hero_io, AbilityView, Ability>();
+  return ListView<Hero_io, AbilityView, Ability>(data_, size_, i.pos, s, VectorIndex(0, s));
+}
+
+inline HeroView Hero_io::MakeView(InputBuffer &i, const Hero *) {
+  return i.failed ? HeroView() : HeroView(i.data + i.pos, i.size - i.pos);
+}
+
+inline HeroView Hero_io::MakeView(InputBuffer &i, const std::unique_ptr<Hero> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Hero *>(nullptr)) : HeroView();
+}
+
+inline bool Hero_io::ViewHero(const char *data, std::size_t size, HeroView &v) {
+  InputBuffer i{data, size, 0, false};
+  if (!ReadHeader(i))
+    return false;
+  v = HeroView(i.data + i.pos, i.size - i.pos);
+  return true;
+}
+
+struct HeroWriter {
+  explicit HeroWriter(std::ostream &o) : o_(o), out_{o, 0} {
+    io_.WriteHeader(out_);
+    start_ = io_.Position(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_name(const std::string &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_category(const Category &v) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_health(const float &v) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_mana(const float &v) {
+    if (next_ != 3 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_abilities() {
+    if (next_ != 4 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_abilities(std::size_t size) {
+    if (next_ != 4 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_abilities(const Ability &v) {
+    if (next_ != 4 || !open_)
+      return false;
+    abilities_index_.push_back(io_.Position(out_) - start_);
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_abilities() {
+    if (next_ != 4 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    io_.WriteVectorIndex(out_, start_, {&abilities_index_});
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 5;
+
+  std::ostream &o_;
+  Hero_io::OutputStream out_;
+  Hero_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+  std::uint64_t start_{0};
+  std::vector<std::uint64_t> abilities_index_;
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+struct HeroJournal {
+  HeroJournal(const std::string &path, Hero &root) : path_(path), root_(root) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    struct stat st;
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+      failed_ = true;
+      return;
+    }
+    // a crash while the marker was written leaves less than the marker and no records, that starts over
+    if (st.st_size < 7) {
+      failed_ = (st.st_size != 0 && ::ftruncate(fd_, 0) != 0) || !WriteAll(fd_, "JRNE0.1", 7) || !Sync(fd_);
+      size_ = end_ = 7;
+      return;
+    }
+    std::vector<char> data(static_cast<std::size_t>(st.st_size));
+    // a crash can leave an incomplete record behind, new records have to follow the last complete one
+    const auto end = ReadAll(fd_, data.data(), data.size(), 0) ? io_.JournalEnd(data.data(), data.size()) : 0;
+    failed_ = end == 0 || (end < data.size() && ::ftruncate(fd_, static_cast<off_t>(end)) != 0);
+    size_ = end_ = end;
+  }
+
+  ~HeroJournal() {
+    if (compactor_.joinable())
+      compactor_.join();
+    commit();
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  HeroJournal(const HeroJournal &) = delete;
+  HeroJournal &operator=(const HeroJournal &) = delete;
+
+  void set_name(std::string v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(1, Hero_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.name = std::move(v);
+    root_.mark_name();
+  }
+
+  void set_category(Category v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(2, Hero_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.category = std::move(v);
+    root_.mark_category();
+  }
+
+  void set_health(float v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(3, Hero_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.health = std::move(v);
+    root_.mark_health();
+  }
+
+  void set_mana(float v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(4, Hero_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.mana = std::move(v);
+    root_.mark_mana();
+  }
+
+  void set_abilities(std::vector<Ability> v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(5, Hero_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.abilities = std::move(v);
+    root_.mark_abilities();
+  }
+
+  bool set_abilities(std::size_t index, Ability v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= root_.abilities.size())
+      return false;
+    auto o = record(5, Hero_io::JournalAssign);
+    io_.Write(o, index);
+    io_.Write(o, v);
+    seal(o);
+    root_.abilities[index] = std::move(v);
+    root_.mark_abilities(index, index + 1);
+    return true;
+  }
+
+  void push_abilities(Ability v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(5, Hero_io::JournalPush);
+    io_.Write(o, v);
+    seal(o);
+    root_.abilities.push_back(std::move(v));
+    root_.mark_abilities(root_.abilities.size() - 1, root_.abilities.size());
+  }
+
+  bool insert_abilities(std::size_t index, Ability v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index > root_.abilities.size())
+      return false;
+    auto o = record(5, Hero_io::JournalInsert);
+    io_.Write(o, index);
+    io_.Write(o, v);
+    seal(o);
+    root_.abilities.insert(root_.abilities.begin() + index, std::move(v));
+    root_.mark_abilities(index, root_.abilities.size());
+    return true;
+  }
+
+  bool erase_abilities(std::size_t first, std::size_t last) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (first > last || last > root_.abilities.size())
+      return false;
+    auto o = record(5, Hero_io::JournalErase);
+    io_.Write(o, first);
+    io_.Write(o, last);
+    seal(o);
+    root_.abilities.erase(root_.abilities.begin() + first, root_.abilities.begin() + last);
+    root_.mark_abilities(first, root_.abilities.size());
+    return true;
+  }
+
+  // returns once every operation recorded so far is on disk, concurrent commits share one sync
+  bool commit() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto target = appended_;
+    while (!failed_ && durable_ < target) {
+      if (syncing_) {
+        synced_.wait(lock);
+        continue;
+      }
+      syncing_ = true;
+      flushing_.swap(pending_);
+      pending_.clear();
+      const auto records = appended_;
+      lock.unlock();
+      const auto ok = WriteAll(fd_, flushing_.data(), flushing_.size()) && Sync(fd_);
+      lock.lock();
+      syncing_ = false;
+      failed_ = failed_ || !ok;
+      size_ += flushing_.size();
+      durable_ = records;
+      synced_.notify_all();
+    }
+    return !failed_;
+  }
+
+  // saves the current state as snapshot in the background, afterwards the journal only keeps later operations
+  std::future<bool> compact(const std::string &snapshot) {
+    if (compactor_.joinable())
+      compactor_.join();
+    auto state = std::make_shared<std::vector<char>>();
+    std::uint64_t point = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      io_.WriteHero(*state, root_);
+      point = end_;
+    }
+    auto done = std::make_shared<std::promise<bool>>();
+    compactor_ = std::thread([this, snapshot, state, point, done]() {
+      done->set_value(save(snapshot, *state, point));
+    });
+    return done->get_future();
+  }
+
+private:
+  static bool WriteAll(int fd, const char *d, std::size_t s) {
+    while (s != 0) {
+      const auto n = ::write(fd, d, s);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+    }
+    return true;
+  }
+
+  static bool ReadAll(int fd, char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pread(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  static bool Sync(int fd) {
+#if defined(__APPLE__)
+    return ::fsync(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+  }
+
+  Hero_io::OutputBuffer record(std::uint32_t member, std::uint32_t operation) {
+    start_ = pending_.size();
+    pending_.resize(start_ + Hero_io::JournalFrameSize());
+    Hero_io::OutputBuffer o{pending_, pending_.size()};
+    io_.Write(o, member);
+    io_.Write(o, operation);
+    return o;
+  }
+
+  void seal(Hero_io::OutputBuffer &o) {
+    pending_.resize(o.size);
+    io_.WriteJournalFrame(pending_, start_);
+    end_ += pending_.size() - start_;
+    ++appended_;
+  }
+
+  // point is the end of the journal at the time the state was taken
+  bool save(const std::string &path, const std::vector<char> &state, std::uint64_t point) {
+    const auto temporary = path + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return false;
+    const auto written = WriteAll(fd, state.data(), state.size()) && Sync(fd);
+    if (::close(fd) != 0 || !written) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    // the checkpoint follows the synced snapshot and has to be on disk before the snapshot replaces the old one
+    const auto hash = io_.HashBytes(0xcbf29ce484222325u, state.data(), state.size());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto o = record(0, Hero_io::JournalSet);
+      io_.Write(o, hash);
+      io_.Write(o, end_ - point);
+      seal(o);
+    }
+    if (!commit() || ::rename(temporary.c_str(), path.c_str()) != 0 || !io_.SyncDirectory(path)) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    synced_.wait(lock, [this]() { return !syncing_; });
+    return !failed_ && rotate(point, hash);
+  }
+
+  // replaces the journal by one that starts with a checkpoint of the snapshot and keeps the records from point on
+  bool rotate(std::uint64_t point, std::uint64_t hash) {
+    std::vector<char> kept("JRNE0.1", "JRNE0.1" + 7);
+    kept.resize(kept.size() + Hero_io::JournalFrameSize());
+    Hero_io::OutputBuffer o{kept, kept.size()};
+    io_.Write(o, std::uint32_t(0));
+    io_.Write(o, std::uint32_t(Hero_io::JournalSet));
+    io_.Write(o, hash);
+    io_.Write(o, std::uint64_t(0));
+    kept.resize(o.size);
+    io_.WriteJournalFrame(kept, 7);
+    const auto head = kept.size();
+    kept.resize(head + static_cast<std::size_t>(size_ - point));
+    if (!ReadAll(fd_, kept.data() + head, kept.size() - head, point))
+      return false;
+    const auto temporary = path_ + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0)
+      return false;
+    if (!WriteAll(fd, kept.data(), kept.size()) || !Sync(fd) || ::rename(temporary.c_str(), path_.c_str()) != 0) {
+      ::close(fd);
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    ::close(fd_);
+    fd_ = fd;
+    end_ -= size_ - kept.size();
+    size_ = kept.size();
+    return io_.SyncDirectory(path_);
+  }
+
+  std::string path_;
+  Hero &root_;
+  Hero_io io_;
+  int fd_{-1};
+  std::mutex mutex_;
+  std::condition_variable synced_;
+  std::vector<char> pending_;
+  std::vector<char> flushing_;
+  std::size_t start_{0};
+  std::uint64_t appended_{0};
+  std::uint64_t durable_{0};
+  std::uint64_t size_{0};
+  std::uint64_t end_{0};
+  bool syncing_{false};
+  bool failed_{false};
+  std::thread compactor_;
+};
+#endif
+}
+}
@@ -0,0 +1,287 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "benchmark.h"
+#include "game.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+using namespace Example::Game;
+
+namespace {
+
+Hero testHero(std::size_t abilities)
+{
+  Hero h;
+  h.name = "Benchmark Hero";
+  h.category = Category::Initiator;
+  h.health = 100.0f;
+  h.mana = 42.0f;
+  h.abilities.reserve(abilities);
+  for (std::size_t i = 0; i < abilities; ++i)
+  {
+    h.abilities.emplace_back();
+    if (i % 2 == 0)
+    {
+      auto &spell = h.abilities.back().create_Spell();
+      spell.manaCost = float(i);
+      spell.cooldown = 0.5f;
+    }
+    else
+    {
+      auto &technique = h.abilities.back().create_Technique();
+      technique.damage = float(i);
+      technique.strength = 2.0f;
+    }
+  }
+  return h;
+}
+
+}  // namespace
+
+TEST_CASE("Game io benchmark", "[benchmark]")
+{
+  const auto hero = testHero(200000);
+
+  std::vector<char> reference;
+  Hero_io().WriteHero(reference, hero);
+
+  SECTION("write")
+  {
+    benchmark("game: WriteHero(std::ostream)", reference.size(), [&hero]() {
+      std::ostringstream s;
+      Hero_io().WriteHero(s, hero);
+    });
+    benchmark("game: WriteHero(std::vector<char>)", reference.size(), [&hero]() {
+      std::vector<char> b;
+      Hero_io().WriteHero(b, hero);
+    });
+    benchmark("game: WriteHeroParallel(std::vector<char>)", reference.size(), [&hero]() {
+      std::vector<char> b;
+      Hero_io().WriteHeroParallel(b, hero);
+    });
+  }
+
+  SECTION("read")
+  {
+    const std::string data(reference.begin(), reference.end());
+    benchmark("game: ReadHero(std::istream)", reference.size(), [&data]() {
+      std::istringstream s(data);
+      Hero v;
+      Hero_io().ReadHero(s, v);
+    });
+    benchmark("game: ReadHero(const char *, std::size_t)", reference.size(), [&reference]() {
+      Hero v;
+      Hero_io().ReadHero(reference.data(), reference.size(), v);
+    });
+    benchmark("game: ReadHeroParallel(const char *, std::size_t)", reference.size(), [&reference]() {
+      Hero v;
+      Hero_io().ReadHeroParallel(reference.data(), reference.size(), v);
+    });
+    benchmark("game: VerifyHero", reference.size(), [&reference]() {
+      volatile bool verified = Hero_io().VerifyHero(reference.data(), reference.size());
+      (void)verified;
+    });
+  }
+
+  SECTION("delta")
+  {
+    // one percent of the abilities changed since the last checkpoint
+    auto changed = hero;
+    const auto change = [&changed]() {
+      for (std::size_t n = 0; n < changed.abilities.size(); n += 100)
+        changed.change_abilities(n).as_Spell().cooldown += 1.0f;
+    };
+    change();
+    std::vector<char> delta;
+    Hero_io().WriteHeroDelta(delta, changed);
+    std::cout << "game: delta of " << delta.size() << " bytes for " << reference.size() << " bytes" << std::endl;
+
+    benchmark("game: WriteHero(std::vector<char>) changed", reference.size(), [&changed]() {
+      std::vector<char> b;
+      Hero_io().WriteHero(b, changed);
+    });
+    benchmark("game: WriteHeroDelta(std::vector<char>)", reference.size(), [&changed, &change]() {
+      change();
+      std::vector<char> b;
+      Hero_io().WriteHeroDelta(b, changed);
+    });
+    benchmark("game: ApplyHeroDelta(const char *, std::size_t)", reference.size(), [&changed, &delta]() {
+      Hero_io().ApplyHeroDelta(delta.data(), delta.size(), changed);
+    });
+  }
+
+  SECTION("diff")
+  {
+    // one percent of the abilities changed and one inserted in front, which shifts all others
+    auto changed = hero;
+    for (std::size_t n = 0; n < changed.abilities.size(); n += 100)
+      changed.abilities[n].as_Spell().cooldown += 1.0f;
+    changed.abilities.insert(changed.abilities.begin(), Ability());
+    const auto patch = Hero_io().DiffHero(hero, changed);
+    std::cout << "game: patch of " << patch.size() << " bytes for " << reference.size() << " bytes" << std::endl;
+
+    benchmark("game: DiffHero", reference.size(), [&hero, &changed]() {
+      volatile auto size = Hero_io().DiffHero(hero, changed).size();
+      (void)size;
+    });
+    benchmark("game: PatchHero", reference.size(), [&hero, &patch]() {
+      auto patched = hero;
+      Hero_io().PatchHero(patched, patch);
+    });
+  }
+
+  SECTION("corrupt")
+  {
+    // an ability count flipped to a few terabytes, rejected before anything is allocated
+    auto broken = reference;
+    const auto count = 7 + sizeof(std::size_t) + hero.name.size() + sizeof(Category) + 2 * sizeof(float);
+    broken[count + 5] ^= 0x10;
+    const std::string data(broken.begin(), broken.end());
+    benchmark("game: ReadHero(std::istream) corrupt count", broken.size(), [&data]() {
+      std::istringstream s(data);
+      Hero v;
+      Hero_io().ReadHero(s, v);
+    });
+    benchmark("game: ReadHero(const char *, std::size_t) corrupt count", broken.size(), [&broken]() {
+      Hero v;
+      Hero_io().ReadHero(broken.data(), broken.size(), v);
+    });
+  }
+
+  SECTION("random access")
+  {
+    benchmark("game: ReadHeroAbilitiesAt(const char *, std::size_t)", sizeof(Ability), [&reference]() {
+      Ability a;
+      Hero_io().ReadHeroAbilitiesAt(reference.data(), reference.size(), 123456, a);
+    });
+    benchmark("game: ReadHero for a single ability", reference.size(), [&reference]() {
+      Hero v;
+      Hero_io().ReadHero(reference.data(), reference.size(), v);
+    });
+  }
+
+  SECTION("view")
+  {
+    benchmark("game: HeroView name and the last ability", reference.size(), [&reference]() {
+      HeroView v;
+      Hero_io().ViewHero(reference.data(), reference.size(), v);
+      volatile std::size_t size = v.name().size();
+      const auto abilities = v.abilities();
+      volatile bool spell = abilities[abilities.size() - 1].is_Spell();
+      (void)size;
+      (void)spell;
+    });
+    benchmark("game: HeroView damage of all techniques", reference.size(), [&reference]() {
+      HeroView v;
+      Hero_io().ViewHero(reference.data(), reference.size(), v);
+      volatile float damage = 0.0f;
+      for (const auto &a : v.abilities())
+        if (a.is_Technique())
+          damage = damage + a.as_Technique().damage;
+    });
+    benchmark("game: ReadHero damage of all techniques", reference.size(), [&reference]() {
+      Hero v;
+      Hero_io().ReadHero(reference.data(), reference.size(), v);
+      volatile float damage = 0.0f;
+      for (const auto &a : v.abilities)
+        if (a.is_Technique())
+          damage = damage + a.as_Technique().damage;
+    });
+  }
+
+  SECTION("iterate")
+  {
+    benchmark("game: damage of all techniques", reference.size(), [&hero]() {
+      volatile float damage = 0.0f;
+      for (const auto &a : hero.abilities)
+        if (a.is_Technique())
+          damage = damage + a.as_Technique().damage;
+    });
+    benchmark("game: copy abilities", reference.size(), [&hero]() {
+      const auto abilities = hero.abilities;
+    });
+  }
+
+  SECTION("file")
+  {
+    benchmark("game: SaveHeroFile", reference.size(), [&hero]() {
+      Hero_io().SaveHeroFile("game_benchmark.core", hero);
+    });
+    benchmark("game: SaveHeroFileAsync", reference.size(), [&hero]() {
+      Hero_io().SaveHeroFileAsync("game_benchmark.core", hero).wait();
+    });
+    std::remove("game_benchmark.core");
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  SECTION("journal")
+  {
+    // a hundred changed abilities made durable, against rewriting the whole snapshot
+    std::remove("game_benchmark.journal");
+    auto journaled = hero;
+    {
+      HeroJournal journal("game_benchmark.journal", journaled);
+      std::size_t next = 0;
+      benchmark("game: HeroJournal 100 changes and commit", reference.size(), [&journal, &next]() {
+        for (int n = 0; n < 100; ++n)
+          journal.set_abilities(next++ % 200000, Ability());
+        journal.commit();
+      });
+      benchmark("game: HeroJournal compact", reference.size(), [&journal]() {
+        journal.compact("game_benchmark.core").wait();
+      });
+    }
+    std::remove("game_benchmark.core");
+    std::remove("game_benchmark.journal");
+  }
+#endif
+
+  SECTION("compressed")
+  {
+    std::stringstream compressed;
+    Hero_io().WriteHeroCompressed(compressed, hero);
+    const auto data = compressed.str();
+    std::cout << "game: compression ratio " << double(reference.size()) / data.size() << std::endl;
+
+    benchmark("game: WriteHeroCompressed", reference.size(), [&hero]() {
+      std::ostringstream s;
+      Hero_io().WriteHeroCompressed(s, hero);
+    });
+    benchmark("game: ReadHeroCompressed", reference.size(), [&data]() {
+      std::istringstream s(data);
+      Hero v;
+      Hero_io().ReadHeroCompressed(s, v);
+    });
+  }
+}
+
+TEST_CASE("Game file benchmark", "[.][file]")
+{
+  // the size of the saved root in MB, raise it beyond the page cache to measure the disk
+  const char *megabytes = std::getenv("COREBUFFER_FILE_BENCHMARK_MB");
+  const auto size = std::strtoull(megabytes ? megabytes : "64", nullptr, 10) << 20;
+  const auto hero = testHero(size / 20);
+  const auto bytes = Hero_io().SerializedSize(hero);
+
+  benchmark("game file: WriteHero(std::ofstream)", bytes, [&hero]() {
+    std::ofstream f("game_file_benchmark.core", std::ios::binary);
+    Hero_io().WriteHero(f, hero);
+  });
+  benchmark("game file: SaveHeroFileUring", bytes, [&hero]() {
+    Hero_io().SaveHeroFileUring("game_file_benchmark.core", hero);
+  });
+  benchmark("game file: ReadHero(std::ifstream)", bytes, []() {
+    std::ifstream f("game_file_benchmark.core", std::ios::binary);
+    Hero v;
+    Hero_io().ReadHero(f, v);
+  });
+  benchmark("game file: LoadHeroFileUring", bytes, []() {
+    Hero v;
+    Hero_io().LoadHeroFileUring("game_file_benchmark.core", v);
+  });
+  std::remove("game_file_benchmark.core");
+}
@@ -0,0 +1,671 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "fuzz.h"
+#include "game.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace Example::Game;
+
+namespace {
+
+Hero testHero(std::size_t abilities)
+{
+  Hero h;
+  h.name = "Test Hero";
+  h.category = Category::Support;
+  h.health = 100.0f;
+  h.mana = 42.0f;
+  for (std::size_t i = 0; i < abilities; ++i)
+  {
+    h.abilities.emplace_back();
+    if (i % 3 == 0)
+      h.abilities.back().create_Spell().manaCost = float(i);
+    else
+      h.abilities.back().create_Technique().damage = float(i);
+  }
+  return h;
+}
+
+// appends to a string and can not tell its position, like a pipe
+struct AppendOnlyBuffer : std::streambuf
+{
+  std::string data;
+
+  int_type overflow(int_type c) override
+  {
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+      data.push_back(traits_type::to_char_type(c));
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override
+  {
+    data.append(s, static_cast<std::size_t>(n));
+    return n;
+  }
+};
+
+}  // namespace
+
+TEST_CASE("Indexed vector test", "[output, index]")
+{
+  SECTION("reading whats written")
+  {
+    const auto hero = testHero(10);
+
+    std::stringstream sOut;
+    Hero_io().WriteHero(sOut, hero);
+
+    Hero heroIn;
+    REQUIRE(Hero_io().ReadHero(sOut, heroIn));
+    CHECK(heroIn == hero);
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+    CHECK(buffer.size() == Hero_io().SerializedSize(hero));
+    CHECK(std::string(buffer.begin(), buffer.end()) == sOut.str());
+  }
+
+  SECTION("reading single elements")
+  {
+    const auto hero = testHero(1000);
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+
+    Ability a;
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), buffer.size(), 999, a));
+    CHECK(a == hero.abilities[999]);
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), buffer.size(), 0, a));
+    CHECK(a == hero.abilities[0]);
+    CHECK_FALSE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), buffer.size(), 1000, a));
+
+    std::stringstream sIn(std::string(buffer.begin(), buffer.end()));
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(sIn, 500, a));
+    CHECK(a == hero.abilities[500]);
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(sIn, 3, a));
+    CHECK(a == hero.abilities[3]);
+  }
+
+  SECTION("viewing single elements")
+  {
+    const auto hero = testHero(1000);
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+
+    // the offsets come from the index, or from passing the elements when the data does not end with it
+    for (const auto extra : {0, 1})
+    {
+      buffer.resize(buffer.size() + extra);
+      HeroView view;
+      REQUIRE(Hero_io().ViewHero(buffer.data(), buffer.size(), view));
+      CHECK(view.name() == hero.name);
+      const auto abilities = view.abilities();
+      REQUIRE(abilities.size() == 1000);
+      CHECK(abilities[999].as_Spell().manaCost == hero.abilities[999].as_Spell().manaCost);
+      CHECK(abilities[500].as_Technique().damage == hero.abilities[500].as_Technique().damage);
+      CHECK_FALSE(abilities[1000].is_Defined());
+
+      std::size_t spells = 0;
+      for (const auto &a : abilities)
+        spells += a.is_Spell() ? 1 : 0;
+      CHECK(spells == 334);
+    }
+  }
+
+  SECTION("writing to a stream that can not seek")
+  {
+    const auto hero = testHero(100);
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+
+    AppendOnlyBuffer streamed;
+    std::ostream sOut(&streamed);
+    REQUIRE(sOut.tellp() == std::ostream::pos_type(-1));
+    Hero_io().WriteHero(sOut, hero);
+    CHECK(streamed.data == std::string(buffer.begin(), buffer.end()));
+
+    AppendOnlyBuffer incremental;
+    std::ostream sIncremental(&incremental);
+    HeroWriter w(sIncremental);
+    REQUIRE(w.write_name(hero.name));
+    REQUIRE(w.write_category(hero.category));
+    REQUIRE(w.write_health(hero.health));
+    REQUIRE(w.write_mana(hero.mana));
+    CHECK_FALSE(w.begin_abilities());
+    REQUIRE(w.begin_abilities(hero.abilities.size()));
+    for (const auto &a : hero.abilities)
+      REQUIRE(w.push_abilities(a));
+    REQUIRE(w.end_abilities());
+    CHECK(incremental.data == streamed.data);
+
+    Ability a;
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(incremental.data.data(), incremental.data.size(), 42, a));
+    CHECK(a == hero.abilities[42]);
+  }
+
+  SECTION("reading single elements written incrementally")
+  {
+    const auto hero = testHero(100);
+
+    std::stringstream sOut;
+    HeroWriter w(sOut);
+    REQUIRE(w.write_name(hero.name));
+    REQUIRE(w.write_category(hero.category));
+    REQUIRE(w.write_health(hero.health));
+    REQUIRE(w.write_mana(hero.mana));
+    REQUIRE(w.begin_abilities());
+    for (const auto &a : hero.abilities)
+      REQUIRE(w.push_abilities(a));
+    REQUIRE(w.end_abilities());
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+    CHECK(sOut.str() == std::string(buffer.begin(), buffer.end()));
+
+    Ability a;
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(sOut, 42, a));
+    CHECK(a == hero.abilities[42]);
+  }
+
+  SECTION("reading single elements written in parallel")
+  {
+    const auto hero = testHero(10000);
+
+    std::vector<char> serial;
+    Hero_io().WriteHero(serial, hero);
+
+    std::vector<char> buffer;
+    Hero_io().WriteHeroParallel(buffer, hero, 4);
+    CHECK(buffer == serial);
+
+    std::stringstream sOut;
+    Hero_io().WriteHeroParallel(sOut, hero, 1);
+    CHECK(sOut.str() == std::string(serial.begin(), serial.end()));
+
+    Ability a;
+    REQUIRE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), buffer.size(), 7777, a));
+    CHECK(a == hero.abilities[7777]);
+  }
+
+  SECTION("reading in parallel")
+  {
+    const auto hero = testHero(10000);
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+
+    Hero heroIn;
+    REQUIRE(Hero_io().ReadHeroParallel(buffer.data(), buffer.size(), heroIn, 4));
+    CHECK(heroIn == hero);
+
+    Hero small;
+    small.abilities.resize(20000);
+    REQUIRE(Hero_io().ReadHeroParallel(buffer.data(), buffer.size(), small, 1));
+    CHECK(small == hero);
+
+    const auto empty = testHero(0);
+    buffer.clear();
+    Hero_io().WriteHero(buffer, empty);
+    REQUIRE(Hero_io().ReadHeroParallel(buffer.data(), buffer.size(), heroIn));
+    CHECK(heroIn == empty);
+  }
+
+  SECTION("Reading in parallel fails with wrong data")
+  {
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, testHero(5000));
+
+    Hero heroIn;
+    for (std::size_t size = 0; size < buffer.size(); size += 997)
+      CHECK_FALSE(Hero_io().ReadHeroParallel(buffer.data(), size, heroIn, 4));
+
+    auto broken = buffer;
+    broken[buffer.size() - 3 * sizeof(std::uint64_t) - 2500 * sizeof(std::uint64_t)] ^= 0x10;
+    CHECK_FALSE(Hero_io().ReadHeroParallel(broken.data(), broken.size(), heroIn, 4));
+
+    broken = buffer;
+    broken[buffer.size() - 1] = 'X';
+    CHECK_FALSE(Hero_io().ReadHeroParallel(broken.data(), broken.size(), heroIn, 4));
+  }
+
+  SECTION("Reading fails at the offset of corrupt data")
+  {
+    const auto hero = testHero(10);
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+
+    const std::size_t name = 8;
+    const auto count = name + sizeof(std::size_t) + hero.name.size() + sizeof(Category) + 2 * sizeof(float);
+    const auto first = count + sizeof(std::size_t);
+
+    const auto check = [](const std::vector<char> &data, std::uint64_t offset) {
+      Hero_io io;
+      Hero heroIn;
+      CHECK_FALSE(io.ReadHero(data.data(), data.size(), heroIn));
+      CHECK(io.ErrorOffset() == offset);
+      std::stringstream sIn(std::string(data.begin(), data.end()));
+      CHECK_FALSE(io.ReadHero(sIn, heroIn));
+      CHECK(io.ErrorOffset() == offset);
+    };
+
+    const std::size_t huge = std::size_t(1) << 42;
+    auto broken = buffer;
+    std::memcpy(broken.data() + name, &huge, sizeof(huge));
+    check(broken, name + sizeof(huge));
+
+    broken = buffer;
+    std::memcpy(broken.data() + count, &huge, sizeof(huge));
+    check(broken, first);
+
+    broken = buffer;
+    const int selection = 7;
+    std::memcpy(broken.data() + first, &selection, sizeof(selection));
+    check(broken, first + sizeof(selection));
+
+    broken.assign(buffer.begin(), buffer.begin() + first + 2);
+    check(broken, first);
+
+    // views leave verifying to the caller, a broken element reads as undefined
+    HeroView view;
+    broken = buffer;
+    std::memcpy(broken.data() + first, &selection, sizeof(selection));
+    CHECK_FALSE(Hero_io().VerifyHero(broken.data(), broken.size()));
+    REQUIRE(Hero_io().ViewHero(broken.data(), broken.size(), view));
+    CHECK(view.name() == hero.name);
+    REQUIRE_FALSE(view.abilities().empty());
+    CHECK_FALSE(view.abilities()[0].is_Defined());
+  }
+
+  SECTION("verifying whats written")
+  {
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, testHero(3000));
+    CHECK(Hero_io().VerifyHero(buffer.data(), buffer.size()));
+
+    auto broken = buffer;
+    broken[buffer.size() - 3 * sizeof(std::uint64_t) - 1500 * sizeof(std::uint64_t)] ^= 0x10;
+    CHECK_FALSE(Hero_io().VerifyHero(broken.data(), broken.size()));
+
+    CHECK(fuzzRoot(buffer, 500, &Hero_io::VerifyHero, &Hero_io::ReadHero, &Hero_io::ReadHeroParallel) == 0);
+  }
+
+  SECTION("writing only the changes")
+  {
+    auto hero = testHero(100000);
+    std::vector<char> snapshot;
+    Hero_io().WriteHero(snapshot, hero);
+    CHECK_FALSE(hero.has_changes());
+
+    hero.set_mana(17.0f);
+    hero.change_abilities(500).create_Technique().damage = -1.0f;
+    hero.change_abilities(90000).create_Spell().cooldown = 3.0f;
+    hero.push_abilities(Ability());
+    hero.abilities.back().create_Spell().manaCost = 9.0f;
+    CHECK(hero.has_changes());
+
+    std::stringstream delta;
+    Hero_io().WriteHeroDelta(delta, hero);
+    CHECK_FALSE(hero.has_changes());
+    CHECK(delta.str().size() < 200);
+
+    Hero heroIn;
+    REQUIRE(Hero_io().ReadHero(snapshot.data(), snapshot.size(), heroIn));
+    REQUIRE(Hero_io().ApplyHeroDelta(delta, heroIn));
+    CHECK(heroIn == hero);
+
+    hero.erase_abilities_if([](const Ability &a) { return a.is_Spell() && a.as_Spell().cooldown > 0.0f; });
+    hero.resize_abilities(95000);
+    hero.set_name("Changed Hero");
+    std::vector<char> second;
+    Hero_io().WriteHeroDelta(second, hero);
+    REQUIRE(Hero_io().ApplyHeroDelta(second.data(), second.size(), heroIn));
+    CHECK(heroIn == hero);
+
+    std::vector<char> empty;
+    Hero_io().WriteHeroDelta(empty, hero);
+    REQUIRE(Hero_io().ApplyHeroDelta(empty.data(), empty.size(), heroIn));
+    CHECK(heroIn == hero);
+    CHECK(empty.size() < 16);
+  }
+
+  SECTION("Applying changes fails with wrong data")
+  {
+    auto hero = testHero(10);
+    hero.resize_abilities(20);
+    std::vector<char> delta;
+    Hero_io().WriteHeroDelta(delta, hero);
+
+    Hero heroIn = testHero(10);
+    CHECK_FALSE(Hero_io().ApplyHeroDelta(delta.data(), delta.size() - 1, heroIn));
+
+    Hero shorter = testHero(5);
+    Hero_io io;
+    CHECK_FALSE(io.ApplyHeroDelta(delta.data(), delta.size(), shorter));
+    CHECK(io.ErrorOffset() > 0);
+
+    std::vector<char> full;
+    Hero_io().WriteHero(full, hero);
+    CHECK_FALSE(Hero_io().ApplyHeroDelta(full.data(), full.size(), heroIn));
+  }
+
+  SECTION("patching the differences")
+  {
+    const auto a = testHero(10000);
+    auto b = a;
+    b.name = "Patched Hero";
+    b.abilities.insert(b.abilities.begin() + 100, 5, Ability());
+    b.abilities[103].create_Spell().cooldown = 7.0f;
+    b.abilities.erase(b.abilities.begin() + 5000, b.abilities.begin() + 5010);
+    b.abilities[9000].create_Technique().strength = 3.0f;
+    b.abilities.emplace_back();
+
+    const auto patch = Hero_io().DiffHero(a, b);
+    std::vector<char> full;
+    Hero_io().WriteHero(full, b);
+    CHECK(patch.size() < full.size() / 100);
+
+    auto c = a;
+    REQUIRE(Hero_io().PatchHero(c, patch));
+    CHECK(c == b);
+
+    const auto nothing = Hero_io().DiffHero(b, b);
+    CHECK(nothing.size() < 24);
+    REQUIRE(Hero_io().PatchHero(c, nothing));
+    CHECK(c == b);
+  }
+
+  SECTION("Patching fails with wrong data")
+  {
+    const auto a = testHero(100);
+    auto b = a;
+    b.abilities.insert(b.abilities.begin(), Ability());
+    const auto patch = Hero_io().DiffHero(a, b);
+
+    auto shorter = testHero(50);
+    Hero_io io;
+    CHECK_FALSE(io.PatchHero(shorter, patch));
+    CHECK(io.ErrorOffset() > 0);
+
+    auto other = a;
+    other.abilities[10].create_Spell().cooldown = 9.0f;
+    const auto before = other;
+    CHECK_FALSE(Hero_io().PatchHero(other, patch));
+    CHECK(other == before);
+
+    auto c = a;
+    CHECK_FALSE(Hero_io().PatchHero(c, patch.data(), patch.size() - 1));
+    auto longer = patch;
+    longer.push_back('\0');
+    CHECK_FALSE(Hero_io().PatchHero(c, longer));
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  SECTION("replaying the journal")
+  {
+    std::remove("game_journal_test.journal");
+    auto hero = testHero(1000);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_test.core", hero));
+    Ability spell;
+    spell.create_Spell().cooldown = 2.0f;
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      journal.set_name("Journaled Hero");
+      journal.set_mana(3.0f);
+      journal.push_abilities(Ability());
+      CHECK(journal.set_abilities(10, spell));
+      CHECK(journal.insert_abilities(0, spell));
+      CHECK(journal.erase_abilities(500, 600));
+      CHECK_FALSE(journal.set_abilities(902, spell));
+      CHECK_FALSE(journal.insert_abilities(903, spell));
+      CHECK_FALSE(journal.erase_abilities(600, 500));
+      CHECK_FALSE(journal.erase_abilities(900, 903));
+      REQUIRE(journal.commit());
+    }
+    CHECK(hero.name == "Journaled Hero");
+    CHECK(hero.abilities.size() == 902);
+
+    Hero heroIn;
+    REQUIRE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", heroIn));
+    CHECK(heroIn == hero);
+
+    std::ofstream("game_journal_test.journal", std::ios::binary | std::ios::app) << "torn record";
+    Hero torn;
+    REQUIRE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", torn));
+    CHECK(torn == hero);
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      journal.set_abilities(0, Ability());
+      journal.erase_abilities(1, 3);
+    }
+    Hero reopened;
+    REQUIRE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", reopened));
+    CHECK(reopened == hero);
+    CHECK(reopened.abilities.size() == 900);
+    std::remove("game_journal_test.core");
+    std::remove("game_journal_test.journal");
+  }
+
+  SECTION("Opening a journal fails with a damaged record")
+  {
+    std::remove("game_journal_test.journal");
+    auto hero = testHero(10);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_test.core", hero));
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      journal.set_name("first");
+      journal.set_name("second");
+      REQUIRE(journal.commit());
+    }
+    std::string data;
+    {
+      std::ifstream f("game_journal_test.journal", std::ios::binary);
+      data.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    data[data.size() / 2 - 10] ^= 1;
+    std::ofstream("game_journal_test.journal", std::ios::binary | std::ios::trunc) << data;
+
+    Hero heroIn;
+    CHECK_FALSE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", heroIn));
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      CHECK_FALSE(journal.commit());
+    }
+    std::ifstream f("game_journal_test.journal", std::ios::binary | std::ios::ate);
+    CHECK(f.tellg() == std::streamoff(data.size()));
+    f.close();
+    std::remove("game_journal_test.core");
+    std::remove("game_journal_test.journal");
+  }
+
+  SECTION("Opening a journal cut off inside its marker")
+  {
+    std::remove("game_journal_test.journal");
+    auto hero = testHero(10);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_test.core", hero));
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      REQUIRE(journal.commit());
+    }
+    std::string marker;
+    {
+      std::ifstream f("game_journal_test.journal", std::ios::binary);
+      marker.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    }
+    std::ofstream("game_journal_test.journal", std::ios::binary | std::ios::trunc) << marker.substr(0, 3);
+
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      journal.set_name("after the crash");
+      REQUIRE(journal.commit());
+    }
+    Hero heroIn;
+    REQUIRE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", heroIn));
+    CHECK(heroIn.name == "after the crash");
+    std::remove("game_journal_test.core");
+    std::remove("game_journal_test.journal");
+  }
+
+  SECTION("committing from several threads")
+  {
+    std::remove("game_journal_test.journal");
+    auto hero = testHero(10);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_test.core", hero));
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      std::vector<int> failed(4);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&journal, &failed, t]() {
+          for (int n = 0; n < 50; ++n)
+          {
+            Ability a;
+            a.create_Technique().damage = float(t * 100 + n);
+            journal.push_abilities(a);
+            failed[t] += journal.commit() ? 0 : 1;
+          }
+        });
+      for (auto &t : threads)
+        t.join();
+      CHECK(failed == std::vector<int>(4));
+    }
+    CHECK(hero.abilities.size() == 210);
+
+    Hero heroIn;
+    REQUIRE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", heroIn));
+    CHECK(heroIn == hero);
+    std::remove("game_journal_test.core");
+    std::remove("game_journal_test.journal");
+  }
+
+  SECTION("compacting the journal")
+  {
+    std::remove("game_journal_test.journal");
+    auto hero = testHero(1000);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_test.core", hero));
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      for (int n = 0; n < 1000; ++n)
+        journal.set_abilities(n, Ability());
+      auto compacted = journal.compact("game_journal_test.core");
+      journal.set_name("Compacted Hero");
+      journal.push_abilities(Ability());
+      REQUIRE(compacted.get());
+      REQUIRE(journal.commit());
+
+      // a snapshot that could not be saved leaves no checkpoint behind
+      CHECK_FALSE(journal.compact("not_existing/game.core").get());
+      journal.erase_abilities(0, 10);
+    }
+
+    std::ifstream f("game_journal_test.journal", std::ios::binary | std::ios::ate);
+    CHECK(f.tellg() < 200);
+    f.close();
+
+    Hero heroIn;
+    REQUIRE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", heroIn));
+    CHECK(heroIn == hero);
+    CHECK(heroIn.name == "Compacted Hero");
+    CHECK(heroIn.abilities.size() == 991);
+    std::remove("game_journal_test.core");
+    std::remove("game_journal_test.journal");
+  }
+
+  SECTION("Replaying fails with wrong data")
+  {
+    std::remove("game_journal_test.journal");
+    auto hero = testHero(100);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_test.core", hero));
+    auto older = testHero(50);
+    REQUIRE(Hero_io().SaveHeroFile("game_journal_older.core", older));
+    {
+      HeroJournal journal("game_journal_test.journal", hero);
+      journal.erase_abilities(60, 100);
+      REQUIRE(journal.compact("game_journal_test.core").get());
+      journal.set_name("Compacted Hero");
+    }
+
+    Hero heroIn;
+    CHECK_FALSE(Hero_io().ReplayHeroJournal("game_journal_older.core", "game_journal_test.journal", heroIn));
+    CHECK_FALSE(Hero_io().ReplayHeroJournal("not_existing.core", "game_journal_test.journal", heroIn));
+    CHECK_FALSE(Hero_io().ReplayHeroJournal("game_journal_test.core", "not_existing.journal", heroIn));
+    CHECK_FALSE(Hero_io().ReplayHeroJournal("game_journal_test.core", "game_journal_test.core", heroIn));
+
+    std::remove("game_journal_test.journal");
+    auto larger = testHero(200);
+    {
+      HeroJournal journal("game_journal_test.journal", larger);
+      journal.erase_abilities(150, 200);
+    }
+    Hero_io io;
+    CHECK_FALSE(io.ReplayHeroJournal("game_journal_test.core", "game_journal_test.journal", heroIn));
+    CHECK(io.ErrorOffset() > 0);
+    std::remove("game_journal_test.core");
+    std::remove("game_journal_older.core");
+    std::remove("game_journal_test.journal");
+  }
+#endif
+
+  SECTION("saving asynchronously")
+  {
+    const auto hero = testHero(200000);
+
+    auto saved = Hero_io().SaveHeroFileAsync("game_async_test.core", hero);
+    REQUIRE(saved.get());
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+    std::ifstream f("game_async_test.core", std::ios::binary);
+    const std::string file((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    std::remove("game_async_test.core");
+    CHECK(file == std::string(buffer.begin(), buffer.end()));
+  }
+
+  SECTION("reading whats saved through io_uring")
+  {
+    const auto hero = testHero(500000);
+    REQUIRE(Hero_io().SaveHeroFileUring("game_uring_test.core", hero));
+
+    std::vector<char> buffer;
+    Hero_io().WriteHero(buffer, hero);
+    std::ifstream f("game_uring_test.core", std::ios::binary);
+    const std::string file((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    CHECK(file == std::string(buffer.begin(), buffer.end()));
+
+    Hero heroIn;
+    REQUIRE(Hero_io().LoadHeroFileUring("game_uring_test.core", heroIn));
+    CHECK(heroIn == hero);
+
+    std::ofstream truncated("game_uring_test.core", std::ios::binary);
+    truncated.write(buffer.data(), buffer.size() / 2);
+    truncated.close();
+    CHECK_FALSE(Hero_io().LoadHeroFileUring("game_uring_test.core", heroIn));
+    std::remove("game_uring_test.core");
+
+    CHECK_FALSE(Hero_io().LoadHeroFileUring("not_existing.core", heroIn));
+    CHECK_FALSE(Hero_io().SaveHeroFileUring("not_existing/game.core", hero));
+  }
+
+  SECTION("Reading single elements fails with wrong data")
+  {
+    Ability a;
+    std::vector<char> buffer;
+    CHECK_FALSE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), buffer.size(), 0, a));
+
+    Hero_io().WriteHero(buffer, testHero(10));
+    for (std::size_t size = 0; size < buffer.size(); ++size)
+      CHECK_FALSE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), size, 0, a));
+
+    buffer[2] = 'X';
+    CHECK_FALSE(Hero_io().ReadHeroAbilitiesAt(buffer.data(), buffer.size(), 0, a));
+  }
+}
@@ -0,0 +1,565 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace Plain {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+struct Point;
+struct Node;
+struct Holder;
+
+struct Point {
+  std::int32_t x{0};
+  float y{0.0f};
+
+  Point() = default;
+
+  friend bool operator==(const Point&l, const Point&r) {
+    return 
+      l.x == r.x
+      && l.y == r.y;
+  }
+
+  friend bool operator!=(const Point&l, const Point&r) {
+    return 
+      l.x != r.x
+      || l.y != r.y;
+  }
+};
+
+struct Node {
+  std::int32_t value{0};
+
+  Node() = default;
+
+  friend bool operator==(const Node&l, const Node&r) {
+    return 
+      l.value == r.value;
+  }
+
+  friend bool operator!=(const Node&l, const Node&r) {
+    return 
+      l.value != r.value;
+  }
+};
+
+struct Holder {
+  std::shared_ptr<Node> node;
+
+  Holder() = default;
+
+  friend bool operator==(const Holder&l, const Holder&r) {
+    return 
+      l.node == r.node;
+  }
+
+  friend bool operator!=(const Holder&l, const Holder&r) {
+    return 
+      l.node != r.node;
+  }
+};
+
+struct Point_io {
+private:
+  std::uint64_t error_offset_{0};
+
+  struct WriteReferences {
+    std::unordered_map<const Node *, unsigned int> Node_ids;
+  };
+
+  struct ReadReferences {
+    std::vector<std::shared_ptr<Node>> Node_objects;
+    std::uint32_t Node_count{0};
+    std::uint64_t Node_verified{0};
+  };
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::shared_ptr<T> &v, std::unordered_map<const T *, unsigned int> &ids) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+      return;
+    }
+    const auto entry = ids.emplace(v.get(), static_cast<unsigned int>(ids.size() + 1));
+    if (entry.second) {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    } else {
+      WriteBytes(o, "\x2", 1);
+      Write(o, entry.first->second);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false, {}};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache, std::uint32_t count) {
+    char ref = 0;
+    ReadBytes(s, &ref, 1);
+    if (ref == '\x1') {
+      // every object takes at least a byte, a count larger than the input left is no reason to allocate
+      if (cache.empty())
+        cache.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, Remaining(s))));
+      v = std::make_shared<T>();
+      cache.push_back(v);
+      Read(s, *v);
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(s, index);
+      if (index == 0 || index > cache.size()) {
+        Fail(s);
+        v.reset();
+      } else {
+        v = cache[index - 1];
+      }
+    } else {
+      if (ref != '\0')
+        Fail(s);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<Node> &v) const {
+    Write(o, v, o.references.Node_ids);
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<Node> &v) {
+    Read(s, v, s.references.Node_objects, s.references.Node_count);
+  }
+
+  template<typename O> void Write(O &o, const Holder &v) const {
+    Write(o, v.node);
+  }
+
+  template<typename I> void Read(I &s, Holder &v) {
+    Read(s, v.node);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.0", 3);
+    const std::uint32_t counts[1] = {};
+    WriteValues(o, counts, 1);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    if (std::memcmp(version, "0.0", 3) != 0)
+      return false;
+    std::uint32_t counts[1] = {};
+    ReadValues(i, counts, 1);
+    i.references.Node_count = counts[0];
+    return !Failed(i) && Available(i, std::size_t(counts[0]), 1);
+  }
+
+  void PatchHeader(char *header, const WriteReferences &references) const {
+    const std::uint32_t counts[1] = {
+      static_cast<std::uint32_t>(references.Node_ids.size()),
+    };
+    std::memcpy(header + 8, counts, sizeof(counts));
+  }
+
+  void PatchHeader(std::ostream &o, std::ostream::pos_type start, const WriteReferences &references) const {
+    const auto end = o.tellp();
+    if (start == std::ostream::pos_type(-1) || end == std::ostream::pos_type(-1))
+      return;
+    char header[12];
+    PatchHeader(header, references);
+    o.seekp(start + std::streamoff(8));
+    o.write(header + 8, 4);
+    o.seekp(end);
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  // owns a file descriptor, it is closed on every way out unless close() was called
+  struct FileHandle {
+    FileHandle() = default;
+    FileHandle(const FileHandle &) = delete;
+    FileHandle &operator=(const FileHandle &) = delete;
+    ~FileHandle() {
+      if (fd >= 0)
+        ::close(fd);
+    }
+    bool close() {
+      const auto closed = fd >= 0 && ::close(fd) == 0;
+      fd = -1;
+      return closed;
+    }
+    int fd{-1};
+  };
+
+  static bool PwriteAll(int fd, const char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pwrite(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  // allocates the blocks up front, so a full disk fails here and not with SIGBUS while writing a mapping
+  static bool ReserveFile(int fd, std::size_t size) {
+#if defined(__APPLE__)
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+    return ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+  }
+
+  // makes a rename into the directory of path durable
+  static bool SyncDirectory(const std::string &path) {
+    const auto slash = path.find_last_of('/');
+    const auto directory = slash == std::string::npos ? std::string(".") : path.substr(0, slash == 0 ? 1 : slash);
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+      return false;
+    const auto synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+  }
+#endif
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WritePoint(std::ostream &o, const Point &v) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WritePoint(std::vector<char> &b, const Point &v) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool ReadPoint(std::istream &stream, Point &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadPoint(const char *data, std::size_t size, Point &v) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  static constexpr std::size_t SerializedSize(const Point &) {
+    return 12 + sizeof(Point);
+  }
+
+  static constexpr std::size_t SerializedSize(const Node &) {
+    return sizeof(Node);
+  }
+
+  std::size_t SerializedSize(const Holder &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  bool LoadPointFile(const std::string &path, Point &v) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+      return false;
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    const auto ok = ReadPoint(static_cast<const char *>(data), size, v);
+    ::munmap(data, size);
+    return ok;
+#else
+    std::ifstream i(path, std::ios::binary);
+    return i && ReadPoint(i, v);
+#endif
+  }
+
+  bool SavePointFile(const std::string &path, const Point &v) const {
+#if defined(__unix__) || defined(__APPLE__)
+    // the data goes to a temporary file first, path is replaced only once everything is on disk
+    const auto size = SerializedSize(v);
+    const auto temporary = path + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return false;
+    void *data = ReserveFile(fd, size) ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    OutputSpan s{static_cast<char *>(data), 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(s.data, s.references);
+    const auto flushed = ::msync(data, size, MS_SYNC) == 0;
+    const auto synced = ::munmap(data, size) == 0 && flushed && ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !synced || ::rename(temporary.c_str(), path.c_str()) != 0) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    return SyncDirectory(path);
+#else
+    std::ofstream f(path, std::ios::binary);
+    WritePoint(f, v);
+    return bool(f);
+#endif
+  }
+
+};
+}
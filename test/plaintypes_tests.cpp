@@ -0,0 +1,35 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "plaintypes.h"
+
+#include <cstdio>
+
+using namespace Plain;
+
+TEST_CASE("plain root output test", "[output, plain]")
+{
+  Point p;
+  p.x = 42;
+  p.y = 1.5f;
+
+  SECTION("the size of a plain root includes the shared counts of the package")
+  {
+    std::vector<char> buffer;
+    Point_io().WritePoint(buffer, p);
+    CHECK(Point_io::SerializedSize(p) == buffer.size());
+
+    Point pIn;
+    REQUIRE(Point_io().ReadPoint(buffer.data(), buffer.size(), pIn));
+    CHECK(pIn == p);
+  }
+
+  SECTION("saving and loading a plain root")
+  {
+    REQUIRE(Point_io().SavePointFile("plaintypes_test.core", p));
+    Point pIn;
+    REQUIRE(Point_io().LoadPointFile("plaintypes_test.core", pIn));
+    std::remove("plaintypes_test.core");
+    CHECK(pIn == p);
+  }
+}
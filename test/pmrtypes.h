@@ -0,0 +1,1927 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+#if __cplusplus < 201703L
+#error "generated with --pmr, requires C++17"
+#endif
+#include <memory_resource>
+
+namespace PmrTypes {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+struct Leaf;
+struct Branch;
+struct Owner;
+struct Counter;
+struct Node;
+struct Root;
+
+struct Leaf {
+  std::pmr::string name{"leaf"};
+  std::pmr::vector<std::int32_t> values;
+
+  Leaf() = default;
+
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  explicit Leaf(const allocator_type &alloc)
+    : name("leaf", alloc)
+    , values(alloc)
+  {}
+  Leaf(const Leaf &other, const allocator_type &alloc)
+    : name(other.name, alloc)
+    , values(other.values, alloc)
+  {}
+  Leaf(Leaf &&other, const allocator_type &alloc)
+    : name(std::move(other.name), alloc)
+    , values(std::move(other.values), alloc)
+  {}
+
+  friend bool operator==(const Leaf&l, const Leaf&r) {
+    return 
+      l.name == r.name
+      && l.values == r.values;
+  }
+
+  friend bool operator!=(const Leaf&l, const Leaf&r) {
+    return 
+      l.name != r.name
+      || l.values != r.values;
+  }
+
+  template<class T> void fill_values(const T &v) {
+    std::fill(values.begin(), values.end(), v);
+  }
+
+  template<class Generator> void generate_values(Generator gen) {
+    std::generate(values.begin(), values.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<std::int32_t>::iterator remove_values(const T &v) {
+    return std::remove(values.begin(), values.end(), v);
+  }
+  template<class Pred> std::pmr::vector<std::int32_t>::iterator remove_values_if(Pred v) {
+    return std::remove_if(values.begin(), values.end(), v);
+  }
+
+  template<class T> void erase_values(const T &v) {
+    values.erase(remove_values(v));
+  }
+  template<class Pred> void erase_values_if(Pred v) {
+    values.erase(remove_values_if(v));
+  }
+
+  void reverse_values() {
+    std::reverse(values.begin(), values.end());
+  }
+
+  void rotate_values(std::pmr::vector<std::int32_t>::iterator i) {
+    std::rotate(values.begin(), i, values.end());
+  }
+
+  void sort_values() {
+    std::sort(values.begin(), values.end());
+  }
+  template<class Comp> void sort_values(Comp p) {
+    std::sort(values.begin(), values.end(), p);
+  }
+
+  template<class Comp> bool any_of_values(Comp p) {
+    return std::any_of(values.begin(), values.end(), p);
+  }
+  template<class T> bool any_of_values_is(const T &p) {
+    return any_of_values([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_values(Comp p) {
+    return std::all_of(values.begin(), values.end(), p);
+  }
+  template<class T> bool all_of_values_are(const T &p) {
+    return all_of_values([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_values(Comp p) {
+    return std::none_of(values.begin(), values.end(), p);
+  }
+  template<class T> bool none_of_values_is(const T &p) {
+    return none_of_values([&p](const std::int32_t &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_values(Fn p) {
+    return std::for_each(values.begin(), values.end(), p);
+  }
+
+  template<class T> std::pmr::vector<std::int32_t>::iterator find_in_values(const T &p) {
+    return std::find(values.begin(), values.end(), p);
+  }
+  template<class Comp> std::pmr::vector<std::int32_t>::iterator find_in_values_if(Comp p) {
+    return std::find_if(values.begin(), values.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<std::int32_t>::iterator>::difference_type count_in_values(const T &p) {
+    return std::count(values.begin(), values.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<std::int32_t>::iterator>::difference_type count_in_values_if(Comp p) {
+    return std::count_if(values.begin(), values.end(), p);
+  }
+};
+
+struct Branch {
+  std::pmr::string label;
+  Leaf leaf;
+  std::pmr::vector<Leaf> leaves;
+  std::pmr::vector<std::pmr::string> tags;
+
+  Branch() = default;
+
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  explicit Branch(const allocator_type &alloc)
+    : label(alloc)
+    , leaf(alloc)
+    , leaves(alloc)
+    , tags(alloc)
+  {}
+  Branch(const Branch &other, const allocator_type &alloc)
+    : label(other.label, alloc)
+    , leaf(other.leaf, alloc)
+    , leaves(other.leaves, alloc)
+    , tags(other.tags, alloc)
+  {}
+  Branch(Branch &&other, const allocator_type &alloc)
+    : label(std::move(other.label), alloc)
+    , leaf(std::move(other.leaf), alloc)
+    , leaves(std::move(other.leaves), alloc)
+    , tags(std::move(other.tags), alloc)
+  {}
+
+  friend bool operator==(const Branch&l, const Branch&r) {
+    return 
+      l.label == r.label
+      && l.leaf == r.leaf
+      && l.leaves == r.leaves
+      && l.tags == r.tags;
+  }
+
+  friend bool operator!=(const Branch&l, const Branch&r) {
+    return 
+      l.label != r.label
+      || l.leaf != r.leaf
+      || l.leaves != r.leaves
+      || l.tags != r.tags;
+  }
+
+  template<class T> void fill_leaves(const T &v) {
+    std::fill(leaves.begin(), leaves.end(), v);
+  }
+
+  template<class Generator> void generate_leaves(Generator gen) {
+    std::generate(leaves.begin(), leaves.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<Leaf>::iterator remove_leaves(const T &v) {
+    return std::remove(leaves.begin(), leaves.end(), v);
+  }
+  template<class Pred> std::pmr::vector<Leaf>::iterator remove_leaves_if(Pred v) {
+    return std::remove_if(leaves.begin(), leaves.end(), v);
+  }
+
+  template<class T> void erase_leaves(const T &v) {
+    leaves.erase(remove_leaves(v));
+  }
+  template<class Pred> void erase_leaves_if(Pred v) {
+    leaves.erase(remove_leaves_if(v));
+  }
+
+  void reverse_leaves() {
+    std::reverse(leaves.begin(), leaves.end());
+  }
+
+  void rotate_leaves(std::pmr::vector<Leaf>::iterator i) {
+    std::rotate(leaves.begin(), i, leaves.end());
+  }
+
+  template<class Comp> void sort_leaves(Comp p) {
+    std::sort(leaves.begin(), leaves.end(), p);
+  }
+
+  template<class Comp> bool any_of_leaves(Comp p) {
+    return std::any_of(leaves.begin(), leaves.end(), p);
+  }
+  template<class T> bool any_of_leaves_is(const T &p) {
+    return any_of_leaves([&p](const Leaf &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_leaves(Comp p) {
+    return std::all_of(leaves.begin(), leaves.end(), p);
+  }
+  template<class T> bool all_of_leaves_are(const T &p) {
+    return all_of_leaves([&p](const Leaf &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_leaves(Comp p) {
+    return std::none_of(leaves.begin(), leaves.end(), p);
+  }
+  template<class T> bool none_of_leaves_is(const T &p) {
+    return none_of_leaves([&p](const Leaf &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_leaves(Fn p) {
+    return std::for_each(leaves.begin(), leaves.end(), p);
+  }
+
+  template<class T> std::pmr::vector<Leaf>::iterator find_in_leaves(const T &p) {
+    return std::find(leaves.begin(), leaves.end(), p);
+  }
+  template<class Comp> std::pmr::vector<Leaf>::iterator find_in_leaves_if(Comp p) {
+    return std::find_if(leaves.begin(), leaves.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<Leaf>::iterator>::difference_type count_in_leaves(const T &p) {
+    return std::count(leaves.begin(), leaves.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<Leaf>::iterator>::difference_type count_in_leaves_if(Comp p) {
+    return std::count_if(leaves.begin(), leaves.end(), p);
+  }
+
+  template<class T> void fill_tags(const T &v) {
+    std::fill(tags.begin(), tags.end(), v);
+  }
+
+  template<class Generator> void generate_tags(Generator gen) {
+    std::generate(tags.begin(), tags.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<std::pmr::string>::iterator remove_tags(const T &v) {
+    return std::remove(tags.begin(), tags.end(), v);
+  }
+  template<class Pred> std::pmr::vector<std::pmr::string>::iterator remove_tags_if(Pred v) {
+    return std::remove_if(tags.begin(), tags.end(), v);
+  }
+
+  template<class T> void erase_tags(const T &v) {
+    tags.erase(remove_tags(v));
+  }
+  template<class Pred> void erase_tags_if(Pred v) {
+    tags.erase(remove_tags_if(v));
+  }
+
+  void reverse_tags() {
+    std::reverse(tags.begin(), tags.end());
+  }
+
+  void rotate_tags(std::pmr::vector<std::pmr::string>::iterator i) {
+    std::rotate(tags.begin(), i, tags.end());
+  }
+
+  void sort_tags() {
+    std::sort(tags.begin(), tags.end());
+  }
+  template<class Comp> void sort_tags(Comp p) {
+    std::sort(tags.begin(), tags.end(), p);
+  }
+
+  template<class Comp> bool any_of_tags(Comp p) {
+    return std::any_of(tags.begin(), tags.end(), p);
+  }
+  template<class T> bool any_of_tags_is(const T &p) {
+    return any_of_tags([&p](const std::pmr::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_tags(Comp p) {
+    return std::all_of(tags.begin(), tags.end(), p);
+  }
+  template<class T> bool all_of_tags_are(const T &p) {
+    return all_of_tags([&p](const std::pmr::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_tags(Comp p) {
+    return std::none_of(tags.begin(), tags.end(), p);
+  }
+  template<class T> bool none_of_tags_is(const T &p) {
+    return none_of_tags([&p](const std::pmr::string &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_tags(Fn p) {
+    return std::for_each(tags.begin(), tags.end(), p);
+  }
+
+  template<class T> std::pmr::vector<std::pmr::string>::iterator find_in_tags(const T &p) {
+    return std::find(tags.begin(), tags.end(), p);
+  }
+  template<class Comp> std::pmr::vector<std::pmr::string>::iterator find_in_tags_if(Comp p) {
+    return std::find_if(tags.begin(), tags.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<std::pmr::string>::iterator>::difference_type count_in_tags(const T &p) {
+    return std::count(tags.begin(), tags.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<std::pmr::string>::iterator>::difference_type count_in_tags_if(Comp p) {
+    return std::count_if(tags.begin(), tags.end(), p);
+  }
+};
+
+struct Owner {
+  std::unique_ptr<Branch> branch;
+  std::pmr::vector<std::pmr::string> names;
+
+  Owner() = default;
+
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  explicit Owner(const allocator_type &alloc)
+    : names(alloc)
+  {}
+  Owner(Owner &&other, const allocator_type &alloc)
+    : branch(std::move(other.branch))
+    , names(std::move(other.names), alloc)
+  {}
+
+  friend bool operator==(const Owner&l, const Owner&r) {
+    return 
+      l.branch == r.branch
+      && l.names == r.names;
+  }
+
+  friend bool operator!=(const Owner&l, const Owner&r) {
+    return 
+      l.branch != r.branch
+      || l.names != r.names;
+  }
+
+  template<class T> void fill_names(const T &v) {
+    std::fill(names.begin(), names.end(), v);
+  }
+
+  template<class Generator> void generate_names(Generator gen) {
+    std::generate(names.begin(), names.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<std::pmr::string>::iterator remove_names(const T &v) {
+    return std::remove(names.begin(), names.end(), v);
+  }
+  template<class Pred> std::pmr::vector<std::pmr::string>::iterator remove_names_if(Pred v) {
+    return std::remove_if(names.begin(), names.end(), v);
+  }
+
+  template<class T> void erase_names(const T &v) {
+    names.erase(remove_names(v));
+  }
+  template<class Pred> void erase_names_if(Pred v) {
+    names.erase(remove_names_if(v));
+  }
+
+  void reverse_names() {
+    std::reverse(names.begin(), names.end());
+  }
+
+  void rotate_names(std::pmr::vector<std::pmr::string>::iterator i) {
+    std::rotate(names.begin(), i, names.end());
+  }
+
+  void sort_names() {
+    std::sort(names.begin(), names.end());
+  }
+  template<class Comp> void sort_names(Comp p) {
+    std::sort(names.begin(), names.end(), p);
+  }
+
+  template<class Comp> bool any_of_names(Comp p) {
+    return std::any_of(names.begin(), names.end(), p);
+  }
+  template<class T> bool any_of_names_is(const T &p) {
+    return any_of_names([&p](const std::pmr::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_names(Comp p) {
+    return std::all_of(names.begin(), names.end(), p);
+  }
+  template<class T> bool all_of_names_are(const T &p) {
+    return all_of_names([&p](const std::pmr::string &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_names(Comp p) {
+    return std::none_of(names.begin(), names.end(), p);
+  }
+  template<class T> bool none_of_names_is(const T &p) {
+    return none_of_names([&p](const std::pmr::string &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_names(Fn p) {
+    return std::for_each(names.begin(), names.end(), p);
+  }
+
+  template<class T> std::pmr::vector<std::pmr::string>::iterator find_in_names(const T &p) {
+    return std::find(names.begin(), names.end(), p);
+  }
+  template<class Comp> std::pmr::vector<std::pmr::string>::iterator find_in_names_if(Comp p) {
+    return std::find_if(names.begin(), names.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<std::pmr::string>::iterator>::difference_type count_in_names(const T &p) {
+    return std::count(names.begin(), names.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<std::pmr::string>::iterator>::difference_type count_in_names_if(Comp p) {
+    return std::count_if(names.begin(), names.end(), p);
+  }
+};
+
+struct Counter {
+  std::uint32_t value{0u};
+  std::shared_ptr<Leaf> shared;
+
+  Counter() = default;
+
+  friend bool operator==(const Counter&l, const Counter&r) {
+    return 
+      l.value == r.value
+      && l.shared == r.shared;
+  }
+
+  friend bool operator!=(const Counter&l, const Counter&r) {
+    return 
+      l.value != r.value
+      || l.shared != r.shared;
+  }
+};
+
+struct Node {
+  Node() = default;
+  Node(const Node &o) { _clone(o); }
+  Node& operator=(const Node &o) {
+    if (this != &o)
+      *this = Node(o);
+    return *this;
+  }
+  Node(Node &&o) noexcept { _move(o); }
+  Node& operator=(Node &&o) noexcept {
+    if (this != &o) {
+      _destroy();
+      _move(o);
+    }
+    return *this;
+  }
+
+  Node(const Leaf &v)
+    : _Leaf(new Leaf(v))
+    , _selection(_Leaf_selection)
+  {}
+  Node(Leaf &&v)
+    : _Leaf(new Leaf(std::forward<Leaf>(v)))
+    , _selection(_Leaf_selection)
+  {}
+  Node & operator=(const Leaf &v) {
+    auto *n = new Leaf(v);
+    _destroy();
+    _Leaf = n;
+    _selection = _Leaf_selection;
+    return *this;
+  }
+  Node & operator=(Leaf &&v) {
+    auto *n = new Leaf(std::forward<Leaf>(v));
+    _destroy();
+    _Leaf = n;
+    _selection = _Leaf_selection;
+    return *this;
+  }
+
+  Node(const Branch &v)
+    : _Branch(new Branch(v))
+    , _selection(_Branch_selection)
+  {}
+  Node(Branch &&v)
+    : _Branch(new Branch(std::forward<Branch>(v)))
+    , _selection(_Branch_selection)
+  {}
+  Node & operator=(const Branch &v) {
+    auto *n = new Branch(v);
+    _destroy();
+    _Branch = n;
+    _selection = _Branch_selection;
+    return *this;
+  }
+  Node & operator=(Branch &&v) {
+    auto *n = new Branch(std::forward<Branch>(v));
+    _destroy();
+    _Branch = n;
+    _selection = _Branch_selection;
+    return *this;
+  }
+
+  ~Node() {
+    _destroy();
+  }
+
+  bool is_Defined() const noexcept { return _selection != no_selection; }
+  void clear() { *this = Node(); }
+  void swap(Node &o) noexcept {
+    Node t(std::move(o));
+    o = std::move(*this);
+    *this = std::move(t);
+  }
+  friend void swap(Node &l, Node &r) noexcept { l.swap(r); }
+
+  bool is_Leaf() const noexcept { return _selection == _Leaf_selection; }
+  const Leaf & as_Leaf() const noexcept { return *_Leaf; }
+  Leaf & as_Leaf() { return *_Leaf; }
+  template<typename... Args> Leaf & create_Leaf(Args&&... args) {
+    return (*this = Leaf(std::forward<Args>(args)...)).as_Leaf();
+  }
+
+  bool is_Branch() const noexcept { return _selection == _Branch_selection; }
+  const Branch & as_Branch() const noexcept { return *_Branch; }
+  Branch & as_Branch() { return *_Branch; }
+  template<typename... Args> Branch & create_Branch(Args&&... args) {
+    return (*this = Branch(std::forward<Args>(args)...)).as_Branch();
+  }
+
+  friend bool operator==(const Node&ab, const Leaf &o) noexcept  { return ab.is_Leaf() && ab.as_Leaf() == o; }
+  friend bool operator==(const Leaf &o, const Node&ab) noexcept  { return ab.is_Leaf() && o == ab.as_Leaf(); }
+  friend bool operator!=(const Node&ab, const Leaf &o) noexcept  { return !ab.is_Leaf() || ab.as_Leaf() != o; }
+  friend bool operator!=(const Leaf &o, const Node&ab) noexcept  { return !ab.is_Leaf() || o != ab.as_Leaf(); }
+
+  friend bool operator==(const Node&ab, const Branch &o) noexcept  { return ab.is_Branch() && ab.as_Branch() == o; }
+  friend bool operator==(const Branch &o, const Node&ab) noexcept  { return ab.is_Branch() && o == ab.as_Branch(); }
+  friend bool operator!=(const Node&ab, const Branch &o) noexcept  { return !ab.is_Branch() || ab.as_Branch() != o; }
+  friend bool operator!=(const Branch &o, const Node&ab) noexcept  { return !ab.is_Branch() || o != ab.as_Branch(); }
+
+  bool operator==(const Node &o) const noexcept
+  {
+    if (this == &o)
+      return true;
+    if (_selection != o._selection)
+      return false;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return true;
+    case _Leaf_selection: return *_Leaf == *o._Leaf;
+    case _Branch_selection: return *_Branch == *o._Branch;
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+  bool operator!=(const Node &o) const noexcept
+  {
+    if (this == &o)
+      return false;
+    if (_selection != o._selection)
+      return true;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return false;
+    case _Leaf_selection: return *_Leaf != *o._Leaf;
+    case _Branch_selection: return *_Branch != *o._Branch;
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+private:
+  void _clone(const Node &o) noexcept
+  {
+     _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Leaf_selection: _Leaf = new Leaf(*o._Leaf); break;
+    case _Branch_selection: _Branch = new Branch(*o._Branch); break;
+    }
+  }
+
+  void _move(Node &o) noexcept
+  {
+    _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Leaf_selection: _Leaf = o._Leaf; break;
+    case _Branch_selection: _Branch = o._Branch; break;
+    }
+    o.no_value = nullptr;
+    o._selection = no_selection;
+  }
+
+  void _destroy() noexcept {
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _Leaf_selection: delete _Leaf; break;
+    case _Branch_selection: delete _Branch; break;
+    }
+    no_value = nullptr;
+  }
+
+  union {
+    struct NoValue_t *no_value{nullptr};
+    Leaf * _Leaf;
+    Branch * _Branch;
+  };
+
+  enum Selection_t {
+    no_selection,
+    _Leaf_selection,
+    _Branch_selection,
+  };
+
+  Selection_t _selection{no_selection};
+  friend struct Root_io;
+};
+
+struct Root {
+  std::pmr::string name;
+  Branch main;
+  std::pmr::vector<Branch> branches;
+  std::pmr::vector<Owner> owners;
+  std::pmr::vector<Node> nodes;
+  Owner owner;
+  Counter counter;
+
+  Root() = default;
+
+  using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+  explicit Root(const allocator_type &alloc)
+    : name(alloc)
+    , main(alloc)
+    , branches(alloc)
+    , owners(alloc)
+    , nodes(alloc)
+    , owner(alloc)
+  {}
+  Root(Root &&other, const allocator_type &alloc)
+    : name(std::move(other.name), alloc)
+    , main(std::move(other.main), alloc)
+    , branches(std::move(other.branches), alloc)
+    , owners(std::move(other.owners), alloc)
+    , nodes(std::move(other.nodes), alloc)
+    , owner(std::move(other.owner), alloc)
+    , counter(std::move(other.counter))
+  {}
+
+  friend bool operator==(const Root&l, const Root&r) {
+    return 
+      l.name == r.name
+      && l.main == r.main
+      && l.branches == r.branches
+      && l.owners == r.owners
+      && l.nodes == r.nodes
+      && l.owner == r.owner
+      && l.counter == r.counter;
+  }
+
+  friend bool operator!=(const Root&l, const Root&r) {
+    return 
+      l.name != r.name
+      || l.main != r.main
+      || l.branches != r.branches
+      || l.owners != r.owners
+      || l.nodes != r.nodes
+      || l.owner != r.owner
+      || l.counter != r.counter;
+  }
+
+  template<class T> void fill_branches(const T &v) {
+    std::fill(branches.begin(), branches.end(), v);
+  }
+
+  template<class Generator> void generate_branches(Generator gen) {
+    std::generate(branches.begin(), branches.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<Branch>::iterator remove_branches(const T &v) {
+    return std::remove(branches.begin(), branches.end(), v);
+  }
+  template<class Pred> std::pmr::vector<Branch>::iterator remove_branches_if(Pred v) {
+    return std::remove_if(branches.begin(), branches.end(), v);
+  }
+
+  template<class T> void erase_branches(const T &v) {
+    branches.erase(remove_branches(v));
+  }
+  template<class Pred> void erase_branches_if(Pred v) {
+    branches.erase(remove_branches_if(v));
+  }
+
+  void reverse_branches() {
+    std::reverse(branches.begin(), branches.end());
+  }
+
+  void rotate_branches(std::pmr::vector<Branch>::iterator i) {
+    std::rotate(branches.begin(), i, branches.end());
+  }
+
+  template<class Comp> void sort_branches(Comp p) {
+    std::sort(branches.begin(), branches.end(), p);
+  }
+
+  template<class Comp> bool any_of_branches(Comp p) {
+    return std::any_of(branches.begin(), branches.end(), p);
+  }
+  template<class T> bool any_of_branches_is(const T &p) {
+    return any_of_branches([&p](const Branch &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_branches(Comp p) {
+    return std::all_of(branches.begin(), branches.end(), p);
+  }
+  template<class T> bool all_of_branches_are(const T &p) {
+    return all_of_branches([&p](const Branch &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_branches(Comp p) {
+    return std::none_of(branches.begin(), branches.end(), p);
+  }
+  template<class T> bool none_of_branches_is(const T &p) {
+    return none_of_branches([&p](const Branch &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_branches(Fn p) {
+    return std::for_each(branches.begin(), branches.end(), p);
+  }
+
+  template<class T> std::pmr::vector<Branch>::iterator find_in_branches(const T &p) {
+    return std::find(branches.begin(), branches.end(), p);
+  }
+  template<class Comp> std::pmr::vector<Branch>::iterator find_in_branches_if(Comp p) {
+    return std::find_if(branches.begin(), branches.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<Branch>::iterator>::difference_type count_in_branches(const T &p) {
+    return std::count(branches.begin(), branches.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<Branch>::iterator>::difference_type count_in_branches_if(Comp p) {
+    return std::count_if(branches.begin(), branches.end(), p);
+  }
+
+  template<class T> void fill_owners(const T &v) {
+    std::fill(owners.begin(), owners.end(), v);
+  }
+
+  template<class Generator> void generate_owners(Generator gen) {
+    std::generate(owners.begin(), owners.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<Owner>::iterator remove_owners(const T &v) {
+    return std::remove(owners.begin(), owners.end(), v);
+  }
+  template<class Pred> std::pmr::vector<Owner>::iterator remove_owners_if(Pred v) {
+    return std::remove_if(owners.begin(), owners.end(), v);
+  }
+
+  template<class T> void erase_owners(const T &v) {
+    owners.erase(remove_owners(v));
+  }
+  template<class Pred> void erase_owners_if(Pred v) {
+    owners.erase(remove_owners_if(v));
+  }
+
+  void reverse_owners() {
+    std::reverse(owners.begin(), owners.end());
+  }
+
+  void rotate_owners(std::pmr::vector<Owner>::iterator i) {
+    std::rotate(owners.begin(), i, owners.end());
+  }
+
+  template<class Comp> void sort_owners(Comp p) {
+    std::sort(owners.begin(), owners.end(), p);
+  }
+
+  template<class Comp> bool any_of_owners(Comp p) {
+    return std::any_of(owners.begin(), owners.end(), p);
+  }
+  template<class T> bool any_of_owners_is(const T &p) {
+    return any_of_owners([&p](const Owner &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_owners(Comp p) {
+    return std::all_of(owners.begin(), owners.end(), p);
+  }
+  template<class T> bool all_of_owners_are(const T &p) {
+    return all_of_owners([&p](const Owner &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_owners(Comp p) {
+    return std::none_of(owners.begin(), owners.end(), p);
+  }
+  template<class T> bool none_of_owners_is(const T &p) {
+    return none_of_owners([&p](const Owner &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_owners(Fn p) {
+    return std::for_each(owners.begin(), owners.end(), p);
+  }
+
+  template<class T> std::pmr::vector<Owner>::iterator find_in_owners(const T &p) {
+    return std::find(owners.begin(), owners.end(), p);
+  }
+  template<class Comp> std::pmr::vector<Owner>::iterator find_in_owners_if(Comp p) {
+    return std::find_if(owners.begin(), owners.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<Owner>::iterator>::difference_type count_in_owners(const T &p) {
+    return std::count(owners.begin(), owners.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<Owner>::iterator>::difference_type count_in_owners_if(Comp p) {
+    return std::count_if(owners.begin(), owners.end(), p);
+  }
+
+  template<class T> void fill_nodes(const T &v) {
+    std::fill(nodes.begin(), nodes.end(), v);
+  }
+
+  template<class Generator> void generate_nodes(Generator gen) {
+    std::generate(nodes.begin(), nodes.end(), gen);
+  }
+
+  template<class T> std::pmr::vector<Node>::iterator remove_nodes(const T &v) {
+    return std::remove(nodes.begin(), nodes.end(), v);
+  }
+  template<class Pred> std::pmr::vector<Node>::iterator remove_nodes_if(Pred v) {
+    return std::remove_if(nodes.begin(), nodes.end(), v);
+  }
+
+  template<class T> void erase_nodes(const T &v) {
+    nodes.erase(remove_nodes(v));
+  }
+  template<class Pred> void erase_nodes_if(Pred v) {
+    nodes.erase(remove_nodes_if(v));
+  }
+
+  void reverse_nodes() {
+    std::reverse(nodes.begin(), nodes.end());
+  }
+
+  void rotate_nodes(std::pmr::vector<Node>::iterator i) {
+    std::rotate(nodes.begin(), i, nodes.end());
+  }
+
+  template<class Comp> void sort_nodes(Comp p) {
+    std::sort(nodes.begin(), nodes.end(), p);
+  }
+
+  template<class Comp> bool any_of_nodes(Comp p) {
+    return std::any_of(nodes.begin(), nodes.end(), p);
+  }
+  template<class T> bool any_of_nodes_is(const T &p) {
+    return any_of_nodes([&p](const Node &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_nodes(Comp p) {
+    return std::all_of(nodes.begin(), nodes.end(), p);
+  }
+  template<class T> bool all_of_nodes_are(const T &p) {
+    return all_of_nodes([&p](const Node &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_nodes(Comp p) {
+    return std::none_of(nodes.begin(), nodes.end(), p);
+  }
+  template<class T> bool none_of_nodes_is(const T &p) {
+    return none_of_nodes([&p](const Node &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_nodes(Fn p) {
+    return std::for_each(nodes.begin(), nodes.end(), p);
+  }
+
+  template<class T> std::pmr::vector<Node>::iterator find_in_nodes(const T &p) {
+    return std::find(nodes.begin(), nodes.end(), p);
+  }
+  template<class Comp> std::pmr::vector<Node>::iterator find_in_nodes_if(Comp p) {
+    return std::find_if(nodes.begin(), nodes.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::pmr::vector<Node>::iterator>::difference_type count_in_nodes(const T &p) {
+    return std::count(nodes.begin(), nodes.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::pmr::vector<Node>::iterator>::difference_type count_in_nodes_if(Comp p) {
+    return std::count_if(nodes.begin(), nodes.end(), p);
+  }
+};
+
+struct Root_io {
+  friend struct RootWriter;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct WriteReferences {
+    std::unordered_map<const Leaf *, unsigned int> Leaf_ids;
+  };
+
+  struct ReadReferences {
+    std::vector<std::shared_ptr<Leaf>> Leaf_objects;
+    std::uint32_t Leaf_count{0};
+    std::uint64_t Leaf_verified{0};
+  };
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::pmr::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O> void Write(O &o, const std::pmr::vector<std::pmr::string> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::unique_ptr<T> &v) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+    } else {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::shared_ptr<T> &v, std::unordered_map<const T *, unsigned int> &ids) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+      return;
+    }
+    const auto entry = ids.emplace(v.get(), static_cast<unsigned int>(ids.size() + 1));
+    if (entry.second) {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    } else {
+      WriteBytes(o, "\x2", 1);
+      Write(o, entry.first->second);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O> void Write(O &o, const std::pmr::string &v) const {
+    Write(o, v.size());
+    WriteBytes(o, v.data(), v.size());
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false, {}};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &i, std::unique_ptr<T> &v) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      v = std::unique_ptr<T>(new T);
+      Read(i, *v);
+    } else {
+      if (ref != '\0')
+        Fail(i);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache, std::uint32_t count) {
+    char ref = 0;
+    ReadBytes(s, &ref, 1);
+    if (ref == '\x1') {
+      // every object takes at least a byte, a count larger than the input left is no reason to allocate
+      if (cache.empty())
+        cache.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, Remaining(s))));
+      v = std::make_shared<T>();
+      cache.push_back(v);
+      Read(s, *v);
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(s, index);
+      if (index == 0 || index > cache.size()) {
+        Fail(s);
+        v.reset();
+      } else {
+        v = cache[index - 1];
+      }
+    } else {
+      if (ref != '\0')
+        Fail(s);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &i, std::pmr::vector<T> &v) {
+    typename std::pmr::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename I> void Read(I &i, std::pmr::vector<std::pmr::string> &v) {
+    auto size = v.size();
+    Read(i, size);
+    if (!Available(i, size, sizeof(std::string::size_type)))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(i, entry);
+  }
+
+  template<typename I> void Read(I &i, std::pmr::string &v) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    v.resize(s);
+    ReadBytes(i, &v[0], s);
+  }
+
+  template<typename O> void Write(O &o, const Leaf &v) const {
+    Write(o, v.name);
+    Write(o, v.values);
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<Leaf> &v) const {
+    Write(o, v, o.references.Leaf_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::pmr::vector<Leaf> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &s, Leaf &v) {
+    Read(s, v.name);
+    Read(s, v.values);
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<Leaf> &v) {
+    Read(s, v, s.references.Leaf_objects, s.references.Leaf_count);
+  }
+
+  template<typename I> void Read(I &s, std::pmr::vector<Leaf> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Branch &v) const {
+    Write(o, v.label);
+    Write(o, v.leaf);
+    Write(o, v.leaves);
+    Write(o, v.tags);
+  }
+
+  template<typename O> void Write(O &o, const std::pmr::vector<Branch> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &s, Branch &v) {
+    Read(s, v.label);
+    Read(s, v.leaf);
+    Read(s, v.leaves);
+    Read(s, v.tags);
+  }
+
+  template<typename I> void Read(I &s, std::pmr::vector<Branch> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Owner &v) const {
+    Write(o, v.branch);
+    Write(o, v.names);
+  }
+
+  template<typename O> void Write(O &o, const std::pmr::vector<Owner> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &s, Owner &v) {
+    Read(s, v.branch);
+    Read(s, v.names);
+  }
+
+  template<typename I> void Read(I &s, std::pmr::vector<Owner> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Counter &v) const {
+    Write(o, v.value);
+    Write(o, v.shared);
+  }
+
+  template<typename I> void Read(I &s, Counter &v) {
+    Read(s, v.value);
+    Read(s, v.shared);
+  }
+
+  template<typename O> void Write(O &o, const Node &v) const {
+    Write(o, v._selection);
+    switch(v._selection) {
+    case Node::no_selection: while(false); /* hack for coverage tool */ break;
+    case Node::_Leaf_selection: Write(o, v.as_Leaf()); break;
+    case Node::_Branch_selection: Write(o, v.as_Branch()); break;
+    }
+  }
+
+  template<typename O> void Write(O &o, const std::pmr::vector<Node> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &i, Node &v) {
+    std::underlying_type<Node::Selection_t>::type raw = 0;
+    Read(i, raw);
+    const auto value = static_cast<std::uint64_t>(raw);
+    if (value > 2) {
+      v.clear();
+      Fail(i);
+      return;
+    }
+    switch(static_cast<Node::Selection_t>(value)) {
+    case Node::no_selection: v.clear(); break;
+    case Node::_Leaf_selection: Read(i, v.create_Leaf()); break;
+    case Node::_Branch_selection: Read(i, v.create_Branch()); break;
+    }
+  }
+
+  template<typename I> void Read(I &s, std::pmr::vector<Node> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Root &v) const {
+    Write(o, v.name);
+    Write(o, v.main);
+    Write(o, v.branches);
+    Write(o, v.owners);
+    Write(o, v.nodes);
+    Write(o, v.owner);
+    Write(o, v.counter);
+  }
+
+  template<typename I> void Read(I &s, Root &v) {
+    Read(s, v.name);
+    Read(s, v.main);
+    Read(s, v.branches);
+    Read(s, v.owners);
+    Read(s, v.nodes);
+    Read(s, v.owner);
+    Read(s, v.counter);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.0", 3);
+    const std::uint32_t counts[1] = {};
+    WriteValues(o, counts, 1);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    if (std::memcmp(version, "0.0", 3) != 0)
+      return false;
+    std::uint32_t counts[1] = {};
+    ReadValues(i, counts, 1);
+    i.references.Leaf_count = counts[0];
+    return !Failed(i) && Available(i, std::size_t(counts[0]), 1);
+  }
+
+  void PatchHeader(char *header, const WriteReferences &references) const {
+    const std::uint32_t counts[1] = {
+      static_cast<std::uint32_t>(references.Leaf_ids.size()),
+    };
+    std::memcpy(header + 8, counts, sizeof(counts));
+  }
+
+  void PatchHeader(std::ostream &o, std::ostream::pos_type start, const WriteReferences &references) const {
+    const auto end = o.tellp();
+    if (start == std::ostream::pos_type(-1) || end == std::ostream::pos_type(-1))
+      return;
+    char header[12];
+    PatchHeader(header, references);
+    o.seekp(start + std::streamoff(8));
+    o.write(header + 8, 4);
+    o.seekp(end);
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+  std::uint64_t ReadSelection(InputBuffer &i, const Node *) {
+    std::underlying_type<Node::Selection_t>::type raw = 0;
+    Read(i, raw);
+    const auto value = static_cast<std::uint64_t>(raw);
+    if (value > 2)
+      Fail(i);
+    return value;
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void VerifyEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Verify(i, static_cast<const T *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Verify(InputBuffer &i, const std::vector<std::string> *) {
+    VerifyEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Verify(i, static_cast<const T *>(nullptr));
+    else if (ref != '\0')
+      Fail(i);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  static std::uint64_t &Verified(InputBuffer &i, const Leaf *) {
+    return i.references.Leaf_verified;
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      ++Verified(i, static_cast<const T *>(nullptr));
+      Verify(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+      if (index == 0 || index > Verified(i, static_cast<const T *>(nullptr)))
+        Fail(i);
+    } else if (ref != '\0') {
+      Fail(i);
+    }
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::weak_ptr<T> *) {
+    Verify(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Leaf *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::int32_t> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Leaf> *) {
+    VerifyEach(i, static_cast<const Leaf *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Branch *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const Leaf *>(nullptr));
+    Verify(i, static_cast<const std::vector<Leaf> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::string> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Branch> *) {
+    VerifyEach(i, static_cast<const Branch *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Owner *) {
+    Verify(i, static_cast<const std::unique_ptr<Branch> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::string> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Owner> *) {
+    VerifyEach(i, static_cast<const Owner *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Counter *) {
+    Verify(i, static_cast<const std::uint32_t *>(nullptr));
+    Verify(i, static_cast<const std::shared_ptr<Leaf> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Counter> *) {
+    VerifyEach(i, static_cast<const Counter *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Node *) {
+    switch (ReadSelection(i, static_cast<const Node *>(nullptr))) {
+    case 1: Verify(i, static_cast<const Leaf *>(nullptr)); break;
+    case 2: Verify(i, static_cast<const Branch *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Node> *) {
+    VerifyEach(i, static_cast<const Node *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Root *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const Branch *>(nullptr));
+    Verify(i, static_cast<const std::vector<Branch> *>(nullptr));
+    Verify(i, static_cast<const std::vector<Owner> *>(nullptr));
+    Verify(i, static_cast<const std::vector<Node> *>(nullptr));
+    Verify(i, static_cast<const Owner *>(nullptr));
+    Verify(i, static_cast<const Counter *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Root> *) {
+    VerifyEach(i, static_cast<const Root *>(nullptr));
+  }
+
+  static constexpr std::size_t ParallelSliceMinimum() {
+    return 1024;
+  }
+
+  template<typename T> std::vector<char> EncodeSlice(const T *begin, const T *end) {
+    std::vector<char> b;
+    OutputBuffer o{b, 0, {}};
+    for (auto entry = begin; entry != end; ++entry) {
+      Write(o, *entry);
+    }
+    b.resize(o.size);
+    return b;
+  }
+
+  template<typename O, typename T> void WriteVectorParallel(O &o, const std::pmr::vector<T> &v, unsigned int threads) const {
+    Write(o, v.size());
+    const auto slices = std::min<std::size_t>(threads, v.size() / ParallelSliceMinimum());
+    if (slices < 2) {
+      for (const auto &entry : v) {
+        Write(o, entry);
+      }
+      return;
+    }
+
+    std::vector<std::future<std::vector<char>>> parts;
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto *begin = v.data() + v.size() * s / slices;
+      const auto *end = v.data() + v.size() * (s + 1) / slices;
+      parts.push_back(std::async(std::launch::async, [begin, end]() {
+        return Root_io().EncodeSlice(begin, end);
+      }));
+    }
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto part = parts[s].get();
+      WriteBytes(o, part.data(), part.size());
+    }
+  }
+
+  template<typename O> void WriteParallel(O &o, const Root &v, unsigned int threads) const {
+    Write(o, v.name);
+    Write(o, v.main);
+    WriteVectorParallel(o, v.branches, threads);
+    WriteVectorParallel(o, v.owners, threads);
+    WriteVectorParallel(o, v.nodes, threads);
+    Write(o, v.owner);
+    Write(o, v.counter);
+  }
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteRoot(std::ostream &o, const Root &v) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteRoot(std::vector<char> &b, const Root &v) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool ReadRoot(std::istream &stream, Root &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadRoot(const char *data, std::size_t size, Root &v) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  void WriteRootParallel(std::ostream &o, const Root &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    WriteParallel(s, v, threads);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteRootParallel(std::vector<char> &b, const Root &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    WriteParallel(o, v, threads);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool VerifyRoot(const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Verify(i, static_cast<const Root *>(nullptr));
+    if (!i.failed && i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  std::size_t SerializedSize(const Leaf &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Branch &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Owner &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Counter &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Node &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Root &v) const {
+    OutputCounter c{0, {}};
+    WriteHeader(c);
+    Write(c, v);
+    return c.size;
+  }
+
+};
+
+struct RootWriter {
+  explicit RootWriter(std::ostream &o) : o_(o), out_{o, 0, {}} {
+    header_ = o_.tellp();
+    io_.WriteHeader(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_name(const std::pmr::string &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_main(const Branch &v) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_branches() {
+    if (next_ != 2 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_branches(std::size_t size) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_branches(const Branch &v) {
+    if (next_ != 2 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_branches() {
+    if (next_ != 2 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_owners() {
+    if (next_ != 3 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_owners(std::size_t size) {
+    if (next_ != 3 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_owners(const Owner &v) {
+    if (next_ != 3 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_owners() {
+    if (next_ != 3 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_nodes() {
+    if (next_ != 4 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_nodes(std::size_t size) {
+    if (next_ != 4 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_nodes(const Node &v) {
+    if (next_ != 4 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_nodes() {
+    if (next_ != 4 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool write_owner(const Owner &v) {
+    if (next_ != 5 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_counter(const Counter &v) {
+    if (next_ != 6 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    io_.PatchHeader(o_, header_, out_.references);
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 7;
+
+  std::ostream &o_;
+  Root_io::OutputStream out_;
+  Root_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+  std::streampos header_{-1};
+};
+}
@@ -0,0 +1,182 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "pmrtypes.h"
+
+#include <sstream>
+
+using namespace PmrTypes;
+
+namespace {
+
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+  std::size_t allocations{0};
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override
+  {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+class DefaultResourceGuard
+{
+public:
+  explicit DefaultResourceGuard(std::pmr::memory_resource *r) : previous_(std::pmr::set_default_resource(r)) {}
+  ~DefaultResourceGuard() { std::pmr::set_default_resource(previous_); }
+
+private:
+  std::pmr::memory_resource *previous_;
+};
+
+Branch testBranch(const std::string &label)
+{
+  Branch b;
+  b.label = label + " with a name that does not fit into the small string buffer";
+  b.leaf.name = "inner leaf of " + b.label;
+  b.leaf.values = {1, 2, 3};
+  for (int i = 0; i < 20; ++i)
+  {
+    b.leaves.emplace_back();
+    b.leaves.back().values.assign(i, i);
+    b.tags.emplace_back("a tag that is long enough to need heap memory " + std::to_string(i));
+  }
+  return b;
+}
+
+Root testRoot()
+{
+  Root r;
+  r.name = "root with a name that does not fit into the small string buffer";
+  r.main = testBranch("main");
+  for (int i = 0; i < 10; ++i)
+    r.branches.push_back(testBranch(std::to_string(i)));
+  r.owner.names = {"first owner name that does not fit into the small buffer", "second"};
+  return r;
+}
+
+}  // namespace
+
+TEST_CASE("Pmr types test", "[output, pmr]")
+{
+  SECTION("default construction")
+  {
+    Leaf l;
+    CHECK(l.name == "leaf");
+    CHECK(l.name.get_allocator().resource() == std::pmr::get_default_resource());
+
+    CountingResource counting;
+    Leaf la(&counting);
+    CHECK(la.name == "leaf");
+    CHECK(la.name.get_allocator().resource() == &counting);
+    CHECK(la.values.get_allocator().resource() == &counting);
+  }
+
+  SECTION("reading into an arena")
+  {
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, testRoot());
+
+    CountingResource counting;
+    std::pmr::monotonic_buffer_resource arena(&counting);
+    Root r(&arena);
+    {
+      DefaultResourceGuard guard(std::pmr::null_memory_resource());
+      std::stringstream sIn(std::string(buffer.begin(), buffer.end()));
+      REQUIRE(Root_io().ReadRoot(sIn, r));
+    }
+    CHECK(r == testRoot());
+    CHECK(counting.allocations > 0);
+
+    CHECK(r.name.get_allocator().resource() == &arena);
+    CHECK(r.main.leaf.name.get_allocator().resource() == &arena);
+    REQUIRE(r.branches.size() == 10);
+    CHECK(r.branches[9].label.get_allocator().resource() == &arena);
+    CHECK(r.branches[9].leaves[19].values.get_allocator().resource() == &arena);
+    CHECK(r.branches[9].tags[19].get_allocator().resource() == &arena);
+    CHECK(r.owner.names[0].get_allocator().resource() == &arena);
+  }
+
+  SECTION("copying and moving between resources")
+  {
+    CountingResource counting;
+    Branch source(testBranch("source"), &counting);
+    CHECK(source.label.get_allocator().resource() == &counting);
+    CHECK(source.leaves[3].values.get_allocator().resource() == &counting);
+
+    std::pmr::monotonic_buffer_resource arena;
+    Branch copy(source, &arena);
+    CHECK(copy == source);
+    CHECK(copy.tags[0].get_allocator().resource() == &arena);
+
+    std::pmr::vector<Branch> branches(&arena);
+    branches.push_back(source);
+    branches.emplace_back();
+    CHECK(branches[0] == source);
+    CHECK(branches[0].leaf.name.get_allocator().resource() == &arena);
+    CHECK(branches[1].leaf.name == "leaf");
+    CHECK(branches[1].leaf.name.get_allocator().resource() == &arena);
+  }
+
+  SECTION("reading whats written")
+  {
+    const auto fullRoot = []() {
+      auto r = testRoot();
+      r.owners.emplace_back();
+      r.owners.back().branch.reset(new Branch(testBranch("owned")));
+      r.counter.value = 42;
+      r.counter.shared = std::make_shared<Leaf>();
+      r.nodes.emplace_back(testBranch("node"));
+      r.nodes.emplace_back(Leaf());
+      return r;
+    };
+    const auto root = fullRoot();
+
+    std::stringstream sOut;
+    Root_io().WriteRoot(sOut, root);
+
+    std::vector<char> buffer;
+    Root_io().WriteRootParallel(buffer, fullRoot(), 2);
+    CHECK(std::string(buffer.begin(), buffer.end()) == sOut.str());
+
+    std::pmr::monotonic_buffer_resource arena;
+    Root rootIn(&arena);
+    REQUIRE(Root_io().ReadRoot(sOut, rootIn));
+    REQUIRE(rootIn.owners[0].branch);
+    CHECK(*rootIn.owners[0].branch == *root.owners[0].branch);
+    REQUIRE(rootIn.counter.shared);
+    CHECK(rootIn.counter.shared->name == "leaf");
+    REQUIRE(rootIn.nodes.size() == 2);
+    CHECK(rootIn.nodes[0].as_Branch() == testBranch("node"));
+    CHECK(rootIn.main == root.main);
+    CHECK(rootIn.branches == root.branches);
+  }
+
+  SECTION("verifying without allocations")
+  {
+    auto root = testRoot();
+    root.nodes.emplace_back(testBranch("node"));
+    root.counter.shared = std::make_shared<Leaf>();
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, root);
+
+    CountingResource counting;
+    DefaultResourceGuard guard(&counting);
+    CHECK(Root_io().VerifyRoot(buffer.data(), buffer.size()));
+    CHECK(counting.allocations == 0);
+
+    Root rootIn;
+    REQUIRE(Root_io().ReadRoot(buffer.data(), buffer.size(), rootIn));
+    CHECK(counting.allocations > 0);
+  }
+}
@@ -0,0 +1,187 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "fuzz.h"
+#include "portabletypes.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace Portable;
+
+namespace {
+
+// the bytes of a value as they are written, little endian unless a little endian host is built with
+// COREBUFFER_BIG_ENDIAN to run the swap path, which writes every value the other way round
+std::string onWire(std::uint64_t v, std::size_t bytes)
+{
+  std::string s;
+  for (std::size_t n = 0; n < bytes; ++n)
+    s += static_cast<char>((v >> (8 * n)) & 0xff);
+#if COREBUFFER_BIG_ENDIAN && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  std::reverse(s.begin(), s.end());
+#endif
+  return s;
+}
+
+Numbers testNumbers()
+{
+  Numbers n;
+  n.a = -2;
+  n.b = 0x01020304;
+  n.c = -0x0102030405060708;
+  n.d = 0xfedc;
+  n.e = 0xfedcba98u;
+  n.f = 0x0102030405060708u;
+  n.g = -1;
+  n.h = 1.5f;
+  n.i = 2.25;
+  n.kind = Kind::large;
+  n.options = Options::gamma;
+  return n;
+}
+
+Root testRoot(int count)
+{
+  Root r;
+  r.numbers = testNumbers();
+  r.names.assign({"a", "bb", ""});
+  for (int i = 0; i < count; ++i)
+  {
+    r.shorts.push_back(static_cast<std::int16_t>(i * 7));
+    r.values.push_back(i * 65537);
+    r.wide.push_back(std::uint64_t(i) * 0x100000001u);
+    r.reals.push_back(i / 3.0);
+    r.kinds.push_back(i % 2 ? Kind::large : Kind::small);
+    r.table.push_back(testNumbers());
+    r.table.back().b = i;
+    r.entries.emplace_back(Name("entry", i));
+  }
+  r.first = std::make_shared<Name>("first", 64);
+  r.others.push_back(r.first);
+  r.others.push_back(std::make_shared<Name>("other", 0));
+  r.last = r.others.back();
+  return r;
+}
+
+}  // namespace
+
+TEST_CASE("portable wire format test", "[output, portable]")
+{
+  SECTION("values are little endian with 64 bit lengths")
+  {
+    Root r;
+    r.numbers = testNumbers();
+    r.names.assign({"ab"});
+    r.shorts.assign({0x0102});
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, r);
+
+    std::string expected = "CORP\x01" "0.0" + onWire(0, 4);
+    expected += onWire(0xfffe, 2) + onWire(0x01020304, 4) + onWire(-0x0102030405060708, 8);
+    expected += onWire(0xfedc, 2) + onWire(0xfedcba98u, 4) + onWire(0x0102030405060708u, 8);
+    expected += onWire(0xff, 1) + onWire(0x3fc00000u, 4) + onWire(0x4002000000000000u, 8);
+    expected += onWire(70000, 4) + onWire(4, 1);
+    expected += onWire(1, 8) + onWire(2, 8) + "ab";
+    expected += onWire(1, 8) + onWire(0x0102, 2);
+    for (int empty = 0; empty < 6; ++empty)
+      expected += onWire(0, 8);
+    expected += std::string(1, '\0') + onWire(0, 8) + std::string(1, '\0');
+
+    REQUIRE(buffer.size() >= expected.size());
+    CHECK(std::string(buffer.begin(), buffer.begin() + expected.size()) == expected);
+  }
+
+  SECTION("reading whats written")
+  {
+    const auto rOut = testRoot(3000);
+
+    std::stringstream sOut;
+    Root_io().WriteRoot(sOut, rOut);
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, rOut);
+    CHECK(std::string(buffer.begin(), buffer.end()) == sOut.str());
+    CHECK(Root_io().SerializedSize(rOut) == buffer.size());
+
+    Root rIn;
+    REQUIRE(Root_io().ReadRoot(sOut, rIn));
+    CHECK(rIn.numbers == rOut.numbers);
+    CHECK(rIn.names == rOut.names);
+    CHECK(rIn.shorts == rOut.shorts);
+    CHECK(rIn.values == rOut.values);
+    CHECK(rIn.wide == rOut.wide);
+    CHECK(rIn.reals == rOut.reals);
+    CHECK(rIn.kinds == rOut.kinds);
+    CHECK(rIn.table == rOut.table);
+    CHECK(rIn.entries == rOut.entries);
+    REQUIRE(rIn.others.size() == 2);
+    CHECK(rIn.others[0] == rIn.first);
+    CHECK(rIn.last.lock() == rIn.others[1]);
+
+    Root parallel;
+    REQUIRE(Root_io().ReadRootParallel(buffer.data(), buffer.size(), parallel, 2));
+    CHECK(parallel.table == rOut.table);
+    CHECK(parallel.entries == rOut.entries);
+
+    Numbers n;
+    REQUIRE(Root_io().ReadRootTableAt(buffer.data(), buffer.size(), 2999, n));
+    CHECK(n == rOut.table[2999]);
+  }
+
+  SECTION("viewing whats written")
+  {
+    const auto rOut = testRoot(100);
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, rOut);
+
+    RootView v;
+    REQUIRE(Root_io().ViewRoot(buffer.data(), buffer.size(), v));
+    CHECK(v.numbers().c() == rOut.numbers.c);
+    CHECK(v.numbers().i() == rOut.numbers.i);
+    REQUIRE(v.wide().size() == 100);
+    CHECK(v.wide()[99] == rOut.wide[99]);
+    CHECK(v.reals()[42] == rOut.reals[42]);
+    CHECK(v.table()[7].b() == 7);
+  }
+
+  SECTION("verifying whats written")
+  {
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, testRoot(20));
+    CHECK(Root_io().VerifyRoot(buffer.data(), buffer.size()));
+
+    CHECK(fuzzRoot(buffer, 2000, &Root_io::VerifyRoot, &Root_io::ReadRoot, &Root_io::ReadRootParallel) == 0);
+  }
+
+  SECTION("Reading fails with the native profile")
+  {
+    Root r;
+    std::stringstream s("CORE0.0");
+    CHECK_FALSE(Root_io().ReadRoot(s, r));
+  }
+
+  SECTION("swapping bytes")
+  {
+    CHECK(SwapBytes(std::uint16_t(0x0102)) == 0x0201);
+    CHECK(SwapBytes(std::uint32_t(0x01020304)) == 0x04030201u);
+    CHECK(SwapBytes(std::uint64_t(0x0102030405060708)) == 0x0807060504030201u);
+
+    std::vector<std::uint32_t> values(1001);
+    for (std::size_t n = 0; n < values.size(); ++n)
+      values[n] = static_cast<std::uint32_t>(n * 0x01010101u);
+    std::vector<std::uint32_t> swapped(values.size());
+    SwapBytes(reinterpret_cast<char *>(swapped.data()), reinterpret_cast<const char *>(values.data()), values.size(),
+              sizeof(std::uint32_t));
+    CHECK(swapped[1000] == SwapBytes(values[1000]));
+    SwapBytes(reinterpret_cast<char *>(swapped.data()), reinterpret_cast<const char *>(swapped.data()), swapped.size(),
+              sizeof(std::uint32_t));
+    CHECK(swapped == values);
+
+    char odd[6] = {1, 2, 3, 4, 5, 6};
+    SwapBytes(odd, odd, 2, 3);
+    CHECK(std::string(odd, 6) == std::string("\x3\x2\x1\x6\x5\x4", 6));
+  }
+}
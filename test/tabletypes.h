@@ -1,748 +1,4053 @@
-#pragma once
-
-#include <vector>
-#include <string>
-#include <ostream>
-#include <istream>
-#include <memory>
-#include <array>
-#include <algorithm>
-#include <type_traits>
-
-namespace Scope {
-
-template<typename T>
-struct AlwaysFalse : std::false_type {};
-
-struct TableA;
-struct TableB;
-struct TableD;
-struct TableC;
-
-template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
-  return l.lock() == r.lock();
-}
-
-template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
-  return l.lock() != r.lock();
-}
-
-struct TableA {
-  std::string name;
-  std::unique_ptr<TableD> d1;
-  std::weak_ptr<TableD> d2;
-  std::shared_ptr<TableD> d3;
-  std::shared_ptr<TableD> d4;
-
-  TableA() = default;
-  TableA(const std::string &name_)
-    : name(name_)
-  {}
-  TableA(const std::shared_ptr<TableD> &d3_)
-    : d3(d3_)
-  {}
-  TableA(const std::shared_ptr<TableD> &d2_, std::unique_ptr<TableD> d1_)
-    : d1(std::move(d1_))
-    , d2(d2_)
-  {}
-
-  friend bool operator==(const TableA&l, const TableA&r) {
-    return 
-      l.name == r.name
-      && l.d1 == r.d1
-      && l.d2 == r.d2
-      && l.d3 == r.d3
-      && l.d4 == r.d4;
-  }
-
-  friend bool operator!=(const TableA&l, const TableA&r) {
-    return 
-      l.name != r.name
-      || l.d1 != r.d1
-      || l.d2 != r.d2
-      || l.d3 != r.d3
-      || l.d4 != r.d4;
-  }
-
-private:
-  unsigned int io_counter_{0};
-  friend struct TableC_io;
-};
-
-struct TableB {
-  std::string name;
-
-  TableB() = default;
-  TableB(const std::string &name_)
-    : name(name_)
-  {}
-
-  friend bool operator==(const TableB&l, const TableB&r) {
-    return 
-      l.name == r.name;
-  }
-
-  friend bool operator!=(const TableB&l, const TableB&r) {
-    return 
-      l.name != r.name;
-  }
-
-private:
-  unsigned int io_counter_{0};
-  friend struct TableC_io;
-};
-
-struct TableD {
-  std::string name;
-  std::shared_ptr<TableA> a;
-
-  TableD() = default;
-
-  friend bool operator==(const TableD&l, const TableD&r) {
-    return 
-      l.name == r.name
-      && l.a == r.a;
-  }
-
-  friend bool operator!=(const TableD&l, const TableD&r) {
-    return 
-      l.name != r.name
-      || l.a != r.a;
-  }
-
-private:
-  unsigned int io_counter_{0};
-  friend struct TableC_io;
-};
-
-struct TableC {
-  TableA a;
-  std::vector<TableB> b;
-  std::vector<std::unique_ptr<TableB>> c;
-  std::vector<std::shared_ptr<TableB>> d;
-  std::vector<std::weak_ptr<TableB>> e;
-
-  TableC() = default;
-  TableC(std::vector<std::unique_ptr<TableB>> c_)
-    : c(std::move(c_))
-  {}
-
-  friend bool operator==(const TableC&l, const TableC&r) {
-    return 
-      l.a == r.a
-      && l.b == r.b
-      && l.c == r.c
-      && l.d == r.d
-      && l.e == r.e;
-  }
-
-  friend bool operator!=(const TableC&l, const TableC&r) {
-    return 
-      l.a != r.a
-      || l.b != r.b
-      || l.c != r.c
-      || l.d != r.d
-      || l.e != r.e;
-  }
-
-  template<class T> void fill_b(const T &v) {
-    std::fill(b.begin(), b.end(), v);
-  }
-
-  template<class Generator> void generate_b(Generator gen) {
-    std::generate(b.begin(), b.end(), gen);
-  }
-
-  template<class T> std::vector<TableB>::iterator remove_b(const T &v) {
-    return std::remove(b.begin(), b.end(), v);
-  }
-  template<class Pred> std::vector<TableB>::iterator remove_b_if(Pred v) {
-    return std::remove_if(b.begin(), b.end(), v);
-  }
-
-  template<class T> void erase_b(const T &v) {
-    b.erase(remove_b(v));
-  }
-  template<class Pred> void erase_b_if(Pred v) {
-    b.erase(remove_b_if(v));
-  }
-
-  void reverse_b() {
-    std::reverse(b.begin(), b.end());
-  }
-
-  void rotate_b(std::vector<TableB>::iterator i) {
-    std::rotate(b.begin(), i, b.end());
-  }
-
-  template<class Comp> void sort_b(Comp p) {
-    std::sort(b.begin(), b.end(), p);
-  }
-
-  template<class Comp> bool any_of_b(Comp p) {
-    return std::any_of(b.begin(), b.end(), p);
-  }
-  template<class T> bool any_of_b_is(const T &p) {
-    return any_of_b([&p](const TableB &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_b(Comp p) {
-    return std::all_of(b.begin(), b.end(), p);
-  }
-  template<class T> bool all_of_b_are(const T &p) {
-    return all_of_b([&p](const TableB &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_b(Comp p) {
-    return std::none_of(b.begin(), b.end(), p);
-  }
-  template<class T> bool none_of_b_is(const T &p) {
-    return none_of_b([&p](const TableB &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_b(Fn p) {
-    return std::for_each(b.begin(), b.end(), p);
-  }
-
-  template<class T> std::vector<TableB>::iterator find_in_b(const T &p) {
-    return std::find(b.begin(), b.end(), p);
-  }
-  template<class Comp> std::vector<TableB>::iterator find_in_b_if(Comp p) {
-    return std::find_if(b.begin(), b.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<TableB>::iterator>::difference_type count_in_b(const T &p) {
-    return std::count(b.begin(), b.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<TableB>::iterator>::difference_type count_in_b_if(Comp p) {
-    return std::count_if(b.begin(), b.end(), p);
-  }
-
-  template<class Generator> void generate_c(Generator gen) {
-    std::generate(c.begin(), c.end(), gen);
-  }
-
-  template<class T> std::vector<std::unique_ptr<TableB>>::iterator remove_c(const T &v) {
-    return std::remove(c.begin(), c.end(), v);
-  }
-  template<class Pred> std::vector<std::unique_ptr<TableB>>::iterator remove_c_if(Pred v) {
-    return std::remove_if(c.begin(), c.end(), v);
-  }
-
-  template<class T> void erase_c(const T &v) {
-    c.erase(remove_c(v));
-  }
-  template<class Pred> void erase_c_if(Pred v) {
-    c.erase(remove_c_if(v));
-  }
-
-  void reverse_c() {
-    std::reverse(c.begin(), c.end());
-  }
-
-  void rotate_c(std::vector<std::unique_ptr<TableB>>::iterator i) {
-    std::rotate(c.begin(), i, c.end());
-  }
-
-  template<class Comp> void sort_c(Comp p) {
-    std::sort(c.begin(), c.end(), p);
-  }
-
-  template<class Comp> bool any_of_c(Comp p) {
-    return std::any_of(c.begin(), c.end(), p);
-  }
-  template<class T> bool any_of_c_is(const T &p) {
-    return any_of_c([&p](const std::unique_ptr<TableB> &x) { return x && *x == p; });
-  }
-
-  template<class Comp> bool all_of_c(Comp p) {
-    return std::all_of(c.begin(), c.end(), p);
-  }
-  template<class T> bool all_of_c_are(const T &p) {
-    return all_of_c([&p](const std::unique_ptr<TableB> &x) { return x && *x == p; });
-  }
-
-  template<class Comp> bool none_of_c(Comp p) {
-    return std::none_of(c.begin(), c.end(), p);
-  }
-  template<class T> bool none_of_c_is(const T &p) {
-    return none_of_c([&p](const std::unique_ptr<TableB> &x) { return x && *x == p; });
-  }
-
-  template<class Fn> Fn for_each_c(Fn p) {
-    return std::for_each(c.begin(), c.end(), p);
-  }
-
-  template<class T> std::vector<std::unique_ptr<TableB>>::iterator find_in_c(const T &p) {
-    return std::find(c.begin(), c.end(), p);
-  }
-  template<class Comp> std::vector<std::unique_ptr<TableB>>::iterator find_in_c_if(Comp p) {
-    return std::find_if(c.begin(), c.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<std::unique_ptr<TableB>>::iterator>::difference_type count_in_c(const T &p) {
-    return std::count(c.begin(), c.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<std::unique_ptr<TableB>>::iterator>::difference_type count_in_c_if(Comp p) {
-    return std::count_if(c.begin(), c.end(), p);
-  }
-
-  template<class T> void fill_d(const T &v) {
-    std::fill(d.begin(), d.end(), v);
-  }
-
-  template<class Generator> void generate_d(Generator gen) {
-    std::generate(d.begin(), d.end(), gen);
-  }
-
-  template<class T> std::vector<std::shared_ptr<TableB>>::iterator remove_d(const T &v) {
-    return std::remove(d.begin(), d.end(), v);
-  }
-  template<class Pred> std::vector<std::shared_ptr<TableB>>::iterator remove_d_if(Pred v) {
-    return std::remove_if(d.begin(), d.end(), v);
-  }
-
-  template<class T> void erase_d(const T &v) {
-    d.erase(remove_d(v));
-  }
-  template<class Pred> void erase_d_if(Pred v) {
-    d.erase(remove_d_if(v));
-  }
-
-  void reverse_d() {
-    std::reverse(d.begin(), d.end());
-  }
-
-  void rotate_d(std::vector<std::shared_ptr<TableB>>::iterator i) {
-    std::rotate(d.begin(), i, d.end());
-  }
-
-  template<class Comp> void sort_d(Comp p) {
-    std::sort(d.begin(), d.end(), p);
-  }
-
-  template<class Comp> bool any_of_d(Comp p) {
-    return std::any_of(d.begin(), d.end(), p);
-  }
-  template<class T> bool any_of_d_is(const T &p) {
-    return any_of_d([&p](const std::shared_ptr<TableB> &x) { return x && *x == p; });
-  }
-
-  bool any_of_d_is(const std::shared_ptr<TableB> &p) {
-    return any_of_d([&p](const std::shared_ptr<TableB> &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_d(Comp p) {
-    return std::all_of(d.begin(), d.end(), p);
-  }
-  template<class T> bool all_of_d_are(const T &p) {
-    return all_of_d([&p](const std::shared_ptr<TableB> &x) { return x && *x == p; });
-  }
-
-  bool all_of_d_are(const std::shared_ptr<TableB> &p) {
-    return all_of_d([&p](const std::shared_ptr<TableB> &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_d(Comp p) {
-    return std::none_of(d.begin(), d.end(), p);
-  }
-  template<class T> bool none_of_d_is(const T &p) {
-    return none_of_d([&p](const std::shared_ptr<TableB> &x) { return x && *x == p; });
-  }
-
-  bool none_of_d_is(const std::shared_ptr<TableB> &p) {
-    return none_of_d([&p](const std::shared_ptr<TableB> &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_d(Fn p) {
-    return std::for_each(d.begin(), d.end(), p);
-  }
-
-  template<class T> std::vector<std::shared_ptr<TableB>>::iterator find_in_d(const T &p) {
-    return std::find(d.begin(), d.end(), p);
-  }
-  template<class Comp> std::vector<std::shared_ptr<TableB>>::iterator find_in_d_if(Comp p) {
-    return std::find_if(d.begin(), d.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<std::shared_ptr<TableB>>::iterator>::difference_type count_in_d(const T &p) {
-    return std::count(d.begin(), d.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<std::shared_ptr<TableB>>::iterator>::difference_type count_in_d_if(Comp p) {
-    return std::count_if(d.begin(), d.end(), p);
-  }
-
-  template<class T> void fill_e(const T &v) {
-    std::fill(e.begin(), e.end(), v);
-  }
-
-  template<class Generator> void generate_e(Generator gen) {
-    std::generate(e.begin(), e.end(), gen);
-  }
-
-  template<class T> std::vector<std::weak_ptr<TableB>>::iterator remove_e(const T &v) {
-    return std::remove(e.begin(), e.end(), v);
-  }
-  template<class Pred> std::vector<std::weak_ptr<TableB>>::iterator remove_e_if(Pred v) {
-    return std::remove_if(e.begin(), e.end(), v);
-  }
-
-  template<class T> void erase_e(const T &v) {
-    e.erase(remove_e(v));
-  }
-  template<class Pred> void erase_e_if(Pred v) {
-    e.erase(remove_e_if(v));
-  }
-
-  void reverse_e() {
-    std::reverse(e.begin(), e.end());
-  }
-
-  void rotate_e(std::vector<std::weak_ptr<TableB>>::iterator i) {
-    std::rotate(e.begin(), i, e.end());
-  }
-
-  template<class Comp> void sort_e(Comp p) {
-    std::sort(e.begin(), e.end(), p);
-  }
-
-  template<class Comp> bool any_of_e(Comp p) {
-    return std::any_of(e.begin(), e.end(), p);
-  }
-  template<class T> bool any_of_e_is(const T &p) {
-    return any_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() && *x.lock() == p; });
-  }
-
-  bool any_of_e_is(const std::shared_ptr<TableB> &p) {
-    return any_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() == p; });
-  }
-
-  template<class Comp> bool all_of_e(Comp p) {
-    return std::all_of(e.begin(), e.end(), p);
-  }
-  template<class T> bool all_of_e_are(const T &p) {
-    return all_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() && *x.lock() == p; });
-  }
-
-  bool all_of_e_are(const std::shared_ptr<TableB> &p) {
-    return all_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() == p; });
-  }
-
-  template<class Comp> bool none_of_e(Comp p) {
-    return std::none_of(e.begin(), e.end(), p);
-  }
-  template<class T> bool none_of_e_is(const T &p) {
-    return none_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() && *x.lock() == p; });
-  }
-
-  bool none_of_e_is(const std::shared_ptr<TableB> &p) {
-    return none_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() == p; });
-  }
-
-  template<class Fn> Fn for_each_e(Fn p) {
-    return std::for_each(e.begin(), e.end(), p);
-  }
-
-  template<class T> std::vector<std::weak_ptr<TableB>>::iterator find_in_e(const T &p) {
-    return std::find(e.begin(), e.end(), p);
-  }
-  template<class Comp> std::vector<std::weak_ptr<TableB>>::iterator find_in_e_if(Comp p) {
-    return std::find_if(e.begin(), e.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<std::weak_ptr<TableB>>::iterator>::difference_type count_in_e(const T &p) {
-    return std::count(e.begin(), e.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<std::weak_ptr<TableB>>::iterator>::difference_type count_in_e_if(Comp p) {
-    return std::count_if(e.begin(), e.end(), p);
-  }
-};
-
-struct TableC_io {
-private:
-  unsigned int TableA_count_{0};
-  std::vector<std::shared_ptr<TableA>> TableA_references_;
-
-  unsigned int TableB_count_{0};
-  std::vector<std::shared_ptr<TableB>> TableB_references_;
-
-  unsigned int TableD_count_{0};
-  std::vector<std::shared_ptr<TableD>> TableD_references_;
-
-  template<typename T> void Write(std::ostream &, const T *) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &o, const T &v) {
-    o.write(reinterpret_cast<const char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<T> &v) {
-    Write(o, v.size());
-    o.write(reinterpret_cast<const char *>(v.data()), sizeof(T) * v.size());
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::unique_ptr<T> &v) {
-    if (!v) {
-      o.write("\x0", 1);
-    } else {
-      o.write("\x1", 1);
-      Write(o, *v);
-    }
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::shared_ptr<T> &v, unsigned int &counter) {
-    if (!v) {
-      o.write("\x0", 1);
-    } else if (v->io_counter_== 0) {
-      v->io_counter_ = ++counter;
-      o.write("\x1", 1);
-      Write(o, *v);
-    } else {
-      o.write("\x2", 1);
-      Write(o, v->io_counter_);
-    }
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<std::unique_ptr<T>> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<std::shared_ptr<T>> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<std::weak_ptr<T>> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  template<typename T> void Write(std::ostream &, const std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &, const std::weak_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  void Write(std::ostream &o, const std::string &v) {
-    Write(o, v.size());
-    o.write(v.data(), v.size());
-  }
-
-  template<typename T> void Read(std::istream &i, T &v) {
-    i.read(reinterpret_cast<char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Read(std::istream &i, std::unique_ptr<T> &v) {
-    char ref = 0;
-    i.read(&ref, 1);
-    if (ref == '\x1') {
-      v = std::unique_ptr<T>(new T);
-      Read(i, *v);
-    }
-  }
-
-  template<typename T> void Read(std::istream &, std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &, std::weak_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache) {
-    char ref = 0;
-    s.read(&ref, 1);
-    if (ref == '\x1') {
-      v = std::make_shared<T>();
-      cache.push_back(v);
-      Read(s, *v);
-    } else if (ref == '\x2') {
-      unsigned int index = 0;
-      Read(s, index);
-      v = cache[index - 1];
-    }
-  }
-
-  template<typename T> void Read(std::istream &s, std::vector<std::unique_ptr<T>> &v) {
-    auto size = v.size();
-    Read(s, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(s, entry);
-  }
-
-  template<typename T> void Read(std::istream &s, std::vector<std::shared_ptr<T>> &v) {
-    auto size = v.size();
-    Read(s, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(s, entry);
-  }
-
-  template<typename T> void Read(std::istream &s, std::vector<std::weak_ptr<T>> &v) {
-    auto size = v.size();
-    Read(s, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(s, entry);
-  }
-
-  template<typename T> void Read(std::istream &i, std::vector<T> &v) {
-    typename std::vector<T>::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(reinterpret_cast<char *>(v.data()), sizeof(T) * s);
-  }
-
-  void Read(std::istream &i, std::string &v) {
-    std::string::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(&v[0], s);
-  }
-
-  void Write(std::ostream &o, const TableA &v) {
-    Write(o, v.name);
-    Write(o, v.d1);
-    Write(o, v.d2);
-    Write(o, v.d3);
-    Write(o, v.d4);
-  }
-
-  void Write(std::ostream &o, const std::shared_ptr<TableA> &v) {
-    Write(o, v, TableA_count_);
-  }
-
-  void Read(std::istream &s, TableA &v) {
-    Read(s, v.name);
-    Read(s, v.d1);
-    Read(s, v.d2);
-    Read(s, v.d3);
-    Read(s, v.d4);
-  }
-
-  void Read(std::istream &s, std::shared_ptr<TableA> &v) {
-    Read(s, v, TableA_references_);
-  }
-
-  void Write(std::ostream &o, const TableB &v) {
-    Write(o, v.name);
-  }
-
-  void Write(std::ostream &o, const std::shared_ptr<TableB> &v) {
-    Write(o, v, TableB_count_);
-  }
-
-  void Write(std::ostream &o, const std::weak_ptr<TableB> &v) {
-    Write(o, v.lock(), TableB_count_);
-  }
-
-  void Write(std::ostream &o, const std::vector<TableB> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  void Read(std::istream &s, TableB &v) {
-    Read(s, v.name);
-  }
-
-  void Read(std::istream &s, std::shared_ptr<TableB> &v) {
-    Read(s, v, TableB_references_);
-  }
-
-  void Read(std::istream &s, std::weak_ptr<TableB> &v) {
-    auto t = v.lock();
-    Read(s, t, TableB_references_);
-    v = t;
-  }
-
-  void Read(std::istream &s, std::vector<TableB> &v) {
-    auto size = v.size();
-    Read(s, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(s, entry);
-  }
-
-  void Write(std::ostream &o, const TableD &v) {
-    Write(o, v.name);
-    Write(o, v.a);
-  }
-
-  void Write(std::ostream &o, const std::shared_ptr<TableD> &v) {
-    Write(o, v, TableD_count_);
-  }
-
-  void Write(std::ostream &o, const std::weak_ptr<TableD> &v) {
-    Write(o, v.lock(), TableD_count_);
-  }
-
-  void Read(std::istream &s, TableD &v) {
-    Read(s, v.name);
-    Read(s, v.a);
-  }
-
-  void Read(std::istream &s, std::shared_ptr<TableD> &v) {
-    Read(s, v, TableD_references_);
-  }
-
-  void Read(std::istream &s, std::weak_ptr<TableD> &v) {
-    auto t = v.lock();
-    Read(s, t, TableD_references_);
-    v = t;
-  }
-
-  void Write(std::ostream &o, const TableC &v) {
-    Write(o, v.a);
-    Write(o, v.b);
-    Write(o, v.c);
-    Write(o, v.d);
-    Write(o, v.e);
-  }
-
-  void Read(std::istream &s, TableC &v) {
-    Read(s, v.a);
-    Read(s, v.b);
-    Read(s, v.c);
-    Read(s, v.d);
-    Read(s, v.e);
-  }
-
-public:
-  void WriteTableC(std::ostream &o, const TableC &v) {
-    TableA_count_ = 0;
-    TableB_count_ = 0;
-    TableD_count_ = 0;
-
-    o.write("CORE", 4);
-    o.write("0.0", 3);
-    Write(o, v);
-  }
-
-  bool ReadTableC(std::istream &i, TableC &v) {
-    TableA_references_.clear();
-    TableB_references_.clear();
-    TableD_references_.clear();
-
-    std::string marker("0000");
-    i.read(&marker[0], 4);
-    if (marker != "CORE")
-      return false;
-    std::string version(3, '_');
-    i.read(&version[0], 3);
-    if (version != "0.0")
-      return false;
-    Read(i, v);
-    return true;
-  }
-
-};
-}
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <bitset>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#ifndef COREBUFFER_IO_URING
+#define COREBUFFER_IO_URING 1
+#endif
+#endif
+#endif
+#else
+#include <fstream>
+#endif
+
+namespace Scope {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+class ChangedElements {
+public:
+  void mark(std::size_t first, std::size_t last) {
+    if (first >= last)
+      return;
+    if (words_.size() < (last + 63) / 64)
+      words_.resize((last + 63) / 64);
+    for (auto n = first; n < last;) {
+      if (n % 64 == 0 && last - n >= 64) {
+        words_[n / 64] = ~std::uint64_t(0);
+        n += 64;
+      } else {
+        words_[n / 64] |= std::uint64_t(1) << (n % 64);
+        ++n;
+      }
+    }
+  }
+
+  void clear() {
+    words_.clear();
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> runs(std::size_t size) const {
+    std::vector<std::pair<std::size_t, std::size_t>> r;
+    const auto end = std::min(size, words_.size() * 64);
+    for (std::size_t n = 0; n < end;) {
+      if (n % 64 == 0 && words_[n / 64] == 0) {
+        n += 64;
+        continue;
+      }
+      if (!test(n)) {
+        ++n;
+        continue;
+      }
+      const auto first = n;
+      while (n < end && test(n))
+        ++n;
+      r.emplace_back(first, n);
+    }
+    return r;
+  }
+
+private:
+  bool test(std::size_t n) const {
+    return (words_[n / 64] >> (n % 64)) & 1;
+  }
+
+  std::vector<std::uint64_t> words_;
+};
+
+
+struct TableA;
+struct TableB;
+struct TableD;
+struct TableC;
+
+template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
+  return l.lock() == r.lock();
+}
+
+template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
+  return l.lock() != r.lock();
+}
+
+struct TableA {
+  std::string name;
+  std::unique_ptr<TableD> d1;
+  std::weak_ptr<TableD> d2;
+  std::shared_ptr<TableD> d3;
+  std::shared_ptr<TableD> d4;
+
+  TableA() = default;
+  TableA(const std::string &name_)
+    : name(name_)
+  {}
+  TableA(const std::shared_ptr<TableD> &d3_)
+    : d3(d3_)
+  {}
+  TableA(const std::shared_ptr<TableD> &d2_, std::unique_ptr<TableD> d1_)
+    : d1(std::move(d1_))
+    , d2(d2_)
+  {}
+
+  friend bool operator==(const TableA&l, const TableA&r) {
+    return 
+      l.name == r.name
+      && l.d1 == r.d1
+      && l.d2 == r.d2
+      && l.d3 == r.d3
+      && l.d4 == r.d4;
+  }
+
+  friend bool operator!=(const TableA&l, const TableA&r) {
+    return 
+      l.name != r.name
+      || l.d1 != r.d1
+      || l.d2 != r.d2
+      || l.d3 != r.d3
+      || l.d4 != r.d4;
+  }
+};
+
+struct TableB {
+  std::string name;
+
+  TableB() = default;
+  TableB(const std::string &name_)
+    : name(name_)
+  {}
+
+  friend bool operator==(const TableB&l, const TableB&r) {
+    return 
+      l.name == r.name;
+  }
+
+  friend bool operator!=(const TableB&l, const TableB&r) {
+    return 
+      l.name != r.name;
+  }
+};
+
+struct TableD {
+  std::string name;
+  std::shared_ptr<TableA> a;
+
+  TableD() = default;
+
+  friend bool operator==(const TableD&l, const TableD&r) {
+    return 
+      l.name == r.name
+      && l.a == r.a;
+  }
+
+  friend bool operator!=(const TableD&l, const TableD&r) {
+    return 
+      l.name != r.name
+      || l.a != r.a;
+  }
+};
+
+struct TableC {
+  TableA a;
+  std::vector<TableB> b;
+  std::vector<std::unique_ptr<TableB>> c;
+  std::vector<std::shared_ptr<TableB>> d;
+  std::vector<std::weak_ptr<TableB>> e;
+
+  TableC() = default;
+  TableC(std::vector<std::unique_ptr<TableB>> c_)
+    : c(std::move(c_))
+  {}
+
+  friend bool operator==(const TableC&l, const TableC&r) {
+    return 
+      l.a == r.a
+      && l.b == r.b
+      && l.c == r.c
+      && l.d == r.d
+      && l.e == r.e;
+  }
+
+  friend bool operator!=(const TableC&l, const TableC&r) {
+    return 
+      l.a != r.a
+      || l.b != r.b
+      || l.c != r.c
+      || l.d != r.d
+      || l.e != r.e;
+  }
+
+  bool has_changes() const {
+    return changes_.any();
+  }
+
+  void clear_changes() {
+    changes_.reset();
+    b_changed_.clear();
+    c_changed_.clear();
+  }
+
+  void mark_a() {
+    changes_.set(0);
+  }
+  template<class T> void set_a(T &&v) {
+    a = std::forward<T>(v);
+    mark_a();
+  }
+
+  void mark_b() {
+    mark_b(0, b.size());
+  }
+  void mark_b(std::size_t first, std::size_t last) {
+    b_changed_.mark(first, std::min(last, b.size()));
+    changes_.set(1);
+  }
+  template<class T> void set_b(T &&v) {
+    b = std::forward<T>(v);
+    mark_b();
+  }
+  std::vector<TableB>::reference change_b(std::size_t index) {
+    mark_b(index, index + 1);
+    return b[index];
+  }
+  template<class T> void push_b(T &&v) {
+    b.push_back(std::forward<T>(v));
+    mark_b(b.size() - 1, b.size());
+  }
+  void resize_b(std::size_t size) {
+    const auto old = b.size();
+    b.resize(size);
+    mark_b(std::min(old, size), size);
+  }
+
+  void mark_c() {
+    mark_c(0, c.size());
+  }
+  void mark_c(std::size_t first, std::size_t last) {
+    c_changed_.mark(first, std::min(last, c.size()));
+    changes_.set(2);
+  }
+  template<class T> void set_c(T &&v) {
+    c = std::forward<T>(v);
+    mark_c();
+  }
+  std::vector<std::unique_ptr<TableB>>::reference change_c(std::size_t index) {
+    mark_c(index, index + 1);
+    return c[index];
+  }
+  template<class T> void push_c(T &&v) {
+    c.push_back(std::forward<T>(v));
+    mark_c(c.size() - 1, c.size());
+  }
+  void resize_c(std::size_t size) {
+    const auto old = c.size();
+    c.resize(size);
+    mark_c(std::min(old, size), size);
+  }
+
+  void mark_d() {
+    changes_.set(3);
+  }
+  void mark_d(std::size_t, std::size_t) {
+    changes_.set(3);
+  }
+  template<class T> void set_d(T &&v) {
+    d = std::forward<T>(v);
+    mark_d();
+  }
+  std::vector<std::shared_ptr<TableB>>::reference change_d(std::size_t index) {
+    mark_d(index, index + 1);
+    return d[index];
+  }
+  template<class T> void push_d(T &&v) {
+    d.push_back(std::forward<T>(v));
+    mark_d(d.size() - 1, d.size());
+  }
+  void resize_d(std::size_t size) {
+    const auto old = d.size();
+    d.resize(size);
+    mark_d(std::min(old, size), size);
+  }
+
+  void mark_e() {
+    changes_.set(4);
+  }
+  void mark_e(std::size_t, std::size_t) {
+    changes_.set(4);
+  }
+  template<class T> void set_e(T &&v) {
+    e = std::forward<T>(v);
+    mark_e();
+  }
+  std::vector<std::weak_ptr<TableB>>::reference change_e(std::size_t index) {
+    mark_e(index, index + 1);
+    return e[index];
+  }
+  template<class T> void push_e(T &&v) {
+    e.push_back(std::forward<T>(v));
+    mark_e(e.size() - 1, e.size());
+  }
+  void resize_e(std::size_t size) {
+    const auto old = e.size();
+    e.resize(size);
+    mark_e(std::min(old, size), size);
+  }
+
+  template<class T> void fill_b(const T &v) {
+    std::fill(b.begin(), b.end(), v);
+    mark_b();
+  }
+
+  template<class Generator> void generate_b(Generator gen) {
+    std::generate(b.begin(), b.end(), gen);
+    mark_b();
+  }
+
+  template<class T> std::vector<TableB>::iterator remove_b(const T &v) {
+    const auto first = std::find(b.begin(), b.end(), v);
+    mark_b(static_cast<std::size_t>(first - b.begin()), b.size());
+    return std::remove(first, b.end(), v);
+  }
+  template<class Pred> std::vector<TableB>::iterator remove_b_if(Pred v) {
+    const auto first = std::find_if(b.begin(), b.end(), v);
+    mark_b(static_cast<std::size_t>(first - b.begin()), b.size());
+    return std::remove_if(first, b.end(), v);
+  }
+
+  template<class T> void erase_b(const T &v) {
+    b.erase(remove_b(v));
+  }
+  template<class Pred> void erase_b_if(Pred v) {
+    b.erase(remove_b_if(v));
+  }
+
+  void reverse_b() {
+    std::reverse(b.begin(), b.end());
+    mark_b();
+  }
+
+  void rotate_b(std::vector<TableB>::iterator i) {
+    std::rotate(b.begin(), i, b.end());
+    mark_b();
+  }
+
+  template<class Comp> void sort_b(Comp p) {
+    std::sort(b.begin(), b.end(), p);
+    mark_b();
+  }
+
+  template<class Comp> bool any_of_b(Comp p) {
+    return std::any_of(b.begin(), b.end(), p);
+  }
+  template<class T> bool any_of_b_is(const T &p) {
+    return any_of_b([&p](const TableB &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_b(Comp p) {
+    return std::all_of(b.begin(), b.end(), p);
+  }
+  template<class T> bool all_of_b_are(const T &p) {
+    return all_of_b([&p](const TableB &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_b(Comp p) {
+    return std::none_of(b.begin(), b.end(), p);
+  }
+  template<class T> bool none_of_b_is(const T &p) {
+    return none_of_b([&p](const TableB &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_b(Fn p) {
+    return std::for_each(b.begin(), b.end(), p);
+  }
+
+  template<class T> std::vector<TableB>::iterator find_in_b(const T &p) {
+    return std::find(b.begin(), b.end(), p);
+  }
+  template<class Comp> std::vector<TableB>::iterator find_in_b_if(Comp p) {
+    return std::find_if(b.begin(), b.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<TableB>::iterator>::difference_type count_in_b(const T &p) {
+    return std::count(b.begin(), b.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<TableB>::iterator>::difference_type count_in_b_if(Comp p) {
+    return std::count_if(b.begin(), b.end(), p);
+  }
+
+  template<class Generator> void generate_c(Generator gen) {
+    std::generate(c.begin(), c.end(), gen);
+    mark_c();
+  }
+
+  template<class T> std::vector<std::unique_ptr<TableB>>::iterator remove_c(const T &v) {
+    const auto first = std::find(c.begin(), c.end(), v);
+    mark_c(static_cast<std::size_t>(first - c.begin()), c.size());
+    return std::remove(first, c.end(), v);
+  }
+  template<class Pred> std::vector<std::unique_ptr<TableB>>::iterator remove_c_if(Pred v) {
+    const auto first = std::find_if(c.begin(), c.end(), v);
+    mark_c(static_cast<std::size_t>(first - c.begin()), c.size());
+    return std::remove_if(first, c.end(), v);
+  }
+
+  template<class T> void erase_c(const T &v) {
+    c.erase(remove_c(v));
+  }
+  template<class Pred> void erase_c_if(Pred v) {
+    c.erase(remove_c_if(v));
+  }
+
+  void reverse_c() {
+    std::reverse(c.begin(), c.end());
+    mark_c();
+  }
+
+  void rotate_c(std::vector<std::unique_ptr<TableB>>::iterator i) {
+    std::rotate(c.begin(), i, c.end());
+    mark_c();
+  }
+
+  template<class Comp> void sort_c(Comp p) {
+    std::sort(c.begin(), c.end(), p);
+    mark_c();
+  }
+
+  template<class Comp> bool any_of_c(Comp p) {
+    return std::any_of(c.begin(), c.end(), p);
+  }
+  template<class T> bool any_of_c_is(const T &p) {
+    return any_of_c([&p](const std::unique_ptr<TableB> &x) { return x && *x == p; });
+  }
+
+  template<class Comp> bool all_of_c(Comp p) {
+    return std::all_of(c.begin(), c.end(), p);
+  }
+  template<class T> bool all_of_c_are(const T &p) {
+    return all_of_c([&p](const std::unique_ptr<TableB> &x) { return x && *x == p; });
+  }
+
+  template<class Comp> bool none_of_c(Comp p) {
+    return std::none_of(c.begin(), c.end(), p);
+  }
+  template<class T> bool none_of_c_is(const T &p) {
+    return none_of_c([&p](const std::unique_ptr<TableB> &x) { return x && *x == p; });
+  }
+
+  template<class Fn> Fn for_each_c(Fn p) {
+    return std::for_each(c.begin(), c.end(), p);
+  }
+
+  template<class T> std::vector<std::unique_ptr<TableB>>::iterator find_in_c(const T &p) {
+    return std::find(c.begin(), c.end(), p);
+  }
+  template<class Comp> std::vector<std::unique_ptr<TableB>>::iterator find_in_c_if(Comp p) {
+    return std::find_if(c.begin(), c.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::unique_ptr<TableB>>::iterator>::difference_type count_in_c(const T &p) {
+    return std::count(c.begin(), c.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::unique_ptr<TableB>>::iterator>::difference_type count_in_c_if(Comp p) {
+    return std::count_if(c.begin(), c.end(), p);
+  }
+
+  template<class T> void fill_d(const T &v) {
+    std::fill(d.begin(), d.end(), v);
+    mark_d();
+  }
+
+  template<class Generator> void generate_d(Generator gen) {
+    std::generate(d.begin(), d.end(), gen);
+    mark_d();
+  }
+
+  template<class T> std::vector<std::shared_ptr<TableB>>::iterator remove_d(const T &v) {
+    const auto first = std::find(d.begin(), d.end(), v);
+    mark_d(static_cast<std::size_t>(first - d.begin()), d.size());
+    return std::remove(first, d.end(), v);
+  }
+  template<class Pred> std::vector<std::shared_ptr<TableB>>::iterator remove_d_if(Pred v) {
+    const auto first = std::find_if(d.begin(), d.end(), v);
+    mark_d(static_cast<std::size_t>(first - d.begin()), d.size());
+    return std::remove_if(first, d.end(), v);
+  }
+
+  template<class T> void erase_d(const T &v) {
+    d.erase(remove_d(v));
+  }
+  template<class Pred> void erase_d_if(Pred v) {
+    d.erase(remove_d_if(v));
+  }
+
+  void reverse_d() {
+    std::reverse(d.begin(), d.end());
+    mark_d();
+  }
+
+  void rotate_d(std::vector<std::shared_ptr<TableB>>::iterator i) {
+    std::rotate(d.begin(), i, d.end());
+    mark_d();
+  }
+
+  template<class Comp> void sort_d(Comp p) {
+    std::sort(d.begin(), d.end(), p);
+    mark_d();
+  }
+
+  template<class Comp> bool any_of_d(Comp p) {
+    return std::any_of(d.begin(), d.end(), p);
+  }
+  template<class T> bool any_of_d_is(const T &p) {
+    return any_of_d([&p](const std::shared_ptr<TableB> &x) { return x && *x == p; });
+  }
+
+  bool any_of_d_is(const std::shared_ptr<TableB> &p) {
+    return any_of_d([&p](const std::shared_ptr<TableB> &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_d(Comp p) {
+    return std::all_of(d.begin(), d.end(), p);
+  }
+  template<class T> bool all_of_d_are(const T &p) {
+    return all_of_d([&p](const std::shared_ptr<TableB> &x) { return x && *x == p; });
+  }
+
+  bool all_of_d_are(const std::shared_ptr<TableB> &p) {
+    return all_of_d([&p](const std::shared_ptr<TableB> &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_d(Comp p) {
+    return std::none_of(d.begin(), d.end(), p);
+  }
+  template<class T> bool none_of_d_is(const T &p) {
+    return none_of_d([&p](const std::shared_ptr<TableB> &x) { return x && *x == p; });
+  }
+
+  bool none_of_d_is(const std::shared_ptr<TableB> &p) {
+    return none_of_d([&p](const std::shared_ptr<TableB> &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_d(Fn p) {
+    return std::for_each(d.begin(), d.end(), p);
+  }
+
+  template<class T> std::vector<std::shared_ptr<TableB>>::iterator find_in_d(const T &p) {
+    return std::find(d.begin(), d.end(), p);
+  }
+  template<class Comp> std::vector<std::shared_ptr<TableB>>::iterator find_in_d_if(Comp p) {
+    return std::find_if(d.begin(), d.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::shared_ptr<TableB>>::iterator>::difference_type count_in_d(const T &p) {
+    return std::count(d.begin(), d.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::shared_ptr<TableB>>::iterator>::difference_type count_in_d_if(Comp p) {
+    return std::count_if(d.begin(), d.end(), p);
+  }
+
+  template<class T> void fill_e(const T &v) {
+    std::fill(e.begin(), e.end(), v);
+    mark_e();
+  }
+
+  template<class Generator> void generate_e(Generator gen) {
+    std::generate(e.begin(), e.end(), gen);
+    mark_e();
+  }
+
+  template<class T> std::vector<std::weak_ptr<TableB>>::iterator remove_e(const T &v) {
+    const auto first = std::find(e.begin(), e.end(), v);
+    mark_e(static_cast<std::size_t>(first - e.begin()), e.size());
+    return std::remove(first, e.end(), v);
+  }
+  template<class Pred> std::vector<std::weak_ptr<TableB>>::iterator remove_e_if(Pred v) {
+    const auto first = std::find_if(e.begin(), e.end(), v);
+    mark_e(static_cast<std::size_t>(first - e.begin()), e.size());
+    return std::remove_if(first, e.end(), v);
+  }
+
+  template<class T> void erase_e(const T &v) {
+    e.erase(remove_e(v));
+  }
+  template<class Pred> void erase_e_if(Pred v) {
+    e.erase(remove_e_if(v));
+  }
+
+  void reverse_e() {
+    std::reverse(e.begin(), e.end());
+    mark_e();
+  }
+
+  void rotate_e(std::vector<std::weak_ptr<TableB>>::iterator i) {
+    std::rotate(e.begin(), i, e.end());
+    mark_e();
+  }
+
+  template<class Comp> void sort_e(Comp p) {
+    std::sort(e.begin(), e.end(), p);
+    mark_e();
+  }
+
+  template<class Comp> bool any_of_e(Comp p) {
+    return std::any_of(e.begin(), e.end(), p);
+  }
+  template<class T> bool any_of_e_is(const T &p) {
+    return any_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() && *x.lock() == p; });
+  }
+
+  bool any_of_e_is(const std::shared_ptr<TableB> &p) {
+    return any_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() == p; });
+  }
+
+  template<class Comp> bool all_of_e(Comp p) {
+    return std::all_of(e.begin(), e.end(), p);
+  }
+  template<class T> bool all_of_e_are(const T &p) {
+    return all_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() && *x.lock() == p; });
+  }
+
+  bool all_of_e_are(const std::shared_ptr<TableB> &p) {
+    return all_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() == p; });
+  }
+
+  template<class Comp> bool none_of_e(Comp p) {
+    return std::none_of(e.begin(), e.end(), p);
+  }
+  template<class T> bool none_of_e_is(const T &p) {
+    return none_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() && *x.lock() == p; });
+  }
+
+  bool none_of_e_is(const std::shared_ptr<TableB> &p) {
+    return none_of_e([&p](const std::weak_ptr<TableB> &x) { return x.lock() == p; });
+  }
+
+  template<class Fn> Fn for_each_e(Fn p) {
+    return std::for_each(e.begin(), e.end(), p);
+  }
+
+  template<class T> std::vector<std::weak_ptr<TableB>>::iterator find_in_e(const T &p) {
+    return std::find(e.begin(), e.end(), p);
+  }
+  template<class Comp> std::vector<std::weak_ptr<TableB>>::iterator find_in_e_if(Comp p) {
+    return std::find_if(e.begin(), e.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<std::weak_ptr<TableB>>::iterator>::difference_type count_in_e(const T &p) {
+    return std::count(e.begin(), e.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<std::weak_ptr<TableB>>::iterator>::difference_type count_in_e_if(Comp p) {
+    return std::count_if(e.begin(), e.end(), p);
+  }
+
+  std::bitset<5> changes_;
+  ChangedElements b_changed_;
+  ChangedElements c_changed_;
+};
+
+struct TableCVisitor {
+  virtual ~TableCVisitor() = default;
+
+  virtual void on_a(const TableA &) {}
+  virtual void on_b_begin(std::size_t) {}
+  virtual void on_b_element(const TableB &) {}
+  virtual void on_b_end() {}
+  virtual void on_c_begin(std::size_t) {}
+  virtual void on_c_element(const std::unique_ptr<TableB> &) {}
+  virtual void on_c_end() {}
+  virtual void on_d_begin(std::size_t) {}
+  virtual void on_d_element(const std::shared_ptr<TableB> &) {}
+  virtual void on_d_end() {}
+  virtual void on_e_begin(std::size_t) {}
+  virtual void on_e_element(const std::weak_ptr<TableB> &) {}
+  virtual void on_e_end() {}
+};
+
+struct StringView {
+  StringView() = default;
+  StringView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::string str() const { return size_ == 0 ? std::string() : std::string(data_, size_); }
+
+  friend bool operator==(const StringView &l, const std::string &r) {
+    return l.size_ == r.size() && (l.size_ == 0 || std::memcmp(l.data_, r.data(), l.size_) == 0);
+  }
+  friend bool operator!=(const StringView &l, const std::string &r) { return !(l == r); }
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+template<typename T> struct ArrayView {
+  ArrayView() = default;
+  ArrayView(const char *data, std::size_t count) : data_(data), count_(count) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  T operator[](std::size_t index) const {
+    T v;
+    std::memcpy(static_cast<void *>(&v), data_ + index * sizeof(T), sizeof(T));
+    return v;
+  }
+
+  struct iterator {
+    const ArrayView *view;
+    std::size_t index;
+
+    T operator*() const { return (*view)[index]; }
+    iterator &operator++() { ++index; return *this; }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{this, count_}; }
+
+private:
+  const char *data_{nullptr};
+  std::size_t count_{0};
+};
+
+// elements are found by passing the ones in front of them, or through the offset index of --index-vectors;
+// the offsets passed for indexing are kept, so indexing the same list again takes constant time
+template<typename IO, typename E, typename Encoded> struct ListView {
+  ListView() = default;
+  ListView(const char *data, std::size_t size, std::size_t first, std::size_t count, const char *index = nullptr)
+    : data_(data), size_(size), first_(first), count_(count), index_(index) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  E operator[](std::size_t index) const {
+    return At(Find(index));
+  }
+
+  struct iterator {
+    const ListView *view;
+    std::size_t index;
+    std::size_t pos;
+
+    E operator*() const { return view->At(pos); }
+    iterator &operator++() {
+      ++index;
+      pos = view->index_ ? view->Find(index) : view->Next(pos);
+      // a list that cannot be passed ends where it broke
+      if (pos >= view->size_)
+        index = view->count_;
+      return *this;
+    }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0, index_ ? Find(0) : first_}; }
+  iterator end() const { return iterator{this, count_, size_}; }
+
+  // where the list ends, the size of the data if it cannot be passed
+  std::size_t EndOffset() const {
+    if (count_ == 0)
+      return first_;
+    if (index_)
+      return Next(Find(count_ - 1));
+    auto pos = first_;
+    for (std::size_t n = 0; n < count_ && pos < size_; ++n)
+      pos = Next(pos);
+    return pos;
+  }
+
+private:
+  std::size_t Next(std::size_t pos) const {
+    if (pos >= size_)
+      return size_;
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false, {}};
+    io.Skip(i, static_cast<const Encoded *>(nullptr));
+    return i.failed ? size_ : i.pos;
+  }
+
+  std::size_t Find(std::size_t index) const {
+    if (index >= count_)
+      return size_;
+    if (index_) {
+      IO io;
+      typename IO::InputBuffer i{index_, count_ * sizeof(std::uint64_t), index * sizeof(std::uint64_t), false, {}};
+      std::uint64_t offset = 0;
+      io.ReadValues(i, &offset, 1);
+      return i.failed || offset >= size_ ? size_ : static_cast<std::size_t>(offset);
+    }
+    if (offsets_.empty())
+      offsets_.push_back(first_);
+    while (offsets_.size() <= index && offsets_.back() < size_)
+      offsets_.push_back(Next(offsets_.back()));
+    return offsets_.size() > index ? offsets_[index] : size_;
+  }
+
+  E At(std::size_t pos) const {
+    if (pos >= size_)
+      return E();
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false, {}};
+    return io.MakeView(i, static_cast<const Encoded *>(nullptr));
+  }
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  std::size_t first_{0};
+  std::size_t count_{0};
+  const char *index_{nullptr};
+  mutable std::vector<std::size_t> offsets_;
+};
+struct TableAView;
+struct TableBView;
+struct TableDView;
+struct TableCView;
+
+struct TableC_io {
+  friend struct TableCWriter;
+  friend struct TableCJournal;
+
+  friend struct TableAView;
+  friend struct TableBView;
+  friend struct TableDView;
+  friend struct TableCView;
+  template<typename, typename, typename> friend struct ListView;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct WriteReferences {
+    std::unordered_map<const TableA *, unsigned int> TableA_ids;
+    std::unordered_map<const TableB *, unsigned int> TableB_ids;
+    std::unordered_map<const TableD *, unsigned int> TableD_ids;
+  };
+
+  struct ReadReferences {
+    std::vector<std::shared_ptr<TableA>> TableA_objects;
+    std::uint32_t TableA_count{0};
+    std::uint64_t TableA_verified{0};
+    std::vector<std::shared_ptr<TableB>> TableB_objects;
+    std::uint32_t TableB_count{0};
+    std::uint64_t TableB_verified{0};
+    std::vector<std::shared_ptr<TableD>> TableD_objects;
+    std::uint32_t TableD_count{0};
+    std::uint64_t TableD_verified{0};
+  };
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::unique_ptr<T> &v) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+    } else {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::shared_ptr<T> &v, std::unordered_map<const T *, unsigned int> &ids) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+      return;
+    }
+    const auto entry = ids.emplace(v.get(), static_cast<unsigned int>(ids.size() + 1));
+    if (entry.second) {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    } else {
+      WriteBytes(o, "\x2", 1);
+      Write(o, entry.first->second);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<std::unique_ptr<T>> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<std::shared_ptr<T>> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<std::weak_ptr<T>> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &, const std::weak_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O> void Write(O &o, const std::string &v) const {
+    Write(o, v.size());
+    WriteBytes(o, v.data(), v.size());
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false, {}};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  static constexpr std::size_t CompressedBlockSize() {
+    return 1 << 16;
+  }
+
+  static void LzEmit(std::vector<char> &d, const char *literals, std::size_t count, std::size_t offset, std::size_t length) {
+    const auto extra = [&d](std::size_t v) {
+      for (; v >= 255; v -= 255)
+        d.push_back(static_cast<char>(255));
+      d.push_back(static_cast<char>(v));
+    };
+    const auto matched = length == 0 ? 0 : length - 4;
+    d.push_back(static_cast<char>((std::min<std::size_t>(count, 15) << 4) | std::min<std::size_t>(matched, 15)));
+    if (count >= 15)
+      extra(count - 15);
+    d.insert(d.end(), literals, literals + count);
+    if (length == 0)
+      return;
+    d.push_back(static_cast<char>(offset & 0xff));
+    d.push_back(static_cast<char>(offset >> 8));
+    if (matched >= 15)
+      extra(matched - 15);
+  }
+
+  static void LzCompress(const char *s, std::size_t size, std::vector<char> &d) {
+    std::vector<std::uint32_t> table(1 << 12, 0);
+    d.clear();
+    std::size_t anchor = 0;
+    std::size_t pos = 0;
+    while (size >= 4 && pos <= size - 4) {
+      std::uint32_t sequence;
+      std::memcpy(&sequence, s + pos, 4);
+      auto &entry = table[(sequence * 2654435761u) >> 20];
+      const std::size_t candidate = entry;
+      entry = static_cast<std::uint32_t>(pos + 1);
+      if (candidate == 0 || pos + 1 - candidate > 0xffff || std::memcmp(s + candidate - 1, s + pos, 4) != 0) {
+        ++pos;
+        continue;
+      }
+      const auto match = candidate - 1;
+      std::size_t length = 4;
+      while (pos + length < size && s[match + length] == s[pos + length])
+        ++length;
+      LzEmit(d, s + anchor, pos - anchor, pos - match, length);
+      pos += length;
+      anchor = pos;
+    }
+    LzEmit(d, s + anchor, size - anchor, 0, 0);
+  }
+
+  static bool LzDecompress(const char *s, std::size_t size, char *d, std::size_t capacity) {
+    std::size_t in = 0;
+    std::size_t out = 0;
+    const auto extra = [s, size, &in](std::size_t &v) {
+      unsigned char b = 255;
+      while (b == 255) {
+        if (in == size)
+          return false;
+        b = static_cast<unsigned char>(s[in++]);
+        v += b;
+      }
+      return true;
+    };
+    while (in < size) {
+      const auto token = static_cast<unsigned char>(s[in++]);
+      std::size_t count = token >> 4;
+      if (count == 15 && !extra(count))
+        return false;
+      if (count > size - in || count > capacity - out)
+        return false;
+      std::memcpy(d + out, s + in, count);
+      in += count;
+      out += count;
+      if (in == size)
+        break;
+      if (size - in < 2)
+        return false;
+      const std::size_t offset = static_cast<unsigned char>(s[in]) | (static_cast<unsigned char>(s[in + 1]) << 8);
+      in += 2;
+      std::size_t length = token & 15;
+      if (length == 15 && !extra(length))
+        return false;
+      length += 4;
+      if (offset == 0 || offset > out || length > capacity - out)
+        return false;
+      if (offset >= length)
+        std::memcpy(d + out, d + out - offset, length);
+      else
+        for (std::size_t i = 0; i < length; ++i)
+          d[out + i] = d[out + i - offset];
+      out += length;
+    }
+    return out == capacity;
+  }
+
+  struct CompressedOutput {
+    std::ostream &stream;
+    std::vector<char> block;
+    std::vector<char> compressed;
+    WriteReferences references;
+  };
+
+  void FlushBlock(CompressedOutput &o) const {
+    if (o.block.empty())
+      return;
+    LzCompress(o.block.data(), o.block.size(), o.compressed);
+    const auto &data = o.compressed.size() < o.block.size() ? o.compressed : o.block;
+    const std::uint32_t sizes[2] = {static_cast<std::uint32_t>(o.block.size()), static_cast<std::uint32_t>(data.size())};
+    o.stream.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    o.stream.write(data.data(), data.size());
+    o.block.clear();
+  }
+
+  void WriteBytes(CompressedOutput &o, const char *d, std::size_t s) const {
+    while (s != 0) {
+      const auto n = std::min(s, CompressedBlockSize() - o.block.size());
+      o.block.insert(o.block.end(), d, d + n);
+      d += n;
+      s -= n;
+      if (o.block.size() == CompressedBlockSize())
+        FlushBlock(o);
+    }
+  }
+
+  // offset counts the decompressed bytes of all blocks before the current one
+  struct CompressedInput {
+    InputStream source;
+    std::vector<char> block;
+    std::vector<char> compressed;
+    std::size_t pos;
+    std::uint64_t offset;
+    bool failed;
+    ReadReferences references;
+  };
+
+  bool NextBlock(CompressedInput &i) {
+    std::uint32_t sizes[2] = {0, 0};
+    ReadBytes(i.source, reinterpret_cast<char *>(sizes), sizeof(sizes));
+    if (i.source.failed || sizes[0] == 0 || sizes[0] > CompressedBlockSize() || sizes[1] > sizes[0])
+      return false;
+    i.offset += i.block.size();
+    i.block.resize(sizes[0]);
+    i.pos = 0;
+    if (sizes[1] == sizes[0]) {
+      ReadBytes(i.source, i.block.data(), sizes[0]);
+      return !i.source.failed;
+    }
+    i.compressed.resize(sizes[1]);
+    ReadBytes(i.source, i.compressed.data(), sizes[1]);
+    return !i.source.failed && LzDecompress(i.compressed.data(), sizes[1], i.block.data(), sizes[0]);
+  }
+
+  void ReadBytes(CompressedInput &i, char *d, std::size_t s) {
+    while (s != 0) {
+      if (i.pos == i.block.size() && (i.failed || !NextBlock(i))) {
+        Fail(i);
+        std::memset(d, 0, s);
+        return;
+      }
+      const auto n = std::min(s, i.block.size() - i.pos);
+      std::memcpy(d, i.block.data() + i.pos, n);
+      i.pos += n;
+      d += n;
+      s -= n;
+    }
+  }
+
+  bool Failed(CompressedInput &i) {
+    return i.failed;
+  }
+
+  void Fail(CompressedInput &i) {
+    if (!i.failed)
+      error_offset_ = i.offset + i.pos;
+    i.failed = true;
+  }
+
+  // a compressed byte never expands to more than 255 bytes, the bound keeps lengths from garbage in check
+  static std::uint64_t Remaining(const CompressedInput &i) {
+    const auto stream = i.source.size - i.source.pos;
+    const auto limit = std::numeric_limits<std::uint64_t>::max() / 256;
+    return i.block.size() - i.pos + (stream > limit ? limit : stream) * 255;
+  }
+
+  bool Available(CompressedInput &i, std::size_t count, std::size_t size) {
+    if (!i.failed && count <= Remaining(i) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &i, std::unique_ptr<T> &v) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      v = std::unique_ptr<T>(new T);
+      Read(i, *v);
+    } else {
+      if (ref != '\0')
+        Fail(i);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &, std::weak_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache, std::uint32_t count) {
+    char ref = 0;
+    ReadBytes(s, &ref, 1);
+    if (ref == '\x1') {
+      // every object takes at least a byte, a count larger than the input left is no reason to allocate
+      if (cache.empty())
+        cache.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, Remaining(s))));
+      v = std::make_shared<T>();
+      cache.push_back(v);
+      Read(s, *v);
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(s, index);
+      if (index == 0 || index > cache.size()) {
+        Fail(s);
+        v.reset();
+      } else {
+        v = cache[index - 1];
+      }
+    } else {
+      if (ref != '\0')
+        Fail(s);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &s, std::vector<std::unique_ptr<T>> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename I, typename T> void Read(I &s, std::vector<std::shared_ptr<T>> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename I, typename T> void Read(I &s, std::vector<std::weak_ptr<T>> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename I> void Read(I &i, std::string &v) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    v.resize(s);
+    ReadBytes(i, &v[0], s);
+  }
+
+  template<typename O> void Write(O &o, const TableA &v) const {
+    Write(o, v.name);
+    Write(o, v.d1);
+    Write(o, v.d2);
+    Write(o, v.d3);
+    Write(o, v.d4);
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<TableA> &v) const {
+    Write(o, v, o.references.TableA_ids);
+  }
+
+  template<typename I> void Read(I &s, TableA &v) {
+    Read(s, v.name);
+    Read(s, v.d1);
+    Read(s, v.d2);
+    Read(s, v.d3);
+    Read(s, v.d4);
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<TableA> &v) {
+    Read(s, v, s.references.TableA_objects, s.references.TableA_count);
+  }
+
+  template<typename O> void Write(O &o, const TableB &v) const {
+    Write(o, v.name);
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<TableB> &v) const {
+    Write(o, v, o.references.TableB_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::weak_ptr<TableB> &v) const {
+    Write(o, v.lock(), o.references.TableB_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::vector<TableB> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &s, TableB &v) {
+    Read(s, v.name);
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<TableB> &v) {
+    Read(s, v, s.references.TableB_objects, s.references.TableB_count);
+  }
+
+  template<typename I> void Read(I &s, std::weak_ptr<TableB> &v) {
+    auto t = v.lock();
+    Read(s, t, s.references.TableB_objects, s.references.TableB_count);
+    v = t;
+  }
+
+  template<typename I> void Read(I &s, std::vector<TableB> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const TableD &v) const {
+    Write(o, v.name);
+    Write(o, v.a);
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<TableD> &v) const {
+    Write(o, v, o.references.TableD_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::weak_ptr<TableD> &v) const {
+    Write(o, v.lock(), o.references.TableD_ids);
+  }
+
+  template<typename I> void Read(I &s, TableD &v) {
+    Read(s, v.name);
+    Read(s, v.a);
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<TableD> &v) {
+    Read(s, v, s.references.TableD_objects, s.references.TableD_count);
+  }
+
+  template<typename I> void Read(I &s, std::weak_ptr<TableD> &v) {
+    auto t = v.lock();
+    Read(s, t, s.references.TableD_objects, s.references.TableD_count);
+    v = t;
+  }
+
+  template<typename O> void Write(O &o, const TableC &v) const {
+    Write(o, v.a);
+    Write(o, v.b);
+    Write(o, v.c);
+    Write(o, v.d);
+    Write(o, v.e);
+  }
+
+  template<typename I> void Read(I &s, TableC &v) {
+    Read(s, v.a);
+    Read(s, v.b);
+    Read(s, v.c);
+    Read(s, v.d);
+    Read(s, v.e);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.0", 3);
+    const std::uint32_t counts[3] = {};
+    WriteValues(o, counts, 3);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    if (std::memcmp(version, "0.0", 3) != 0)
+      return false;
+    std::uint32_t counts[3] = {};
+    ReadValues(i, counts, 3);
+    i.references.TableA_count = counts[0];
+    i.references.TableB_count = counts[1];
+    i.references.TableD_count = counts[2];
+    return !Failed(i) && Available(i, std::size_t(counts[0]) + std::size_t(counts[1]) + std::size_t(counts[2]), 1);
+  }
+
+  void PatchHeader(char *header, const WriteReferences &references) const {
+    const std::uint32_t counts[3] = {
+      static_cast<std::uint32_t>(references.TableA_ids.size()),
+      static_cast<std::uint32_t>(references.TableB_ids.size()),
+      static_cast<std::uint32_t>(references.TableD_ids.size()),
+    };
+    std::memcpy(header + 8, counts, sizeof(counts));
+  }
+
+  void PatchHeader(std::ostream &o, std::ostream::pos_type start, const WriteReferences &references) const {
+    const auto end = o.tellp();
+    if (start == std::ostream::pos_type(-1) || end == std::ostream::pos_type(-1))
+      return;
+    char header[20];
+    PatchHeader(header, references);
+    o.seekp(start + std::streamoff(8));
+    o.write(header + 8, 12);
+    o.seekp(end);
+  }
+
+  template<typename I> void Visit(I &i, TableCVisitor &visitor) {
+    {
+      TableA value{};
+      Read(i, value);
+      visitor.on_a(value);
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_b_begin(size);
+      TableB entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_b_element(entry);
+      }
+      visitor.on_b_end();
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_c_begin(size);
+      std::unique_ptr<TableB> entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_c_element(entry);
+      }
+      visitor.on_c_end();
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_d_begin(size);
+      std::shared_ptr<TableB> entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_d_element(entry);
+      }
+      visitor.on_d_end();
+    }
+    {
+      std::size_t size = 0;
+      Read(i, size);
+      visitor.on_e_begin(size);
+      std::weak_ptr<TableB> entry{};
+      for (std::size_t n = 0; n < size && !Failed(i); ++n) {
+        Read(i, entry);
+        visitor.on_e_element(entry);
+      }
+      visitor.on_e_end();
+    }
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void SkipEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Skip(InputBuffer &i, const std::vector<std::string> *) {
+    SkipEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      Skip(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+    }
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::weak_ptr<T> *) {
+    Skip(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::weak_ptr<T> *>(nullptr));
+  }
+
+  StringView MakeView(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return StringView();
+    i.pos += s;
+    return StringView(i.data + i.pos - s, s);
+  }
+  void Skip(InputBuffer &i, const TableA *) {
+    Skip(i, static_cast<const std::string *>(nullptr));
+    Skip(i, static_cast<const std::unique_ptr<TableD> *>(nullptr));
+    Skip(i, static_cast<const std::weak_ptr<TableD> *>(nullptr));
+    Skip(i, static_cast<const std::shared_ptr<TableD> *>(nullptr));
+    Skip(i, static_cast<const std::shared_ptr<TableD> *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<TableA> *) {
+    SkipEach(i, static_cast<const TableA *>(nullptr));
+  }
+
+  TableAView MakeView(InputBuffer &i, const TableA *);
+  TableAView MakeView(InputBuffer &i, const std::unique_ptr<TableA> *);
+
+  void Skip(InputBuffer &i, const TableB *) {
+    Skip(i, static_cast<const std::string *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<TableB> *) {
+    SkipEach(i, static_cast<const TableB *>(nullptr));
+  }
+
+  TableBView MakeView(InputBuffer &i, const TableB *);
+  TableBView MakeView(InputBuffer &i, const std::unique_ptr<TableB> *);
+
+  void Skip(InputBuffer &i, const TableD *) {
+    Skip(i, static_cast<const std::string *>(nullptr));
+    Skip(i, static_cast<const std::shared_ptr<TableA> *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<TableD> *) {
+    SkipEach(i, static_cast<const TableD *>(nullptr));
+  }
+
+  TableDView MakeView(InputBuffer &i, const TableD *);
+  TableDView MakeView(InputBuffer &i, const std::unique_ptr<TableD> *);
+
+  void Skip(InputBuffer &i, const TableC *) {
+    Skip(i, static_cast<const TableA *>(nullptr));
+    Skip(i, static_cast<const std::vector<TableB> *>(nullptr));
+    Skip(i, static_cast<const std::vector<std::unique_ptr<TableB>> *>(nullptr));
+    Skip(i, static_cast<const std::vector<std::shared_ptr<TableB>> *>(nullptr));
+    Skip(i, static_cast<const std::vector<std::weak_ptr<TableB>> *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<TableC> *) {
+    SkipEach(i, static_cast<const TableC *>(nullptr));
+  }
+
+  TableCView MakeView(InputBuffer &i, const TableC *);
+  TableCView MakeView(InputBuffer &i, const std::unique_ptr<TableC> *);
+
+  template<typename T> void Verify(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void VerifyEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Verify(i, static_cast<const T *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Verify(InputBuffer &i, const std::vector<std::string> *) {
+    VerifyEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Verify(i, static_cast<const T *>(nullptr));
+    else if (ref != '\0')
+      Fail(i);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  static std::uint64_t &Verified(InputBuffer &i, const TableA *) {
+    return i.references.TableA_verified;
+  }
+
+  static std::uint64_t &Verified(InputBuffer &i, const TableB *) {
+    return i.references.TableB_verified;
+  }
+
+  static std::uint64_t &Verified(InputBuffer &i, const TableD *) {
+    return i.references.TableD_verified;
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      ++Verified(i, static_cast<const T *>(nullptr));
+      Verify(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+      if (index == 0 || index > Verified(i, static_cast<const T *>(nullptr)))
+        Fail(i);
+    } else if (ref != '\0') {
+      Fail(i);
+    }
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::weak_ptr<T> *) {
+    Verify(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const TableA *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const std::unique_ptr<TableD> *>(nullptr));
+    Verify(i, static_cast<const std::weak_ptr<TableD> *>(nullptr));
+    Verify(i, static_cast<const std::shared_ptr<TableD> *>(nullptr));
+    Verify(i, static_cast<const std::shared_ptr<TableD> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<TableA> *) {
+    VerifyEach(i, static_cast<const TableA *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const TableB *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<TableB> *) {
+    VerifyEach(i, static_cast<const TableB *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const TableD *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+    Verify(i, static_cast<const std::shared_ptr<TableA> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<TableD> *) {
+    VerifyEach(i, static_cast<const TableD *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const TableC *) {
+    Verify(i, static_cast<const TableA *>(nullptr));
+    Verify(i, static_cast<const std::vector<TableB> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::unique_ptr<TableB>> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::shared_ptr<TableB>> *>(nullptr));
+    Verify(i, static_cast<const std::vector<std::weak_ptr<TableB>> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<TableC> *) {
+    VerifyEach(i, static_cast<const TableC *>(nullptr));
+  }
+
+  template<typename O> void WriteDelta(O &o, TableC &v) const {
+    WriteBytes(o, "DLTE0.0", 7);
+    const bool references = v.changes_[0] || v.changes_[3] || v.changes_[4];
+    if (references) {
+      Write(o, std::uint32_t(1));
+      Write(o, v.a);
+    }
+    if (v.changes_[1]) {
+      Write(o, std::uint32_t(2));
+      const auto runs = v.b_changed_.runs(v.b.size());
+      Write(o, v.b.size());
+      Write(o, runs.size());
+      for (const auto &r : runs) {
+        Write(o, r.first);
+        Write(o, r.second - r.first);
+        for (auto n = r.first; n < r.second; ++n)
+          Write(o, v.b[n]);
+      }
+    }
+    if (v.changes_[2]) {
+      Write(o, std::uint32_t(3));
+      const auto runs = v.c_changed_.runs(v.c.size());
+      Write(o, v.c.size());
+      Write(o, runs.size());
+      for (const auto &r : runs) {
+        Write(o, r.first);
+        Write(o, r.second - r.first);
+        for (auto n = r.first; n < r.second; ++n)
+          Write(o, v.c[n]);
+      }
+    }
+    if (references) {
+      Write(o, std::uint32_t(4));
+      Write(o, v.d);
+    }
+    if (references) {
+      Write(o, std::uint32_t(5));
+      Write(o, v.e);
+    }
+    Write(o, std::uint32_t(0));
+    v.clear_changes();
+  }
+
+  template<typename I, typename V> bool ReadRun(I &i, V &v, std::size_t size, std::size_t &first, std::size_t &count, std::size_t element) {
+    Read(i, first);
+    Read(i, count);
+    if (Failed(i))
+      return false;
+    if (first > v.size() || first > size || count > size - first) {
+      Fail(i);
+      return false;
+    }
+    if (!Available(i, count, element))
+      return false;
+    if (first + count > v.size())
+      v.resize(first + count);
+    return true;
+  }
+
+  template<typename I, typename V> void EndRuns(I &i, V &v, std::size_t size) {
+    if (Failed(i))
+      return;
+    if (size > v.size())
+      Fail(i);
+    else
+      v.resize(size);
+  }
+
+  template<typename I> bool ApplyDelta(I &i, TableC &v) {
+    char marker[7];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 7);
+    if (std::memcmp(marker, "DLTE0.0", 7) != 0) {
+      Fail(i);
+      return false;
+    }
+    for (;;) {
+      std::uint32_t member = 0;
+      Read(i, member);
+      if (Failed(i))
+        return false;
+      switch (member) {
+      case 0:
+        return true;
+      case 1: {
+        Read(i, v.a);
+        break;
+      }
+      case 2: {
+        std::size_t size = 0, runs = 0;
+        Read(i, size);
+        Read(i, runs);
+        for (std::size_t r = 0; r < runs && !Failed(i); ++r) {
+          std::size_t first = 0, count = 0;
+          if (ReadRun(i, v.b, size, first, count, 1))
+            for (auto n = first; n < first + count; ++n)
+              Read(i, v.b[n]);
+        }
+        EndRuns(i, v.b, size);
+        break;
+      }
+      case 3: {
+        std::size_t size = 0, runs = 0;
+        Read(i, size);
+        Read(i, runs);
+        for (std::size_t r = 0; r < runs && !Failed(i); ++r) {
+          std::size_t first = 0, count = 0;
+          if (ReadRun(i, v.c, size, first, count, 1))
+            for (auto n = first; n < first + count; ++n)
+              Read(i, v.c[n]);
+        }
+        EndRuns(i, v.c, size);
+        break;
+      }
+      case 4: {
+        Read(i, v.d);
+        break;
+      }
+      case 5: {
+        Read(i, v.e);
+        break;
+      }
+      default:
+        Fail(i);
+        return false;
+      }
+    }
+  }
+
+  static std::uint64_t HashBytes(std::uint64_t h, const char *data, std::size_t size) {
+    for (std::size_t n = 0; n < size; ++n)
+      h = (h ^ static_cast<unsigned char>(data[n])) * 0x100000001b3u;
+    return h;
+  }
+
+  template<typename T> std::uint64_t Hash(std::uint64_t h, const T &v) const {
+    return HashBytes(h, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename T> std::uint64_t Hash(std::uint64_t h, const std::vector<T> &v) const {
+    h = Hash(h, v.size());
+    for (const auto &entry : v)
+      h = Hash(h, entry);
+    return h;
+  }
+
+  template<typename T> std::uint64_t Hash(std::uint64_t h, const std::unique_ptr<T> &v) const {
+    return v ? Hash(Hash(h, '\x1'), *v) : Hash(h, '\x0');
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const std::string &v) const {
+    return HashBytes(Hash(h, v.size()), v.data(), v.size());
+  }
+
+  std::uint64_t Hash(std::uint64_t h, const TableB &v) const {
+    h = Hash(h, v.name);
+    return h;
+  }
+
+  template<typename O, typename V> void WriteLiteral(O &o, const V &v, std::size_t first, std::size_t last) const {
+    if (first == last)
+      return;
+    Write(o, last - first);
+    Write(o, std::size_t(0));
+    for (auto n = first; n < last; ++n)
+      Write(o, v[n]);
+  }
+
+  template<typename V> void IndexElements(const V &a, std::vector<std::uint64_t> &hashes, std::vector<std::size_t> &slots) const {
+    std::size_t capacity = 16;
+    while (capacity < 2 * a.size())
+      capacity *= 2;
+    hashes.resize(a.size());
+    slots.assign(capacity, 0);
+    for (std::size_t k = 0; k < a.size(); ++k) {
+      hashes[k] = Hash(0xcbf29ce484222325u, a[k]);
+      auto s = hashes[k] & (capacity - 1);
+      while (slots[s] != 0 && hashes[slots[s] - 1] != hashes[k])
+        s = (s + 1) & (capacity - 1);
+      if (slots[s] == 0)
+        slots[s] = k + 1;
+    }
+  }
+
+  template<typename V> std::size_t FindElement(const V &a, const typename V::value_type &e, const std::vector<std::uint64_t> &hashes, const std::vector<std::size_t> &slots) const {
+    const auto h = Hash(0xcbf29ce484222325u, e);
+    for (auto s = h & (slots.size() - 1); slots[s] != 0; s = (s + 1) & (slots.size() - 1))
+      if (hashes[slots[s] - 1] == h)
+        return a[slots[s] - 1] == e ? slots[s] - 1 : a.size();
+    return a.size();
+  }
+
+  template<typename O, typename V> void WriteVectorDiff(O &o, const V &a, const V &b) const {
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::size_t> slots;
+    Write(o, b.size());
+    std::size_t literal = 0, next = 0;
+    for (std::size_t n = 0; n < b.size();) {
+      auto from = a.size();
+      const auto replaced = next + (n - literal);
+      if (replaced < a.size() && a[replaced] == b[n]) {
+        from = replaced;
+      } else if (next < a.size() && a[next] == b[n]) {
+        from = next;
+      } else {
+        if (slots.empty())
+          IndexElements(a, hashes, slots);
+        from = FindElement(a, b[n], hashes, slots);
+      }
+      if (from == a.size()) {
+        ++n;
+        continue;
+      }
+      std::size_t count = 1;
+      while (n + count < b.size() && from + count < a.size() && a[from + count] == b[n + count])
+        ++count;
+      WriteLiteral(o, b, literal, n);
+      Write(o, count);
+      Write(o, from + 1);
+      n += count;
+      literal = n;
+      next = from + count;
+    }
+    WriteLiteral(o, b, literal, b.size());
+  }
+
+  template<typename V> bool ReadCopy(InputBuffer &i, V &v, const V &a, std::size_t size, std::size_t count, std::size_t from) {
+    if (count == 0 || count > size - v.size() || from - 1 >= a.size() || count > a.size() - (from - 1)) {
+      Fail(i);
+      return false;
+    }
+    v.insert(v.end(), a.begin() + (from - 1), a.begin() + (from - 1 + count));
+    return true;
+  }
+
+  template<typename V> bool ReadLiteral(InputBuffer &i, V &v, std::size_t size, std::size_t count) {
+    if (count == 0 || count > size - v.size()) {
+      Fail(i);
+      return false;
+    }
+    if (!Available(i, count, 1))
+      return false;
+    v.resize(v.size() + count);
+    return true;
+  }
+
+  struct OutputHash {
+    std::uint64_t hash;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputHash &o, const char *d, std::size_t s) const {
+    o.hash = HashBytes(o.hash, d, s);
+  }
+
+  // a patch only applies to the value it was made from, it carries the hash of its written bytes
+  std::uint64_t HashDiffBase(const TableC &v) const {
+    OutputHash h{0xcbf29ce484222325u, {}};
+    Write(h, v);
+    return h.hash;
+  }
+
+  static bool Differs(const std::vector<char> &a, const OutputBuffer &oa, const std::vector<char> &b, const OutputBuffer &ob) {
+    return oa.size != ob.size || (oa.size != 0 && std::memcmp(a.data(), b.data(), oa.size) != 0);
+  }
+
+  // pointers compare by the values they point to, so the written bytes are compared
+  template<typename T> bool WrittenDiffers(const T &a, const T &b) const {
+    std::vector<char> wa, wb;
+    OutputBuffer oa{wa, 0, {}}, ob{wb, 0, {}};
+    Write(oa, a);
+    Write(ob, b);
+    return Differs(wa, oa, wb, ob);
+  }
+
+  template<typename O> void WriteDiff(O &o, const TableC &a, const TableC &b) const {
+    WriteBytes(o, "DIFE0.0", 7);
+    Write(o, HashDiffBase(a));
+    // members with shared or weak pointers are written together, they share the ids of their objects
+    std::vector<char> ra, rb;
+    OutputBuffer oa{ra, 0, {}}, ob{rb, 0, {}};
+    Write(oa, a.a);
+    Write(oa, a.d);
+    Write(oa, a.e);
+    Write(ob, b.a);
+    Write(ob, b.d);
+    Write(ob, b.e);
+    const bool references = Differs(ra, oa, rb, ob);
+    if (references) {
+      Write(o, std::uint32_t(1));
+      Write(o, b.a);
+    }
+    if (a.b != b.b) {
+      Write(o, std::uint32_t(2));
+      WriteVectorDiff(o, a.b, b.b);
+    }
+    if (WrittenDiffers(a.c, b.c)) {
+      Write(o, std::uint32_t(3));
+      Write(o, b.c);
+    }
+    if (references) {
+      Write(o, std::uint32_t(4));
+      Write(o, b.d);
+    }
+    if (references) {
+      Write(o, std::uint32_t(5));
+      Write(o, b.e);
+    }
+    Write(o, std::uint32_t(0));
+  }
+
+  bool ApplyDiff(InputBuffer &i, TableC &v) {
+    char marker[7];
+    std::uint64_t base = 0;
+    error_offset_ = 0;
+    ReadBytes(i, marker, 7);
+    Read(i, base);
+    if (std::memcmp(marker, "DIFE0.0", 7) != 0 || base != HashDiffBase(v)) {
+      Fail(i);
+      return false;
+    }
+    for (;;) {
+      std::uint32_t member = 0;
+      Read(i, member);
+      if (Failed(i))
+        return false;
+      switch (member) {
+      case 0:
+        return true;
+      case 1: {
+        Read(i, v.a);
+        break;
+      }
+      case 2: {
+        std::size_t size = 0;
+        Read(i, size);
+        decltype(v.b) b(v.b.get_allocator());
+        while (b.size() < size && !Failed(i)) {
+          std::size_t count = 0, from = 0;
+          Read(i, count);
+          Read(i, from);
+          if (Failed(i))
+            break;
+          if (from != 0) {
+            ReadCopy(i, b, v.b, size, count, from);
+            continue;
+          }
+          if (ReadLiteral(i, b, size, count))
+            for (auto n = b.size() - count; n < b.size(); ++n)
+              Read(i, b[n]);
+        }
+        if (!Failed(i))
+          v.b.swap(b);
+        break;
+      }
+      case 3: {
+        Read(i, v.c);
+        break;
+      }
+      case 4: {
+        Read(i, v.d);
+        break;
+      }
+      case 5: {
+        Read(i, v.e);
+        break;
+      }
+      default:
+        Fail(i);
+        return false;
+      }
+    }
+  }
+
+  enum JournalOperation : std::uint32_t { JournalSet, JournalAssign, JournalPush, JournalInsert, JournalErase };
+
+  // every journal record starts with the little endian size and hash of its payload
+  static constexpr std::size_t JournalFrameSize() {
+    return 12;
+  }
+
+  static std::uint64_t JournalWord(const char *d, std::size_t bytes) {
+    std::uint64_t v = 0;
+    while (bytes-- != 0)
+      v = (v << 8) | static_cast<unsigned char>(d[bytes]);
+    return v;
+  }
+
+  void WriteJournalFrame(std::vector<char> &b, std::size_t start) const {
+    const std::uint64_t size = b.size() - start - JournalFrameSize();
+    const auto hash = HashBytes(0xcbf29ce484222325u, b.data() + start + JournalFrameSize(), size);
+    for (std::size_t n = 0; n < 4; ++n)
+      b[start + n] = static_cast<char>(size >> (8 * n));
+    for (std::size_t n = 0; n < 8; ++n)
+      b[start + 4 + n] = static_cast<char>(hash >> (8 * n));
+  }
+
+  // end of the last complete record, 0 without a journal header or with a damaged record before the end
+  std::size_t JournalEnd(const char *data, std::size_t size) {
+    if (size < 7 || std::memcmp(data, "JRNE0.0", 7) != 0)
+      return 0;
+    std::size_t pos = 7;
+    while (size - pos >= JournalFrameSize()) {
+      const auto length = JournalWord(data + pos, 4);
+      if (length > size - pos - JournalFrameSize())
+        break;
+      if (HashBytes(0xcbf29ce484222325u, data + pos + JournalFrameSize(), length) != JournalWord(data + pos + 4, 8)) {
+        if (pos + JournalFrameSize() + length == size)
+          return pos;
+        error_offset_ = pos;
+        return 0;
+      }
+      pos += JournalFrameSize() + length;
+    }
+    return pos;
+  }
+
+  // a checkpoint holds the hash of a snapshot and how many bytes before it the state of the snapshot was reached
+  bool JournalCheckpoint(const char *data, std::size_t size, std::uint64_t &snapshot, std::uint64_t &back) {
+    InputBuffer i{data, size, 0, false, {}};
+    std::uint32_t member = 1, operation = 0;
+    Read(i, member);
+    Read(i, operation);
+    Read(i, snapshot);
+    Read(i, back);
+    return member == 0 && !Failed(i);
+  }
+
+  static bool JournalRange(std::uint32_t operation, std::size_t first, std::size_t last, std::size_t size) {
+    switch (operation) {
+    case JournalSet:
+    case JournalPush:
+      return true;
+    case JournalAssign:
+      return first < size;
+    case JournalInsert:
+      return first <= size;
+    case JournalErase:
+      return first <= last && last <= size;
+    }
+    return false;
+  }
+
+  bool ApplyJournalRecord(InputBuffer &i, TableC &v) {
+    std::uint32_t member = 0, operation = 0;
+    Read(i, member);
+    Read(i, operation);
+    if (Failed(i))
+      return false;
+    if (member == 0) {
+      std::uint64_t snapshot = 0, back = 0;
+      Read(i, snapshot);
+      Read(i, back);
+      return !Failed(i);
+    }
+    std::size_t first = 0, last = 0;
+    if (operation == JournalAssign || operation == JournalInsert || operation == JournalErase)
+      Read(i, first);
+    if (operation == JournalErase)
+      Read(i, last);
+    if (Failed(i))
+      return false;
+    switch (member) {
+    case 2:
+      if (!JournalRange(operation, first, last, v.b.size()))
+        break;
+      switch (operation) {
+      case JournalSet:
+        Read(i, v.b);
+        break;
+      case JournalAssign:
+        Read(i, v.b[first]);
+        break;
+      case JournalPush:
+        first = v.b.size();
+        v.b.emplace_back();
+        Read(i, v.b.back());
+        break;
+      case JournalInsert:
+        v.b.emplace(v.b.begin() + first);
+        Read(i, v.b[first]);
+        break;
+      default:
+        v.b.erase(v.b.begin() + first, v.b.begin() + last);
+      }
+      if (operation == JournalSet)
+        v.mark_b();
+      else
+        v.mark_b(first, operation == JournalAssign ? first + 1 : v.b.size());
+      return !Failed(i);
+    case 3:
+      if (!JournalRange(operation, first, last, v.c.size()))
+        break;
+      switch (operation) {
+      case JournalSet:
+        Read(i, v.c);
+        break;
+      case JournalAssign:
+        Read(i, v.c[first]);
+        break;
+      case JournalPush:
+        first = v.c.size();
+        v.c.emplace_back();
+        Read(i, v.c.back());
+        break;
+      case JournalInsert:
+        v.c.emplace(v.c.begin() + first);
+        Read(i, v.c[first]);
+        break;
+      default:
+        v.c.erase(v.c.begin() + first, v.c.begin() + last);
+      }
+      if (operation == JournalSet)
+        v.mark_c();
+      else
+        v.mark_c(first, operation == JournalAssign ? first + 1 : v.c.size());
+      return !Failed(i);
+    }
+    Fail(i);
+    return false;
+  }
+
+  // replays the records from the point the last checkpoint of the snapshot refers to, a journal that does not start
+  // with a checkpoint was opened on the snapshot and is replayed from its start
+  bool ReplayJournal(const char *data, std::size_t size, std::uint64_t snapshot, TableC &v) {
+    error_offset_ = 0;
+    const auto end = JournalEnd(data, size);
+    if (end == 0)
+      return false;
+    std::size_t start = 7;
+    bool found = false, leading = false;
+    std::vector<std::size_t> frames;
+    for (auto pos = start; pos < end; pos += JournalFrameSize() + JournalWord(data + pos, 4)) {
+      frames.push_back(pos);
+      std::uint64_t hash = 0, back = 0;
+      if (!JournalCheckpoint(data + pos + JournalFrameSize(), JournalWord(data + pos, 4), hash, back))
+        continue;
+      leading = leading || pos == 7;
+      if (hash == snapshot && back <= pos && std::binary_search(frames.begin(), frames.end(), pos - back)) {
+        found = true;
+        start = static_cast<std::size_t>(pos - back);
+      }
+    }
+    if (leading && !found)
+      return false;
+    for (auto pos = start; pos < end;) {
+      const auto length = JournalWord(data + pos, 4);
+      InputBuffer i{data + pos + JournalFrameSize(), length, 0, false, {}};
+      if (!ApplyJournalRecord(i, v) || i.pos != i.size) {
+        error_offset_ = pos;
+        return false;
+      }
+      pos += JournalFrameSize() + length;
+    }
+    return true;
+  }
+
+  static bool ReadFileData(const std::string &path, std::vector<char> &d) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    auto ok = ::fstat(fd, &st) == 0;
+    d.resize(ok ? static_cast<std::size_t>(st.st_size) : 0);
+    for (std::size_t done = 0; ok && done < d.size();) {
+      const auto n = ::read(fd, d.data() + done, d.size() - done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      ok = n > 0;
+      done += ok ? static_cast<std::size_t>(n) : 0;
+    }
+    ::close(fd);
+    return ok;
+#else
+    std::ifstream f(path, std::ios::binary);
+    if (!f)
+      return false;
+    d.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return !f.bad();
+#endif
+  }
+
+  static constexpr std::size_t ParallelSliceMinimum() {
+    return 1024;
+  }
+
+  template<typename T> std::vector<char> EncodeSlice(const T *begin, const T *end) {
+    std::vector<char> b;
+    OutputBuffer o{b, 0, {}};
+    for (auto entry = begin; entry != end; ++entry) {
+      Write(o, *entry);
+    }
+    b.resize(o.size);
+    return b;
+  }
+
+  template<typename O, typename T> void WriteVectorParallel(O &o, const std::vector<T> &v, unsigned int threads) const {
+    Write(o, v.size());
+    const auto slices = std::min<std::size_t>(threads, v.size() / ParallelSliceMinimum());
+    if (slices < 2) {
+      for (const auto &entry : v) {
+        Write(o, entry);
+      }
+      return;
+    }
+
+    std::vector<std::future<std::vector<char>>> parts;
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto *begin = v.data() + v.size() * s / slices;
+      const auto *end = v.data() + v.size() * (s + 1) / slices;
+      parts.push_back(std::async(std::launch::async, [begin, end]() {
+        return TableC_io().EncodeSlice(begin, end);
+      }));
+    }
+    for (std::size_t s = 0; s < slices; ++s) {
+      const auto part = parts[s].get();
+      WriteBytes(o, part.data(), part.size());
+    }
+  }
+
+  template<typename O> void WriteParallel(O &o, const TableC &v, unsigned int threads) const {
+    Write(o, v.a);
+    WriteVectorParallel(o, v.b, threads);
+    WriteVectorParallel(o, v.c, threads);
+    Write(o, v.d);
+    Write(o, v.e);
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  // owns a file descriptor, it is closed on every way out unless close() was called
+  struct FileHandle {
+    FileHandle() = default;
+    FileHandle(const FileHandle &) = delete;
+    FileHandle &operator=(const FileHandle &) = delete;
+    ~FileHandle() {
+      if (fd >= 0)
+        ::close(fd);
+    }
+    bool close() {
+      const auto closed = fd >= 0 && ::close(fd) == 0;
+      fd = -1;
+      return closed;
+    }
+    int fd{-1};
+  };
+
+  static bool PwriteAll(int fd, const char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pwrite(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  // allocates the blocks up front, so a full disk fails here and not with SIGBUS while writing a mapping
+  static bool ReserveFile(int fd, std::size_t size) {
+#if defined(__APPLE__)
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+#else
+    return ::posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0;
+#endif
+  }
+
+  // makes a rename into the directory of path durable
+  static bool SyncDirectory(const std::string &path) {
+    const auto slash = path.find_last_of('/');
+    const auto directory = slash == std::string::npos ? std::string(".") : path.substr(0, slash == 0 ? 1 : slash);
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+      return false;
+    const auto synced = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && synced;
+  }
+#endif
+
+  static constexpr std::size_t AsyncBlockSize() {
+    return 1 << 20;
+  }
+
+  struct AsyncOutput {
+#if defined(__unix__) || defined(__APPLE__)
+    FileHandle file;
+#else
+    std::ofstream file;
+#endif
+    std::vector<char> buffer;
+    std::vector<char> flushing;
+    std::future<bool> flushed;
+    std::uint64_t size;
+    bool failed;
+    WriteReferences references;
+  };
+
+  static bool FlushAll(AsyncOutput &o, const std::vector<char> &d) {
+#if defined(__unix__) || defined(__APPLE__)
+    std::size_t done = 0;
+    while (done < d.size()) {
+      const auto n = ::write(o.file.fd, d.data() + done, d.size() - done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      done += static_cast<std::size_t>(n);
+    }
+    return true;
+#else
+    return bool(o.file.write(d.data(), d.size()));
+#endif
+  }
+
+  static bool WaitFlush(AsyncOutput &o) {
+    if (o.flushed.valid() && !o.flushed.get())
+      o.failed = true;
+    return !o.failed;
+  }
+
+  static void FlushAsync(AsyncOutput &o) {
+    WaitFlush(o);
+    std::swap(o.buffer, o.flushing);
+    o.buffer.clear();
+    auto *output = &o;
+    o.flushed = std::async(std::launch::async, [output]() { return FlushAll(*output, output->flushing); });
+  }
+
+  void WriteBytes(AsyncOutput &o, const char *d, std::size_t s) const {
+    o.buffer.insert(o.buffer.end(), d, d + s);
+    o.size += s;
+    if (o.buffer.size() >= AsyncBlockSize())
+      FlushAsync(o);
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  static constexpr std::size_t FileBlockSize() {
+    return 1 << 20;
+  }
+
+  static constexpr std::size_t FileBlockCount() {
+    return 4;
+  }
+
+#ifdef COREBUFFER_IO_URING
+  struct FileRing {
+    int fd{-1};
+    void *sqRing;
+    void *cqRing;
+    io_uring_sqe *sqes;
+    std::size_t sqRingSize;
+    std::size_t cqRingSize;
+    std::size_t sqesSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    io_uring_cqe *cqes;
+  };
+
+  static void CloseRing(FileRing &r) {
+    if (r.sqes)
+      ::munmap(r.sqes, r.sqesSize);
+    if (r.cqRing)
+      ::munmap(r.cqRing, r.cqRingSize);
+    if (r.sqRing)
+      ::munmap(r.sqRing, r.sqRingSize);
+    if (r.fd >= 0)
+      ::close(r.fd);
+    r = FileRing();
+    r.fd = -1;
+  }
+
+  static bool SetupRing(FileRing &r, char *buffer, std::size_t size) {
+    r = FileRing();
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    r.fd = static_cast<int>(::syscall(__NR_io_uring_setup, static_cast<unsigned>(FileBlockCount()), &params));
+    if (r.fd < 0)
+      return false;
+    r.sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    r.cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    r.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    const auto map = [&r](std::size_t length, off_t offset) -> void * {
+      void *p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, r.fd, offset);
+      return p == MAP_FAILED ? nullptr : p;
+    };
+    r.sqRing = map(r.sqRingSize, IORING_OFF_SQ_RING);
+    r.cqRing = map(r.cqRingSize, IORING_OFF_CQ_RING);
+    r.sqes = static_cast<io_uring_sqe *>(map(r.sqesSize, IORING_OFF_SQES));
+    iovec registered{buffer, size};
+    if (!r.sqRing || !r.cqRing || !r.sqes ||
+        ::syscall(__NR_io_uring_register, r.fd, IORING_REGISTER_BUFFERS, &registered, 1) != 0) {
+      CloseRing(r);
+      return false;
+    }
+    auto *sq = static_cast<char *>(r.sqRing);
+    r.sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    r.sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    r.sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    r.sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    auto *cq = static_cast<char *>(r.cqRing);
+    r.cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    r.cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    r.cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    r.cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+  }
+
+  static bool SubmitFixed(FileRing &r, bool write, int fd, char *d, std::size_t s, std::uint64_t offset,
+                          std::uint64_t tag) {
+    const auto tail = *r.sqTail;
+    const auto slot = tail & *r.sqMask;
+    auto &sqe = r.sqes[slot];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(d);
+    sqe.len = static_cast<std::uint32_t>(s);
+    sqe.off = offset;
+    sqe.buf_index = 0;
+    sqe.user_data = tag;
+    r.sqArray[slot] = slot;
+    __atomic_store_n(r.sqTail, tail + 1, __ATOMIC_RELEASE);
+    long submitted = 0;
+    do
+      submitted = ::syscall(__NR_io_uring_enter, r.fd, 1, 0, 0, nullptr, 0);
+    while (submitted < 0 && errno == EINTR);
+    if (submitted == 1 || __atomic_load_n(r.sqHead, __ATOMIC_ACQUIRE) != tail)
+      return true;
+    __atomic_store_n(r.sqTail, tail, __ATOMIC_RELEASE);
+    return false;
+  }
+
+  static bool WaitFixed(FileRing &r, std::uint64_t &tag, int &result) {
+    for (;;) {
+      const auto head = *r.cqHead;
+      if (head != __atomic_load_n(r.cqTail, __ATOMIC_ACQUIRE)) {
+        const auto &cqe = r.cqes[head & *r.cqMask];
+        tag = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(r.cqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+      if (::syscall(__NR_io_uring_enter, r.fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+        return false;
+    }
+  }
+
+#else
+  struct FileRing {
+    int fd{-1};
+  };
+
+  static void CloseRing(FileRing &r) {
+    r.fd = -1;
+  }
+
+  static bool SetupRing(FileRing &r, char *, std::size_t) {
+    r.fd = -1;
+    return false;
+  }
+
+  static bool SubmitFixed(FileRing &, bool, int, char *, std::size_t, std::uint64_t, std::uint64_t) {
+    return false;
+  }
+
+  static bool WaitFixed(FileRing &, std::uint64_t &, int &) {
+    return false;
+  }
+
+#endif
+
+  static bool PreadAll(int fd, char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pread(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  struct FileOutput {
+    ~FileOutput() {
+      CloseRing(ring);
+    }
+    FileHandle file;
+    FileRing ring;
+    std::vector<char> blocks;
+    std::vector<std::size_t> pending;
+    std::vector<std::uint64_t> offsets;
+    std::size_t block;
+    std::size_t used;
+    std::uint64_t size;
+    bool failed;
+    WriteReferences references;
+  };
+
+  static void CompleteWrite(FileOutput &o) {
+    std::uint64_t block = 0;
+    int result = 0;
+    if (!WaitFixed(o.ring, block, result) || block >= FileBlockCount()) {
+      o.failed = true;
+      std::fill(o.pending.begin(), o.pending.end(), 0);
+      return;
+    }
+    const auto length = o.pending[block];
+    const auto done = static_cast<std::size_t>(std::max(result, 0));
+    if (result < 0 || (done < length && !PwriteAll(o.file.fd, o.blocks.data() + block * FileBlockSize() + done,
+                                                     length - done, o.offsets[block] + done)))
+      o.failed = true;
+    o.pending[block] = 0;
+  }
+
+  static void SubmitBlock(FileOutput &o) {
+    if (o.used == 0)
+      return;
+    auto *d = o.blocks.data() + o.block * FileBlockSize();
+    if (o.ring.fd >= 0 && SubmitFixed(o.ring, true, o.file.fd, d, o.used, o.size, o.block)) {
+      o.pending[o.block] = o.used;
+      o.offsets[o.block] = o.size;
+    } else if (!PwriteAll(o.file.fd, d, o.used, o.size)) {
+      o.failed = true;
+    }
+    o.size += o.used;
+    o.used = 0;
+    o.block = (o.block + 1) % FileBlockCount();
+    while (o.pending[o.block] != 0)
+      CompleteWrite(o);
+  }
+
+  void WriteBytes(FileOutput &o, const char *d, std::size_t s) const {
+    while (s != 0) {
+      const auto n = std::min(s, FileBlockSize() - o.used);
+      std::memcpy(o.blocks.data() + o.block * FileBlockSize() + o.used, d, n);
+      o.used += n;
+      d += n;
+      s -= n;
+      if (o.used == FileBlockSize())
+        SubmitBlock(o);
+    }
+  }
+
+  static bool FinishOutput(FileOutput &o) {
+    SubmitBlock(o);
+    for (std::size_t block = 0; block < FileBlockCount(); ++block)
+      while (o.pending[block] != 0)
+        CompleteWrite(o);
+    CloseRing(o.ring);
+    return !o.failed;
+  }
+
+  struct FileInput {
+    ~FileInput() {
+      CloseRing(ring);
+    }
+    FileHandle file;
+    FileRing ring;
+    std::vector<char> blocks;
+    std::vector<char> loaded;
+    std::uint64_t size;
+    std::uint64_t current;
+    std::size_t pos;
+    std::size_t pending;
+    bool failed;
+    ReadReferences references;
+  };
+
+  static std::size_t BlockLength(const FileInput &i, std::uint64_t block) {
+    if (block * FileBlockSize() >= i.size)
+      return 0;
+    return static_cast<std::size_t>(std::min<std::uint64_t>(FileBlockSize(), i.size - block * FileBlockSize()));
+  }
+
+  static void RequestBlock(FileInput &i, std::uint64_t block) {
+    const auto slot = block % FileBlockCount();
+    i.loaded[slot] = 0;
+    if (BlockLength(i, block) == 0 || i.ring.fd < 0)
+      return;
+    if (SubmitFixed(i.ring, false, i.file.fd, i.blocks.data() + slot * FileBlockSize(), BlockLength(i, block),
+                    block * FileBlockSize(), block))
+      ++i.pending;
+  }
+
+  static void CompleteRead(FileInput &i) {
+    std::uint64_t block = 0;
+    int result = 0;
+    if (!WaitFixed(i.ring, block, result)) {
+      i.failed = true;
+      i.pending = 0;
+      return;
+    }
+    --i.pending;
+    const auto slot = block % FileBlockCount();
+    const auto length = BlockLength(i, block);
+    const auto done = static_cast<std::size_t>(std::max(result, 0));
+    auto *d = i.blocks.data() + slot * FileBlockSize();
+    i.loaded[slot] = result >= 0 && (done >= length || PreadAll(i.file.fd, d + done, length - done,
+                                                                   block * FileBlockSize() + done));
+    if (!i.loaded[slot])
+      i.failed = true;
+  }
+
+  static bool LoadBlock(FileInput &i, std::uint64_t block) {
+    const auto slot = block % FileBlockCount();
+    while (!i.loaded[slot] && i.pending != 0 && !i.failed)
+      CompleteRead(i);
+    if (i.loaded[slot])
+      return true;
+    return !i.failed && BlockLength(i, block) != 0 &&
+           PreadAll(i.file.fd, i.blocks.data() + slot * FileBlockSize(), BlockLength(i, block), block * FileBlockSize());
+  }
+
+  void ReadBytes(FileInput &i, char *d, std::size_t s) {
+    while (s != 0) {
+      if (i.failed) {
+        std::memset(d, 0, s);
+        return;
+      }
+      if (i.pos == BlockLength(i, i.current)) {
+        RequestBlock(i, i.current + FileBlockCount());
+        ++i.current;
+        i.pos = 0;
+        if (!LoadBlock(i, i.current))
+          Fail(i);
+        continue;
+      }
+      const auto n = std::min(s, BlockLength(i, i.current) - i.pos);
+      std::memcpy(d, i.blocks.data() + (i.current % FileBlockCount()) * FileBlockSize() + i.pos, n);
+      i.pos += n;
+      d += n;
+      s -= n;
+    }
+  }
+
+  bool Failed(FileInput &i) {
+    return i.failed;
+  }
+
+  void Fail(FileInput &i) {
+    if (!i.failed)
+      error_offset_ = i.current * FileBlockSize() + i.pos;
+    i.failed = true;
+  }
+
+  static std::uint64_t Remaining(const FileInput &i) {
+    return i.size - i.current * FileBlockSize() - i.pos;
+  }
+
+  bool Available(FileInput &i, std::size_t count, std::size_t size) {
+    if (count <= Remaining(i) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  static bool FinishInput(FileInput &i) {
+    while (i.pending != 0)
+      CompleteRead(i);
+    CloseRing(i.ring);
+    return i.file.close() && !i.failed;
+  }
+
+#endif
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteTableC(std::ostream &o, const TableC &v) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteTableC(std::vector<char> &b, const TableC &v) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool ReadTableC(std::istream &stream, TableC &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadTableC(const char *data, std::size_t size, TableC &v) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  void WriteTableCParallel(std::ostream &o, const TableC &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    WriteParallel(s, v, threads);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteTableCParallel(std::vector<char> &b, const TableC &v, unsigned int threads = std::thread::hardware_concurrency()) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    WriteParallel(o, v, threads);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  void WriteTableCCompressed(std::ostream &o, const TableC &v) const {
+
+    o.write("CORZ", 4);
+    CompressedOutput c{o, {}, {}, {}};
+    c.block.reserve(CompressedBlockSize());
+    WriteHeader(c);
+    Write(c, v);
+    FlushBlock(c);
+    const std::uint32_t end[2] = {0, 0};
+    o.write(reinterpret_cast<const char *>(end), sizeof(end));
+  }
+
+  bool ReadTableCCompressed(std::istream &i, TableC &v) {
+
+    char marker[4];
+    i.read(marker, 4);
+    if (!i || std::memcmp(marker, "CORZ", 4) != 0)
+      return false;
+    CompressedInput c{MakeInput(i), {}, {}, 0, 0, false, {}};
+    if (!ReadHeader(c))
+      return false;
+    Read(c, v);
+    std::uint32_t end[2] = {1, 1};
+    i.read(reinterpret_cast<char *>(end), sizeof(end));
+    return !c.failed && c.pos == c.block.size() && i && end[0] == 0;
+  }
+
+  bool VisitTableC(std::istream &stream, TableCVisitor &visitor) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Visit(i, visitor);
+    return !Failed(i);
+  }
+
+  bool VisitTableC(const char *data, std::size_t size, TableCVisitor &visitor) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Visit(i, visitor);
+    return !Failed(i);
+  }
+
+  bool ViewTableC(const char *data, std::size_t size, TableCView &v);
+
+  bool VerifyTableC(const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Verify(i, static_cast<const TableC *>(nullptr));
+    if (!i.failed && i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  void WriteTableCDelta(std::ostream &o, TableC &v) const {
+    OutputStream s{o, 0, {}};
+    WriteDelta(s, v);
+  }
+
+  void WriteTableCDelta(std::vector<char> &b, TableC &v) const {
+    OutputBuffer o{b, b.size(), {}};
+    WriteDelta(o, v);
+    b.resize(o.size);
+  }
+
+  bool ApplyTableCDelta(std::istream &stream, TableC &v) {
+    auto i = MakeInput(stream);
+    return ApplyDelta(i, v);
+  }
+
+  bool ApplyTableCDelta(const char *data, std::size_t size, TableC &v) {
+    InputBuffer i{data, size, 0, false, {}};
+    return ApplyDelta(i, v);
+  }
+
+  std::vector<char> DiffTableC(const TableC &a, const TableC &b) const {
+    std::vector<char> patch;
+    OutputBuffer o{patch, 0, {}};
+    WriteDiff(o, a, b);
+    patch.resize(o.size);
+    return patch;
+  }
+
+  bool PatchTableC(TableC &v, const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ApplyDiff(i, v))
+      return false;
+    if (i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  bool PatchTableC(TableC &v, const std::vector<char> &patch) {
+    return PatchTableC(v, patch.data(), patch.size());
+  }
+
+  bool ReplayTableCJournal(const std::string &snapshot, const std::string &journal, TableC &v) {
+    std::vector<char> state, records;
+    if (!ReadFileData(snapshot, state) || !ReadFileData(journal, records) || !ReadTableC(state.data(), state.size(), v))
+      return false;
+    return ReplayJournal(records.data(), records.size(), HashBytes(0xcbf29ce484222325u, state.data(), state.size()), v);
+  }
+
+  std::size_t SerializedSize(const TableA &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const TableB &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const TableD &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const TableC &v) const {
+    OutputCounter c{0, {}};
+    WriteHeader(c);
+    Write(c, v);
+    return c.size;
+  }
+
+  bool LoadTableCFile(const std::string &path, TableC &v) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      return false;
+    }
+    const auto size = static_cast<std::size_t>(st.st_size);
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+      return false;
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    const auto ok = ReadTableC(static_cast<const char *>(data), size, v);
+    ::munmap(data, size);
+    return ok;
+#else
+    std::ifstream i(path, std::ios::binary);
+    return i && ReadTableC(i, v);
+#endif
+  }
+
+  bool SaveTableCFile(const std::string &path, const TableC &v) const {
+#if defined(__unix__) || defined(__APPLE__)
+    // the data goes to a temporary file first, path is replaced only once everything is on disk
+    const auto size = SerializedSize(v);
+    const auto temporary = path + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return false;
+    void *data = ReserveFile(fd, size) ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    OutputSpan s{static_cast<char *>(data), 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(s.data, s.references);
+    const auto flushed = ::msync(data, size, MS_SYNC) == 0;
+    const auto synced = ::munmap(data, size) == 0 && flushed && ::fsync(fd) == 0;
+    if (::close(fd) != 0 || !synced || ::rename(temporary.c_str(), path.c_str()) != 0) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    return SyncDirectory(path);
+#else
+    std::ofstream f(path, std::ios::binary);
+    WriteTableC(f, v);
+    return bool(f);
+#endif
+  }
+
+  std::future<bool> SaveTableCFileAsync(const std::string &path, const TableC &v) const {
+    auto output = std::make_shared<AsyncOutput>();
+#if defined(__unix__) || defined(__APPLE__)
+    // the data goes to a temporary file first, path is replaced only once everything is on disk
+    const auto temporary = path + ".tmp";
+    output->file.fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (output->file.fd < 0) {
+#else
+    output->file.open(path, std::ios::binary);
+    if (!output->file) {
+#endif
+      std::promise<bool> failed;
+      failed.set_value(false);
+      return failed.get_future();
+    }
+    output->buffer.reserve(AsyncBlockSize());
+    output->flushing.reserve(AsyncBlockSize());
+    WriteHeader(*output);
+    Write(*output, v);
+    char header[20];
+    PatchHeader(header, output->references);
+    const std::string counts(header + 8, 12);
+#if defined(__unix__) || defined(__APPLE__)
+    return std::async(std::launch::async, [output, path, temporary, counts]() {
+      auto ok = WaitFlush(*output) && FlushAll(*output, output->buffer);
+      ok = ok && PwriteAll(output->file.fd, counts.data(), counts.size(), 8);
+      if (!ok || ::fsync(output->file.fd) != 0 || !output->file.close() ||
+          ::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        return false;
+      }
+      return SyncDirectory(path);
+#else
+    return std::async(std::launch::async, [output, counts]() {
+      const auto ok = WaitFlush(*output) && FlushAll(*output, output->buffer);
+      output->file.seekp(8);
+      output->file.write(counts.data(), counts.size());
+      output->file.close();
+      return ok && !output->file.fail();
+#endif
+    });
+  }
+
+  bool SaveTableCFileUring(const std::string &path, const TableC &v) const {
+#if defined(__unix__) || defined(__APPLE__)
+    const auto temporary = path + ".tmp";
+    FileOutput f{};
+    f.file.fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (f.file.fd < 0)
+      return false;
+    f.blocks.resize(FileBlockCount() * FileBlockSize());
+    f.pending.assign(FileBlockCount(), 0);
+    f.offsets.assign(FileBlockCount(), 0);
+    SetupRing(f.ring, f.blocks.data(), f.blocks.size());
+    WriteHeader(f);
+    Write(f, v);
+    auto ok = FinishOutput(f);
+    char header[20];
+    PatchHeader(header, f.references);
+    ok = ok && PwriteAll(f.file.fd, header + 8, 12, 8);
+    if (!ok || ::fsync(f.file.fd) != 0 || !f.file.close() || ::rename(temporary.c_str(), path.c_str()) != 0) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    return SyncDirectory(path);
+#else
+    return SaveTableCFile(path, v);
+#endif
+  }
+
+  bool LoadTableCFileUring(const std::string &path, TableC &v) {
+#if defined(__unix__) || defined(__APPLE__)
+    FileInput f{};
+    f.file.fd = ::open(path.c_str(), O_RDONLY);
+    if (f.file.fd < 0)
+      return false;
+    struct stat st;
+    if (::fstat(f.file.fd, &st) != 0 || st.st_size == 0)
+      return false;
+    f.size = static_cast<std::uint64_t>(st.st_size);
+    f.blocks.resize(FileBlockCount() * FileBlockSize());
+    f.loaded.assign(FileBlockCount(), 0);
+    SetupRing(f.ring, f.blocks.data(), f.blocks.size());
+    for (std::uint64_t block = 0; block < FileBlockCount(); ++block)
+      RequestBlock(f, block);
+    f.failed = !LoadBlock(f, 0);
+    if (ReadHeader(f))
+      Read(f, v);
+    else
+      f.failed = true;
+    return FinishInput(f);
+#else
+    return LoadTableCFile(path, v);
+#endif
+  }
+
+};
+
+struct TableAView {
+  TableAView() = default;
+  TableAView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  StringView name() const;
+  TableDView d1() const;
+
+private:
+  friend struct TableC_io;
+
+  TableC_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[5]{};
+  mutable std::size_t known_{0};
+};
+
+struct TableBView {
+  TableBView() = default;
+  TableBView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  StringView name() const;
+
+private:
+  friend struct TableC_io;
+
+  TableC_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[1]{};
+  mutable std::size_t known_{0};
+};
+
+struct TableDView {
+  TableDView() = default;
+  TableDView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  StringView name() const;
+
+private:
+  friend struct TableC_io;
+
+  TableC_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[2]{};
+  mutable std::size_t known_{0};
+};
+
+struct TableCView {
+  TableCView() = default;
+  TableCView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  TableAView a() const;
+  ListView<TableC_io, TableBView, TableB> b() const;
+  ListView<TableC_io, TableBView, std::unique_ptr<TableB>> c() const;
+
+private:
+  friend struct TableC_io;
+
+  TableC_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[5]{};
+  mutable std::size_t known_{0};
+};
+
+inline TableC_io::InputBuffer TableAView::SeekMember(std::size_t member) const {
+  TableC_io io;
+  TableC_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const std::string *>(nullptr)); break;
+    case 1: io.Skip(i, static_cast<const std::unique_ptr<TableD> *>(nullptr)); break;
+    case 2: io.Skip(i, static_cast<const std::weak_ptr<TableD> *>(nullptr)); break;
+    case 3: io.Skip(i, static_cast<const std::shared_ptr<TableD> *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline StringView TableAView::name() const {
+  TableC_io io;
+  auto i = SeekMember(0);
+  return io.MakeView(i, static_cast<const std::string *>(nullptr));
+}
+
+inline TableDView TableAView::d1() const {
+  TableC_io io;
+  auto i = SeekMember(1);
+  char ref = 0;
+  io.ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? TableDView(i.data + i.pos, i.size - i.pos) : TableDView();
+}
+
+inline TableAView TableC_io::MakeView(InputBuffer &i, const TableA *) {
+  return i.failed ? TableAView() : TableAView(i.data + i.pos, i.size - i.pos);
+}
+
+inline TableAView TableC_io::MakeView(InputBuffer &i, const std::unique_ptr<TableA> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const TableA *>(nullptr)) : TableAView();
+}
+
+inline TableC_io::InputBuffer TableBView::SeekMember(std::size_t) const {
+  return TableC_io::InputBuffer{data_, size_, 0, false, {}};
+}
+
+inline StringView TableBView::name() const {
+  TableC_io io;
+  auto i = SeekMember(0);
+  return io.MakeView(i, static_cast<const std::string *>(nullptr));
+}
+
+inline TableBView TableC_io::MakeView(InputBuffer &i, const TableB *) {
+  return i.failed ? TableBView() : TableBView(i.data + i.pos, i.size - i.pos);
+}
+
+inline TableBView TableC_io::MakeView(InputBuffer &i, const std::unique_ptr<TableB> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const TableB *>(nullptr)) : TableBView();
+}
+
+inline TableC_io::InputBuffer TableDView::SeekMember(std::size_t member) const {
+  TableC_io io;
+  TableC_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const std::string *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline StringView TableDView::name() const {
+  TableC_io io;
+  auto i = SeekMember(0);
+  return io.MakeView(i, static_cast<const std::string *>(nullptr));
+}
+
+inline TableDView TableC_io::MakeView(InputBuffer &i, const TableD *) {
+  return i.failed ? TableDView() : TableDView(i.data + i.pos, i.size - i.pos);
+}
+
+inline TableDView TableC_io::MakeView(InputBuffer &i, const std::unique_ptr<TableD> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const TableD *>(nullptr)) : TableDView();
+}
+
+inline TableC_io::InputBuffer TableCView::SeekMember(std::size_t member) const {
+  TableC_io io;
+  TableC_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const TableA *>(nullptr)); break;
+    case 1: i.pos = this->b().EndOffset(); i.failed = i.pos >= size_; break;
+    case 2: i.pos = this->c().EndOffset(); i.failed = i.pos >= size_; break;
+    case 3: io.Skip(i, static_cast<const std::vector<std::shared_ptr<TableB>> *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline TableAView TableCView::a() const {
+  auto i = SeekMember(0);
+  return i.failed ? TableAView() : TableAView(i.data + i.pos, i.size - i.pos);
+}
+
+inline ListView<TableC_io, TableBView, TableB> TableCView::b() const {
+  TableC_io io;
+  auto i = SeekMember(1);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, 1))
+    return ListView<TableC_io, TableBView, TableB>();
+  return ListView<TableC_io, TableBView, TableB>(data_, size_, i.pos, s);
+}
+
+inline ListView<TableC_io, TableBView, std::unique_ptr<TableB>> TableCView::c() const {
+  TableC_io io;
+  auto i = SeekMember(2);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, 1))
+    return ListView<TableC_io, TableBView, std::unique_ptr<TableB>>();
+  return ListView<TableC_io, TableBView, std::unique_ptr<TableB>>(data_, size_, i.pos, s);
+}
+
+inline TableCView TableC_io::MakeView(InputBuffer &i, const TableC *) {
+  return i.failed ? TableCView() : TableCView(i.data + i.pos, i.size - i.pos);
+}
+
+inline TableCView TableC_io::MakeView(InputBuffer &i, const std::unique_ptr<TableC> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const TableC *>(nullptr)) : TableCView();
+}
+
+inline bool TableC_io::ViewTableC(const char *data, std::size_t size, TableCView &v) {
+  InputBuffer i{data, size, 0, false, {}};
+  if (!ReadHeader(i))
+    return false;
+  v = TableCView(i.data + i.pos, i.size - i.pos);
+  return true;
+}
+
+struct TableCWriter {
+  explicit TableCWriter(std::ostream &o) : o_(o), out_{o, 0, {}} {
+    header_ = o_.tellp();
+    io_.WriteHeader(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_a(const TableA &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_b() {
+    if (next_ != 1 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_b(std::size_t size) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_b(const TableB &v) {
+    if (next_ != 1 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_b() {
+    if (next_ != 1 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_c() {
+    if (next_ != 2 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_c(std::size_t size) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_c(const std::unique_ptr<TableB> &v) {
+    if (next_ != 2 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_c() {
+    if (next_ != 2 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_d() {
+    if (next_ != 3 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_d(std::size_t size) {
+    if (next_ != 3 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_d(const std::shared_ptr<TableB> &v) {
+    if (next_ != 3 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_d() {
+    if (next_ != 3 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool begin_e() {
+    if (next_ != 4 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_e(std::size_t size) {
+    if (next_ != 4 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_e(const std::weak_ptr<TableB> &v) {
+    if (next_ != 4 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_e() {
+    if (next_ != 4 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    io_.PatchHeader(o_, header_, out_.references);
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 5;
+
+  std::ostream &o_;
+  TableC_io::OutputStream out_;
+  TableC_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+  std::streampos header_{-1};
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+struct TableCJournal {
+  TableCJournal(const std::string &path, TableC &root) : path_(path), root_(root) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    struct stat st;
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+      failed_ = true;
+      return;
+    }
+    // a crash while the marker was written leaves less than the marker and no records, that starts over
+    if (st.st_size < 7) {
+      failed_ = (st.st_size != 0 && ::ftruncate(fd_, 0) != 0) || !WriteAll(fd_, "JRNE0.0", 7) || !Sync(fd_);
+      size_ = end_ = 7;
+      return;
+    }
+    std::vector<char> data(static_cast<std::size_t>(st.st_size));
+    // a crash can leave an incomplete record behind, new records have to follow the last complete one
+    const auto end = ReadAll(fd_, data.data(), data.size(), 0) ? io_.JournalEnd(data.data(), data.size()) : 0;
+    failed_ = end == 0 || (end < data.size() && ::ftruncate(fd_, static_cast<off_t>(end)) != 0);
+    size_ = end_ = end;
+  }
+
+  ~TableCJournal() {
+    if (compactor_.joinable())
+      compactor_.join();
+    commit();
+    if (fd_ >= 0)
+      ::close(fd_);
+  }
+
+  TableCJournal(const TableCJournal &) = delete;
+  TableCJournal &operator=(const TableCJournal &) = delete;
+
+  void set_b(std::vector<TableB> v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(2, TableC_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.b = std::move(v);
+    root_.mark_b();
+  }
+
+  bool set_b(std::size_t index, TableB v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= root_.b.size())
+      return false;
+    auto o = record(2, TableC_io::JournalAssign);
+    io_.Write(o, index);
+    io_.Write(o, v);
+    seal(o);
+    root_.b[index] = std::move(v);
+    root_.mark_b(index, index + 1);
+    return true;
+  }
+
+  void push_b(TableB v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(2, TableC_io::JournalPush);
+    io_.Write(o, v);
+    seal(o);
+    root_.b.push_back(std::move(v));
+    root_.mark_b(root_.b.size() - 1, root_.b.size());
+  }
+
+  bool insert_b(std::size_t index, TableB v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index > root_.b.size())
+      return false;
+    auto o = record(2, TableC_io::JournalInsert);
+    io_.Write(o, index);
+    io_.Write(o, v);
+    seal(o);
+    root_.b.insert(root_.b.begin() + index, std::move(v));
+    root_.mark_b(index, root_.b.size());
+    return true;
+  }
+
+  bool erase_b(std::size_t first, std::size_t last) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (first > last || last > root_.b.size())
+      return false;
+    auto o = record(2, TableC_io::JournalErase);
+    io_.Write(o, first);
+    io_.Write(o, last);
+    seal(o);
+    root_.b.erase(root_.b.begin() + first, root_.b.begin() + last);
+    root_.mark_b(first, root_.b.size());
+    return true;
+  }
+
+  void set_c(std::vector<std::unique_ptr<TableB>> v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(3, TableC_io::JournalSet);
+    io_.Write(o, v);
+    seal(o);
+    root_.c = std::move(v);
+    root_.mark_c();
+  }
+
+  bool set_c(std::size_t index, std::unique_ptr<TableB> v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= root_.c.size())
+      return false;
+    auto o = record(3, TableC_io::JournalAssign);
+    io_.Write(o, index);
+    io_.Write(o, v);
+    seal(o);
+    root_.c[index] = std::move(v);
+    root_.mark_c(index, index + 1);
+    return true;
+  }
+
+  void push_c(std::unique_ptr<TableB> v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto o = record(3, TableC_io::JournalPush);
+    io_.Write(o, v);
+    seal(o);
+    root_.c.push_back(std::move(v));
+    root_.mark_c(root_.c.size() - 1, root_.c.size());
+  }
+
+  bool insert_c(std::size_t index, std::unique_ptr<TableB> v) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index > root_.c.size())
+      return false;
+    auto o = record(3, TableC_io::JournalInsert);
+    io_.Write(o, index);
+    io_.Write(o, v);
+    seal(o);
+    root_.c.insert(root_.c.begin() + index, std::move(v));
+    root_.mark_c(index, root_.c.size());
+    return true;
+  }
+
+  bool erase_c(std::size_t first, std::size_t last) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (first > last || last > root_.c.size())
+      return false;
+    auto o = record(3, TableC_io::JournalErase);
+    io_.Write(o, first);
+    io_.Write(o, last);
+    seal(o);
+    root_.c.erase(root_.c.begin() + first, root_.c.begin() + last);
+    root_.mark_c(first, root_.c.size());
+    return true;
+  }
+
+  // returns once every operation recorded so far is on disk, concurrent commits share one sync
+  bool commit() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto target = appended_;
+    while (!failed_ && durable_ < target) {
+      if (syncing_) {
+        synced_.wait(lock);
+        continue;
+      }
+      syncing_ = true;
+      flushing_.swap(pending_);
+      pending_.clear();
+      const auto records = appended_;
+      lock.unlock();
+      const auto ok = WriteAll(fd_, flushing_.data(), flushing_.size()) && Sync(fd_);
+      lock.lock();
+      syncing_ = false;
+      failed_ = failed_ || !ok;
+      size_ += flushing_.size();
+      durable_ = records;
+      synced_.notify_all();
+    }
+    return !failed_;
+  }
+
+  // saves the current state as snapshot in the background, afterwards the journal only keeps later operations
+  std::future<bool> compact(const std::string &snapshot) {
+    if (compactor_.joinable())
+      compactor_.join();
+    auto state = std::make_shared<std::vector<char>>();
+    std::uint64_t point = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      io_.WriteTableC(*state, root_);
+      point = end_;
+    }
+    auto done = std::make_shared<std::promise<bool>>();
+    compactor_ = std::thread([this, snapshot, state, point, done]() {
+      done->set_value(save(snapshot, *state, point));
+    });
+    return done->get_future();
+  }
+
+private:
+  static bool WriteAll(int fd, const char *d, std::size_t s) {
+    while (s != 0) {
+      const auto n = ::write(fd, d, s);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+    }
+    return true;
+  }
+
+  static bool ReadAll(int fd, char *d, std::size_t s, std::uint64_t offset) {
+    while (s != 0) {
+      const auto n = ::pread(fd, d, s, static_cast<off_t>(offset));
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      d += n;
+      s -= static_cast<std::size_t>(n);
+      offset += static_cast<std::uint64_t>(n);
+    }
+    return true;
+  }
+
+  static bool Sync(int fd) {
+#if defined(__APPLE__)
+    return ::fsync(fd) == 0;
+#else
+    return ::fdatasync(fd) == 0;
+#endif
+  }
+
+  TableC_io::OutputBuffer record(std::uint32_t member, std::uint32_t operation) {
+    start_ = pending_.size();
+    pending_.resize(start_ + TableC_io::JournalFrameSize());
+    TableC_io::OutputBuffer o{pending_, pending_.size(), {}};
+    io_.Write(o, member);
+    io_.Write(o, operation);
+    return o;
+  }
+
+  void seal(TableC_io::OutputBuffer &o) {
+    pending_.resize(o.size);
+    io_.WriteJournalFrame(pending_, start_);
+    end_ += pending_.size() - start_;
+    ++appended_;
+  }
+
+  // point is the end of the journal at the time the state was taken
+  bool save(const std::string &path, const std::vector<char> &state, std::uint64_t point) {
+    const auto temporary = path + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return false;
+    const auto written = WriteAll(fd, state.data(), state.size()) && Sync(fd);
+    if (::close(fd) != 0 || !written) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    // the checkpoint follows the synced snapshot and has to be on disk before the snapshot replaces the old one
+    const auto hash = io_.HashBytes(0xcbf29ce484222325u, state.data(), state.size());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto o = record(0, TableC_io::JournalSet);
+      io_.Write(o, hash);
+      io_.Write(o, end_ - point);
+      seal(o);
+    }
+    if (!commit() || ::rename(temporary.c_str(), path.c_str()) != 0 || !io_.SyncDirectory(path)) {
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    synced_.wait(lock, [this]() { return !syncing_; });
+    return !failed_ && rotate(point, hash);
+  }
+
+  // replaces the journal by one that starts with a checkpoint of the snapshot and keeps the records from point on
+  bool rotate(std::uint64_t point, std::uint64_t hash) {
+    std::vector<char> kept("JRNE0.0", "JRNE0.0" + 7);
+    kept.resize(kept.size() + TableC_io::JournalFrameSize());
+    TableC_io::OutputBuffer o{kept, kept.size(), {}};
+    io_.Write(o, std::uint32_t(0));
+    io_.Write(o, std::uint32_t(TableC_io::JournalSet));
+    io_.Write(o, hash);
+    io_.Write(o, std::uint64_t(0));
+    kept.resize(o.size);
+    io_.WriteJournalFrame(kept, 7);
+    const auto head = kept.size();
+    kept.resize(head + static_cast<std::size_t>(size_ - point));
+    if (!ReadAll(fd_, kept.data() + head, kept.size() - head, point))
+      return false;
+    const auto temporary = path_ + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0)
+      return false;
+    if (!WriteAll(fd, kept.data(), kept.size()) || !Sync(fd) || ::rename(temporary.c_str(), path_.c_str()) != 0) {
+      ::close(fd);
+      ::unlink(temporary.c_str());
+      return false;
+    }
+    ::close(fd_);
+    fd_ = fd;
+    end_ -= size_ - kept.size();
+    size_ = kept.size();
+    return io_.SyncDirectory(path_);
+  }
+
+  std::string path_;
+  TableC &root_;
+  TableC_io io_;
+  int fd_{-1};
+  std::mutex mutex_;
+  std::condition_variable synced_;
+  std::vector<char> pending_;
+  std::vector<char> flushing_;
+  std::size_t start_{0};
+  std::uint64_t appended_{0};
+  std::uint64_t durable_{0};
+  std::uint64_t size_{0};
+  std::uint64_t end_{0};
+  bool syncing_{false};
+  bool failed_{false};
+  std::thread compactor_;
+};
+#endif
+}
@@ -0,0 +1,96 @@
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "benchmark.h"
+#include "tabletypes.h"
+
+#include <sstream>
+
+using namespace Scope;
+
+namespace {
+
+TableC testTableC(std::size_t entries)
+{
+  TableC c;
+  c.a.name = "TableA";
+  c.a.d1.reset(new TableD());
+  for (std::size_t i = 0; i < entries; ++i)
+  {
+    const auto name = "TableB_" + std::to_string(i);
+    c.b.emplace_back(name);
+    c.c.emplace_back(new TableB(name));
+  }
+  return c;
+}
+
+}  // namespace
+
+TEST_CASE("TableTypes io benchmark", "[benchmark]")
+{
+  const auto c = testTableC(50000);
+
+  std::vector<char> reference;
+  TableC_io().WriteTableC(reference, c);
+
+  SECTION("write")
+  {
+    benchmark("tabletypes: WriteTableC(std::ostream)", reference.size(), [&c]() {
+      std::ostringstream s;
+      TableC_io().WriteTableC(s, c);
+    });
+    benchmark("tabletypes: WriteTableC(std::vector<char>)", reference.size(), [&c]() {
+      std::vector<char> b;
+      TableC_io().WriteTableC(b, c);
+    });
+  }
+
+  SECTION("read")
+  {
+    const std::string data(reference.begin(), reference.end());
+    benchmark("tabletypes: ReadTableC(std::istream)", reference.size(), [&data]() {
+      std::istringstream s(data);
+      TableC v;
+      TableC_io().ReadTableC(s, v);
+    });
+    benchmark("tabletypes: ReadTableC(const char *, std::size_t)", reference.size(), [&reference]() {
+      TableC v;
+      TableC_io().ReadTableC(reference.data(), reference.size(), v);
+    });
+  }
+
+  SECTION("shared")
+  {
+    TableC shared;
+    for (std::size_t i = 0; i < 200000; ++i)
+    {
+      shared.d.emplace_back(new TableB("TableB_" + std::to_string(i)));
+      shared.e.emplace_back(shared.d.back());
+    }
+    std::vector<char> data;
+    TableC_io().WriteTableC(data, shared);
+
+    benchmark("tabletypes: ReadTableC with shared references", data.size(), [&data]() {
+      TableC v;
+      TableC_io().ReadTableC(data.data(), data.size(), v);
+    });
+  }
+
+  SECTION("compressed")
+  {
+    std::stringstream compressed;
+    TableC_io().WriteTableCCompressed(compressed, c);
+    const auto data = compressed.str();
+    std::cout << "tabletypes: compression ratio " << double(reference.size()) / data.size() << std::endl;
+
+    benchmark("tabletypes: WriteTableCCompressed", reference.size(), [&c]() {
+      std::ostringstream s;
+      TableC_io().WriteTableCCompressed(s, c);
+    });
+    benchmark("tabletypes: ReadTableCCompressed", reference.size(), [&data]() {
+      std::istringstream s(data);
+      TableC v;
+      TableC_io().ReadTableCCompressed(s, v);
+    });
+  }
+}
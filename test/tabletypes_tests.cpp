@@ -1,960 +1,1664 @@
-#define CATCH_CONFIG_FAST_COMPILE
-#include "catch2/catch.hpp"
-
-#include "tabletypes.h"
-
-#include <sstream>
-
-using namespace Scope;
-
-TEST_CASE("TableType test", "[output, table]")
-{
-  SECTION("Compare operator")
-  {
-    CHECK(TableA() == TableA());
-    CHECK_FALSE(TableA() != TableA());
-
-    CHECK(TableB() == TableB());
-    CHECK_FALSE(TableB() != TableB());
-
-    CHECK(TableC() == TableC());
-    CHECK_FALSE(TableC() != TableC());
-  }
-
-  SECTION("reading whats written")
-  {
-    TableC c;
-    c.b.emplace_back();
-    c.b.back().name = "TableB1";
-    c.b.emplace_back();
-    c.b.back().name = "TableB2";
-
-    TableC cIn;
-    CHECK_FALSE(c == cIn);
-
-    std::stringstream sOut;
-    TableC_io().WriteTableC(sOut, c);
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-
-    TableC_io().ReadTableC(sIn, cIn);
-
-    CHECK(c == cIn);
-  }
-
-  SECTION("reading whats written with shared data")
-  {
-    std::stringstream sOut;
-    {
-      TableC c;
-      c.a.name = "TableA";
-      c.a.d1.reset(new TableD());
-      c.a.d1->name = "TableD_1";
-      c.a.d3 = std::make_shared<TableD>();
-      c.a.d3->name = "TableD_3";
-      c.a.d2 = c.a.d3;
-      c.a.d4 = c.a.d3;
-
-      TableC_io().WriteTableC(sOut, c);
-    }
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-
-    TableC cIn;
-    TableC_io().ReadTableC(sIn, cIn);
-
-    CHECK(cIn.a.name == "TableA");
-
-    REQUIRE(cIn.a.d1);
-    REQUIRE(cIn.a.d2.lock());
-    REQUIRE(cIn.a.d3);
-    REQUIRE(cIn.a.d4);
-
-    CHECK(cIn.a.d1->name == "TableD_1");
-    CHECK(cIn.a.d2.lock()->name == "TableD_3");
-    CHECK(cIn.a.d3->name == "TableD_3");
-    CHECK(cIn.a.d4->name == "TableD_3");
-
-    CHECK(cIn.a.d2.lock() == cIn.a.d3);
-    CHECK(cIn.a.d4 == cIn.a.d3);
-  }
-
-  SECTION("reading whats written with shared data and cross releation ship")
-  {
-    std::stringstream sOut;
-
-    {
-      TableC c;
-      c.a.name = "TableA";
-      c.a.d3 = std::make_shared<TableD>();
-      c.a.d3->name = "TableD_3";
-      c.a.d3->a = std::make_shared<TableA>();
-      c.a.d3->a->d2 = c.a.d3;
-      c.a.d3->a->d3 = c.a.d3;
-      c.a.d3->a->d4 = c.a.d3;
-
-      TableC_io().WriteTableC(sOut, c);
-    }
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-
-    TableC cIn;
-    TableC_io().ReadTableC(sIn, cIn);
-
-    CHECK(cIn.a.name == "TableA");
-
-    REQUIRE(cIn.a.d3);
-    CHECK(cIn.a.d3->name == "TableD_3");
-
-    REQUIRE(cIn.a.d3->a);
-    REQUIRE(cIn.a.d3->a->d2.lock());
-    REQUIRE(cIn.a.d3->a->d3);
-    REQUIRE(cIn.a.d3->a->d4);
-    CHECK(cIn.a.d3->a->d2.lock() == cIn.a.d3);
-    CHECK(cIn.a.d3->a->d3 == cIn.a.d3);
-    CHECK(cIn.a.d3->a->d4 == cIn.a.d3);
-  }
-
-  SECTION("reading whats written with shared data in vectors")
-  {
-    std::stringstream sOut;
-    {
-      TableC c;
-      c.c.emplace_back(new TableB);
-      c.c.back()->name = "TableB_c";
-      c.d.emplace_back(new TableB);
-      c.d.back()->name = "TableB_d";
-      c.d.push_back(c.d.front());
-      c.e.push_back(c.d.front());
-      c.e.push_back(c.d.front());
-      TableC_io().WriteTableC(sOut, c);
-    }
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-
-    TableC cIn;
-    TableC_io().ReadTableC(sIn, cIn);
-
-    REQUIRE(cIn.c.size() == 1);
-    REQUIRE(cIn.d.size() == 2);
-    REQUIRE(cIn.e.size() == 2);
-
-    REQUIRE(cIn.c.front());
-    REQUIRE(cIn.d[0]);
-    REQUIRE(cIn.d[1]);
-    REQUIRE(cIn.e[0].lock());
-    REQUIRE(cIn.e[1].lock());
-
-    CHECK(cIn.c.back()->name == "TableB_c");
-    CHECK(cIn.d.back()->name == "TableB_d");
-    CHECK(cIn.d[0] == cIn.d[1]);
-    CHECK(cIn.e[1].lock() == cIn.d[1]);
-    CHECK(cIn.e[1].lock() == cIn.d[1]);
-  }
-
-  SECTION("Compare operations")
-  {
-    TableD d1;
-    TableD d2;
-    CHECK(d1 == d2);
-    CHECK_FALSE(d1 != d2);
-
-    d1.name = "xxx";
-    d2.name = "yyy";
-
-    CHECK_FALSE(d1 == d2);
-    CHECK(d1 != d2);
-  }
-
-  SECTION("Reading fails with wrong data")
-  {
-    TableC c;
-
-    std::stringstream s1("FALSE");
-    CHECK_FALSE(TableC_io().ReadTableC(s1, c));
-
-    std::stringstream s2("COREfails");
-    CHECK_FALSE(TableC_io().ReadTableC(s2, c));
-  }
-
-  SECTION("initializing methods with pointer")
-  {
-    auto d = std::make_shared<TableD>();
-
-    auto _inited = TableA(d);
-
-    CHECK(nullptr == _inited.d1);
-    CHECK(nullptr == _inited.d2.lock());
-    CHECK(d == _inited.d3);
-    CHECK(nullptr == _inited.d4);
-
-    _inited = TableA(d, std::unique_ptr<TableD>(new TableD));
-
-    CHECK(nullptr != _inited.d1);
-    CHECK(d == _inited.d2.lock());
-    CHECK(nullptr == _inited.d3);
-    CHECK(nullptr == _inited.d4);
-  }
-
-  SECTION("initializing methods vector of unique pointer")
-  {
-    std::vector<std::unique_ptr<TableB>> list;
-    list.emplace_back(new TableB);
-    list.emplace_back(new TableB);
-
-    TableC _inited(std::move(list));
-
-    CHECK(_inited.c.size() == 2);
-  }
-
-  SECTION("vector algorithm table")
-  {
-    TableC p;
-    p.b.emplace_back("x");
-    p.b.emplace_back("xx");
-    p.b.emplace_back("xxx");
-    REQUIRE(p.b.size() == 3);
-
-    SECTION("generate")
-    {
-      std::string x("x");
-      p.generate_b([&x]() { return TableB(x += "x"); });
-      CHECK(p.b[0] == TableB("xx"));
-      CHECK(p.b[1] == TableB("xxx"));
-      CHECK(p.b[2] == TableB("xxxx"));
-    }
-
-    SECTION("fill")
-    {
-      p.fill_b(TableB("42"));
-
-      CHECK(p.b[0] == TableB("42"));
-      CHECK(p.b[1] == TableB("42"));
-      CHECK(p.b[2] == TableB("42"));
-    }
-
-    SECTION("remove")
-    {
-      auto e = p.remove_b(TableB("xx"));
-
-      CHECK(e == p.b.end() - 1);
-      CHECK(3 == p.b.size());
-      CHECK(p.b[0] == TableB("x"));
-      CHECK(p.b[1] == TableB("xxx"));
-    }
-
-    SECTION("remove_if")
-    {
-      auto e = p.remove_b_if([](const TableB &b) { return b == TableB("xx"); });
-
-      CHECK(e == p.b.end() - 1);
-      CHECK(3 == p.b.size());
-      CHECK(p.b[0] == TableB("x"));
-      CHECK(p.b[1] == TableB("xxx"));
-    }
-
-    SECTION("erase")
-    {
-      p.erase_b(TableB("xx"));
-
-      CHECK(2 == p.b.size());
-      CHECK(p.b[0] == TableB("x"));
-      CHECK(p.b[1] == TableB("xxx"));
-    }
-
-    SECTION("erase_if")
-    {
-      p.erase_b_if([](const TableB &b) { return b == TableB("xx"); });
-
-      CHECK(2 == p.b.size());
-      CHECK(p.b[0] == TableB("x"));
-      CHECK(p.b[1] == TableB("xxx"));
-    }
-
-    SECTION("reverse")
-    {
-      p.reverse_b();
-
-      REQUIRE(3 == p.b.size());
-      CHECK(p.b[0] == TableB("xxx"));
-      CHECK(p.b[1] == TableB("xx"));
-      CHECK(p.b[2] == TableB("x"));
-    }
-
-    SECTION("rotate")
-    {
-      p.rotate_b(p.b.begin() + 1);
-
-      REQUIRE(3 == p.b.size());
-      CHECK(p.b[0] == TableB("xx"));
-      CHECK(p.b[1] == TableB("xxx"));
-      CHECK(p.b[2] == TableB("x"));
-    }
-
-    SECTION("sort with comparator")
-    {
-      p.b[0] = TableB("32");
-      p.b[1] = TableB("124");
-      p.b[2] = TableB("42");
-      p.sort_b([](const TableB &l, const TableB &r) { return l.name > r.name; });
-
-      REQUIRE(3 == p.b.size());
-      CHECK(p.b[0] == TableB("42"));
-      CHECK(p.b[1] == TableB("32"));
-      CHECK(p.b[2] == TableB("124"));
-    }
-
-    SECTION("any of")
-    {
-      CHECK(p.any_of_b([](const TableB &x) { return x.name == "xx"; }));
-      CHECK_FALSE(p.any_of_b([](const TableB &x) { return x.name == "42"; }));
-    }
-
-    SECTION("all of")
-    {
-      CHECK(p.all_of_b([](const TableB &x) { return !x.name.empty() && x.name[0] == 'x'; }));
-      CHECK_FALSE(p.all_of_b([](const TableB &x) { return x.name.size() == 2; }));
-    }
-
-    SECTION("none of")
-    {
-      CHECK_FALSE(p.none_of_b([](const TableB &x) { return !x.name.empty() && x.name[0] == 'x'; }));
-      CHECK_FALSE(p.none_of_b([](const TableB &x) { return x.name.size() == 2; }));
-      CHECK(p.none_of_b([](const TableB &x) { return x.name.size() > 3; }));
-    }
-
-    SECTION("any of is")
-    {
-      CHECK(p.any_of_b_is(TableB("xx")));
-      CHECK_FALSE(p.any_of_b_is(TableB("42")));
-    }
-
-    SECTION("all of are")
-    {
-      CHECK_FALSE(p.all_of_b_are(TableB("42")));
-      p.fill_b(TableB("42"));
-      CHECK(p.b.size() == 3);
-      CHECK(p.all_of_b_are(TableB("42")));
-    }
-
-    SECTION("none of value")
-    {
-      CHECK_FALSE(p.none_of_b_is(TableB("x")));
-      CHECK(p.none_of_b_is(TableB("42")));
-    }
-
-    SECTION("for each")
-    {
-      std::string x;
-      p.for_each_b([&x](const TableB &i) { x += i.name; });
-      CHECK(x == std::string("x") + "xx" + "xxx");
-    }
-
-    SECTION("find")
-    {
-      CHECK(p.find_in_b(TableB("xx").name) == p.b.begin() + 1);
-      CHECK(p.find_in_b(TableB("42").name) == p.b.end());
-    }
-
-    SECTION("find if")
-    {
-      CHECK(p.find_in_b_if([](const TableB &x) { return x.name == "xx"; }) == p.b.begin() + 1);
-      CHECK(p.find_in_b_if([](const TableB &x) { return x.name == "42"; }) == p.b.end());
-    }
-
-    SECTION("count")
-    {
-      CHECK(p.count_in_b(TableB("xx")) == 1);
-      CHECK(p.count_in_b(TableB("42")) == 0);
-    }
-
-    SECTION("count if")
-    {
-      CHECK(p.count_in_b_if([](const TableB &x) { return x.name.size() % 2 == 1; }) == 2);
-      CHECK(p.count_in_b_if([](const TableB &x) { return x.name.size() > 42; }) == 0);
-    }
-  }
-
-  SECTION("vector algorithm unique table")
-  {
-    TableC p;
-    p.c.emplace_back(new TableB("x"));
-    p.c.emplace_back(new TableB("xx"));
-    p.c.emplace_back(new TableB("xxx"));
-    REQUIRE(p.c.size() == 3);
-
-    SECTION("generate")
-    {
-      std::string x("x");
-      p.generate_c([&x]() { return std::unique_ptr<TableB>(new TableB(x += "x")); });
-      CHECK(p.c[0]->name == "xx");
-      CHECK(p.c[1]->name == "xxx");
-      CHECK(p.c[2]->name == "xxxx");
-    }
-
-    SECTION("remove")
-    {
-      auto e = p.remove_c(p.c[1]);
-
-      CHECK(e == p.c.end() - 1);
-      CHECK(3 == p.c.size());
-      CHECK(p.c[0]->name == "x");
-      CHECK(p.c[1]->name == "xxx");
-    }
-
-    SECTION("remove_if")
-    {
-      auto e = p.remove_c_if([](const std::unique_ptr<TableB> &b) { return *b == TableB("xx"); });
-
-      CHECK(e == p.c.end() - 1);
-      CHECK(3 == p.c.size());
-      CHECK(p.c[0]->name == "x");
-      CHECK(p.c[1]->name == "xxx");
-    }
-
-    SECTION("erase")
-    {
-      p.erase_c(p.c[1]);
-
-      CHECK(2 == p.c.size());
-      CHECK(p.c[0]->name == "x");
-      CHECK(p.c[1]->name == "xxx");
-    }
-
-    SECTION("erase_if")
-    {
-      p.erase_c_if([](const std::unique_ptr<TableB> &b) { return *b == TableB("xx"); });
-
-      CHECK(2 == p.c.size());
-      CHECK(p.c[0]->name == "x");
-      CHECK(p.c[1]->name == "xxx");
-    }
-
-    SECTION("reverse")
-    {
-      p.reverse_c();
-
-      REQUIRE(3 == p.c.size());
-      CHECK(p.c[0]->name == "xxx");
-      CHECK(p.c[1]->name == "xx");
-      CHECK(p.c[2]->name == "x");
-    }
-
-    SECTION("rotate")
-    {
-      p.rotate_c(p.c.begin() + 1);
-
-      REQUIRE(3 == p.c.size());
-      CHECK(p.c[0]->name == "xx");
-      CHECK(p.c[1]->name == "xxx");
-      CHECK(p.c[2]->name == "x");
-    }
-
-    SECTION("sort with comparator")
-    {
-      p.c[0] = std::unique_ptr<TableB>(new TableB("32"));
-      p.c[1] = std::unique_ptr<TableB>(new TableB("124"));
-      p.c[2] = std::unique_ptr<TableB>(new TableB("42"));
-      p.sort_c([](const std::unique_ptr<TableB> &l, const std::unique_ptr<TableB> &r) { return l->name > r->name; });
-
-      REQUIRE(3 == p.c.size());
-      CHECK(p.c[0]->name == "42");
-      CHECK(p.c[1]->name == "32");
-      CHECK(p.c[2]->name == "124");
-    }
-
-    SECTION("any of")
-    {
-      CHECK(p.any_of_c([](const std::unique_ptr<TableB> &x) { return x->name == "xx"; }));
-      CHECK_FALSE(p.any_of_c([](const std::unique_ptr<TableB> &x) { return x->name == "42"; }));
-    }
-
-    SECTION("all of")
-    {
-      CHECK(p.all_of_c([](const std::unique_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
-      CHECK_FALSE(p.all_of_c([](const std::unique_ptr<TableB> &x) { return x->name.size() == 2; }));
-    }
-
-    SECTION("none of")
-    {
-      CHECK_FALSE(p.none_of_c([](const std::unique_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
-      CHECK_FALSE(p.none_of_c([](const std::unique_ptr<TableB> &x) { return x->name.size() == 2; }));
-      CHECK(p.none_of_c([](const std::unique_ptr<TableB> &x) { return x->name.size() > 3; }));
-    }
-
-    SECTION("any of is")
-    {
-      p.c.push_back(nullptr);
-      CHECK(p.any_of_c_is(TableB("xx")));
-      CHECK_FALSE(p.any_of_c_is(TableB("42")));
-    }
-
-    SECTION("all of are")
-    {
-      p.c.push_back(nullptr);
-      CHECK_FALSE(p.all_of_c_are(TableB("42")));
-      for (auto &c : p.c)
-        if (c)
-          c->name = "42";
-      CHECK_FALSE(p.all_of_c_are(TableB("42")));
-      p.c.pop_back();
-      CHECK(p.all_of_c_are(TableB("42")));
-    }
-
-    SECTION("none of value")
-    {
-      p.c.push_back(nullptr);
-      CHECK_FALSE(p.none_of_c_is(TableB("x")));
-      CHECK(p.none_of_c_is(TableB("42")));
-    }
-
-    SECTION("for each")
-    {
-      std::string x;
-      p.for_each_c([&x](const std::unique_ptr<TableB> &i) { x += i->name; });
-      CHECK(x == std::string("x") + "xx" + "xxx");
-    }
-
-    SECTION("find")
-    {
-      CHECK(p.find_in_c(p.c[1]) == p.c.begin() + 1);
-      CHECK(p.find_in_c(nullptr) == p.c.end());
-    }
-
-    SECTION("find if")
-    {
-      CHECK(p.find_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name == "xx"; }) == p.c.begin() + 1);
-      CHECK(p.find_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name == "42"; }) == p.c.end());
-    }
-
-    SECTION("count")
-    {
-      CHECK(p.count_in_c(p.c[1]) == 1);
-      CHECK(p.count_in_c(nullptr) == 0);
-    }
-
-    SECTION("count if")
-    {
-      CHECK(p.count_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name.size() % 2 == 1; }) == 2);
-      CHECK(p.count_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name.size() > 42; }) == 0);
-    }
-  }
-
-  SECTION("vector algorithm shared table")
-  {
-    TableC p;
-    p.d.emplace_back(new TableB("x"));
-    p.d.emplace_back(new TableB("xx"));
-    p.d.emplace_back(new TableB("xxx"));
-    REQUIRE(p.d.size() == 3);
-
-    SECTION("fill")
-    {
-      p.fill_d(std::make_shared<TableB>("42"));
-
-      CHECK(p.d[0] == p.d[1]);
-      CHECK(p.d[0] == p.d[2]);
-      CHECK(*p.d[2] == TableB("42"));
-    }
-
-    SECTION("generate")
-    {
-      std::string x("x");
-      p.generate_d([&x]() { return std::make_shared<TableB>(x += "x"); });
-      CHECK(p.d[0]->name == "xx");
-      CHECK(p.d[1]->name == "xxx");
-      CHECK(p.d[2]->name == "xxxx");
-    }
-
-    SECTION("remove")
-    {
-      auto e = p.remove_d(p.d[1]);
-
-      CHECK(e == p.d.end() - 1);
-      CHECK(3 == p.d.size());
-      CHECK(p.d[0]->name == "x");
-      CHECK(p.d[1]->name == "xxx");
-    }
-
-    SECTION("remove_if")
-    {
-      auto e = p.remove_d_if([](const std::shared_ptr<TableB> &b) { return *b == TableB("xx"); });
-
-      CHECK(e == p.d.end() - 1);
-      CHECK(3 == p.d.size());
-      CHECK(p.d[0]->name == "x");
-      CHECK(p.d[1]->name == "xxx");
-    }
-
-    SECTION("erase")
-    {
-      p.erase_d(p.d[1]);
-
-      CHECK(2 == p.d.size());
-      CHECK(p.d[0]->name == "x");
-      CHECK(p.d[1]->name == "xxx");
-    }
-
-    SECTION("erase_if")
-    {
-      p.erase_d_if([](const std::shared_ptr<TableB> &b) { return *b == TableB("xx"); });
-
-      CHECK(2 == p.d.size());
-      CHECK(p.d[0]->name == "x");
-      CHECK(p.d[1]->name == "xxx");
-    }
-
-    SECTION("reverse")
-    {
-      p.reverse_d();
-
-      REQUIRE(3 == p.d.size());
-      CHECK(p.d[0]->name == "xxx");
-      CHECK(p.d[1]->name == "xx");
-      CHECK(p.d[2]->name == "x");
-    }
-
-    SECTION("rotate")
-    {
-      p.rotate_d(p.d.begin() + 1);
-
-      REQUIRE(3 == p.d.size());
-      CHECK(p.d[0]->name == "xx");
-      CHECK(p.d[1]->name == "xxx");
-      CHECK(p.d[2]->name == "x");
-    }
-
-    SECTION("sort with comparator")
-    {
-      p.d[0] = std::shared_ptr<TableB>(new TableB("32"));
-      p.d[1] = std::shared_ptr<TableB>(new TableB("124"));
-      p.d[2] = std::shared_ptr<TableB>(new TableB("42"));
-      p.sort_d([](const std::shared_ptr<TableB> &l, const std::shared_ptr<TableB> &r) { return l->name > r->name; });
-
-      REQUIRE(3 == p.d.size());
-      CHECK(p.d[0]->name == "42");
-      CHECK(p.d[1]->name == "32");
-      CHECK(p.d[2]->name == "124");
-    }
-
-    SECTION("any of")
-    {
-      CHECK(p.any_of_d([](const std::shared_ptr<TableB> &x) { return x->name == "xx"; }));
-      CHECK_FALSE(p.any_of_d([](const std::shared_ptr<TableB> &x) { return x->name == "42"; }));
-    }
-
-    SECTION("all of")
-    {
-      CHECK(p.all_of_d([](const std::shared_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
-      CHECK_FALSE(p.all_of_d([](const std::shared_ptr<TableB> &x) { return x->name.size() == 2; }));
-    }
-
-    SECTION("none of")
-    {
-      CHECK_FALSE(p.none_of_d([](const std::shared_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
-      CHECK_FALSE(p.none_of_d([](const std::shared_ptr<TableB> &x) { return x->name.size() == 2; }));
-      CHECK(p.none_of_d([](const std::shared_ptr<TableB> &x) { return x->name.size() > 3; }));
-    }
-
-    SECTION("any of is")
-    {
-      p.d.push_back(nullptr);
-      CHECK(p.any_of_d_is(TableB("xx")));
-      CHECK_FALSE(p.any_of_d_is(TableB("42")));
-    }
-
-    SECTION("any of is pointer")
-    {
-      p.d.push_back(nullptr);
-      CHECK(p.any_of_d_is(p.d[1]));
-      CHECK_FALSE(p.any_of_d_is(std::make_shared<TableB>("42")));
-    }
-
-    SECTION("all of are")
-    {
-      p.d.push_back(nullptr);
-      CHECK_FALSE(p.all_of_d_are(TableB("42")));
-      for (auto &c : p.d)
-        if (c)
-          c->name = "42";
-      CHECK_FALSE(p.all_of_d_are(TableB("42")));
-      p.d.pop_back();
-      CHECK(p.all_of_d_are(TableB("42")));
-    }
-
-    SECTION("all of are pointer")
-    {
-      p.d.push_back(nullptr);
-      CHECK_FALSE(p.all_of_d_are(p.d[1]));
-      CHECK_FALSE(p.all_of_d_are(std::make_shared<TableB>("42")));
-      p.d = {p.d[2], p.d[2], p.d[2]};
-      CHECK(p.all_of_d_are(p.d[2]));
-    }
-
-    SECTION("none of value")
-    {
-      p.d.push_back(nullptr);
-      CHECK_FALSE(p.none_of_d_is(TableB("x")));
-      CHECK(p.none_of_d_is(TableB("42")));
-    }
-
-    SECTION("none of value pointer")
-    {
-      p.d.push_back(nullptr);
-      CHECK_FALSE(p.none_of_d_is(p.d[1]));
-      CHECK(p.none_of_d_is(std::make_shared<TableB>("42")));
-    }
-
-    SECTION("for each")
-    {
-      std::string x;
-      p.for_each_d([&x](const std::shared_ptr<TableB> &i) { x += i->name; });
-      CHECK(x == std::string("x") + "xx" + "xxx");
-    }
-
-    SECTION("find")
-    {
-      CHECK(p.find_in_d(p.d[1]) == p.d.begin() + 1);
-      CHECK(p.find_in_d(nullptr) == p.d.end());
-    }
-
-    SECTION("find if")
-    {
-      CHECK(p.find_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name == "xx"; }) == p.d.begin() + 1);
-      CHECK(p.find_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name == "42"; }) == p.d.end());
-    }
-
-    SECTION("count")
-    {
-      CHECK(p.count_in_d(p.d[1]) == 1);
-      CHECK(p.count_in_d(nullptr) == 0);
-    }
-
-    SECTION("count if")
-    {
-      CHECK(p.count_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name.size() % 2 == 1; }) == 2);
-      CHECK(p.count_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name.size() > 42; }) == 0);
-    }
-  }
-
-  SECTION("vector algorithm weak table")
-  {
-    TableC p;
-    p.d.emplace_back(new TableB("x"));
-    p.d.emplace_back(new TableB("xx"));
-    p.d.emplace_back(new TableB("xxx"));
-    p.e.emplace_back(p.d[0]);
-    p.e.emplace_back(p.d[1]);
-    p.e.emplace_back(p.d[2]);
-    REQUIRE(p.e.size() == 3);
-
-    SECTION("fill")
-    {
-      const auto x = std::make_shared<TableB>("42");
-      p.fill_e(x);
-
-      CHECK(p.e[0].lock() == p.e[1].lock());
-      CHECK(p.e[0].lock() == p.e[2].lock());
-      CHECK(p.e[2].lock() == x);
-    }
-
-    SECTION("generate")
-    {
-      std::string x("x");
-      p.generate_e([&]() {
-        p.d.emplace_back(new TableB(x += "x"));
-        return p.d.back();
-      });
-      CHECK(p.e[0].lock()->name == "xx");
-      CHECK(p.e[1].lock()->name == "xxx");
-      CHECK(p.e[2].lock()->name == "xxxx");
-      CHECK(p.e[0].lock() == p.d[3]);
-      CHECK(p.e[1].lock() == p.d[4]);
-      CHECK(p.e[2].lock() == p.d[5]);
-    }
-
-    SECTION("remove")
-    {
-      auto e = p.remove_e(p.e[1]);
-
-      CHECK(e == p.e.end() - 1);
-      CHECK(3 == p.e.size());
-      CHECK(p.e[0].lock()->name == "x");
-      CHECK(p.e[1].lock()->name == "xxx");
-    }
-
-    SECTION("remove_if")
-    {
-      auto e = p.remove_e_if([](const std::weak_ptr<TableB> &b) { return b.lock() && *b.lock() == TableB("xx"); });
-
-      CHECK(e == p.e.end() - 1);
-      CHECK(3 == p.e.size());
-      CHECK(p.e[0].lock()->name == "x");
-      CHECK(p.e[1].lock()->name == "xxx");
-    }
-
-    SECTION("erase")
-    {
-      p.erase_e(p.e[1]);
-
-      CHECK(2 == p.e.size());
-      CHECK(p.e[0].lock()->name == "x");
-      CHECK(p.e[1].lock()->name == "xxx");
-    }
-
-    SECTION("erase_if")
-    {
-      p.erase_e_if([](const std::weak_ptr<TableB> &b) { return b.lock() && *b.lock() == TableB("xx"); });
-
-      CHECK(2 == p.e.size());
-      CHECK(p.e[0].lock()->name == "x");
-      CHECK(p.e[1].lock()->name == "xxx");
-    }
-
-    SECTION("reverse")
-    {
-      p.reverse_e();
-
-      REQUIRE(3 == p.e.size());
-      CHECK(p.e[0].lock()->name == "xxx");
-      CHECK(p.e[1].lock()->name == "xx");
-      CHECK(p.e[2].lock()->name == "x");
-    }
-
-    SECTION("rotate")
-    {
-      p.rotate_e(p.e.begin() + 1);
-
-      REQUIRE(3 == p.e.size());
-      CHECK(p.e[0].lock()->name == "xx");
-      CHECK(p.e[1].lock()->name == "xxx");
-      CHECK(p.e[2].lock()->name == "x");
-    }
-
-    SECTION("sort with comparator")
-    {
-      p.d[0]->name = "32";
-      p.d[1]->name = "124";
-      p.d[2]->name = "42";
-      p.sort_e([](const std::weak_ptr<TableB> &l, const std::weak_ptr<TableB> &r) {
-        return l.lock() && r.lock() && l.lock()->name > r.lock()->name;
-      });
-
-      REQUIRE(3 == p.e.size());
-      CHECK(p.e[0].lock()->name == "42");
-      CHECK(p.e[1].lock()->name == "32");
-      CHECK(p.e[2].lock()->name == "124");
-    }
-
-    SECTION("any of")
-    {
-      CHECK(p.any_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "xx"; }));
-      CHECK_FALSE(p.any_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "42"; }));
-    }
-
-    SECTION("all of")
-    {
-      CHECK(p.all_of_e(
-          [](const std::weak_ptr<TableB> &x) { return !x.lock()->name.empty() && x.lock()->name[0] == 'x'; }));
-      CHECK_FALSE(p.all_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() == 2; }));
-    }
-
-    SECTION("none of")
-    {
-      CHECK_FALSE(p.none_of_e(
-          [](const std::weak_ptr<TableB> &x) { return !x.lock()->name.empty() && x.lock()->name[0] == 'x'; }));
-      CHECK_FALSE(p.none_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() == 2; }));
-      CHECK(p.none_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() > 3; }));
-    }
-
-    SECTION("any of is")
-    {
-      p.e.push_back(std::make_shared<TableB>());
-      CHECK(p.e.back().lock() == nullptr);
-      CHECK(p.any_of_e_is(TableB("xx")));
-      CHECK_FALSE(p.any_of_e_is(TableB("42")));
-    }
-
-    SECTION("any of is pointer")
-    {
-      p.e.push_back(std::make_shared<TableB>());
-      CHECK(p.e.back().lock() == nullptr);
-      CHECK(p.any_of_e_is(p.e[1].lock()));
-      CHECK_FALSE(p.any_of_e_is(std::make_shared<TableB>("42")));
-    }
-
-    SECTION("all of are")
-    {
-      p.e.push_back(std::make_shared<TableB>());
-      CHECK(p.e.back().lock() == nullptr);
-      CHECK_FALSE(p.all_of_e_are(TableB("42")));
-      for (auto &c : p.e)
-        if (c.lock())
-          c.lock()->name = "42";
-      CHECK_FALSE(p.all_of_e_are(TableB("42")));
-      p.e.pop_back();
-      CHECK(p.all_of_e_are(TableB("42")));
-    }
-
-    SECTION("all of are pointer")
-    {
-      p.e.push_back(std::make_shared<TableB>());
-      CHECK(p.e.back().lock() == nullptr);
-      CHECK_FALSE(p.all_of_e_are(p.e[1].lock()));
-      CHECK_FALSE(p.all_of_e_are(std::make_shared<TableB>("42")));
-      p.e = {p.e[2], p.e[2], p.e[2]};
-      CHECK(p.all_of_e_are(p.e[2].lock()));
-    }
-
-    SECTION("none of value")
-    {
-      p.e.push_back(std::make_shared<TableB>());
-      CHECK(p.e.back().lock() == nullptr);
-      CHECK_FALSE(p.none_of_e_is(TableB("x")));
-      CHECK(p.none_of_e_is(TableB("42")));
-    }
-
-    SECTION("none of value pointer")
-    {
-      p.e.push_back(std::make_shared<TableB>());
-      CHECK(p.e.back().lock() == nullptr);
-      CHECK_FALSE(p.none_of_e_is(p.e[1].lock()));
-      CHECK(p.none_of_e_is(std::make_shared<TableB>("42")));
-    }
-
-    SECTION("for each")
-    {
-      std::string x;
-      p.for_each_e([&x](const std::weak_ptr<TableB> &i) { x += i.lock()->name; });
-      CHECK(x == std::string("x") + "xx" + "xxx");
-    }
-
-    SECTION("find")
-    {
-      CHECK(p.find_in_e(p.e[1]) == p.e.begin() + 1);
-      // CHECK(p.find_in_e(nullptr) == p.e.end());
-    }
-
-    SECTION("find if")
-    {
-      CHECK(p.find_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "xx"; }) == p.e.begin() + 1);
-      CHECK(p.find_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "42"; }) == p.e.end());
-    }
-
-    SECTION("count")
-    {
-      CHECK(p.count_in_e(p.e[1]) == 1);
-      // CHECK(p.count_in_e(p.d[1]) == 0);
-    }
-
-    SECTION("count if")
-    {
-      CHECK(p.count_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() % 2 == 1; }) == 2);
-      CHECK(p.count_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() > 42; }) == 0);
-    }
-  }
-}
+#define CATCH_CONFIG_FAST_COMPILE
+#include "catch2/catch.hpp"
+
+#include "fuzz.h"
+#include "tabletypes.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace Scope;
+
+TEST_CASE("TableType test", "[output, table]")
+{
+  SECTION("Compare operator")
+  {
+    CHECK(TableA() == TableA());
+    CHECK_FALSE(TableA() != TableA());
+
+    CHECK(TableB() == TableB());
+    CHECK_FALSE(TableB() != TableB());
+
+    CHECK(TableC() == TableC());
+    CHECK_FALSE(TableC() != TableC());
+  }
+
+  SECTION("reading whats written")
+  {
+    TableC c;
+    c.b.emplace_back();
+    c.b.back().name = "TableB1";
+    c.b.emplace_back();
+    c.b.back().name = "TableB2";
+
+    TableC cIn;
+    CHECK_FALSE(c == cIn);
+
+    std::stringstream sOut;
+    TableC_io().WriteTableC(sOut, c);
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+
+    TableC_io().ReadTableC(sIn, cIn);
+
+    CHECK(c == cIn);
+  }
+
+  SECTION("reading whats written with shared data")
+  {
+    std::stringstream sOut;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d1.reset(new TableD());
+      c.a.d1->name = "TableD_1";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d2 = c.a.d3;
+      c.a.d4 = c.a.d3;
+
+      TableC_io().WriteTableC(sOut, c);
+    }
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+
+    TableC cIn;
+    TableC_io().ReadTableC(sIn, cIn);
+
+    CHECK(cIn.a.name == "TableA");
+
+    REQUIRE(cIn.a.d1);
+    REQUIRE(cIn.a.d2.lock());
+    REQUIRE(cIn.a.d3);
+    REQUIRE(cIn.a.d4);
+
+    CHECK(cIn.a.d1->name == "TableD_1");
+    CHECK(cIn.a.d2.lock()->name == "TableD_3");
+    CHECK(cIn.a.d3->name == "TableD_3");
+    CHECK(cIn.a.d4->name == "TableD_3");
+
+    CHECK(cIn.a.d2.lock() == cIn.a.d3);
+    CHECK(cIn.a.d4 == cIn.a.d3);
+  }
+
+  SECTION("reading whats written with shared data and cross releation ship")
+  {
+    std::stringstream sOut;
+
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d3->a = std::make_shared<TableA>();
+      c.a.d3->a->d2 = c.a.d3;
+      c.a.d3->a->d3 = c.a.d3;
+      c.a.d3->a->d4 = c.a.d3;
+
+      TableC_io().WriteTableC(sOut, c);
+    }
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+
+    TableC cIn;
+    TableC_io().ReadTableC(sIn, cIn);
+
+    CHECK(cIn.a.name == "TableA");
+
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d3->name == "TableD_3");
+
+    REQUIRE(cIn.a.d3->a);
+    REQUIRE(cIn.a.d3->a->d2.lock());
+    REQUIRE(cIn.a.d3->a->d3);
+    REQUIRE(cIn.a.d3->a->d4);
+    CHECK(cIn.a.d3->a->d2.lock() == cIn.a.d3);
+    CHECK(cIn.a.d3->a->d3 == cIn.a.d3);
+    CHECK(cIn.a.d3->a->d4 == cIn.a.d3);
+  }
+
+  SECTION("reading whats written with shared data in vectors")
+  {
+    std::stringstream sOut;
+    {
+      TableC c;
+      c.c.emplace_back(new TableB);
+      c.c.back()->name = "TableB_c";
+      c.d.emplace_back(new TableB);
+      c.d.back()->name = "TableB_d";
+      c.d.push_back(c.d.front());
+      c.e.push_back(c.d.front());
+      c.e.push_back(c.d.front());
+      TableC_io().WriteTableC(sOut, c);
+    }
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+
+    TableC cIn;
+    TableC_io().ReadTableC(sIn, cIn);
+
+    REQUIRE(cIn.c.size() == 1);
+    REQUIRE(cIn.d.size() == 2);
+    REQUIRE(cIn.e.size() == 2);
+
+    REQUIRE(cIn.c.front());
+    REQUIRE(cIn.d[0]);
+    REQUIRE(cIn.d[1]);
+    REQUIRE(cIn.e[0].lock());
+    REQUIRE(cIn.e[1].lock());
+
+    CHECK(cIn.c.back()->name == "TableB_c");
+    CHECK(cIn.d.back()->name == "TableB_d");
+    CHECK(cIn.d[0] == cIn.d[1]);
+    CHECK(cIn.e[1].lock() == cIn.d[1]);
+    CHECK(cIn.e[1].lock() == cIn.d[1]);
+  }
+
+  SECTION("reading whats written into a buffer")
+  {
+    std::vector<char> buffer;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d4 = c.a.d3;
+      c.b.emplace_back("TableB");
+      c.c.emplace_back(new TableB("TableB_c"));
+
+      TableC_io().WriteTableC(buffer, c);
+    }
+
+    std::stringstream sIn(std::string(buffer.begin(), buffer.end()));
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(sIn, cIn));
+
+    CHECK(cIn.a.name == "TableA");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d3->name == "TableD_3");
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 1);
+    CHECK(cIn.b.front().name == "TableB");
+    REQUIRE(cIn.c.size() == 1);
+    CHECK(cIn.c.front()->name == "TableB_c");
+  }
+
+  SECTION("reading whats written from a span")
+  {
+    std::vector<char> buffer;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d4 = c.a.d3;
+      c.b.emplace_back("TableB");
+      c.c.emplace_back(new TableB("TableB_c"));
+
+      TableC_io().WriteTableC(buffer, c);
+    }
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(buffer.data(), buffer.size(), cIn));
+
+    CHECK(cIn.a.name == "TableA");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d3->name == "TableD_3");
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 1);
+    CHECK(cIn.b.front().name == "TableB");
+    REQUIRE(cIn.c.size() == 1);
+    CHECK(cIn.c.front()->name == "TableB_c");
+
+    TableC cShort;
+    CHECK_FALSE(TableC_io().ReadTableC(buffer.data(), buffer.size() - 1, cShort));
+  }
+
+  SECTION("serialized size with shared references")
+  {
+    TableC c;
+    c.a.d3 = std::make_shared<TableD>();
+    c.a.d3->name = "TableD_3";
+    c.a.d4 = c.a.d3;
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.d.push_back(c.d.back());
+    c.e.emplace_back(c.d.back());
+
+    const auto size = TableC_io().SerializedSize(c);
+
+    std::vector<char> buffer;
+    TableC_io().WriteTableC(buffer, c);
+    CHECK(size == buffer.size());
+  }
+
+  SECTION("writing shared data twice and from several threads")
+  {
+    TableC c;
+    c.a.d3 = std::make_shared<TableD>();
+    c.a.d3->name = "TableD_3";
+    c.a.d3->a = std::make_shared<TableA>("TableA_shared");
+    c.a.d4 = c.a.d3;
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.d.push_back(c.d.back());
+    c.e.emplace_back(c.d.back());
+    const TableC &constC = c;
+
+    // writing keeps its ids with the output, so one const _io object serves every thread
+    const TableC_io io;
+    std::vector<char> first;
+    io.WriteTableC(first, constC);
+    std::vector<char> second;
+    io.WriteTableC(second, constC);
+    CHECK(second == first);
+    CHECK(io.SerializedSize(constC) == first.size());
+
+    std::vector<std::vector<char>> buffers(4);
+    std::vector<std::thread> threads;
+    for (auto &b : buffers)
+      threads.emplace_back([&b, &io, &constC]() { io.WriteTableC(b, constC); });
+    for (auto &t : threads)
+      t.join();
+    for (const auto &b : buffers)
+      CHECK(b == first);
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(first.data(), first.size(), cIn));
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d3->a->name == "TableA_shared");
+    CHECK(cIn.a.d3.use_count() == 2);
+    CHECK(cIn.a.d3->a.use_count() == 1);
+    REQUIRE(cIn.d.size() == 2);
+    CHECK(cIn.d[0].use_count() == 2);
+  }
+
+  SECTION("shared object counts in the header")
+  {
+    TableC c;
+    c.a.d3 = std::make_shared<TableD>();
+    c.a.d3->a = std::make_shared<TableA>("TableA_shared");
+    c.a.d4 = c.a.d3;
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.d.emplace_back(new TableB("TableB_e"));
+    c.d.push_back(c.d.back());
+
+    std::vector<char> buffer;
+    TableC_io().WriteTableC(buffer, c);
+    std::uint32_t counts[3] = {};
+    std::memcpy(counts, buffer.data() + 8, sizeof(counts));
+    CHECK(counts[0] == 1);
+    CHECK(counts[1] == 2);
+    CHECK(counts[2] == 1);
+
+    std::stringstream sOut;
+    TableC_io().WriteTableC(sOut, c);
+    CHECK(sOut.str() == std::string(buffer.begin(), buffer.end()));
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(buffer.data(), buffer.size(), cIn));
+    CHECK(cIn.d[1] == cIn.d[2]);
+
+    auto broken = buffer;
+    const std::uint32_t huge = 0xffffffff;
+    std::memcpy(broken.data() + 8, &huge, sizeof(huge));
+    CHECK_FALSE(TableC_io().ReadTableC(broken.data(), broken.size(), cIn));
+  }
+
+  SECTION("Reading fails with wrong shared references")
+  {
+    TableC c;
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.d.push_back(c.d.back());
+
+    std::vector<char> buffer;
+    TableC_io().WriteTableC(buffer, c);
+    const auto index = buffer.size() - sizeof(std::size_t) - sizeof(unsigned int);
+    REQUIRE(buffer[index - 1] == '\x2');
+
+    TableC cIn;
+    for (const unsigned int wrong : {0u, 2u, 1000000u})
+    {
+      auto broken = buffer;
+      std::memcpy(broken.data() + index, &wrong, sizeof(wrong));
+      TableC_io io;
+      CHECK_FALSE(io.ReadTableC(broken.data(), broken.size(), cIn));
+      CHECK(io.ErrorOffset() == index + sizeof(wrong));
+
+      std::stringstream sIn(std::string(broken.begin(), broken.end()));
+      CHECK_FALSE(io.ReadTableC(sIn, cIn));
+      CHECK(io.ErrorOffset() == index + sizeof(wrong));
+
+      CHECK_FALSE(io.VerifyTableC(broken.data(), broken.size()));
+      CHECK(io.ErrorOffset() == index + sizeof(wrong));
+    }
+
+    auto broken = buffer;
+    broken[index - 1] = '\x3';
+    CHECK_FALSE(TableC_io().ReadTableC(broken.data(), broken.size(), cIn));
+    CHECK_FALSE(TableC_io().VerifyTableC(broken.data(), broken.size()));
+  }
+
+  SECTION("verifying whats written")
+  {
+    TableC c;
+    c.a.name = "TableA";
+    c.a.d3 = std::make_shared<TableD>();
+    c.a.d3->name = "TableD_3";
+    c.a.d4 = c.a.d3;
+    c.b.emplace_back("TableB");
+    c.c.emplace_back(new TableB("TableB_c"));
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.d.push_back(c.d.back());
+    c.e.emplace_back(c.d.back());
+
+    std::vector<char> buffer;
+    TableC_io().WriteTableC(buffer, c);
+    CHECK(TableC_io().VerifyTableC(buffer.data(), buffer.size()));
+
+    buffer.push_back('\0');
+    TableC_io io;
+    CHECK_FALSE(io.VerifyTableC(buffer.data(), buffer.size()));
+    CHECK(io.ErrorOffset() == buffer.size() - 1);
+    buffer.pop_back();
+
+    CHECK(fuzzRoot(buffer, 5000, &TableC_io::VerifyTableC, &TableC_io::ReadTableC) == 0);
+  }
+
+  SECTION("writing only the changes")
+  {
+    TableC c;
+    c.a.name = "TableA";
+    c.a.d3 = std::make_shared<TableD>();
+    c.a.d3->name = "TableD_3";
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.b.emplace_back("TableB_1");
+    c.b.emplace_back("TableB_2");
+
+    std::vector<char> snapshot;
+    TableC_io().WriteTableC(snapshot, c);
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(snapshot.data(), snapshot.size(), cIn));
+
+    c.change_b(1).name = "TableB_changed";
+    std::vector<char> delta;
+    TableC_io().WriteTableC(delta, c);
+    const auto full = delta.size();
+    delta.clear();
+    TableC_io().WriteTableCDelta(delta, c);
+    CHECK(delta.size() < full);
+    REQUIRE(TableC_io().ApplyTableCDelta(delta.data(), delta.size(), cIn));
+    CHECK(cIn.b == c.b);
+    REQUIRE(cIn.d.size() == 1);
+    CHECK(cIn.d[0]->name == "TableB_d");
+
+    c.push_e(c.d.back());
+    c.a.d4 = c.a.d3;
+    c.mark_a();
+    std::stringstream sDelta;
+    TableC_io().WriteTableCDelta(sDelta, c);
+    REQUIRE(TableC_io().ApplyTableCDelta(sDelta, cIn));
+    CHECK(cIn.a.name == "TableA");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d3->name == "TableD_3");
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.e.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+  }
+
+  SECTION("patching the differences")
+  {
+    TableC a;
+    a.a.name = "TableA";
+    a.a.d3 = std::make_shared<TableD>();
+    a.c.emplace_back(new TableB("TableB_c"));
+    a.d.emplace_back(new TableB("TableB_d"));
+    for (int i = 0; i < 100; ++i)
+      a.b.emplace_back("TableB_" + std::to_string(i));
+
+    TableC b;
+    b.a.name = "TableA";
+    b.a.d3 = a.a.d3;
+    b.a.d4 = a.a.d3;
+    b.d = a.d;
+    b.b = a.b;
+    b.b.erase(b.b.begin() + 10);
+    b.b.insert(b.b.begin() + 50, TableB("inserted"));
+    b.e.emplace_back(b.d[0]);
+
+    const auto patch = TableC_io().DiffTableC(a, b);
+    std::vector<char> full;
+    TableC_io().WriteTableC(full, b);
+    CHECK(patch.size() < full.size() / 4);
+
+    std::vector<char> base;
+    TableC_io().WriteTableC(base, a);
+    TableC c;
+    REQUIRE(TableC_io().ReadTableC(base.data(), base.size(), c));
+
+    // pointers of equal values are no difference
+    CHECK(TableC_io().DiffTableC(a, c).size() == TableC_io().DiffTableC(a, a).size());
+
+    REQUIRE(TableC_io().PatchTableC(c, patch));
+    CHECK(c.b == b.b);
+    CHECK(c.c.empty());
+    REQUIRE(c.a.d3);
+    CHECK(c.a.d4 == c.a.d3);
+    REQUIRE(c.e.size() == 1);
+    CHECK(c.e[0].lock() == c.d[0]);
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  SECTION("replaying the journal")
+  {
+    std::remove("tabletypes_journal_test.journal");
+    TableC c;
+    c.a.d3 = std::make_shared<TableD>();
+    c.a.d4 = c.a.d3;
+    c.d.emplace_back(new TableB("TableB_d"));
+    c.e.emplace_back(c.d[0]);
+    REQUIRE(TableC_io().SaveTableCFile("tabletypes_journal_test.core", c));
+    {
+      TableCJournal journal("tabletypes_journal_test.journal", c);
+      journal.push_b(TableB("first"));
+      journal.insert_b(0, TableB("second"));
+      journal.push_c(std::unique_ptr<TableB>(new TableB("unique")));
+      journal.push_c(nullptr);
+      journal.set_c(1, std::unique_ptr<TableB>(new TableB("replaced")));
+      journal.erase_b(1, 2);
+      REQUIRE(journal.commit());
+    }
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReplayTableCJournal("tabletypes_journal_test.core", "tabletypes_journal_test.journal", cIn));
+    CHECK(cIn.b == c.b);
+    REQUIRE(cIn.c.size() == 2);
+    CHECK(cIn.c[0]->name == "unique");
+    CHECK(cIn.c[1]->name == "replaced");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.e.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+    std::remove("tabletypes_journal_test.core");
+    std::remove("tabletypes_journal_test.journal");
+  }
+#endif
+
+  SECTION("reading whats written compressed")
+  {
+    std::stringstream sOut;
+    std::vector<char> plain;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d4 = c.a.d3;
+      for (int i = 0; i < 20000; ++i)
+        c.b.emplace_back("TableB_" + std::to_string(i % 1000));
+      c.d.emplace_back(new TableB("TableB_d"));
+      c.d.push_back(c.d.back());
+
+      TableC_io().WriteTableCCompressed(sOut, c);
+      TableC_io().WriteTableC(plain, c);
+    }
+    CHECK(sOut.str().size() < plain.size() / 2);
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableCCompressed(sOut, cIn));
+    CHECK(cIn.a.name == "TableA");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 20000);
+    CHECK(cIn.b[12345].name == "TableB_345");
+    REQUIRE(cIn.d.size() == 2);
+    CHECK(cIn.d[0] == cIn.d[1]);
+
+    auto corrupt = sOut.str();
+    corrupt[corrupt.size() / 2] ^= 0x55;
+    corrupt.resize(corrupt.size() - 20);
+    std::stringstream sCorrupt(corrupt);
+    TableC cCorrupt;
+    CHECK_FALSE(TableC_io().ReadTableCCompressed(sCorrupt, cCorrupt));
+
+    std::stringstream sPlain(std::string(plain.begin(), plain.end()));
+    CHECK_FALSE(TableC_io().ReadTableCCompressed(sPlain, cCorrupt));
+
+    for (std::size_t size = 4; size < sOut.str().size(); size += 1 + sOut.str().size() / 16)
+    {
+      std::stringstream sTruncated(sOut.str().substr(0, size));
+      CHECK_FALSE(TableC_io().ReadTableCCompressed(sTruncated, cCorrupt));
+    }
+
+    std::string garbage = "CORE\x01" "0.0" + std::string(12, '\x01') + std::string(400, '\xff');
+    const std::uint32_t sizes[2] = {std::uint32_t(garbage.size()), std::uint32_t(garbage.size())};
+    garbage.insert(0, reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    garbage.insert(0, "CORZ");
+    std::stringstream sGarbage(garbage);
+    TableC_io io;
+    CHECK_FALSE(io.ReadTableCCompressed(sGarbage, cCorrupt));
+    CHECK(io.ErrorOffset() == 20);
+  }
+
+  SECTION("visiting whats written")
+  {
+    struct Visitor : TableCVisitor
+    {
+      void on_a(const TableA &a) override { name = a.name; }
+      void on_b_begin(std::size_t size) override { b.reserve(size); }
+      void on_b_element(const TableB &entry) override { b.push_back(entry.name); }
+      void on_d_element(const std::shared_ptr<TableB> &entry) override { d.push_back(entry); }
+      void on_e_end() override { ended = true; }
+
+      std::string name;
+      std::vector<std::string> b;
+      std::vector<std::shared_ptr<TableB>> d;
+      bool ended{false};
+    };
+
+    std::vector<char> buffer;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.b.emplace_back("TableB_1");
+      c.b.emplace_back("TableB_2");
+      c.d.emplace_back(new TableB("TableB_d"));
+      c.d.push_back(c.d.back());
+      TableC_io().WriteTableC(buffer, c);
+    }
+
+    Visitor v;
+    REQUIRE(TableC_io().VisitTableC(buffer.data(), buffer.size(), v));
+    CHECK(v.name == "TableA");
+    CHECK(v.b == std::vector<std::string>({"TableB_1", "TableB_2"}));
+    REQUIRE(v.d.size() == 2);
+    CHECK(v.d[0]->name == "TableB_d");
+    CHECK(v.d[0] == v.d[1]);
+    CHECK(v.ended);
+
+    std::stringstream sIn(std::string(buffer.begin(), buffer.end()));
+    Visitor vs;
+    REQUIRE(TableC_io().VisitTableC(sIn, vs));
+    CHECK(vs.b == v.b);
+
+    Visitor vShort;
+    CHECK_FALSE(TableC_io().VisitTableC(buffer.data(), buffer.size() - 1, vShort));
+  }
+
+  SECTION("viewing whats written")
+  {
+    std::vector<char> buffer;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d1.reset(new TableD);
+      c.a.d1->name = "TableD_1";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d4 = c.a.d3;
+      c.b.emplace_back("TableB_1");
+      c.b.emplace_back("TableB_2");
+      c.c.emplace_back(new TableB("TableB_c"));
+      c.c.emplace_back();
+      TableC_io().WriteTableC(buffer, c);
+    }
+
+    TableCView v;
+    REQUIRE(TableC_io().ViewTableC(buffer.data(), buffer.size(), v));
+    CHECK(v.a().name() == std::string("TableA"));
+    REQUIRE(static_cast<bool>(v.a().d1()));
+    CHECK(v.a().d1().name().str() == "TableD_1");
+
+    std::vector<std::string> names;
+    for (const auto &b : v.b())
+      names.push_back(b.name().str());
+    CHECK(names == std::vector<std::string>({"TableB_1", "TableB_2"}));
+    const auto list = v.b();
+    CHECK(list[1].name() == std::string("TableB_2"));
+    CHECK(list[0].name() == std::string("TableB_1"));
+    CHECK_FALSE(static_cast<bool>(list[2]));
+
+    REQUIRE(v.c().size() == 2);
+    CHECK(v.c()[0].name().str() == "TableB_c");
+    CHECK_FALSE(static_cast<bool>(v.c()[1]));
+
+    for (std::size_t size = 0; size < buffer.size(); ++size)
+    {
+      TableCView vShort;
+      if (!TableC_io().ViewTableC(buffer.data(), size, vShort))
+        continue;
+      std::size_t count = 0;
+      for (const auto &b : vShort.c())
+        count += b.name().size();
+      CHECK(count <= 8);
+    }
+  }
+
+  SECTION("writing in parallel")
+  {
+    const auto testC = []() {
+      TableC c;
+      c.a = TableA("TableA");
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d4 = c.a.d3;
+      for (int i = 0; i < 5000; ++i)
+      {
+        c.b.emplace_back("TableB_" + std::to_string(i));
+        c.c.emplace_back(new TableB("TableB_c" + std::to_string(i)));
+      }
+      c.d.push_back(std::make_shared<TableB>("TableB_d"));
+      c.e.push_back(c.d.back());
+      return c;
+    };
+
+    std::stringstream sSerial;
+    TableC_io().WriteTableC(sSerial, testC());
+
+    std::stringstream sParallel;
+    TableC_io().WriteTableCParallel(sParallel, testC(), 4);
+    CHECK(sParallel.str() == sSerial.str());
+
+    std::vector<char> buffer;
+    TableC_io().WriteTableCParallel(buffer, testC(), 3);
+    CHECK(std::string(buffer.begin(), buffer.end()) == sSerial.str());
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(sParallel, cIn));
+    CHECK(cIn.b == testC().b);
+    REQUIRE(cIn.c.size() == 5000);
+    CHECK(cIn.c[4999]->name == "TableB_c4999");
+    REQUIRE(cIn.d.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+  }
+
+  SECTION("reading whats written incrementally")
+  {
+    std::stringstream sOut;
+    {
+      TableA a("TableA");
+      a.d3 = std::make_shared<TableD>();
+      a.d3->name = "TableD_3";
+      a.d4 = a.d3;
+      auto shared = std::make_shared<TableB>("TableB_d");
+
+      TableCWriter w(sOut);
+      CHECK_FALSE(w.begin_b());
+      REQUIRE(w.write_a(a));
+      REQUIRE(w.begin_b());
+      for (int i = 0; i < 1000; ++i)
+        REQUIRE(w.push_b(TableB("TableB_" + std::to_string(i))));
+      CHECK_FALSE(w.push_c(std::unique_ptr<TableB>()));
+      REQUIRE(w.end_b());
+      REQUIRE(w.begin_c(1));
+      REQUIRE(w.push_c(std::unique_ptr<TableB>(new TableB("TableB_c"))));
+      REQUIRE(w.end_c());
+      REQUIRE(w.begin_d());
+      REQUIRE(w.push_d(shared));
+      REQUIRE(w.push_d(shared));
+      REQUIRE(w.end_d());
+      REQUIRE(w.begin_e(1));
+      REQUIRE(w.push_e(shared));
+      CHECK_FALSE(w.done());
+      REQUIRE(w.end_e());
+      CHECK(w.done());
+    }
+
+    TableC cIn;
+    REQUIRE(TableC_io().ReadTableC(sOut, cIn));
+    CHECK(cIn.a.name == "TableA");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 1000);
+    CHECK(cIn.b[999].name == "TableB_999");
+    REQUIRE(cIn.c.size() == 1);
+    CHECK(cIn.c[0]->name == "TableB_c");
+    REQUIRE(cIn.d.size() == 2);
+    CHECK(cIn.d[0] == cIn.d[1]);
+    REQUIRE(cIn.e.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+
+    // the shared counts are patched into the header like the counts of the vectors
+    std::vector<char> buffer;
+    TableC_io().WriteTableC(buffer, cIn);
+    CHECK(sOut.str() == std::string(buffer.begin(), buffer.end()));
+
+    std::stringstream sCount;
+    TableCWriter wCount(sCount);
+    REQUIRE(wCount.write_a(TableA("TableA")));
+    REQUIRE(wCount.begin_b(2));
+    REQUIRE(wCount.push_b(TableB("TableB")));
+    CHECK_FALSE(wCount.end_b());
+  }
+
+  SECTION("reading whats saved to a file")
+  {
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d3->name = "TableD_3";
+      c.a.d4 = c.a.d3;
+      c.b.emplace_back("TableB");
+      c.d.emplace_back(new TableB("TableB_d"));
+      c.d.push_back(c.d.back());
+      c.e.emplace_back(c.d.back());
+
+      REQUIRE(TableC_io().SaveTableCFile("tabletypes_test.core", c));
+    }
+
+    std::ifstream old("tabletypes_test.core", std::ios::binary);
+    REQUIRE(TableC_io().SaveTableCFile("tabletypes_test.core", TableC()));
+    CHECK_FALSE(std::ifstream("tabletypes_test.core.tmp"));
+    TableC cOld;
+    REQUIRE(TableC_io().ReadTableC(old, cOld));
+    CHECK(cOld.a.name == "TableA");
+    CHECK_FALSE(TableC_io().SaveTableCFile("not_existing/tabletypes_test.core", cOld));
+
+    TableC cIn;
+    REQUIRE(TableC_io().LoadTableCFile("tabletypes_test.core", cIn));
+    CHECK(cIn == TableC());
+    REQUIRE(TableC_io().SaveTableCFile("tabletypes_test.core", cOld));
+    REQUIRE(TableC_io().LoadTableCFile("tabletypes_test.core", cIn));
+    std::remove("tabletypes_test.core");
+
+    CHECK(cIn.a.name == "TableA");
+    REQUIRE(cIn.a.d3);
+    CHECK(cIn.a.d3->name == "TableD_3");
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 1);
+    CHECK(cIn.b.front().name == "TableB");
+    REQUIRE(cIn.d.size() == 2);
+    CHECK(cIn.d[0]->name == "TableB_d");
+    CHECK(cIn.d[0] == cIn.d[1]);
+    REQUIRE(cIn.e.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+
+    CHECK_FALSE(TableC_io().LoadTableCFile("not_existing.core", cIn));
+  }
+
+  SECTION("reading whats saved to a file asynchronously")
+  {
+    std::vector<char> buffer;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d4 = c.a.d3;
+      for (int i = 0; i < 100000; ++i)
+        c.b.emplace_back("TableB_" + std::to_string(i));
+      c.d.emplace_back(new TableB("TableB_d"));
+      c.e.emplace_back(c.d.back());
+
+      auto saved = TableC_io().SaveTableCFileAsync("tabletypes_async_test.core", c);
+      REQUIRE(saved.get());
+      TableC_io().WriteTableC(buffer, c);
+    }
+
+    // the shared counts are in the header and the temporary file is renamed over the target
+    std::ifstream f("tabletypes_async_test.core", std::ios::binary);
+    const std::string file((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    CHECK(file == std::string(buffer.begin(), buffer.end()));
+    CHECK_FALSE(std::ifstream("tabletypes_async_test.core.tmp"));
+
+    TableC cIn;
+    REQUIRE(TableC_io().LoadTableCFile("tabletypes_async_test.core", cIn));
+    std::remove("tabletypes_async_test.core");
+
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 100000);
+    CHECK(cIn.b.back().name == "TableB_99999");
+    REQUIRE(cIn.e.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+
+    CHECK_FALSE(TableC_io().SaveTableCFileAsync("not_existing/tabletypes.core", cIn).get());
+  }
+
+  SECTION("reading whats saved through io_uring")
+  {
+    std::vector<char> buffer;
+    {
+      TableC c;
+      c.a.name = "TableA";
+      c.a.d3 = std::make_shared<TableD>();
+      c.a.d4 = c.a.d3;
+      for (int i = 0; i < 300000; ++i)
+        c.b.emplace_back("TableB_" + std::to_string(i));
+      c.d.emplace_back(new TableB("TableB_d"));
+      c.d.push_back(c.d.back());
+      c.e.emplace_back(c.d.back());
+
+      REQUIRE(TableC_io().SaveTableCFileUring("tabletypes_uring_test.core", c));
+      TableC_io().WriteTableC(buffer, c);
+    }
+
+    std::ifstream f("tabletypes_uring_test.core", std::ios::binary);
+    const std::string file((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    f.close();
+    CHECK(file == std::string(buffer.begin(), buffer.end()));
+    CHECK_FALSE(std::ifstream("tabletypes_uring_test.core.tmp"));
+
+    TableC cIn;
+    REQUIRE(TableC_io().LoadTableCFileUring("tabletypes_uring_test.core", cIn));
+    std::remove("tabletypes_uring_test.core");
+
+    CHECK(cIn.a.d4 == cIn.a.d3);
+    REQUIRE(cIn.b.size() == 300000);
+    CHECK(cIn.b.back().name == "TableB_299999");
+    REQUIRE(cIn.d.size() == 2);
+    CHECK(cIn.d[0] == cIn.d[1]);
+    REQUIRE(cIn.e.size() == 1);
+    CHECK(cIn.e[0].lock() == cIn.d[0]);
+
+    CHECK_FALSE(TableC_io().SaveTableCFileUring("not_existing/tabletypes.core", cIn));
+    CHECK_FALSE(TableC_io().LoadTableCFileUring("not_existing/tabletypes.core", cIn));
+  }
+
+  SECTION("Compare operations")
+  {
+    TableD d1;
+    TableD d2;
+    CHECK(d1 == d2);
+    CHECK_FALSE(d1 != d2);
+
+    d1.name = "xxx";
+    d2.name = "yyy";
+
+    CHECK_FALSE(d1 == d2);
+    CHECK(d1 != d2);
+  }
+
+  SECTION("Reading fails with wrong data")
+  {
+    TableC c;
+
+    std::stringstream s1("FALSE");
+    CHECK_FALSE(TableC_io().ReadTableC(s1, c));
+
+    std::stringstream s2("COREfails");
+    CHECK_FALSE(TableC_io().ReadTableC(s2, c));
+  }
+
+  SECTION("initializing methods with pointer")
+  {
+    auto d = std::make_shared<TableD>();
+
+    auto _inited = TableA(d);
+
+    CHECK(nullptr == _inited.d1);
+    CHECK(nullptr == _inited.d2.lock());
+    CHECK(d == _inited.d3);
+    CHECK(nullptr == _inited.d4);
+
+    _inited = TableA(d, std::unique_ptr<TableD>(new TableD));
+
+    CHECK(nullptr != _inited.d1);
+    CHECK(d == _inited.d2.lock());
+    CHECK(nullptr == _inited.d3);
+    CHECK(nullptr == _inited.d4);
+  }
+
+  SECTION("initializing methods vector of unique pointer")
+  {
+    std::vector<std::unique_ptr<TableB>> list;
+    list.emplace_back(new TableB);
+    list.emplace_back(new TableB);
+
+    TableC _inited(std::move(list));
+
+    CHECK(_inited.c.size() == 2);
+  }
+
+  SECTION("vector algorithm table")
+  {
+    TableC p;
+    p.b.emplace_back("x");
+    p.b.emplace_back("xx");
+    p.b.emplace_back("xxx");
+    REQUIRE(p.b.size() == 3);
+
+    SECTION("generate")
+    {
+      std::string x("x");
+      p.generate_b([&x]() { return TableB(x += "x"); });
+      CHECK(p.b[0] == TableB("xx"));
+      CHECK(p.b[1] == TableB("xxx"));
+      CHECK(p.b[2] == TableB("xxxx"));
+    }
+
+    SECTION("fill")
+    {
+      p.fill_b(TableB("42"));
+
+      CHECK(p.b[0] == TableB("42"));
+      CHECK(p.b[1] == TableB("42"));
+      CHECK(p.b[2] == TableB("42"));
+    }
+
+    SECTION("remove")
+    {
+      auto e = p.remove_b(TableB("xx"));
+
+      CHECK(e == p.b.end() - 1);
+      CHECK(3 == p.b.size());
+      CHECK(p.b[0] == TableB("x"));
+      CHECK(p.b[1] == TableB("xxx"));
+    }
+
+    SECTION("remove_if")
+    {
+      auto e = p.remove_b_if([](const TableB &b) { return b == TableB("xx"); });
+
+      CHECK(e == p.b.end() - 1);
+      CHECK(3 == p.b.size());
+      CHECK(p.b[0] == TableB("x"));
+      CHECK(p.b[1] == TableB("xxx"));
+    }
+
+    SECTION("erase")
+    {
+      p.erase_b(TableB("xx"));
+
+      CHECK(2 == p.b.size());
+      CHECK(p.b[0] == TableB("x"));
+      CHECK(p.b[1] == TableB("xxx"));
+    }
+
+    SECTION("erase_if")
+    {
+      p.erase_b_if([](const TableB &b) { return b == TableB("xx"); });
+
+      CHECK(2 == p.b.size());
+      CHECK(p.b[0] == TableB("x"));
+      CHECK(p.b[1] == TableB("xxx"));
+    }
+
+    SECTION("reverse")
+    {
+      p.reverse_b();
+
+      REQUIRE(3 == p.b.size());
+      CHECK(p.b[0] == TableB("xxx"));
+      CHECK(p.b[1] == TableB("xx"));
+      CHECK(p.b[2] == TableB("x"));
+    }
+
+    SECTION("rotate")
+    {
+      p.rotate_b(p.b.begin() + 1);
+
+      REQUIRE(3 == p.b.size());
+      CHECK(p.b[0] == TableB("xx"));
+      CHECK(p.b[1] == TableB("xxx"));
+      CHECK(p.b[2] == TableB("x"));
+    }
+
+    SECTION("sort with comparator")
+    {
+      p.b[0] = TableB("32");
+      p.b[1] = TableB("124");
+      p.b[2] = TableB("42");
+      p.sort_b([](const TableB &l, const TableB &r) { return l.name > r.name; });
+
+      REQUIRE(3 == p.b.size());
+      CHECK(p.b[0] == TableB("42"));
+      CHECK(p.b[1] == TableB("32"));
+      CHECK(p.b[2] == TableB("124"));
+    }
+
+    SECTION("any of")
+    {
+      CHECK(p.any_of_b([](const TableB &x) { return x.name == "xx"; }));
+      CHECK_FALSE(p.any_of_b([](const TableB &x) { return x.name == "42"; }));
+    }
+
+    SECTION("all of")
+    {
+      CHECK(p.all_of_b([](const TableB &x) { return !x.name.empty() && x.name[0] == 'x'; }));
+      CHECK_FALSE(p.all_of_b([](const TableB &x) { return x.name.size() == 2; }));
+    }
+
+    SECTION("none of")
+    {
+      CHECK_FALSE(p.none_of_b([](const TableB &x) { return !x.name.empty() && x.name[0] == 'x'; }));
+      CHECK_FALSE(p.none_of_b([](const TableB &x) { return x.name.size() == 2; }));
+      CHECK(p.none_of_b([](const TableB &x) { return x.name.size() > 3; }));
+    }
+
+    SECTION("any of is")
+    {
+      CHECK(p.any_of_b_is(TableB("xx")));
+      CHECK_FALSE(p.any_of_b_is(TableB("42")));
+    }
+
+    SECTION("all of are")
+    {
+      CHECK_FALSE(p.all_of_b_are(TableB("42")));
+      p.fill_b(TableB("42"));
+      CHECK(p.b.size() == 3);
+      CHECK(p.all_of_b_are(TableB("42")));
+    }
+
+    SECTION("none of value")
+    {
+      CHECK_FALSE(p.none_of_b_is(TableB("x")));
+      CHECK(p.none_of_b_is(TableB("42")));
+    }
+
+    SECTION("for each")
+    {
+      std::string x;
+      p.for_each_b([&x](const TableB &i) { x += i.name; });
+      CHECK(x == std::string("x") + "xx" + "xxx");
+    }
+
+    SECTION("find")
+    {
+      CHECK(p.find_in_b(TableB("xx").name) == p.b.begin() + 1);
+      CHECK(p.find_in_b(TableB("42").name) == p.b.end());
+    }
+
+    SECTION("find if")
+    {
+      CHECK(p.find_in_b_if([](const TableB &x) { return x.name == "xx"; }) == p.b.begin() + 1);
+      CHECK(p.find_in_b_if([](const TableB &x) { return x.name == "42"; }) == p.b.end());
+    }
+
+    SECTION("count")
+    {
+      CHECK(p.count_in_b(TableB("xx")) == 1);
+      CHECK(p.count_in_b(TableB("42")) == 0);
+    }
+
+    SECTION("count if")
+    {
+      CHECK(p.count_in_b_if([](const TableB &x) { return x.name.size() % 2 == 1; }) == 2);
+      CHECK(p.count_in_b_if([](const TableB &x) { return x.name.size() > 42; }) == 0);
+    }
+  }
+
+  SECTION("vector algorithm unique table")
+  {
+    TableC p;
+    p.c.emplace_back(new TableB("x"));
+    p.c.emplace_back(new TableB("xx"));
+    p.c.emplace_back(new TableB("xxx"));
+    REQUIRE(p.c.size() == 3);
+
+    SECTION("generate")
+    {
+      std::string x("x");
+      p.generate_c([&x]() { return std::unique_ptr<TableB>(new TableB(x += "x")); });
+      CHECK(p.c[0]->name == "xx");
+      CHECK(p.c[1]->name == "xxx");
+      CHECK(p.c[2]->name == "xxxx");
+    }
+
+    SECTION("remove")
+    {
+      auto e = p.remove_c(p.c[1]);
+
+      CHECK(e == p.c.end() - 1);
+      CHECK(3 == p.c.size());
+      CHECK(p.c[0]->name == "x");
+      CHECK(p.c[1]->name == "xxx");
+    }
+
+    SECTION("remove_if")
+    {
+      auto e = p.remove_c_if([](const std::unique_ptr<TableB> &b) { return *b == TableB("xx"); });
+
+      CHECK(e == p.c.end() - 1);
+      CHECK(3 == p.c.size());
+      CHECK(p.c[0]->name == "x");
+      CHECK(p.c[1]->name == "xxx");
+    }
+
+    SECTION("erase")
+    {
+      p.erase_c(p.c[1]);
+
+      CHECK(2 == p.c.size());
+      CHECK(p.c[0]->name == "x");
+      CHECK(p.c[1]->name == "xxx");
+    }
+
+    SECTION("erase_if")
+    {
+      p.erase_c_if([](const std::unique_ptr<TableB> &b) { return *b == TableB("xx"); });
+
+      CHECK(2 == p.c.size());
+      CHECK(p.c[0]->name == "x");
+      CHECK(p.c[1]->name == "xxx");
+    }
+
+    SECTION("reverse")
+    {
+      p.reverse_c();
+
+      REQUIRE(3 == p.c.size());
+      CHECK(p.c[0]->name == "xxx");
+      CHECK(p.c[1]->name == "xx");
+      CHECK(p.c[2]->name == "x");
+    }
+
+    SECTION("rotate")
+    {
+      p.rotate_c(p.c.begin() + 1);
+
+      REQUIRE(3 == p.c.size());
+      CHECK(p.c[0]->name == "xx");
+      CHECK(p.c[1]->name == "xxx");
+      CHECK(p.c[2]->name == "x");
+    }
+
+    SECTION("sort with comparator")
+    {
+      p.c[0] = std::unique_ptr<TableB>(new TableB("32"));
+      p.c[1] = std::unique_ptr<TableB>(new TableB("124"));
+      p.c[2] = std::unique_ptr<TableB>(new TableB("42"));
+      p.sort_c([](const std::unique_ptr<TableB> &l, const std::unique_ptr<TableB> &r) { return l->name > r->name; });
+
+      REQUIRE(3 == p.c.size());
+      CHECK(p.c[0]->name == "42");
+      CHECK(p.c[1]->name == "32");
+      CHECK(p.c[2]->name == "124");
+    }
+
+    SECTION("any of")
+    {
+      CHECK(p.any_of_c([](const std::unique_ptr<TableB> &x) { return x->name == "xx"; }));
+      CHECK_FALSE(p.any_of_c([](const std::unique_ptr<TableB> &x) { return x->name == "42"; }));
+    }
+
+    SECTION("all of")
+    {
+      CHECK(p.all_of_c([](const std::unique_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
+      CHECK_FALSE(p.all_of_c([](const std::unique_ptr<TableB> &x) { return x->name.size() == 2; }));
+    }
+
+    SECTION("none of")
+    {
+      CHECK_FALSE(p.none_of_c([](const std::unique_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
+      CHECK_FALSE(p.none_of_c([](const std::unique_ptr<TableB> &x) { return x->name.size() == 2; }));
+      CHECK(p.none_of_c([](const std::unique_ptr<TableB> &x) { return x->name.size() > 3; }));
+    }
+
+    SECTION("any of is")
+    {
+      p.c.push_back(nullptr);
+      CHECK(p.any_of_c_is(TableB("xx")));
+      CHECK_FALSE(p.any_of_c_is(TableB("42")));
+    }
+
+    SECTION("all of are")
+    {
+      p.c.push_back(nullptr);
+      CHECK_FALSE(p.all_of_c_are(TableB("42")));
+      for (auto &c : p.c)
+        if (c)
+          c->name = "42";
+      CHECK_FALSE(p.all_of_c_are(TableB("42")));
+      p.c.pop_back();
+      CHECK(p.all_of_c_are(TableB("42")));
+    }
+
+    SECTION("none of value")
+    {
+      p.c.push_back(nullptr);
+      CHECK_FALSE(p.none_of_c_is(TableB("x")));
+      CHECK(p.none_of_c_is(TableB("42")));
+    }
+
+    SECTION("for each")
+    {
+      std::string x;
+      p.for_each_c([&x](const std::unique_ptr<TableB> &i) { x += i->name; });
+      CHECK(x == std::string("x") + "xx" + "xxx");
+    }
+
+    SECTION("find")
+    {
+      CHECK(p.find_in_c(p.c[1]) == p.c.begin() + 1);
+      CHECK(p.find_in_c(nullptr) == p.c.end());
+    }
+
+    SECTION("find if")
+    {
+      CHECK(p.find_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name == "xx"; }) == p.c.begin() + 1);
+      CHECK(p.find_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name == "42"; }) == p.c.end());
+    }
+
+    SECTION("count")
+    {
+      CHECK(p.count_in_c(p.c[1]) == 1);
+      CHECK(p.count_in_c(nullptr) == 0);
+    }
+
+    SECTION("count if")
+    {
+      CHECK(p.count_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name.size() % 2 == 1; }) == 2);
+      CHECK(p.count_in_c_if([](const std::unique_ptr<TableB> &x) { return x->name.size() > 42; }) == 0);
+    }
+  }
+
+  SECTION("vector algorithm shared table")
+  {
+    TableC p;
+    p.d.emplace_back(new TableB("x"));
+    p.d.emplace_back(new TableB("xx"));
+    p.d.emplace_back(new TableB("xxx"));
+    REQUIRE(p.d.size() == 3);
+
+    SECTION("fill")
+    {
+      p.fill_d(std::make_shared<TableB>("42"));
+
+      CHECK(p.d[0] == p.d[1]);
+      CHECK(p.d[0] == p.d[2]);
+      CHECK(*p.d[2] == TableB("42"));
+    }
+
+    SECTION("generate")
+    {
+      std::string x("x");
+      p.generate_d([&x]() { return std::make_shared<TableB>(x += "x"); });
+      CHECK(p.d[0]->name == "xx");
+      CHECK(p.d[1]->name == "xxx");
+      CHECK(p.d[2]->name == "xxxx");
+    }
+
+    SECTION("remove")
+    {
+      auto e = p.remove_d(p.d[1]);
+
+      CHECK(e == p.d.end() - 1);
+      CHECK(3 == p.d.size());
+      CHECK(p.d[0]->name == "x");
+      CHECK(p.d[1]->name == "xxx");
+    }
+
+    SECTION("remove_if")
+    {
+      auto e = p.remove_d_if([](const std::shared_ptr<TableB> &b) { return *b == TableB("xx"); });
+
+      CHECK(e == p.d.end() - 1);
+      CHECK(3 == p.d.size());
+      CHECK(p.d[0]->name == "x");
+      CHECK(p.d[1]->name == "xxx");
+    }
+
+    SECTION("erase")
+    {
+      p.erase_d(p.d[1]);
+
+      CHECK(2 == p.d.size());
+      CHECK(p.d[0]->name == "x");
+      CHECK(p.d[1]->name == "xxx");
+    }
+
+    SECTION("erase_if")
+    {
+      p.erase_d_if([](const std::shared_ptr<TableB> &b) { return *b == TableB("xx"); });
+
+      CHECK(2 == p.d.size());
+      CHECK(p.d[0]->name == "x");
+      CHECK(p.d[1]->name == "xxx");
+    }
+
+    SECTION("reverse")
+    {
+      p.reverse_d();
+
+      REQUIRE(3 == p.d.size());
+      CHECK(p.d[0]->name == "xxx");
+      CHECK(p.d[1]->name == "xx");
+      CHECK(p.d[2]->name == "x");
+    }
+
+    SECTION("rotate")
+    {
+      p.rotate_d(p.d.begin() + 1);
+
+      REQUIRE(3 == p.d.size());
+      CHECK(p.d[0]->name == "xx");
+      CHECK(p.d[1]->name == "xxx");
+      CHECK(p.d[2]->name == "x");
+    }
+
+    SECTION("sort with comparator")
+    {
+      p.d[0] = std::shared_ptr<TableB>(new TableB("32"));
+      p.d[1] = std::shared_ptr<TableB>(new TableB("124"));
+      p.d[2] = std::shared_ptr<TableB>(new TableB("42"));
+      p.sort_d([](const std::shared_ptr<TableB> &l, const std::shared_ptr<TableB> &r) { return l->name > r->name; });
+
+      REQUIRE(3 == p.d.size());
+      CHECK(p.d[0]->name == "42");
+      CHECK(p.d[1]->name == "32");
+      CHECK(p.d[2]->name == "124");
+    }
+
+    SECTION("any of")
+    {
+      CHECK(p.any_of_d([](const std::shared_ptr<TableB> &x) { return x->name == "xx"; }));
+      CHECK_FALSE(p.any_of_d([](const std::shared_ptr<TableB> &x) { return x->name == "42"; }));
+    }
+
+    SECTION("all of")
+    {
+      CHECK(p.all_of_d([](const std::shared_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
+      CHECK_FALSE(p.all_of_d([](const std::shared_ptr<TableB> &x) { return x->name.size() == 2; }));
+    }
+
+    SECTION("none of")
+    {
+      CHECK_FALSE(p.none_of_d([](const std::shared_ptr<TableB> &x) { return !x->name.empty() && x->name[0] == 'x'; }));
+      CHECK_FALSE(p.none_of_d([](const std::shared_ptr<TableB> &x) { return x->name.size() == 2; }));
+      CHECK(p.none_of_d([](const std::shared_ptr<TableB> &x) { return x->name.size() > 3; }));
+    }
+
+    SECTION("any of is")
+    {
+      p.d.push_back(nullptr);
+      CHECK(p.any_of_d_is(TableB("xx")));
+      CHECK_FALSE(p.any_of_d_is(TableB("42")));
+    }
+
+    SECTION("any of is pointer")
+    {
+      p.d.push_back(nullptr);
+      CHECK(p.any_of_d_is(p.d[1]));
+      CHECK_FALSE(p.any_of_d_is(std::make_shared<TableB>("42")));
+    }
+
+    SECTION("all of are")
+    {
+      p.d.push_back(nullptr);
+      CHECK_FALSE(p.all_of_d_are(TableB("42")));
+      for (auto &c : p.d)
+        if (c)
+          c->name = "42";
+      CHECK_FALSE(p.all_of_d_are(TableB("42")));
+      p.d.pop_back();
+      CHECK(p.all_of_d_are(TableB("42")));
+    }
+
+    SECTION("all of are pointer")
+    {
+      p.d.push_back(nullptr);
+      CHECK_FALSE(p.all_of_d_are(p.d[1]));
+      CHECK_FALSE(p.all_of_d_are(std::make_shared<TableB>("42")));
+      p.d = {p.d[2], p.d[2], p.d[2]};
+      CHECK(p.all_of_d_are(p.d[2]));
+    }
+
+    SECTION("none of value")
+    {
+      p.d.push_back(nullptr);
+      CHECK_FALSE(p.none_of_d_is(TableB("x")));
+      CHECK(p.none_of_d_is(TableB("42")));
+    }
+
+    SECTION("none of value pointer")
+    {
+      p.d.push_back(nullptr);
+      CHECK_FALSE(p.none_of_d_is(p.d[1]));
+      CHECK(p.none_of_d_is(std::make_shared<TableB>("42")));
+    }
+
+    SECTION("for each")
+    {
+      std::string x;
+      p.for_each_d([&x](const std::shared_ptr<TableB> &i) { x += i->name; });
+      CHECK(x == std::string("x") + "xx" + "xxx");
+    }
+
+    SECTION("find")
+    {
+      CHECK(p.find_in_d(p.d[1]) == p.d.begin() + 1);
+      CHECK(p.find_in_d(nullptr) == p.d.end());
+    }
+
+    SECTION("find if")
+    {
+      CHECK(p.find_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name == "xx"; }) == p.d.begin() + 1);
+      CHECK(p.find_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name == "42"; }) == p.d.end());
+    }
+
+    SECTION("count")
+    {
+      CHECK(p.count_in_d(p.d[1]) == 1);
+      CHECK(p.count_in_d(nullptr) == 0);
+    }
+
+    SECTION("count if")
+    {
+      CHECK(p.count_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name.size() % 2 == 1; }) == 2);
+      CHECK(p.count_in_d_if([](const std::shared_ptr<TableB> &x) { return x->name.size() > 42; }) == 0);
+    }
+  }
+
+  SECTION("vector algorithm weak table")
+  {
+    TableC p;
+    p.d.emplace_back(new TableB("x"));
+    p.d.emplace_back(new TableB("xx"));
+    p.d.emplace_back(new TableB("xxx"));
+    p.e.emplace_back(p.d[0]);
+    p.e.emplace_back(p.d[1]);
+    p.e.emplace_back(p.d[2]);
+    REQUIRE(p.e.size() == 3);
+
+    SECTION("fill")
+    {
+      const auto x = std::make_shared<TableB>("42");
+      p.fill_e(x);
+
+      CHECK(p.e[0].lock() == p.e[1].lock());
+      CHECK(p.e[0].lock() == p.e[2].lock());
+      CHECK(p.e[2].lock() == x);
+    }
+
+    SECTION("generate")
+    {
+      std::string x("x");
+      p.generate_e([&]() {
+        p.d.emplace_back(new TableB(x += "x"));
+        return p.d.back();
+      });
+      CHECK(p.e[0].lock()->name == "xx");
+      CHECK(p.e[1].lock()->name == "xxx");
+      CHECK(p.e[2].lock()->name == "xxxx");
+      CHECK(p.e[0].lock() == p.d[3]);
+      CHECK(p.e[1].lock() == p.d[4]);
+      CHECK(p.e[2].lock() == p.d[5]);
+    }
+
+    SECTION("remove")
+    {
+      auto e = p.remove_e(p.e[1]);
+
+      CHECK(e == p.e.end() - 1);
+      CHECK(3 == p.e.size());
+      CHECK(p.e[0].lock()->name == "x");
+      CHECK(p.e[1].lock()->name == "xxx");
+    }
+
+    SECTION("remove_if")
+    {
+      auto e = p.remove_e_if([](const std::weak_ptr<TableB> &b) { return b.lock() && *b.lock() == TableB("xx"); });
+
+      CHECK(e == p.e.end() - 1);
+      CHECK(3 == p.e.size());
+      CHECK(p.e[0].lock()->name == "x");
+      CHECK(p.e[1].lock()->name == "xxx");
+    }
+
+    SECTION("erase")
+    {
+      p.erase_e(p.e[1]);
+
+      CHECK(2 == p.e.size());
+      CHECK(p.e[0].lock()->name == "x");
+      CHECK(p.e[1].lock()->name == "xxx");
+    }
+
+    SECTION("erase_if")
+    {
+      p.erase_e_if([](const std::weak_ptr<TableB> &b) { return b.lock() && *b.lock() == TableB("xx"); });
+
+      CHECK(2 == p.e.size());
+      CHECK(p.e[0].lock()->name == "x");
+      CHECK(p.e[1].lock()->name == "xxx");
+    }
+
+    SECTION("reverse")
+    {
+      p.reverse_e();
+
+      REQUIRE(3 == p.e.size());
+      CHECK(p.e[0].lock()->name == "xxx");
+      CHECK(p.e[1].lock()->name == "xx");
+      CHECK(p.e[2].lock()->name == "x");
+    }
+
+    SECTION("rotate")
+    {
+      p.rotate_e(p.e.begin() + 1);
+
+      REQUIRE(3 == p.e.size());
+      CHECK(p.e[0].lock()->name == "xx");
+      CHECK(p.e[1].lock()->name == "xxx");
+      CHECK(p.e[2].lock()->name == "x");
+    }
+
+    SECTION("sort with comparator")
+    {
+      p.d[0]->name = "32";
+      p.d[1]->name = "124";
+      p.d[2]->name = "42";
+      p.sort_e([](const std::weak_ptr<TableB> &l, const std::weak_ptr<TableB> &r) {
+        return l.lock() && r.lock() && l.lock()->name > r.lock()->name;
+      });
+
+      REQUIRE(3 == p.e.size());
+      CHECK(p.e[0].lock()->name == "42");
+      CHECK(p.e[1].lock()->name == "32");
+      CHECK(p.e[2].lock()->name == "124");
+    }
+
+    SECTION("any of")
+    {
+      CHECK(p.any_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "xx"; }));
+      CHECK_FALSE(p.any_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "42"; }));
+    }
+
+    SECTION("all of")
+    {
+      CHECK(p.all_of_e(
+          [](const std::weak_ptr<TableB> &x) { return !x.lock()->name.empty() && x.lock()->name[0] == 'x'; }));
+      CHECK_FALSE(p.all_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() == 2; }));
+    }
+
+    SECTION("none of")
+    {
+      CHECK_FALSE(p.none_of_e(
+          [](const std::weak_ptr<TableB> &x) { return !x.lock()->name.empty() && x.lock()->name[0] == 'x'; }));
+      CHECK_FALSE(p.none_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() == 2; }));
+      CHECK(p.none_of_e([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() > 3; }));
+    }
+
+    SECTION("any of is")
+    {
+      p.e.push_back(std::make_shared<TableB>());
+      CHECK(p.e.back().lock() == nullptr);
+      CHECK(p.any_of_e_is(TableB("xx")));
+      CHECK_FALSE(p.any_of_e_is(TableB("42")));
+    }
+
+    SECTION("any of is pointer")
+    {
+      p.e.push_back(std::make_shared<TableB>());
+      CHECK(p.e.back().lock() == nullptr);
+      CHECK(p.any_of_e_is(p.e[1].lock()));
+      CHECK_FALSE(p.any_of_e_is(std::make_shared<TableB>("42")));
+    }
+
+    SECTION("all of are")
+    {
+      p.e.push_back(std::make_shared<TableB>());
+      CHECK(p.e.back().lock() == nullptr);
+      CHECK_FALSE(p.all_of_e_are(TableB("42")));
+      for (auto &c : p.e)
+        if (c.lock())
+          c.lock()->name = "42";
+      CHECK_FALSE(p.all_of_e_are(TableB("42")));
+      p.e.pop_back();
+      CHECK(p.all_of_e_are(TableB("42")));
+    }
+
+    SECTION("all of are pointer")
+    {
+      p.e.push_back(std::make_shared<TableB>());
+      CHECK(p.e.back().lock() == nullptr);
+      CHECK_FALSE(p.all_of_e_are(p.e[1].lock()));
+      CHECK_FALSE(p.all_of_e_are(std::make_shared<TableB>("42")));
+      p.e = {p.e[2], p.e[2], p.e[2]};
+      CHECK(p.all_of_e_are(p.e[2].lock()));
+    }
+
+    SECTION("none of value")
+    {
+      p.e.push_back(std::make_shared<TableB>());
+      CHECK(p.e.back().lock() == nullptr);
+      CHECK_FALSE(p.none_of_e_is(TableB("x")));
+      CHECK(p.none_of_e_is(TableB("42")));
+    }
+
+    SECTION("none of value pointer")
+    {
+      p.e.push_back(std::make_shared<TableB>());
+      CHECK(p.e.back().lock() == nullptr);
+      CHECK_FALSE(p.none_of_e_is(p.e[1].lock()));
+      CHECK(p.none_of_e_is(std::make_shared<TableB>("42")));
+    }
+
+    SECTION("for each")
+    {
+      std::string x;
+      p.for_each_e([&x](const std::weak_ptr<TableB> &i) { x += i.lock()->name; });
+      CHECK(x == std::string("x") + "xx" + "xxx");
+    }
+
+    SECTION("find")
+    {
+      CHECK(p.find_in_e(p.e[1]) == p.e.begin() + 1);
+      // CHECK(p.find_in_e(nullptr) == p.e.end());
+    }
+
+    SECTION("find if")
+    {
+      CHECK(p.find_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "xx"; }) == p.e.begin() + 1);
+      CHECK(p.find_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name == "42"; }) == p.e.end());
+    }
+
+    SECTION("count")
+    {
+      CHECK(p.count_in_e(p.e[1]) == 1);
+      // CHECK(p.count_in_e(p.d[1]) == 0);
+    }
+
+    SECTION("count if")
+    {
+      CHECK(p.count_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() % 2 == 1; }) == 2);
+      CHECK(p.count_in_e_if([](const std::weak_ptr<TableB> &x) { return x.lock()->name.size() > 42; }) == 0);
+    }
+  }
+}
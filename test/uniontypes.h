@@ -1,531 +1,1658 @@
-#pragma once
-
-#include <vector>
-#include <string>
-#include <ostream>
-#include <istream>
-#include <memory>
-#include <array>
-#include <algorithm>
-#include <type_traits>
-
-namespace UnionTypes {
-
-template<typename T>
-struct AlwaysFalse : std::false_type {};
-
-struct A;
-struct B;
-struct AB;
-struct Root;
-
-template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
-  return l.lock() == r.lock();
-}
-
-template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
-  return l.lock() != r.lock();
-}
-
-struct A {
-  std::string name;
-
-  A() = default;
-  A(const std::string &name_)
-    : name(name_)
-  {}
-
-  friend bool operator==(const A&l, const A&r) {
-    return 
-      l.name == r.name;
-  }
-
-  friend bool operator!=(const A&l, const A&r) {
-    return 
-      l.name != r.name;
-  }
-};
-
-struct B {
-  std::int64_t size{0};
-
-  B() = default;
-  B(const std::int64_t &size_)
-    : size(size_)
-  {}
-
-  friend bool operator==(const B&l, const B&r) {
-    return 
-      l.size == r.size;
-  }
-
-  friend bool operator!=(const B&l, const B&r) {
-    return 
-      l.size != r.size;
-  }
-};
-
-struct AB {
-  AB() = default;
-  AB(const AB &o) { _clone(o); }
-  AB& operator=(const AB &o) { _destroy(); _clone(o); return *this; }
-
-  AB(const A &v)
-    : _A(new A(v))
-    , _selection(_A_selection)
-  {}
-  AB(A &&v)
-    : _A(new A(std::forward<A>(v)))
-    , _selection(_A_selection)
-  {}
-  AB & operator=(const A &v) {
-    _destroy();
-    _A = new A(v);
-    _selection = _A_selection;
-    return *this;
-  }
-  AB & operator=(A &&v) {
-    _destroy();
-    _A = new A(std::forward<A>(v));
-    _selection = _A_selection;
-    return *this;
-  }
-
-  AB(const B &v)
-    : _B(new B(v))
-    , _selection(_B_selection)
-  {}
-  AB(B &&v)
-    : _B(new B(std::forward<B>(v)))
-    , _selection(_B_selection)
-  {}
-  AB & operator=(const B &v) {
-    _destroy();
-    _B = new B(v);
-    _selection = _B_selection;
-    return *this;
-  }
-  AB & operator=(B &&v) {
-    _destroy();
-    _B = new B(std::forward<B>(v));
-    _selection = _B_selection;
-    return *this;
-  }
-
-  ~AB() {
-    _destroy();
-  }
-
-  bool is_Defined() const noexcept { return _selection != no_selection; }
-  void clear() { *this = AB(); }
-
-  bool is_A() const noexcept { return _selection == _A_selection; }
-  const A & as_A() const noexcept { return *_A; }
-  A & as_A() { return *_A; }
-  template<typename... Args> A & create_A(Args&&... args) {
-    return (*this = A(std::forward<Args>(args)...)).as_A();
-  }
-
-  bool is_B() const noexcept { return _selection == _B_selection; }
-  const B & as_B() const noexcept { return *_B; }
-  B & as_B() { return *_B; }
-  template<typename... Args> B & create_B(Args&&... args) {
-    return (*this = B(std::forward<Args>(args)...)).as_B();
-  }
-
-  friend bool operator==(const AB&ab, const A &o) noexcept  { return ab.is_A() && ab.as_A() == o; }
-  friend bool operator==(const A &o, const AB&ab) noexcept  { return ab.is_A() && o == ab.as_A(); }
-  friend bool operator!=(const AB&ab, const A &o) noexcept  { return !ab.is_A() || ab.as_A() != o; }
-  friend bool operator!=(const A &o, const AB&ab) noexcept  { return !ab.is_A() || o != ab.as_A(); }
-
-  friend bool operator==(const AB&ab, const B &o) noexcept  { return ab.is_B() && ab.as_B() == o; }
-  friend bool operator==(const B &o, const AB&ab) noexcept  { return ab.is_B() && o == ab.as_B(); }
-  friend bool operator!=(const AB&ab, const B &o) noexcept  { return !ab.is_B() || ab.as_B() != o; }
-  friend bool operator!=(const B &o, const AB&ab) noexcept  { return !ab.is_B() || o != ab.as_B(); }
-
-  bool operator==(const AB &o) const noexcept
-  {
-    if (this == &o)
-      return true;
-    if (_selection != o._selection)
-      return false;
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ return true;
-    case _A_selection: return *_A == *o._A;
-    case _B_selection: return *_B == *o._B;
-    }
-    return false; // without this line there is a msvc warning I do not understand.
-  }
-
-  bool operator!=(const AB &o) const noexcept
-  {
-    if (this == &o)
-      return false;
-    if (_selection != o._selection)
-      return true;
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ return false;
-    case _A_selection: return *_A != *o._A;
-    case _B_selection: return *_B != *o._B;
-    }
-    return false; // without this line there is a msvc warning I do not understand.
-  }
-
-private:
-  void _clone(const AB &o) noexcept
-  {
-     _selection = o._selection;
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ break;
-    case _A_selection: _A = new A(*o._A); break;
-    case _B_selection: _B = new B(*o._B); break;
-    }
-  }
-
-  void _destroy() noexcept {
-    switch(_selection) {
-    case no_selection: while(false); /* hack for coverage tool */ break;
-    case _A_selection: delete _A; break;
-    case _B_selection: delete _B; break;
-    }
-    no_value = nullptr;
-  }
-
-  union {
-    struct NoValue_t *no_value{nullptr};
-    A * _A;
-    B * _B;
-  };
-
-  enum Selection_t {
-    no_selection,
-    _A_selection,
-    _B_selection,
-  };
-
-  Selection_t _selection{no_selection};
-  unsigned int io_counter_{0};
-  friend struct Root_io;
-};
-
-struct Root {
-  A a;
-  B b;
-  std::shared_ptr<AB> c;
-  std::weak_ptr<AB> cw;
-  std::unique_ptr<AB> d;
-  std::vector<AB> e;
-  AB f;
-  std::unique_ptr<AB> empty;
-  std::unique_ptr<AB> null;
-
-  Root() = default;
-
-  friend bool operator==(const Root&l, const Root&r) {
-    return 
-      l.a == r.a
-      && l.b == r.b
-      && l.c == r.c
-      && l.cw == r.cw
-      && l.d == r.d
-      && l.e == r.e
-      && l.f == r.f
-      && l.empty == r.empty
-      && l.null == r.null;
-  }
-
-  friend bool operator!=(const Root&l, const Root&r) {
-    return 
-      l.a != r.a
-      || l.b != r.b
-      || l.c != r.c
-      || l.cw != r.cw
-      || l.d != r.d
-      || l.e != r.e
-      || l.f != r.f
-      || l.empty != r.empty
-      || l.null != r.null;
-  }
-
-  template<class T> void fill_e(const T &v) {
-    std::fill(e.begin(), e.end(), v);
-  }
-
-  template<class Generator> void generate_e(Generator gen) {
-    std::generate(e.begin(), e.end(), gen);
-  }
-
-  template<class T> std::vector<AB>::iterator remove_e(const T &v) {
-    return std::remove(e.begin(), e.end(), v);
-  }
-  template<class Pred> std::vector<AB>::iterator remove_e_if(Pred v) {
-    return std::remove_if(e.begin(), e.end(), v);
-  }
-
-  template<class T> void erase_e(const T &v) {
-    e.erase(remove_e(v));
-  }
-  template<class Pred> void erase_e_if(Pred v) {
-    e.erase(remove_e_if(v));
-  }
-
-  void reverse_e() {
-    std::reverse(e.begin(), e.end());
-  }
-
-  void rotate_e(std::vector<AB>::iterator i) {
-    std::rotate(e.begin(), i, e.end());
-  }
-
-  template<class Comp> void sort_e(Comp p) {
-    std::sort(e.begin(), e.end(), p);
-  }
-
-  template<class Comp> bool any_of_e(Comp p) {
-    return std::any_of(e.begin(), e.end(), p);
-  }
-  template<class T> bool any_of_e_is(const T &p) {
-    return any_of_e([&p](const AB &x) { return x == p; });
-  }
-
-  template<class Comp> bool all_of_e(Comp p) {
-    return std::all_of(e.begin(), e.end(), p);
-  }
-  template<class T> bool all_of_e_are(const T &p) {
-    return all_of_e([&p](const AB &x) { return x == p; });
-  }
-
-  template<class Comp> bool none_of_e(Comp p) {
-    return std::none_of(e.begin(), e.end(), p);
-  }
-  template<class T> bool none_of_e_is(const T &p) {
-    return none_of_e([&p](const AB &x) { return x == p; });
-  }
-
-  template<class Fn> Fn for_each_e(Fn p) {
-    return std::for_each(e.begin(), e.end(), p);
-  }
-
-  template<class T> std::vector<AB>::iterator find_in_e(const T &p) {
-    return std::find(e.begin(), e.end(), p);
-  }
-  template<class Comp> std::vector<AB>::iterator find_in_e_if(Comp p) {
-    return std::find_if(e.begin(), e.end(), p);
-  }
-
-  template<class T>   typename std::iterator_traits<std::vector<AB>::iterator>::difference_type count_in_e(const T &p) {
-    return std::count(e.begin(), e.end(), p);
-  }
-  template<class Comp>   typename std::iterator_traits<std::vector<AB>::iterator>::difference_type count_in_e_if(Comp p) {
-    return std::count_if(e.begin(), e.end(), p);
-  }
-};
-
-struct Root_io {
-private:
-  unsigned int AB_count_{0};
-  std::vector<std::shared_ptr<AB>> AB_references_;
-
-  template<typename T> void Write(std::ostream &, const T *) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &o, const T &v) {
-    o.write(reinterpret_cast<const char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::vector<T> &v) {
-    Write(o, v.size());
-    o.write(reinterpret_cast<const char *>(v.data()), sizeof(T) * v.size());
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::unique_ptr<T> &v) {
-    if (!v) {
-      o.write("\x0", 1);
-    } else {
-      o.write("\x1", 1);
-      Write(o, *v);
-    }
-  }
-
-  template<typename T> void Write(std::ostream &o, const std::shared_ptr<T> &v, unsigned int &counter) {
-    if (!v) {
-      o.write("\x0", 1);
-    } else if (v->io_counter_== 0) {
-      v->io_counter_ = ++counter;
-      o.write("\x1", 1);
-      Write(o, *v);
-    } else {
-      o.write("\x2", 1);
-      Write(o, v->io_counter_);
-    }
-  }
-
-  template<typename T> void Write(std::ostream &, const std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Write(std::ostream &, const std::weak_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  void Write(std::ostream &o, const std::string &v) {
-    Write(o, v.size());
-    o.write(v.data(), v.size());
-  }
-
-  template<typename T> void Read(std::istream &i, T &v) {
-    i.read(reinterpret_cast<char *>(&v), sizeof(T));
-  }
-
-  template<typename T> void Read(std::istream &i, std::unique_ptr<T> &v) {
-    char ref = 0;
-    i.read(&ref, 1);
-    if (ref == '\x1') {
-      v = std::unique_ptr<T>(new T);
-      Read(i, *v);
-    }
-  }
-
-  template<typename T> void Read(std::istream &, std::shared_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &, std::weak_ptr<T> &) {
-    static_assert(AlwaysFalse<T>::value, "Something not implemented");
-  }
-
-  template<typename T> void Read(std::istream &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache) {
-    char ref = 0;
-    s.read(&ref, 1);
-    if (ref == '\x1') {
-      v = std::make_shared<T>();
-      cache.push_back(v);
-      Read(s, *v);
-    } else if (ref == '\x2') {
-      unsigned int index = 0;
-      Read(s, index);
-      v = cache[index - 1];
-    }
-  }
-
-  template<typename T> void Read(std::istream &i, std::vector<T> &v) {
-    typename std::vector<T>::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(reinterpret_cast<char *>(v.data()), sizeof(T) * s);
-  }
-
-  void Read(std::istream &i, std::string &v) {
-    std::string::size_type s{0};
-    Read(i, s);
-    v.resize(s);
-    i.read(&v[0], s);
-  }
-
-  void Write(std::ostream &o, const A &v) {
-    Write(o, v.name);
-  }
-
-  void Read(std::istream &s, A &v) {
-    Read(s, v.name);
-  }
-
-  void Write(std::ostream &o, const AB &v) {
-    o.write(reinterpret_cast<const char*>(&v._selection), sizeof(AB::Selection_t));
-    switch(v._selection) {
-    case AB::no_selection: while(false); /* hack for coverage tool */ break;
-    case AB::_A_selection: Write(o, v.as_A()); break;
-    case AB::_B_selection: Write(o, v.as_B()); break;
-    }
-  }
-
-  void Write(std::ostream &o, const std::shared_ptr<AB> &v) {
-    Write(o, v, AB_count_);
-  }
-
-  void Write(std::ostream &o, const std::weak_ptr<AB> &v) {
-    Write(o, v.lock(), AB_count_);
-  }
-
-  void Write(std::ostream &o, const std::vector<AB> &v) {
-    Write(o, v.size());
-    for (const auto &entry : v)
-      Write(o, entry);
-  }
-
-  void Read(std::istream &i, AB &v) {
-    i.read(reinterpret_cast<char*>(&v._selection), sizeof(AB::Selection_t));
-    switch(v._selection) {
-    case AB::no_selection: while(false); /* hack for coverage tool */ break;
-    case AB::_A_selection: Read(i, v.create_A()); break;
-    case AB::_B_selection: Read(i, v.create_B()); break;
-    }
-  }
-
-  void Read(std::istream &s, std::shared_ptr<AB> &v) {
-    Read(s, v, AB_references_);
-  }
-
-  void Read(std::istream &s, std::weak_ptr<AB> &v) {
-    auto t = v.lock();
-    Read(s, t, AB_references_);
-    v = t;
-  }
-
-  void Read(std::istream &s, std::vector<AB> &v) {
-    auto size = v.size();
-    Read(s, size);
-    v.resize(size);
-    for (auto &entry : v)
-      Read(s, entry);
-  }
-
-  void Write(std::ostream &o, const Root &v) {
-    Write(o, v.a);
-    Write(o, v.b);
-    Write(o, v.c);
-    Write(o, v.cw);
-    Write(o, v.d);
-    Write(o, v.e);
-    Write(o, v.f);
-    Write(o, v.empty);
-    Write(o, v.null);
-  }
-
-  void Read(std::istream &s, Root &v) {
-    Read(s, v.a);
-    Read(s, v.b);
-    Read(s, v.c);
-    Read(s, v.cw);
-    Read(s, v.d);
-    Read(s, v.e);
-    Read(s, v.f);
-    Read(s, v.empty);
-    Read(s, v.null);
-  }
-
-public:
-  void WriteRoot(std::ostream &o, const Root &v) {
-
-    o.write("CORE", 4);
-    o.write("0.0", 3);
-    Write(o, v);
-  }
-
-  bool ReadRoot(std::istream &i, Root &v) {
-
-    std::string marker("0000");
-    i.read(&marker[0], 4);
-    if (marker != "CORE")
-      return false;
-    std::string version(3, '_');
-    i.read(&version[0], 3);
-    if (version != "0.0")
-      return false;
-    Read(i, v);
-    return true;
-  }
-
-};
-}
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <istream>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <unordered_map>
+#include <new>
+
+namespace UnionTypes {
+
+template<typename T>
+struct AlwaysFalse : std::false_type {};
+
+struct A;
+struct B;
+struct AB;
+struct Root;
+
+template<typename T> bool operator==(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
+  return l.lock() == r.lock();
+}
+
+template<typename T> bool operator!=(const std::weak_ptr<T> &l, const std::weak_ptr<T> &r) {
+  return l.lock() != r.lock();
+}
+
+struct A {
+  std::string name;
+
+  A() = default;
+  A(const std::string &name_)
+    : name(name_)
+  {}
+
+  friend bool operator==(const A&l, const A&r) {
+    return 
+      l.name == r.name;
+  }
+
+  friend bool operator!=(const A&l, const A&r) {
+    return 
+      l.name != r.name;
+  }
+};
+
+struct B {
+  std::int64_t size{0};
+
+  B() = default;
+  B(const std::int64_t &size_)
+    : size(size_)
+  {}
+
+  friend bool operator==(const B&l, const B&r) {
+    return 
+      l.size == r.size;
+  }
+
+  friend bool operator!=(const B&l, const B&r) {
+    return 
+      l.size != r.size;
+  }
+};
+
+struct AB {
+  AB() = default;
+  AB(const AB &o) { _clone(o); }
+  AB& operator=(const AB &o) {
+    if (this != &o)
+      *this = AB(o);
+    return *this;
+  }
+  AB(AB &&o) noexcept { _move(o); }
+  AB& operator=(AB &&o) noexcept {
+    if (this != &o) {
+      _destroy();
+      _move(o);
+    }
+    return *this;
+  }
+
+  AB(const A &v)
+    : _selection(_A_selection)
+  { _construct<A>(v); }
+  AB(A &&v)
+    : _selection(_A_selection)
+  { _construct<A>(std::forward<A>(v)); }
+  AB & operator=(const A &v) {
+    create_A(v);
+    return *this;
+  }
+  AB & operator=(A &&v) {
+    create_A(std::forward<A>(v));
+    return *this;
+  }
+
+  AB(const B &v)
+    : _selection(_B_selection)
+  { _construct<B>(v); }
+  AB(B &&v)
+    : _selection(_B_selection)
+  { _construct<B>(std::forward<B>(v)); }
+  AB & operator=(const B &v) {
+    create_B(v);
+    return *this;
+  }
+  AB & operator=(B &&v) {
+    create_B(std::forward<B>(v));
+    return *this;
+  }
+
+  ~AB() {
+    _destroy();
+  }
+
+  bool is_Defined() const noexcept { return _selection != no_selection; }
+  void clear() { *this = AB(); }
+  void swap(AB &o) noexcept {
+    AB t(std::move(o));
+    o = std::move(*this);
+    *this = std::move(t);
+  }
+  friend void swap(AB &l, AB &r) noexcept { l.swap(r); }
+
+  bool is_A() const noexcept { return _selection == _A_selection; }
+  const A & as_A() const noexcept { return *_get<A>(); }
+  A & as_A() { return *_get<A>(); }
+  template<typename... Args> A & create_A(Args&&... args) {
+    _replace<A>(std::forward<Args>(args)...);
+    _selection = _A_selection;
+    return as_A();
+  }
+
+  bool is_B() const noexcept { return _selection == _B_selection; }
+  const B & as_B() const noexcept { return *_get<B>(); }
+  B & as_B() { return *_get<B>(); }
+  template<typename... Args> B & create_B(Args&&... args) {
+    _replace<B>(std::forward<Args>(args)...);
+    _selection = _B_selection;
+    return as_B();
+  }
+
+  friend bool operator==(const AB&ab, const A &o) noexcept  { return ab.is_A() && ab.as_A() == o; }
+  friend bool operator==(const A &o, const AB&ab) noexcept  { return ab.is_A() && o == ab.as_A(); }
+  friend bool operator!=(const AB&ab, const A &o) noexcept  { return !ab.is_A() || ab.as_A() != o; }
+  friend bool operator!=(const A &o, const AB&ab) noexcept  { return !ab.is_A() || o != ab.as_A(); }
+
+  friend bool operator==(const AB&ab, const B &o) noexcept  { return ab.is_B() && ab.as_B() == o; }
+  friend bool operator==(const B &o, const AB&ab) noexcept  { return ab.is_B() && o == ab.as_B(); }
+  friend bool operator!=(const AB&ab, const B &o) noexcept  { return !ab.is_B() || ab.as_B() != o; }
+  friend bool operator!=(const B &o, const AB&ab) noexcept  { return !ab.is_B() || o != ab.as_B(); }
+
+  bool operator==(const AB &o) const noexcept
+  {
+    if (this == &o)
+      return true;
+    if (_selection != o._selection)
+      return false;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return true;
+    case _A_selection: return *_get<A>() == *o._get<A>();
+    case _B_selection: return *_get<B>() == *o._get<B>();
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+  bool operator!=(const AB &o) const noexcept
+  {
+    if (this == &o)
+      return false;
+    if (_selection != o._selection)
+      return true;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ return false;
+    case _A_selection: return *_get<A>() != *o._get<A>();
+    case _B_selection: return *_get<B>() != *o._get<B>();
+    }
+    return false; // without this line there is a msvc warning I do not understand.
+  }
+
+private:
+  void _clone(const AB &o) noexcept
+  {
+     _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _A_selection: _construct<A>(*o._get<A>()); break;
+    case _B_selection: _construct<B>(*o._get<B>()); break;
+    }
+  }
+
+  void _move(AB &o) noexcept
+  {
+    _selection = o._selection;
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _A_selection: _take<A>(o); break;
+    case _B_selection: _take<B>(o); break;
+    }
+    o._selection = no_selection;
+  }
+
+  void _destroy() noexcept {
+    switch(_selection) {
+    case no_selection: while(false); /* hack for coverage tool */ break;
+    case _A_selection: _free<A>(); break;
+    case _B_selection: _free<B>(); break;
+    }
+    _selection = no_selection;
+  }
+
+  template<typename T> using _inline = std::integral_constant<bool, sizeof(T) <= 16 && std::is_nothrow_move_constructible<T>::value>;
+  template<typename T> using _held = typename std::conditional<_inline<T>::value, T, T *>::type;
+  template<typename T> struct _slot {
+    alignas(_held<T>) unsigned char bytes[sizeof(_held<T>)];
+  };
+
+  template<typename T> T *_get() noexcept { return _get<T>(_inline<T>()); }
+  template<typename T> const T *_get() const noexcept { return const_cast<AB *>(this)->_get<T>(); }
+  template<typename T> T *_get(std::true_type) noexcept { return reinterpret_cast<T *>(&_storage); }
+  template<typename T> T *_get(std::false_type) noexcept { return *reinterpret_cast<T **>(&_storage); }
+
+  template<typename T, typename... Args> void _construct(Args &&... args) {
+    _place<T>(_inline<T>(), std::forward<Args>(args)...);
+  }
+  template<typename T, typename... Args> void _place(std::true_type, Args &&... args) {
+    new (&_storage) T(std::forward<Args>(args)...);
+  }
+  template<typename T, typename... Args> void _place(std::false_type, Args &&... args) {
+    new (&_storage) T *(new T(std::forward<Args>(args)...));
+  }
+
+  // builds the new value before the old one is destroyed, the arguments may refer into it
+  template<typename T, typename... Args> void _replace(Args &&... args) {
+    _replace<T>(_inline<T>(), std::forward<Args>(args)...);
+  }
+  template<typename T, typename... Args> void _replace(std::true_type, Args &&... args) {
+    T v(std::forward<Args>(args)...);
+    _destroy();
+    new (&_storage) T(std::move(v));
+  }
+  template<typename T, typename... Args> void _replace(std::false_type, Args &&... args) {
+    T *v = new T(std::forward<Args>(args)...);
+    _destroy();
+    new (&_storage) T *(v);
+  }
+
+  template<typename T> void _free() noexcept { _free<T>(_inline<T>()); }
+  template<typename T> void _free(std::true_type) noexcept { _get<T>()->~T(); }
+  template<typename T> void _free(std::false_type) noexcept { delete _get<T>(); }
+
+  template<typename T> void _take(AB &o) noexcept { _take<T>(o, _inline<T>()); }
+  template<typename T> void _take(AB &o, std::true_type) noexcept {
+    new (&_storage) T(std::move(*o._get<T>()));
+    o._free<T>();
+  }
+  template<typename T> void _take(AB &o, std::false_type) noexcept {
+    new (&_storage) T *(o._get<T>());
+  }
+
+  union {
+    _slot<A> _A;
+    _slot<B> _B;
+  } _storage;
+
+  enum Selection_t {
+    no_selection,
+    _A_selection,
+    _B_selection,
+  };
+
+  Selection_t _selection{no_selection};
+  friend struct Root_io;
+};
+
+struct Root {
+  A a;
+  B b;
+  std::shared_ptr<AB> c;
+  std::weak_ptr<AB> cw;
+  std::unique_ptr<AB> d;
+  std::vector<AB> e;
+  AB f;
+  std::unique_ptr<AB> empty;
+  std::unique_ptr<AB> null;
+
+  Root() = default;
+
+  friend bool operator==(const Root&l, const Root&r) {
+    return 
+      l.a == r.a
+      && l.b == r.b
+      && l.c == r.c
+      && l.cw == r.cw
+      && l.d == r.d
+      && l.e == r.e
+      && l.f == r.f
+      && l.empty == r.empty
+      && l.null == r.null;
+  }
+
+  friend bool operator!=(const Root&l, const Root&r) {
+    return 
+      l.a != r.a
+      || l.b != r.b
+      || l.c != r.c
+      || l.cw != r.cw
+      || l.d != r.d
+      || l.e != r.e
+      || l.f != r.f
+      || l.empty != r.empty
+      || l.null != r.null;
+  }
+
+  template<class T> void fill_e(const T &v) {
+    std::fill(e.begin(), e.end(), v);
+  }
+
+  template<class Generator> void generate_e(Generator gen) {
+    std::generate(e.begin(), e.end(), gen);
+  }
+
+  template<class T> std::vector<AB>::iterator remove_e(const T &v) {
+    return std::remove(e.begin(), e.end(), v);
+  }
+  template<class Pred> std::vector<AB>::iterator remove_e_if(Pred v) {
+    return std::remove_if(e.begin(), e.end(), v);
+  }
+
+  template<class T> void erase_e(const T &v) {
+    e.erase(remove_e(v));
+  }
+  template<class Pred> void erase_e_if(Pred v) {
+    e.erase(remove_e_if(v));
+  }
+
+  void reverse_e() {
+    std::reverse(e.begin(), e.end());
+  }
+
+  void rotate_e(std::vector<AB>::iterator i) {
+    std::rotate(e.begin(), i, e.end());
+  }
+
+  template<class Comp> void sort_e(Comp p) {
+    std::sort(e.begin(), e.end(), p);
+  }
+
+  template<class Comp> bool any_of_e(Comp p) {
+    return std::any_of(e.begin(), e.end(), p);
+  }
+  template<class T> bool any_of_e_is(const T &p) {
+    return any_of_e([&p](const AB &x) { return x == p; });
+  }
+
+  template<class Comp> bool all_of_e(Comp p) {
+    return std::all_of(e.begin(), e.end(), p);
+  }
+  template<class T> bool all_of_e_are(const T &p) {
+    return all_of_e([&p](const AB &x) { return x == p; });
+  }
+
+  template<class Comp> bool none_of_e(Comp p) {
+    return std::none_of(e.begin(), e.end(), p);
+  }
+  template<class T> bool none_of_e_is(const T &p) {
+    return none_of_e([&p](const AB &x) { return x == p; });
+  }
+
+  template<class Fn> Fn for_each_e(Fn p) {
+    return std::for_each(e.begin(), e.end(), p);
+  }
+
+  template<class T> std::vector<AB>::iterator find_in_e(const T &p) {
+    return std::find(e.begin(), e.end(), p);
+  }
+  template<class Comp> std::vector<AB>::iterator find_in_e_if(Comp p) {
+    return std::find_if(e.begin(), e.end(), p);
+  }
+
+  template<class T>   typename std::iterator_traits<std::vector<AB>::iterator>::difference_type count_in_e(const T &p) {
+    return std::count(e.begin(), e.end(), p);
+  }
+  template<class Comp>   typename std::iterator_traits<std::vector<AB>::iterator>::difference_type count_in_e_if(Comp p) {
+    return std::count_if(e.begin(), e.end(), p);
+  }
+};
+
+struct StringView {
+  StringView() = default;
+  StringView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::string str() const { return size_ == 0 ? std::string() : std::string(data_, size_); }
+
+  friend bool operator==(const StringView &l, const std::string &r) {
+    return l.size_ == r.size() && (l.size_ == 0 || std::memcmp(l.data_, r.data(), l.size_) == 0);
+  }
+  friend bool operator!=(const StringView &l, const std::string &r) { return !(l == r); }
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+template<typename T> struct ArrayView {
+  ArrayView() = default;
+  ArrayView(const char *data, std::size_t count) : data_(data), count_(count) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  T operator[](std::size_t index) const {
+    T v;
+    std::memcpy(static_cast<void *>(&v), data_ + index * sizeof(T), sizeof(T));
+    return v;
+  }
+
+  struct iterator {
+    const ArrayView *view;
+    std::size_t index;
+
+    T operator*() const { return (*view)[index]; }
+    iterator &operator++() { ++index; return *this; }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0}; }
+  iterator end() const { return iterator{this, count_}; }
+
+private:
+  const char *data_{nullptr};
+  std::size_t count_{0};
+};
+
+// elements are found by passing the ones in front of them, or through the offset index of --index-vectors;
+// the offsets passed for indexing are kept, so indexing the same list again takes constant time
+template<typename IO, typename E, typename Encoded> struct ListView {
+  ListView() = default;
+  ListView(const char *data, std::size_t size, std::size_t first, std::size_t count, const char *index = nullptr)
+    : data_(data), size_(size), first_(first), count_(count), index_(index) {}
+
+  std::size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  E operator[](std::size_t index) const {
+    return At(Find(index));
+  }
+
+  struct iterator {
+    const ListView *view;
+    std::size_t index;
+    std::size_t pos;
+
+    E operator*() const { return view->At(pos); }
+    iterator &operator++() {
+      ++index;
+      pos = view->index_ ? view->Find(index) : view->Next(pos);
+      // a list that cannot be passed ends where it broke
+      if (pos >= view->size_)
+        index = view->count_;
+      return *this;
+    }
+    bool operator==(const iterator &o) const { return index == o.index; }
+    bool operator!=(const iterator &o) const { return index != o.index; }
+  };
+  iterator begin() const { return iterator{this, 0, index_ ? Find(0) : first_}; }
+  iterator end() const { return iterator{this, count_, size_}; }
+
+  // where the list ends, the size of the data if it cannot be passed
+  std::size_t EndOffset() const {
+    if (count_ == 0)
+      return first_;
+    if (index_)
+      return Next(Find(count_ - 1));
+    auto pos = first_;
+    for (std::size_t n = 0; n < count_ && pos < size_; ++n)
+      pos = Next(pos);
+    return pos;
+  }
+
+private:
+  std::size_t Next(std::size_t pos) const {
+    if (pos >= size_)
+      return size_;
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false, {}};
+    io.Skip(i, static_cast<const Encoded *>(nullptr));
+    return i.failed ? size_ : i.pos;
+  }
+
+  std::size_t Find(std::size_t index) const {
+    if (index >= count_)
+      return size_;
+    if (index_) {
+      IO io;
+      typename IO::InputBuffer i{index_, count_ * sizeof(std::uint64_t), index * sizeof(std::uint64_t), false, {}};
+      std::uint64_t offset = 0;
+      io.ReadValues(i, &offset, 1);
+      return i.failed || offset >= size_ ? size_ : static_cast<std::size_t>(offset);
+    }
+    if (offsets_.empty())
+      offsets_.push_back(first_);
+    while (offsets_.size() <= index && offsets_.back() < size_)
+      offsets_.push_back(Next(offsets_.back()));
+    return offsets_.size() > index ? offsets_[index] : size_;
+  }
+
+  E At(std::size_t pos) const {
+    if (pos >= size_)
+      return E();
+    IO io;
+    typename IO::InputBuffer i{data_, size_, pos, false, {}};
+    return io.MakeView(i, static_cast<const Encoded *>(nullptr));
+  }
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  std::size_t first_{0};
+  std::size_t count_{0};
+  const char *index_{nullptr};
+  mutable std::vector<std::size_t> offsets_;
+};
+struct AView;
+struct ABView;
+struct RootView;
+
+struct Root_io {
+  friend struct RootWriter;
+
+  friend struct AView;
+  friend struct ABView;
+  friend struct RootView;
+  template<typename, typename, typename> friend struct ListView;
+
+private:
+  std::uint64_t error_offset_{0};
+
+  struct WriteReferences {
+    std::unordered_map<const AB *, unsigned int> AB_ids;
+  };
+
+  struct ReadReferences {
+    std::vector<std::shared_ptr<AB>> AB_objects;
+    std::uint32_t AB_count{0};
+    std::uint64_t AB_verified{0};
+  };
+
+  struct OutputBuffer {
+    std::vector<char> &buffer;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(std::ostream &o, const char *d, std::size_t s) const {
+    o.write(d, s);
+  }
+
+  // counts the written bytes itself, tellp() does not work for every stream
+  struct OutputStream {
+    std::ostream &stream;
+    std::uint64_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputStream &o, const char *d, std::size_t s) const {
+    o.stream.write(d, s);
+    o.size += s;
+  }
+
+  void WriteBytes(OutputBuffer &o, const char *d, std::size_t s) const {
+    if (o.buffer.size() - o.size < s)
+      o.buffer.resize(std::max(2 * o.buffer.size(), o.size + s));
+    if (s != 0)
+      std::memcpy(o.buffer.data() + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputSpan {
+    char *data;
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputSpan &o, const char *d, std::size_t s) const {
+    if (s != 0)
+      std::memcpy(o.data + o.size, d, s);
+    o.size += s;
+  }
+
+  struct OutputCounter {
+    std::size_t size;
+    WriteReferences references;
+  };
+
+  void WriteBytes(OutputCounter &o, const char *, std::size_t s) const {
+    o.size += s;
+  }
+
+  template<typename O, typename T> void Write(O &, const T *) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &o, const T &v) const {
+    WriteBytes(o, reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template<typename O, typename T> void WriteValues(O &o, const T *v, std::size_t count) const {
+    WriteBytes(o, reinterpret_cast<const char *>(v), sizeof(T) * count);
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::vector<T> &v) const {
+    Write(o, v.size());
+    WriteValues(o, v.data(), v.size());
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::unique_ptr<T> &v) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+    } else {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &o, const std::shared_ptr<T> &v, std::unordered_map<const T *, unsigned int> &ids) const {
+    if (!v) {
+      WriteBytes(o, "\x0", 1);
+      return;
+    }
+    const auto entry = ids.emplace(v.get(), static_cast<unsigned int>(ids.size() + 1));
+    if (entry.second) {
+      WriteBytes(o, "\x1", 1);
+      Write(o, *v);
+    } else {
+      WriteBytes(o, "\x2", 1);
+      Write(o, entry.first->second);
+    }
+  }
+
+  template<typename O, typename T> void Write(O &, const std::shared_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O, typename T> void Write(O &, const std::weak_ptr<T> &) const {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename O> void Write(O &o, const std::string &v) const {
+    Write(o, v.size());
+    WriteBytes(o, v.data(), v.size());
+  }
+
+  struct InputBuffer {
+    const char *data;
+    std::size_t size;
+    std::size_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  // positions are stream positions, size is the end of a stream that can seek or the maximum
+  struct InputStream {
+    std::istream &stream;
+    std::uint64_t size;
+    std::uint64_t pos;
+    bool failed;
+    ReadReferences references;
+  };
+
+  static InputStream MakeInput(std::istream &i) {
+    const auto pos = i.tellg();
+    InputStream s{i, std::numeric_limits<std::uint64_t>::max(), 0, false, {}};
+    if (pos == std::istream::pos_type(-1))
+      return s;
+    s.pos = static_cast<std::uint64_t>(pos);
+    const auto end = i.seekg(0, std::ios::end).tellg();
+    if (end != std::istream::pos_type(-1) && end >= pos)
+      s.size = static_cast<std::uint64_t>(end);
+    i.clear();
+    i.seekg(pos);
+    return s;
+  }
+
+  void Fail(InputStream &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+    i.stream.setstate(std::ios::failbit);
+  }
+
+  void Fail(InputBuffer &i) {
+    if (!i.failed)
+      error_offset_ = i.pos;
+    i.failed = true;
+    i.pos = i.size;
+  }
+
+  template<typename I> void Fail(I &i) {
+    i.failed = true;
+  }
+
+  void ReadBytes(InputStream &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s || !i.stream.read(d, s)) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    i.pos += s;
+  }
+
+  void ReadBytes(InputBuffer &i, char *d, std::size_t s) {
+    if (i.size - i.pos < s) {
+      Fail(i);
+      std::memset(d, 0, s);
+      return;
+    }
+    if (s != 0)
+      std::memcpy(d, i.data + i.pos, s);
+    i.pos += s;
+  }
+
+  bool Failed(InputStream &i) {
+    return i.failed;
+  }
+
+  bool Failed(InputBuffer &i) {
+    return i.failed;
+  }
+
+  bool Available(InputStream &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  bool Available(InputBuffer &i, std::size_t count, std::size_t size) {
+    if (count <= (i.size - i.pos) / size)
+      return true;
+    Fail(i);
+    return false;
+  }
+
+  // bytes known to follow, 0 for a stream that cannot tell its end
+  static std::uint64_t Remaining(const InputStream &i) {
+    return i.size == std::numeric_limits<std::uint64_t>::max() ? 0 : i.size - i.pos;
+  }
+
+  static std::uint64_t Remaining(const InputBuffer &i) {
+    return i.size - i.pos;
+  }
+
+  template<typename I, typename T> void Read(I &i, T &v) {
+    ReadBytes(i, reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template<typename I, typename T> void ReadValues(I &i, T *v, std::size_t count) {
+    ReadBytes(i, reinterpret_cast<char *>(v), sizeof(T) * count);
+  }
+
+  template<typename I, typename T> void Read(I &i, std::unique_ptr<T> &v) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      v = std::unique_ptr<T>(new T);
+      Read(i, *v);
+    } else {
+      if (ref != '\0')
+        Fail(i);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &, std::shared_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &, std::weak_ptr<T> &) {
+    static_assert(AlwaysFalse<T>::value, "Something not implemented");
+  }
+
+  template<typename I, typename T> void Read(I &s, std::shared_ptr<T> &v, std::vector<std::shared_ptr<T>> &cache, std::uint32_t count) {
+    char ref = 0;
+    ReadBytes(s, &ref, 1);
+    if (ref == '\x1') {
+      // every object takes at least a byte, a count larger than the input left is no reason to allocate
+      if (cache.empty())
+        cache.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(count, Remaining(s))));
+      v = std::make_shared<T>();
+      cache.push_back(v);
+      Read(s, *v);
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(s, index);
+      if (index == 0 || index > cache.size()) {
+        Fail(s);
+        v.reset();
+      } else {
+        v = cache[index - 1];
+      }
+    } else {
+      if (ref != '\0')
+        Fail(s);
+      v.reset();
+    }
+  }
+
+  template<typename I, typename T> void Read(I &i, std::vector<T> &v) {
+    typename std::vector<T>::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, sizeof(T)))
+      return;
+    v.resize(s);
+    ReadValues(i, v.data(), s);
+  }
+
+  template<typename I> void Read(I &i, std::string &v) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    v.resize(s);
+    ReadBytes(i, &v[0], s);
+  }
+
+  template<typename O> void Write(O &o, const A &v) const {
+    Write(o, v.name);
+  }
+
+  template<typename I> void Read(I &s, A &v) {
+    Read(s, v.name);
+  }
+
+  template<typename O> void Write(O &o, const AB &v) const {
+    Write(o, v._selection);
+    switch(v._selection) {
+    case AB::no_selection: while(false); /* hack for coverage tool */ break;
+    case AB::_A_selection: Write(o, v.as_A()); break;
+    case AB::_B_selection: Write(o, v.as_B()); break;
+    }
+  }
+
+  template<typename O> void Write(O &o, const std::shared_ptr<AB> &v) const {
+    Write(o, v, o.references.AB_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::weak_ptr<AB> &v) const {
+    Write(o, v.lock(), o.references.AB_ids);
+  }
+
+  template<typename O> void Write(O &o, const std::vector<AB> &v) const {
+    Write(o, v.size());
+    for (const auto &entry : v)
+      Write(o, entry);
+  }
+
+  template<typename I> void Read(I &i, AB &v) {
+    std::underlying_type<AB::Selection_t>::type raw = 0;
+    Read(i, raw);
+    const auto value = static_cast<std::uint64_t>(raw);
+    if (value > 2) {
+      v.clear();
+      Fail(i);
+      return;
+    }
+    switch(static_cast<AB::Selection_t>(value)) {
+    case AB::no_selection: v.clear(); break;
+    case AB::_A_selection: Read(i, v.create_A()); break;
+    case AB::_B_selection: Read(i, v.create_B()); break;
+    }
+  }
+
+  template<typename I> void Read(I &s, std::shared_ptr<AB> &v) {
+    Read(s, v, s.references.AB_objects, s.references.AB_count);
+  }
+
+  template<typename I> void Read(I &s, std::weak_ptr<AB> &v) {
+    auto t = v.lock();
+    Read(s, t, s.references.AB_objects, s.references.AB_count);
+    v = t;
+  }
+
+  template<typename I> void Read(I &s, std::vector<AB> &v) {
+    auto size = v.size();
+    Read(s, size);
+    if (!Available(s, size, 1))
+      return;
+    v.resize(size);
+    for (auto &entry : v)
+      Read(s, entry);
+  }
+
+  template<typename O> void Write(O &o, const Root &v) const {
+    Write(o, v.a);
+    Write(o, v.b);
+    Write(o, v.c);
+    Write(o, v.cw);
+    Write(o, v.d);
+    Write(o, v.e);
+    Write(o, v.f);
+    Write(o, v.empty);
+    Write(o, v.null);
+  }
+
+  template<typename I> void Read(I &s, Root &v) {
+    Read(s, v.a);
+    Read(s, v.b);
+    Read(s, v.c);
+    Read(s, v.cw);
+    Read(s, v.d);
+    Read(s, v.e);
+    Read(s, v.f);
+    Read(s, v.empty);
+    Read(s, v.null);
+  }
+
+  template<typename O> void WriteHeader(O &o) const {
+    WriteBytes(o, "CORE\x01", 5);
+    WriteBytes(o, "0.0", 3);
+    const std::uint32_t counts[1] = {};
+    WriteValues(o, counts, 1);
+  }
+
+  template<typename I> bool ReadHeader(I &i) {
+    char marker[5];
+    error_offset_ = 0;
+    ReadBytes(i, marker, 5);
+    if (std::memcmp(marker, "CORE\x01", 5) != 0) {
+      Fail(i);
+      return false;
+    }
+    char version[3];
+    ReadBytes(i, version, 3);
+    if (std::memcmp(version, "0.0", 3) != 0)
+      return false;
+    std::uint32_t counts[1] = {};
+    ReadValues(i, counts, 1);
+    i.references.AB_count = counts[0];
+    return !Failed(i) && Available(i, std::size_t(counts[0]), 1);
+  }
+
+  void PatchHeader(char *header, const WriteReferences &references) const {
+    const std::uint32_t counts[1] = {
+      static_cast<std::uint32_t>(references.AB_ids.size()),
+    };
+    std::memcpy(header + 8, counts, sizeof(counts));
+  }
+
+  void PatchHeader(std::ostream &o, std::ostream::pos_type start, const WriteReferences &references) const {
+    const auto end = o.tellp();
+    if (start == std::ostream::pos_type(-1) || end == std::ostream::pos_type(-1))
+      return;
+    char header[12];
+    PatchHeader(header, references);
+    o.seekp(start + std::streamoff(8));
+    o.write(header + 8, 4);
+    o.seekp(end);
+  }
+
+  template<typename O> void WritePaddedSize(O &o, std::size_t v) const {
+    Write(o, v);
+  }
+
+  std::uint64_t ReadSelection(InputBuffer &i, const AB *) {
+    std::underlying_type<AB::Selection_t>::type raw = 0;
+    Read(i, raw);
+    const auto value = static_cast<std::uint64_t>(raw);
+    if (value > 2)
+      Fail(i);
+    return value;
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void SkipEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Skip(InputBuffer &i, const std::vector<std::string> *) {
+    SkipEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Skip(i, static_cast<const T *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      Skip(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+    }
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::weak_ptr<T> *) {
+    Skip(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Skip(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    SkipEach(i, static_cast<const std::weak_ptr<T> *>(nullptr));
+  }
+
+  StringView MakeView(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return StringView();
+    i.pos += s;
+    return StringView(i.data + i.pos - s, s);
+  }
+  void Skip(InputBuffer &i, const A *) {
+    Skip(i, static_cast<const std::string *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<A> *) {
+    SkipEach(i, static_cast<const A *>(nullptr));
+  }
+
+  AView MakeView(InputBuffer &i, const A *);
+  AView MakeView(InputBuffer &i, const std::unique_ptr<A> *);
+
+  void Skip(InputBuffer &i, const AB *) {
+    switch (ReadSelection(i, static_cast<const AB *>(nullptr))) {
+    case 1: Skip(i, static_cast<const A *>(nullptr)); break;
+    case 2: Skip(i, static_cast<const B *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Skip(InputBuffer &i, const std::vector<AB> *) {
+    SkipEach(i, static_cast<const AB *>(nullptr));
+  }
+
+  ABView MakeView(InputBuffer &i, const AB *);
+  ABView MakeView(InputBuffer &i, const std::unique_ptr<AB> *);
+
+  void Skip(InputBuffer &i, const Root *) {
+    Skip(i, static_cast<const A *>(nullptr));
+    Skip(i, static_cast<const B *>(nullptr));
+    Skip(i, static_cast<const std::shared_ptr<AB> *>(nullptr));
+    Skip(i, static_cast<const std::weak_ptr<AB> *>(nullptr));
+    Skip(i, static_cast<const std::unique_ptr<AB> *>(nullptr));
+    Skip(i, static_cast<const std::vector<AB> *>(nullptr));
+    Skip(i, static_cast<const AB *>(nullptr));
+    Skip(i, static_cast<const std::unique_ptr<AB> *>(nullptr));
+    Skip(i, static_cast<const std::unique_ptr<AB> *>(nullptr));
+  }
+
+  void Skip(InputBuffer &i, const std::vector<Root> *) {
+    SkipEach(i, static_cast<const Root *>(nullptr));
+  }
+
+  RootView MakeView(InputBuffer &i, const Root *);
+  RootView MakeView(InputBuffer &i, const std::unique_ptr<Root> *);
+
+  template<typename T> void Verify(InputBuffer &i, const T *) {
+    T v;
+    Read(i, v);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<T> *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (Available(i, s, sizeof(T)))
+      i.pos += s * sizeof(T);
+  }
+
+  template<typename T> void VerifyEach(InputBuffer &i, const T *) {
+    std::size_t s{0};
+    Read(i, s);
+    if (!Available(i, s, 1))
+      return;
+    for (std::size_t n = 0; n < s && !i.failed; ++n)
+      Verify(i, static_cast<const T *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::string *) {
+    std::string::size_type s{0};
+    Read(i, s);
+    if (Available(i, s, 1))
+      i.pos += s;
+  }
+
+  void Verify(InputBuffer &i, const std::vector<std::string> *) {
+    VerifyEach(i, static_cast<const std::string *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::unique_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1')
+      Verify(i, static_cast<const T *>(nullptr));
+    else if (ref != '\0')
+      Fail(i);
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::unique_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::unique_ptr<T> *>(nullptr));
+  }
+
+  static std::uint64_t &Verified(InputBuffer &i, const AB *) {
+    return i.references.AB_verified;
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::shared_ptr<T> *) {
+    char ref = 0;
+    ReadBytes(i, &ref, 1);
+    if (ref == '\x1') {
+      ++Verified(i, static_cast<const T *>(nullptr));
+      Verify(i, static_cast<const T *>(nullptr));
+    } else if (ref == '\x2') {
+      unsigned int index = 0;
+      Read(i, index);
+      if (index == 0 || index > Verified(i, static_cast<const T *>(nullptr)))
+        Fail(i);
+    } else if (ref != '\0') {
+      Fail(i);
+    }
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::weak_ptr<T> *) {
+    Verify(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::shared_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  template<typename T> void Verify(InputBuffer &i, const std::vector<std::weak_ptr<T>> *) {
+    VerifyEach(i, static_cast<const std::shared_ptr<T> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const A *) {
+    Verify(i, static_cast<const std::string *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<A> *) {
+    VerifyEach(i, static_cast<const A *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const B *) {
+    if (Available(i, 1, sizeof(B)))
+      i.pos += sizeof(B);
+  }
+
+  void Verify(InputBuffer &i, const AB *) {
+    switch (ReadSelection(i, static_cast<const AB *>(nullptr))) {
+    case 1: Verify(i, static_cast<const A *>(nullptr)); break;
+    case 2: Verify(i, static_cast<const B *>(nullptr)); break;
+    case 0: break;
+    default: Fail(i); break;
+    }
+  }
+
+  void Verify(InputBuffer &i, const std::vector<AB> *) {
+    VerifyEach(i, static_cast<const AB *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const Root *) {
+    Verify(i, static_cast<const A *>(nullptr));
+    Verify(i, static_cast<const B *>(nullptr));
+    Verify(i, static_cast<const std::shared_ptr<AB> *>(nullptr));
+    Verify(i, static_cast<const std::weak_ptr<AB> *>(nullptr));
+    Verify(i, static_cast<const std::unique_ptr<AB> *>(nullptr));
+    Verify(i, static_cast<const std::vector<AB> *>(nullptr));
+    Verify(i, static_cast<const AB *>(nullptr));
+    Verify(i, static_cast<const std::unique_ptr<AB> *>(nullptr));
+    Verify(i, static_cast<const std::unique_ptr<AB> *>(nullptr));
+  }
+
+  void Verify(InputBuffer &i, const std::vector<Root> *) {
+    VerifyEach(i, static_cast<const Root *>(nullptr));
+  }
+
+public:
+  std::uint64_t ErrorOffset() const {
+    return error_offset_;
+  }
+
+  void WriteRoot(std::ostream &o, const Root &v) const {
+    const auto start = o.tellp();
+
+    OutputStream s{o, 0, {}};
+    WriteHeader(s);
+    Write(s, v);
+    PatchHeader(o, start, s.references);
+  }
+
+  void WriteRoot(std::vector<char> &b, const Root &v) const {
+    const auto start = b.size();
+
+    OutputBuffer o{b, b.size(), {}};
+    WriteHeader(o);
+    Write(o, v);
+    b.resize(o.size);
+    PatchHeader(b.data() + start, o.references);
+  }
+
+  bool ReadRoot(std::istream &stream, Root &v) {
+
+    auto i = MakeInput(stream);
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ReadRoot(const char *data, std::size_t size, Root &v) {
+
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Read(i, v);
+    return !i.failed;
+  }
+
+  bool ViewRoot(const char *data, std::size_t size, RootView &v);
+
+  bool VerifyRoot(const char *data, std::size_t size) {
+    InputBuffer i{data, size, 0, false, {}};
+    if (!ReadHeader(i))
+      return false;
+    Verify(i, static_cast<const Root *>(nullptr));
+    if (!i.failed && i.pos != i.size)
+      Fail(i);
+    return !i.failed;
+  }
+
+  std::size_t SerializedSize(const A &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  static constexpr std::size_t SerializedSize(const B &) {
+    return sizeof(B);
+  }
+
+  std::size_t SerializedSize(const AB &v) const {
+    OutputCounter c{0, {}};
+    Write(c, v);
+    return c.size;
+  }
+
+  std::size_t SerializedSize(const Root &v) const {
+    OutputCounter c{0, {}};
+    WriteHeader(c);
+    Write(c, v);
+    return c.size;
+  }
+
+};
+
+struct AView {
+  AView() = default;
+  AView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  StringView name() const;
+
+private:
+  friend struct Root_io;
+
+  Root_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[1]{};
+  mutable std::size_t known_{0};
+};
+
+struct ABView {
+  ABView() = default;
+  ABView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  bool is_Defined() const;
+  bool is_A() const;
+  AView as_A() const;
+  bool is_B() const;
+  B as_B() const;
+
+private:
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+struct RootView {
+  RootView() = default;
+  RootView(const char *data, std::size_t size) : data_(data), size_(size) {}
+
+  explicit operator bool() const { return data_ != nullptr; }
+
+  AView a() const;
+  B b() const;
+  ABView d() const;
+  ListView<Root_io, ABView, AB> e() const;
+  ABView f() const;
+  ABView empty() const;
+  ABView null() const;
+
+private:
+  friend struct Root_io;
+
+  Root_io::InputBuffer SeekMember(std::size_t member) const;
+
+  const char *data_{nullptr};
+  std::size_t size_{0};
+  // members are found when they are first asked for, offsets_ up to known_ hold where they start
+  mutable std::size_t offsets_[9]{};
+  mutable std::size_t known_{0};
+};
+
+inline Root_io::InputBuffer AView::SeekMember(std::size_t) const {
+  return Root_io::InputBuffer{data_, size_, 0, false, {}};
+}
+
+inline StringView AView::name() const {
+  Root_io io;
+  auto i = SeekMember(0);
+  return io.MakeView(i, static_cast<const std::string *>(nullptr));
+}
+
+inline AView Root_io::MakeView(InputBuffer &i, const A *) {
+  return i.failed ? AView() : AView(i.data + i.pos, i.size - i.pos);
+}
+
+inline AView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<A> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const A *>(nullptr)) : AView();
+}
+
+inline bool ABView::is_Defined() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  const auto selection = io.ReadSelection(i, static_cast<const AB *>(nullptr));
+  return !i.failed && selection != 0;
+}
+
+inline bool ABView::is_A() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  const auto selection = io.ReadSelection(i, static_cast<const AB *>(nullptr));
+  return !i.failed && selection == 1;
+}
+
+inline AView ABView::as_A() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  if (io.ReadSelection(i, static_cast<const AB *>(nullptr)) != 1 || i.failed)
+    return AView();
+  return i.failed ? AView() : AView(i.data + i.pos, i.size - i.pos);
+}
+
+inline bool ABView::is_B() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  const auto selection = io.ReadSelection(i, static_cast<const AB *>(nullptr));
+  return !i.failed && selection == 2;
+}
+
+inline B ABView::as_B() const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, 0, false, {}};
+  if (io.ReadSelection(i, static_cast<const AB *>(nullptr)) != 2 || i.failed)
+    return B();
+  B v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline ABView Root_io::MakeView(InputBuffer &i, const AB *) {
+  return i.failed ? ABView() : ABView(i.data + i.pos, i.size - i.pos);
+}
+
+inline ABView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<AB> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const AB *>(nullptr)) : ABView();
+}
+
+inline Root_io::InputBuffer RootView::SeekMember(std::size_t member) const {
+  Root_io io;
+  Root_io::InputBuffer i{data_, size_, offsets_[known_], false, {}};
+  while (known_ < member && !i.failed) {
+    switch (known_) {
+    case 0: io.Skip(i, static_cast<const A *>(nullptr)); break;
+    case 1: io.Skip(i, static_cast<const B *>(nullptr)); break;
+    case 2: io.Skip(i, static_cast<const std::shared_ptr<AB> *>(nullptr)); break;
+    case 3: io.Skip(i, static_cast<const std::weak_ptr<AB> *>(nullptr)); break;
+    case 4: io.Skip(i, static_cast<const std::unique_ptr<AB> *>(nullptr)); break;
+    case 5: i.pos = this->e().EndOffset(); i.failed = i.pos >= size_; break;
+    case 6: io.Skip(i, static_cast<const AB *>(nullptr)); break;
+    case 7: io.Skip(i, static_cast<const std::unique_ptr<AB> *>(nullptr)); break;
+    }
+    if (!i.failed)
+      offsets_[++known_] = i.pos;
+  }
+  if (!i.failed)
+    i.pos = offsets_[member];
+  return i;
+}
+
+inline AView RootView::a() const {
+  auto i = SeekMember(0);
+  return i.failed ? AView() : AView(i.data + i.pos, i.size - i.pos);
+}
+
+inline B RootView::b() const {
+  Root_io io;
+  auto i = SeekMember(1);
+  B v{};
+  io.Read(i, v);
+  return v;
+}
+
+inline ABView RootView::d() const {
+  Root_io io;
+  auto i = SeekMember(4);
+  char ref = 0;
+  io.ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? ABView(i.data + i.pos, i.size - i.pos) : ABView();
+}
+
+inline ListView<Root_io, ABView, AB> RootView::e() const {
+  Root_io io;
+  auto i = SeekMember(5);
+  std::size_t s{0};
+  io.Read(i, s);
+  if (!io.Available(i, s, 1))
+    return ListView<Root_io, ABView, AB>();
+  return ListView<Root_io, ABView, AB>(data_, size_, i.pos, s);
+}
+
+inline ABView RootView::f() const {
+  auto i = SeekMember(6);
+  return i.failed ? ABView() : ABView(i.data + i.pos, i.size - i.pos);
+}
+
+inline ABView RootView::empty() const {
+  Root_io io;
+  auto i = SeekMember(7);
+  char ref = 0;
+  io.ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? ABView(i.data + i.pos, i.size - i.pos) : ABView();
+}
+
+inline ABView RootView::null() const {
+  Root_io io;
+  auto i = SeekMember(8);
+  char ref = 0;
+  io.ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? ABView(i.data + i.pos, i.size - i.pos) : ABView();
+}
+
+inline RootView Root_io::MakeView(InputBuffer &i, const Root *) {
+  return i.failed ? RootView() : RootView(i.data + i.pos, i.size - i.pos);
+}
+
+inline RootView Root_io::MakeView(InputBuffer &i, const std::unique_ptr<Root> *) {
+  char ref = 0;
+  ReadBytes(i, &ref, 1);
+  return ref == '\x1' ? MakeView(i, static_cast<const Root *>(nullptr)) : RootView();
+}
+
+inline bool Root_io::ViewRoot(const char *data, std::size_t size, RootView &v) {
+  InputBuffer i{data, size, 0, false, {}};
+  if (!ReadHeader(i))
+    return false;
+  v = RootView(i.data + i.pos, i.size - i.pos);
+  return true;
+}
+
+struct RootWriter {
+  explicit RootWriter(std::ostream &o) : o_(o), out_{o, 0, {}} {
+    header_ = o_.tellp();
+    io_.WriteHeader(out_);
+  }
+
+  bool done() const {
+    return next_ == count_members && bool(o_);
+  }
+
+  bool write_a(const A &v) {
+    if (next_ != 0 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_b(const B &v) {
+    if (next_ != 1 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_c(const std::shared_ptr<AB> &v) {
+    if (next_ != 2 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_cw(const std::weak_ptr<AB> &v) {
+    if (next_ != 3 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_d(const std::unique_ptr<AB> &v) {
+    if (next_ != 4 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool begin_e() {
+    if (next_ != 5 || open_)
+      return false;
+    position_ = o_.tellp();
+    if (position_ == std::streampos(-1))
+      return false;
+    io_.WritePaddedSize(out_, 0);
+    open_ = true;
+    count_ = 0;
+    return bool(o_);
+  }
+
+  bool begin_e(std::size_t size) {
+    if (next_ != 5 || open_)
+      return false;
+    io_.Write(out_, size);
+    position_ = std::streampos(-1);
+    open_ = true;
+    count_ = 0;
+    size_ = size;
+    return bool(o_);
+  }
+
+  bool push_e(const AB &v) {
+    if (next_ != 5 || !open_)
+      return false;
+    io_.Write(out_, v);
+    ++count_;
+    return bool(o_);
+  }
+
+  bool end_e() {
+    if (next_ != 5 || !open_)
+      return false;
+    open_ = false;
+    ++next_;
+    if (position_ != std::streampos(-1)) {
+      const auto end = o_.tellp();
+      o_.seekp(position_);
+      io_.WritePaddedSize(o_, count_);
+      o_.seekp(end);
+    } else if (count_ != size_)
+      return false;
+    return bool(o_);
+  }
+
+  bool write_f(const AB &v) {
+    if (next_ != 6 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_empty(const std::unique_ptr<AB> &v) {
+    if (next_ != 7 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    return bool(o_);
+  }
+
+  bool write_null(const std::unique_ptr<AB> &v) {
+    if (next_ != 8 || open_)
+      return false;
+    io_.Write(out_, v);
+    ++next_;
+    io_.PatchHeader(o_, header_, out_.references);
+    return bool(o_);
+  }
+
+private:
+  static constexpr std::size_t count_members = 9;
+
+  std::ostream &o_;
+  Root_io::OutputStream out_;
+  Root_io io_;
+  std::size_t next_{0};
+  bool open_{false};
+  std::size_t count_{0};
+  std::size_t size_{0};
+  std::streampos position_{-1};
+  std::streampos header_{-1};
+};
+}
@@ -1,355 +1,567 @@
-
-#define CATCH_CONFIG_FAST_COMPILE
-#include <sstream>
-#include "catch2/catch.hpp"
-#include "uniontypes.h"
-
-using namespace UnionTypes;
-
-A testA()
-{
-  return A("hello");
-}
-
-void checkA(const AB &ab)
-{
-  REQUIRE(ab.is_Defined());
-  REQUIRE(ab.is_A());
-  REQUIRE_NOTHROW(ab.as_A());
-  CHECK_FALSE(ab.is_B());
-  CHECK(ab.as_A().name == "hello");
-}
-
-B testB()
-{
-  return B(42);
-}
-void checkB(const AB &ab)
-{
-  REQUIRE(ab.is_Defined());
-  REQUIRE(ab.is_B());
-  REQUIRE_NOTHROW(ab.as_B());
-  CHECK(ab.as_B().size == 42);
-}
-
-TEST_CASE("case", "[tag]")
-{
-  SECTION("Use union")
-  {
-    SECTION("default")
-    {
-      AB ab;
-      CHECK(!ab.is_Defined());
-    }
-
-    SECTION("construct copy")
-    {
-      const AB a = testA();
-      checkA(AB(a));
-      const AB b = testB();
-      checkB(AB(b));
-    }
-
-    SECTION("assignment")
-    {
-      AB ab;
-      const AB a = testA();
-      ab = a;
-      checkA(ab);
-
-      const AB b = testB();
-      ab = b;
-      checkB(ab);
-
-      AB xx;
-      ab = xx;
-      CHECK(!ab.is_Defined());
-    }
-
-    SECTION("construct sub types r-value ")
-    {
-      checkA(AB(testA()));
-      checkB(AB(testB()));
-    }
-
-    SECTION("construct sub types l-value ")
-    {
-      const A a = testA();
-      checkA(AB(a));
-
-      const B b = testB();
-      checkB(AB(b));
-    }
-
-    SECTION("Assignment sub types r-value")
-    {
-      AB ab;
-      ab = testA();
-      checkA(ab);
-
-      ab = testB();
-      checkB(ab);
-    }
-
-    SECTION("Assignment sub types l-value ")
-    {
-      AB ab;
-      const A a = testA();
-      ab = a;
-      checkA(ab);
-
-      const B b = testB();
-      ab = b;
-      checkB(ab);
-    }
-
-    SECTION("Assignment sub types l-value ")
-    {
-      AB ab = testA();
-      ab.as_A().name = "HALLO";
-      CHECK(AB(testA()) != ab);
-
-      ab = testB();
-      ab.as_B().size = 53;
-      CHECK(AB(testB()) != ab);
-    }
-
-    SECTION("clear content")
-    {
-      AB ab = testA();
-      CHECK(ab.is_Defined());
-      CHECK(ab.is_A());
-      CHECK_FALSE(ab.is_B());
-
-      ab.clear();
-      CHECK_FALSE(ab.is_Defined());
-      CHECK_FALSE(ab.is_A());
-      CHECK_FALSE(ab.is_B());
-    }
-
-    SECTION("compare equal")
-    {
-      AB n;
-      AB a = testA();
-      AB b = testB();
-
-      CHECK(n == n);
-      CHECK(n == AB());
-      CHECK(a == AB(testA()));
-      CHECK(b == AB(testB()));
-
-      CHECK_FALSE(a == n);
-      CHECK_FALSE(a == b);
-      CHECK_FALSE(n == b);
-    }
-
-    SECTION("compare not equal")
-    {
-      AB n;
-      AB a = testA();
-      AB b = testB();
-
-      CHECK_FALSE(n != n);
-      CHECK_FALSE(n != AB());
-      CHECK_FALSE(a != AB(testA()));
-      CHECK_FALSE(b != AB(testB()));
-
-      CHECK(a != n);
-      CHECK(a != b);
-      CHECK(n != b);
-    }
-
-    SECTION("compare equal subtype l r")
-    {
-      AB n;
-      AB a = testA();
-      AB b = testB();
-
-      CHECK(a == testA());
-      CHECK(b == testB());
-
-      CHECK_FALSE(n == testA());
-      CHECK_FALSE(n == testB());
-      CHECK_FALSE(a == testB());
-      CHECK_FALSE(b == testA());
-    }
-
-    SECTION("compare equal subtype r l")
-    {
-      AB n;
-      AB a = testA();
-      AB b = testB();
-
-      CHECK(testA() == a);
-      CHECK(testB() == b);
-
-      CHECK_FALSE(testA() == n);
-      CHECK_FALSE(testB() == n);
-      CHECK_FALSE(testB() == a);
-      CHECK_FALSE(testA() == b);
-    }
-
-    SECTION("compare not equal subtype l r")
-    {
-      AB n;
-      AB a = testA();
-      AB b = testB();
-
-      CHECK_FALSE(a != testA());
-      CHECK_FALSE(b != testB());
-
-      CHECK(n != testA());
-      CHECK(n != testB());
-      CHECK(a != testB());
-      CHECK(b != testA());
-    }
-
-    SECTION("compare not equal subtype l r")
-    {
-      AB n;
-      AB a = testA();
-      AB b = testB();
-
-      CHECK_FALSE(testA() != a);
-      CHECK_FALSE(testB() != b);
-
-      CHECK(testA() != n);
-      CHECK(testB() != n);
-      CHECK(testB() != a);
-      CHECK(testA() != b);
-    }
-  }
-
-  SECTION("general compare operations")
-  {
-    CHECK(A() == A());
-    CHECK_FALSE(A() != A());
-
-    CHECK(B() == B());
-    CHECK_FALSE(B() != B());
-
-    CHECK(Root() == Root());
-    CHECK_FALSE(Root() != Root());
-  }
-
-  SECTION("reading whats written plain union")
-  {
-    std::stringstream sOut;
-    {
-      Root root;
-
-      CHECK_FALSE(root.f.is_Defined());
-      root.f.create_A("bear boy");
-      REQUIRE((root.f.is_Defined() && root.f.is_A()));
-
-      Root_io().WriteRoot(sOut, root);
-    }
-
-    {
-      const auto buffer = sOut.str();
-      std::stringstream sIn(buffer);
-
-      Root rootIn;
-      Root_io().ReadRoot(sIn, rootIn);
-
-      REQUIRE((rootIn.f.is_Defined() && rootIn.f.is_A()));
-      CHECK(rootIn.f.as_A().name == "bear boy");
-    }
-  }
-
-  SECTION("reading whats written pointer union")
-  {
-    std::stringstream sOut;
-    {
-      Root root;
-      root.c = std::make_shared<AB>();
-      root.c->create_A("Hallo");
-      root.cw = root.c;
-
-      root.d = std::unique_ptr<AB>(new AB);
-      root.d->create_B(54);
-
-      root.empty = std::unique_ptr<AB>(new AB);
-
-      Root_io().WriteRoot(sOut, root);
-    }
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-
-    Root rootIn;
-    Root_io().ReadRoot(sIn, rootIn);
-
-    REQUIRE(rootIn.c != nullptr);
-    REQUIRE(rootIn.c->is_A());
-    CHECK(rootIn.c->as_A().name == "Hallo");
-
-    REQUIRE(rootIn.cw.lock() != nullptr);
-    CHECK(rootIn.cw.lock() == rootIn.c);
-
-    REQUIRE(rootIn.d != nullptr);
-    REQUIRE(rootIn.d->is_B());
-    CHECK(rootIn.d->as_B().size == 54);
-
-    REQUIRE(rootIn.empty != nullptr);
-    CHECK_FALSE(rootIn.empty->is_Defined());
-
-    CHECK(rootIn.null == nullptr);
-  }
-
-  SECTION("reading whats written vector")
-  {
-    std::stringstream sOut;
-    {
-      Root root;
-      root.e.emplace_back(A("funny name"));
-      root.e.emplace_back(B(54));
-
-      Root_io().WriteRoot(sOut, root);
-    }
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-    Root rootIn;
-    Root_io().ReadRoot(sIn, rootIn);
-
-    REQUIRE(rootIn.e.size() == 2);
-
-    REQUIRE(rootIn.e[0].is_A());
-    CHECK(rootIn.e[0].as_A().name == "funny name");
-
-    REQUIRE(rootIn.e[1].is_B());
-    CHECK(rootIn.e[1].as_B().size == 54);
-  }
-
-  SECTION("reading whats written non union types")
-  {
-    Root root;
-    root.a = A("Hallo");
-    root.b = B(42);
-
-    Root rootIn;
-    CHECK_FALSE(root == rootIn);
-
-    std::stringstream sOut;
-    Root_io().WriteRoot(sOut, root);
-
-    const auto buffer = sOut.str();
-    std::stringstream sIn(buffer);
-
-    Root_io().ReadRoot(sIn, rootIn);
-
-    CHECK(root == rootIn);
-  }
-
-  SECTION("Reading fails with wrong data")
-  {
-    Root r;
-
-    std::istringstream s1("FALSE");
-    CHECK_FALSE(Root_io().ReadRoot(s1, r));
-
-    std::istringstream s2("COREfails");
-    CHECK_FALSE(Root_io().ReadRoot(s2, r));
-  }
-}
+
+#define CATCH_CONFIG_FAST_COMPILE
+#include <sstream>
+#include "catch2/catch.hpp"
+#include "fuzz.h"
+#include "uniontypes.h"
+
+using namespace UnionTypes;
+
+namespace {
+// counts the allocations of the containers that use it, copies share the counter
+template <typename T>
+struct CountingAllocator
+{
+  using value_type = T;
+
+  explicit CountingAllocator(std::size_t &count) : allocations(&count) {}
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U> &other) : allocations(other.allocations)
+  {}
+
+  T *allocate(std::size_t n)
+  {
+    ++*allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T *p, std::size_t n) { std::allocator<T>().deallocate(p, n); }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U> &other) const
+  {
+    return allocations == other.allocations;
+  }
+  template <typename U>
+  bool operator!=(const CountingAllocator<U> &other) const
+  {
+    return allocations != other.allocations;
+  }
+
+  std::size_t *allocations;
+};
+}  // namespace
+
+A testA()
+{
+  return A("hello");
+}
+
+void checkA(const AB &ab)
+{
+  REQUIRE(ab.is_Defined());
+  REQUIRE(ab.is_A());
+  REQUIRE_NOTHROW(ab.as_A());
+  CHECK_FALSE(ab.is_B());
+  CHECK(ab.as_A().name == "hello");
+}
+
+B testB()
+{
+  return B(42);
+}
+void checkB(const AB &ab)
+{
+  REQUIRE(ab.is_Defined());
+  REQUIRE(ab.is_B());
+  REQUIRE_NOTHROW(ab.as_B());
+  CHECK(ab.as_B().size == 42);
+}
+
+TEST_CASE("case", "[tag]")
+{
+  SECTION("Use union")
+  {
+    SECTION("default")
+    {
+      AB ab;
+      CHECK(!ab.is_Defined());
+    }
+
+    SECTION("construct copy")
+    {
+      const AB a = testA();
+      checkA(AB(a));
+      const AB b = testB();
+      checkB(AB(b));
+    }
+
+    SECTION("assignment")
+    {
+      AB ab;
+      const AB a = testA();
+      ab = a;
+      checkA(ab);
+
+      const AB b = testB();
+      ab = b;
+      checkB(ab);
+
+      AB xx;
+      ab = xx;
+      CHECK(!ab.is_Defined());
+    }
+
+    SECTION("construct sub types r-value ")
+    {
+      checkA(AB(testA()));
+      checkB(AB(testB()));
+    }
+
+    SECTION("construct sub types l-value ")
+    {
+      const A a = testA();
+      checkA(AB(a));
+
+      const B b = testB();
+      checkB(AB(b));
+    }
+
+    SECTION("Assignment sub types r-value")
+    {
+      AB ab;
+      ab = testA();
+      checkA(ab);
+
+      ab = testB();
+      checkB(ab);
+    }
+
+    SECTION("Assignment sub types l-value ")
+    {
+      AB ab;
+      const A a = testA();
+      ab = a;
+      checkA(ab);
+
+      const B b = testB();
+      ab = b;
+      checkB(ab);
+    }
+
+    SECTION("Assignment sub types l-value ")
+    {
+      AB ab = testA();
+      ab.as_A().name = "HALLO";
+      CHECK(AB(testA()) != ab);
+
+      ab = testB();
+      ab.as_B().size = 53;
+      CHECK(AB(testB()) != ab);
+    }
+
+    SECTION("clear content")
+    {
+      AB ab = testA();
+      CHECK(ab.is_Defined());
+      CHECK(ab.is_A());
+      CHECK_FALSE(ab.is_B());
+
+      ab.clear();
+      CHECK_FALSE(ab.is_Defined());
+      CHECK_FALSE(ab.is_A());
+      CHECK_FALSE(ab.is_B());
+    }
+
+    SECTION("compare equal")
+    {
+      AB n;
+      AB a = testA();
+      AB b = testB();
+
+      CHECK(n == n);
+      CHECK(n == AB());
+      CHECK(a == AB(testA()));
+      CHECK(b == AB(testB()));
+
+      CHECK_FALSE(a == n);
+      CHECK_FALSE(a == b);
+      CHECK_FALSE(n == b);
+    }
+
+    SECTION("compare not equal")
+    {
+      AB n;
+      AB a = testA();
+      AB b = testB();
+
+      CHECK_FALSE(n != n);
+      CHECK_FALSE(n != AB());
+      CHECK_FALSE(a != AB(testA()));
+      CHECK_FALSE(b != AB(testB()));
+
+      CHECK(a != n);
+      CHECK(a != b);
+      CHECK(n != b);
+    }
+
+    SECTION("compare equal subtype l r")
+    {
+      AB n;
+      AB a = testA();
+      AB b = testB();
+
+      CHECK(a == testA());
+      CHECK(b == testB());
+
+      CHECK_FALSE(n == testA());
+      CHECK_FALSE(n == testB());
+      CHECK_FALSE(a == testB());
+      CHECK_FALSE(b == testA());
+    }
+
+    SECTION("compare equal subtype r l")
+    {
+      AB n;
+      AB a = testA();
+      AB b = testB();
+
+      CHECK(testA() == a);
+      CHECK(testB() == b);
+
+      CHECK_FALSE(testA() == n);
+      CHECK_FALSE(testB() == n);
+      CHECK_FALSE(testB() == a);
+      CHECK_FALSE(testA() == b);
+    }
+
+    SECTION("compare not equal subtype l r")
+    {
+      AB n;
+      AB a = testA();
+      AB b = testB();
+
+      CHECK_FALSE(a != testA());
+      CHECK_FALSE(b != testB());
+
+      CHECK(n != testA());
+      CHECK(n != testB());
+      CHECK(a != testB());
+      CHECK(b != testA());
+    }
+
+    SECTION("compare not equal subtype l r")
+    {
+      AB n;
+      AB a = testA();
+      AB b = testB();
+
+      CHECK_FALSE(testA() != a);
+      CHECK_FALSE(testB() != b);
+
+      CHECK(testA() != n);
+      CHECK(testB() != n);
+      CHECK(testB() != a);
+      CHECK(testA() != b);
+    }
+  }
+
+  SECTION("small alternatives are stored inline")
+  {
+    const auto inside = [](const AB &ab, const void *p) {
+      const auto *begin = reinterpret_cast<const char *>(&ab);
+      const auto *value = static_cast<const char *>(p);
+      return value >= begin && value < begin + sizeof(AB);
+    };
+
+    AB ab = testB();
+    CHECK(inside(ab, &ab.as_B()));
+    ab = testA();
+    CHECK_FALSE(inside(ab, &ab.as_A()));
+    ab.create_B(7);
+    CHECK(inside(ab, &ab.as_B()));
+
+    std::vector<AB> v(100, AB(testB()));
+    for (const auto &entry : v)
+      CHECK(inside(entry, &entry.as_B()));
+    v[50] = testA();
+    checkA(v[50]);
+    CHECK(v[51] == testB());
+  }
+
+  SECTION("assigning a value from the same union")
+  {
+    AB ab = testA();
+    ab.create_A(ab.as_A());
+    checkA(ab);
+    ab = ab.as_A();
+    checkA(ab);
+    const AB &self = ab;
+    ab = self;
+    checkA(ab);
+
+    ab.create_B(ab.is_A() ? 42 : 0);
+    ab.create_B(ab.as_B());
+    checkB(ab);
+    ab = std::move(ab.as_B());
+    checkB(ab);
+  }
+
+  SECTION("moving does not allocate")
+  {
+    static_assert(std::is_nothrow_move_constructible<AB>::value, "AB has to be nothrow move constructible");
+    static_assert(std::is_nothrow_move_assignable<AB>::value, "AB has to be nothrow move assignable");
+
+    std::size_t allocations = 0;
+    std::vector<AB, CountingAllocator<AB>> v{CountingAllocator<AB>(allocations)};
+    v.reserve(4);
+    for (int i = 0; i < 4; ++i)
+      v.emplace_back(A("a name long enough for a heap buffer " + std::to_string(i)));
+    const auto *name = v[3].as_A().name.data();
+    const auto before = allocations;
+    v.emplace_back(testB());
+    CHECK(allocations - before == 1);
+    CHECK(v[3].as_A().name == "a name long enough for a heap buffer 3");
+    CHECK(v[3].as_A().name.data() == name);
+    checkB(v[4]);
+
+    AB a = A("a name long enough for a heap buffer");
+    AB b = testB();
+    const auto *aValue = &a.as_A();
+    name = a.as_A().name.data();
+    AB moved(std::move(a));
+    CHECK_FALSE(a.is_Defined());
+    REQUIRE(moved.is_A());
+    CHECK(moved.as_A().name.data() == name);
+    // A does not fit into the inline slot, moving hands over the heap value
+    CHECK(&moved.as_A() == aValue);
+
+    swap(moved, b);
+    checkB(moved);
+    REQUIRE(b.is_A());
+    CHECK(b.as_A().name.data() == name);
+    moved.swap(b);
+    CHECK(moved.as_A().name.data() == name);
+
+    b = std::move(moved);
+    CHECK(b.as_A().name.data() == name);
+    CHECK_FALSE(moved.is_Defined());
+    b = std::move(b);
+    CHECK(b.as_A().name.data() == name);
+  }
+
+  SECTION("general compare operations")
+  {
+    CHECK(A() == A());
+    CHECK_FALSE(A() != A());
+
+    CHECK(B() == B());
+    CHECK_FALSE(B() != B());
+
+    CHECK(Root() == Root());
+    CHECK_FALSE(Root() != Root());
+  }
+
+  SECTION("reading whats written plain union")
+  {
+    std::stringstream sOut;
+    {
+      Root root;
+
+      CHECK_FALSE(root.f.is_Defined());
+      root.f.create_A("bear boy");
+      REQUIRE((root.f.is_Defined() && root.f.is_A()));
+
+      Root_io().WriteRoot(sOut, root);
+    }
+
+    {
+      const auto buffer = sOut.str();
+      std::stringstream sIn(buffer);
+
+      Root rootIn;
+      Root_io().ReadRoot(sIn, rootIn);
+
+      REQUIRE((rootIn.f.is_Defined() && rootIn.f.is_A()));
+      CHECK(rootIn.f.as_A().name == "bear boy");
+    }
+  }
+
+  SECTION("reading whats written pointer union")
+  {
+    std::stringstream sOut;
+    {
+      Root root;
+      root.c = std::make_shared<AB>();
+      root.c->create_A("Hallo");
+      root.cw = root.c;
+
+      root.d = std::unique_ptr<AB>(new AB);
+      root.d->create_B(54);
+
+      root.empty = std::unique_ptr<AB>(new AB);
+
+      Root_io().WriteRoot(sOut, root);
+    }
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+
+    Root rootIn;
+    Root_io().ReadRoot(sIn, rootIn);
+
+    REQUIRE(rootIn.c != nullptr);
+    REQUIRE(rootIn.c->is_A());
+    CHECK(rootIn.c->as_A().name == "Hallo");
+
+    REQUIRE(rootIn.cw.lock() != nullptr);
+    CHECK(rootIn.cw.lock() == rootIn.c);
+
+    REQUIRE(rootIn.d != nullptr);
+    REQUIRE(rootIn.d->is_B());
+    CHECK(rootIn.d->as_B().size == 54);
+
+    REQUIRE(rootIn.empty != nullptr);
+    CHECK_FALSE(rootIn.empty->is_Defined());
+
+    CHECK(rootIn.null == nullptr);
+  }
+
+  SECTION("reading whats written vector")
+  {
+    std::stringstream sOut;
+    {
+      Root root;
+      root.e.emplace_back(A("funny name"));
+      root.e.emplace_back(B(54));
+
+      Root_io().WriteRoot(sOut, root);
+    }
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+    Root rootIn;
+    Root_io().ReadRoot(sIn, rootIn);
+
+    REQUIRE(rootIn.e.size() == 2);
+
+    REQUIRE(rootIn.e[0].is_A());
+    CHECK(rootIn.e[0].as_A().name == "funny name");
+
+    REQUIRE(rootIn.e[1].is_B());
+    CHECK(rootIn.e[1].as_B().size == 54);
+  }
+
+  SECTION("reading into existing values")
+  {
+    std::stringstream sOut;
+    {
+      Root root;
+      root.d.reset(new AB(A("unique")));
+      root.e.emplace_back(B(54));
+      root.e.emplace_back();
+      root.f = B(12);
+
+      Root_io().WriteRoot(sOut, root);
+    }
+
+    Root rootIn;
+    rootIn.e.emplace_back(A("replaced"));
+    rootIn.e.emplace_back(A("cleared"));
+    rootIn.f = A("replaced");
+    rootIn.null.reset(new AB(B(1)));
+
+    Root_io().ReadRoot(sOut, rootIn);
+
+    REQUIRE(rootIn.d);
+    CHECK(rootIn.d->is_A());
+    REQUIRE(rootIn.e.size() == 2);
+    REQUIRE(rootIn.e[0].is_B());
+    CHECK(rootIn.e[0].as_B().size == 54);
+    CHECK_FALSE(rootIn.e[1].is_Defined());
+    REQUIRE(rootIn.f.is_B());
+    CHECK(rootIn.f.as_B().size == 12);
+    CHECK(rootIn.null == nullptr);
+  }
+
+  SECTION("viewing whats written")
+  {
+    std::vector<char> buffer;
+    {
+      Root root;
+      root.a = A("Hallo");
+      root.c = std::make_shared<AB>(A("shared"));
+      root.cw = root.c;
+      root.d.reset(new AB(B(54)));
+      root.e.emplace_back(A("funny name"));
+      root.e.emplace_back();
+      root.e.emplace_back(B(12));
+      root.f = A("plain");
+      root.empty.reset(new AB);
+
+      Root_io().WriteRoot(buffer, root);
+    }
+
+    RootView v;
+    REQUIRE(Root_io().ViewRoot(buffer.data(), buffer.size(), v));
+    CHECK(v.a().name() == std::string("Hallo"));
+    CHECK(v.b().size == 0);
+
+    REQUIRE(v.d().is_B());
+    CHECK_FALSE(v.d().is_A());
+    CHECK(v.d().as_B().size == 54);
+
+    REQUIRE(v.e().size() == 3);
+    REQUIRE(v.e()[0].is_A());
+    CHECK(v.e()[0].as_A().name() == std::string("funny name"));
+    CHECK_FALSE(v.e()[1].is_Defined());
+    CHECK(v.e()[2].as_B().size == 12);
+
+    REQUIRE(v.f().is_A());
+    CHECK(v.f().as_A().name() == std::string("plain"));
+    CHECK_FALSE(v.empty().is_Defined());
+    CHECK_FALSE(v.null().is_Defined());
+  }
+
+  SECTION("reading whats written non union types")
+  {
+    Root root;
+    root.a = A("Hallo");
+    root.b = B(42);
+
+    Root rootIn;
+    CHECK_FALSE(root == rootIn);
+
+    std::stringstream sOut;
+    Root_io().WriteRoot(sOut, root);
+
+    const auto buffer = sOut.str();
+    std::stringstream sIn(buffer);
+
+    Root_io().ReadRoot(sIn, rootIn);
+
+    CHECK(root == rootIn);
+  }
+
+  SECTION("verifying whats written")
+  {
+    Root root;
+    root.a.name = "plain";
+    root.f.create_A("plain");
+    root.c = std::make_shared<AB>();
+    root.c->create_A("Hallo");
+    root.cw = root.c;
+    root.d = std::unique_ptr<AB>(new AB);
+    root.d->create_B(54);
+    root.empty = std::unique_ptr<AB>(new AB);
+    for (int i = 0; i < 100; ++i)
+      root.e.emplace_back(B(i));
+
+    std::vector<char> buffer;
+    Root_io().WriteRoot(buffer, root);
+
+    CHECK(Root_io().VerifyRoot(buffer.data(), buffer.size()));
+
+    CHECK(fuzzRoot(buffer, 5000, &Root_io::VerifyRoot, &Root_io::ReadRoot) == 0);
+  }
+
+  SECTION("Reading fails with wrong data")
+  {
+    Root r;
+
+    std::istringstream s1("FALSE");
+    CHECK_FALSE(Root_io().ReadRoot(s1, r));
+
+    std::istringstream s2("COREfails");
+    CHECK_FALSE(Root_io().ReadRoot(s2, r));
+  }
+}